@@ -457,6 +457,15 @@ proc generate_lwip_opts {libhandle} {
 			puts $lwipopts_fd "\#define DEFAULT_RAW_RECVMBOX_SIZE	30"
 			puts $lwipopts_fd "\#define LWIP_COMPAT_MUTEX 0"
 			puts $lwipopts_fd "\#define LWIP_ALLOW_MEM_FREE_FROM_OTHER_CONTEXT 1"
+			set core_locking [common::get_property CONFIG.tcpip_core_locking $libhandle]
+			if {$core_locking == true} {
+				puts $lwipopts_fd "\#define LWIP_TCPIP_CORE_LOCKING 1"
+				puts $lwipopts_fd "\#define LWIP_TCPIP_CORE_LOCKING_INPUT 1"
+			}
+			set mbox_batch [common::get_property CONFIG.tcpip_mbox_batch $libhandle]
+			set inpkt_batch [common::get_property CONFIG.tcpip_inpkt_batch $libhandle]
+			puts $lwipopts_fd "\#define TCPIP_MBOX_BATCH $mbox_batch"
+			puts $lwipopts_fd "\#define TCPIP_INPKT_BATCH_MAX $inpkt_batch"
 			puts $lwipopts_fd ""
 		}
 	}
@@ -499,6 +508,12 @@ proc generate_lwip_opts {libhandle} {
 		puts $lwipopts_fd "\#define MEMP_NUM_NETBUF     $memp_num_netbuf"
 		puts $lwipopts_fd "\#define MEMP_NUM_NETCONN    $memp_num_netconn"
 		puts $lwipopts_fd "\#define LWIP_PROVIDE_ERRNO  1"
+		set zero_copy_api [common::get_property CONFIG.socket_zero_copy_api $libhandle]
+		if {$zero_copy_api == true} {
+			set memp_num_netconn_ref [common::get_property CONFIG.memp_num_netconn_ref $libhandle]
+			puts $lwipopts_fd "\#define LWIP_NETCONN_ZEROCOPY 1"
+			puts $lwipopts_fd "\#define MEMP_NUM_NETCONN_REF $memp_num_netconn_ref"
+		}
 	}
 	puts $lwipopts_fd "\#define MEMP_NUM_SYS_TIMEOUT $memp_n_sys_timeout"
 
@@ -577,6 +592,35 @@ proc generate_lwip_opts {libhandle} {
 	puts $lwipopts_fd "\#define TCP_QUEUE_OOSEQ $tcp_queue_ooseq"
 	puts $lwipopts_fd "\#define TCP_SND_QUEUELEN   16 * TCP_SND_BUF/TCP_MSS"
 
+	# windows or send buffers beyond 16 bits need the window scale option
+	if {$tcp_wnd > 65535 || $tcp_snd_buf > 65535} {
+		set tcp_rcv_scale 0
+		while {[expr $tcp_wnd >> $tcp_rcv_scale] > 65535} {
+			incr tcp_rcv_scale
+		}
+		if {$tcp_rcv_scale > 14} {
+			error "ERROR: TCP window of $tcp_wnd bytes is too large even with TCP window scaling" "" "MDT_ERROR"
+		}
+		puts $lwipopts_fd "\#define LWIP_WND_SCALE 1"
+		puts $lwipopts_fd "\#define TCP_RCV_SCALE $tcp_rcv_scale"
+	}
+
+	set tcp_sack		[expr [common::get_property CONFIG.tcp_sack $libhandle] == true]
+	if {$tcp_sack == 1} {
+		if {$tcp_queue_ooseq != 1} {
+			error "ERROR: TCP SACK requires tcp_queue_ooseq to be set" "" "MDT_ERROR"
+		}
+		puts $lwipopts_fd "\#define LWIP_TCP_SACK 1"
+	}
+
+	set lwip_pcb_hash	[expr [common::get_property CONFIG.lwip_pcb_hash $libhandle] == true]
+	if {$lwip_pcb_hash == 1} {
+		set pcb_hash_size	[common::get_property CONFIG.pcb_hash_size $libhandle]
+		puts $lwipopts_fd "\#define LWIP_PCB_HASH 1"
+		puts $lwipopts_fd "\#define TCP_PCB_HASH_SIZE $pcb_hash_size"
+		puts $lwipopts_fd "\#define UDP_PCB_HASH_SIZE $pcb_hash_size"
+	}
+
 	set have_ethonzynq 0
 	foreach emac $emac_periphs_list {
 		set iptype [common::get_property IP_NAME $emac]
@@ -1307,6 +1351,10 @@ proc generate_adapterconfig_include {libhandle} {
 		puts $fd "\#define XLWIP_CONFIG_N_TX_COALESCE $ncoalesce"
 		set ncoalesce [common::get_property CONFIG.n_rx_coalesce $libhandle]
 		puts $fd "\#define XLWIP_CONFIG_N_RX_COALESCE $ncoalesce"
+		set coalesce_lat [common::get_property CONFIG.adaptive_coalesce_latency $libhandle]
+		puts $fd "\#define XLWIP_CONFIG_COALESCE_LATENCY_US $coalesce_lat"
+		set sg_clk [common::get_property CONFIG.axidma_sg_clock_mhz $libhandle]
+		puts $fd "\#define XLWIP_CONFIG_AXIDMA_SG_CLK_MHZ $sg_clk"
 		puts $fd ""
 	}
 	if {$have_ps_ethernet == 1} {
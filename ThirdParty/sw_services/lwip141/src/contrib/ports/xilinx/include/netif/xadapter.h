@@ -63,6 +63,9 @@ struct xemac_s {
 void 		lwip_raw_init();
 int 		xemacif_input(struct netif *netif);
 void 		xemacif_input_thread(struct netif *netif);
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+void 		xemacif_input_batch(struct netif *netif, struct pbuf **p, u16_t count);
+#endif
 struct netif *	xemac_add(struct netif *netif,
 	struct ip_addr *ipaddr, struct ip_addr *netmask, struct ip_addr *gw,
 	unsigned char *mac_ethernet_address,
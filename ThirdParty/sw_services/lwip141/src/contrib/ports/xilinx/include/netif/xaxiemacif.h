@@ -51,11 +51,20 @@ extern "C" {
 #else
 #include "xaxidma.h"
 #include "xaxidma_hw.h"
+#include "xaxidma_coalesce.h"
 #endif
 
 #include "netif/xpqueue.h"
 #include "xlwipconfig.h"
 
+/* Adaptive DMA interrupt coalescing, 0 keeps the fixed coalescing settings */
+#ifndef XLWIP_CONFIG_COALESCE_LATENCY_US
+#define XLWIP_CONFIG_COALESCE_LATENCY_US 0
+#endif
+#ifndef XLWIP_CONFIG_AXIDMA_SG_CLK_MHZ
+#define XLWIP_CONFIG_AXIDMA_SG_CLK_MHZ 100
+#endif
+
 void 	xaxiemacif_setmac(u32_t index, u8_t *addr);
 u8_t*	xaxiemacif_getmac(u32_t index);
 err_t 	xaxiemacif_init(struct netif *netif);
@@ -86,6 +95,13 @@ typedef struct {
 	/* pointers to memory holding buffer descriptors (used only with SDMA) */
 	void *rx_bdspace;
 	void *tx_bdspace;
+
+#if !defined(XLWIP_CONFIG_INCLUDE_AXI_ETHERNET_FIFO) && \
+	XLWIP_CONFIG_COALESCE_LATENCY_US
+	/* adaptive interrupt coalescing controllers of the DMA rings */
+	XAxiDma_Coalesce rx_coalesce;
+	XAxiDma_Coalesce tx_coalesce;
+#endif
 } xaxiemacif_s;
 
 extern xaxiemacif_s xaxiemacif;
@@ -99,6 +115,9 @@ s32_t process_sent_bds(XAxiDma_BdRing *txring);
 #ifndef XLWIP_CONFIG_INCLUDE_AXI_ETHERNET_FIFO
 XStatus init_axi_dma(struct xemac_s *xemac);
 XStatus axidma_sgsend(xaxiemacif_s *xaxiemacif, struct pbuf *p);
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+void xaxiemacif_coalesce_tick(struct netif *netif, u32_t elapsed_ms);
+#endif
 #endif
 
 #ifdef __cplusplus
@@ -47,6 +47,9 @@
 #include "lwip/tcp.h"
 #include "lwip/udp.h"
 #include "lwip/tcp_impl.h"
+#if !NO_SYS
+#include "lwip/tcpip.h"
+#endif
 
 #include "netif/etharp.h"
 #include "netif/xadapter.h"
@@ -251,3 +254,25 @@ xemacif_input(struct netif *netif)
 
 	return n_packets;
 }
+
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+/*
+ * Hand the packets collected by an adapter input routine over to the
+ * tcpip thread with a single message. The packets are dropped if the
+ * message cannot be queued.
+ */
+void
+xemacif_input_batch(struct netif *netif, struct pbuf **p, u16_t count)
+{
+	u16_t i;
+
+	if (count == 0)
+		return;
+
+	if (tcpip_input_batch(p, count, netif) != ERR_OK) {
+		LWIP_DEBUGF(NETIF_DEBUG, ("xemacif_input_batch: IP input error\r\n"));
+		for (i = 0; i < count; i++)
+			pbuf_free(p[i]);
+	}
+}
+#endif
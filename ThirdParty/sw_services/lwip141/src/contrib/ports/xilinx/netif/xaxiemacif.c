@@ -241,6 +241,10 @@ int xaxiemacif_input(struct netif *netif)
 	struct eth_hdr *ethhdr;
 	struct pbuf *p;
 	SYS_ARCH_DECL_PROTECT(lev);
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+	struct pbuf *batch[TCPIP_INPKT_BATCH_MAX];
+	u16_t n_batch = 0;
+#endif
 
 #if !NO_SYS
 	while (1)
@@ -252,8 +256,12 @@ int xaxiemacif_input(struct netif *netif)
 		SYS_ARCH_UNPROTECT(lev);
 
 		/* no packet could be read, silently ignore this */
-		if (p == NULL)
+		if (p == NULL) {
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+			xemacif_input_batch(netif, batch, n_batch);
+#endif
 			return 0;
+		}
 
 		/* points to packet payload, which starts with an Ethernet header */
 		ethhdr = p->payload;
@@ -272,11 +280,19 @@ int xaxiemacif_input(struct netif *netif)
 			case ETHTYPE_PPPOE:
 #endif /* PPPOE_SUPPORT */
 				/* full packet send to tcpip_thread to process */
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+				batch[n_batch++] = p;
+				if (n_batch == TCPIP_INPKT_BATCH_MAX) {
+					xemacif_input_batch(netif, batch, n_batch);
+					n_batch = 0;
+				}
+#else
 				if (netif->input(p, netif) != ERR_OK) {
 					LWIP_DEBUGF(NETIF_DEBUG, ("xaxiemacif_input: IP input error\r\n"));
 					pbuf_free(p);
 					p = NULL;
 				}
+#endif
 				break;
 
 			default:
@@ -285,6 +301,9 @@ int xaxiemacif_input(struct netif *netif)
 				break;
 		}
 	}
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+	xemacif_input_batch(netif, batch, n_batch);
+#endif
 	return 1;
 }
 
@@ -45,6 +45,7 @@
 #include "lwip/sys.h"
 #endif
 
+#include "lwip/sys.h"
 #include "lwip/stats.h"
 #include "lwip/inet_chksum.h"
 
@@ -93,6 +94,13 @@
 /* Byte alignment of BDs */
 #define BD_ALIGNMENT (XAXIDMA_BD_MINIMUM_ALIGNMENT*2)
 
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+/* Highest packet threshold: interrupt before half of a ring has completed */
+#define COALESCE_MAX_COUNT(n_desc) \
+	(((n_desc) / 2 > XAXIDMA_COALESCE_MAX) ? XAXIDMA_COALESCE_MAX : \
+	(((n_desc) / 2 > 0) ? (n_desc) / 2 : 1))
+#endif
+
 #if XPAR_INTC_0_HAS_FAST == 1
 /*********** Function Prototypes *********************************************/
 /*
@@ -286,6 +294,11 @@ static void axidma_send_handler(void *arg)
 		xil_printf("%s: Error: axidma error interrupt is asserted\r\n",
 			__FUNCTION__);
 		XAxiDma_Reset(&xaxiemacif->axidma);
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+		/* the reset cleared the coalescing settings of both rings */
+		XAxiDma_CoalesceInvalidate(&xaxiemacif->rx_coalesce);
+		XAxiDma_CoalesceInvalidate(&xaxiemacif->tx_coalesce);
+#endif
 #ifdef OS_IS_FREERTOS
 		xInsideISR--;
 #endif
@@ -293,7 +306,14 @@ static void axidma_send_handler(void *arg)
 	}
 	/* If Transmit done interrupt is asserted, process completed BD's */
 	if (irq_status & (XAXIDMA_IRQ_DELAY_MASK | XAXIDMA_IRQ_IOC_MASK)) {
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+		int free_bds = XAxiDma_BdRingGetFreeCnt(txringptr);
+#endif
 		process_sent_bds(txringptr);
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+		XAxiDma_CoalesceIntr(&xaxiemacif->tx_coalesce,
+				XAxiDma_BdRingGetFreeCnt(txringptr) - free_bds);
+#endif
 	}
 #ifdef OS_IS_FREERTOS
 	xInsideISR--;
@@ -408,6 +428,11 @@ static void axidma_recv_handler(void *arg)
 			}
 			timeOut -= 1;
 		}
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+		/* the reset cleared the coalescing settings of both rings */
+		XAxiDma_CoalesceInvalidate(&xaxiemacif->rx_coalesce);
+		XAxiDma_CoalesceInvalidate(&xaxiemacif->tx_coalesce);
+#endif
 		XAxiDma_BdRingIntEnable(rxring, XAXIDMA_IRQ_ALL_MASK);
 		XAxiDma_Resume(&xaxiemacif->axidma);
 #ifdef OS_IS_FREERTOS
@@ -423,6 +448,9 @@ static void axidma_recv_handler(void *arg)
 		int rx_bytes;
 
 		bd_processed = XAxiDma_BdRingFromHw(rxring, XAXIDMA_ALL_BDS, &rxbdset);
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+		XAxiDma_CoalesceIntr(&xaxiemacif->rx_coalesce, bd_processed);
+#endif
 
 		for (i = 0, rxbd = rxbdset; i < bd_processed; i++) {
 			p = (struct pbuf *)XAxiDma_BdGetId(rxbd);
@@ -622,6 +650,9 @@ XStatus init_axi_dma(struct xemac_s *xemac)
 	XStatus status;
 	u32_t i;
 	xaxiemacif_s *xaxiemacif = (xaxiemacif_s *)(xemac->state);
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+	XAxiDma_CoalesceConfig coalesce_cfg;
+#endif
 #if XPAR_INTC_0_HAS_FAST == 1
 	xaxiemacif_fast = xaxiemacif;
 	xemac_fast = xemac;
@@ -750,6 +781,28 @@ XStatus init_axi_dma(struct xemac_s *xemac)
 		LWIP_DEBUGF(NETIF_DEBUG, ("Error setting coalescing settings\r\n"));
 		return ERR_IF;
 	}
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+	/* let the packet thresholds follow the traffic from here on */
+	coalesce_cfg.TargetLatencyUs = XLWIP_CONFIG_COALESCE_LATENCY_US;
+	coalesce_cfg.TargetIrqRate = 0;
+	coalesce_cfg.TimerPeriodNs = XAXIDMA_COALESCE_TIMER_NS(
+				XLWIP_CONFIG_AXIDMA_SG_CLK_MHZ * 1000000);
+	coalesce_cfg.MinCounter = 1;
+	coalesce_cfg.MaxCounter = COALESCE_MAX_COUNT(XLWIP_CONFIG_N_RX_DESC);
+	status = XAxiDma_CoalesceInitialize(&xaxiemacif->rx_coalesce,
+					rxringptr, &coalesce_cfg);
+	if (status != XST_SUCCESS) {
+		LWIP_DEBUGF(NETIF_DEBUG, ("Error setting up adaptive coalescing\r\n"));
+		return ERR_IF;
+	}
+	coalesce_cfg.MaxCounter = COALESCE_MAX_COUNT(XLWIP_CONFIG_N_TX_DESC);
+	status = XAxiDma_CoalesceInitialize(&xaxiemacif->tx_coalesce,
+					txringptr, &coalesce_cfg);
+	if (status != XST_SUCCESS) {
+		LWIP_DEBUGF(NETIF_DEBUG, ("Error setting up adaptive coalescing\r\n"));
+		return ERR_IF;
+	}
+#endif
 	/* start DMA */
 	status = XAxiDma_BdRingStart(txringptr);
 	if (status != XST_SUCCESS) {
@@ -918,6 +971,31 @@ XStatus init_axi_dma(struct xemac_s *xemac)
 	return 0;
 }
 
+#if XLWIP_CONFIG_COALESCE_LATENCY_US
+/*
+ * xaxiemacif_coalesce_tick():
+ *
+ * Retune the DMA interrupt coalescing of the interface to the traffic seen
+ * since the previous call. To be called periodically, e.g. from the timer
+ * that drives the lwIP TCP timers, with the time elapsed since the previous
+ * call. Every 100 to 250 ms is a good rate.
+ *
+ * The DMA control registers are updated read-modify-write, as are the
+ * interrupt enables in the DMA handlers, so interrupts are masked meanwhile.
+ */
+void xaxiemacif_coalesce_tick(struct netif *netif, u32_t elapsed_ms)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
+	xaxiemacif_s *xaxiemacif = (xaxiemacif_s *)(xemac->state);
+
+	SYS_ARCH_PROTECT(lev);
+	XAxiDma_CoalesceSample(&xaxiemacif->rx_coalesce, elapsed_ms * 1000);
+	XAxiDma_CoalesceSample(&xaxiemacif->tx_coalesce, elapsed_ms * 1000);
+	SYS_ARCH_UNPROTECT(lev);
+}
+#endif
+
 #if XPAR_INTC_0_HAS_FAST == 1
 /****************************** Fast receive Handler *************************/
 static void axidma_recvfast_handler(void)
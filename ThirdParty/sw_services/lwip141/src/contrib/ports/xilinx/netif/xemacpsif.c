@@ -216,6 +216,10 @@ s32_t xemacpsif_input(struct netif *netif)
 	struct eth_hdr *ethhdr;
 	struct pbuf *p;
 	SYS_ARCH_DECL_PROTECT(lev);
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+	struct pbuf *batch[TCPIP_INPKT_BATCH_MAX];
+	u16_t n_batch = 0;
+#endif
 
 #ifdef OS_IS_FREERTOS
 	while (1)
@@ -228,6 +232,9 @@ s32_t xemacpsif_input(struct netif *netif)
 
 		/* no packet could be read, silently ignore this */
 		if (p == NULL) {
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+			xemacif_input_batch(netif, batch, n_batch);
+#endif
 			return 0;
 		}
 
@@ -248,11 +255,19 @@ s32_t xemacpsif_input(struct netif *netif)
 			case ETHTYPE_PPPOE:
 	#endif /* PPPOE_SUPPORT */
 				/* full packet send to tcpip_thread to process */
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+				batch[n_batch++] = p;
+				if (n_batch == TCPIP_INPKT_BATCH_MAX) {
+					xemacif_input_batch(netif, batch, n_batch);
+					n_batch = 0;
+				}
+#else
 				if (netif->input(p, netif) != ERR_OK) {
 					LWIP_DEBUGF(NETIF_DEBUG, ("xemacpsif_input: IP input error\r\n"));
 					pbuf_free(p);
 					p = NULL;
 				}
+#endif
 				break;
 
 			default:
@@ -262,6 +277,9 @@ s32_t xemacpsif_input(struct netif *netif)
 		}
 	}
 
+#if !NO_SYS && TCPIP_INPKT_BATCH_MAX
+	xemacif_input_batch(netif, batch, n_batch);
+#endif
 	return 1;
 }
 
@@ -866,7 +866,14 @@ portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
 	return ulReturn;
 }
 
+#if LWIP_TCPIP_CORE_LOCKING && !configUSE_MUTEXES
+#error "LWIP_TCPIP_CORE_LOCKING requires configUSE_MUTEXES in FreeRTOSConfig.h"
+#endif
+
 /** Create a new mutex
+ * FreeRTOS mutexes are priority-inheriting, so an application thread holding
+ * the lwIP core lock (LWIP_TCPIP_CORE_LOCKING) is boosted while the tcpip
+ * thread waits on it.
  * @param mutex pointer to the mutex to create
  * @return a new mutex */
 err_t sys_mutex_new( sys_mutex_t *pxMutex )
@@ -54,6 +54,11 @@
 
 #include <string.h>
 
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+static err_t netconn_write_internal(struct netconn *conn, const void *dataptr, size_t size,
+                                    u8_t apiflags, size_t *bytes_written, struct netconn_ref *ref);
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
+
 /**
  * Create a new netconn (of a specific type) that has a callback function.
  * The corresponding pcb is also created.
@@ -598,6 +603,20 @@ err_t
 netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size,
                      u8_t apiflags, size_t *bytes_written)
 {
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+  return netconn_write_internal(conn, dataptr, size, apiflags, bytes_written, NULL);
+}
+
+/**
+ * Common part of netconn_write_partly() and netconn_write_ref().
+ *
+ * @param ref release record for a netconn_write_ref() call, NULL otherwise
+ */
+static err_t
+netconn_write_internal(struct netconn *conn, const void *dataptr, size_t size,
+                       u8_t apiflags, size_t *bytes_written, struct netconn_ref *ref)
+{
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
   struct api_msg msg;
   err_t err;
   u8_t dontblock;
@@ -620,6 +639,11 @@ netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size,
   msg.msg.msg.w.dataptr = dataptr;
   msg.msg.msg.w.apiflags = apiflags;
   msg.msg.msg.w.len = size;
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+  msg.msg.msg.w.ref = ref;
+#elif LWIP_NETCONN_ZEROCOPY
+  msg.msg.msg.w.ref = NULL;
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
 #if LWIP_SO_SNDTIMEO
   if (conn->send_timeout != 0) {
     /* get the time we started, which is later compared to
@@ -634,6 +658,12 @@ netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size,
      but if it is, this is done inside api_msg.c:do_write(), so we can use the
      non-blocking version here. */
   err = TCPIP_APIMSG(&msg);
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+  if (msg.msg.msg.w.ref != NULL) {
+    /* do_write() failed before handing the buffer over to do_writemore() */
+    memp_free(MEMP_NETCONN_REF, msg.msg.msg.w.ref);
+  }
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
   if ((err == ERR_OK) && (bytes_written != NULL)) {
     if (dontblock
 #if LWIP_SO_SNDTIMEO
@@ -652,6 +682,61 @@ netconn_write_partly(struct netconn *conn, const void *dataptr, size_t size,
   return err;
 }
 
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+/**
+ * Send data over a TCP netconn without copying it: the queued segments
+ * reference the application buffer directly until the remote side has
+ * acknowledged the data.
+ * ref_fn is called from tcpip_thread once the stack does not reference the
+ * buffer any more (this also happens if the call fails after part of the
+ * buffer has been enqueued). Until then, the buffer must not be modified.
+ * Closing the netconn waits until all such buffers have been released.
+ *
+ * @param conn the TCP netconn over which to send data
+ * @param dataptr pointer to the application buffer that contains the data to send
+ * @param size size of the application data to send
+ * @param apiflags NETCONN_MORE and/or NETCONN_DONTBLOCK (NETCONN_COPY is ignored)
+ * @param bytes_written pointer to a location that receives the number of written bytes
+ * @param ref_fn function called when the buffer is released
+ * @param arg argument passed to ref_fn
+ * @return ERR_OK if data was sent, any other err_t on error
+ */
+err_t
+netconn_write_ref(struct netconn *conn, const void *dataptr, size_t size,
+                  u8_t apiflags, size_t *bytes_written,
+                  netconn_ref_fn ref_fn, void *arg)
+{
+  struct netconn_ref *ref;
+  err_t err;
+
+  LWIP_ERROR("netconn_write_ref: invalid conn",  (conn != NULL), return ERR_ARG;);
+  LWIP_ERROR("netconn_write_ref: invalid conn->type",  (conn->type == NETCONN_TCP), return ERR_VAL;);
+  LWIP_ERROR("netconn_write_ref: invalid ref_fn",  (ref_fn != NULL), return ERR_ARG;);
+  if (size == 0) {
+    return ERR_OK;
+  }
+  if ((netconn_is_nonblocking(conn) || (apiflags & NETCONN_DONTBLOCK)) &&
+      (bytes_written == NULL)) {
+    return ERR_VAL;
+  }
+
+  ref = (struct netconn_ref *)memp_malloc(MEMP_NETCONN_REF);
+  if (ref == NULL) {
+    return ERR_MEM;
+  }
+  ref->next = NULL;
+  ref->dataptr = dataptr;
+  ref->len = 0;
+  ref->ref_fn = ref_fn;
+  ref->arg = arg;
+
+  /* ownership of ref passes to do_writemore() */
+  err = netconn_write_internal(conn, dataptr, size,
+                               (u8_t)(apiflags & ~NETCONN_COPY), bytes_written, ref);
+  return err;
+}
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
+
 /**
  * Close ot shutdown a TCP netconn (doesn't delete it).
  *
@@ -45,6 +45,9 @@
 #include "lwip/ip.h"
 #include "lwip/udp.h"
 #include "lwip/tcp.h"
+#if LWIP_NETCONN_ZEROCOPY
+#include "lwip/tcp_impl.h"
+#endif /* LWIP_NETCONN_ZEROCOPY */
 #include "lwip/raw.h"
 
 #include "lwip/memp.h"
@@ -64,6 +67,10 @@
 #if LWIP_TCP
 static err_t do_writemore(struct netconn *conn);
 static void do_close_internal(struct netconn *conn);
+#if LWIP_NETCONN_ZEROCOPY
+static void netconn_ref_enqueue(struct netconn *conn, struct netconn_ref *ref, size_t len);
+static void netconn_ref_release(struct netconn *conn, err_t err);
+#endif /* LWIP_NETCONN_ZEROCOPY */
 #endif
 
 #if LWIP_RAW
@@ -317,6 +324,11 @@ sent_tcp(void *arg, struct tcp_pcb *pcb, u16_t len)
   LWIP_UNUSED_ARG(pcb);
   LWIP_ASSERT("conn != NULL", (conn != NULL));
 
+#if LWIP_NETCONN_ZEROCOPY
+  /* release application buffers before a pending close checks for them */
+  netconn_ref_release(conn, ERR_OK);
+#endif /* LWIP_NETCONN_ZEROCOPY */
+
   if (conn->state == NETCONN_WRITE) {
     do_writemore(conn);
   } else if (conn->state == NETCONN_CLOSE) {
@@ -364,6 +376,15 @@ err_tcp(void *arg, err_t err)
   old_state = conn->state;
   conn->state = NETCONN_NONE;
 
+#if LWIP_NETCONN_ZEROCOPY
+  /* the pcb and its segments are gone: release all application buffers */
+  if ((old_state == NETCONN_WRITE) && (conn->current_msg->msg.w.ref != NULL)) {
+    netconn_ref_enqueue(conn, conn->current_msg->msg.w.ref, conn->write_offset);
+    conn->current_msg->msg.w.ref = NULL;
+  }
+  netconn_ref_release(conn, err);
+#endif /* LWIP_NETCONN_ZEROCOPY */
+
   /* Notify the user layer about a connection error. Used to signal
      select. */
   API_EVENT(conn, NETCONN_EVT_ERROR, 0);
@@ -629,6 +650,10 @@ netconn_alloc(enum netconn_type t, netconn_callback callback)
 #if LWIP_TCP
   conn->current_msg  = NULL;
   conn->write_offset = 0;
+#if LWIP_NETCONN_ZEROCOPY
+  conn->refs_head    = NULL;
+  conn->refs_tail    = NULL;
+#endif /* LWIP_NETCONN_ZEROCOPY */
 #endif /* LWIP_TCP */
 #if LWIP_SO_SNDTIMEO
   conn->send_timeout = 0;
@@ -662,6 +687,10 @@ netconn_free(struct netconn *conn)
 #if LWIP_TCP
   LWIP_ASSERT("acceptmbox must be deallocated before calling this function",
     !sys_mbox_valid(&conn->acceptmbox));
+#if LWIP_NETCONN_ZEROCOPY
+  LWIP_ASSERT("application buffers must be released before calling this function",
+    conn->refs_head == NULL);
+#endif /* LWIP_NETCONN_ZEROCOPY */
 #endif /* LWIP_TCP */
 
   sys_sem_free(&conn->op_completed);
@@ -761,6 +790,16 @@ do_close_internal(struct netconn *conn)
   /* shutting down both ends is the same as closing */
   close = shut == NETCONN_SHUT_RDWR;
 
+#if LWIP_NETCONN_ZEROCOPY
+  if (shut_tx && (conn->refs_head != NULL)) {
+    /* Segments still reference application buffers passed to
+       netconn_write_ref(): wait for their ACK, sent_tcp or poll_tcp
+       call us again. */
+    tcp_output(conn->pcb.tcp);
+    return;
+  }
+#endif /* LWIP_NETCONN_ZEROCOPY */
+
   /* Set back some callback pointers */
   if (close) {
     tcp_arg(conn->pcb.tcp, NULL);
@@ -1193,6 +1232,63 @@ do_recv(struct api_msg_msg *msg)
   TCPIP_APIMSG_ACK(msg);
 }
 
+#if LWIP_NETCONN_ZEROCOPY
+/**
+ * Append the release record of a netconn_write_ref() call to the list of
+ * buffers waiting to be acknowledged. Records of which nothing has been
+ * enqueued are freed right away.
+ *
+ * @param conn the TCP netconn the data was written to
+ * @param ref the release record
+ * @param len number of bytes enqueued from the buffer
+ */
+static void
+netconn_ref_enqueue(struct netconn *conn, struct netconn_ref *ref, size_t len)
+{
+  if (len == 0) {
+    memp_free(MEMP_NETCONN_REF, ref);
+    return;
+  }
+  ref->len = len;
+  ref->next = NULL;
+  /* the pcb might be gone already, the record is released right away then */
+  ref->end_seqno = (conn->pcb.tcp != NULL) ? conn->pcb.tcp->snd_lbb : 0;
+  if (conn->refs_tail != NULL) {
+    conn->refs_tail->next = ref;
+  } else {
+    conn->refs_head = ref;
+  }
+  conn->refs_tail = ref;
+}
+
+/**
+ * Call the release callbacks of all buffers that have been acknowledged
+ * completely, or of all buffers if an error is passed.
+ *
+ * @param conn the TCP netconn
+ * @param err ERR_OK to release acknowledged buffers only, or the error
+ *            that aborted the connection
+ */
+static void
+netconn_ref_release(struct netconn *conn, err_t err)
+{
+  struct netconn_ref *ref;
+
+  while ((ref = conn->refs_head) != NULL) {
+    if ((err == ERR_OK) && (conn->pcb.tcp != NULL) &&
+        TCP_SEQ_LT(conn->pcb.tcp->lastack, ref->end_seqno)) {
+      break;
+    }
+    conn->refs_head = ref->next;
+    if (conn->refs_head == NULL) {
+      conn->refs_tail = NULL;
+    }
+    ref->ref_fn(conn, ref->arg, ref->dataptr, ref->len, err);
+    memp_free(MEMP_NETCONN_REF, ref);
+  }
+}
+#endif /* LWIP_NETCONN_ZEROCOPY */
+
 /**
  * See if more data needs to be written from a previous call to netconn_write.
  * Called initially from do_write. If the first call can't send all data
@@ -1313,6 +1409,14 @@ err_mem:
     }
   }
   if (write_finished) {
+#if LWIP_NETCONN_ZEROCOPY
+    if (conn->current_msg->msg.w.ref != NULL) {
+      /* hand the buffer over to the list waiting for ACKs */
+      netconn_ref_enqueue(conn, conn->current_msg->msg.w.ref,
+        (err == ERR_OK) ? conn->current_msg->msg.w.len : conn->write_offset);
+      conn->current_msg->msg.w.ref = NULL;
+    }
+#endif /* LWIP_NETCONN_ZEROCOPY */
     /* everything was written: set back connection state
        and back to application task */
     conn->current_msg->err = err;
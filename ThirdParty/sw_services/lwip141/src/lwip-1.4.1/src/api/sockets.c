@@ -786,6 +786,125 @@ lwip_send(int s, const void *data, size_t size, int flags)
   return (err == ERR_OK ? (int)written : -1);
 }
 
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+/**
+ * Receive data from a TCP socket without copying it: the pbuf chain holding
+ * the next received data is handed over to the caller, who must pbuf_free()
+ * it. The receive window is updated as if the data had been read.
+ *
+ * @param s the TCP socket
+ * @param p pointer where the received pbuf chain is stored
+ * @param flags MSG_DONTWAIT or 0
+ * @return number of bytes in *p, 0 if the connection was closed, -1 on error
+ */
+int
+lwip_recv_pbuf(int s, struct pbuf **p, int flags)
+{
+  struct lwip_sock *sock;
+  struct pbuf      *buf = NULL;
+  struct pbuf      *q;
+  u16_t            off;
+  err_t            err;
+
+  LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_pbuf(%d, 0x%x)\n", s, flags));
+  sock = get_socket(s);
+  if (!sock) {
+    return -1;
+  }
+  if ((p == NULL) || (netconn_type(sock->conn) != NETCONN_TCP)) {
+    sock_set_errno(sock, err_to_errno(ERR_ARG));
+    return -1;
+  }
+  *p = NULL;
+
+  if (sock->lastdata) {
+    /* hand over what is left from a previous lwip_recvfrom() */
+    buf = (struct pbuf *)sock->lastdata;
+    off = sock->lastoffset;
+    sock->lastdata = NULL;
+    sock->lastoffset = 0;
+    while (off >= buf->len) {
+      /* drop pbufs that have been read completely */
+      off -= buf->len;
+      q = buf->next;
+      LWIP_ASSERT("lastoffset beyond lastdata", q != NULL);
+      pbuf_ref(q);
+      pbuf_dechain(buf);
+      pbuf_free(buf);
+      buf = q;
+    }
+    if (off > 0) {
+      pbuf_header(buf, -(s16_t)off);
+    }
+  } else {
+    if (((flags & MSG_DONTWAIT) || netconn_is_nonblocking(sock->conn)) &&
+        (sock->rcvevent <= 0)) {
+      LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_pbuf(%d): returning EWOULDBLOCK\n", s));
+      sock_set_errno(sock, EWOULDBLOCK);
+      return -1;
+    }
+    err = netconn_recv_tcp_pbuf(sock->conn, &buf);
+    if (err != ERR_OK) {
+      LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recv_pbuf(%d): error is \"%s\"!\n",
+        s, lwip_strerr(err)));
+      sock_set_errno(sock, err_to_errno(err));
+      return (err == ERR_CLSD) ? 0 : -1;
+    }
+    LWIP_ASSERT("buf != NULL", buf != NULL);
+  }
+
+  /* update receive window */
+  netconn_recved(sock->conn, (u32_t)buf->tot_len);
+  *p = buf;
+  sock_set_errno(sock, 0);
+  return buf->tot_len;
+}
+
+/**
+ * Send data over a TCP socket without copying it (see netconn_write_ref()):
+ * the buffer must stay untouched until ref_fn is called from tcpip_thread.
+ *
+ * @param s the TCP socket
+ * @param data the application buffer
+ * @param size number of bytes to send
+ * @param flags MSG_MORE and/or MSG_DONTWAIT
+ * @param ref_fn function called when the stack releases the buffer
+ * @param arg argument passed to ref_fn
+ * @return number of bytes enqueued, -1 on error
+ */
+int
+lwip_send_ref(int s, const void *data, size_t size, int flags,
+              netconn_ref_fn ref_fn, void *arg)
+{
+  struct lwip_sock *sock;
+  err_t err;
+  u8_t write_flags;
+  size_t written;
+
+  LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_ref(%d, data=%p, size=%"SZT_F", flags=0x%x)\n",
+                              s, data, size, flags));
+
+  sock = get_socket(s);
+  if (!sock) {
+    return -1;
+  }
+
+  if (sock->conn->type != NETCONN_TCP) {
+    sock_set_errno(sock, err_to_errno(ERR_ARG));
+    return -1;
+  }
+
+  write_flags = ((flags & MSG_MORE)     ? NETCONN_MORE      : 0) |
+                ((flags & MSG_DONTWAIT) ? NETCONN_DONTBLOCK : 0);
+  written = 0;
+  err = netconn_write_ref(sock->conn, data, size, write_flags, &written, ref_fn, arg);
+
+  LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_send_ref(%d) err=%d written=%"SZT_F"\n", s, err, written));
+  sock_set_errno(sock, err_to_errno(err));
+  return (err == ERR_OK ? (int)written : -1);
+}
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
+
 int
 lwip_sendto(int s, const void *data, size_t size, int flags,
        const struct sockaddr *to, socklen_t tolen)
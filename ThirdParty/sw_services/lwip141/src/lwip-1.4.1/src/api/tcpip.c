@@ -46,9 +46,12 @@
 #include "lwip/pbuf.h"
 #include "lwip/tcpip.h"
 #include "lwip/init.h"
+#include "lwip/ip.h"
 #include "netif/etharp.h"
 #include "netif/ppp_oe.h"
 
+#include <string.h>
+
 /* global variables */
 static tcpip_init_done_fn tcpip_init_done;
 static void *tcpip_init_done_arg;
@@ -60,6 +63,103 @@ sys_mutex_t lock_tcpip_core;
 #endif /* LWIP_TCPIP_CORE_LOCKING */
 
 
+/**
+ * Pass a received packet to the ethernet or IP layer, depending on the
+ * type of the netif it was received on.
+ */
+static err_t
+tcpip_input_packet(struct pbuf *p, struct netif *inp)
+{
+#if LWIP_ETHERNET
+  if (inp->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
+    return ethernet_input(p, inp);
+  } else
+#endif /* LWIP_ETHERNET */
+  {
+    return ip_input(p, inp);
+  }
+}
+
+/**
+ * Process one message posted to the tcpip_thread mailbox.
+ * Called with the core locked.
+ *
+ * @param msg the message to process
+ */
+static void
+tcpip_thread_handle_msg(struct tcpip_msg *msg)
+{
+#if TCPIP_INPKT_BATCH_MAX && !LWIP_TCPIP_CORE_LOCKING_INPUT
+  struct tcpip_inpkt_batch *batch;
+  u16_t i;
+#endif /* TCPIP_INPKT_BATCH_MAX && !LWIP_TCPIP_CORE_LOCKING_INPUT */
+
+  switch (msg->type) {
+#if LWIP_NETCONN
+  case TCPIP_MSG_API:
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: API message %p\n", (void *)msg));
+    msg->msg.apimsg->function(&(msg->msg.apimsg->msg));
+    break;
+#endif /* LWIP_NETCONN */
+
+#if !LWIP_TCPIP_CORE_LOCKING_INPUT
+  case TCPIP_MSG_INPKT:
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: PACKET %p\n", (void *)msg));
+    tcpip_input_packet(msg->msg.inp.p, msg->msg.inp.netif);
+    memp_free(MEMP_TCPIP_MSG_INPKT, msg);
+    break;
+
+#if TCPIP_INPKT_BATCH_MAX
+  case TCPIP_MSG_INPKT_BATCH:
+    batch = (struct tcpip_inpkt_batch *)msg;
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: PACKET BATCH %p (%"U16_F")\n",
+      (void *)batch, batch->count));
+    for (i = 0; i < batch->count; i++) {
+      tcpip_input_packet(batch->p[i], batch->netif);
+    }
+    memp_free(MEMP_TCPIP_MSG_INPKT_BATCH, batch);
+    break;
+#endif /* TCPIP_INPKT_BATCH_MAX */
+#endif /* LWIP_TCPIP_CORE_LOCKING_INPUT */
+
+#if LWIP_NETIF_API
+  case TCPIP_MSG_NETIFAPI:
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: Netif API message %p\n", (void *)msg));
+    msg->msg.netifapimsg->function(&(msg->msg.netifapimsg->msg));
+    break;
+#endif /* LWIP_NETIF_API */
+
+#if LWIP_TCPIP_TIMEOUT
+  case TCPIP_MSG_TIMEOUT:
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: TIMEOUT %p\n", (void *)msg));
+    sys_timeout(msg->msg.tmo.msecs, msg->msg.tmo.h, msg->msg.tmo.arg);
+    memp_free(MEMP_TCPIP_MSG_API, msg);
+    break;
+  case TCPIP_MSG_UNTIMEOUT:
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: UNTIMEOUT %p\n", (void *)msg));
+    sys_untimeout(msg->msg.tmo.h, msg->msg.tmo.arg);
+    memp_free(MEMP_TCPIP_MSG_API, msg);
+    break;
+#endif /* LWIP_TCPIP_TIMEOUT */
+
+  case TCPIP_MSG_CALLBACK:
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: CALLBACK %p\n", (void *)msg));
+    msg->msg.cb.function(msg->msg.cb.ctx);
+    memp_free(MEMP_TCPIP_MSG_API, msg);
+    break;
+
+  case TCPIP_MSG_CALLBACK_STATIC:
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: CALLBACK_STATIC %p\n", (void *)msg));
+    msg->msg.cb.function(msg->msg.cb.ctx);
+    break;
+
+  default:
+    LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: invalid message: %d\n", msg->type));
+    LWIP_ASSERT("tcpip_thread: invalid message", 0);
+    break;
+  }
+}
+
 /**
  * The main lwIP thread. This thread has exclusive access to lwIP core functions
  * (unless access to them is not locked). Other threads communicate with this
@@ -74,6 +174,9 @@ static void
 tcpip_thread(void *arg)
 {
   struct tcpip_msg *msg;
+#if TCPIP_MBOX_BATCH
+  u32_t batch;
+#endif /* TCPIP_MBOX_BATCH */
   LWIP_UNUSED_ARG(arg);
 
   if (tcpip_init_done != NULL) {
@@ -87,65 +190,17 @@ tcpip_thread(void *arg)
     /* wait for a message, timeouts are processed while waiting */
     sys_timeouts_mbox_fetch(&mbox, (void **)&msg);
     LOCK_TCPIP_CORE();
-    switch (msg->type) {
-#if LWIP_NETCONN
-    case TCPIP_MSG_API:
-      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: API message %p\n", (void *)msg));
-      msg->msg.apimsg->function(&(msg->msg.apimsg->msg));
-      break;
-#endif /* LWIP_NETCONN */
-
-#if !LWIP_TCPIP_CORE_LOCKING_INPUT
-    case TCPIP_MSG_INPKT:
-      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: PACKET %p\n", (void *)msg));
-#if LWIP_ETHERNET
-      if (msg->msg.inp.netif->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
-        ethernet_input(msg->msg.inp.p, msg->msg.inp.netif);
-      } else
-#endif /* LWIP_ETHERNET */
-      {
-        ip_input(msg->msg.inp.p, msg->msg.inp.netif);
+    tcpip_thread_handle_msg(msg);
+#if TCPIP_MBOX_BATCH
+    /* drain what has been posted in the meantime without blocking,
+       checking the timeouts or releasing the core lock in between */
+    for (batch = 0; batch < TCPIP_MBOX_BATCH; batch++) {
+      if (sys_mbox_tryfetch(&mbox, (void **)&msg) == SYS_MBOX_EMPTY) {
+        break;
       }
-      memp_free(MEMP_TCPIP_MSG_INPKT, msg);
-      break;
-#endif /* LWIP_TCPIP_CORE_LOCKING_INPUT */
-
-#if LWIP_NETIF_API
-    case TCPIP_MSG_NETIFAPI:
-      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: Netif API message %p\n", (void *)msg));
-      msg->msg.netifapimsg->function(&(msg->msg.netifapimsg->msg));
-      break;
-#endif /* LWIP_NETIF_API */
-
-#if LWIP_TCPIP_TIMEOUT
-    case TCPIP_MSG_TIMEOUT:
-      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: TIMEOUT %p\n", (void *)msg));
-      sys_timeout(msg->msg.tmo.msecs, msg->msg.tmo.h, msg->msg.tmo.arg);
-      memp_free(MEMP_TCPIP_MSG_API, msg);
-      break;
-    case TCPIP_MSG_UNTIMEOUT:
-      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: UNTIMEOUT %p\n", (void *)msg));
-      sys_untimeout(msg->msg.tmo.h, msg->msg.tmo.arg);
-      memp_free(MEMP_TCPIP_MSG_API, msg);
-      break;
-#endif /* LWIP_TCPIP_TIMEOUT */
-
-    case TCPIP_MSG_CALLBACK:
-      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: CALLBACK %p\n", (void *)msg));
-      msg->msg.cb.function(msg->msg.cb.ctx);
-      memp_free(MEMP_TCPIP_MSG_API, msg);
-      break;
-
-    case TCPIP_MSG_CALLBACK_STATIC:
-      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: CALLBACK_STATIC %p\n", (void *)msg));
-      msg->msg.cb.function(msg->msg.cb.ctx);
-      break;
-
-    default:
-      LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_thread: invalid message: %d\n", msg->type));
-      LWIP_ASSERT("tcpip_thread: invalid message", 0);
-      break;
+      tcpip_thread_handle_msg(msg);
     }
+#endif /* TCPIP_MBOX_BATCH */
   }
 }
 
@@ -164,14 +219,7 @@ tcpip_input(struct pbuf *p, struct netif *inp)
   err_t ret;
   LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_input: PACKET %p/%p\n", (void *)p, (void *)inp));
   LOCK_TCPIP_CORE();
-#if LWIP_ETHERNET
-  if (inp->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
-    ret = ethernet_input(p, inp);
-  } else
-#endif /* LWIP_ETHERNET */
-  {
-    ret = ip_input(p, inp);
-  }
+  ret = tcpip_input_packet(p, inp);
   UNLOCK_TCPIP_CORE();
   return ret;
 #else /* LWIP_TCPIP_CORE_LOCKING_INPUT */
@@ -196,6 +244,58 @@ tcpip_input(struct pbuf *p, struct netif *inp)
 #endif /* LWIP_TCPIP_CORE_LOCKING_INPUT */
 }
 
+#if TCPIP_INPKT_BATCH_MAX
+/**
+ * Pass a batch of received packets to tcpip_thread for input processing
+ * with a single message, saving the mailbox round trip per packet.
+ * On error, none of the packets has been taken over and the caller has
+ * to free them.
+ *
+ * @param p array of received packets (see tcpip_input())
+ * @param count number of packets in p, at most TCPIP_INPKT_BATCH_MAX
+ * @param inp the network interface on which the packets were received
+ */
+err_t
+tcpip_input_batch(struct pbuf **p, u16_t count, struct netif *inp)
+{
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+  u16_t i;
+
+  LWIP_DEBUGF(TCPIP_DEBUG, ("tcpip_input_batch: %"U16_F" PACKETS/%p\n", count, (void *)inp));
+  LOCK_TCPIP_CORE();
+  for (i = 0; i < count; i++) {
+    tcpip_input_packet(p[i], inp);
+  }
+  UNLOCK_TCPIP_CORE();
+  return ERR_OK;
+#else /* LWIP_TCPIP_CORE_LOCKING_INPUT */
+  struct tcpip_inpkt_batch *batch;
+
+  LWIP_ASSERT("tcpip_input_batch: invalid count", count <= TCPIP_INPKT_BATCH_MAX);
+  if (count == 0) {
+    return ERR_OK;
+  }
+  if (!sys_mbox_valid(&mbox)) {
+    return ERR_VAL;
+  }
+  batch = (struct tcpip_inpkt_batch *)memp_malloc(MEMP_TCPIP_MSG_INPKT_BATCH);
+  if (batch == NULL) {
+    return ERR_MEM;
+  }
+
+  batch->msg.type = TCPIP_MSG_INPKT_BATCH;
+  batch->netif = inp;
+  batch->count = count;
+  MEMCPY(batch->p, p, count * sizeof(struct pbuf *));
+  if (sys_mbox_trypost(&mbox, &batch->msg) != ERR_OK) {
+    memp_free(MEMP_TCPIP_MSG_INPKT_BATCH, batch);
+    return ERR_MEM;
+  }
+  return ERR_OK;
+#endif /* LWIP_TCPIP_CORE_LOCKING_INPUT */
+}
+#endif /* TCPIP_INPKT_BATCH_MAX */
+
 /**
  * Call a specific function in the thread context of
  * tcpip_thread for easy access synchronization.
@@ -119,9 +119,24 @@
   #error "MEMP_NUM_REASSDATA > IP_REASS_MAX_PBUFS doesn't make sense since each struct ip_reassdata must hold 2 pbufs at least!"
 #endif
 #endif /* !MEMP_MEM_MALLOC */
+#if LWIP_WND_SCALE
+#if (LWIP_TCP && (TCP_WND > (0xffffUL << TCP_RCV_SCALE)))
+  #error "TCP_WND is too big for TCP_RCV_SCALE, increase TCP_RCV_SCALE or reduce TCP_WND in your lwipopts.h"
+#endif
+#if (LWIP_TCP && (TCP_RCV_SCALE > 14))
+  #error "TCP_RCV_SCALE must not be larger than 14 (RFC 7323)"
+#endif
+#else /* LWIP_WND_SCALE */
 #if (LWIP_TCP && (TCP_WND > 0xffff))
   #error "If you want to use TCP, TCP_WND must fit in an u16_t, so, you have to reduce it in your lwipopts.h"
 #endif
+#if (LWIP_TCP && (TCP_SND_BUF > 0xffff))
+  #error "If you want to use TCP, TCP_SND_BUF must fit in an u16_t unless LWIP_WND_SCALE is enabled"
+#endif
+#endif /* LWIP_WND_SCALE */
+#if (LWIP_TCP && LWIP_TCP_SACK && !TCP_QUEUE_OOSEQ)
+  #error "LWIP_TCP_SACK needs TCP_QUEUE_OOSEQ"
+#endif
 #if (LWIP_TCP && (TCP_SND_QUEUELEN > 0xffff))
   #error "If you want to use TCP, TCP_SND_QUEUELEN must fit in an u16_t, so, you have to reduce it in your lwipopts.h"
 #endif
@@ -113,6 +113,13 @@ struct tcp_pcb *tcp_tw_pcbs;
 struct tcp_pcb ** const tcp_pcb_lists[] = {&tcp_listen_pcbs.pcbs, &tcp_bound_pcbs,
   &tcp_active_pcbs, &tcp_tw_pcbs};
 
+#if LWIP_PCB_HASH
+/** Hash table of the PCBs in tcp_active_pcbs */
+struct tcp_pcb *tcp_active_pcbs_hash[TCP_PCB_HASH_SIZE];
+/** Hash table of the PCBs in tcp_listen_pcbs */
+union tcp_listen_pcbs_t tcp_listen_pcbs_hash[TCP_PCB_HASH_SIZE];
+#endif /* LWIP_PCB_HASH */
+
 /** Only used for temporary storage. */
 struct tcp_pcb *tcp_tmp_pcb;
 
@@ -172,7 +179,7 @@ tcp_close_shutdown(struct tcp_pcb *pcb, u8_t rst_on_unacked_data)
   err_t err;
 
   if (rst_on_unacked_data && ((pcb->state == ESTABLISHED) || (pcb->state == CLOSE_WAIT))) {
-    if ((pcb->refused_data != NULL) || (pcb->rcv_wnd != TCP_WND)) {
+    if ((pcb->refused_data != NULL) || (pcb->rcv_wnd != TCP_WND_MAX(pcb))) {
       /* Not all data received by application, send RST to tell the remote
          side about this. */
       LWIP_ASSERT("pcb->flags & TF_RXCLOSED", pcb->flags & TF_RXCLOSED);
@@ -580,7 +587,7 @@ u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb)
 {
   u32_t new_right_edge = pcb->rcv_nxt + pcb->rcv_wnd;
 
-  if (TCP_SEQ_GEQ(new_right_edge, pcb->rcv_ann_right_edge + LWIP_MIN((TCP_WND / 2), pcb->mss))) {
+  if (TCP_SEQ_GEQ(new_right_edge, pcb->rcv_ann_right_edge + LWIP_MIN((TCP_WND_MAX(pcb) / 2), pcb->mss))) {
     /* we can advertise more window */
     pcb->rcv_ann_wnd = pcb->rcv_wnd;
     return new_right_edge - pcb->rcv_ann_right_edge;
@@ -592,8 +599,10 @@ u32_t tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb)
     } else {
       /* keep the right edge of window constant */
       u32_t new_rcv_ann_wnd = pcb->rcv_ann_right_edge - pcb->rcv_nxt;
+#if !LWIP_WND_SCALE
       LWIP_ASSERT("new_rcv_ann_wnd <= 0xffff", new_rcv_ann_wnd <= 0xffff);
-      pcb->rcv_ann_wnd = (u16_t)new_rcv_ann_wnd;
+#endif /* !LWIP_WND_SCALE */
+      pcb->rcv_ann_wnd = (tcpwnd_size_t)new_rcv_ann_wnd;
     }
     return 0;
   }
@@ -611,16 +620,18 @@ void
 tcp_recved(struct tcp_pcb *pcb, u16_t len)
 {
   int wnd_inflation;
+  tcpwnd_size_t rcv_wnd;
 
   /* pcb->state LISTEN not allowed here */
   LWIP_ASSERT("don't call tcp_recved for listen-pcbs",
     pcb->state != LISTEN);
-  LWIP_ASSERT("tcp_recved: len would wrap rcv_wnd\n",
-              len <= 0xffff - pcb->rcv_wnd );
 
-  pcb->rcv_wnd += len;
-  if (pcb->rcv_wnd > TCP_WND) {
-    pcb->rcv_wnd = TCP_WND;
+  rcv_wnd = (tcpwnd_size_t)(pcb->rcv_wnd + len);
+  if ((rcv_wnd > TCP_WND_MAX(pcb)) || (rcv_wnd < pcb->rcv_wnd)) {
+    /* window got too big or tcpwnd_size_t wrapped */
+    pcb->rcv_wnd = TCP_WND_MAX(pcb);
+  } else {
+    pcb->rcv_wnd = rcv_wnd;
   }
 
   wnd_inflation = tcp_update_rcv_ann_wnd(pcb);
@@ -634,8 +645,8 @@ tcp_recved(struct tcp_pcb *pcb, u16_t len)
     tcp_output(pcb);
   }
 
-  LWIP_DEBUGF(TCP_DEBUG, ("tcp_recved: recveived %"U16_F" bytes, wnd %"U16_F" (%"U16_F").\n",
-         len, pcb->rcv_wnd, TCP_WND - pcb->rcv_wnd));
+  LWIP_DEBUGF(TCP_DEBUG, ("tcp_recved: recveived %"U16_F" bytes, wnd %"TCPWNDSIZE_F" (%"TCPWNDSIZE_F").\n",
+         len, pcb->rcv_wnd, TCP_WND_MAX(pcb) - pcb->rcv_wnd));
 }
 
 /**
@@ -743,8 +754,12 @@ tcp_connect(struct tcp_pcb *pcb, ip_addr_t *ipaddr, u16_t port,
   pcb->snd_nxt = iss;
   pcb->lastack = iss - 1;
   pcb->snd_lbb = iss - 1;
-  pcb->rcv_wnd = TCP_WND;
-  pcb->rcv_ann_wnd = TCP_WND;
+#if LWIP_TCP_SACK
+  pcb->recover = pcb->lastack;
+#endif /* LWIP_TCP_SACK */
+  /* the window scale option is not negotiated yet */
+  pcb->rcv_wnd = TCPWND_MIN16(TCP_WND);
+  pcb->rcv_ann_wnd = TCPWND_MIN16(TCP_WND);
   pcb->rcv_ann_right_edge = pcb->rcv_nxt;
   pcb->snd_wnd = TCP_WND;
   /* As initial send MSS, we use TCP_MSS but limit it to 536.
@@ -788,7 +803,7 @@ void
 tcp_slowtmr(void)
 {
   struct tcp_pcb *pcb, *prev;
-  u16_t eff_wnd;
+  tcpwnd_size_t eff_wnd;
   u8_t pcb_remove;      /* flag if a PCB should be removed */
   u8_t pcb_reset;       /* flag if a RST should be sent when removing */
   err_t err;
@@ -867,8 +882,8 @@ tcp_slowtmr_start:
             pcb->ssthresh = (pcb->mss << 1);
           }
           pcb->cwnd = pcb->mss;
-          LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_slowtmr: cwnd %"U16_F
-                                       " ssthresh %"U16_F"\n",
+          LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_slowtmr: cwnd %"TCPWNDSIZE_F
+                                       " ssthresh %"TCPWNDSIZE_F"\n",
                                        pcb->cwnd, pcb->ssthresh));
 
           /* The following needs to be called AFTER cwnd is set to one
@@ -958,6 +973,9 @@ tcp_slowtmr_start:
         LWIP_ASSERT("tcp_slowtmr: first pcb == tcp_active_pcbs", tcp_active_pcbs == pcb);
         tcp_active_pcbs = pcb->next;
       }
+#if LWIP_PCB_HASH
+      tcp_pcb_hash_remove(&tcp_active_pcbs, pcb);
+#endif /* LWIP_PCB_HASH */
 
       if (pcb_reset) {
         tcp_rst(pcb->snd_nxt, pcb->rcv_nxt, &pcb->local_ip, &pcb->remote_ip,
@@ -1098,7 +1116,7 @@ tcp_process_refused_data(struct tcp_pcb *pcb)
     if (refused_flags & PBUF_FLAG_TCP_FIN) {
       /* correct rcv_wnd as the application won't call tcp_recved()
          for the FIN's seqno */
-      if (pcb->rcv_wnd != TCP_WND) {
+      if (pcb->rcv_wnd != TCP_WND_MAX(pcb)) {
         pcb->rcv_wnd++;
       }
       TCP_EVENT_CLOSED(pcb, err);
@@ -1308,8 +1326,9 @@ tcp_alloc(u8_t prio)
     pcb->prio = prio;
     pcb->snd_buf = TCP_SND_BUF;
     pcb->snd_queuelen = 0;
-    pcb->rcv_wnd = TCP_WND;
-    pcb->rcv_ann_wnd = TCP_WND;
+    /* the window scale option is not negotiated yet */
+    pcb->rcv_wnd = TCPWND_MIN16(TCP_WND);
+    pcb->rcv_ann_wnd = TCPWND_MIN16(TCP_WND);
     pcb->tos = 0;
     pcb->ttl = TCP_TTL;
     /* As initial send MSS, we use TCP_MSS but limit it to 536.
@@ -1325,6 +1344,9 @@ tcp_alloc(u8_t prio)
     pcb->snd_nxt = iss;
     pcb->lastack = iss;
     pcb->snd_lbb = iss;
+#if LWIP_TCP_SACK
+    pcb->recover = iss;
+#endif /* LWIP_TCP_SACK */
     pcb->tmr = tcp_ticks;
     pcb->last_timer = tcp_timer_ctr;
 
@@ -1528,6 +1550,65 @@ tcp_pcb_purge(struct tcp_pcb *pcb)
   }
 }
 
+#if LWIP_PCB_HASH
+/**
+ * Returns the hash bucket of a PCB that is on the given PCB list, or NULL
+ * if that list is not hashed.
+ */
+static struct tcp_pcb **
+tcp_pcb_hash_bucket(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+  if (pcbs == &tcp_active_pcbs) {
+    return &tcp_active_pcbs_hash[TCP_PCB_HASH(pcb->local_port, pcb->remote_port, &pcb->remote_ip)];
+  }
+  if (pcbs == &tcp_listen_pcbs.pcbs) {
+    return &tcp_listen_pcbs_hash[TCP_LISTEN_PCB_HASH(pcb->local_port)].pcbs;
+  }
+  return NULL;
+}
+
+/**
+ * Adds a PCB that was just registered with a PCB list to the matching
+ * hash table (called through TCP_REG).
+ *
+ * @param pcbs PCB list the pcb was added to
+ * @param pcb tcp_pcb to add
+ */
+void
+tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+  struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, pcb);
+
+  if (bucket != NULL) {
+    pcb->hash_next = *bucket;
+    *bucket = pcb;
+  }
+}
+
+/**
+ * Removes a PCB that is taken off a PCB list from the matching hash table
+ * (called through TCP_RMV).
+ *
+ * @param pcbs PCB list the pcb is removed from
+ * @param pcb tcp_pcb to remove
+ */
+void
+tcp_pcb_hash_remove(struct tcp_pcb **pcbs, struct tcp_pcb *pcb)
+{
+  struct tcp_pcb **bucket = tcp_pcb_hash_bucket(pcbs, pcb);
+
+  if (bucket != NULL) {
+    for (; *bucket != NULL; bucket = &(*bucket)->hash_next) {
+      if (*bucket == pcb) {
+        *bucket = pcb->hash_next;
+        break;
+      }
+    }
+    pcb->hash_next = NULL;
+  }
+}
+#endif /* LWIP_PCB_HASH */
+
 /**
  * Purges the PCB and removes it from a PCB list. Any delayed ACKs are sent first.
  *
@@ -75,6 +75,27 @@ struct tcp_pcb *tcp_input_pcb;
 static err_t tcp_process(struct tcp_pcb *pcb);
 static void tcp_receive(struct tcp_pcb *pcb);
 static void tcp_parseopt(struct tcp_pcb *pcb);
+#if LWIP_WND_SCALE || LWIP_TCP_SACK
+static void tcp_latch_synopts(struct tcp_pcb *pcb);
+#endif /* LWIP_WND_SCALE || LWIP_TCP_SACK */
+
+#if LWIP_WND_SCALE
+/* Window scale option of the current SYN, TCP_SYNOPT_NONE if absent. It is
+   only latched into the pcb once the SYN has been accepted. */
+#define TCP_SYNOPT_NONE 0xFF
+static u8_t syn_wnd_scale;
+#endif /* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+/* SACK-permitted option seen on the current SYN */
+static u8_t syn_sack_perm;
+/* SACK blocks of the current segment as (left edge, right edge) pairs;
+   the 40 bytes of option space hold at most 4 */
+#define TCP_SACK_RCVD_MAX 4
+static u32_t sack_rcvd[2 * TCP_SACK_RCVD_MAX];
+static u8_t sack_rcvd_num;
+
+static void tcp_sack_update(struct tcp_pcb *pcb);
+#endif /* LWIP_TCP_SACK */
 
 static err_t tcp_listen_input(struct tcp_pcb_listen *pcb);
 static err_t tcp_timewait_input(struct tcp_pcb *pcb);
@@ -97,6 +118,10 @@ tcp_input(struct pbuf *p, struct netif *inp)
   struct tcp_pcb *lpcb_prev = NULL;
   struct tcp_pcb_listen *lpcb_any = NULL;
 #endif /* SO_REUSE */
+#if LWIP_PCB_HASH
+  struct tcp_pcb **bucket;
+  struct tcp_pcb_listen **lbucket;
+#endif /* LWIP_PCB_HASH */
   u8_t hdrlen;
   err_t err;
 
@@ -167,7 +192,12 @@ tcp_input(struct pbuf *p, struct netif *inp)
   prev = NULL;
 
 
+#if LWIP_PCB_HASH
+  bucket = &tcp_active_pcbs_hash[TCP_PCB_HASH(tcphdr->dest, tcphdr->src, &current_iphdr_src)];
+  for(pcb = *bucket; pcb != NULL; pcb = pcb->hash_next) {
+#else /* LWIP_PCB_HASH */
   for(pcb = tcp_active_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif /* LWIP_PCB_HASH */
     LWIP_ASSERT("tcp_input: active pcb->state != CLOSED", pcb->state != CLOSED);
     LWIP_ASSERT("tcp_input: active pcb->state != TIME-WAIT", pcb->state != TIME_WAIT);
     LWIP_ASSERT("tcp_input: active pcb->state != LISTEN", pcb->state != LISTEN);
@@ -181,9 +211,15 @@ tcp_input(struct pbuf *p, struct netif *inp)
          arrivals). */
       LWIP_ASSERT("tcp_input: pcb->next != pcb (before cache)", pcb->next != pcb);
       if (prev != NULL) {
+#if LWIP_PCB_HASH
+        prev->hash_next = pcb->hash_next;
+        pcb->hash_next = *bucket;
+        *bucket = pcb;
+#else /* LWIP_PCB_HASH */
         prev->next = pcb->next;
         pcb->next = tcp_active_pcbs;
         tcp_active_pcbs = pcb;
+#endif /* LWIP_PCB_HASH */
       }
       LWIP_ASSERT("tcp_input: pcb->next != pcb (after cache)", pcb->next != pcb);
       break;
@@ -213,7 +249,12 @@ tcp_input(struct pbuf *p, struct netif *inp)
     /* Finally, if we still did not get a match, we check all PCBs that
        are LISTENing for incoming connections. */
     prev = NULL;
+#if LWIP_PCB_HASH
+    lbucket = &tcp_listen_pcbs_hash[TCP_LISTEN_PCB_HASH(tcphdr->dest)].listen_pcbs;
+    for(lpcb = *lbucket; lpcb != NULL; lpcb = lpcb->hash_next) {
+#else /* LWIP_PCB_HASH */
     for(lpcb = tcp_listen_pcbs.listen_pcbs; lpcb != NULL; lpcb = lpcb->next) {
+#endif /* LWIP_PCB_HASH */
       if (lpcb->local_port == tcphdr->dest) {
 #if SO_REUSE
         if (ip_addr_cmp(&(lpcb->local_ip), &current_iphdr_dest)) {
@@ -247,11 +288,17 @@ tcp_input(struct pbuf *p, struct netif *inp)
          lookups will be faster (we exploit locality in TCP segment
          arrivals). */
       if (prev != NULL) {
+#if LWIP_PCB_HASH
+        ((struct tcp_pcb_listen *)prev)->hash_next = lpcb->hash_next;
+        lpcb->hash_next = *lbucket;
+        *lbucket = lpcb;
+#else /* LWIP_PCB_HASH */
         ((struct tcp_pcb_listen *)prev)->next = lpcb->next;
               /* our successor is the remainder of the listening list */
         lpcb->next = tcp_listen_pcbs.listen_pcbs;
               /* put this listening pcb at the head of the listening list */
         tcp_listen_pcbs.listen_pcbs = lpcb;
+#endif /* LWIP_PCB_HASH */
       }
 
       LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_input: packed for LISTENing connection.\n"));
@@ -330,10 +377,24 @@ tcp_input(struct pbuf *p, struct netif *inp)
            called when new send buffer space is available, we call it
            now. */
         if (pcb->acked > 0) {
+#if LWIP_WND_SCALE
+          /* pcb->acked may exceed the u16_t length of the sent callback,
+             so it may have to be called several times. */
+          tcpwnd_size_t acked = pcb->acked;
+          while (acked > 0) {
+            u16_t acked16 = TCPWND_MIN16(acked);
+            acked -= acked16;
+            TCP_EVENT_SENT(pcb, acked16, err);
+            if (err == ERR_ABRT) {
+              goto aborted;
+            }
+          }
+#else /* LWIP_WND_SCALE */
           TCP_EVENT_SENT(pcb, pcb->acked, err);
           if (err == ERR_ABRT) {
             goto aborted;
           }
+#endif /* LWIP_WND_SCALE */
         }
 
         if (recv_data != NULL) {
@@ -368,7 +429,7 @@ tcp_input(struct pbuf *p, struct netif *inp)
           } else {
             /* correct rcv_wnd as the application won't call tcp_recved()
                for the FIN's seqno */
-            if (pcb->rcv_wnd != TCP_WND) {
+            if (pcb->rcv_wnd != TCP_WND_MAX(pcb)) {
               pcb->rcv_wnd++;
             }
             TCP_EVENT_CLOSED(pcb, err);
@@ -499,6 +560,9 @@ tcp_listen_input(struct tcp_pcb_listen *pcb)
 
     /* Parse any options in the SYN. */
     tcp_parseopt(npcb);
+#if LWIP_WND_SCALE || LWIP_TCP_SACK
+    tcp_latch_synopts(npcb);
+#endif /* LWIP_WND_SCALE || LWIP_TCP_SACK */
 #if TCP_CALCULATE_EFF_SEND_MSS
     npcb->mss = tcp_eff_send_mss(npcb->mss, &(npcb->remote_ip));
 #endif /* TCP_CALCULATE_EFF_SEND_MSS */
@@ -631,6 +695,10 @@ tcp_process(struct tcp_pcb *pcb)
     /* received SYN ACK with expected sequence number? */
     if ((flags & TCP_ACK) && (flags & TCP_SYN)
         && ackno == ntohl(pcb->unacked->tcphdr->seqno) + 1) {
+#if LWIP_WND_SCALE || LWIP_TCP_SACK
+      /* the SYN|ACK is acceptable, apply the options it carried */
+      tcp_latch_synopts(pcb);
+#endif /* LWIP_WND_SCALE || LWIP_TCP_SACK */
       pcb->snd_buf++;
       pcb->rcv_nxt = seqno + 1;
       pcb->rcv_ann_right_edge = pcb->rcv_nxt;
@@ -684,7 +752,7 @@ tcp_process(struct tcp_pcb *pcb)
     if (flags & TCP_ACK) {
       /* expected ACK number? */
       if (TCP_SEQ_BETWEEN(ackno, pcb->lastack+1, pcb->snd_nxt)) {
-        u16_t old_cwnd;
+        tcpwnd_size_t old_cwnd;
         pcb->state = ESTABLISHED;
         LWIP_DEBUGF(TCP_DEBUG, ("TCP connection established %"U16_F" -> %"U16_F".\n", inseg.tcphdr->src, inseg.tcphdr->dest));
 #if LWIP_CALLBACK_API
@@ -856,6 +924,7 @@ tcp_receive(struct tcp_pcb *pcb)
   u32_t right_wnd_edge;
   u16_t new_tot_len;
   int found_dupack = 0;
+  tcpwnd_size_t snd_wnd;
 #if TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS
   u32_t ooseq_blen;
   u16_t ooseq_qlen;
@@ -865,16 +934,18 @@ tcp_receive(struct tcp_pcb *pcb)
 
   if (flags & TCP_ACK) {
     right_wnd_edge = pcb->snd_wnd + pcb->snd_wl2;
+    /* the window field of segments other than SYNs is scaled */
+    snd_wnd = SND_WND_SCALE(pcb, (tcpwnd_size_t)tcphdr->wnd);
 
     /* Update window. */
     if (TCP_SEQ_LT(pcb->snd_wl1, seqno) ||
        (pcb->snd_wl1 == seqno && TCP_SEQ_LT(pcb->snd_wl2, ackno)) ||
-       (pcb->snd_wl2 == ackno && tcphdr->wnd > pcb->snd_wnd)) {
-      pcb->snd_wnd = tcphdr->wnd;
+       (pcb->snd_wl2 == ackno && snd_wnd > pcb->snd_wnd)) {
+      pcb->snd_wnd = snd_wnd;
       /* keep track of the biggest window announced by the remote host to calculate
          the maximum segment size */
-      if (pcb->snd_wnd_max < tcphdr->wnd) {
-        pcb->snd_wnd_max = tcphdr->wnd;
+      if (pcb->snd_wnd_max < snd_wnd) {
+        pcb->snd_wnd_max = snd_wnd;
       }
       pcb->snd_wl1 = seqno;
       pcb->snd_wl2 = ackno;
@@ -888,10 +959,10 @@ tcp_receive(struct tcp_pcb *pcb)
         /* stop persist timer */
           pcb->persist_backoff = 0;
       }
-      LWIP_DEBUGF(TCP_WND_DEBUG, ("tcp_receive: window update %"U16_F"\n", pcb->snd_wnd));
+      LWIP_DEBUGF(TCP_WND_DEBUG, ("tcp_receive: window update %"TCPWNDSIZE_F"\n", pcb->snd_wnd));
 #if TCP_WND_DEBUG
     } else {
-      if (pcb->snd_wnd != tcphdr->wnd) {
+      if (pcb->snd_wnd != snd_wnd) {
         LWIP_DEBUGF(TCP_WND_DEBUG,
                     ("tcp_receive: no window update lastack %"U32_F" ackno %"
                      U32_F" wl1 %"U32_F" seqno %"U32_F" wl2 %"U32_F"\n",
@@ -938,7 +1009,7 @@ tcp_receive(struct tcp_pcb *pcb)
               if (pcb->dupacks > 3) {
                 /* Inflate the congestion window, but not if it means that
                    the value overflows. */
-                if ((u16_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
+                if ((tcpwnd_size_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
                   pcb->cwnd += pcb->mss;
                 }
               } else if (pcb->dupacks == 3) {
@@ -961,8 +1032,16 @@ tcp_receive(struct tcp_pcb *pcb)
          in fast retransmit. Also reset the congestion window to the
          slow start threshold. */
       if (pcb->flags & TF_INFR) {
-        pcb->flags &= ~TF_INFR;
-        pcb->cwnd = pcb->ssthresh;
+#if LWIP_TCP_SACK
+        /* With SACK, a partial ACK leaves us in recovery until all data
+           outstanding when it was entered is acknowledged, so further
+           holes are repaired without reducing cwnd again. */
+        if (!(pcb->flags & TF_SACK) || !TCP_SEQ_LT(ackno, pcb->recover))
+#endif /* LWIP_TCP_SACK */
+        {
+          pcb->flags &= ~TF_INFR;
+          pcb->cwnd = pcb->ssthresh;
+        }
       }
 
       /* Reset the number of retransmissions. */
@@ -971,8 +1050,9 @@ tcp_receive(struct tcp_pcb *pcb)
       /* Reset the retransmission time-out. */
       pcb->rto = (pcb->sa >> 3) + pcb->sv;
 
-      /* Update the send buffer space. Diff between the two can never exceed 64K? */
-      pcb->acked = (u16_t)(ackno - pcb->lastack);
+      /* Update the send buffer space. Diff between the two can never exceed 64K
+         unless window scaling is in use. */
+      pcb->acked = (tcpwnd_size_t)(ackno - pcb->lastack);
 
       pcb->snd_buf += pcb->acked;
 
@@ -984,16 +1064,16 @@ tcp_receive(struct tcp_pcb *pcb)
          ssthresh). */
       if (pcb->state >= ESTABLISHED) {
         if (pcb->cwnd < pcb->ssthresh) {
-          if ((u16_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
+          if ((tcpwnd_size_t)(pcb->cwnd + pcb->mss) > pcb->cwnd) {
             pcb->cwnd += pcb->mss;
           }
-          LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: slow start cwnd %"U16_F"\n", pcb->cwnd));
+          LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: slow start cwnd %"TCPWNDSIZE_F"\n", pcb->cwnd));
         } else {
-          u16_t new_cwnd = (pcb->cwnd + pcb->mss * pcb->mss / pcb->cwnd);
+          tcpwnd_size_t new_cwnd = (pcb->cwnd + pcb->mss * pcb->mss / pcb->cwnd);
           if (new_cwnd > pcb->cwnd) {
             pcb->cwnd = new_cwnd;
           }
-          LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: congestion avoidance cwnd %"U16_F"\n", pcb->cwnd));
+          LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: congestion avoidance cwnd %"TCPWNDSIZE_F"\n", pcb->cwnd));
         }
       }
       LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_receive: ACK for %"U32_F", unacked->seqno %"U32_F":%"U32_F"\n",
@@ -1082,6 +1162,15 @@ tcp_receive(struct tcp_pcb *pcb)
     }
     /* End of ACK for new data processing. */
 
+#if LWIP_TCP_SACK
+    /* Update the scoreboard with the SACK blocks of this segment and
+       retransmit what it shows to be lost. */
+    if (pcb->flags & TF_SACK) {
+      tcp_sack_update(pcb);
+      tcp_rexmit_sack(pcb);
+    }
+#endif /* LWIP_TCP_SACK */
+
     LWIP_DEBUGF(TCP_RTO_DEBUG, ("tcp_receive: pcb->rttest %"U32_F" rtseq %"U32_F" ackno %"U32_F"\n",
                                 pcb->rttest, pcb->rtseq, ackno));
 
@@ -1230,7 +1319,7 @@ tcp_receive(struct tcp_pcb *pcb)
             TCPH_FLAGS_SET(inseg.tcphdr, TCPH_FLAGS(inseg.tcphdr) &~ TCP_FIN);
           }
           /* Adjust length of segment to fit in the window. */
-          inseg.len = pcb->rcv_wnd;
+          inseg.len = (u16_t)pcb->rcv_wnd;
           if (TCPH_FLAGS(inseg.tcphdr) & TCP_SYN) {
             inseg.len -= 1;
           }
@@ -1366,7 +1455,13 @@ tcp_receive(struct tcp_pcb *pcb)
 
       } else {
         /* We get here if the incoming segment is out-of-sequence. */
+#if LWIP_TCP_SACK
+        /* The ACK is sent once the segment is queued so that its SACK
+           blocks include it. */
+        pcb->rcv_sack_last = seqno;
+#else /* LWIP_TCP_SACK */
         tcp_send_empty_ack(pcb);
+#endif /* LWIP_TCP_SACK */
 #if TCP_QUEUE_OOSEQ
         /* We queue the segment on the ->ooseq queue. */
         if (pcb->ooseq == NULL) {
@@ -1513,6 +1608,9 @@ tcp_receive(struct tcp_pcb *pcb)
           }
         }
 #endif /* TCP_OOSEQ_MAX_BYTES || TCP_OOSEQ_MAX_PBUFS */
+#if LWIP_TCP_SACK
+        tcp_send_empty_ack(pcb);
+#endif /* LWIP_TCP_SACK */
 #endif /* TCP_QUEUE_OOSEQ */
       }
     } else {
@@ -1534,7 +1632,8 @@ tcp_receive(struct tcp_pcb *pcb)
  * Parses the options contained in the incoming segment.
  *
  * Called from tcp_listen_input() and tcp_process().
- * Currently, only the MSS option is supported!
+ * Supported are the MSS, timestamp, window scale, SACK permitted and SACK
+ * options.
  *
  * @param pcb the tcp_pcb for which a segment arrived
  */
@@ -1544,11 +1643,21 @@ tcp_parseopt(struct tcp_pcb *pcb)
   u16_t c, max_c;
   u16_t mss;
   u8_t *opts, opt;
+#if LWIP_TCP_SACK
+  u16_t i;
+#endif /* LWIP_TCP_SACK */
 #if LWIP_TCP_TIMESTAMPS
   u32_t tsval;
 #endif
 
   opts = (u8_t *)tcphdr + TCP_HLEN;
+#if LWIP_WND_SCALE
+  syn_wnd_scale = TCP_SYNOPT_NONE;
+#endif /* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+  syn_sack_perm = 0;
+  sack_rcvd_num = 0;
+#endif /* LWIP_TCP_SACK */
 
   /* Parse the TCP MSS option, if present. */
   if(TCPH_HDRLEN(tcphdr) > 0x5) {
@@ -1600,6 +1709,60 @@ tcp_parseopt(struct tcp_pcb *pcb)
         c += 0x0A;
         break;
 #endif
+#if LWIP_WND_SCALE
+      case 0x03:
+        LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: WND_SCALE\n"));
+        if (opts[c + 1] != 0x03 || c + 0x03 > max_c) {
+          /* Bad length */
+          LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+          return;
+        }
+        /* The option is only valid on SYNs. It is applied by
+           tcp_latch_synopts() once the SYN has been accepted. */
+        if (flags & TCP_SYN) {
+          syn_wnd_scale = LWIP_MIN(opts[c + 2], 14);
+        }
+        /* Advance to next option */
+        c += 0x03;
+        break;
+#endif /* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+      case 0x04:
+        LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK_PERM\n"));
+        if (opts[c + 1] != 0x02 || c + 0x02 > max_c) {
+          /* Bad length */
+          LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+          return;
+        }
+        if (flags & TCP_SYN) {
+          syn_sack_perm = 1;
+        }
+        /* Advance to next option */
+        c += 0x02;
+        break;
+      case 0x05:
+        LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: SACK\n"));
+        if (opts[c + 1] < 0x0A || ((opts[c + 1] - 2) & 0x07) != 0 ||
+            c + opts[c + 1] > max_c) {
+          /* Bad length */
+          LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: bad length\n"));
+          return;
+        }
+        /* Only recorded if SACK was negotiated. The blocks are applied to
+           the unacked queue by tcp_sack_update(). */
+        if (pcb->flags & TF_SACK) {
+          for (i = c + 2; (i < c + opts[c + 1]) && (sack_rcvd_num < TCP_SACK_RCVD_MAX); i += 8) {
+            sack_rcvd[2 * sack_rcvd_num] = ((u32_t)opts[i] << 24) |
+              ((u32_t)opts[i + 1] << 16) | ((u32_t)opts[i + 2] << 8) | opts[i + 3];
+            sack_rcvd[2 * sack_rcvd_num + 1] = ((u32_t)opts[i + 4] << 24) |
+              ((u32_t)opts[i + 5] << 16) | ((u32_t)opts[i + 6] << 8) | opts[i + 7];
+            sack_rcvd_num++;
+          }
+        }
+        /* Advance to next option */
+        c += opts[c + 1];
+        break;
+#endif /* LWIP_TCP_SACK */
       default:
         LWIP_DEBUGF(TCP_INPUT_DEBUG, ("tcp_parseopt: other\n"));
         if (opts[c + 1] == 0) {
@@ -1616,4 +1779,75 @@ tcp_parseopt(struct tcp_pcb *pcb)
   }
 }
 
+#if LWIP_WND_SCALE || LWIP_TCP_SACK
+/**
+ * Applies the window scale and SACK-permitted options that tcp_parseopt()
+ * found on a SYN. Called only for a SYN that has been accepted: the SYN of
+ * a new connection on a listening pcb or a valid SYN|ACK in SYN_SENT.
+ *
+ * @param pcb the tcp_pcb the SYN belongs to
+ */
+static void
+tcp_latch_synopts(struct tcp_pcb *pcb)
+{
+#if LWIP_WND_SCALE
+  if ((syn_wnd_scale != TCP_SYNOPT_NONE) && !(pcb->flags & TF_WND_SCALE)) {
+    pcb->snd_scale = syn_wnd_scale;
+    pcb->rcv_scale = TCP_RCV_SCALE;
+    pcb->flags |= TF_WND_SCALE;
+    /* window scaling is enabled, we can use the full receive window */
+    LWIP_ASSERT("window not at default value", pcb->rcv_wnd == TCPWND_MIN16(TCP_WND));
+    LWIP_ASSERT("window not at default value", pcb->rcv_ann_wnd == TCPWND_MIN16(TCP_WND));
+    pcb->rcv_wnd = pcb->rcv_ann_wnd = TCP_WND;
+  }
+#endif /* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+  if (syn_sack_perm) {
+    pcb->flags |= TF_SACK;
+  }
+#endif /* LWIP_TCP_SACK */
+}
+#endif /* LWIP_WND_SCALE || LWIP_TCP_SACK */
+
+#if LWIP_TCP_SACK
+/**
+ * Marks the segments on the unacked queue that are covered by the SACK
+ * blocks tcp_parseopt() found on the current segment (RFC 2018). Blocks at
+ * or below the cumulative ACK (D-SACK) or beyond snd_nxt are ignored.
+ * The marks are cleared again by tcp_rexmit_rto(), as the receiver may
+ * discard data it has SACKed.
+ *
+ * Called from tcp_receive() after the cumulative ACK has been processed.
+ *
+ * @param pcb the tcp_pcb for which a segment arrived
+ */
+static void
+tcp_sack_update(struct tcp_pcb *pcb)
+{
+  struct tcp_seg *seg;
+  u32_t left, right, seg_seqno;
+  u8_t i;
+
+  for (i = 0; i < sack_rcvd_num; i++) {
+    left = sack_rcvd[2 * i];
+    right = sack_rcvd[2 * i + 1];
+    if (!TCP_SEQ_LT(left, right) || TCP_SEQ_LEQ(left, pcb->lastack) ||
+        TCP_SEQ_GT(right, pcb->snd_nxt)) {
+      continue;
+    }
+    /* the unacked queue is sorted by sequence number */
+    for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+      seg_seqno = ntohl(seg->tcphdr->seqno);
+      if (TCP_SEQ_GEQ(seg_seqno, right)) {
+        break;
+      }
+      if (TCP_SEQ_GEQ(seg_seqno, left) &&
+          TCP_SEQ_LEQ(seg_seqno + TCP_TCPLEN(seg), right)) {
+        seg->flags |= TF_SEG_SACKED;
+      }
+    }
+  }
+}
+#endif /* LWIP_TCP_SACK */
+
 #endif /* LWIP_TCP */
@@ -114,7 +114,7 @@ tcp_output_alloc_header(struct tcp_pcb *pcb, u16_t optlen, u16_t datalen,
     tcphdr->seqno = seqno_be;
     tcphdr->ackno = htonl(pcb->rcv_nxt);
     TCPH_HDRLEN_FLAGS_SET(tcphdr, (5 + optlen / 4), TCP_ACK);
-    tcphdr->wnd = htons(pcb->rcv_ann_wnd);
+    tcphdr->wnd = htons(TCPWND_MIN16(RCV_WND_SCALE(pcb, pcb->rcv_ann_wnd)));
     tcphdr->chksum = 0;
     tcphdr->urgp = 0;
 
@@ -315,7 +315,7 @@ tcp_write_checks(struct tcp_pcb *pcb, u16_t len)
 
   /* fail on too much data */
   if (len > pcb->snd_buf) {
-    LWIP_DEBUGF(TCP_OUTPUT_DEBUG | 3, ("tcp_write: too much data (len=%"U16_F" > snd_buf=%"U16_F")\n",
+    LWIP_DEBUGF(TCP_OUTPUT_DEBUG | 3, ("tcp_write: too much data (len=%"U16_F" > snd_buf=%"TCPWNDSIZE_F")\n",
       len, pcb->snd_buf));
     pcb->flags |= TF_NAGLEMEMERR;
     return ERR_MEM;
@@ -379,7 +379,7 @@ tcp_write(struct tcp_pcb *pcb, const void *arg, u16_t len, u8_t apiflags)
 #endif /* TCP_CHECKSUM_ON_COPY */
   err_t err;
   /* don't allocate segments bigger than half the maximum window we ever received */
-  u16_t mss_local = LWIP_MIN(pcb->mss, pcb->snd_wnd_max/2);
+  u16_t mss_local = LWIP_MIN(pcb->mss, TCPWND_MIN16(pcb->snd_wnd_max/2));
 
 #if LWIP_NETIF_TX_SINGLE_PBUF
   /* Always copy to try to create single pbufs for TX */
@@ -751,6 +751,17 @@ tcp_enqueue_flags(struct tcp_pcb *pcb, u8_t flags)
 
   if (flags & TCP_SYN) {
     optflags = TF_SEG_OPTS_MSS;
+#if LWIP_WND_SCALE
+    /* a SYN|ACK may only carry the option if the peer's SYN did */
+    if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_WND_SCALE)) {
+      optflags |= TF_SEG_OPTS_WND_SCALE;
+    }
+#endif /* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+    if ((pcb->state != SYN_RCVD) || (pcb->flags & TF_SACK)) {
+      optflags |= TF_SEG_OPTS_SACK_PERM;
+    }
+#endif /* LWIP_TCP_SACK */
   }
 #if LWIP_TCP_TIMESTAMPS
   if ((pcb->flags & TF_TIMESTAMP)) {
@@ -843,6 +854,165 @@ tcp_build_timestamp_option(struct tcp_pcb *pcb, u32_t *opts)
 }
 #endif
 
+#if LWIP_TCP_SACK
+/** Number of segments SACKed above a segment that make it count as lost
+ * (DupThresh of RFC 6675) */
+#define TCP_SACK_DUPTHRESH 3
+
+/** Number of SACK blocks that fit next to optlen bytes of other options:
+ * the 40 bytes of option space hold 4 blocks, 3 next to a timestamp */
+#define TCP_SACK_MAX_BLOCKS(optlen) \
+  ((u8_t)LWIP_MIN(LWIP_TCP_MAX_SACK_NUM, (40 - 4 - (optlen)) / 8))
+
+/** Collect SACK blocks (RFC 2018) describing the data on pcb->ooseq.
+ * The block holding the most recently received out-of-sequence segment
+ * is stored first, the remaining ones in sequence order.
+ *
+ * @param pcb tcp_pcb
+ * @param blocks array receiving max (left edge, right edge) pairs
+ * @param max maximum number of blocks to collect
+ * @return the number of blocks collected
+ */
+static u8_t
+tcp_collect_sack_blocks(struct tcp_pcb *pcb, u32_t *blocks, u8_t max)
+{
+  struct tcp_seg *seg = pcb->ooseq;
+  u32_t left, right;
+  u8_t num = 0, recent_found = 0, i;
+
+  while (seg != NULL) {
+    /* merge contiguous segments into one block; ooseq seqnos are in host order */
+    left = seg->tcphdr->seqno;
+    right = left + TCP_TCPLEN(seg);
+    for (seg = seg->next; (seg != NULL) && (seg->tcphdr->seqno == right); seg = seg->next) {
+      right += TCP_TCPLEN(seg);
+    }
+    if (!recent_found && TCP_SEQ_BETWEEN(pcb->rcv_sack_last, left, right - 1)) {
+      /* make room in front, dropping the last block if we are full */
+      if (num == max) {
+        num--;
+      }
+      for (i = num; i > 0; i--) {
+        blocks[2 * i] = blocks[2 * i - 2];
+        blocks[2 * i + 1] = blocks[2 * i - 1];
+      }
+      blocks[0] = left;
+      blocks[1] = right;
+      num++;
+      recent_found = 1;
+    } else if (num < max) {
+      blocks[2 * num] = left;
+      blocks[2 * num + 1] = right;
+      num++;
+    } else if (recent_found) {
+      break;
+    }
+  }
+  return num;
+}
+
+/** Build a SACK option (two NOPs for alignment + the blocks) at the
+ * specified options pointer.
+ *
+ * @param opts option pointer where to store the option
+ * @param blocks (left edge, right edge) pairs
+ * @param num number of blocks
+ */
+static void
+tcp_build_sack_option(u32_t *opts, const u32_t *blocks, u8_t num)
+{
+  u8_t i;
+
+  opts[0] = htonl(0x01010500 | (2 + 8 * num));
+  for (i = 0; i < 2 * num; i++) {
+    opts[1 + i] = htonl(blocks[i]);
+  }
+}
+
+/** Send a segment with SACK blocks appended to its options.
+ * The option space of a queued segment is fixed when the segment is
+ * created, so a new header carrying the SACK option is built and the
+ * segment's data is chained behind it. The segment itself is left
+ * unchanged for retransmission. Called by tcp_output_segment() with
+ * seg->p->payload pointing to the TCP header.
+ *
+ * @param seg the tcp_seg to send
+ * @param pcb the tcp_pcb for the TCP connection used to send the segment
+ * @return ERR_OK if the segment was sent, ERR_VAL if there is nothing to
+ *         SACK or no block fits within the MSS and ERR_MEM if no header
+ *         could be allocated; in the error cases the caller sends the
+ *         segment without SACK blocks
+ */
+static err_t
+tcp_output_segment_sack(struct tcp_seg *seg, struct tcp_pcb *pcb)
+{
+  struct pbuf *p, *data;
+  struct tcp_hdr *tcphdr;
+  u32_t sack_blocks[2 * LWIP_TCP_MAX_SACK_NUM];
+  u16_t hdrlen = TCPH_HDRLEN(seg->tcphdr) * 4;
+  u8_t max_sacks, num_sacks, stripped = 0;
+
+  /* tcp_write() sizes segments so that data and options fit in the MSS.
+     Only as many blocks as still fit are added, otherwise the segment
+     would exceed the path MTU. */
+  if ((u32_t)seg->len + (hdrlen - TCP_HLEN) + 4 + 8 > pcb->mss) {
+    return ERR_VAL;
+  }
+  max_sacks = (u8_t)LWIP_MIN(TCP_SACK_MAX_BLOCKS(hdrlen - TCP_HLEN),
+    (pcb->mss - seg->len - (hdrlen - TCP_HLEN) - 4) / 8);
+  num_sacks = tcp_collect_sack_blocks(pcb, sack_blocks, max_sacks);
+  if (num_sacks == 0) {
+    return ERR_VAL;
+  }
+  p = pbuf_alloc(PBUF_IP, hdrlen + 4 + 8 * num_sacks, PBUF_RAM);
+  if (p == NULL) {
+    LWIP_DEBUGF(TCP_OUTPUT_DEBUG, ("tcp_output_segment: no pbuf for SACK header\n"));
+    return ERR_MEM;
+  }
+  tcphdr = (struct tcp_hdr *)p->payload;
+  MEMCPY(tcphdr, seg->tcphdr, hdrlen);
+  TCPH_HDRLEN_SET(tcphdr, (hdrlen + 4 + 8 * num_sacks) / 4);
+  tcp_build_sack_option((u32_t *)(void *)((u8_t *)tcphdr + hdrlen),
+    sack_blocks, num_sacks);
+
+  /* chain the data behind the new header; pbuf_chain() takes a reference */
+  data = seg->p;
+  if (data->len == hdrlen) {
+    /* header-only first pbuf, the data is in the rest of the chain */
+    data = data->next;
+  } else {
+    pbuf_header(data, -(s16_t)hdrlen);
+    stripped = 1;
+  }
+  if (data != NULL) {
+    pbuf_chain(p, data);
+  }
+
+  tcphdr->chksum = 0;
+#if CHECKSUM_GEN_TCP
+  tcphdr->chksum = inet_chksum_pseudo(p, &(pcb->local_ip), &(pcb->remote_ip),
+        IP_PROTO_TCP, p->tot_len);
+#endif /* CHECKSUM_GEN_TCP */
+  TCP_STATS_INC(tcp.xmit);
+
+#if LWIP_NETIF_HWADDRHINT
+  ip_output_hinted(p, &(pcb->local_ip), &(pcb->remote_ip), pcb->ttl, pcb->tos,
+      IP_PROTO_TCP, &(pcb->addr_hint));
+#else /* LWIP_NETIF_HWADDRHINT*/
+  ip_output(p, &(pcb->local_ip), &(pcb->remote_ip), pcb->ttl, pcb->tos,
+      IP_PROTO_TCP);
+#endif /* LWIP_NETIF_HWADDRHINT*/
+
+  /* drop the new header (and its reference on the data) and give the
+     segment its header back */
+  pbuf_free(p);
+  if (stripped) {
+    pbuf_header(seg->p, (s16_t)hdrlen);
+  }
+  return ERR_OK;
+}
+#endif /* LWIP_TCP_SACK */
+
 /** Send an ACK without data.
  *
  * @param pcb Protocol control block for the TCP connection to send the ACK
@@ -853,12 +1023,23 @@ tcp_send_empty_ack(struct tcp_pcb *pcb)
   struct pbuf *p;
   struct tcp_hdr *tcphdr;
   u8_t optlen = 0;
+#if LWIP_TCP_SACK
+  u32_t sack_blocks[2 * LWIP_TCP_MAX_SACK_NUM];
+  u8_t num_sacks = 0;
+#endif /* LWIP_TCP_SACK */
 
 #if LWIP_TCP_TIMESTAMPS
   if (pcb->flags & TF_TIMESTAMP) {
     optlen = LWIP_TCP_OPT_LENGTH(TF_SEG_OPTS_TS);
   }
 #endif
+#if LWIP_TCP_SACK
+  if ((pcb->flags & TF_SACK) && (pcb->ooseq != NULL)) {
+    num_sacks = tcp_collect_sack_blocks(pcb, sack_blocks,
+      TCP_SACK_MAX_BLOCKS(optlen));
+    optlen += 4 + 8 * num_sacks;
+  }
+#endif /* LWIP_TCP_SACK */
 
   p = tcp_output_alloc_header(pcb, optlen, 0, htonl(pcb->snd_nxt));
   if (p == NULL) {
@@ -879,6 +1060,12 @@ tcp_send_empty_ack(struct tcp_pcb *pcb)
     tcp_build_timestamp_option(pcb, (u32_t *)(tcphdr + 1));
   }
 #endif
+#if LWIP_TCP_SACK
+  if (num_sacks > 0) {
+    tcp_build_sack_option((u32_t *)(tcphdr + 1) + (optlen - 4 - 8 * num_sacks) / 4,
+      sack_blocks, num_sacks);
+  }
+#endif /* LWIP_TCP_SACK */
 
 #if CHECKSUM_GEN_TCP
   tcphdr->chksum = inet_chksum_pseudo(p, &(pcb->local_ip), &(pcb->remote_ip),
@@ -954,13 +1141,13 @@ tcp_output(struct tcp_pcb *pcb)
 #endif /* TCP_OUTPUT_DEBUG */
 #if TCP_CWND_DEBUG
   if (seg == NULL) {
-    LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %"U16_F
-                                 ", cwnd %"U16_F", wnd %"U32_F
+    LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %"TCPWNDSIZE_F
+                                 ", cwnd %"TCPWNDSIZE_F", wnd %"U32_F
                                  ", seg == NULL, ack %"U32_F"\n",
                                  pcb->snd_wnd, pcb->cwnd, wnd, pcb->lastack));
   } else {
     LWIP_DEBUGF(TCP_CWND_DEBUG,
-                ("tcp_output: snd_wnd %"U16_F", cwnd %"U16_F", wnd %"U32_F
+                ("tcp_output: snd_wnd %"TCPWNDSIZE_F", cwnd %"TCPWNDSIZE_F", wnd %"U32_F
                  ", effwnd %"U32_F", seq %"U32_F", ack %"U32_F"\n",
                  pcb->snd_wnd, pcb->cwnd, wnd,
                  ntohl(seg->tcphdr->seqno) - pcb->lastack + seg->len,
@@ -984,7 +1171,7 @@ tcp_output(struct tcp_pcb *pcb)
       break;
     }
 #if TCP_CWND_DEBUG
-    LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %"U16_F", cwnd %"U16_F", wnd %"U32_F", effwnd %"U32_F", seq %"U32_F", ack %"U32_F", i %"S16_F"\n",
+    LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %"TCPWNDSIZE_F", cwnd %"TCPWNDSIZE_F", wnd %"U32_F", effwnd %"U32_F", seq %"U32_F", ack %"U32_F", i %"S16_F"\n",
                             pcb->snd_wnd, pcb->cwnd, wnd,
                             ntohl(seg->tcphdr->seqno) + seg->len -
                             pcb->lastack,
@@ -1069,7 +1256,16 @@ tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
   seg->tcphdr->ackno = htonl(pcb->rcv_nxt);
 
   /* advertise our receive window size in this TCP segment */
-  seg->tcphdr->wnd = htons(pcb->rcv_ann_wnd);
+#if LWIP_WND_SCALE
+  if (seg->flags & TF_SEG_OPTS_WND_SCALE) {
+    /* The Window field in a SYN segment itself (the only type where we
+       send the window scale option) is never scaled. */
+    seg->tcphdr->wnd = htons(TCPWND_MIN16(pcb->rcv_ann_wnd));
+  } else
+#endif /* LWIP_WND_SCALE */
+  {
+    seg->tcphdr->wnd = htons(TCPWND_MIN16(RCV_WND_SCALE(pcb, pcb->rcv_ann_wnd)));
+  }
 
   pcb->rcv_ann_right_edge = pcb->rcv_nxt + pcb->rcv_ann_wnd;
 
@@ -1086,6 +1282,18 @@ tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
     *opts = TCP_BUILD_MSS_OPTION(mss);
     opts += 1;
   }
+#if LWIP_WND_SCALE
+  if (seg->flags & TF_SEG_OPTS_WND_SCALE) {
+    *opts = TCP_BUILD_WND_SCALE_OPTION(TCP_RCV_SCALE);
+    opts += 1;
+  }
+#endif /* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+  if (seg->flags & TF_SEG_OPTS_SACK_PERM) {
+    *opts = TCP_BUILD_SACK_PERM_OPTION();
+    opts += 1;
+  }
+#endif /* LWIP_TCP_SACK */
 #if LWIP_TCP_TIMESTAMPS
   pcb->ts_lastacksent = pcb->rcv_nxt;
 
@@ -1128,6 +1336,14 @@ tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb)
 
   seg->p->payload = seg->tcphdr;
 
+#if LWIP_TCP_SACK
+  /* piggyback SACK blocks on the segment while data is out of sequence */
+  if ((pcb->flags & TF_SACK) && (pcb->ooseq != NULL) &&
+      (tcp_output_segment_sack(seg, pcb) == ERR_OK)) {
+    return;
+  }
+#endif /* LWIP_TCP_SACK */
+
   seg->tcphdr->chksum = 0;
 #if CHECKSUM_GEN_TCP
 #if TCP_CHECKSUM_ON_COPY
@@ -1221,7 +1437,7 @@ tcp_rst(u32_t seqno, u32_t ackno,
   tcphdr->seqno = htonl(seqno);
   tcphdr->ackno = htonl(ackno);
   TCPH_HDRLEN_FLAGS_SET(tcphdr, TCP_HLEN/4, TCP_RST | TCP_ACK);
-  tcphdr->wnd = PP_HTONS(TCP_WND);
+  tcphdr->wnd = PP_HTONS(TCPWND_MIN16(TCP_WND));
   tcphdr->chksum = 0;
   tcphdr->urgp = 0;
 
@@ -1253,6 +1469,17 @@ tcp_rexmit_rto(struct tcp_pcb *pcb)
     return;
   }
 
+#if LWIP_TCP_SACK
+  /* The receiver may have discarded data it SACKed, so the scoreboard is
+     cleared and everything is sent again (RFC 2018). No new recovery is
+     started before the data outstanding now is acknowledged. */
+  for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+    seg->flags &= ~(TF_SEG_SACKED | TF_SEG_REXMIT);
+  }
+  pcb->flags &= ~TF_INFR;
+  pcb->recover = pcb->snd_nxt;
+#endif /* LWIP_TCP_SACK */
+
   /* Move all unacked segments to the head of the unsent queue */
   for (seg = pcb->unacked; seg->next != NULL; seg = seg->next);
   /* concatenate unsent queue after unacked queue */
@@ -1294,6 +1521,9 @@ tcp_rexmit(struct tcp_pcb *pcb)
   /* Keep the unsent queue sorted. */
   seg = pcb->unacked;
   pcb->unacked = seg->next;
+#if LWIP_TCP_SACK
+  seg->flags |= TF_SEG_REXMIT;
+#endif /* LWIP_TCP_SACK */
 
   cur_seg = &(pcb->unsent);
   while (*cur_seg &&
@@ -1321,6 +1551,38 @@ tcp_rexmit(struct tcp_pcb *pcb)
 }
 
 
+/**
+ * Reduce ssthresh and cwnd when entering fast recovery
+ *
+ * @param pcb the tcp_pcb that detected a loss
+ */
+static void
+tcp_enter_fast_recovery(struct tcp_pcb *pcb)
+{
+  /* Set ssthresh to half of the minimum of the current
+   * cwnd and the advertised window */
+  if (pcb->cwnd > pcb->snd_wnd) {
+    pcb->ssthresh = pcb->snd_wnd / 2;
+  } else {
+    pcb->ssthresh = pcb->cwnd / 2;
+  }
+
+  /* The minimum value for ssthresh should be 2 MSS */
+  if (pcb->ssthresh < 2*pcb->mss) {
+    LWIP_DEBUGF(TCP_FR_DEBUG,
+                ("tcp_receive: The minimum value for ssthresh %"TCPWNDSIZE_F
+                 " should be min 2 mss %"U16_F"...\n",
+                 pcb->ssthresh, 2*pcb->mss));
+    pcb->ssthresh = 2*pcb->mss;
+  }
+
+  pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
+  pcb->flags |= TF_INFR;
+#if LWIP_TCP_SACK
+  pcb->recover = pcb->snd_nxt;
+#endif /* LWIP_TCP_SACK */
+}
+
 /**
  * Handle retransmission after three dupacks received
  *
@@ -1337,28 +1599,66 @@ tcp_rexmit_fast(struct tcp_pcb *pcb)
                  (u16_t)pcb->dupacks, pcb->lastack,
                  ntohl(pcb->unacked->tcphdr->seqno)));
     tcp_rexmit(pcb);
+    tcp_enter_fast_recovery(pcb);
+  }
+}
 
-    /* Set ssthresh to half of the minimum of the current
-     * cwnd and the advertised window */
-    if (pcb->cwnd > pcb->snd_wnd) {
-      pcb->ssthresh = pcb->snd_wnd / 2;
-    } else {
-      pcb->ssthresh = pcb->cwnd / 2;
-    }
+#if LWIP_TCP_SACK
+/**
+ * Retransmit the first segment the SACK scoreboard shows to be lost: a
+ * segment on the unacked queue that is neither SACKed nor retransmitted
+ * yet and has at least TCP_SACK_DUPTHRESH SACKed segments above it
+ * (RFC 6675). Enters fast recovery if we are not in it already. One
+ * segment is sent per incoming ACK.
+ *
+ * The segment is sent where it is on the unacked queue, so holes further
+ * than cwnd beyond the cumulative ACK can be repaired as well.
+ *
+ * Called by tcp_receive() after the scoreboard has been updated.
+ *
+ * @param pcb the tcp_pcb for which to retransmit a lost segment
+ */
+void
+tcp_rexmit_sack(struct tcp_pcb *pcb)
+{
+  struct tcp_seg *seg;
+  u16_t sacked = 0;
 
-    /* The minimum value for ssthresh should be 2 MSS */
-    if (pcb->ssthresh < 2*pcb->mss) {
-      LWIP_DEBUGF(TCP_FR_DEBUG,
-                  ("tcp_receive: The minimum value for ssthresh %"U16_F
-                   " should be min 2 mss %"U16_F"...\n",
-                   pcb->ssthresh, 2*pcb->mss));
-      pcb->ssthresh = 2*pcb->mss;
-    }
+  /* no new recovery before the data outstanding at the last retransmission
+     time-out has been acknowledged */
+  if (!(pcb->flags & TF_INFR) && TCP_SEQ_LT(pcb->lastack, pcb->recover)) {
+    return;
+  }
 
-    pcb->cwnd = pcb->ssthresh + 3 * pcb->mss;
-    pcb->flags |= TF_INFR;
+  for (seg = pcb->unacked; seg != NULL; seg = seg->next) {
+    if (seg->flags & TF_SEG_SACKED) {
+      sacked++;
+    }
+  }
+  /* sacked counts the SACKed segments above seg */
+  for (seg = pcb->unacked; (seg != NULL) && (sacked >= TCP_SACK_DUPTHRESH);
+       seg = seg->next) {
+    if (seg->flags & TF_SEG_SACKED) {
+      sacked--;
+    } else if (!(seg->flags & TF_SEG_REXMIT)) {
+      LWIP_DEBUGF(TCP_FR_DEBUG, ("tcp_rexmit_sack: lastack %"U32_F
+                                 ", retransmit %"U32_F"\n", pcb->lastack,
+                                 ntohl(seg->tcphdr->seqno)));
+      if (!(pcb->flags & TF_INFR)) {
+        tcp_enter_fast_recovery(pcb);
+      }
+      /* pcb->nrtx is left alone: it counts time-outs, and one window may
+         hold many holes */
+      seg->flags |= TF_SEG_REXMIT;
+      snmp_inc_tcpretranssegs();
+      tcp_output_segment(seg, pcb);
+      /* Don't take any rtt measurements after retransmitting. */
+      pcb->rttest = 0;
+      return;
+    }
   }
 }
+#endif /* LWIP_TCP_SACK */
 
 
 /**
@@ -79,6 +79,42 @@ static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 /* exported in udp.h (was static) */
 struct udp_pcb *udp_pcbs;
 
+#if LWIP_PCB_HASH
+#define UDP_PCB_HASH(port) ((u16_t)(((port) ^ ((port) >> 8)) & (UDP_PCB_HASH_SIZE - 1)))
+/* The PCBs of udp_pcbs hashed by local port */
+static struct udp_pcb *udp_pcbs_hash[UDP_PCB_HASH_SIZE];
+
+/**
+ * Add a PCB to the hash bucket of its local port.
+ */
+static void
+udp_pcb_hash_add(struct udp_pcb *pcb)
+{
+  struct udp_pcb **bucket = &udp_pcbs_hash[UDP_PCB_HASH(pcb->local_port)];
+
+  pcb->hash_next = *bucket;
+  *bucket = pcb;
+}
+
+/**
+ * Remove a PCB from the hash bucket of its local port (if it is there).
+ */
+static void
+udp_pcb_hash_remove(struct udp_pcb *pcb)
+{
+  struct udp_pcb **bucket;
+
+  for (bucket = &udp_pcbs_hash[UDP_PCB_HASH(pcb->local_port)];
+       *bucket != NULL; bucket = &(*bucket)->hash_next) {
+    if (*bucket == pcb) {
+      *bucket = pcb->hash_next;
+      break;
+    }
+  }
+  pcb->hash_next = NULL;
+}
+#endif /* LWIP_PCB_HASH */
+
 /**
  * Initialize this module.
  */
@@ -106,7 +142,11 @@ again:
     udp_port = UDP_LOCAL_PORT_RANGE_START;
   }
   /* Check all PCBs. */
+#if LWIP_PCB_HASH
+  for(pcb = udp_pcbs_hash[UDP_PCB_HASH(udp_port)]; pcb != NULL; pcb = pcb->hash_next) {
+#else /* LWIP_PCB_HASH */
   for(pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif /* LWIP_PCB_HASH */
     if (pcb->local_port == udp_port) {
       if (++n > (UDP_LOCAL_PORT_RANGE_END - UDP_LOCAL_PORT_RANGE_START)) {
         return 0;
@@ -157,6 +197,9 @@ udp_input(struct pbuf *p, struct netif *inp)
   u16_t src, dest;
   u8_t local_match;
   u8_t broadcast;
+#if LWIP_PCB_HASH
+  struct udp_pcb **bucket;
+#endif /* LWIP_PCB_HASH */
 
   PERF_START;
 
@@ -226,7 +269,12 @@ udp_input(struct pbuf *p, struct netif *inp)
      * 'Perfect match' pcbs (connected to the remote port & ip address) are
      * preferred. If no perfect match is found, the first unconnected pcb that
      * matches the local port and ip address gets the datagram. */
+#if LWIP_PCB_HASH
+    bucket = &udp_pcbs_hash[UDP_PCB_HASH(dest)];
+    for (pcb = *bucket; pcb != NULL; pcb = pcb->hash_next) {
+#else /* LWIP_PCB_HASH */
     for (pcb = udp_pcbs; pcb != NULL; pcb = pcb->next) {
+#endif /* LWIP_PCB_HASH */
       local_match = 0;
       /* print the PCB local and remote address */
       LWIP_DEBUGF(UDP_DEBUG,
@@ -271,9 +319,15 @@ udp_input(struct pbuf *p, struct netif *inp)
         if (prev != NULL) {
           /* move the pcb to the front of udp_pcbs so that is
              found faster next time */
+#if LWIP_PCB_HASH
+          prev->hash_next = pcb->hash_next;
+          pcb->hash_next = *bucket;
+          *bucket = pcb;
+#else /* LWIP_PCB_HASH */
           prev->next = pcb->next;
           pcb->next = udp_pcbs;
           udp_pcbs = pcb;
+#endif /* LWIP_PCB_HASH */
         } else {
           UDP_STATS_INC(udp.cachehit);
         }
@@ -817,6 +871,12 @@ udp_bind(struct udp_pcb *pcb, ip_addr_t *ipaddr, u16_t port)
       return ERR_USE;
     }
   }
+#if LWIP_PCB_HASH
+  if (rebind != 0) {
+    /* the local port may change, take the PCB out of its old bucket */
+    udp_pcb_hash_remove(pcb);
+  }
+#endif /* LWIP_PCB_HASH */
   pcb->local_port = port;
   snmp_insert_udpidx_tree(pcb);
   /* pcb not active yet? */
@@ -825,6 +885,9 @@ udp_bind(struct udp_pcb *pcb, ip_addr_t *ipaddr, u16_t port)
     pcb->next = udp_pcbs;
     udp_pcbs = pcb;
   }
+#if LWIP_PCB_HASH
+  udp_pcb_hash_add(pcb);
+#endif /* LWIP_PCB_HASH */
   LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE,
               ("udp_bind: bound to %"U16_F".%"U16_F".%"U16_F".%"U16_F", port %"U16_F"\n",
                ip4_addr1_16(&pcb->local_ip), ip4_addr2_16(&pcb->local_ip),
@@ -899,6 +962,9 @@ udp_connect(struct udp_pcb *pcb, ip_addr_t *ipaddr, u16_t port)
   /* PCB not yet on the list, add PCB now */
   pcb->next = udp_pcbs;
   udp_pcbs = pcb;
+#if LWIP_PCB_HASH
+  udp_pcb_hash_add(pcb);
+#endif /* LWIP_PCB_HASH */
   return ERR_OK;
 }
 
@@ -962,6 +1028,9 @@ udp_remove(struct udp_pcb *pcb)
       }
     }
   }
+#if LWIP_PCB_HASH
+  udp_pcb_hash_remove(pcb);
+#endif /* LWIP_PCB_HASH */
   memp_free(MEMP_UDP_PCB, pcb);
 }
 
@@ -130,6 +130,28 @@ struct api_msg_msg;
 /** A callback prototype to inform about events for a netconn */
 typedef void (* netconn_callback)(struct netconn *, enum netconn_evt, u16_t len);
 
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+/** A callback prototype to release a buffer passed to netconn_write_ref().
+ * It is called from tcpip_thread once the stack holds no more references
+ * to the buffer: err is ERR_OK when all 'len' bytes have been acknowledged
+ * by the remote side, or the connection error if it was aborted before. */
+typedef void (* netconn_ref_fn)(struct netconn *conn, void *arg,
+                                const void *dataptr, size_t len, err_t err);
+
+/** An application buffer that is referenced by queued TCP segments */
+struct netconn_ref {
+  struct netconn_ref *next;
+  /** the buffer and the number of bytes enqueued from it */
+  const void *dataptr;
+  size_t len;
+  /** sequence number following the last byte of the buffer */
+  u32_t end_seqno;
+  /** release callback and its argument */
+  netconn_ref_fn ref_fn;
+  void *arg;
+};
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
+
 /** A netconn descriptor */
 struct netconn {
   /** type of the netconn (TCP, UDP or RAW) */
@@ -188,6 +210,12 @@ struct netconn {
       this temporarily stores the message.
       Also used during connect and close. */
   struct api_msg_msg *current_msg;
+#if LWIP_NETCONN_ZEROCOPY
+  /** TCP: buffers written with netconn_write_ref() which are not yet
+      acknowledged, oldest first */
+  struct netconn_ref *refs_head;
+  struct netconn_ref *refs_tail;
+#endif /* LWIP_NETCONN_ZEROCOPY */
 #endif /* LWIP_TCP */
   /** A callback function that is informed about events for this netconn */
   netconn_callback callback;
@@ -239,6 +267,11 @@ err_t   netconn_write_partly(struct netconn *conn, const void *dataptr, size_t s
                              u8_t apiflags, size_t *bytes_written);
 #define netconn_write(conn, dataptr, size, apiflags) \
           netconn_write_partly(conn, dataptr, size, apiflags, NULL)
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+err_t   netconn_write_ref(struct netconn *conn, const void *dataptr, size_t size,
+                          u8_t apiflags, size_t *bytes_written,
+                          netconn_ref_fn ref_fn, void *arg);
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
 err_t   netconn_close(struct netconn *conn);
 err_t   netconn_shutdown(struct netconn *conn, u8_t shut_rx, u8_t shut_tx);
 
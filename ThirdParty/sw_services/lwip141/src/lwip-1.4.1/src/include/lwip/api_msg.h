@@ -92,6 +92,10 @@ struct api_msg_msg {
 #if LWIP_SO_SNDTIMEO
       u32_t time_started;
 #endif /* LWIP_SO_SNDTIMEO */
+#if LWIP_NETCONN_ZEROCOPY
+      /** release record of a netconn_write_ref() call, NULL otherwise */
+      struct netconn_ref *ref;
+#endif /* LWIP_NETCONN_ZEROCOPY */
     } w;
     /** used for do_recv */
     struct {
@@ -54,12 +54,18 @@ LWIP_MEMPOOL(FRAG_PBUF,      MEMP_NUM_FRAG_PBUF,       sizeof(struct pbuf_custom
 #if LWIP_NETCONN
 LWIP_MEMPOOL(NETBUF,         MEMP_NUM_NETBUF,          sizeof(struct netbuf),         "NETBUF")
 LWIP_MEMPOOL(NETCONN,        MEMP_NUM_NETCONN,         sizeof(struct netconn),        "NETCONN")
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+LWIP_MEMPOOL(NETCONN_REF,    MEMP_NUM_NETCONN_REF,     sizeof(struct netconn_ref),    "NETCONN_REF")
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
 #endif /* LWIP_NETCONN */
 
 #if NO_SYS==0
 LWIP_MEMPOOL(TCPIP_MSG_API,  MEMP_NUM_TCPIP_MSG_API,   sizeof(struct tcpip_msg),      "TCPIP_MSG_API")
 #if !LWIP_TCPIP_CORE_LOCKING_INPUT
 LWIP_MEMPOOL(TCPIP_MSG_INPKT,MEMP_NUM_TCPIP_MSG_INPKT, sizeof(struct tcpip_msg),      "TCPIP_MSG_INPKT")
+#if TCPIP_INPKT_BATCH_MAX
+LWIP_MEMPOOL(TCPIP_MSG_INPKT_BATCH, MEMP_NUM_TCPIP_MSG_INPKT_BATCH, sizeof(struct tcpip_inpkt_batch), "TCPIP_MSG_INPKT_BATCH")
+#endif /* TCPIP_INPKT_BATCH_MAX */
 #endif /* !LWIP_TCPIP_CORE_LOCKING_INPUT */
 #endif /* NO_SYS==0 */
 
@@ -340,6 +340,16 @@
 #define MEMP_NUM_NETCONN                4
 #endif
 
+/**
+ * MEMP_NUM_NETCONN_REF: the number of application buffers that can be
+ * handed over with netconn_write_ref() and still be waiting for their
+ * acknowledgement (summed over all netconns).
+ * (only needed if LWIP_NETCONN_ZEROCOPY==1)
+ */
+#ifndef MEMP_NUM_NETCONN_REF
+#define MEMP_NUM_NETCONN_REF            16
+#endif
+
 /**
  * MEMP_NUM_TCPIP_MSG_API: the number of struct tcpip_msg, which are used
  * for callback/timeout API communication.
@@ -358,6 +368,15 @@
 #define MEMP_NUM_TCPIP_MSG_INPKT        8
 #endif
 
+/**
+ * MEMP_NUM_TCPIP_MSG_INPKT_BATCH: the number of packet batches that can be
+ * queued for the tcpip thread by tcpip_input_batch().
+ * (only needed if TCPIP_INPKT_BATCH_MAX > 0)
+ */
+#ifndef MEMP_NUM_TCPIP_MSG_INPKT_BATCH
+#define MEMP_NUM_TCPIP_MSG_INPKT_BATCH  8
+#endif
+
 /**
  * MEMP_NUM_SNMP_NODE: the number of leafs in the SNMP tree.
  */
@@ -897,6 +916,14 @@
 #define UDP_TTL                         (IP_DEFAULT_TTL)
 #endif
 
+/**
+ * UDP_PCB_HASH_SIZE: Number of buckets of the UDP PCB hash table used
+ * when LWIP_PCB_HASH is enabled (must be a power of 2).
+ */
+#ifndef UDP_PCB_HASH_SIZE
+#define UDP_PCB_HASH_SIZE               32
+#endif
+
 /**
  * LWIP_NETBUF_RECVINFO==1: append destination addr and port to every netbuf.
  */
@@ -925,12 +952,29 @@
 
 /**
  * TCP_WND: The size of a TCP window.  This must be at least
- * (2 * TCP_MSS) for things to work well
+ * (2 * TCP_MSS) for things to work well.
+ * With LWIP_WND_SCALE, this may be up to (0xffff << TCP_RCV_SCALE).
  */
 #ifndef TCP_WND
 #define TCP_WND                         (4 * TCP_MSS)
 #endif
 
+/**
+ * LWIP_WND_SCALE==1: Support the TCP window scale option (RFC 7323) so
+ * that windows (TCP_WND, TCP_SND_BUF) larger than 64KB can be used.
+ */
+#ifndef LWIP_WND_SCALE
+#define LWIP_WND_SCALE                  0
+#endif
+
+/**
+ * TCP_RCV_SCALE: Shift count announced in the window scale option. It
+ * must be large enough for (TCP_WND >> TCP_RCV_SCALE) to fit in 16 bits.
+ */
+#ifndef TCP_RCV_SCALE
+#define TCP_RCV_SCALE                   0
+#endif
+
 /**
  * TCP_MAXRTX: Maximum number of retransmissions of data segments.
  */
@@ -953,6 +997,27 @@
 #define TCP_QUEUE_OOSEQ                 (LWIP_TCP)
 #endif
 
+/**
+ * LWIP_TCP_SACK==1: Negotiate selective acknowledgments (RFC 2018) and
+ * report segments held on the out-of-sequence queue in SACK blocks of the
+ * ACKs we send, so the peer only retransmits what is actually missing.
+ * The SACK blocks of the peer mark the segments on our unacked queue, and
+ * a segment with three SACKed segments above it is retransmitted without
+ * waiting for duplicate ACKs or a time-out (RFC 6675).
+ * Requires TCP_QUEUE_OOSEQ.
+ */
+#ifndef LWIP_TCP_SACK
+#define LWIP_TCP_SACK                   0
+#endif
+
+/**
+ * LWIP_TCP_MAX_SACK_NUM: Maximum number of SACK blocks put in one segment
+ * (at most 4, or 3 if timestamps are in use).
+ */
+#ifndef LWIP_TCP_MAX_SACK_NUM
+#define LWIP_TCP_MAX_SACK_NUM           4
+#endif
+
 /**
  * TCP_MSS: TCP Maximum segment size. (default is 536, a conservative default,
  * you might want to increase this.)
@@ -999,7 +1064,7 @@
  * TCP snd_buf for select to return writable (combined with TCP_SNDQUEUELOWAT).
  */
 #ifndef TCP_SNDLOWAT
-#define TCP_SNDLOWAT                    LWIP_MIN(LWIP_MAX(((TCP_SND_BUF)/2), (2 * TCP_MSS) + 1), (TCP_SND_BUF) - 1)
+#define TCP_SNDLOWAT                    LWIP_MIN(LWIP_MAX(((TCP_SND_BUF)/2), (2 * TCP_MSS) + 1), LWIP_MIN((TCP_SND_BUF) - 1, 0xfffe))
 #endif
 
 /**
@@ -1073,7 +1138,11 @@
  * explicit window update
  */
 #ifndef TCP_WND_UPDATE_THRESHOLD
+#if LWIP_WND_SCALE
+#define TCP_WND_UPDATE_THRESHOLD   LWIP_MIN((TCP_WND / 4), (TCP_MSS * 4))
+#else /* LWIP_WND_SCALE */
 #define TCP_WND_UPDATE_THRESHOLD   (TCP_WND / 4)
+#endif /* LWIP_WND_SCALE */
 #endif
 
 /**
@@ -1088,6 +1157,24 @@
 #define LWIP_CALLBACK_API               1
 #endif
 
+/**
+ * LWIP_PCB_HASH==1: Keep hash tables of the active and listening TCP PCBs
+ * and of the UDP PCBs next to the PCB lists, so that tcp_input() and
+ * udp_input() find the PCB of a segment without walking every connection.
+ * Costs one pointer per PCB plus the bucket arrays.
+ */
+#ifndef LWIP_PCB_HASH
+#define LWIP_PCB_HASH                   0
+#endif
+
+/**
+ * TCP_PCB_HASH_SIZE: Number of buckets of the TCP PCB hash tables used
+ * when LWIP_PCB_HASH is enabled (must be a power of 2).
+ */
+#ifndef TCP_PCB_HASH_SIZE
+#define TCP_PCB_HASH_SIZE               64
+#endif
+
 
 /*
    ----------------------------------
@@ -1276,6 +1363,24 @@
 #define TCPIP_MBOX_SIZE                 0
 #endif
 
+/**
+ * TCPIP_MBOX_BATCH: The maximum number of additional messages the tcpip
+ * thread takes from its mailbox without blocking after each wakeup, before
+ * it checks the timeouts again. 0 processes one message per wakeup.
+ */
+#ifndef TCPIP_MBOX_BATCH
+#define TCPIP_MBOX_BATCH                0
+#endif
+
+/**
+ * TCPIP_INPKT_BATCH_MAX: The maximum number of received packets that
+ * tcpip_input_batch() passes to the tcpip thread in a single message.
+ * 0 disables tcpip_input_batch().
+ */
+#ifndef TCPIP_INPKT_BATCH_MAX
+#define TCPIP_INPKT_BATCH_MAX           0
+#endif
+
 /**
  * SLIPIF_THREAD_NAME: The name assigned to the slipif_loop thread.
  */
@@ -1415,6 +1520,16 @@
 #define LWIP_NETCONN                    1
 #endif
 
+/**
+ * LWIP_NETCONN_ZEROCOPY==1: Enable the zero-copy TCP calls: netconn_write_ref()
+ * sends straight out of application buffers and reports their release through
+ * a callback, lwip_recv_pbuf()/lwip_send_ref() expose this and
+ * netconn_recv_tcp_pbuf() to the socket layer.
+ */
+#ifndef LWIP_NETCONN_ZEROCOPY
+#define LWIP_NETCONN_ZEROCOPY           0
+#endif
+
 /** LWIP_TCPIP_TIMEOUT==1: Enable tcpip_timeout/tcpip_untimeout tod create
  * timers running in tcpip_thread from another thread.
  */
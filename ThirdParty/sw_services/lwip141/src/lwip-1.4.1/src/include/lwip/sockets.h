@@ -42,6 +42,10 @@
 
 #include "lwip/ip_addr.h"
 #include "lwip/inet.h"
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+#include "lwip/api.h"
+#include "lwip/pbuf.h"
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
 
 #ifdef __cplusplus
 extern "C" {
@@ -341,6 +345,11 @@ int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptse
                 struct timeval *timeout);
 int lwip_ioctl(int s, long cmd, void *argp);
 int lwip_fcntl(int s, int cmd, int val);
+#if LWIP_TCP && LWIP_NETCONN_ZEROCOPY
+int lwip_recv_pbuf(int s, struct pbuf **p, int flags);
+int lwip_send_ref(int s, const void *dataptr, size_t size, int flags,
+                  netconn_ref_fn ref_fn, void *arg);
+#endif /* LWIP_TCP && LWIP_NETCONN_ZEROCOPY */
 
 #if LWIP_COMPAT_SOCKETS
 #define accept(a,b,c)         lwip_accept(a,b,c)
@@ -153,8 +153,36 @@ enum tcp_state {
 /**
  * members common to struct tcp_pcb and struct tcp_listen_pcb
  */
+#if LWIP_WND_SCALE
+#define RCV_WND_SCALE(pcb, wnd) (((wnd) >> (pcb)->rcv_scale))
+#define SND_WND_SCALE(pcb, wnd) (((wnd) << (pcb)->snd_scale))
+#define TCP_WND_MAX(pcb)        ((tcpwnd_size_t)(((pcb)->flags & TF_WND_SCALE) ? TCP_WND : TCPWND_MIN16(TCP_WND)))
+typedef u32_t tcpwnd_size_t;
+#define TCPWNDSIZE_F            U32_F
+#else /* LWIP_WND_SCALE */
+#define RCV_WND_SCALE(pcb, wnd) (wnd)
+#define SND_WND_SCALE(pcb, wnd) (wnd)
+#define TCP_WND_MAX(pcb)        TCP_WND
+typedef u16_t tcpwnd_size_t;
+#define TCPWNDSIZE_F            U16_F
+#endif /* LWIP_WND_SCALE */
+#define TCPWND_MIN16(x)         ((u16_t)LWIP_MIN((x), 0xFFFF))
+
+#if LWIP_WND_SCALE || LWIP_TCP_SACK
+typedef u16_t tcpflags_t;
+#else /* LWIP_WND_SCALE || LWIP_TCP_SACK */
+typedef u8_t tcpflags_t;
+#endif /* LWIP_WND_SCALE || LWIP_TCP_SACK */
+
+#if LWIP_PCB_HASH
+#define TCP_PCB_HASH_NEXT(type) type *hash_next; /* for the PCB hash table */
+#else /* LWIP_PCB_HASH */
+#define TCP_PCB_HASH_NEXT(type)
+#endif /* LWIP_PCB_HASH */
+
 #define TCP_PCB_COMMON(type) \
   type *next; /* for the linked list */ \
+  TCP_PCB_HASH_NEXT(type) \
   void *callback_arg; \
   /* the accept callback for listen- and normal pcbs, if LWIP_CALLBACK_API */ \
   DEF_ACCEPT_CALLBACK \
@@ -174,15 +202,21 @@ struct tcp_pcb {
   /* ports are in host byte order */
   u16_t remote_port;
 
-  u8_t flags;
-#define TF_ACK_DELAY   ((u8_t)0x01U)   /* Delayed ACK. */
-#define TF_ACK_NOW     ((u8_t)0x02U)   /* Immediate ACK. */
-#define TF_INFR        ((u8_t)0x04U)   /* In fast recovery. */
-#define TF_TIMESTAMP   ((u8_t)0x08U)   /* Timestamp option enabled */
-#define TF_RXCLOSED    ((u8_t)0x10U)   /* rx closed by tcp_shutdown */
-#define TF_FIN         ((u8_t)0x20U)   /* Connection was closed locally (FIN segment enqueued). */
-#define TF_NODELAY     ((u8_t)0x40U)   /* Disable Nagle algorithm */
-#define TF_NAGLEMEMERR ((u8_t)0x80U)   /* nagle enabled, memerr, try to output to prevent delayed ACK to happen */
+  tcpflags_t flags;
+#define TF_ACK_DELAY   ((tcpflags_t)0x01U)   /* Delayed ACK. */
+#define TF_ACK_NOW     ((tcpflags_t)0x02U)   /* Immediate ACK. */
+#define TF_INFR        ((tcpflags_t)0x04U)   /* In fast recovery. */
+#define TF_TIMESTAMP   ((tcpflags_t)0x08U)   /* Timestamp option enabled */
+#define TF_RXCLOSED    ((tcpflags_t)0x10U)   /* rx closed by tcp_shutdown */
+#define TF_FIN         ((tcpflags_t)0x20U)   /* Connection was closed locally (FIN segment enqueued). */
+#define TF_NODELAY     ((tcpflags_t)0x40U)   /* Disable Nagle algorithm */
+#define TF_NAGLEMEMERR ((tcpflags_t)0x80U)   /* nagle enabled, memerr, try to output to prevent delayed ACK to happen */
+#if LWIP_WND_SCALE
+#define TF_WND_SCALE   ((tcpflags_t)0x0100U) /* Window Scale option enabled */
+#endif /* LWIP_WND_SCALE */
+#if LWIP_TCP_SACK
+#define TF_SACK        ((tcpflags_t)0x0200U) /* Peer permitted selective acknowledgments */
+#endif /* LWIP_TCP_SACK */
 
   /* the rest of the fields are in host byte order
      as we have to do some math with them */
@@ -194,9 +228,12 @@ struct tcp_pcb {
 
   /* receiver variables */
   u32_t rcv_nxt;   /* next seqno expected */
-  u16_t rcv_wnd;   /* receiver window available */
-  u16_t rcv_ann_wnd; /* receiver window to announce */
+  tcpwnd_size_t rcv_wnd;   /* receiver window available */
+  tcpwnd_size_t rcv_ann_wnd; /* receiver window to announce */
   u32_t rcv_ann_right_edge; /* announced right edge of window */
+#if LWIP_TCP_SACK
+  u32_t rcv_sack_last; /* seqno of the last out-of-sequence segment received */
+#endif /* LWIP_TCP_SACK */
 
   /* Retransmission timer. */
   s16_t rtime;
@@ -214,22 +251,25 @@ struct tcp_pcb {
   /* fast retransmit/recovery */
   u8_t dupacks;
   u32_t lastack; /* Highest acknowledged seqno. */
+#if LWIP_TCP_SACK
+  u32_t recover; /* snd_nxt when loss recovery was last entered (RFC 6675) */
+#endif /* LWIP_TCP_SACK */
 
   /* congestion avoidance/control variables */
-  u16_t cwnd;
-  u16_t ssthresh;
+  tcpwnd_size_t cwnd;
+  tcpwnd_size_t ssthresh;
 
   /* sender variables */
   u32_t snd_nxt;   /* next new seqno to be sent */
   u32_t snd_wl1, snd_wl2; /* Sequence and acknowledgement numbers of last
                              window update. */
   u32_t snd_lbb;       /* Sequence number of next byte to be buffered. */
-  u16_t snd_wnd;   /* sender window */
-  u16_t snd_wnd_max; /* the maximum sender window announced by the remote host */
+  tcpwnd_size_t snd_wnd;   /* sender window */
+  tcpwnd_size_t snd_wnd_max; /* the maximum sender window announced by the remote host */
 
-  u16_t acked;
+  tcpwnd_size_t acked;
 
-  u16_t snd_buf;   /* Available buffer space for sending (in bytes). */
+  tcpwnd_size_t snd_buf;   /* Available buffer space for sending (in bytes). */
 #define TCP_SNDQUEUELEN_OVERFLOW (0xffffU-3)
   u16_t snd_queuelen; /* Available buffer space for sending (in tcp_segs). */
 
@@ -279,6 +319,11 @@ struct tcp_pcb {
 
   /* KEEPALIVE counter */
   u8_t keep_cnt_sent;
+
+#if LWIP_WND_SCALE
+  u8_t snd_scale;
+  u8_t rcv_scale;
+#endif /* LWIP_WND_SCALE */
 };
 
 struct tcp_pcb_listen {
@@ -323,7 +368,7 @@ void             tcp_poll    (struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interv
 void             tcp_err     (struct tcp_pcb *pcb, tcp_err_fn err);
 
 #define          tcp_mss(pcb)             (((pcb)->flags & TF_TIMESTAMP) ? ((pcb)->mss - 12)  : (pcb)->mss)
-#define          tcp_sndbuf(pcb)          ((pcb)->snd_buf)
+#define          tcp_sndbuf(pcb)          (TCPWND_MIN16((pcb)->snd_buf))
 #define          tcp_sndqueuelen(pcb)     ((pcb)->snd_queuelen)
 #define          tcp_nagle_disable(pcb)   ((pcb)->flags |= TF_NODELAY)
 #define          tcp_nagle_enable(pcb)    ((pcb)->flags &= ~TF_NODELAY)
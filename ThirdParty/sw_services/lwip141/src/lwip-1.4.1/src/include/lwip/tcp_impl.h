@@ -69,6 +69,9 @@ err_t            tcp_send_empty_ack(struct tcp_pcb *pcb);
 void             tcp_rexmit  (struct tcp_pcb *pcb);
 void             tcp_rexmit_rto  (struct tcp_pcb *pcb);
 void             tcp_rexmit_fast (struct tcp_pcb *pcb);
+#if LWIP_TCP_SACK
+void             tcp_rexmit_sack (struct tcp_pcb *pcb);
+#endif /* LWIP_TCP_SACK */
 u32_t            tcp_update_rcv_ann_wnd(struct tcp_pcb *pcb);
 err_t            tcp_process_refused_data(struct tcp_pcb *pcb);
 
@@ -292,15 +295,26 @@ struct tcp_seg {
 #define TF_SEG_OPTS_TS          (u8_t)0x02U /* Include timestamp option. */
 #define TF_SEG_DATA_CHECKSUMMED (u8_t)0x04U /* ALL data (not the header) is
                                                checksummed into 'chksum' */
+#define TF_SEG_OPTS_WND_SCALE   (u8_t)0x08U /* Include window scale option. */
+#define TF_SEG_OPTS_SACK_PERM   (u8_t)0x10U /* Include SACK permitted option. */
+#define TF_SEG_SACKED           (u8_t)0x20U /* Covered by a SACK block of the peer. */
+#define TF_SEG_REXMIT           (u8_t)0x40U /* Retransmitted since the last
+                                               retransmission time-out. */
   struct tcp_hdr *tcphdr;  /* the TCP header */
 };
 
 #define LWIP_TCP_OPT_LENGTH(flags)              \
   (flags & TF_SEG_OPTS_MSS ? 4  : 0) +          \
-  (flags & TF_SEG_OPTS_TS  ? 12 : 0)
+  (flags & TF_SEG_OPTS_TS  ? 12 : 0) +          \
+  (flags & TF_SEG_OPTS_WND_SCALE ? 4 : 0) +     \
+  (flags & TF_SEG_OPTS_SACK_PERM ? 4 : 0)
 
 /** This returns a TCP header option for MSS in an u32_t */
 #define TCP_BUILD_MSS_OPTION(mss) htonl(0x02040000 | ((mss) & 0xFFFF))
+/** This returns a NOP + window scale option in an u32_t */
+#define TCP_BUILD_WND_SCALE_OPTION(shift) htonl(0x01030300 | ((shift) & 0xFF))
+/** This returns two NOPs + the SACK permitted option in an u32_t */
+#define TCP_BUILD_SACK_PERM_OPTION() PP_HTONL(0x01010402)
 
 /* Global variables: */
 extern struct tcp_pcb *tcp_input_pcb;
@@ -327,6 +341,33 @@ extern struct tcp_pcb *tcp_tmp_pcb;      /* Only used for temporary storage. */
    3) All PCBs in the tcp_listen_pcbs list is in LISTEN state.
    4) All PCBs in the tcp_tw_pcbs list is in TIME-WAIT state.
 */
+#if LWIP_PCB_HASH
+/* Hash tables shadowing tcp_active_pcbs (keyed by the connection's ports
+   and remote address) and tcp_listen_pcbs (keyed by the local port). They
+   are updated by TCP_REG and TCP_RMV; the other lists are not hashed. */
+#define TCP_PCB_HASH(lport, rport, rip) \
+  TCP_PCB_HASH_FOLD((u32_t)(lport) ^ (rport) ^ ip4_addr_get_u32(rip) ^ \
+                    (ip4_addr_get_u32(rip) >> 16))
+/* Bits 8-15 are folded in as well: on little endian targets they hold the
+   last byte of the remote address */
+#define TCP_PCB_HASH_FOLD(h) \
+  ((u16_t)(((h) ^ ((h) >> 8)) & (TCP_PCB_HASH_SIZE - 1)))
+#define TCP_LISTEN_PCB_HASH(lport) \
+  ((u16_t)(((lport) ^ ((lport) >> 8)) & (TCP_PCB_HASH_SIZE - 1)))
+
+extern struct tcp_pcb *tcp_active_pcbs_hash[TCP_PCB_HASH_SIZE];
+extern union tcp_listen_pcbs_t tcp_listen_pcbs_hash[TCP_PCB_HASH_SIZE];
+
+void tcp_pcb_hash_add(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+void tcp_pcb_hash_remove(struct tcp_pcb **pcbs, struct tcp_pcb *pcb);
+
+#define TCP_HASH_ADD(pcbs, npcb) tcp_pcb_hash_add((pcbs), (npcb))
+#define TCP_HASH_RMV(pcbs, npcb) tcp_pcb_hash_remove((pcbs), (npcb))
+#else /* LWIP_PCB_HASH */
+#define TCP_HASH_ADD(pcbs, npcb)
+#define TCP_HASH_RMV(pcbs, npcb)
+#endif /* LWIP_PCB_HASH */
+
 /* Define two macros, TCP_REG and TCP_RMV that registers a TCP PCB
    with a PCB list or removes a PCB from a list, respectively. */
 #ifndef TCP_DEBUG_PCB_LISTS
@@ -344,6 +385,7 @@ extern struct tcp_pcb *tcp_tmp_pcb;      /* Only used for temporary storage. */
                             (npcb)->next = *(pcbs); \
                             LWIP_ASSERT("TCP_REG: npcb->next != npcb", (npcb)->next != (npcb)); \
                             *(pcbs) = (npcb); \
+                            TCP_HASH_ADD(pcbs, npcb); \
                             LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
               tcp_timer_needed(); \
                             } while(0)
@@ -358,6 +400,7 @@ extern struct tcp_pcb *tcp_tmp_pcb;      /* Only used for temporary storage. */
                                   break; \
                                } \
                             } \
+                            TCP_HASH_RMV(pcbs, npcb); \
                             (npcb)->next = NULL; \
                             LWIP_ASSERT("TCP_RMV: tcp_pcbs sane", tcp_pcbs_sane()); \
                             LWIP_DEBUGF(TCP_DEBUG, ("TCP_RMV: removed %p from %p\n", (npcb), *(pcbs))); \
@@ -369,6 +412,7 @@ extern struct tcp_pcb *tcp_tmp_pcb;      /* Only used for temporary storage. */
   do {                                             \
     (npcb)->next = *pcbs;                          \
     *(pcbs) = (npcb);                              \
+    TCP_HASH_ADD(pcbs, npcb);                      \
     tcp_timer_needed();                            \
   } while (0)
 
@@ -387,6 +431,7 @@ extern struct tcp_pcb *tcp_tmp_pcb;      /* Only used for temporary storage. */
         }                                          \
       }                                            \
     }                                              \
+    TCP_HASH_RMV(pcbs, npcb);                      \
     (npcb)->next = NULL;                           \
   } while(0)
 
@@ -90,6 +90,9 @@ err_t tcpip_apimsg_lock(struct api_msg *apimsg);
 #endif /* LWIP_NETCONN */
 
 err_t tcpip_input(struct pbuf *p, struct netif *inp);
+#if TCPIP_INPKT_BATCH_MAX
+err_t tcpip_input_batch(struct pbuf **p, u16_t count, struct netif *inp);
+#endif /* TCPIP_INPKT_BATCH_MAX */
 
 #if LWIP_NETIF_API
 err_t tcpip_netifapi(struct netifapi_msg *netifapimsg);
@@ -119,6 +122,9 @@ enum tcpip_msg_type {
   TCPIP_MSG_API,
 #endif /* LWIP_NETCONN */
   TCPIP_MSG_INPKT,
+#if TCPIP_INPKT_BATCH_MAX
+  TCPIP_MSG_INPKT_BATCH,
+#endif /* TCPIP_INPKT_BATCH_MAX */
 #if LWIP_NETIF_API
   TCPIP_MSG_NETIFAPI,
 #endif /* LWIP_NETIF_API */
@@ -158,6 +164,17 @@ struct tcpip_msg {
   } msg;
 };
 
+#if TCPIP_INPKT_BATCH_MAX
+/** Received packets passed to tcpip_thread with a single message */
+struct tcpip_inpkt_batch {
+  /** must be the first member: tcpip_thread casts the message back */
+  struct tcpip_msg msg;
+  struct netif *netif;
+  u16_t count;
+  struct pbuf *p[TCPIP_INPKT_BATCH_MAX];
+};
+#endif /* TCPIP_INPKT_BATCH_MAX */
+
 #ifdef __cplusplus
 }
 #endif
@@ -95,6 +95,10 @@ struct udp_pcb {
 /* Protocol specific PCB members */
 
   struct udp_pcb *next;
+#if LWIP_PCB_HASH
+  /** next pcb in the same udp_pcbs hash bucket */
+  struct udp_pcb *hash_next;
+#endif /* LWIP_PCB_HASH */
 
   u8_t flags;
   /** ports are in host byte order */
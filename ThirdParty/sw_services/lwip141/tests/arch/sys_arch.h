@@ -0,0 +1,85 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file arch/sys_arch.h
+*
+* Host build stand-in for the FreeRTOS sys_arch.h of the Xilinx port, used
+* by the tests built with NO_SYS=0. Semaphores, mutexes and mailboxes are
+* built on POSIX threads, and the operations that cost a FreeRTOS queue
+* call or a task switch on the target are counted in SysStats.
+*
+******************************************************************************/
+
+#ifndef __SYS_XILINX_ARCH_H__
+#define __SYS_XILINX_ARCH_H__
+
+#include <errno.h>
+#include <pthread.h>
+#include "lwipopts.h"
+
+#define SYS_MBOX_NULL		NULL
+#define SYS_SEM_NULL		NULL
+
+typedef struct sys_sem *sys_sem_t;
+typedef struct sys_mutex *sys_mutex_t;
+typedef struct sys_mbox *sys_mbox_t;
+typedef pthread_t sys_thread_t;
+typedef int sys_prot_t;
+
+#define sys_mbox_valid(x)		(*(x) != NULL)
+#define sys_mbox_set_invalid(x)		(*(x) = NULL)
+#define sys_sem_valid(x)		(*(x) != NULL)
+#define sys_sem_set_invalid(x)		(*(x) = NULL)
+#define sys_mutex_valid(x)		(*(x) != NULL)
+#define sys_mutex_set_invalid(x)	(*(x) = NULL)
+
+/* sys.h only defines these for the processors of the target */
+#define SYS_ARCH_DECL_PROTECT(lev)	sys_prot_t lev
+#define SYS_ARCH_PROTECT(lev)		lev = sys_arch_protect()
+#define SYS_ARCH_UNPROTECT(lev)		sys_arch_unprotect(lev)
+
+sys_prot_t sys_arch_protect(void);
+void sys_arch_unprotect(sys_prot_t lev);
+
+typedef struct {
+	unsigned long MboxPosts;	/* Messages posted to mailboxes */
+	unsigned long MboxFetches;	/* Messages taken from them */
+	unsigned long SemSignals;	/* Semaphores signalled */
+	unsigned long MutexLocks;	/* Mutexes taken */
+	unsigned long Blocks;		/* Fetches and waits that had to block */
+} SysArchStats;
+
+extern SysArchStats SysStats;
+
+#endif /* __SYS_XILINX_ARCH_H__ */
@@ -0,0 +1,119 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file lwipopts.h
+*
+* lwIP options of the host build of the tests, in place of the lwipopts.h
+* generated from the library parameters. The stack runs without an OS and
+* without timers, and checksums are neither generated nor checked, so the
+* benchmarks measure the input path of the stack. LWIP_PCB_HASH and the hash
+* sizes are set on the compiler command line, as are window scaling, SACK
+* and the larger windows and pools of tcp_sack_link.
+*
+* tcpip_echo_bench is built with NO_SYS=0: the stack runs in the tcpip
+* thread on the POSIX threads of arch/sys_arch.h, with the socket API, and
+* the tcpip thread options are set on the command line.
+*
+******************************************************************************/
+
+#ifndef __LWIPOPTS_H__
+#define __LWIPOPTS_H__
+
+#define PROCESSOR_LITTLE_ENDIAN
+
+#ifndef NO_SYS
+#define NO_SYS				1
+#endif
+#if NO_SYS
+#define NO_SYS_NO_TIMERS		1
+#define SYS_LIGHTWEIGHT_PROT		0
+#define LWIP_NETCONN			0
+#define LWIP_SOCKET			0
+#else
+#define SYS_LIGHTWEIGHT_PROT		1
+#define LWIP_NETCONN			1
+#define LWIP_SOCKET			1
+#define LWIP_COMPAT_SOCKETS		0
+#define LWIP_COMPAT_MUTEX		0
+#define MEMP_NUM_NETCONN		16
+#define MEMP_NUM_NETBUF			32
+#define MEMP_NUM_TCPIP_MSG_API		32
+#define MEMP_NUM_TCPIP_MSG_INPKT	32
+#define TCPIP_MBOX_SIZE			64
+#define DEFAULT_TCP_RECVMBOX_SIZE	32
+#define DEFAULT_ACCEPTMBOX_SIZE		16
+#endif
+#define LWIP_STATS			0
+#define LWIP_ARP			0
+#define LWIP_DHCP			0
+#define LWIP_IGMP			0
+#define LWIP_RAW			0
+#define IP_REASSEMBLY			0
+#define IP_FRAG				0
+
+#define MEM_ALIGNMENT			8
+#ifndef MEM_SIZE
+#define MEM_SIZE			(1024 * 1024)
+#endif
+#define MEMP_NUM_PBUF			16
+#define MEMP_NUM_TCP_PCB		4200
+#define MEMP_NUM_TCP_PCB_LISTEN		4
+#ifndef MEMP_NUM_TCP_SEG
+#define MEMP_NUM_TCP_SEG		64
+#endif
+#define MEMP_NUM_UDP_PCB		4200
+#ifndef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE			64
+#endif
+#define PBUF_POOL_BUFSIZE		1600
+
+#define TCP_MSS				1460
+#ifndef TCP_WND
+#define TCP_WND				(4 * TCP_MSS)
+#endif
+#ifndef TCP_SND_BUF
+#define TCP_SND_BUF			(4 * TCP_MSS)
+#endif
+#ifndef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN		16
+#endif
+
+#define CHECKSUM_GEN_IP			0
+#define CHECKSUM_GEN_UDP		0
+#define CHECKSUM_GEN_TCP		0
+#define CHECKSUM_CHECK_IP		0
+#define CHECKSUM_CHECK_UDP		0
+#define CHECKSUM_CHECK_TCP		0
+
+#endif /* __LWIPOPTS_H__ */
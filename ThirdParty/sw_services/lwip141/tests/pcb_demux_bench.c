@@ -0,0 +1,425 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file pcb_demux_bench.c
+*
+* Connection scaling benchmark of the TCP and UDP input demultiplexing of
+* lwIP, built once with the PCB lists and once with LWIP_PCB_HASH.
+*
+* The stack runs on the host with one network interface, 10.0.0.1/8, whose
+* output function records the TCP segments the stack sends. For each number
+* of connections the benchmark
+*  - opens that many TCP connections to a listener on port 502: a SYN is fed
+*    to the stack, the sequence number of its SYN-ACK is taken from the
+*    output and the handshake is completed with an ACK,
+*  - feeds pure ACK segments of randomly chosen connections to ip_input()
+*    and reports the time per segment,
+*  - aborts every second connection and checks that segments of the closed
+*    connections are answered with a reset and the others are not,
+*  - binds that many UDP PCBs to consecutive ports and reports the time per
+*    datagram sent to a random one, checking that each datagram reaches the
+*    receive callback of its PCB.
+* The TCP connections come from 16 hosts with consecutive source ports, and
+* in a second pass from one host each with the same source port, as many
+* field devices would.
+*
+* Usage: pcb_demux_bench [segments per measurement]
+*
+* The default is 200000.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwip/init.h"
+#include "lwip/ip.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/tcp_impl.h"
+#include "lwip/udp.h"
+
+/************************** Constant Definitions *****************************/
+
+#define BENCH_MAX_CONNS		4096
+#define BENCH_SERVER_PORT	502
+#define BENCH_UDP_PORT		10000
+#define BENCH_CLIENT_ISS	1000
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32_t Ip;		/* Remote address, host order */
+	u16_t Port;		/* Remote port */
+	u32_t ServerIss;	/* Sequence number of the SYN-ACK */
+	struct tcp_pcb *Pcb;
+} BenchConn;
+
+/************************** Variable Definitions *****************************/
+
+static struct netif Netif;
+static BenchConn Conns[BENCH_MAX_CONNS];
+static struct udp_pcb *UdpPcbs[BENCH_MAX_CONNS];
+static struct tcp_pcb *Listener;
+
+static u32_t OutSegments;	/* TCP segments sent by the stack */
+static u32_t OutRst;		/* Resets among them */
+static u32_t OutSeq;		/* Sequence number of the last one */
+static u8_t OutFlags;		/* Flags of the last one */
+static struct tcp_pcb *Accepted;
+static u32_t UdpWrong;
+static u32_t UdpReceived;
+static u32_t Failed;
+
+static unsigned long long Seed = 1;
+
+/************************** Function Definitions *****************************/
+
+static u32_t BenchRand(u32_t Range)
+{
+	Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+	return (u32_t)(Seed >> 33) % Range;
+}
+
+static double BenchNow(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+
+	return (Ts.tv_sec * 1e9) + Ts.tv_nsec;
+}
+
+static void BenchFail(const char *What, u32_t Value)
+{
+	if (Failed < 10) {
+		printf("  FAIL: %s (%u)\n", What, Value);
+	}
+	Failed++;
+}
+
+/* Output of the network interface, the packet starts with the IP header */
+static err_t BenchOutput(struct netif *NetifPtr, struct pbuf *p,
+			 ip_addr_t *IpAddr)
+{
+	struct ip_hdr *IpHdr = (struct ip_hdr *)p->payload;
+	struct tcp_hdr *TcpHdr;
+
+	(void)NetifPtr;
+	(void)IpAddr;
+
+	if (IPH_PROTO(IpHdr) == IP_PROTO_TCP) {
+		TcpHdr = (struct tcp_hdr *)((u8_t *)p->payload +
+				(IPH_HL(IpHdr) * 4));
+		OutSegments++;
+		OutSeq = ntohl(TcpHdr->seqno);
+		OutFlags = TCPH_FLAGS(TcpHdr);
+		if (OutFlags & TCP_RST) {
+			OutRst++;
+		}
+	}
+
+	return ERR_OK;
+}
+
+static err_t BenchNetifInit(struct netif *NetifPtr)
+{
+	NetifPtr->output = BenchOutput;
+	NetifPtr->mtu = 1500;
+
+	return ERR_OK;
+}
+
+/* Feeds an IP packet with a transport header of HdrLen bytes to the stack */
+static void BenchInput(u32_t SrcIp, u8_t Proto, const void *Hdr, u16_t HdrLen)
+{
+	struct pbuf *p;
+	struct ip_hdr *IpHdr;
+
+	p = pbuf_alloc(PBUF_RAW, IP_HLEN + HdrLen, PBUF_POOL);
+	if (p == NULL) {
+		BenchFail("out of pbufs", 0);
+		return;
+	}
+	IpHdr = (struct ip_hdr *)p->payload;
+	memset(IpHdr, 0, IP_HLEN);
+	IPH_VHL_SET(IpHdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(IpHdr, htons(IP_HLEN + HdrLen));
+	IPH_TTL_SET(IpHdr, 64);
+	IPH_PROTO_SET(IpHdr, Proto);
+	IpHdr->src.addr = htonl(SrcIp);
+	IpHdr->dest.addr = Netif.ip_addr.addr;
+	memcpy((u8_t *)p->payload + IP_HLEN, Hdr, HdrLen);
+
+	ip_input(p, &Netif);
+}
+
+static void BenchTcpInput(const BenchConn *Conn, u32_t Seq, u32_t Ack,
+			  u8_t Flags)
+{
+	struct tcp_hdr TcpHdr;
+
+	memset(&TcpHdr, 0, sizeof(TcpHdr));
+	TcpHdr.src = htons(Conn->Port);
+	TcpHdr.dest = htons(BENCH_SERVER_PORT);
+	TcpHdr.seqno = htonl(Seq);
+	TcpHdr.ackno = htonl(Ack);
+	TCPH_HDRLEN_FLAGS_SET(&TcpHdr, 5, Flags);
+	TcpHdr.wnd = htons(TCP_WND);
+
+	BenchInput(Conn->Ip, IP_PROTO_TCP, &TcpHdr, sizeof(TcpHdr));
+}
+
+static err_t BenchAccept(void *Arg, struct tcp_pcb *NewPcb, err_t Err)
+{
+	(void)Arg;
+	(void)Err;
+	Accepted = NewPcb;
+
+	return ERR_OK;
+}
+
+static void BenchUdpRecv(void *Arg, struct udp_pcb *Pcb, struct pbuf *p,
+			 ip_addr_t *Addr, u16_t Port)
+{
+	u32_t Index = (u32_t)(mem_ptr_t)Arg;
+
+	(void)Addr;
+	(void)Port;
+	if (UdpPcbs[Index] != Pcb) {
+		UdpWrong++;
+	}
+	UdpReceived++;
+	pbuf_free(p);
+}
+
+/* Opens the connections, returns the number opened */
+static u32_t BenchOpen(u32_t NumConns, u32_t SamePort)
+{
+	BenchConn *Conn;
+	u32_t Index;
+
+	for (Index = 0; Index < NumConns; Index++) {
+		Conn = &Conns[Index];
+		if (SamePort) {
+			/* 10.1.0.0 and up, all from port 5000 */
+			Conn->Ip = 0x0A010000 + Index;
+			Conn->Port = 5000;
+		}
+		else {
+			/* 16 hosts, consecutive ports */
+			Conn->Ip = 0x0A010000 + (Index % 16);
+			Conn->Port = (u16_t)(49152 + (Index / 16));
+		}
+
+		Accepted = NULL;
+		OutFlags = 0;
+		BenchTcpInput(Conn, BENCH_CLIENT_ISS, 0, TCP_SYN);
+		if (OutFlags != (TCP_SYN | TCP_ACK)) {
+			BenchFail("no SYN-ACK", Index);
+			return Index;
+		}
+		Conn->ServerIss = OutSeq;
+		BenchTcpInput(Conn, BENCH_CLIENT_ISS + 1, Conn->ServerIss + 1,
+				TCP_ACK);
+		if ((Accepted == NULL) || (Accepted->state != ESTABLISHED)) {
+			BenchFail("connection not accepted", Index);
+			return Index;
+		}
+		Conn->Pcb = Accepted;
+	}
+
+	return NumConns;
+}
+
+/* Time per pure ACK segment of a random connection, ns */
+static double BenchTcp(u32_t NumConns, u32_t Segments)
+{
+	BenchConn *Conn;
+	u32_t StartOut = OutSegments;
+	u32_t Count;
+	double Start;
+	double Ns;
+
+	Start = BenchNow();
+	for (Count = 0; Count < Segments; Count++) {
+		Conn = &Conns[BenchRand(NumConns)];
+		BenchTcpInput(Conn, BENCH_CLIENT_ISS + 1, Conn->ServerIss + 1,
+				TCP_ACK);
+	}
+	Ns = (BenchNow() - Start) / Segments;
+
+	if (OutSegments != StartOut) {
+		BenchFail("segments of open connections answered",
+			  OutSegments - StartOut);
+	}
+
+	return Ns;
+}
+
+/* Aborts every second connection, checks the demultiplexing, closes all */
+static void BenchClose(u32_t NumConns)
+{
+	u32_t Index;
+	u32_t StartRst;
+
+	for (Index = 0; Index < NumConns; Index += 2) {
+		tcp_abort(Conns[Index].Pcb);
+		Conns[Index].Pcb = NULL;
+	}
+
+	StartRst = OutRst;
+	for (Index = 0; Index < NumConns; Index++) {
+		BenchTcpInput(&Conns[Index], BENCH_CLIENT_ISS + 1,
+			Conns[Index].ServerIss + 1, TCP_ACK);
+	}
+	if (OutRst - StartRst != (NumConns + 1) / 2) {
+		BenchFail("resets for closed connections", OutRst - StartRst);
+	}
+
+	for (Index = 1; Index < NumConns; Index += 2) {
+		tcp_abort(Conns[Index].Pcb);
+		Conns[Index].Pcb = NULL;
+	}
+	if (tcp_active_pcbs != NULL) {
+		BenchFail("connections left", 0);
+	}
+}
+
+/* Time per datagram to a random bound UDP PCB, ns */
+static double BenchUdp(u32_t NumPcbs, u32_t Datagrams)
+{
+	struct udp_hdr UdpHdr;
+	u16_t Port;
+	u32_t Index;
+	u32_t Count;
+	double Start;
+	double Ns;
+
+	for (Index = 0; Index < NumPcbs; Index++) {
+		UdpPcbs[Index] = udp_new();
+		if ((UdpPcbs[Index] == NULL) || (udp_bind(UdpPcbs[Index],
+			IP_ADDR_ANY, (u16_t)(BENCH_UDP_PORT + Index)) != ERR_OK)) {
+			BenchFail("udp bind", Index);
+			return 0.0;
+		}
+		udp_recv(UdpPcbs[Index], BenchUdpRecv,
+			 (void *)(mem_ptr_t)Index);
+	}
+
+	UdpWrong = 0;
+	UdpReceived = 0;
+	memset(&UdpHdr, 0, sizeof(UdpHdr));
+	UdpHdr.src = htons(5000);
+	UdpHdr.len = htons(UDP_HLEN);
+
+	Start = BenchNow();
+	for (Count = 0; Count < Datagrams; Count++) {
+		Port = (u16_t)(BENCH_UDP_PORT + BenchRand(NumPcbs));
+		UdpHdr.dest = htons(Port);
+		BenchInput(0x0A010001, IP_PROTO_UDP, &UdpHdr, sizeof(UdpHdr));
+	}
+	Ns = (BenchNow() - Start) / Datagrams;
+
+	if ((UdpReceived != Datagrams) || (UdpWrong != 0)) {
+		BenchFail("datagrams not delivered to their PCB",
+			  Datagrams - UdpReceived + UdpWrong);
+	}
+
+	for (Index = 0; Index < NumPcbs; Index++) {
+		udp_remove(UdpPcbs[Index]);
+	}
+
+	return Ns;
+}
+
+int main(int argc, char *argv[])
+{
+	static const u32_t Sizes[] = { 16, 256, 1024, 4096 };
+	ip_addr_t Addr;
+	ip_addr_t Mask;
+	ip_addr_t Gw;
+	u32_t Segments = 200000;
+	u32_t Index;
+	u32_t Pass;
+	u32_t Opened;
+	double Ns[2];
+
+	if (argc > 1) {
+		Segments = strtoul(argv[1], NULL, 0);
+	}
+
+	lwip_init();
+	IP4_ADDR(&Addr, 10, 0, 0, 1);
+	IP4_ADDR(&Mask, 255, 0, 0, 0);
+	IP4_ADDR(&Gw, 10, 0, 0, 254);
+	netif_add(&Netif, &Addr, &Mask, &Gw, NULL, BenchNetifInit, ip_input);
+	netif_set_default(&Netif);
+	netif_set_up(&Netif);
+
+	Listener = tcp_new();
+	tcp_bind(Listener, IP_ADDR_ANY, BENCH_SERVER_PORT);
+	Listener = tcp_listen(Listener);
+	tcp_accept(Listener, BenchAccept);
+
+#if LWIP_PCB_HASH
+	printf("PCB hash tables, %d TCP and %d UDP buckets\n\n",
+		TCP_PCB_HASH_SIZE, UDP_PCB_HASH_SIZE);
+#else
+	printf("PCB lists\n\n");
+#endif
+	printf("%11s %14s %14s %14s\n", "connections", "TCP ns/seg",
+		"TCP ns/seg", "UDP ns/dgram");
+	printf("%11s %14s %14s %14s\n", "", "16 hosts", "same port", "");
+
+	for (Index = 0; Index < sizeof(Sizes) / sizeof(Sizes[0]); Index++) {
+		for (Pass = 0; Pass < 2; Pass++) {
+			Opened = BenchOpen(Sizes[Index], Pass);
+			Ns[Pass] = (Opened == Sizes[Index]) ?
+				BenchTcp(Opened, Segments) : 0.0;
+			BenchClose(Opened);
+		}
+		printf("%11u %14.1f %14.1f %14.1f\n", Sizes[Index], Ns[0],
+			Ns[1], BenchUdp(Sizes[Index], Segments));
+	}
+
+	printf("\n%s\n", (Failed == 0) ? "all checks passed" :
+					"CHECKS FAILED");
+	return (Failed == 0) ? 0 : 1;
+}
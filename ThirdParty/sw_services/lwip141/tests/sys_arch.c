@@ -0,0 +1,368 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file sys_arch.c
+*
+* Host build stand-in for the FreeRTOS sys_arch.c of the Xilinx port: the
+* lwIP system layer on POSIX threads. Mailboxes have a fixed size like the
+* FreeRTOS queues they replace, sys_arch_protect() takes one recursive
+* mutex, and the operations are counted in SysStats.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdlib.h>
+#include <time.h>
+#include "lwip/opt.h"
+#include "lwip/sys.h"
+
+/**************************** Type Definitions *******************************/
+
+struct sys_sem {
+	pthread_mutex_t Lock;
+	pthread_cond_t Cond;
+	u32_t Count;
+};
+
+struct sys_mutex {
+	pthread_mutex_t Lock;
+};
+
+struct sys_mbox {
+	pthread_mutex_t Lock;
+	pthread_cond_t NotEmpty;
+	pthread_cond_t NotFull;
+	u32_t Size;
+	u32_t Head;
+	u32_t Count;
+	void **Msgs;
+};
+
+typedef struct {
+	lwip_thread_fn Fn;
+	void *Arg;
+} SysThreadStart;
+
+/************************** Variable Definitions *****************************/
+
+SysArchStats SysStats;
+
+static pthread_mutex_t ProtLock;
+
+/************************** Function Definitions *****************************/
+
+#define SysCount(Field)	__atomic_fetch_add(&SysStats.Field, 1, __ATOMIC_RELAXED)
+
+static void SysCondInit(pthread_cond_t *Cond)
+{
+	pthread_condattr_t Attr;
+
+	pthread_condattr_init(&Attr);
+	pthread_condattr_setclock(&Attr, CLOCK_MONOTONIC);
+	pthread_cond_init(Cond, &Attr);
+	pthread_condattr_destroy(&Attr);
+}
+
+/*
+ * Waits on Cond for at most Timeout ms, 0 waits forever. Returns nonzero
+ * once the time-out has expired.
+ */
+static int SysCondWait(pthread_cond_t *Cond, pthread_mutex_t *Lock,
+		       u32_t Start, u32_t Timeout)
+{
+	struct timespec Ts;
+	u32_t End = Start + Timeout;
+
+	if (Timeout == 0) {
+		pthread_cond_wait(Cond, Lock);
+		return 0;
+	}
+	Ts.tv_sec = End / 1000;
+	Ts.tv_nsec = (long)(End % 1000) * 1000000L;
+
+	return pthread_cond_timedwait(Cond, Lock, &Ts) != 0;
+}
+
+u32_t sys_now(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+
+	return (u32_t)(Ts.tv_sec * 1000 + Ts.tv_nsec / 1000000);
+}
+
+void sys_init(void)
+{
+	pthread_mutexattr_t Attr;
+
+	pthread_mutexattr_init(&Attr);
+	pthread_mutexattr_settype(&Attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&ProtLock, &Attr);
+	pthread_mutexattr_destroy(&Attr);
+}
+
+sys_prot_t sys_arch_protect(void)
+{
+	pthread_mutex_lock(&ProtLock);
+
+	return 0;
+}
+
+void sys_arch_unprotect(sys_prot_t Lev)
+{
+	(void)Lev;
+
+	pthread_mutex_unlock(&ProtLock);
+}
+
+err_t sys_sem_new(sys_sem_t *Sem, u8_t Count)
+{
+	*Sem = malloc(sizeof(**Sem));
+	if (*Sem == NULL) {
+		return ERR_MEM;
+	}
+	pthread_mutex_init(&(*Sem)->Lock, NULL);
+	SysCondInit(&(*Sem)->Cond);
+	(*Sem)->Count = Count;
+
+	return ERR_OK;
+}
+
+void sys_sem_signal(sys_sem_t *Sem)
+{
+	SysCount(SemSignals);
+	pthread_mutex_lock(&(*Sem)->Lock);
+	(*Sem)->Count++;
+	pthread_cond_signal(&(*Sem)->Cond);
+	pthread_mutex_unlock(&(*Sem)->Lock);
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *Sem, u32_t Timeout)
+{
+	u32_t Start = sys_now();
+
+	pthread_mutex_lock(&(*Sem)->Lock);
+	if ((*Sem)->Count == 0) {
+		SysCount(Blocks);
+	}
+	while ((*Sem)->Count == 0) {
+		if (SysCondWait(&(*Sem)->Cond, &(*Sem)->Lock, Start, Timeout)) {
+			pthread_mutex_unlock(&(*Sem)->Lock);
+			return SYS_ARCH_TIMEOUT;
+		}
+	}
+	(*Sem)->Count--;
+	pthread_mutex_unlock(&(*Sem)->Lock);
+
+	return sys_now() - Start;
+}
+
+void sys_sem_free(sys_sem_t *Sem)
+{
+	pthread_cond_destroy(&(*Sem)->Cond);
+	pthread_mutex_destroy(&(*Sem)->Lock);
+	free(*Sem);
+}
+
+err_t sys_mutex_new(sys_mutex_t *Mutex)
+{
+	*Mutex = malloc(sizeof(**Mutex));
+	if (*Mutex == NULL) {
+		return ERR_MEM;
+	}
+	pthread_mutex_init(&(*Mutex)->Lock, NULL);
+
+	return ERR_OK;
+}
+
+void sys_mutex_lock(sys_mutex_t *Mutex)
+{
+	SysCount(MutexLocks);
+	if (pthread_mutex_trylock(&(*Mutex)->Lock) != 0) {
+		SysCount(Blocks);
+		pthread_mutex_lock(&(*Mutex)->Lock);
+	}
+}
+
+void sys_mutex_unlock(sys_mutex_t *Mutex)
+{
+	pthread_mutex_unlock(&(*Mutex)->Lock);
+}
+
+void sys_mutex_free(sys_mutex_t *Mutex)
+{
+	pthread_mutex_destroy(&(*Mutex)->Lock);
+	free(*Mutex);
+}
+
+err_t sys_mbox_new(sys_mbox_t *Mbox, int Size)
+{
+	if (Size <= 0) {
+		Size = 64;
+	}
+	*Mbox = malloc(sizeof(**Mbox));
+	if (*Mbox == NULL) {
+		return ERR_MEM;
+	}
+	(*Mbox)->Msgs = malloc(Size * sizeof(void *));
+	if ((*Mbox)->Msgs == NULL) {
+		free(*Mbox);
+		return ERR_MEM;
+	}
+	pthread_mutex_init(&(*Mbox)->Lock, NULL);
+	SysCondInit(&(*Mbox)->NotEmpty);
+	SysCondInit(&(*Mbox)->NotFull);
+	(*Mbox)->Size = Size;
+	(*Mbox)->Head = 0;
+	(*Mbox)->Count = 0;
+
+	return ERR_OK;
+}
+
+static void SysMboxPut(struct sys_mbox *Mbox, void *Msg)
+{
+	SysCount(MboxPosts);
+	Mbox->Msgs[(Mbox->Head + Mbox->Count) % Mbox->Size] = Msg;
+	Mbox->Count++;
+	pthread_cond_signal(&Mbox->NotEmpty);
+}
+
+void sys_mbox_post(sys_mbox_t *Mbox, void *Msg)
+{
+	pthread_mutex_lock(&(*Mbox)->Lock);
+	while ((*Mbox)->Count == (*Mbox)->Size) {
+		pthread_cond_wait(&(*Mbox)->NotFull, &(*Mbox)->Lock);
+	}
+	SysMboxPut(*Mbox, Msg);
+	pthread_mutex_unlock(&(*Mbox)->Lock);
+}
+
+err_t sys_mbox_trypost(sys_mbox_t *Mbox, void *Msg)
+{
+	err_t Status = ERR_MEM;
+
+	pthread_mutex_lock(&(*Mbox)->Lock);
+	if ((*Mbox)->Count < (*Mbox)->Size) {
+		SysMboxPut(*Mbox, Msg);
+		Status = ERR_OK;
+	}
+	pthread_mutex_unlock(&(*Mbox)->Lock);
+
+	return Status;
+}
+
+static void SysMboxGet(struct sys_mbox *Mbox, void **Msg)
+{
+	SysCount(MboxFetches);
+	if (Msg != NULL) {
+		*Msg = Mbox->Msgs[Mbox->Head];
+	}
+	Mbox->Head = (Mbox->Head + 1) % Mbox->Size;
+	Mbox->Count--;
+	pthread_cond_signal(&Mbox->NotFull);
+}
+
+u32_t sys_arch_mbox_fetch(sys_mbox_t *Mbox, void **Msg, u32_t Timeout)
+{
+	u32_t Start = sys_now();
+
+	pthread_mutex_lock(&(*Mbox)->Lock);
+	if ((*Mbox)->Count == 0) {
+		SysCount(Blocks);
+	}
+	while ((*Mbox)->Count == 0) {
+		if (SysCondWait(&(*Mbox)->NotEmpty, &(*Mbox)->Lock, Start,
+				Timeout)) {
+			pthread_mutex_unlock(&(*Mbox)->Lock);
+			return SYS_ARCH_TIMEOUT;
+		}
+	}
+	SysMboxGet(*Mbox, Msg);
+	pthread_mutex_unlock(&(*Mbox)->Lock);
+
+	return sys_now() - Start;
+}
+
+u32_t sys_arch_mbox_tryfetch(sys_mbox_t *Mbox, void **Msg)
+{
+	u32_t Status = SYS_MBOX_EMPTY;
+
+	pthread_mutex_lock(&(*Mbox)->Lock);
+	if ((*Mbox)->Count > 0) {
+		SysMboxGet(*Mbox, Msg);
+		Status = 0;
+	}
+	pthread_mutex_unlock(&(*Mbox)->Lock);
+
+	return Status;
+}
+
+void sys_mbox_free(sys_mbox_t *Mbox)
+{
+	pthread_cond_destroy(&(*Mbox)->NotFull);
+	pthread_cond_destroy(&(*Mbox)->NotEmpty);
+	pthread_mutex_destroy(&(*Mbox)->Lock);
+	free((*Mbox)->Msgs);
+	free(*Mbox);
+}
+
+static void *SysThreadMain(void *Arg)
+{
+	SysThreadStart Start = *(SysThreadStart *)Arg;
+
+	free(Arg);
+	Start.Fn(Start.Arg);
+
+	return NULL;
+}
+
+sys_thread_t sys_thread_new(const char *Name, lwip_thread_fn Fn, void *Arg,
+			    int StackSize, int Prio)
+{
+	SysThreadStart *Start = malloc(sizeof(*Start));
+	pthread_t Thread;
+
+	(void)Name;
+	(void)StackSize;
+	(void)Prio;
+
+	Start->Fn = Fn;
+	Start->Arg = Arg;
+	pthread_create(&Thread, NULL, SysThreadMain, Start);
+	pthread_detach(Thread);
+
+	return Thread;
+}
@@ -0,0 +1,723 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file tcp_sack_link.c
+*
+* Test of the TCP selective acknowledgments of lwIP (LWIP_TCP_SACK) over a
+* simulated lossy link.
+*
+* The two ends of a TCP connection, A and B, run on one network interface of
+* the host, 10.0.0.1/8. A connects to B on port 6000 and sends it a stream of
+* known data. The output function of the interface puts each packet on the
+* link of its direction, which has a bandwidth of 20 Mbit/s and a one-way
+* delay of 30 ms, and the packets are fed to ip_input() when they arrive.
+* The test runs in simulated time and calls tcp_tmr() every 250 ms. Data
+* segments are dropped on the link, either chosen by their index or at
+* random at a given rate.
+*
+* Every packet sent is checked:
+*  - the data and options of a segment fit in the MSS of 1460 bytes,
+*  - each SACK block lies above the cumulative ACK, covers data that was
+*    delivered to the receiver and is maximal: the bytes just before and
+*    just after it were not delivered,
+*  - the first SACK block of an ACK sent for an out-of-sequence segment
+*    holds that segment.
+* The runs are
+*  - two segments of one window dropped: each is retransmitted once, and
+*    the ACKs carry two SACK blocks,
+*  - random loss of data segments with SACK and, with the SACK-permitted
+*    option removed from the SYNs, without it: the throughput of both is
+*    reported and SACK has to be faster,
+*  - random loss in both directions while B sends messages of up to one
+*    MSS to A: B piggybacks SACK blocks on its data segments where they fit.
+* All data received is compared with what was sent.
+*
+* Usage: tcp_sack_link
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 1.0        10/18/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lwip/init.h"
+#include "lwip/ip.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/tcp_impl.h"
+
+/************************** Constant Definitions *****************************/
+
+#define BENCH_PORT		6000
+#define BENCH_MTU		1500
+#define BENCH_NS_PER_BYTE	400ULL		/* 20 Mbit/s */
+#define BENCH_DELAY_NS		30000000ULL	/* one way */
+#define BENCH_TMR_NS		(TCP_TMR_INTERVAL * 1000000ULL)
+#define BENCH_MSG_NS		20000000ULL	/* messages of B */
+#define BENCH_LIMIT_NS		120000000000ULL	/* per run */
+#define BENCH_QUEUE		4096		/* packets per direction */
+#define BENCH_MAX_BYTES		(8 * 1024 * 1024)
+#define BENCH_CHUNK		8192
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	unsigned long long Due;	/* Arrival time */
+	u16_t Len;
+	u8_t Data[BENCH_MTU];
+} BenchPkt;
+
+/* One direction of the link and the stream of data sent over it */
+typedef struct {
+	BenchPkt *Pkts;		/* Packets in flight */
+	u32_t Head;
+	u32_t Count;
+	unsigned long long BusyUntil;
+	u8_t *Delivered;	/* Bitmap of the data given to the receiver */
+	u32_t CumDelivered;	/* First byte not given to it */
+	u32_t Iss;		/* Initial sequence number of the sender */
+	u32_t SndMax;		/* End of the highest data sent */
+	u32_t DataSegs;		/* Data segments sent */
+	u32_t Drops;
+	u32_t Rexmits;		/* Segments sent again */
+	u32_t RexmitBytes;
+	u32_t SackSegs;		/* Segments with SACK blocks for the reverse */
+	u32_t PiggySacks;	/* stream, and those of them carrying data */
+	u32_t MaxBlocks;
+	u32_t Sent;		/* Stream bytes written by the sender */
+	u32_t Received;		/* and read by the receiver */
+} BenchDir;
+
+typedef struct {
+	u32_t Bytes;		/* Sent by A */
+	u32_t LossPpm;		/* Random loss of data segments */
+	const u32_t *DropList;	/* Indexes of data segments of A to drop */
+	u32_t DropNum;
+	u8_t Sack;		/* SACK-permitted left in the SYNs */
+	u8_t Bidir;		/* B sends messages to A, loss both ways */
+} BenchCfg;
+
+/************************** Variable Definitions *****************************/
+
+static struct netif Netif;
+static BenchPkt Pkts[2][BENCH_QUEUE];
+static u8_t Delivered[2][BENCH_MAX_BYTES / 8 + 1];
+static BenchDir Dirs[2];	/* 0: A to B, 1: B to A */
+static const BenchCfg *Cfg;
+
+static struct tcp_pcb *Client;
+static struct tcp_pcb *Listener;
+static struct tcp_pcb *Accepted;
+static unsigned long long Now;
+static unsigned long long StartTime;
+static unsigned long long DoneTime;
+static u8_t Chunk[BENCH_CHUNK];
+static u32_t Messages;
+
+/* Segment being given to ip_input() */
+static int DelivDir = -1;
+static u32_t DelivOff;
+static u32_t DelivLen;
+static u8_t DelivOoseq;
+
+static u32_t Failed;
+
+static unsigned long long Seed = 1;
+
+static const u16_t MsgSizes[] = { 1000, 1410, 1440, 1460 };
+
+/************************** Function Definitions *****************************/
+
+static u32_t BenchRand(u32_t Range)
+{
+	Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+	return (u32_t)(Seed >> 33) % Range;
+}
+
+static void BenchFail(const char *What, u32_t Value)
+{
+	if (Failed < 10) {
+		printf("  FAIL: %s (%u)\n", What, Value);
+	}
+	Failed++;
+}
+
+static u8_t BenchPattern(u32_t Dir, u32_t Offset)
+{
+	return (u8_t)(Offset ^ (Offset >> 11) ^ (Dir * 0x5A));
+}
+
+static int BenchIsDelivered(const BenchDir *D, u32_t Off)
+{
+	return (D->Delivered[Off >> 3] >> (Off & 7)) & 1;
+}
+
+/* Returns 1 if every byte of [Lo, Hi) was given to the receiver */
+static int BenchAllDelivered(const BenchDir *D, u32_t Lo, u32_t Hi)
+{
+	while ((Lo < Hi) && (Lo & 7)) {
+		if (!BenchIsDelivered(D, Lo++)) {
+			return 0;
+		}
+	}
+	while (Lo + 8 <= Hi) {
+		if (D->Delivered[Lo >> 3] != 0xFF) {
+			return 0;
+		}
+		Lo += 8;
+	}
+	while (Lo < Hi) {
+		if (!BenchIsDelivered(D, Lo++)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/* Checks the SACK blocks sent for the stream of direction Dir */
+static void BenchCheckSack(u32_t Dir, const struct tcp_hdr *TcpHdr,
+			   const u8_t *Blocks, u32_t Num)
+{
+	const BenchDir *D = &Dirs[Dir];
+	u32_t Ack = ntohl(TcpHdr->ackno) - (D->Iss + 1);
+	u32_t Index;
+	u32_t Lo;
+	u32_t Hi;
+
+	for (Index = 0; Index < Num; Index++) {
+		Lo = ((u32_t)Blocks[0] << 24) | ((u32_t)Blocks[1] << 16) |
+			((u32_t)Blocks[2] << 8) | Blocks[3];
+		Hi = ((u32_t)Blocks[4] << 24) | ((u32_t)Blocks[5] << 16) |
+			((u32_t)Blocks[6] << 8) | Blocks[7];
+		Lo -= D->Iss + 1;
+		Hi -= D->Iss + 1;
+		Blocks += 8;
+
+		if (((s32_t)(Lo - Ack) <= 0) || ((s32_t)(Hi - Lo) <= 0) ||
+		    (Hi > BENCH_MAX_BYTES)) {
+			BenchFail("SACK block at or below the ACK", Lo);
+			continue;
+		}
+		if (!BenchAllDelivered(D, Lo, Hi)) {
+			BenchFail("SACK block holds data not received", Lo);
+		}
+		if (BenchIsDelivered(D, Lo - 1) || BenchIsDelivered(D, Hi)) {
+			BenchFail("SACK block not maximal", Lo);
+		}
+		if ((Index == 0) && ((int)Dir == DelivDir) && DelivOoseq &&
+		    ((DelivOff < Lo) || (DelivOff + DelivLen > Hi))) {
+			BenchFail("first SACK block misses the last segment",
+				  DelivOff);
+		}
+	}
+}
+
+/* Output of the network interface, the packet starts with the IP header */
+static err_t BenchOutput(struct netif *NetifPtr, struct pbuf *p,
+			 ip_addr_t *IpAddr)
+{
+	BenchDir *D;
+	BenchPkt *Pkt;
+	struct ip_hdr *IpHdr;
+	struct tcp_hdr *TcpHdr;
+	u8_t *Opts;
+	u32_t Dir;
+	u32_t OptLen;
+	u32_t Payload;
+	u32_t Off;
+	u32_t Index;
+	unsigned long long Start;
+
+	(void)NetifPtr;
+	(void)IpAddr;
+
+	if (p->tot_len > BENCH_MTU) {
+		BenchFail("packet exceeds the MTU", p->tot_len);
+		return ERR_OK;
+	}
+	if (Dirs[0].Count == BENCH_QUEUE || Dirs[1].Count == BENCH_QUEUE) {
+		BenchFail("link queue full", p->tot_len);
+		return ERR_OK;
+	}
+
+	/* B sends from the port it listens on */
+	IpHdr = (struct ip_hdr *)p->payload;
+	TcpHdr = (struct tcp_hdr *)((u8_t *)p->payload + IPH_HL(IpHdr) * 4);
+	Dir = (ntohs(TcpHdr->src) == BENCH_PORT) ? 1 : 0;
+
+	/* Copied to the tail of the queue, the slot is only used if kept */
+	D = &Dirs[Dir];
+	Pkt = &D->Pkts[(D->Head + D->Count) % BENCH_QUEUE];
+	pbuf_copy_partial(p, Pkt->Data, p->tot_len, 0);
+	Pkt->Len = p->tot_len;
+	IpHdr = (struct ip_hdr *)(void *)Pkt->Data;
+	TcpHdr = (struct tcp_hdr *)(void *)(Pkt->Data + IPH_HL(IpHdr) * 4);
+	Opts = (u8_t *)(TcpHdr + 1);
+	OptLen = TCPH_HDRLEN(TcpHdr) * 4 - TCP_HLEN;
+	Payload = Pkt->Len - IPH_HL(IpHdr) * 4 - TCP_HLEN - OptLen;
+
+	if (OptLen + Payload > TCP_MSS) {
+		BenchFail("segment exceeds the MSS", OptLen + Payload);
+	}
+	if (TCPH_FLAGS(TcpHdr) & TCP_SYN) {
+		D->Iss = ntohl(TcpHdr->seqno);
+	}
+
+	for (Index = 0; Index < OptLen; ) {
+		if (Opts[Index] == 0) {
+			break;
+		}
+		if (Opts[Index] == 1) {
+			Index++;
+			continue;
+		}
+		if ((Opts[Index] == 4) && !Cfg->Sack) {
+			/* replaced by two NOPs, the peer sees no SACK-permitted */
+			Opts[Index] = 1;
+			Opts[Index + 1] = 1;
+		} else if (Opts[Index] == 5) {
+			D->SackSegs++;
+			if (Payload > 0) {
+				D->PiggySacks++;
+			}
+			if ((u32_t)(Opts[Index + 1] - 2) / 8 > D->MaxBlocks) {
+				D->MaxBlocks = (u32_t)(Opts[Index + 1] - 2) / 8;
+			}
+			BenchCheckSack(1 - Dir, TcpHdr, &Opts[Index + 2],
+				       (u32_t)(Opts[Index + 1] - 2) / 8);
+		}
+		Index += Opts[Index + 1];
+	}
+
+	/* Serialized on the link, then delayed */
+	Start = (D->BusyUntil > Now) ? D->BusyUntil : Now;
+	D->BusyUntil = Start + Pkt->Len * BENCH_NS_PER_BYTE;
+	Pkt->Due = D->BusyUntil + BENCH_DELAY_NS;
+
+	if (Payload > 0) {
+		Off = ntohl(TcpHdr->seqno) - (D->Iss + 1);
+		if (Off < D->SndMax) {
+			D->Rexmits++;
+			D->RexmitBytes += Payload;
+		}
+		if (Off + Payload > D->SndMax) {
+			D->SndMax = Off + Payload;
+		}
+		for (Index = 0; Index < Cfg->DropNum; Index++) {
+			if ((Dir == 0) && (Cfg->DropList[Index] == D->DataSegs)) {
+				break;
+			}
+		}
+		D->DataSegs++;
+		if ((Index < Cfg->DropNum) ||
+		    (((Dir == 0) || Cfg->Bidir) &&
+		     (BenchRand(1000000) < Cfg->LossPpm))) {
+			D->Drops++;
+			return ERR_OK;
+		}
+	}
+	D->Count++;
+
+	return ERR_OK;
+}
+
+static err_t BenchNetifInit(struct netif *NetifPtr)
+{
+	NetifPtr->output = BenchOutput;
+	NetifPtr->mtu = BENCH_MTU;
+
+	return ERR_OK;
+}
+
+/* Gives the first packet of direction Dir to the stack */
+static void BenchDeliver(u32_t Dir)
+{
+	BenchDir *D = &Dirs[Dir];
+	BenchPkt *Pkt = &D->Pkts[D->Head];
+	struct ip_hdr *IpHdr = (struct ip_hdr *)(void *)Pkt->Data;
+	struct tcp_hdr *TcpHdr;
+	struct pbuf *p;
+	u32_t Payload;
+	u32_t Off;
+
+	D->Head = (D->Head + 1) % BENCH_QUEUE;
+	D->Count--;
+
+	TcpHdr = (struct tcp_hdr *)(void *)(Pkt->Data + IPH_HL(IpHdr) * 4);
+	Payload = Pkt->Len - IPH_HL(IpHdr) * 4 - TCPH_HDRLEN(TcpHdr) * 4;
+	if (Payload > 0) {
+		Off = ntohl(TcpHdr->seqno) - (D->Iss + 1);
+		DelivDir = Dir;
+		DelivOff = Off;
+		DelivLen = Payload;
+		DelivOoseq = (Off > D->CumDelivered);
+		for (; Payload > 0; Payload--, Off++) {
+			D->Delivered[Off >> 3] |= (u8_t)(1 << (Off & 7));
+		}
+		while (BenchIsDelivered(D, D->CumDelivered)) {
+			D->CumDelivered++;
+		}
+	}
+
+	p = pbuf_alloc(PBUF_RAW, Pkt->Len, PBUF_POOL);
+	if (p == NULL) {
+		BenchFail("out of pbufs", Pkt->Len);
+	} else {
+		pbuf_take(p, Pkt->Data, Pkt->Len);
+		ip_input(p, &Netif);
+	}
+	DelivDir = -1;
+}
+
+/* Writes as much of the stream of A as the send buffer takes */
+static void BenchFill(struct tcp_pcb *Pcb)
+{
+	BenchDir *D = &Dirs[0];
+	u32_t Len;
+	u32_t Index;
+
+	while ((D->Sent < Cfg->Bytes) && (tcp_sndbuf(Pcb) > 0)) {
+		Len = Cfg->Bytes - D->Sent;
+		if (Len > tcp_sndbuf(Pcb)) {
+			Len = tcp_sndbuf(Pcb);
+		}
+		if (Len > BENCH_CHUNK) {
+			Len = BENCH_CHUNK;
+		}
+		for (Index = 0; Index < Len; Index++) {
+			Chunk[Index] = BenchPattern(0, D->Sent + Index);
+		}
+		if (tcp_write(Pcb, Chunk, (u16_t)Len,
+			      TCP_WRITE_FLAG_COPY) != ERR_OK) {
+			break;
+		}
+		D->Sent += Len;
+	}
+	tcp_output(Pcb);
+}
+
+/* B sends the next message to A */
+static void BenchMessage(void)
+{
+	BenchDir *D = &Dirs[1];
+	u32_t Len = MsgSizes[Messages % (sizeof(MsgSizes) / sizeof(MsgSizes[0]))];
+	u32_t Index;
+
+	if ((Accepted == NULL) || (tcp_sndbuf(Accepted) < Len)) {
+		return;
+	}
+	for (Index = 0; Index < Len; Index++) {
+		Chunk[Index] = BenchPattern(1, D->Sent + Index);
+	}
+	if (tcp_write(Accepted, Chunk, (u16_t)Len,
+		      TCP_WRITE_FLAG_COPY) == ERR_OK) {
+		D->Sent += Len;
+		Messages++;
+		tcp_output(Accepted);
+	}
+}
+
+/* Receive callback of both ends, the argument is the direction */
+static err_t BenchRecv(void *Arg, struct tcp_pcb *Pcb, struct pbuf *p,
+		       err_t Err)
+{
+	u32_t Dir = (u32_t)(size_t)Arg;
+	BenchDir *D = &Dirs[Dir];
+	struct pbuf *q;
+	u32_t Index;
+
+	(void)Err;
+
+	if (p == NULL) {
+		return ERR_OK;
+	}
+	for (q = p; q != NULL; q = q->next) {
+		for (Index = 0; Index < q->len; Index++) {
+			if (((u8_t *)q->payload)[Index] !=
+			    BenchPattern(Dir, D->Received + Index)) {
+				BenchFail("data mismatch", D->Received + Index);
+				break;
+			}
+		}
+		D->Received += q->len;
+	}
+	if ((Dir == 0) && (D->Received == Cfg->Bytes)) {
+		DoneTime = Now;
+	}
+	tcp_recved(Pcb, p->tot_len);
+	pbuf_free(p);
+
+	return ERR_OK;
+}
+
+static err_t BenchSent(void *Arg, struct tcp_pcb *Pcb, u16_t Len)
+{
+	(void)Arg;
+	(void)Len;
+
+	BenchFill(Pcb);
+
+	return ERR_OK;
+}
+
+static void BenchErr(void *Arg, err_t Err)
+{
+	BenchFail("connection aborted", (u32_t)(-Err));
+	if (Arg == (void *)1) {
+		Client = NULL;
+	} else {
+		Accepted = NULL;
+	}
+}
+
+static err_t BenchAccept(void *Arg, struct tcp_pcb *Pcb, err_t Err)
+{
+	(void)Arg;
+	(void)Err;
+
+	tcp_accepted(Listener);
+	Accepted = Pcb;
+	tcp_arg(Pcb, (void *)0);
+	tcp_recv(Pcb, BenchRecv);
+	tcp_err(Pcb, BenchErr);
+	tcp_nagle_disable(Pcb);
+
+	return ERR_OK;
+}
+
+static err_t BenchConnected(void *Arg, struct tcp_pcb *Pcb, err_t Err)
+{
+	(void)Arg;
+	(void)Err;
+
+	StartTime = Now;
+	BenchFill(Pcb);
+
+	return ERR_OK;
+}
+
+/* Runs one transfer, returns the throughput of A to B in Mbit/s */
+static double BenchRun(const BenchCfg *Config)
+{
+	unsigned long long Limit;
+	unsigned long long NextTmr;
+	unsigned long long NextMsg;
+	unsigned long long Next;
+	int Which;
+	u32_t Dir;
+
+	Cfg = Config;
+	Seed = 1;
+	Messages = 0;
+	DoneTime = 0;
+	memset(Dirs, 0, sizeof(Dirs));
+	memset(Delivered, 0, sizeof(Delivered));
+	for (Dir = 0; Dir < 2; Dir++) {
+		Dirs[Dir].Pkts = Pkts[Dir];
+		Dirs[Dir].Delivered = Delivered[Dir];
+	}
+
+	Listener = tcp_new();
+	tcp_bind(Listener, IP_ADDR_ANY, BENCH_PORT);
+	Listener = tcp_listen(Listener);
+	tcp_accept(Listener, BenchAccept);
+
+	Client = tcp_new();
+	tcp_arg(Client, (void *)1);
+	tcp_recv(Client, BenchRecv);
+	tcp_sent(Client, BenchSent);
+	tcp_err(Client, BenchErr);
+	tcp_connect(Client, &Netif.ip_addr, BENCH_PORT, BenchConnected);
+
+	Limit = Now + BENCH_LIMIT_NS;
+	NextTmr = Now + BENCH_TMR_NS;
+	NextMsg = Now + BENCH_MSG_NS;
+	while (Now < Limit) {
+		if ((Dirs[0].Received == Cfg->Bytes) &&
+		    (Dirs[1].Received == Dirs[1].Sent)) {
+			break;
+		}
+		Next = NextTmr;
+		Which = -1;
+		if (Cfg->Bidir && (NextMsg < Next)) {
+			Next = NextMsg;
+			Which = 2;
+		}
+		for (Dir = 0; Dir < 2; Dir++) {
+			if ((Dirs[Dir].Count > 0) &&
+			    (Dirs[Dir].Pkts[Dirs[Dir].Head].Due < Next)) {
+				Next = Dirs[Dir].Pkts[Dirs[Dir].Head].Due;
+				Which = Dir;
+			}
+		}
+		Now = Next;
+		if (Which == -1) {
+			tcp_tmr();
+			NextTmr += BENCH_TMR_NS;
+		} else if (Which == 2) {
+			/* B talks while A's stream is under way */
+			if (Dirs[0].Received < Cfg->Bytes) {
+				BenchMessage();
+			}
+			NextMsg += BENCH_MSG_NS;
+		} else {
+			BenchDeliver(Which);
+		}
+	}
+	if ((Dirs[0].Received != Cfg->Bytes) ||
+	    (Dirs[1].Received != Dirs[1].Sent)) {
+		BenchFail("transfer not complete", Dirs[0].Received);
+	}
+	if (!Cfg->Sack && (Dirs[0].SackSegs + Dirs[1].SackSegs > 0)) {
+		BenchFail("SACK blocks without SACK-permitted",
+			  Dirs[0].SackSegs + Dirs[1].SackSegs);
+	}
+
+	if (Client != NULL) {
+		tcp_err(Client, NULL);
+		tcp_abort(Client);
+		Client = NULL;
+	}
+	if (Accepted != NULL) {
+		tcp_err(Accepted, NULL);
+		tcp_abort(Accepted);
+		Accepted = NULL;
+	}
+	tcp_close(Listener);
+	Dirs[0].Count = 0;
+	Dirs[1].Count = 0;
+
+	if (DoneTime <= StartTime) {
+		return 0;
+	}
+
+	return Cfg->Bytes * 8.0 * 1000.0 / (DoneTime - StartTime);
+}
+
+int main(void)
+{
+	static const u32_t Drops[] = { 200, 203 };
+	static const u32_t LossPpm[] = { 10000, 20000 };
+	BenchCfg Config;
+	ip_addr_t Ip;
+	ip_addr_t Mask;
+	ip_addr_t Gw;
+	double Rate[2];
+	u32_t RexmitBytes[2];
+	u32_t Index;
+	u32_t Sack;
+
+	lwip_init();
+	IP4_ADDR(&Ip, 10, 0, 0, 1);
+	IP4_ADDR(&Mask, 255, 0, 0, 0);
+	IP4_ADDR(&Gw, 0, 0, 0, 0);
+	netif_add(&Netif, &Ip, &Mask, &Gw, NULL, BenchNetifInit, ip_input);
+	netif_set_default(&Netif);
+	netif_set_up(&Netif);
+
+	printf("20 Mbit/s, %u ms one way, TCP_WND %u, MSS %u\n\n",
+	       (u32_t)(BENCH_DELAY_NS / 1000000), (u32_t)TCP_WND, TCP_MSS);
+
+	/* Two holes in one window, each repaired by one retransmission */
+	memset(&Config, 0, sizeof(Config));
+	Config.Bytes = 4 * 1024 * 1024;
+	Config.DropList = Drops;
+	Config.DropNum = sizeof(Drops) / sizeof(Drops[0]);
+	Config.Sack = 1;
+	Rate[0] = BenchRun(&Config);
+	printf("segments %u and %u dropped: %u retransmitted, "
+	       "up to %u SACK blocks, %.1f Mbit/s\n", Drops[0], Drops[1],
+	       Dirs[0].Rexmits, Dirs[1].MaxBlocks, Rate[0]);
+	if (Dirs[0].Rexmits != Config.DropNum) {
+		BenchFail("retransmissions", Dirs[0].Rexmits);
+	}
+	if (Dirs[1].MaxBlocks < 2) {
+		BenchFail("SACK blocks", Dirs[1].MaxBlocks);
+	}
+
+	/* Random loss with and without SACK */
+	printf("\n%6s %14s %14s %14s %14s\n", "loss", "SACK Mbit/s",
+	       "Mbit/s", "SACK rexmit KB", "rexmit KB");
+	for (Index = 0; Index < sizeof(LossPpm) / sizeof(LossPpm[0]);
+	     Index++) {
+		for (Sack = 0; Sack < 2; Sack++) {
+			memset(&Config, 0, sizeof(Config));
+			Config.Bytes = BENCH_MAX_BYTES;
+			Config.LossPpm = LossPpm[Index];
+			Config.Sack = (u8_t)(1 - Sack);
+			Rate[Sack] = BenchRun(&Config);
+			RexmitBytes[Sack] = Dirs[0].RexmitBytes;
+			if (Config.Sack && (Dirs[1].SackSegs == 0)) {
+				BenchFail("no SACK blocks", LossPpm[Index]);
+			}
+		}
+		printf("%5.1f%% %14.2f %14.2f %14u %14u\n",
+		       LossPpm[Index] / 10000.0, Rate[0], Rate[1],
+		       RexmitBytes[0] / 1024, RexmitBytes[1] / 1024);
+		if (Rate[0] <= Rate[1]) {
+			BenchFail("SACK not faster", LossPpm[Index]);
+		}
+	}
+
+	/* Both directions, B's data carries SACK blocks where they fit */
+	memset(&Config, 0, sizeof(Config));
+	Config.Bytes = 4 * 1024 * 1024;
+	Config.LossPpm = 10000;
+	Config.Sack = 1;
+	Config.Bidir = 1;
+	Rate[0] = BenchRun(&Config);
+	printf("\nboth directions, 1%% loss: %.1f Mbit/s, %u messages, "
+	       "%u of %u SACKs on data\n", Rate[0], Messages,
+	       Dirs[1].PiggySacks, Dirs[1].SackSegs);
+	if (Dirs[1].PiggySacks == 0) {
+		BenchFail("no SACK blocks on data", Dirs[1].SackSegs);
+	}
+
+	printf("\n%s\n", (Failed == 0) ? "all checks passed" :
+	       "CHECKS FAILED");
+
+	return (Failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,501 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file tcpip_echo_bench.c
+*
+* Small-message echo benchmark of the tcpip thread of lwIP, built once with
+* the default options and once each with TCPIP_MBOX_BATCH,
+* TCPIP_INPKT_BATCH_MAX and LWIP_TCPIP_CORE_LOCKING.
+*
+* The stack runs in its tcpip thread on the POSIX threads of the sys_arch.c
+* stand-in, with the echo server of freertos_lwip_echo_server: a thread
+* accepts connections on port 7 and starts a thread per connection that
+* writes back what it reads with the socket API. The main thread is the
+* client. It passes TCP segments to the stack the way the receive path of
+* an ethernet adapter does, with tcpip_input() or, when the stack has it,
+* with tcpip_input_batch(), and takes the echoed segments from the output
+* function of the network interface.
+*
+* The client opens 8 connections. In each round it sends a 64 byte message
+* on 1 or on all 8 connections, as one burst, and waits for all of them to
+* be echoed, checking the data; the next message acknowledges the echo.
+* For each case the benchmark reports the echoes per second, the mailbox
+* posts and semaphore signals per echo (each one a queue operation on
+* FreeRTOS), the waits that had to block (a task switch on FreeRTOS) and
+* the mutexes taken per echo: the heap mutex of mem.c and, with core
+* locking, the core lock.
+*
+* Usage: tcpip_echo_bench [echoes per measurement]
+*
+* The default is 40000.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- ---------------------------------------------------
+* 1.0        10/18/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "lwip/init.h"
+#include "lwip/ip.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/sockets.h"
+#include "lwip/sys.h"
+#include "lwip/tcp_impl.h"
+#include "lwip/tcpip.h"
+
+/************************** Constant Definitions *****************************/
+
+#define BENCH_PORT		7
+#define BENCH_CLIENT_PORT	40000
+#define BENCH_CLIENT_ISS	1000
+#define BENCH_CONNS		8
+#define BENCH_MSG_LEN		64
+#define BENCH_WARMUP		200	/* rounds */
+#define BENCH_QUEUE		256	/* output segments */
+#define BENCH_TIMEOUT_S		5
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32_t Seq;		/* Next sequence number of the client */
+	u32_t Ack;		/* Next one expected from the server */
+	u32_t Echoed;		/* Bytes echoed in this round */
+} BenchConn;
+
+/* TCP segment sent by the stack */
+typedef struct {
+	u16_t Port;		/* Client port */
+	u8_t Flags;
+	u32_t Seq;
+	u16_t Len;
+	u8_t Data[BENCH_MSG_LEN];
+} BenchSeg;
+
+/************************** Variable Definitions *****************************/
+
+static struct netif Netif;
+static BenchConn Conns[BENCH_CONNS];
+static sys_sem_t Ready;
+
+static pthread_mutex_t OutLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t OutCond = PTHREAD_COND_INITIALIZER;
+static BenchSeg OutQueue[BENCH_QUEUE];
+static u32_t OutHead;
+static u32_t OutCount;
+
+static u32_t Failed;
+
+/************************** Function Definitions *****************************/
+
+static double BenchNow(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+
+	return (Ts.tv_sec * 1e9) + Ts.tv_nsec;
+}
+
+static void BenchFail(const char *What, u32_t Value)
+{
+	if (Failed < 10) {
+		printf("  FAIL: %s (%u)\n", What, Value);
+	}
+	Failed++;
+}
+
+static u8_t BenchPattern(u32_t Round, u32_t Conn, u32_t Index)
+{
+	return (u8_t)(Round * 31 + Conn * 7 + Index);
+}
+
+/*
+ * Output of the network interface, the packet starts with the IP header.
+ * Called by the tcpip thread, or with core locking by the thread that
+ * holds the core lock.
+ */
+static err_t BenchOutput(struct netif *NetifPtr, struct pbuf *p,
+			 ip_addr_t *IpAddr)
+{
+	u8_t Packet[IP_HLEN + TCP_HLEN + 40 + BENCH_MSG_LEN];
+	struct ip_hdr *IpHdr = (struct ip_hdr *)(void *)Packet;
+	struct tcp_hdr *TcpHdr;
+	BenchSeg *Seg;
+	u16_t Len;
+
+	(void)NetifPtr;
+	(void)IpAddr;
+
+	Len = pbuf_copy_partial(p, Packet, sizeof(Packet), 0);
+	if ((Len < IP_HLEN + TCP_HLEN) || (IPH_PROTO(IpHdr) != IP_PROTO_TCP)) {
+		return ERR_OK;
+	}
+	TcpHdr = (struct tcp_hdr *)(void *)(Packet + IPH_HL(IpHdr) * 4);
+
+	pthread_mutex_lock(&OutLock);
+	if (OutCount == BENCH_QUEUE) {
+		BenchFail("output queue full", OutCount);
+	} else {
+		Seg = &OutQueue[(OutHead + OutCount) % BENCH_QUEUE];
+		Seg->Port = ntohs(TcpHdr->dest);
+		Seg->Flags = TCPH_FLAGS(TcpHdr);
+		Seg->Seq = ntohl(TcpHdr->seqno);
+		Seg->Len = p->tot_len - IPH_HL(IpHdr) * 4 -
+			TCPH_HDRLEN(TcpHdr) * 4;
+		if (Seg->Len > BENCH_MSG_LEN) {
+			BenchFail("echo too long", Seg->Len);
+			Seg->Len = BENCH_MSG_LEN;
+		}
+		memcpy(Seg->Data, (u8_t *)TcpHdr + TCPH_HDRLEN(TcpHdr) * 4,
+		       Seg->Len);
+		OutCount++;
+		pthread_cond_signal(&OutCond);
+	}
+	pthread_mutex_unlock(&OutLock);
+
+	return ERR_OK;
+}
+
+static err_t BenchNetifInit(struct netif *NetifPtr)
+{
+	NetifPtr->output = BenchOutput;
+	NetifPtr->mtu = 1500;
+
+	return ERR_OK;
+}
+
+/* Takes the next segment sent by the stack, 0 if none comes */
+static int BenchNextSeg(BenchSeg *Seg)
+{
+	struct timespec Ts;
+	int Status = 1;
+
+	clock_gettime(CLOCK_REALTIME, &Ts);
+	Ts.tv_sec += BENCH_TIMEOUT_S;
+
+	pthread_mutex_lock(&OutLock);
+	while ((OutCount == 0) && (Status != 0)) {
+		if (pthread_cond_timedwait(&OutCond, &OutLock, &Ts) != 0) {
+			Status = 0;
+		}
+	}
+	if (OutCount > 0) {
+		*Seg = OutQueue[OutHead];
+		OutHead = (OutHead + 1) % BENCH_QUEUE;
+		OutCount--;
+		Status = 1;
+	}
+	pthread_mutex_unlock(&OutLock);
+
+	return Status;
+}
+
+/* Builds a segment of connection Conn carrying Len bytes of Data */
+static struct pbuf *BenchSegment(u32_t Conn, u8_t Flags, const u8_t *Data,
+				 u16_t Len)
+{
+	struct pbuf *p;
+	struct ip_hdr *IpHdr;
+	struct tcp_hdr *TcpHdr;
+
+	p = pbuf_alloc(PBUF_RAW, IP_HLEN + TCP_HLEN + Len, PBUF_POOL);
+	if (p == NULL) {
+		BenchFail("out of pbufs", Conn);
+		return NULL;
+	}
+	IpHdr = (struct ip_hdr *)p->payload;
+	memset(IpHdr, 0, IP_HLEN + TCP_HLEN);
+	IPH_VHL_SET(IpHdr, 4, IP_HLEN / 4);
+	IPH_LEN_SET(IpHdr, htons(IP_HLEN + TCP_HLEN + Len));
+	IPH_TTL_SET(IpHdr, 64);
+	IPH_PROTO_SET(IpHdr, IP_PROTO_TCP);
+	IP4_ADDR(&IpHdr->src, 10, 0, 0, 2);
+	IpHdr->dest.addr = Netif.ip_addr.addr;
+
+	TcpHdr = (struct tcp_hdr *)((u8_t *)p->payload + IP_HLEN);
+	TcpHdr->src = htons(BENCH_CLIENT_PORT + Conn);
+	TcpHdr->dest = htons(BENCH_PORT);
+	TcpHdr->seqno = htonl(Conns[Conn].Seq);
+	TcpHdr->ackno = htonl(Conns[Conn].Ack);
+	TCPH_HDRLEN_FLAGS_SET(TcpHdr, TCP_HLEN / 4, Flags);
+	TcpHdr->wnd = htons(TCP_WND);
+	memcpy((u8_t *)TcpHdr + TCP_HLEN, Data, Len);
+
+	return p;
+}
+
+/* Passes segments to the stack as the receive path of an adapter does */
+static void BenchInput(struct pbuf **p, u32_t Num)
+{
+	u32_t Index;
+
+#if TCPIP_INPKT_BATCH_MAX
+	u32_t Count;
+
+	for (Index = 0; Index < Num; Index += Count) {
+		Count = Num - Index;
+		if (Count > TCPIP_INPKT_BATCH_MAX) {
+			Count = TCPIP_INPKT_BATCH_MAX;
+		}
+		if (tcpip_input_batch(&p[Index], (u16_t)Count,
+				      &Netif) != ERR_OK) {
+			BenchFail("tcpip_input_batch", Index);
+		}
+	}
+#else
+	for (Index = 0; Index < Num; Index++) {
+		if (tcpip_input(p[Index], &Netif) != ERR_OK) {
+			BenchFail("tcpip_input", Index);
+			pbuf_free(p[Index]);
+		}
+	}
+#endif
+}
+
+/* Thread per connection, as process_echo_request() of echo.c */
+static void BenchEchoThread(void *Arg)
+{
+	int Sd = (int)(size_t)Arg;
+	char Buf[2048];
+	int Len;
+
+	while ((Len = lwip_read(Sd, Buf, sizeof(Buf))) > 0) {
+		if (lwip_write(Sd, Buf, Len) < 0) {
+			break;
+		}
+	}
+	lwip_close(Sd);
+}
+
+/* Listening thread, as echo_application_thread() of echo.c */
+static void BenchServerThread(void *Arg)
+{
+	struct sockaddr_in Address;
+	struct sockaddr_in Remote;
+	socklen_t Size;
+	int Sock;
+	int Sd;
+
+	(void)Arg;
+
+	Sock = lwip_socket(AF_INET, SOCK_STREAM, 0);
+	memset(&Address, 0, sizeof(Address));
+	Address.sin_family = AF_INET;
+	Address.sin_port = htons(BENCH_PORT);
+	Address.sin_addr.s_addr = INADDR_ANY;
+	if ((Sock < 0) ||
+	    (lwip_bind(Sock, (struct sockaddr *)&Address, sizeof(Address)) < 0) ||
+	    (lwip_listen(Sock, BENCH_CONNS) < 0)) {
+		BenchFail("echo server socket", 0);
+	}
+	sys_sem_signal(&Ready);
+
+	while (1) {
+		Size = sizeof(Remote);
+		Sd = lwip_accept(Sock, (struct sockaddr *)&Remote, &Size);
+		if (Sd >= 0) {
+			sys_thread_new("echos", BenchEchoThread,
+				       (void *)(size_t)Sd, 4096,
+				       DEFAULT_THREAD_PRIO);
+		}
+	}
+}
+
+/* Three-way handshake of connection Conn */
+static void BenchConnect(u32_t Conn)
+{
+	struct pbuf *p;
+	BenchSeg Seg;
+
+	Conns[Conn].Seq = BENCH_CLIENT_ISS;
+	Conns[Conn].Ack = 0;
+	p = BenchSegment(Conn, TCP_SYN, NULL, 0);
+	if (p == NULL) {
+		return;
+	}
+	BenchInput(&p, 1);
+	if (!BenchNextSeg(&Seg) || (Seg.Port != BENCH_CLIENT_PORT + Conn) ||
+	    (Seg.Flags != (TCP_SYN | TCP_ACK))) {
+		BenchFail("no SYN-ACK", Conn);
+		return;
+	}
+	Conns[Conn].Seq++;
+	Conns[Conn].Ack = Seg.Seq + 1;
+	p = BenchSegment(Conn, TCP_ACK, NULL, 0);
+	if (p != NULL) {
+		BenchInput(&p, 1);
+	}
+}
+
+/* One message on each of the first Num connections, waits for the echoes */
+static void BenchRound(u32_t Round, u32_t Num)
+{
+	struct pbuf *p[BENCH_CONNS];
+	u8_t Msg[BENCH_MSG_LEN];
+	BenchSeg Seg;
+	BenchConn *Conn;
+	u32_t Pending = Num;
+	u32_t Index;
+	u32_t Byte;
+
+	for (Index = 0; Index < Num; Index++) {
+		for (Byte = 0; Byte < BENCH_MSG_LEN; Byte++) {
+			Msg[Byte] = BenchPattern(Round, Index, Byte);
+		}
+		p[Index] = BenchSegment(Index, TCP_ACK | TCP_PSH, Msg,
+					BENCH_MSG_LEN);
+		if (p[Index] == NULL) {
+			return;
+		}
+		Conns[Index].Seq += BENCH_MSG_LEN;
+		Conns[Index].Echoed = 0;
+	}
+	BenchInput(p, Num);
+
+	while (Pending > 0) {
+		if (!BenchNextSeg(&Seg)) {
+			BenchFail("echo missing", Round);
+			exit(1);
+		}
+		Index = Seg.Port - BENCH_CLIENT_PORT;
+		if ((Seg.Len == 0) || (Index >= Num)) {
+			continue;
+		}
+		Conn = &Conns[Index];
+		if ((Seg.Seq != Conn->Ack) ||
+		    (Conn->Echoed + Seg.Len > BENCH_MSG_LEN)) {
+			BenchFail("echo out of sequence", Seg.Seq);
+			continue;
+		}
+		for (Byte = 0; Byte < Seg.Len; Byte++) {
+			if (Seg.Data[Byte] != BenchPattern(Round, Index,
+					Conn->Echoed + Byte)) {
+				BenchFail("echo data", Round);
+				break;
+			}
+		}
+		Conn->Ack += Seg.Len;
+		Conn->Echoed += Seg.Len;
+		if (Conn->Echoed == BENCH_MSG_LEN) {
+			Pending--;
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	static const u32_t Nums[] = { 1, BENCH_CONNS };
+	SysArchStats Start;
+	ip_addr_t Ip;
+	ip_addr_t Mask;
+	ip_addr_t Gw;
+	u32_t Echoes = 40000;
+	u32_t Rounds;
+	u32_t Round = 0;
+	u32_t Index;
+	u32_t Last;
+	double Ns;
+
+	if (argc > 1) {
+		Echoes = (u32_t)strtoul(argv[1], NULL, 0);
+	}
+
+	/* lwip_init() of the Xilinx port starts the tcpip thread, and the
+	   network interface is added next, as in main.c of the echo server */
+	lwip_init();
+	IP4_ADDR(&Ip, 10, 0, 0, 1);
+	IP4_ADDR(&Mask, 255, 0, 0, 0);
+	IP4_ADDR(&Gw, 0, 0, 0, 0);
+	netif_add(&Netif, &Ip, &Mask, &Gw, NULL, BenchNetifInit, tcpip_input);
+	netif_set_default(&Netif);
+	netif_set_up(&Netif);
+
+	sys_sem_new(&Ready, 0);
+	sys_thread_new("echo", BenchServerThread, NULL, 4096,
+		       DEFAULT_THREAD_PRIO);
+	sys_sem_wait(&Ready);
+	for (Index = 0; Index < BENCH_CONNS; Index++) {
+		BenchConnect(Index);
+	}
+	if (Failed != 0) {
+		printf("\nCHECKS FAILED\n");
+		return 1;
+	}
+
+	printf("TCPIP_MBOX_BATCH %d, TCPIP_INPKT_BATCH_MAX %d, "
+	       "LWIP_TCPIP_CORE_LOCKING %d\n\n", TCPIP_MBOX_BATCH,
+	       TCPIP_INPKT_BATCH_MAX, LWIP_TCPIP_CORE_LOCKING);
+	printf("%11s %10s %10s %10s %10s %10s\n", "connections", "echoes/s",
+	       "us/round", "posts/echo", "waits/echo", "locks/echo");
+
+	for (Index = 0; Index < sizeof(Nums) / sizeof(Nums[0]); Index++) {
+		for (Last = Round + BENCH_WARMUP; Round < Last; Round++) {
+			BenchRound(Round, Nums[Index]);
+		}
+		Rounds = Echoes / Nums[Index];
+		Start = SysStats;
+		Ns = BenchNow();
+		for (Last = Round + Rounds; Round < Last; Round++) {
+			BenchRound(Round, Nums[Index]);
+		}
+		Ns = BenchNow() - Ns;
+		printf("%11u %10.0f %10.2f %10.2f %10.2f %10.2f\n",
+		       Nums[Index], Rounds * Nums[Index] * 1e9 / Ns,
+		       Ns / 1000 / Rounds,
+		       (double)(SysStats.MboxPosts - Start.MboxPosts +
+				SysStats.SemSignals - Start.SemSignals) /
+		       (Rounds * Nums[Index]),
+		       (double)(SysStats.Blocks - Start.Blocks) /
+		       (Rounds * Nums[Index]),
+		       (double)(SysStats.MutexLocks - Start.MutexLocks) /
+		       (Rounds * Nums[Index]));
+	}
+
+	printf("\n%s\n", (Failed == 0) ? "all checks passed" :
+	       "CHECKS FAILED");
+
+	return (Failed == 0) ? 0 : 1;
+}
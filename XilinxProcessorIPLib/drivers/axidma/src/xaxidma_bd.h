@@ -145,12 +145,17 @@ typedef UINTPTR XAxiDma_Bd[XAXIDMA_BD_NUM_WORDS];
 #ifdef __aarch64__
 #define XAXIDMA_CACHE_FLUSH(BdPtr)
 #define XAXIDMA_CACHE_INVALIDATE(BdPtr)
+#define XAXIDMA_CACHE_FLUSH_RANGE(Addr, Len)	((void)(Addr), (void)(Len))
 #else
 #define XAXIDMA_CACHE_FLUSH(BdPtr) \
 	Xil_DCacheFlushRange((UINTPTR)(BdPtr), XAXIDMA_BD_HW_NUM_BYTES)
 
 #define XAXIDMA_CACHE_INVALIDATE(BdPtr) \
 	Xil_DCacheInvalidateRange((UINTPTR)(BdPtr), XAXIDMA_BD_HW_NUM_BYTES)
+
+/* Flush a run of adjacent BDs with a single cache maintenance call */
+#define XAXIDMA_CACHE_FLUSH_RANGE(Addr, Len) \
+	Xil_DCacheFlushRange((UINTPTR)(Addr), (Len))
 #endif
 
 /*****************************************************************************/
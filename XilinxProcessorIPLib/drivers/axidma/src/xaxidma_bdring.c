@@ -164,6 +164,33 @@
         (BdPtr) = (XAxiDma_Bd*)Addr;                                  \
     }
 
+/******************************************************************************
+ * Flush a set of adjacent BDs starting at BdSetPtr, splitting the range in two
+ * if it wraps around the end of the ring.
+ *
+ * @param	RingPtr is the BD ring the set belongs to.
+ * @param	BdSetPtr is the first BD of the set.
+ * @param	NumBd is the number of BDs in the set.
+ *
+ * @returns	None
+ *
+ *****************************************************************************/
+#define XAXIDMA_RING_FLUSH_SET(RingPtr, BdSetPtr, NumBd)		    \
+    {                                                                       \
+        UINTPTR Start = (UINTPTR)(void *)(BdSetPtr);                        \
+        UINTPTR End = (RingPtr)->LastBdAddr + (RingPtr)->Separation;        \
+        UINTPTR Bytes = (RingPtr)->Separation * (UINTPTR)(NumBd);           \
+                                                                            \
+        if ((Start + Bytes) > End) {                                        \
+            XAXIDMA_CACHE_FLUSH_RANGE(Start, End - Start);                  \
+            XAXIDMA_CACHE_FLUSH_RANGE((RingPtr)->FirstBdAddr,               \
+                                      Bytes - (End - Start));               \
+        }                                                                   \
+        else {                                                              \
+            XAXIDMA_CACHE_FLUSH_RANGE(Start, Bytes);                        \
+        }                                                                   \
+    }
+
 /************************** Function Prototypes ******************************/
 
 /************************** Variable Definitions *****************************/
@@ -1068,9 +1095,6 @@ int XAxiDma_BdRingToHw(XAxiDma_BdRing * RingPtr, int NumBd,
 		BdSts &=  ~XAXIDMA_BD_STS_COMPLETE_MASK;
 		XAxiDma_BdWrite(CurBdPtr, XAXIDMA_BD_STS_OFFSET, BdSts);
 
-		/* Flush the current BD so DMA core could see the updates */
-		XAXIDMA_CACHE_FLUSH(CurBdPtr);
-
 		CurBdPtr = (XAxiDma_Bd *)((void *)XAxiDma_BdRingNext(RingPtr, CurBdPtr));
 		BdCr = XAxiDma_BdRead(CurBdPtr, XAXIDMA_BD_CTRL_LEN_OFFSET);
 		BdSts = XAxiDma_BdRead(CurBdPtr, XAXIDMA_BD_STS_OFFSET);
@@ -1099,8 +1123,12 @@ int XAxiDma_BdRingToHw(XAxiDma_BdRing * RingPtr, int NumBd,
 	BdSts &= ~XAXIDMA_BD_STS_COMPLETE_MASK;
 	XAxiDma_BdWrite(CurBdPtr, XAXIDMA_BD_STS_OFFSET, BdSts);
 
-	/* Flush the last BD so DMA core could see the updates */
-	XAXIDMA_CACHE_FLUSH(CurBdPtr);
+	/* Flush the whole set so DMA core could see the updates. The BDs
+	 * are adjacent in memory, so this takes one cache maintenance call,
+	 * or two if the set wraps around the end of the ring, instead of one
+	 * per BD.
+	 */
+	XAXIDMA_RING_FLUSH_SET(RingPtr, BdSetPtr, NumBd);
 	DATA_SYNC;
 
 	/* This set has completed pre-processing, adjust ring pointers and
@@ -0,0 +1,253 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxidma_coalesce.c
+* @addtogroup axidma_v9_0
+* @{
+*
+* This file implements the adaptive interrupt coalescing controller. See
+* xaxidma_coalesce.h for a description of how it is used.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 9.3        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xaxidma_coalesce.h"
+
+/************************** Constant Definitions *****************************/
+
+#define XAXIDMA_COALESCE_US_PER_SEC	1000000U
+
+/**************************** Type Definitions *******************************/
+
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+
+/************************** Function Prototypes ******************************/
+
+static int XAxiDma_CoalesceApply(XAxiDma_Coalesce *CoalPtr);
+
+/************************** Variable Definitions *****************************/
+
+
+/*****************************************************************************/
+/**
+* Initialize a coalescing controller and program the ring for a completion
+* rate of zero, that is the lowest packet threshold.
+*
+* @param	CoalPtr is the controller to initialize.
+* @param	RingPtr is the BD ring to control. The ring must have been
+*		created with XAxiDma_BdRingCreate().
+* @param	CfgPtr holds the targets and limits. It is copied.
+*
+* @return
+*		- XST_SUCCESS if the controller was initialized.
+*		- XST_INVALID_PARAM if neither target is set, the delay timer
+*		  unit is 0 or the packet threshold limits are out of range.
+*		- XST_FAILURE if the ring rejected the coalescing settings.
+*
+* @note		None.
+*
+******************************************************************************/
+int XAxiDma_CoalesceInitialize(XAxiDma_Coalesce *CoalPtr,
+		XAxiDma_BdRing *RingPtr, const XAxiDma_CoalesceConfig *CfgPtr)
+{
+	Xil_AssertNonvoid(CoalPtr != NULL);
+	Xil_AssertNonvoid(RingPtr != NULL);
+	Xil_AssertNonvoid(CfgPtr != NULL);
+
+	if (((CfgPtr->TargetLatencyUs == 0U) &&
+			(CfgPtr->TargetIrqRate == 0U)) ||
+			(CfgPtr->TimerPeriodNs == 0U) ||
+			(CfgPtr->MinCounter == 0U) ||
+			(CfgPtr->MinCounter > CfgPtr->MaxCounter)) {
+		xdbg_printf(XDBG_DEBUG_ERROR, "CoalesceInitialize: "
+				"invalid configuration\r\n");
+
+		return XST_INVALID_PARAM;
+	}
+
+	memset(CoalPtr, 0, sizeof(XAxiDma_Coalesce));
+	CoalPtr->RingPtr = RingPtr;
+	CoalPtr->Config = *CfgPtr;
+
+	return XAxiDma_CoalesceApply(CoalPtr);
+}
+
+/*****************************************************************************/
+/**
+* Take a sample of the completion rate of the ring and retune its packet
+* threshold and delay timer. The ring registers are only written when a value
+* changes.
+*
+* @param	CoalPtr is the controller to operate on.
+* @param	ElapsedUs is the time since the previous call, or since
+*		XAxiDma_CoalesceInitialize() for the first call.
+*
+* @return
+*		- XST_SUCCESS if the sample was taken.
+*		- XST_INVALID_PARAM if ElapsedUs is 0.
+*		- XST_FAILURE if the ring rejected the coalescing settings.
+*
+* @note		Must not run concurrently with itself. It may preempt, or be
+*		preempted by, XAxiDma_CoalesceIntr().
+*
+******************************************************************************/
+int XAxiDma_CoalesceSample(XAxiDma_Coalesce *CoalPtr, u32 ElapsedUs)
+{
+	u32 BdCount;
+	u32 IrqCount;
+	u32 Rate;
+
+	Xil_AssertNonvoid(CoalPtr != NULL);
+
+	if (ElapsedUs == 0U) {
+		return XST_INVALID_PARAM;
+	}
+
+	BdCount = CoalPtr->BdCount;
+	IrqCount = CoalPtr->IrqCount;
+
+	Rate = (u32)(((u64)(BdCount - CoalPtr->LastBdCount) *
+			XAXIDMA_COALESCE_US_PER_SEC) / ElapsedUs);
+	CoalPtr->IrqRate = (u32)(((u64)(IrqCount - CoalPtr->LastIrqCount) *
+			XAXIDMA_COALESCE_US_PER_SEC) / ElapsedUs);
+
+	CoalPtr->LastBdCount = BdCount;
+	CoalPtr->LastIrqCount = IrqCount;
+
+	/* Follow a burst at once so the interrupt rate stays bounded, and
+	 * back off gradually. The delay timer bounds the latency while the
+	 * threshold is still too high for the traffic.
+	 */
+	if (Rate >= CoalPtr->BdRate) {
+		CoalPtr->BdRate = Rate;
+	}
+	else {
+		CoalPtr->BdRate -= (CoalPtr->BdRate - Rate +
+				((1U << XAXIDMA_COALESCE_DECAY_SHIFT) - 1U)) >>
+				XAXIDMA_COALESCE_DECAY_SHIFT;
+	}
+
+	return XAxiDma_CoalesceApply(CoalPtr);
+}
+
+/*****************************************************************************/
+/**
+* Derive the packet threshold and delay timer from the averaged completion
+* rate and program them if they changed.
+*
+* The threshold is the number of BDs that complete within the target latency
+* and/or the number that complete per target interrupt period. With both
+* targets the lower threshold is used, so the latency target takes precedence
+* over the interrupt rate. The delay timer is set to the shorter of the two
+* periods, so a lone BD never waits longer than that.
+*
+* @param	CoalPtr is the controller to operate on.
+*
+* @return	XST_SUCCESS, or XST_FAILURE if the ring rejected the settings.
+*
+* @note		None.
+*
+******************************************************************************/
+static int XAxiDma_CoalesceApply(XAxiDma_Coalesce *CoalPtr)
+{
+	XAxiDma_CoalesceConfig *CfgPtr = &CoalPtr->Config;
+	u32 Counter = CfgPtr->MaxCounter;
+	u32 WaitUs = CfgPtr->TargetLatencyUs;
+	u32 Timer;
+	u32 Value;
+	int Status;
+
+	if (CfgPtr->TargetIrqRate != 0U) {
+		Counter = (CoalPtr->BdRate + CfgPtr->TargetIrqRate - 1U) /
+				CfgPtr->TargetIrqRate;
+
+		Value = XAXIDMA_COALESCE_US_PER_SEC / CfgPtr->TargetIrqRate;
+		if ((WaitUs == 0U) || (Value < WaitUs)) {
+			WaitUs = Value;
+		}
+	}
+
+	if (CfgPtr->TargetLatencyUs != 0U) {
+		Value = (u32)(((u64)CoalPtr->BdRate * CfgPtr->TargetLatencyUs) /
+				XAXIDMA_COALESCE_US_PER_SEC);
+		if (Value < Counter) {
+			Counter = Value;
+		}
+	}
+
+	if (Counter < CfgPtr->MinCounter) {
+		Counter = CfgPtr->MinCounter;
+	}
+	else if (Counter > CfgPtr->MaxCounter) {
+		Counter = CfgPtr->MaxCounter;
+	}
+
+	/* A timer of 0 disables it, which would strand BDs below the
+	 * threshold, so round short waits up to one unit.
+	 */
+	Timer = (u32)(((u64)WaitUs * 1000U) / CfgPtr->TimerPeriodNs);
+	if (Timer == 0U) {
+		Timer = 1U;
+	}
+	else if (Timer > XAXIDMA_COALESCE_MAX) {
+		Timer = XAXIDMA_COALESCE_MAX;
+	}
+
+	if ((Counter == CoalPtr->Counter) && (Timer == CoalPtr->Timer)) {
+		return XST_SUCCESS;
+	}
+
+	Status = XAxiDma_BdRingSetCoalesce(CoalPtr->RingPtr, Counter, Timer);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	CoalPtr->Counter = Counter;
+	CoalPtr->Timer = Timer;
+
+	return XST_SUCCESS;
+}
+/** @} */
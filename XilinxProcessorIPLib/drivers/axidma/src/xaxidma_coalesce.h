@@ -0,0 +1,229 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxidma_coalesce.h
+* @addtogroup axidma_v9_0
+* @{
+*
+* This file contains an adaptive interrupt coalescing controller for the BD
+* rings of the AXI DMA driver in SG mode.
+*
+* XAxiDma_BdRingSetCoalesce() programs a fixed packet threshold and delay
+* timer. A fixed setting is a trade off: a high threshold adds up to one
+* delay timer period of latency when traffic is light, a low threshold costs
+* one interrupt per few packets when it is heavy. The controller measures the
+* completion rate of a ring and reprograms both values so that
+*
+*	- no completed BD waits longer than a target latency for its
+*	  interrupt, and/or
+*	- the ring raises about a target number of interrupts per second.
+*
+* When both targets are set the latency target wins: the lower of the two
+* packet thresholds and the shorter of the two delay timer periods are
+* programmed, so the latency bound holds and the interrupt rate may exceed its
+* target.
+*
+* The controller has no time base of its own. The interrupt handler of the
+* ring reports every batch of reclaimed BDs with XAxiDma_CoalesceIntr(), and a
+* periodic context (a timer tick, a housekeeping thread) calls
+* XAxiDma_CoalesceSample() with the time elapsed since the previous call.
+* Sampling every 10 to 250 ms works well. The two functions may run in
+* different contexts without locking.
+*
+* XAxiDma_Reset() puts the packet threshold and delay timer of both channels
+* back to their defaults. Call XAxiDma_CoalesceInvalidate() for the rings of
+* a reset DMA so that the next sample programs them again.
+*
+* The delay timer of the DMA counts in units of 125 SG clock cycles, so the
+* controller has to be told the SG clock, see XAXIDMA_COALESCE_TIMER_NS().
+*
+* Typical use:
+* <pre>
+*	XAxiDma_CoalesceConfig Cfg = {
+*		.TargetLatencyUs = 50,
+*		.TargetIrqRate = 0,
+*		.TimerPeriodNs = XAXIDMA_COALESCE_TIMER_NS(100000000),
+*		.MinCounter = 1,
+*		.MaxCounter = 64,
+*	};
+*
+*	XAxiDma_CoalesceInitialize(&RxCoal, RxRingPtr, &Cfg);
+*
+*	// In the RX interrupt handler
+*	NumBd = XAxiDma_BdRingFromHw(RxRingPtr, XAXIDMA_ALL_BDS, &BdPtr);
+*	XAxiDma_CoalesceIntr(&RxCoal, NumBd);
+*
+*	// Every 100 ms
+*	XAxiDma_CoalesceSample(&RxCoal, 100000);
+* </pre>
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 9.3        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+#ifndef XAXIDMA_COALESCE_H_	/* prevent circular inclusions */
+#define XAXIDMA_COALESCE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xaxidma_bdring.h"
+
+/************************** Constant Definitions *****************************/
+
+/** Largest packet threshold and delay timer value the hardware accepts */
+#define XAXIDMA_COALESCE_MAX		0xFFU
+
+/**
+ * Weight of the newest sample in the averaged completion rate, as a shift.
+ * A rising rate is taken over at once; a falling one decays by 1/4 of the
+ * difference per sample.
+ */
+#define XAXIDMA_COALESCE_DECAY_SHIFT	2U
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Targets and limits of a coalescing controller.
+ */
+typedef struct {
+	u32 TargetLatencyUs;	/**< Longest wait of a completed BD for its
+				  *  interrupt, 0 for no latency target */
+	u32 TargetIrqRate;	/**< Interrupts per second to aim for, 0 for
+				  *  no interrupt rate target */
+	u32 TimerPeriodNs;	/**< Length of one delay timer unit */
+	u8 MinCounter;		/**< Lowest packet threshold to program */
+	u8 MaxCounter;		/**< Highest packet threshold to program */
+} XAxiDma_CoalesceConfig;
+
+/**
+ * Coalescing controller for one BD ring.
+ */
+typedef struct {
+	XAxiDma_BdRing *RingPtr;	/**< Ring being controlled */
+	XAxiDma_CoalesceConfig Config;	/**< Targets and limits */
+	volatile u32 BdCount;		/**< BDs reported, written by
+					  *  XAxiDma_CoalesceIntr() only */
+	volatile u32 IrqCount;		/**< Interrupts reported, written by
+					  *  XAxiDma_CoalesceIntr() only */
+	u32 LastBdCount;		/**< BdCount at the previous sample */
+	u32 LastIrqCount;		/**< IrqCount at the previous sample */
+	u32 BdRate;			/**< Averaged BDs per second */
+	u32 IrqRate;			/**< Interrupts per second over the last
+					  *  sample period */
+	u32 Counter;			/**< Packet threshold programmed */
+	u32 Timer;			/**< Delay timer value programmed */
+} XAxiDma_Coalesce;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/*****************************************************************************/
+/**
+* Return the length in ns of one delay timer unit for a given SG clock.
+*
+* @param	SgClkHz is the frequency of the DMA SG clock (m_axi_sg_aclk)
+*		in Hz.
+*
+* @return	Length of a delay timer unit (125 SG clock cycles) in ns.
+*
+* @note		C-style signature:
+*		u32 XAXIDMA_COALESCE_TIMER_NS(u32 SgClkHz)
+*
+******************************************************************************/
+#define XAXIDMA_COALESCE_TIMER_NS(SgClkHz) \
+	((u32)(125000000U / ((u32)(SgClkHz) / 1000U)))
+
+/*****************************************************************************/
+/**
+* Report a batch of BDs reclaimed by the interrupt handler of the ring.
+*
+* @param	CoalPtr is the controller of the ring.
+* @param	NumBd is the number of BDs reclaimed in this interrupt.
+*
+* @return	None.
+*
+* @note		C-style signature:
+*		void XAxiDma_CoalesceIntr(XAxiDma_Coalesce *CoalPtr, int NumBd)
+*
+******************************************************************************/
+#define XAxiDma_CoalesceIntr(CoalPtr, NumBd)			\
+	do {							\
+		(CoalPtr)->BdCount += (u32)(NumBd);		\
+		(CoalPtr)->IrqCount++;				\
+	} while (0)
+
+/*****************************************************************************/
+/**
+* Forget the packet threshold and delay timer programmed into the ring, so
+* that the next XAxiDma_CoalesceSample() writes them again. To be called after
+* the DMA has been reset.
+*
+* @param	CoalPtr is the controller of the ring.
+*
+* @return	None.
+*
+* @note		C-style signature:
+*		void XAxiDma_CoalesceInvalidate(XAxiDma_Coalesce *CoalPtr)
+*
+*		0 is never programmed, the lowest values are 1.
+*
+******************************************************************************/
+#define XAxiDma_CoalesceInvalidate(CoalPtr)			\
+	do {							\
+		(CoalPtr)->Counter = 0U;			\
+		(CoalPtr)->Timer = 0U;				\
+	} while (0)
+
+/************************** Function Prototypes ******************************/
+
+int XAxiDma_CoalesceInitialize(XAxiDma_Coalesce *CoalPtr,
+		XAxiDma_BdRing *RingPtr, const XAxiDma_CoalesceConfig *CfgPtr);
+int XAxiDma_CoalesceSample(XAxiDma_Coalesce *CoalPtr, u32 ElapsedUs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of protection macro */
+/** @} */
@@ -0,0 +1,994 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxidma_stream.c
+* @addtogroup axidma_v9_0
+* @{
+*
+* This file implements the streaming layer on top of the BD ring API. See
+* xaxidma_stream.h for a description of how it is used.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 9.3        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xaxidma_stream.h"
+
+/************************** Constant Definitions *****************************/
+
+/* Default number of reclaimed RX BDs collected before they are re-armed */
+#define XAXIDMA_STREAM_REFILL_BATCH	8
+
+/**************************** Type Definitions *******************************/
+
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/******************************************************************************
+ * Return the position of a BD in its ring.
+ *
+ * @param	RingPtr is the ring BdPtr appears in
+ * @param	BdPtr is the BD
+ *
+ * @returns	Index of the BD, 0 for the first BD of the ring
+ *
+ *****************************************************************************/
+#define XAxiDma_StreamBdIndex(RingPtr, BdPtr) \
+	(u32)(((UINTPTR)(BdPtr) - (RingPtr)->FirstBdAddr) / (RingPtr)->Separation)
+
+/************************** Function Prototypes ******************************/
+
+static void XAxiDma_StreamInvalidateBufs(XAxiDma_Stream *StreamPtr,
+		int RingIndex, XAxiDma_BdRing *RingPtr, XAxiDma_Bd *BdPtr,
+		int NumBd);
+static int XAxiDma_StreamRxRefill(XAxiDma_Stream *StreamPtr, int RingIndex,
+		XAxiDma_BdRing *RingPtr);
+static int XAxiDma_StreamRxRecycle(XAxiDma_Stream *StreamPtr);
+static int XAxiDma_StreamReport(XAxiDma_StreamHandler Handler,
+		void *CallBackRef, XAxiDma_StreamQueue *QueuePtr,
+		XAxiDma_BdRing *RingPtr, XAxiDma_Bd *BdPtr, int NumBd,
+		int RingIndex);
+
+/************************** Variable Definitions *****************************/
+
+
+/*****************************************************************************/
+/**
+* Initialize a streaming layer instance for a DMA engine. The DMA engine must
+* have been initialized with XAxiDma_CfgInitialize() and be in SG mode.
+*
+* @param	StreamPtr is the instance to initialize.
+* @param	DmaPtr is the DMA engine to stream through.
+*
+* @return
+*		- XST_SUCCESS if the instance was initialized.
+*		- XST_NOT_SGDMA if the DMA engine is in simple mode.
+*
+* @note		None.
+*
+******************************************************************************/
+int XAxiDma_StreamInitialize(XAxiDma_Stream *StreamPtr, XAxiDma *DmaPtr)
+{
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(DmaPtr != NULL);
+	Xil_AssertNonvoid(DmaPtr->Initialized);
+
+	if (!XAxiDma_HasSg(DmaPtr)) {
+		xdbg_printf(XDBG_DEBUG_ERROR, "Stream: DMA is in simple mode\r\n");
+
+		return XST_NOT_SGDMA;
+	}
+
+	memset(StreamPtr, 0, sizeof(XAxiDma_Stream));
+	StreamPtr->DmaPtr = DmaPtr;
+	StreamPtr->RxRefillBatch = XAXIDMA_STREAM_REFILL_BATCH;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Set the handler called for every completed receive BD. Setting a handler
+* disables the receive completion queue.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	Handler is the function to call, NULL to remove it.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+* @note		The buffer is given back to hardware once the handler returns.
+*
+******************************************************************************/
+void XAxiDma_StreamSetRxHandler(XAxiDma_Stream *StreamPtr,
+			XAxiDma_StreamHandler Handler, void *CallBackRef)
+{
+	Xil_AssertVoid(StreamPtr != NULL);
+
+	StreamPtr->RxHandler = Handler;
+	StreamPtr->RxCallBackRef = CallBackRef;
+	StreamPtr->RxQueuePtr = NULL;
+}
+
+/*****************************************************************************/
+/**
+* Set the handler called for every completed transmit BD. Setting a handler
+* disables the transmit completion queue.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	Handler is the function to call, NULL to remove it.
+* @param	CallBackRef is passed to the handler.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XAxiDma_StreamSetTxHandler(XAxiDma_Stream *StreamPtr,
+			XAxiDma_StreamHandler Handler, void *CallBackRef)
+{
+	Xil_AssertVoid(StreamPtr != NULL);
+
+	StreamPtr->TxHandler = Handler;
+	StreamPtr->TxCallBackRef = CallBackRef;
+	StreamPtr->TxQueuePtr = NULL;
+}
+
+/*****************************************************************************/
+/**
+* Report receive completions through a completion queue instead of a handler.
+* The receive buffer of an entry stays owned by the consumer until the entry
+* is released with XAxiDma_StreamQueueRelease().
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	QueuePtr is a queue set up with XAxiDma_StreamQueueInit().
+*
+* @return	None.
+*
+* @note		Must be called before any receive ring is started.
+*
+******************************************************************************/
+void XAxiDma_StreamSetRxQueue(XAxiDma_Stream *StreamPtr,
+			XAxiDma_StreamQueue *QueuePtr)
+{
+	Xil_AssertVoid(StreamPtr != NULL);
+	Xil_AssertVoid(QueuePtr != NULL);
+
+	StreamPtr->RxQueuePtr = QueuePtr;
+	StreamPtr->RxHandler = NULL;
+}
+
+/*****************************************************************************/
+/**
+* Report transmit completions through a completion queue instead of a
+* handler.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	QueuePtr is a queue set up with XAxiDma_StreamQueueInit().
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XAxiDma_StreamSetTxQueue(XAxiDma_Stream *StreamPtr,
+			XAxiDma_StreamQueue *QueuePtr)
+{
+	Xil_AssertVoid(StreamPtr != NULL);
+	Xil_AssertVoid(QueuePtr != NULL);
+
+	StreamPtr->TxQueuePtr = QueuePtr;
+	StreamPtr->TxHandler = NULL;
+}
+
+/*****************************************************************************/
+/**
+* Set how many reclaimed receive BDs are collected before they are given back
+* to hardware in one XAxiDma_BdRingToHw() call. BDs are re-armed earlier if
+* fewer than this many are left with the hardware.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	NumBd is the batch size, at least 1.
+*
+* @return	None.
+*
+* @note		The default is 8.
+*
+******************************************************************************/
+void XAxiDma_StreamSetRxRefillBatch(XAxiDma_Stream *StreamPtr, int NumBd)
+{
+	Xil_AssertVoid(StreamPtr != NULL);
+	Xil_AssertVoid(NumBd > 0);
+
+	StreamPtr->RxRefillBatch = NumBd;
+}
+
+/*****************************************************************************/
+/**
+* Set up a receive ring and give all its BDs to hardware. The BD area is
+* divided into as many BDs as fit, and BD N receives into
+* BufBase + N * BufSize.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	RingIndex is the receive ring, 0 unless the DMA engine has
+*		several S2MM channels.
+* @param	BdSpace is the address of the BD area. It must be aligned to
+*		XAXIDMA_BD_MINIMUM_ALIGNMENT.
+* @param	BdSpaceBytes is the size of the BD area.
+* @param	BufBase is the address of the buffer area, which must hold
+*		one buffer per BD.
+* @param	BufSize is the size of each buffer. It must be a multiple of
+*		XAXIDMA_BD_MINIMUM_ALIGNMENT so that no two buffers share a
+*		cache line.
+*
+* @return
+*		- XST_SUCCESS if the ring was set up.
+*		- XST_INVALID_PARAM if the BD area cannot hold a BD or a
+*		  buffer size is not accepted by the hardware.
+*		- XST_FAILURE or an error returned by the BD ring API.
+*
+* @note		The ring is started by XAxiDma_StreamStart().
+*
+******************************************************************************/
+int XAxiDma_StreamRxSetup(XAxiDma_Stream *StreamPtr, int RingIndex,
+			UINTPTR BdSpace, u32 BdSpaceBytes,
+			UINTPTR BufBase, u32 BufSize)
+{
+	XAxiDma_BdRing *RingPtr;
+	XAxiDma_Bd BdTemplate;
+	XAxiDma_Bd *BdPtr;
+	XAxiDma_Bd *BdCurPtr;
+	int BdCount;
+	int Index;
+	int Status;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->DmaPtr->HasS2Mm);
+	Xil_AssertNonvoid((RingIndex >= 0) &&
+			(RingIndex < StreamPtr->DmaPtr->RxNumChannels));
+	Xil_AssertNonvoid((BufSize % XAXIDMA_BD_MINIMUM_ALIGNMENT) == 0U);
+
+	RingPtr = XAxiDma_GetRxIndexRing(StreamPtr->DmaPtr, RingIndex);
+
+	XAxiDma_BdRingIntDisable(RingPtr, XAXIDMA_IRQ_ALL_MASK);
+
+	BdCount = XAxiDma_BdRingCntCalc(XAXIDMA_BD_MINIMUM_ALIGNMENT,
+					BdSpaceBytes);
+	if (BdCount <= 0) {
+		return XST_INVALID_PARAM;
+	}
+
+	Status = XAxiDma_BdRingCreate(RingPtr, BdSpace, BdSpace,
+				XAXIDMA_BD_MINIMUM_ALIGNMENT, BdCount);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XAxiDma_BdClear(&BdTemplate);
+	Status = XAxiDma_BdRingClone(RingPtr, &BdTemplate);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XAxiDma_BdRingAlloc(RingPtr, BdCount, &BdPtr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* Bind buffer N to BD N for the life of the ring */
+	BdCurPtr = BdPtr;
+	for (Index = 0; Index < BdCount; Index++) {
+		Status = XAxiDma_BdSetBufAddr(BdCurPtr,
+				BufBase + ((UINTPTR)Index * BufSize));
+		if (Status == XST_SUCCESS) {
+			Status = XAxiDma_BdSetLength(BdCurPtr, BufSize,
+					RingPtr->MaxTransferLen);
+		}
+		if (Status != XST_SUCCESS) {
+			XAxiDma_BdRingUnAlloc(RingPtr, BdCount, BdPtr);
+
+			return XST_INVALID_PARAM;
+		}
+
+		XAxiDma_BdSetCtrl(BdCurPtr, 0);
+		XAxiDma_BdSetId(BdCurPtr, BufBase + ((UINTPTR)Index * BufSize));
+
+		BdCurPtr = (XAxiDma_Bd *)((void *)
+				XAxiDma_BdRingNext(RingPtr, BdCurPtr));
+	}
+
+	StreamPtr->RxBufBase[RingIndex] = BufBase;
+	StreamPtr->RxBufSize[RingIndex] = BufSize;
+	StreamPtr->RxHeld[RingIndex] = 0;
+
+	/* No dirty line may be written back over received data */
+	Xil_DCacheInvalidateRange(BufBase, (u32)BdCount * BufSize);
+
+	Status = XAxiDma_BdRingToHw(RingPtr, BdCount, BdPtr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	StreamPtr->RxRingMask |= (u32)1 << RingIndex;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Set up the transmit ring.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	BdSpace is the address of the BD area. It must be aligned to
+*		XAXIDMA_BD_MINIMUM_ALIGNMENT.
+* @param	BdSpaceBytes is the size of the BD area. It bounds the number
+*		of packets that can be in flight.
+*
+* @return
+*		- XST_SUCCESS if the ring was set up.
+*		- XST_INVALID_PARAM if the BD area cannot hold a BD.
+*		- An error returned by the BD ring API.
+*
+* @note		The ring is started by XAxiDma_StreamStart().
+*
+******************************************************************************/
+int XAxiDma_StreamTxSetup(XAxiDma_Stream *StreamPtr, UINTPTR BdSpace,
+			u32 BdSpaceBytes)
+{
+	XAxiDma_BdRing *RingPtr;
+	XAxiDma_Bd BdTemplate;
+	int BdCount;
+	int Status;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->DmaPtr->HasMm2S);
+
+	RingPtr = XAxiDma_GetTxRing(StreamPtr->DmaPtr);
+
+	XAxiDma_BdRingIntDisable(RingPtr, XAXIDMA_IRQ_ALL_MASK);
+
+	BdCount = XAxiDma_BdRingCntCalc(XAXIDMA_BD_MINIMUM_ALIGNMENT,
+					BdSpaceBytes);
+	if (BdCount <= 0) {
+		return XST_INVALID_PARAM;
+	}
+
+	Status = XAxiDma_BdRingCreate(RingPtr, BdSpace, BdSpace,
+				XAXIDMA_BD_MINIMUM_ALIGNMENT, BdCount);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XAxiDma_BdClear(&BdTemplate);
+	Status = XAxiDma_BdRingClone(RingPtr, &BdTemplate);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	StreamPtr->HasTx = TRUE;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Start the rings that have been set up. In multichannel mode the current
+* descriptor of every receive ring is programmed before any ring is started.
+*
+* @param	StreamPtr is the instance to operate on.
+*
+* @return
+*		- XST_SUCCESS if the rings were started.
+*		- An error returned by the BD ring API.
+*
+* @note		Interrupts are left to the application, see
+*		XAxiDma_BdRingIntEnable().
+*
+******************************************************************************/
+int XAxiDma_StreamStart(XAxiDma_Stream *StreamPtr)
+{
+	XAxiDma_BdRing *RingPtr;
+	int RingIndex;
+	int Status;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+
+	if (StreamPtr->HasTx) {
+		Status = XAxiDma_BdRingStart(
+				XAxiDma_GetTxRing(StreamPtr->DmaPtr));
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+	}
+
+	for (RingIndex = 0; RingIndex < XAXIDMA_STREAM_MAX_RX_RINGS;
+								RingIndex++) {
+		if (StreamPtr->RxRingMask & ((u32)1 << RingIndex)) {
+			RingPtr = XAxiDma_GetRxIndexRing(StreamPtr->DmaPtr,
+							RingIndex);
+			Status = XAxiDma_UpdateBdRingCDesc(RingPtr);
+			if (Status != XST_SUCCESS) {
+				return Status;
+			}
+		}
+	}
+
+	for (RingIndex = 0; RingIndex < XAXIDMA_STREAM_MAX_RX_RINGS;
+								RingIndex++) {
+		if (StreamPtr->RxRingMask & ((u32)1 << RingIndex)) {
+			RingPtr = XAxiDma_GetRxIndexRing(StreamPtr->DmaPtr,
+							RingIndex);
+			Status = XAxiDma_StartBdRingHw(RingPtr);
+			if (Status != XST_SUCCESS) {
+				return Status;
+			}
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Queue packets for transmission, one BD per packet. All packets are handed to
+* hardware with a single tail pointer update. Buffers that follow each other
+* in memory are flushed from the data cache with one call.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	BufPtr is an array of packets.
+* @param	NumBufs is the number of packets in the array.
+*
+* @return
+*		- XST_SUCCESS if all packets were queued.
+*		- XST_DMA_SG_LIST_FULL if there are not enough free BDs. No
+*		  packet is queued; call XAxiDma_StreamTxPoll() to reclaim
+*		  completed BDs.
+*		- XST_INVALID_PARAM if a packet length is not accepted by the
+*		  hardware.
+*		- An error returned by XAxiDma_BdRingToHw().
+*
+* @note		This function and XAxiDma_StreamTxPoll() both update the
+*		transmit ring and must not preempt each other.
+*
+******************************************************************************/
+int XAxiDma_StreamTxSubmit(XAxiDma_Stream *StreamPtr,
+			const XAxiDma_StreamBuf *BufPtr, int NumBufs)
+{
+	XAxiDma_BdRing *RingPtr;
+	XAxiDma_Bd *BdPtr;
+	XAxiDma_Bd *BdCurPtr;
+	UINTPTR RunStart;
+	UINTPTR RunEnd;
+	int Index;
+	int Status;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->HasTx);
+	Xil_AssertNonvoid(BufPtr != NULL);
+
+	if (NumBufs <= 0) {
+		return XST_SUCCESS;
+	}
+
+	RingPtr = XAxiDma_GetTxRing(StreamPtr->DmaPtr);
+
+	if (XAxiDma_BdRingGetFreeCnt(RingPtr) < NumBufs) {
+		return XST_DMA_SG_LIST_FULL;
+	}
+
+	Status = XAxiDma_BdRingAlloc(RingPtr, NumBufs, &BdPtr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	RunStart = BufPtr[0].BufAddr;
+	RunEnd = RunStart;
+	BdCurPtr = BdPtr;
+	for (Index = 0; Index < NumBufs; Index++) {
+		/* Extend the flush run while buffers are contiguous */
+		if (BufPtr[Index].BufAddr != RunEnd) {
+			Xil_DCacheFlushRange(RunStart, RunEnd - RunStart);
+			RunStart = BufPtr[Index].BufAddr;
+		}
+		RunEnd = BufPtr[Index].BufAddr + BufPtr[Index].Length;
+
+		Status = XAxiDma_BdSetBufAddr(BdCurPtr, BufPtr[Index].BufAddr);
+		if (Status == XST_SUCCESS) {
+			Status = XAxiDma_BdSetLength(BdCurPtr,
+					BufPtr[Index].Length,
+					RingPtr->MaxTransferLen);
+		}
+		if (Status != XST_SUCCESS) {
+			XAxiDma_BdRingUnAlloc(RingPtr, NumBufs, BdPtr);
+
+			return XST_INVALID_PARAM;
+		}
+
+		XAxiDma_BdSetCtrl(BdCurPtr, XAXIDMA_BD_CTRL_TXSOF_MASK |
+					XAXIDMA_BD_CTRL_TXEOF_MASK);
+		XAxiDma_BdSetId(BdCurPtr, BufPtr[Index].BufAddr);
+
+		if (StreamPtr->DmaPtr->TxNumChannels > 1) {
+			XAxiDma_BdSetTDest(BdCurPtr, BufPtr[Index].TDest);
+			XAxiDma_BdSetTId(BdCurPtr, BufPtr[Index].TId);
+		}
+
+		BdCurPtr = (XAxiDma_Bd *)((void *)
+				XAxiDma_BdRingNext(RingPtr, BdCurPtr));
+	}
+	Xil_DCacheFlushRange(RunStart, RunEnd - RunStart);
+
+	Status = XAxiDma_BdRingToHw(RingPtr, NumBufs, BdPtr);
+	if (Status != XST_SUCCESS) {
+		XAxiDma_BdRingUnAlloc(RingPtr, NumBufs, BdPtr);
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* Reclaim completed receive BDs on all receive rings, report them and give
+* BDs back to hardware in batches. In queue mode, the BDs of entries released
+* by the consumer since the last call are re-armed first.
+*
+* This is meant to be called from the receive interrupt handler after the
+* interrupt has been acknowledged, or periodically when polling.
+*
+* @param	StreamPtr is the instance to operate on.
+*
+* @return	The number of completions reported, or a negative XST_* error
+*		code if the BD ring is inconsistent.
+*
+* @note		Channel errors are not handled here. The error bits of each
+*		BD are passed on in the completion status, and a halted
+*		channel must be reset by the application.
+*
+******************************************************************************/
+int XAxiDma_StreamRxPoll(XAxiDma_Stream *StreamPtr)
+{
+	XAxiDma_StreamQueue *QueuePtr;
+	XAxiDma_BdRing *RingPtr;
+	XAxiDma_Bd *BdPtr;
+	int RingIndex;
+	int BdLimit;
+	int NumBd;
+	int Total = 0;
+	int Status;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+
+	QueuePtr = StreamPtr->RxQueuePtr;
+	if (QueuePtr != NULL) {
+		Status = XAxiDma_StreamRxRecycle(StreamPtr);
+		if (Status != XST_SUCCESS) {
+			return -Status;
+		}
+	}
+
+	for (RingIndex = 0; RingIndex < XAXIDMA_STREAM_MAX_RX_RINGS;
+								RingIndex++) {
+		if (!(StreamPtr->RxRingMask & ((u32)1 << RingIndex))) {
+			continue;
+		}
+
+		RingPtr = XAxiDma_GetRxIndexRing(StreamPtr->DmaPtr, RingIndex);
+
+		BdLimit = XAXIDMA_ALL_BDS;
+		if (QueuePtr != NULL) {
+			BdLimit = (int)(QueuePtr->Size -
+					(QueuePtr->Head - QueuePtr->Recycled));
+		}
+
+		NumBd = 0;
+		if (BdLimit > 0) {
+			NumBd = XAxiDma_BdRingFromHw(RingPtr, BdLimit, &BdPtr);
+		}
+
+		if (NumBd > 0) {
+			XAxiDma_StreamInvalidateBufs(StreamPtr, RingIndex,
+						RingPtr, BdPtr, NumBd);
+
+			Total += XAxiDma_StreamReport(StreamPtr->RxHandler,
+					StreamPtr->RxCallBackRef, QueuePtr,
+					RingPtr, BdPtr, NumBd, RingIndex);
+
+			if (QueuePtr != NULL) {
+				/* The consumer owns the buffers until
+				 * it releases the queue entries */
+				StreamPtr->RxHeld[RingIndex] += NumBd;
+			}
+			else {
+				Status = XAxiDma_BdRingFree(RingPtr, NumBd,
+								BdPtr);
+				if (Status != XST_SUCCESS) {
+					return -Status;
+				}
+			}
+		}
+
+		Status = XAxiDma_StreamRxRefill(StreamPtr, RingIndex, RingPtr);
+		if (Status != XST_SUCCESS) {
+			return -Status;
+		}
+	}
+
+	return Total;
+}
+
+/*****************************************************************************/
+/**
+* Reclaim completed transmit BDs and report them.
+*
+* @param	StreamPtr is the instance to operate on.
+*
+* @return	The number of completions reported, or a negative XST_* error
+*		code if the BD ring is inconsistent.
+*
+* @note		See XAxiDma_StreamTxSubmit() for the locking requirement.
+*
+******************************************************************************/
+int XAxiDma_StreamTxPoll(XAxiDma_Stream *StreamPtr)
+{
+	XAxiDma_StreamQueue *QueuePtr;
+	XAxiDma_BdRing *RingPtr;
+	XAxiDma_Bd *BdPtr;
+	int BdLimit;
+	int NumBd;
+	int Status;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->HasTx);
+
+	RingPtr = XAxiDma_GetTxRing(StreamPtr->DmaPtr);
+	QueuePtr = StreamPtr->TxQueuePtr;
+
+	BdLimit = XAXIDMA_ALL_BDS;
+	if (QueuePtr != NULL) {
+		/* Transmit entries do not hold BDs */
+		QueuePtr->Recycled = QueuePtr->Tail;
+		BdLimit = (int)(QueuePtr->Size -
+				(QueuePtr->Head - QueuePtr->Recycled));
+		if (BdLimit == 0) {
+			return 0;
+		}
+	}
+
+	NumBd = XAxiDma_BdRingFromHw(RingPtr, BdLimit, &BdPtr);
+	if (NumBd == 0) {
+		return 0;
+	}
+
+	(void)XAxiDma_StreamReport(StreamPtr->TxHandler,
+				StreamPtr->TxCallBackRef, QueuePtr,
+				RingPtr, BdPtr, NumBd, 0);
+
+	Status = XAxiDma_BdRingFree(RingPtr, NumBd, BdPtr);
+	if (Status != XST_SUCCESS) {
+		return -Status;
+	}
+
+	return NumBd;
+}
+
+/*****************************************************************************/
+/**
+* Initialize a completion queue.
+*
+* @param	QueuePtr is the queue to initialize.
+* @param	Entries is the storage for the entries.
+* @param	Size is the number of entries, a power of 2.
+*
+* @return
+*		- XST_SUCCESS if the queue was initialized.
+*		- XST_INVALID_PARAM if Size is not a power of 2.
+*
+* @note		None.
+*
+******************************************************************************/
+int XAxiDma_StreamQueueInit(XAxiDma_StreamQueue *QueuePtr,
+			XAxiDma_StreamCompletion *Entries, u32 Size)
+{
+	Xil_AssertNonvoid(QueuePtr != NULL);
+	Xil_AssertNonvoid(Entries != NULL);
+
+	if ((Size == 0U) || ((Size & (Size - 1U)) != 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	QueuePtr->Entries = Entries;
+	QueuePtr->Size = Size;
+	QueuePtr->Head = 0U;
+	QueuePtr->Tail = 0U;
+	QueuePtr->Recycled = 0U;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Return the oldest completion in a queue without removing it.
+*
+* @param	QueuePtr is the queue to read.
+*
+* @return	The oldest entry, or NULL if the queue is empty.
+*
+* @note		Only the consumer may call this function.
+*
+******************************************************************************/
+XAxiDma_StreamCompletion *XAxiDma_StreamQueuePeek(
+			XAxiDma_StreamQueue *QueuePtr)
+{
+	Xil_AssertNonvoid(QueuePtr != NULL);
+
+	if (QueuePtr->Head == QueuePtr->Tail) {
+		return NULL;
+	}
+
+	/* Read the entry only after seeing the producer's Head update */
+	DATA_SYNC;
+
+	return &QueuePtr->Entries[QueuePtr->Tail & (QueuePtr->Size - 1U)];
+}
+
+/*****************************************************************************/
+/**
+* Remove the oldest completion from a queue. For a receive queue this also
+* hands the buffer of the entry back; its BD is re-armed by the next
+* XAxiDma_StreamRxPoll().
+*
+* @param	QueuePtr is the queue to operate on.
+*
+* @return	None.
+*
+* @note		Only the consumer may call this function, and only after
+*		XAxiDma_StreamQueuePeek() returned an entry.
+*
+******************************************************************************/
+void XAxiDma_StreamQueueRelease(XAxiDma_StreamQueue *QueuePtr)
+{
+	Xil_AssertVoid(QueuePtr != NULL);
+	Xil_AssertVoid(QueuePtr->Head != QueuePtr->Tail);
+
+	/* Finish all accesses to the entry and buffer before giving it up */
+	DATA_SYNC;
+	QueuePtr->Tail++;
+}
+
+/*****************************************************************************/
+/**
+* Invalidate the receive buffers of a set of adjacent BDs. Buffer N belongs
+* to BD N, so the buffers of the set are adjacent too and take one cache
+* maintenance call, or two if the set wraps around the end of the ring.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	RingIndex is the receive ring.
+* @param	RingPtr is the BD ring of the receive ring.
+* @param	BdPtr is the first BD of the set.
+* @param	NumBd is the number of BDs in the set.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XAxiDma_StreamInvalidateBufs(XAxiDma_Stream *StreamPtr,
+		int RingIndex, XAxiDma_BdRing *RingPtr, XAxiDma_Bd *BdPtr,
+		int NumBd)
+{
+	u32 First;
+	u32 Count;
+	UINTPTR BufBase = StreamPtr->RxBufBase[RingIndex];
+	u32 BufSize = StreamPtr->RxBufSize[RingIndex];
+
+	First = XAxiDma_StreamBdIndex(RingPtr, BdPtr);
+	Count = (u32)NumBd;
+
+	if ((First + Count) > (u32)RingPtr->AllCnt) {
+		Xil_DCacheInvalidateRange(BufBase,
+			(First + Count - (u32)RingPtr->AllCnt) * BufSize);
+		Count = (u32)RingPtr->AllCnt - First;
+	}
+	Xil_DCacheInvalidateRange(BufBase + ((UINTPTR)First * BufSize),
+				Count * BufSize);
+}
+
+/*****************************************************************************/
+/**
+* Give the free BDs of a receive ring back to hardware once a batch has
+* collected, or straight away if hardware is running low.
+*
+* @param	StreamPtr is the instance to operate on.
+* @param	RingIndex is the receive ring.
+* @param	RingPtr is the BD ring of the receive ring.
+*
+* @return	XST_SUCCESS or an error returned by the BD ring API.
+*
+* @note		None.
+*
+******************************************************************************/
+static int XAxiDma_StreamRxRefill(XAxiDma_Stream *StreamPtr, int RingIndex,
+		XAxiDma_BdRing *RingPtr)
+{
+	XAxiDma_Bd *BdPtr;
+	int NumBd;
+	int Status;
+
+	NumBd = XAxiDma_BdRingGetFreeCnt(RingPtr);
+	if ((NumBd == 0) || ((NumBd < StreamPtr->RxRefillBatch) &&
+			(RingPtr->HwCnt >= StreamPtr->RxRefillBatch))) {
+		return XST_SUCCESS;
+	}
+
+	/* The free group follows the BDs that were last given to hardware,
+	 * so these are the same BDs, still pointing at their own buffers.
+	 */
+	Status = XAxiDma_BdRingAlloc(RingPtr, NumBd, &BdPtr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/* Drop anything the consumer may have left dirty in the buffers */
+	XAxiDma_StreamInvalidateBufs(StreamPtr, RingIndex, RingPtr, BdPtr,
+					NumBd);
+
+	return XAxiDma_BdRingToHw(RingPtr, NumBd, BdPtr);
+}
+
+/*****************************************************************************/
+/**
+* Free the BDs of the receive queue entries the consumer has released since
+* the last call. Each ring's entries are released in the order its BDs were
+* reclaimed, so they can be freed from the post-processing group in bulk.
+*
+* @param	StreamPtr is the instance to operate on.
+*
+* @return	XST_SUCCESS or an error returned by XAxiDma_BdRingFree().
+*
+* @note		None.
+*
+******************************************************************************/
+static int XAxiDma_StreamRxRecycle(XAxiDma_Stream *StreamPtr)
+{
+	XAxiDma_StreamQueue *QueuePtr = StreamPtr->RxQueuePtr;
+	XAxiDma_BdRing *RingPtr;
+	int Released[XAXIDMA_STREAM_MAX_RX_RINGS];
+	int RingIndex;
+	u32 Tail;
+	int Status;
+
+	Tail = QueuePtr->Tail;
+	if (Tail == QueuePtr->Recycled) {
+		return XST_SUCCESS;
+	}
+
+	memset(Released, 0, sizeof(Released));
+	while (QueuePtr->Recycled != Tail) {
+		RingIndex = QueuePtr->Entries[QueuePtr->Recycled &
+					(QueuePtr->Size - 1U)].RingIndex;
+		Released[RingIndex]++;
+		QueuePtr->Recycled++;
+	}
+
+	for (RingIndex = 0; RingIndex < XAXIDMA_STREAM_MAX_RX_RINGS;
+								RingIndex++) {
+		if (Released[RingIndex] == 0) {
+			continue;
+		}
+
+		RingPtr = XAxiDma_GetRxIndexRing(StreamPtr->DmaPtr, RingIndex);
+		Status = XAxiDma_BdRingFree(RingPtr, Released[RingIndex],
+						RingPtr->PostHead);
+		if (Status != XST_SUCCESS) {
+			return Status;
+		}
+		StreamPtr->RxHeld[RingIndex] -= Released[RingIndex];
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Report a set of completed BDs through a handler or a completion queue.
+*
+* @param	Handler is the completion handler, used if QueuePtr is NULL.
+* @param	CallBackRef is passed to the handler.
+* @param	QueuePtr is the completion queue, or NULL.
+* @param	RingPtr is the BD ring the set belongs to.
+* @param	BdPtr is the first BD of the set.
+* @param	NumBd is the number of BDs in the set. In queue mode the
+*		caller has made sure the queue has room for all of them.
+* @param	RingIndex is the receive ring, 0 for transmit.
+*
+* @return	The number of completions reported.
+*
+* @note		With neither a handler nor a queue the BDs are only counted.
+*
+******************************************************************************/
+static int XAxiDma_StreamReport(XAxiDma_StreamHandler Handler,
+		void *CallBackRef, XAxiDma_StreamQueue *QueuePtr,
+		XAxiDma_BdRing *RingPtr, XAxiDma_Bd *BdPtr, int NumBd,
+		int RingIndex)
+{
+	XAxiDma_StreamCompletion Completion;
+	XAxiDma_StreamCompletion *CompPtr = &Completion;
+	u32 Head = 0U;
+	int Index;
+
+	if (QueuePtr != NULL) {
+		Head = QueuePtr->Head;
+	}
+
+	for (Index = 0; Index < NumBd; Index++) {
+		if (QueuePtr != NULL) {
+			CompPtr = &QueuePtr->Entries[Head &
+						(QueuePtr->Size - 1U)];
+			Head++;
+		}
+
+		CompPtr->BufAddr = XAxiDma_BdGetBufAddr(BdPtr);
+		CompPtr->Status = XAxiDma_BdGetSts(BdPtr);
+		CompPtr->Length = XAxiDma_BdGetActualLength(BdPtr,
+						RingPtr->MaxTransferLen);
+		CompPtr->RingIndex = (u16)RingIndex;
+		CompPtr->Direction = RingPtr->IsRxChannel ?
+			XAXIDMA_DEVICE_TO_DMA : XAXIDMA_DMA_TO_DEVICE;
+
+		if ((QueuePtr == NULL) && (Handler != NULL)) {
+			Handler(CallBackRef, CompPtr);
+		}
+
+		BdPtr = (XAxiDma_Bd *)((void *)
+				XAxiDma_BdRingNext(RingPtr, BdPtr));
+	}
+
+	if (QueuePtr != NULL) {
+		/* Publish the whole batch with one barrier */
+		DATA_SYNC;
+		QueuePtr->Head = Head;
+	}
+
+	return NumBd;
+}
+/** @} */
@@ -0,0 +1,243 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxidma_stream.h
+* @addtogroup axidma_v9_0
+* @{
+*
+* This file contains a streaming layer built on the BD ring API of the AXI DMA
+* driver for SG mode. It takes care of the refill and reclaim loops that
+* packet based applications otherwise write around XAxiDma_BdRingAlloc(),
+* XAxiDma_BdRingToHw(), XAxiDma_BdRingFromHw() and XAxiDma_BdRingFree().
+*
+* <b>Receive</b>
+*
+* Each receive ring (one per TDEST channel in multichannel mode) is given a
+* BD area and a buffer area holding one fixed size buffer per BD. Buffer N
+* always belongs to BD N, so the ring is primed once in
+* XAxiDma_StreamRxSetup() and afterwards a BD only needs its status cleared
+* to be given back to hardware. Completed BDs are reclaimed and re-armed in
+* batches, and the cache maintenance for the BDs and the buffers of a batch
+* is done over contiguous ranges instead of per BD.
+*
+* <b>Transmit</b>
+*
+* XAxiDma_StreamTxSubmit() queues a list of packets, one BD per packet, with
+* a single tail pointer update. Buffers that are adjacent in memory are
+* flushed together. In multichannel mode each packet carries its TDEST and
+* TID.
+*
+* <b>Completions</b>
+*
+* Completions are reported either through a handler called from
+* XAxiDma_StreamRxPoll()/XAxiDma_StreamTxPoll(), or through a single
+* producer, single consumer completion queue. In handler mode a receive
+* buffer is re-armed as soon as the handler returns. In queue mode the
+* consumer owns the buffer until it releases the entry with
+* XAxiDma_StreamQueueRelease(); the BD is re-armed by the next poll. The
+* queue needs no locking as long as the poll functions run in one context
+* (typically the DMA interrupt handler) and the consumer in another.
+*
+* Typical use:
+* <pre>
+*	XAxiDma_StreamInitialize(&Stream, &AxiDma);
+*	XAxiDma_StreamSetRxHandler(&Stream, RxHandler, &AppData);
+*	XAxiDma_StreamRxSetup(&Stream, 0, RX_BD_SPACE, RX_BD_BYTES,
+*				RX_BUF_BASE, RX_BUF_SIZE);
+*	XAxiDma_StreamTxSetup(&Stream, TX_BD_SPACE, TX_BD_BYTES);
+*	XAxiDma_StreamStart(&Stream);
+*
+*	// In the RX and TX interrupt handlers, after acknowledging the IRQ
+*	XAxiDma_StreamRxPoll(&Stream);
+*	XAxiDma_StreamTxPoll(&Stream);
+* </pre>
+*
+* @note
+*
+* The layer assumes a flat address map (the BD and buffer virtual addresses
+* are the physical addresses), and that receive buffers are large enough for
+* a whole packet. A packet spanning several receive BDs is reported as one
+* completion per BD; the last one has XAXIDMA_BD_STS_RXEOF_MASK set in its
+* status.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 9.3        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+#ifndef XAXIDMA_STREAM_H_	/* prevent circular inclusions */
+#define XAXIDMA_STREAM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xaxidma.h"
+
+/************************** Constant Definitions *****************************/
+
+/** Maximum number of receive rings, one per S2MM channel */
+#define XAXIDMA_STREAM_MAX_RX_RINGS	16
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * A completed transfer as reported to the application.
+ */
+typedef struct {
+	UINTPTR BufAddr;	/**< Buffer the BD pointed to */
+	u32 Length;		/**< Number of bytes transferred */
+	u32 Status;		/**< BD status word. Holds the error and
+				  *  SOF/EOF bits and, for multichannel RX,
+				  *  TDEST, TID and TUSER */
+	u16 RingIndex;		/**< Receive ring (channel), 0 for TX */
+	u16 Direction;		/**< XAXIDMA_DEVICE_TO_DMA or
+				  *  XAXIDMA_DMA_TO_DEVICE */
+} XAxiDma_StreamCompletion;
+
+/**
+ * Single producer, single consumer queue of completions. Head is only
+ * written by the poll functions and Tail only by the consumer.
+ */
+typedef struct {
+	XAxiDma_StreamCompletion *Entries; /**< Entry storage */
+	u32 Size;		/**< Number of entries, a power of 2 */
+	volatile u32 Head;	/**< Next entry to fill */
+	volatile u32 Tail;	/**< Next entry to consume */
+	u32 Recycled;		/**< Entries whose BD has been re-armed,
+				  *  producer private */
+} XAxiDma_StreamQueue;
+
+/**
+ * Completion handler. CompPtr is only valid for the duration of the call.
+ */
+typedef void (*XAxiDma_StreamHandler)(void *CallBackRef,
+				const XAxiDma_StreamCompletion *CompPtr);
+
+/**
+ * One packet to transmit.
+ */
+typedef struct {
+	UINTPTR BufAddr;	/**< Start of the packet */
+	u32 Length;		/**< Length of the packet in bytes */
+	u8 TDest;		/**< TDEST, used in multichannel mode only */
+	u8 TId;			/**< TID, used in multichannel mode only */
+} XAxiDma_StreamBuf;
+
+/**
+ * The streaming layer instance data.
+ */
+typedef struct {
+	XAxiDma *DmaPtr;		/**< DMA engine instance */
+
+	XAxiDma_StreamHandler RxHandler; /**< RX completion handler */
+	void *RxCallBackRef;		/**< Argument of RxHandler */
+	XAxiDma_StreamHandler TxHandler; /**< TX completion handler */
+	void *TxCallBackRef;		/**< Argument of TxHandler */
+	XAxiDma_StreamQueue *RxQueuePtr; /**< RX completion queue */
+	XAxiDma_StreamQueue *TxQueuePtr; /**< TX completion queue */
+
+	u32 RxRingMask;			/**< Receive rings that are set up */
+	int HasTx;			/**< Transmit ring is set up */
+	int RxRefillBatch;		/**< Re-arm threshold in BDs */
+	UINTPTR RxBufBase[XAXIDMA_STREAM_MAX_RX_RINGS]; /**< Buffer areas */
+	u32 RxBufSize[XAXIDMA_STREAM_MAX_RX_RINGS];	/**< Buffer sizes */
+	int RxHeld[XAXIDMA_STREAM_MAX_RX_RINGS];	/**< BDs held by the
+							  *  RX queue */
+} XAxiDma_Stream;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/*****************************************************************************/
+/**
+* Return the number of completions waiting in a completion queue.
+*
+* @param	QueuePtr is the queue to check.
+*
+* @return	Number of entries that can be read with
+*		XAxiDma_StreamQueuePeek().
+*
+* @note
+*		C-style signature:
+*		u32 XAxiDma_StreamQueueCount(XAxiDma_StreamQueue *QueuePtr)
+*
+******************************************************************************/
+#define XAxiDma_StreamQueueCount(QueuePtr) \
+	((QueuePtr)->Head - (QueuePtr)->Tail)
+
+/************************** Function Prototypes ******************************/
+
+int XAxiDma_StreamInitialize(XAxiDma_Stream *StreamPtr, XAxiDma *DmaPtr);
+void XAxiDma_StreamSetRxHandler(XAxiDma_Stream *StreamPtr,
+			XAxiDma_StreamHandler Handler, void *CallBackRef);
+void XAxiDma_StreamSetTxHandler(XAxiDma_Stream *StreamPtr,
+			XAxiDma_StreamHandler Handler, void *CallBackRef);
+void XAxiDma_StreamSetRxQueue(XAxiDma_Stream *StreamPtr,
+			XAxiDma_StreamQueue *QueuePtr);
+void XAxiDma_StreamSetTxQueue(XAxiDma_Stream *StreamPtr,
+			XAxiDma_StreamQueue *QueuePtr);
+void XAxiDma_StreamSetRxRefillBatch(XAxiDma_Stream *StreamPtr, int NumBd);
+
+int XAxiDma_StreamRxSetup(XAxiDma_Stream *StreamPtr, int RingIndex,
+			UINTPTR BdSpace, u32 BdSpaceBytes,
+			UINTPTR BufBase, u32 BufSize);
+int XAxiDma_StreamTxSetup(XAxiDma_Stream *StreamPtr, UINTPTR BdSpace,
+			u32 BdSpaceBytes);
+int XAxiDma_StreamStart(XAxiDma_Stream *StreamPtr);
+
+int XAxiDma_StreamTxSubmit(XAxiDma_Stream *StreamPtr,
+			const XAxiDma_StreamBuf *BufPtr, int NumBufs);
+int XAxiDma_StreamRxPoll(XAxiDma_Stream *StreamPtr);
+int XAxiDma_StreamTxPoll(XAxiDma_Stream *StreamPtr);
+
+int XAxiDma_StreamQueueInit(XAxiDma_StreamQueue *QueuePtr,
+			XAxiDma_StreamCompletion *Entries, u32 Size);
+XAxiDma_StreamCompletion *XAxiDma_StreamQueuePeek(
+			XAxiDma_StreamQueue *QueuePtr);
+void XAxiDma_StreamQueueRelease(XAxiDma_StreamQueue *QueuePtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of protection macro */
+/** @} */
@@ -0,0 +1,381 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxidma_coalesce_replay.c
+*
+* Host trace replay for the adaptive interrupt coalescing controller.
+*
+* A stream of BD completions is fed through a model of the interrupt logic of
+* one AXI DMA channel: an interrupt is raised when the number of completed BDs
+* reaches the packet threshold, or when the delay timer, restarted by every
+* completion, expires (PG021, "Interrupt Coalescing"). The threshold and
+* timer are taken from the simulated control register, which the real
+* XAxiDma_BdRingSetCoalesce() writes. The interrupt handler reports each
+* batch with XAxiDma_CoalesceIntr() and a 100 ms tick calls
+* XAxiDma_CoalesceSample().
+*
+* The same stream is replayed with the fixed settings the lwIP adapter uses
+* (threshold 1, and a fixed threshold of 32) and with the controller. For
+* every second of the trace the interrupt rate and the mean and maximum
+* latency from BD completion to interrupt are printed.
+*
+* Halfway through the second second of the adaptive run the DMA is reset, as
+* the lwIP adapter does on an error interrupt, and the program checks that
+* the next sample programs the threshold and timer again.
+*
+* Usage: xaxidma_coalesce_replay [trace]
+*
+* The optional trace is a text file with one "<time in us> <BDs>" line per
+* completion, in time order. Without it a synthetic trace is used: 1 s at
+* 1000 packets/s, 1 s at 100000 packets/s, 1 s of 32 packet bursts every
+* 5 ms, and 1 s at 1000 packets/s again.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 9.3        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "xaxidma_coalesce.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE		0x40000000U	/* Simulated channel registers */
+#define SIM_REGS		16U
+
+#define SG_CLK_HZ		100000000U	/* SG clock of the model */
+#define TICK_US			100000U		/* Coalescing sample period */
+#define LATENCY_US		50U		/* Controller latency target */
+#define MAX_PHASES		64U
+#define MAX_PENDING		(XAXIDMA_COALESCE_MAX + 1U)
+#define MAX_EVENTS		(1U << 20)
+#define RESET_US		1500000U	/* DMA reset in the adaptive run */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 TimeUs;
+	u32 NumBd;
+} Event;
+
+typedef struct {
+	u32 Irqs;
+	u32 Bds;
+	u64 LatencySumNs;
+	u64 LatencyMaxNs;
+} PhaseStats;
+
+typedef enum {
+	MODE_FIXED_1,
+	MODE_FIXED_32,
+	MODE_ADAPTIVE,
+} Mode;
+
+/************************** Variable Definitions *****************************/
+
+static u32 SimRegs[SIM_REGS];
+static u32 CrWrites;
+
+static Event *Events;
+static u32 NumEvents;
+
+static XAxiDma_BdRing Ring;
+static XAxiDma_Coalesce Coal;
+static PhaseStats Phase[MAX_PHASES];
+static u64 PendingNs[MAX_PENDING];
+static u32 NumPending;
+
+/*****************************************************************************/
+/*
+* Register accesses of the driver land in the simulated channel registers.
+*/
+u32 Xil_In32(UINTPTR Addr)
+{
+	if ((Addr >= SIM_BASE) && (Addr < SIM_BASE + SIM_REGS * 4U)) {
+		return SimRegs[(Addr - SIM_BASE) / 4U];
+	}
+	return *(volatile u32 *)Addr;
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	if ((Addr >= SIM_BASE) && (Addr < SIM_BASE + SIM_REGS * 4U)) {
+		if (Addr == SIM_BASE + XAXIDMA_CR_OFFSET) {
+			CrWrites++;
+		}
+		SimRegs[(Addr - SIM_BASE) / 4U] = Value;
+		return;
+	}
+	*(volatile u32 *)Addr = Value;
+}
+
+/*****************************************************************************/
+/*
+* Packet threshold and delay timer in ns as currently programmed.
+*/
+static u32 SimThreshold(void)
+{
+	return (SimRegs[XAXIDMA_CR_OFFSET / 4U] & XAXIDMA_COALESCE_MASK) >>
+			XAXIDMA_COALESCE_SHIFT;
+}
+
+static u64 SimDelayNs(void)
+{
+	u32 Timer = (SimRegs[XAXIDMA_CR_OFFSET / 4U] & XAXIDMA_DELAY_MASK) >>
+			XAXIDMA_DELAY_SHIFT;
+
+	return (u64)Timer * XAXIDMA_COALESCE_TIMER_NS(SG_CLK_HZ);
+}
+
+/*****************************************************************************/
+/*
+* Raise the channel interrupt at Now and run the handler.
+*/
+static void SimIrq(u64 Now, Mode SimMode)
+{
+	PhaseStats *StatsPtr;
+	u64 Latency;
+	u32 Index;
+
+	Phase[(u32)(Now / 1000000000U) % MAX_PHASES].Irqs++;
+	for (Index = 0U; Index < NumPending; Index++) {
+		StatsPtr = &Phase[(u32)(PendingNs[Index] / 1000000000U) %
+				MAX_PHASES];
+		Latency = Now - PendingNs[Index];
+		StatsPtr->Bds++;
+		StatsPtr->LatencySumNs += Latency;
+		if (Latency > StatsPtr->LatencyMaxNs) {
+			StatsPtr->LatencyMaxNs = Latency;
+		}
+	}
+	if (SimMode == MODE_ADAPTIVE) {
+		XAxiDma_CoalesceIntr(&Coal, NumPending);
+	}
+	NumPending = 0U;
+}
+
+/*****************************************************************************/
+/*
+* Replay the trace once with the given coalescing mode and print the result.
+*/
+static void Replay(const char *Name, Mode SimMode)
+{
+	XAxiDma_CoalesceConfig Cfg;
+	u64 NextTick = (u64)TICK_US * 1000U;
+	u64 Deadline = 0U;
+	u64 ResetAt = (SimMode == MODE_ADAPTIVE) ? (u64)RESET_US * 1000U : 0U;
+	u64 Now;
+	u32 LastPhase;
+	u32 Index;
+	u32 Bd;
+	int Status = XST_SUCCESS;
+
+	memset(SimRegs, 0, sizeof(SimRegs));
+	memset(Phase, 0, sizeof(Phase));
+	/* Reset value of the control register: threshold 1, timer off */
+	SimRegs[XAXIDMA_CR_OFFSET / 4U] = 1U << XAXIDMA_COALESCE_SHIFT;
+	CrWrites = 0U;
+	NumPending = 0U;
+	Ring.ChanBase = SIM_BASE;
+
+	switch (SimMode) {
+	case MODE_FIXED_1:
+		Status = XAxiDma_BdRingSetCoalesce(&Ring, 1U, 0U);
+		break;
+	case MODE_FIXED_32:
+		/* Timer matched to the latency target */
+		Status = XAxiDma_BdRingSetCoalesce(&Ring, 32U,
+				(LATENCY_US * 1000U) /
+				XAXIDMA_COALESCE_TIMER_NS(SG_CLK_HZ));
+		break;
+	case MODE_ADAPTIVE:
+		Cfg.TargetLatencyUs = LATENCY_US;
+		Cfg.TargetIrqRate = 0U;
+		Cfg.TimerPeriodNs = XAXIDMA_COALESCE_TIMER_NS(SG_CLK_HZ);
+		Cfg.MinCounter = 1U;
+		Cfg.MaxCounter = 64U;
+		Status = XAxiDma_CoalesceInitialize(&Coal, &Ring, &Cfg);
+		break;
+	}
+	if (Status != XST_SUCCESS) {
+		printf("%s: setup failed\n", Name);
+		exit(1);
+	}
+
+	for (Index = 0U; Index <= NumEvents; Index++) {
+		/* Time of the next completion, or drain the rest at the end */
+		Now = (Index < NumEvents) ? (u64)Events[Index].TimeUs * 1000U :
+				NextTick + (u64)TICK_US * 1000U;
+
+		/* Delay timer interrupts and ticks before the completion */
+		for (;;) {
+			if ((NumPending != 0U) && (Deadline != 0U) &&
+					(Deadline <= Now) &&
+					(Deadline <= NextTick)) {
+				SimIrq(Deadline, SimMode);
+				Deadline = 0U;
+			}
+			else if ((ResetAt != 0U) && (ResetAt <= Now) &&
+					(ResetAt < NextTick)) {
+				/* Reset clears the control register */
+				SimRegs[XAXIDMA_CR_OFFSET / 4U] =
+					1U << XAXIDMA_COALESCE_SHIFT;
+				XAxiDma_CoalesceInvalidate(&Coal);
+				ResetAt = 0U;
+			}
+			else if (NextTick <= Now) {
+				if (SimMode == MODE_ADAPTIVE) {
+					XAxiDma_CoalesceSample(&Coal, TICK_US);
+					if (SimThreshold() != Coal.Counter) {
+						printf("%s: threshold %u, "
+							"controller %u\n",
+							Name, SimThreshold(),
+							Coal.Counter);
+						exit(1);
+					}
+				}
+				NextTick += (u64)TICK_US * 1000U;
+			}
+			else {
+				break;
+			}
+		}
+		if (Index == NumEvents) {
+			break;
+		}
+
+		for (Bd = 0U; Bd < Events[Index].NumBd; Bd++) {
+			PendingNs[NumPending++] = Now;
+			if (NumPending >= SimThreshold()) {
+				SimIrq(Now, SimMode);
+			}
+		}
+		/* The delay timer restarts with every completion */
+		Deadline = ((NumPending != 0U) && (SimDelayNs() != 0U)) ?
+				Now + SimDelayNs() : 0U;
+	}
+
+	LastPhase = (Events[NumEvents - 1U].TimeUs / 1000000U) % MAX_PHASES;
+	for (Index = 0U; Index <= LastPhase; Index++) {
+		printf("%-12s %5u %9u %9u %10.1f %10.1f\n", Name, Index,
+			Phase[Index].Bds, Phase[Index].Irqs,
+			Phase[Index].Bds ? (double)Phase[Index].LatencySumNs /
+				Phase[Index].Bds / 1000.0 : 0.0,
+			(double)Phase[Index].LatencyMaxNs / 1000.0);
+	}
+	printf("%-12s %u control register writes\n", Name, CrWrites);
+}
+
+/*****************************************************************************/
+/*
+* Append Count completions of one BD, Step us apart, starting at Start us.
+*/
+static void AddEvents(u32 Start, u32 Step, u32 Count)
+{
+	u32 Index;
+
+	for (Index = 0U; (Index < Count) && (NumEvents < MAX_EVENTS);
+			Index++) {
+		Events[NumEvents].TimeUs = Start + Index * Step;
+		Events[NumEvents].NumBd = 1U;
+		NumEvents++;
+	}
+}
+
+static void BuildSyntheticTrace(void)
+{
+	u32 Burst;
+
+	AddEvents(0U, 1000U, 1000U);
+	AddEvents(1000000U, 10U, 100000U);
+	for (Burst = 0U; Burst < 200U; Burst++) {
+		AddEvents(2000000U + Burst * 5000U, 10U, 32U);
+	}
+	AddEvents(3000000U, 1000U, 1000U);
+}
+
+static void LoadTrace(const char *Path)
+{
+	FILE *File = fopen(Path, "r");
+	unsigned int TimeUs;
+	unsigned int NumBd;
+
+	if (File == NULL) {
+		perror(Path);
+		exit(1);
+	}
+	while ((NumEvents < MAX_EVENTS) &&
+			(fscanf(File, "%u %u", &TimeUs, &NumBd) == 2)) {
+		Events[NumEvents].TimeUs = TimeUs;
+		Events[NumEvents].NumBd = NumBd;
+		NumEvents++;
+	}
+	fclose(File);
+}
+
+int main(int argc, char *argv[])
+{
+	Events = malloc(MAX_EVENTS * sizeof(Event));
+	if (Events == NULL) {
+		return 1;
+	}
+	if (argc > 1) {
+		LoadTrace(argv[1]);
+	}
+	else {
+		BuildSyntheticTrace();
+	}
+	if (NumEvents == 0U) {
+		printf("empty trace\n");
+		return 1;
+	}
+
+	printf("%-12s %5s %9s %9s %10s %10s\n", "mode", "sec", "bds",
+		"irqs", "mean us", "max us");
+	Replay("fixed-1", MODE_FIXED_1);
+	Replay("fixed-32", MODE_FIXED_32);
+	Replay("adaptive", MODE_ADAPTIVE);
+
+	free(Events);
+	return 0;
+}
@@ -0,0 +1,853 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxidma_stream_sim.c
+*
+* Host test and benchmark of the BD ring streaming layer against a model of
+* the scatter gather engine.
+*
+* The model keeps the control, status, current and tail descriptor registers
+* of the MM2S channel and of up to four S2MM channels (TDEST 0 to 3). Once a
+* channel runs it follows the next descriptor pointers of the BDs from the
+* current descriptor until it has completed the tail descriptor, and resumes
+* when a new tail is written. A received packet goes into the buffer of the
+* next BD of its channel, which is completed with the length and the SOF and
+* EOF bits; without a BD the packet is dropped. Submitted transmit BDs are
+* completed when the tail is written. The BDs and buffers live in memory
+* below 4 GB so that the 32-bit descriptor pointers reach them.
+*
+* Each round the model receives a burst of 1 to 32 packets spread over the
+* channels, the software polls the receive rings, submits 1 to 8 packets
+* and polls the transmit ring. Every packet carries its channel, length and
+* per channel sequence number. The same rounds are run with:
+*  - a per BD loop as in the lwIP adapters: one cache invalidate per buffer,
+*    and each reclaimed BD re-armed and given to hardware on its own, one
+*    transmit packet per submission,
+*  - the streaming layer with completion handlers,
+*  - the streaming layer with completion queues,
+* and all three again with four channels (multichannel mode, TDEST and TID
+* set on the transmit BDs).
+*
+* For each run the host time spent in the software per packet, the tail
+* pointer writes and the cache maintenance calls per packet are printed.
+* The checks are that no packet is dropped, that every packet is received
+* once, in order, on the ring of its channel and with its length, that the
+* transmit BDs carry SOF, EOF, the length and the TDEST/TID of their packet,
+* and that every transmit packet is completed.
+*
+* Usage: xaxidma_stream_sim [rounds] [seed]
+*
+* The defaults are 200000 and 1.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 9.3        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "xaxidma_stream.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE	0x40400000U	/* Simulated DMA registers */
+#define SIM_REG_BYTES	0x200U
+#define SIM_MAX_CHAN	4
+
+#define SIM_RX_BDS	128		/* BDs per receive ring */
+#define SIM_TX_BDS	128
+#define SIM_BUF_SIZE	2048U
+#define SIM_TX_BUFS	256U
+#define SIM_QUEUE_SIZE	256U
+#define SIM_MAX_BURST	32U
+#define SIM_MAX_SUBMIT	8U
+#define SIM_MIN_LEN	64U
+#define SIM_MAX_LEN	1514U
+
+#define SIM_PER_BD	0	/* Software modes */
+#define SIM_HANDLER	1
+#define SIM_QUEUE	2
+
+/**************************** Type Definitions *******************************/
+
+/* One channel of the engine */
+typedef struct {
+	u32 CDescOffset;	/* Register offsets from SIM_BASE */
+	u32 TDescOffset;
+	u32 SrOffset;
+	u32 Next;		/* Next BD to fetch, 0 before the first tail */
+	u32 Tail;
+	int Idle;		/* The tail BD has been completed */
+} SimChan;
+
+typedef struct {
+	const char *Name;
+	int NumChan;
+	int Mode;
+} SimRunCfg;
+
+typedef struct {
+	u64 RxNs;
+	u64 TxNs;
+	u32 RxPackets;
+	u32 TxPackets;
+	u32 TailWrites;
+	u32 CacheCalls;
+	u64 CacheBytes;
+} SimResult;
+
+/************************** Variable Definitions *****************************/
+
+static u32 SimRegs[SIM_REG_BYTES / 4U];
+static SimChan TxChan;
+static SimChan RxChan[SIM_MAX_CHAN];
+static int NumChan;
+
+static u8 *Mem;
+static UINTPTR TxBdSpace;
+static UINTPTR RxBdSpace[SIM_MAX_CHAN];
+static UINTPTR TxBufBase;
+static UINTPTR RxBufBase[SIM_MAX_CHAN];
+static u32 RxBdBytes;
+static u32 TxBdBytes;
+
+static XAxiDma Dma;
+static XAxiDma_Stream Stream;
+static XAxiDma_StreamQueue RxQueue;
+static XAxiDma_StreamQueue TxQueue;
+static XAxiDma_StreamCompletion RxEntries[SIM_QUEUE_SIZE];
+static XAxiDma_StreamCompletion TxEntries[SIM_QUEUE_SIZE];
+
+static u32 HwRxSeq[SIM_MAX_CHAN];	/* Next sequence number sent */
+static u32 SwRxSeq[SIM_MAX_CHAN];	/* Next sequence number expected */
+static u32 HwTxSeq;			/* Next transmit packet expected */
+static u32 SwTxSeq;			/* Next transmit packet submitted */
+static u32 TxCompleted;
+
+static u32 RxDropped;
+static u32 RxErrors;
+static u32 TxErrors;
+static u32 SgErrors;
+static u32 BadAccesses;
+static SimResult Result;
+static u32 Failed;
+
+static unsigned long long Seed = 1U;
+
+/*****************************************************************************/
+
+static u32 SimRand(u32 Range)
+{
+	Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (u32)((Seed >> 33) % Range);
+}
+
+static void Check(int Cond, const char *What)
+{
+	if (!Cond) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+static u64 NowNs(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return (u64)Ts.tv_sec * 1000000000ULL + (u64)Ts.tv_nsec;
+}
+
+static u32 BdWord(u32 Bd, u32 Offset)
+{
+	return *(volatile u32 *)(UINTPTR)(Bd + Offset);
+}
+
+static void BdSetWord(u32 Bd, u32 Offset, u32 Value)
+{
+	*(volatile u32 *)(UINTPTR)(Bd + Offset) = Value;
+}
+
+/*
+* Cache maintenance is counted, the host is coherent.
+*/
+void Xil_DCacheFlushRange(UINTPTR Addr, u32 Len)
+{
+	(void)Addr;
+	Result.CacheCalls++;
+	Result.CacheBytes += Len;
+}
+
+void Xil_DCacheInvalidateRange(UINTPTR Addr, u32 Len)
+{
+	(void)Addr;
+	Result.CacheCalls++;
+	Result.CacheBytes += Len;
+}
+
+static void SimReset(void)
+{
+	int Index;
+
+	memset(SimRegs, 0, sizeof(SimRegs));
+	SimRegs[TxChan.SrOffset / 4U] = XAXIDMA_HALTED_MASK;
+	SimRegs[RxChan[0].SrOffset / 4U] = XAXIDMA_HALTED_MASK;
+	TxChan.Next = TxChan.Tail = 0U;
+	TxChan.Idle = 0;
+	for (Index = 0; Index < SIM_MAX_CHAN; Index++) {
+		RxChan[Index].Next = 0U;
+		RxChan[Index].Tail = 0U;
+		RxChan[Index].Idle = 0;
+	}
+}
+
+static void SimInitChannels(void)
+{
+	int Index;
+
+	TxChan.SrOffset = XAXIDMA_TX_OFFSET + XAXIDMA_SR_OFFSET;
+	TxChan.CDescOffset = XAXIDMA_TX_OFFSET + XAXIDMA_CDESC_OFFSET;
+	TxChan.TDescOffset = XAXIDMA_TX_OFFSET + XAXIDMA_TDESC_OFFSET;
+	for (Index = 0; Index < SIM_MAX_CHAN; Index++) {
+		RxChan[Index].SrOffset = XAXIDMA_RX_OFFSET + XAXIDMA_SR_OFFSET;
+		if (Index == 0) {
+			RxChan[Index].CDescOffset = XAXIDMA_RX_OFFSET +
+						XAXIDMA_CDESC_OFFSET;
+			RxChan[Index].TDescOffset = XAXIDMA_RX_OFFSET +
+						XAXIDMA_TDESC_OFFSET;
+		} else {
+			RxChan[Index].CDescOffset = XAXIDMA_RX_OFFSET +
+				XAXIDMA_RX_CDESC0_OFFSET +
+				(u32)(Index - 1) * XAXIDMA_RX_NDESC_OFFSET;
+			RxChan[Index].TDescOffset = XAXIDMA_RX_OFFSET +
+				XAXIDMA_RX_TDESC0_OFFSET +
+				(u32)(Index - 1) * XAXIDMA_RX_NDESC_OFFSET;
+		}
+	}
+}
+
+/*
+* Next BD the channel may process, 0 if it has none.
+*/
+static u32 SimChanTake(SimChan *Chan)
+{
+	if ((SimRegs[Chan->SrOffset / 4U] & XAXIDMA_HALTED_MASK) != 0U ||
+			Chan->Next == 0U || Chan->Idle) {
+		return 0U;
+	}
+	if ((BdWord(Chan->Next, XAXIDMA_BD_STS_OFFSET) &
+			XAXIDMA_BD_STS_COMPLETE_MASK) != 0U) {
+		/* The engine would stop with an SG internal error */
+		SgErrors++;
+		return 0U;
+	}
+	return Chan->Next;
+}
+
+static void SimChanDone(SimChan *Chan, u32 Bd)
+{
+	Chan->Idle = (Bd == Chan->Tail);
+	Chan->Next = BdWord(Bd, XAXIDMA_BD_NDESC_OFFSET) &
+			XAXIDMA_DESC_LSB_MASK;
+}
+
+/*
+* Complete all transmit BDs up to the tail, checking each against the header
+* the software wrote into its buffer.
+*/
+static void SimHwTx(void)
+{
+	u32 Bd;
+	u32 Ctrl;
+	u32 Len;
+	u32 *Buf;
+
+	while ((Bd = SimChanTake(&TxChan)) != 0U) {
+		Ctrl = BdWord(Bd, XAXIDMA_BD_CTRL_LEN_OFFSET);
+		Len = Ctrl & Dma.TxBdRing.MaxTransferLen;
+		Buf = (u32 *)(UINTPTR)BdWord(Bd, XAXIDMA_BD_BUFA_OFFSET);
+		if ((Ctrl & XAXIDMA_BD_CTRL_TXSOF_MASK) == 0U ||
+				(Ctrl & XAXIDMA_BD_CTRL_TXEOF_MASK) == 0U ||
+				Buf[0] != HwTxSeq || Buf[2] != Len) {
+			TxErrors++;
+		}
+		if (NumChan > 1 && (BdWord(Bd, XAXIDMA_BD_MCCTL_OFFSET) !=
+				((Buf[1] << XAXIDMA_BD_TDEST_FIELD_SHIFT) |
+				 ((HwTxSeq & 0xFU) <<
+				  XAXIDMA_BD_TID_FIELD_SHIFT)))) {
+			TxErrors++;
+		}
+		HwTxSeq++;
+		BdSetWord(Bd, XAXIDMA_BD_STS_OFFSET,
+			XAXIDMA_BD_STS_COMPLETE_MASK | Len);
+		SimChanDone(&TxChan, Bd);
+	}
+}
+
+/*
+* Receive a burst of packets on random channels.
+*/
+static void SimHwRx(u32 Count)
+{
+	u32 Index;
+	u32 Ch;
+	u32 Bd;
+	u32 Len;
+	u32 *Buf;
+
+	for (Index = 0U; Index < Count; Index++) {
+		Ch = SimRand((u32)NumChan);
+		Len = SIM_MIN_LEN + SimRand(SIM_MAX_LEN - SIM_MIN_LEN + 1U);
+		Bd = SimChanTake(&RxChan[Ch]);
+		if (Bd == 0U) {
+			RxDropped++;
+			continue;
+		}
+		Buf = (u32 *)(UINTPTR)BdWord(Bd, XAXIDMA_BD_BUFA_OFFSET);
+		Buf[0] = HwRxSeq[Ch]++;
+		Buf[1] = Ch;
+		Buf[2] = Len;
+		BdSetWord(Bd, XAXIDMA_BD_STS_OFFSET,
+			XAXIDMA_BD_STS_COMPLETE_MASK |
+			XAXIDMA_BD_STS_RXSOF_MASK |
+			XAXIDMA_BD_STS_RXEOF_MASK | Len);
+		SimChanDone(&RxChan[Ch], Bd);
+	}
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	if (Addr < SIM_BASE || Addr >= SIM_BASE + SIM_REG_BYTES) {
+		BadAccesses++;
+		return 0U;
+	}
+	return SimRegs[(Addr - SIM_BASE) / 4U];
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset;
+	SimChan *Chan = NULL;
+	int Index;
+
+	if (Addr < SIM_BASE || Addr >= SIM_BASE + SIM_REG_BYTES) {
+		BadAccesses++;
+		return;
+	}
+	Offset = (u32)(Addr - SIM_BASE);
+
+	if (Offset == XAXIDMA_TX_OFFSET + XAXIDMA_CR_OFFSET ||
+			Offset == XAXIDMA_RX_OFFSET + XAXIDMA_CR_OFFSET) {
+		if ((Value & XAXIDMA_CR_RESET_MASK) != 0U) {
+			/* Reset completes at once and stops both channels */
+			SimReset();
+			return;
+		}
+		SimRegs[Offset / 4U] = Value;
+		if ((Value & XAXIDMA_CR_RUNSTOP_MASK) != 0U) {
+			SimRegs[(Offset + XAXIDMA_SR_OFFSET) / 4U] &=
+						~XAXIDMA_HALTED_MASK;
+		}
+		return;
+	}
+
+	SimRegs[Offset / 4U] = Value;
+
+	if (Offset == TxChan.TDescOffset) {
+		Chan = &TxChan;
+	}
+	for (Index = 0; Index < NumChan; Index++) {
+		if (Offset == RxChan[Index].TDescOffset) {
+			Chan = &RxChan[Index];
+		}
+	}
+	if (Chan != NULL) {
+		Result.TailWrites++;
+		Chan->Tail = Value;
+		Chan->Idle = 0;
+		if (Chan->Next == 0U) {
+			Chan->Next = SimRegs[Chan->CDescOffset / 4U];
+		}
+	}
+}
+
+/*
+* Check a received packet against its header and the ring it arrived on.
+*/
+static void SimRxPacket(int RingIndex, UINTPTR BufAddr, u32 Length,
+			u32 Status)
+{
+	u32 *Buf = (u32 *)BufAddr;
+
+	if (BufAddr < RxBufBase[RingIndex] || BufAddr >= RxBufBase[RingIndex] +
+			(UINTPTR)SIM_RX_BDS * SIM_BUF_SIZE ||
+			(Status & XAXIDMA_BD_STS_RXEOF_MASK) == 0U ||
+			Buf[1] != (u32)RingIndex ||
+			Buf[0] != SwRxSeq[RingIndex] || Buf[2] != Length) {
+		RxErrors++;
+	}
+	SwRxSeq[RingIndex]++;
+	Result.RxPackets++;
+}
+
+static void RxHandler(void *CallBackRef,
+			const XAxiDma_StreamCompletion *CompPtr)
+{
+	(void)CallBackRef;
+	SimRxPacket(CompPtr->RingIndex, CompPtr->BufAddr, CompPtr->Length,
+			CompPtr->Status);
+}
+
+static void TxHandler(void *CallBackRef,
+			const XAxiDma_StreamCompletion *CompPtr)
+{
+	(void)CallBackRef;
+	(void)CompPtr;
+	TxCompleted++;
+}
+
+static UINTPTR SimTxBuf(u32 Seq, u32 *LenPtr, u32 *ChPtr)
+{
+	u32 *Buf = (u32 *)(TxBufBase + (UINTPTR)(Seq % SIM_TX_BUFS) *
+				SIM_BUF_SIZE);
+
+	*LenPtr = SIM_MIN_LEN + SimRand(SIM_MAX_LEN - SIM_MIN_LEN + 1U);
+	*ChPtr = SimRand((u32)NumChan);
+	Buf[0] = Seq;
+	Buf[1] = *ChPtr;
+	Buf[2] = *LenPtr;
+	return (UINTPTR)Buf;
+}
+
+/*****************************************************************************/
+/*
+* The per BD loop.
+*/
+static int PerBdSetup(void)
+{
+	XAxiDma_BdRing *RingPtr;
+	XAxiDma_Bd BdTemplate;
+	XAxiDma_Bd *BdPtr;
+	XAxiDma_Bd *BdCurPtr;
+	UINTPTR BufAddr;
+	int Ch;
+	int Index;
+	int Status;
+
+	RingPtr = XAxiDma_GetTxRing(&Dma);
+	Status = XAxiDma_BdRingCreate(RingPtr, TxBdSpace, TxBdSpace,
+				XAXIDMA_BD_MINIMUM_ALIGNMENT, SIM_TX_BDS);
+	XAxiDma_BdClear(&BdTemplate);
+	Status |= XAxiDma_BdRingClone(RingPtr, &BdTemplate);
+	Status |= XAxiDma_BdRingStart(RingPtr);
+
+	for (Ch = 0; Ch < NumChan; Ch++) {
+		RingPtr = XAxiDma_GetRxIndexRing(&Dma, Ch);
+		Status |= XAxiDma_BdRingCreate(RingPtr, RxBdSpace[Ch],
+				RxBdSpace[Ch], XAXIDMA_BD_MINIMUM_ALIGNMENT,
+				SIM_RX_BDS);
+		Status |= XAxiDma_BdRingClone(RingPtr, &BdTemplate);
+		Status |= XAxiDma_BdRingAlloc(RingPtr, SIM_RX_BDS, &BdPtr);
+		BdCurPtr = BdPtr;
+		for (Index = 0; Index < SIM_RX_BDS; Index++) {
+			BufAddr = RxBufBase[Ch] + (UINTPTR)Index * SIM_BUF_SIZE;
+			Status |= XAxiDma_BdSetBufAddr(BdCurPtr, BufAddr);
+			Status |= XAxiDma_BdSetLength(BdCurPtr, SIM_BUF_SIZE,
+						RingPtr->MaxTransferLen);
+			XAxiDma_BdSetCtrl(BdCurPtr, 0);
+			XAxiDma_BdSetId(BdCurPtr, BufAddr);
+			Xil_DCacheInvalidateRange(BufAddr, SIM_BUF_SIZE);
+			BdCurPtr = (XAxiDma_Bd *)XAxiDma_BdRingNext(RingPtr,
+								BdCurPtr);
+		}
+		Status |= XAxiDma_BdRingToHw(RingPtr, SIM_RX_BDS, BdPtr);
+	}
+
+	/*
+	 * The receive channels share the run/stop bit, so all current
+	 * descriptors are set before the first one starts.
+	 */
+	for (Ch = 0; Ch < NumChan; Ch++) {
+		Status |= XAxiDma_UpdateBdRingCDesc(
+				XAxiDma_GetRxIndexRing(&Dma, Ch));
+	}
+	for (Ch = 0; Ch < NumChan; Ch++) {
+		Status |= XAxiDma_StartBdRingHw(
+				XAxiDma_GetRxIndexRing(&Dma, Ch));
+	}
+	return Status;
+}
+
+static void PerBdRxPoll(void)
+{
+	XAxiDma_BdRing *RingPtr;
+	XAxiDma_Bd *BdPtr;
+	XAxiDma_Bd *BdCurPtr;
+	UINTPTR BufAddr;
+	int NumBd;
+	int Ch;
+	int Index;
+
+	for (Ch = 0; Ch < NumChan; Ch++) {
+		RingPtr = XAxiDma_GetRxIndexRing(&Dma, Ch);
+		NumBd = XAxiDma_BdRingFromHw(RingPtr, XAXIDMA_ALL_BDS, &BdPtr);
+		BdCurPtr = BdPtr;
+		for (Index = 0; Index < NumBd; Index++) {
+			BufAddr = (UINTPTR)XAxiDma_BdGetId(BdCurPtr);
+			Xil_DCacheInvalidateRange(BufAddr, SIM_BUF_SIZE);
+			SimRxPacket(Ch, BufAddr,
+				XAxiDma_BdGetActualLength(BdCurPtr,
+						RingPtr->MaxTransferLen),
+				XAxiDma_BdGetSts(BdCurPtr));
+			BdCurPtr = (XAxiDma_Bd *)XAxiDma_BdRingNext(RingPtr,
+								BdCurPtr);
+		}
+		if (NumBd > 0) {
+			(void)XAxiDma_BdRingFree(RingPtr, NumBd, BdPtr);
+		}
+
+		/* Re-arm one BD at a time */
+		NumBd = XAxiDma_BdRingGetFreeCnt(RingPtr);
+		for (Index = 0; Index < NumBd; Index++) {
+			if (XAxiDma_BdRingAlloc(RingPtr, 1, &BdPtr) !=
+					XST_SUCCESS) {
+				RxErrors++;
+				break;
+			}
+			BufAddr = (UINTPTR)XAxiDma_BdGetId(BdPtr);
+			(void)XAxiDma_BdSetBufAddr(BdPtr, BufAddr);
+			(void)XAxiDma_BdSetLength(BdPtr, SIM_BUF_SIZE,
+						RingPtr->MaxTransferLen);
+			XAxiDma_BdSetCtrl(BdPtr, 0);
+			Xil_DCacheInvalidateRange(BufAddr, SIM_BUF_SIZE);
+			if (XAxiDma_BdRingToHw(RingPtr, 1, BdPtr) !=
+					XST_SUCCESS) {
+				RxErrors++;
+			}
+		}
+	}
+}
+
+static void PerBdTxSubmit(u32 Count)
+{
+	XAxiDma_BdRing *RingPtr = XAxiDma_GetTxRing(&Dma);
+	XAxiDma_Bd *BdPtr;
+	UINTPTR BufAddr;
+	u32 Len;
+	u32 Ch;
+	u32 Index;
+
+	for (Index = 0U; Index < Count; Index++) {
+		BufAddr = SimTxBuf(SwTxSeq, &Len, &Ch);
+		if (XAxiDma_BdRingAlloc(RingPtr, 1, &BdPtr) != XST_SUCCESS) {
+			TxErrors++;
+			return;
+		}
+		(void)XAxiDma_BdSetBufAddr(BdPtr, BufAddr);
+		(void)XAxiDma_BdSetLength(BdPtr, Len, RingPtr->MaxTransferLen);
+		XAxiDma_BdSetCtrl(BdPtr, XAXIDMA_BD_CTRL_TXSOF_MASK |
+					XAXIDMA_BD_CTRL_TXEOF_MASK);
+		XAxiDma_BdSetId(BdPtr, BufAddr);
+		if (NumChan > 1) {
+			XAxiDma_BdSetTDest(BdPtr, Ch);
+			XAxiDma_BdSetTId(BdPtr, SwTxSeq & 0xFU);
+		}
+		Xil_DCacheFlushRange(BufAddr, Len);
+		if (XAxiDma_BdRingToHw(RingPtr, 1, BdPtr) != XST_SUCCESS) {
+			TxErrors++;
+		}
+		SwTxSeq++;
+	}
+}
+
+static void PerBdTxPoll(void)
+{
+	XAxiDma_BdRing *RingPtr = XAxiDma_GetTxRing(&Dma);
+	XAxiDma_Bd *BdPtr;
+	int NumBd;
+
+	NumBd = XAxiDma_BdRingFromHw(RingPtr, XAXIDMA_ALL_BDS, &BdPtr);
+	if (NumBd > 0) {
+		TxCompleted += (u32)NumBd;
+		(void)XAxiDma_BdRingFree(RingPtr, NumBd, BdPtr);
+	}
+}
+
+/*****************************************************************************/
+/*
+* The streaming layer.
+*/
+static int StreamSetup(int Mode)
+{
+	int Ch;
+	int Status;
+
+	Status = XAxiDma_StreamInitialize(&Stream, &Dma);
+	if (Mode == SIM_QUEUE) {
+		Status |= XAxiDma_StreamQueueInit(&RxQueue, RxEntries,
+						SIM_QUEUE_SIZE);
+		Status |= XAxiDma_StreamQueueInit(&TxQueue, TxEntries,
+						SIM_QUEUE_SIZE);
+		XAxiDma_StreamSetRxQueue(&Stream, &RxQueue);
+		XAxiDma_StreamSetTxQueue(&Stream, &TxQueue);
+	} else {
+		XAxiDma_StreamSetRxHandler(&Stream, RxHandler, NULL);
+		XAxiDma_StreamSetTxHandler(&Stream, TxHandler, NULL);
+	}
+	for (Ch = 0; Ch < NumChan; Ch++) {
+		Status |= XAxiDma_StreamRxSetup(&Stream, Ch, RxBdSpace[Ch],
+				RxBdBytes, RxBufBase[Ch], SIM_BUF_SIZE);
+	}
+	Status |= XAxiDma_StreamTxSetup(&Stream, TxBdSpace, TxBdBytes);
+	Status |= XAxiDma_StreamStart(&Stream);
+	return Status;
+}
+
+static void StreamTxSubmit(u32 Count)
+{
+	XAxiDma_StreamBuf Bufs[SIM_MAX_SUBMIT];
+	u32 Ch;
+	u32 Index;
+
+	for (Index = 0U; Index < Count; Index++) {
+		Bufs[Index].BufAddr = SimTxBuf(SwTxSeq + Index,
+					&Bufs[Index].Length, &Ch);
+		Bufs[Index].TDest = (u8)Ch;
+		Bufs[Index].TId = (u8)((SwTxSeq + Index) & 0xFU);
+	}
+	if (XAxiDma_StreamTxSubmit(&Stream, Bufs, (int)Count) !=
+			XST_SUCCESS) {
+		TxErrors++;
+		return;
+	}
+	SwTxSeq += Count;
+}
+
+/* The consumer side of the completion queues */
+static void StreamDrainQueues(void)
+{
+	XAxiDma_StreamCompletion *CompPtr;
+
+	while ((CompPtr = XAxiDma_StreamQueuePeek(&RxQueue)) != NULL) {
+		SimRxPacket(CompPtr->RingIndex, CompPtr->BufAddr,
+				CompPtr->Length, CompPtr->Status);
+		XAxiDma_StreamQueueRelease(&RxQueue);
+	}
+	while (XAxiDma_StreamQueuePeek(&TxQueue) != NULL) {
+		TxCompleted++;
+		XAxiDma_StreamQueueRelease(&TxQueue);
+	}
+}
+
+/*****************************************************************************/
+
+static void Run(const SimRunCfg *Cfg, u32 Rounds)
+{
+	XAxiDma_Config DmaCfg;
+	u32 Round;
+	u32 Count;
+	u32 Packets;
+	u64 Start;
+	int Status;
+	int Ch;
+
+	memset(&DmaCfg, 0, sizeof(DmaCfg));
+	DmaCfg.BaseAddr = SIM_BASE;
+	DmaCfg.HasMm2S = 1;
+	DmaCfg.Mm2SDataWidth = 32;
+	DmaCfg.HasS2Mm = 1;
+	DmaCfg.S2MmDataWidth = 32;
+	DmaCfg.HasSg = 1;
+	DmaCfg.Mm2sNumChannels = Cfg->NumChan;
+	DmaCfg.S2MmNumChannels = Cfg->NumChan;
+	DmaCfg.Mm2SBurstSize = 16;
+	DmaCfg.S2MmBurstSize = 16;
+	DmaCfg.AddrWidth = 32;
+
+	NumChan = Cfg->NumChan;
+	memset(Mem, 0, (RxBdBytes * SIM_MAX_CHAN) + TxBdBytes);
+	memset(HwRxSeq, 0, sizeof(HwRxSeq));
+	memset(SwRxSeq, 0, sizeof(SwRxSeq));
+	HwTxSeq = SwTxSeq = TxCompleted = 0U;
+	RxDropped = RxErrors = TxErrors = SgErrors = BadAccesses = 0U;
+	SimReset();
+
+	Status = XAxiDma_CfgInitialize(&Dma, &DmaCfg);
+	if (Status == XST_SUCCESS) {
+		Status = Cfg->Mode == SIM_PER_BD ? PerBdSetup() :
+						StreamSetup(Cfg->Mode);
+	}
+	Check(Status == XST_SUCCESS, "setup");
+	if (Status != XST_SUCCESS) {
+		return;
+	}
+	memset(&Result, 0, sizeof(Result));
+
+	for (Round = 0U; Round < Rounds; Round++) {
+		SimHwRx(1U + SimRand(SIM_MAX_BURST));
+
+		Start = NowNs();
+		if (Cfg->Mode == SIM_PER_BD) {
+			PerBdRxPoll();
+		} else {
+			(void)XAxiDma_StreamRxPoll(&Stream);
+			if (Cfg->Mode == SIM_QUEUE) {
+				StreamDrainQueues();
+			}
+		}
+		Result.RxNs += NowNs() - Start;
+
+		Count = 1U + SimRand(SIM_MAX_SUBMIT);
+		Start = NowNs();
+		if (Cfg->Mode == SIM_PER_BD) {
+			PerBdTxSubmit(Count);
+		} else {
+			StreamTxSubmit(Count);
+		}
+		Result.TxNs += NowNs() - Start;
+
+		SimHwTx();
+
+		Start = NowNs();
+		if (Cfg->Mode == SIM_PER_BD) {
+			PerBdTxPoll();
+		} else {
+			(void)XAxiDma_StreamTxPoll(&Stream);
+			if (Cfg->Mode == SIM_QUEUE) {
+				StreamDrainQueues();
+			}
+		}
+		Result.TxNs += NowNs() - Start;
+		Result.TxPackets += Count;
+	}
+
+	Packets = Result.RxPackets + Result.TxPackets;
+	printf("%-26s %8.1f %8.1f %10.2f %10.2f %10.0f\n", Cfg->Name,
+		(double)Result.RxNs / Result.RxPackets,
+		(double)Result.TxNs / Result.TxPackets,
+		(double)Result.TailWrites / Packets,
+		(double)Result.CacheCalls / Packets,
+		(double)Result.CacheBytes / Packets);
+
+	Check(RxDropped == 0U, "no packet is dropped");
+	Check(RxErrors == 0U, "packets are received in order on their ring");
+	Check(TxErrors == 0U, "transmit BDs match their packets");
+	Check(SgErrors == 0U, "the engine never fetches a completed BD");
+	Check(BadAccesses == 0U, "only DMA registers are accessed");
+	Check(HwTxSeq == SwTxSeq && TxCompleted == SwTxSeq,
+		"every transmit packet is completed");
+	for (Ch = 0; Ch < NumChan; Ch++) {
+		Check(SwRxSeq[Ch] == HwRxSeq[Ch],
+			"every received packet is reported");
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	static const SimRunCfg Runs[] = {
+		{ "per BD loop",		1, SIM_PER_BD },
+		{ "stream, handlers",		1, SIM_HANDLER },
+		{ "stream, queues",		1, SIM_QUEUE },
+		{ "per BD loop, 4 ch",		4, SIM_PER_BD },
+		{ "stream, handlers, 4 ch",	4, SIM_HANDLER },
+		{ "stream, queues, 4 ch",	4, SIM_QUEUE },
+	};
+	u32 Rounds = 200000U;
+	u32 Index;
+	u32 MemBytes;
+	UINTPTR Addr;
+	unsigned long long RunSeed;
+
+	if (argc > 1) {
+		Rounds = (u32)strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		Seed = strtoull(argv[2], NULL, 0);
+	}
+
+	RxBdBytes = (u32)XAxiDma_BdRingMemCalc(XAXIDMA_BD_MINIMUM_ALIGNMENT,
+						SIM_RX_BDS);
+	TxBdBytes = (u32)XAxiDma_BdRingMemCalc(XAXIDMA_BD_MINIMUM_ALIGNMENT,
+						SIM_TX_BDS);
+	MemBytes = RxBdBytes * SIM_MAX_CHAN + TxBdBytes +
+		(SIM_MAX_CHAN * SIM_RX_BDS + SIM_TX_BUFS) * SIM_BUF_SIZE;
+
+	/* BD pointers and buffer addresses are 32 bits wide */
+	Mem = mmap(NULL, MemBytes, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (Mem == MAP_FAILED) {
+		printf("cannot map memory below 4 GB\n");
+		return 1;
+	}
+	Addr = (UINTPTR)Mem;
+	for (Index = 0U; Index < SIM_MAX_CHAN; Index++) {
+		RxBdSpace[Index] = Addr;
+		Addr += RxBdBytes;
+	}
+	TxBdSpace = Addr;
+	Addr += TxBdBytes;
+	for (Index = 0U; Index < SIM_MAX_CHAN; Index++) {
+		RxBufBase[Index] = Addr;
+		Addr += (UINTPTR)SIM_RX_BDS * SIM_BUF_SIZE;
+	}
+	TxBufBase = Addr;
+
+	SimInitChannels();
+	RunSeed = Seed;
+
+	printf("%u rounds of 1-%u received and 1-%u transmitted packets\n\n",
+		Rounds, SIM_MAX_BURST, SIM_MAX_SUBMIT);
+	printf("                           ns/rx    ns/tx  tail wr/pkt"
+		" cache/pkt cache B/pkt\n");
+	for (Index = 0U; Index < sizeof(Runs) / sizeof(Runs[0]); Index++) {
+		/* Every run sees the same packets */
+		Seed = RunSeed;
+		Run(&Runs[Index], Rounds);
+	}
+
+	printf("\n%s\n", Failed == 0U ? "all checks passed" : "CHECKS FAILED");
+	return Failed == 0U ? 0 : 1;
+}
@@ -0,0 +1,584 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxivdma_fb.c
+* @addtogroup axivdma_v6_0
+* @{
+*
+* Implementation of the frame-buffer manager. See xaxivdma_fb.h for the
+* usage and the handoff rules between the application and the interrupt
+* handler.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 6.2        10/18/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xaxivdma_fb.h"
+#include "xaxivdma_i.h"
+
+/************************** Function Prototypes ******************************/
+
+static void XAxiVdma_FbCallBack(void *CallBackRef, u32 InterruptTypes);
+static void XAxiVdma_FbPark(XAxiVdma_FrameBuf *FbPtr, u8 Frame);
+static u8 XAxiVdma_FbFindFree(XAxiVdma_FrameBuf *FbPtr, u8 Busy0, u8 Busy1,
+        u8 Busy2);
+static void XAxiVdma_FbPublish(XAxiVdma_FrameBuf *FbPtr, u8 Frame);
+
+/*****************************************************************************/
+/**
+ * Initialize a frame-buffer manager for one channel
+ *
+ * @param FbPtr is the pointer to the manager to initialize
+ * @param InstancePtr is the pointer to the DMA engine to work on
+ * @param Direction is the channel to manage, use XAXIVDMA_READ/WRITE
+ * @param FrameAddr is the array of frame store start addresses
+ * @param NumFrames is the number of entries in FrameAddr, between 3 and
+ *        XAXIVDMA_FB_MAX_FRAMES
+ *
+ * @return
+ * - XST_SUCCESS if the manager is initialized
+ * - XST_INVALID_PARAM if Direction or NumFrames is invalid
+ *
+ * @note
+ * The read channel starts parked on frame 0 and the write channel on the
+ * last frame, so that a genlocked pair does not start on the same store.
+ *****************************************************************************/
+int XAxiVdma_FbInitialize(XAxiVdma_FrameBuf *FbPtr, XAxiVdma *InstancePtr,
+        u16 Direction, const UINTPTR *FrameAddr, u8 NumFrames)
+{
+	int Index;
+
+	Xil_AssertNonvoid(FbPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XAXIVDMA_DEVICE_READY);
+	Xil_AssertNonvoid(FrameAddr != NULL);
+
+	if ((Direction != XAXIVDMA_READ) && (Direction != XAXIVDMA_WRITE)) {
+		return XST_INVALID_PARAM;
+	}
+
+	if ((NumFrames < 3) || (NumFrames > XAXIVDMA_FB_MAX_FRAMES)) {
+		xdbg_printf(XDBG_DEBUG_ERROR,
+		    "Invalid number of frame stores %d\r\n", NumFrames);
+
+		return XST_INVALID_PARAM;
+	}
+
+	FbPtr->InstancePtr = InstancePtr;
+	FbPtr->Direction = Direction;
+	FbPtr->NumFrames = NumFrames;
+
+	/* Unused entries point at frame 0, the channel is never parked there
+	 */
+	for (Index = 0; Index < XAXIVDMA_MAX_FRAMESTORE; Index++) {
+		FbPtr->FrameAddr[Index] = (Index < NumFrames) ?
+		    FrameAddr[Index] : FrameAddr[0];
+	}
+
+	FbPtr->HwFrame = (Direction == XAXIVDMA_READ) ? 0 : (NumFrames - 1);
+	FbPtr->CpuFrame = XAXIVDMA_FB_NONE;
+	FbPtr->ReadyFrame = XAXIVDMA_FB_NONE;
+	FbPtr->ReadySeq = 0;
+	FbPtr->TakenSeq = 0;
+	FbPtr->FrameCount = 0;
+	FbPtr->DroppedCount = 0;
+	FbPtr->RepeatedCount = 0;
+	FbPtr->GenlockPtr = NULL;
+	FbPtr->IsGenlocked = 0;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * Link a write channel manager to a read channel manager, so that every
+ * captured frame is queued for display by the write channel interrupt.
+ *
+ * @param WriteFbPtr is the pointer to the write channel manager
+ * @param ReadFbPtr is the pointer to the read channel manager
+ *
+ * @return
+ * - XST_SUCCESS if the managers are linked
+ * - XST_INVALID_PARAM if the directions are wrong or the two managers do
+ *   not own the same frame stores
+ *
+ * @note
+ * Call this before XAxiVdma_FbStart() on either manager. The CPU must not
+ * call XAxiVdma_FbAcquire() or XAxiVdma_FbRelease() on the read manager
+ * afterwards; it may still acquire captured frames from the write manager.
+ *****************************************************************************/
+int XAxiVdma_FbGenlock(XAxiVdma_FrameBuf *WriteFbPtr,
+        XAxiVdma_FrameBuf *ReadFbPtr)
+{
+	int Index;
+
+	Xil_AssertNonvoid(WriteFbPtr != NULL);
+	Xil_AssertNonvoid(ReadFbPtr != NULL);
+
+	if ((WriteFbPtr->Direction != XAXIVDMA_WRITE) ||
+	    (ReadFbPtr->Direction != XAXIVDMA_READ) ||
+	    (WriteFbPtr->NumFrames != ReadFbPtr->NumFrames)) {
+
+		return XST_INVALID_PARAM;
+	}
+
+	for (Index = 0; Index < WriteFbPtr->NumFrames; Index++) {
+		if (WriteFbPtr->FrameAddr[Index] !=
+		    ReadFbPtr->FrameAddr[Index]) {
+			xdbg_printf(XDBG_DEBUG_ERROR,
+			    "Frame store %d differs between channels\r\n",
+			    Index);
+
+			return XST_INVALID_PARAM;
+		}
+	}
+
+	WriteFbPtr->GenlockPtr = ReadFbPtr;
+	ReadFbPtr->IsGenlocked = 1;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * Start the channel in park mode under control of the manager
+ *
+ * This sets the frame store addresses, a frame count of 1, installs the
+ * general callback for the channel, enables the frame count interrupt, starts
+ * the channel and parks it on its initial frame.
+ *
+ * @param FbPtr is the pointer to the manager
+ *
+ * @return
+ * - XST_SUCCESS if the channel is running
+ * - XST_DEVICE_NOT_FOUND if the channel is not in the hardware
+ * - XST_INVALID_PARAM if the channel was configured with fewer frames
+ *   than the manager owns
+ * - Error code from the VDMA API that failed otherwise
+ *
+ * @note
+ * The channel must have been configured with XAxiVdma_DmaConfig(). If the
+ * frame count is not writable in this hardware build its reset value of 1
+ * is relied upon.
+ *****************************************************************************/
+int XAxiVdma_FbStart(XAxiVdma_FrameBuf *FbPtr)
+{
+	XAxiVdma_Channel *Channel;
+	int Status;
+
+	Xil_AssertNonvoid(FbPtr != NULL);
+	Xil_AssertNonvoid(FbPtr->InstancePtr != NULL);
+
+	Channel = XAxiVdma_GetChannel(FbPtr->InstancePtr, FbPtr->Direction);
+
+	if (!Channel->IsValid) {
+		return XST_DEVICE_NOT_FOUND;
+	}
+
+	if (FbPtr->NumFrames > Channel->NumFrames) {
+		return XST_INVALID_PARAM;
+	}
+
+	Status = XAxiVdma_DmaSetBufferAddr(FbPtr->InstancePtr,
+	    FbPtr->Direction, FbPtr->FrameAddr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	Status = XAxiVdma_ChannelSetFrmCnt(Channel, 1, 0);
+	if ((Status != XST_SUCCESS) && (Status != XST_NO_FEATURE)) {
+		return Status;
+	}
+
+	Status = XAxiVdma_SetCallBack(FbPtr->InstancePtr,
+	    XAXIVDMA_HANDLER_GENERAL, (void *)XAxiVdma_FbCallBack,
+	    (void *)FbPtr, FbPtr->Direction);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	XAxiVdma_IntrEnable(FbPtr->InstancePtr, XAXIVDMA_IXR_FRMCNT_MASK,
+	    FbPtr->Direction);
+
+	/* Set the park frame before the channel starts fetching
+	 */
+	XAxiVdma_FbPark(FbPtr, FbPtr->HwFrame);
+
+	Status = XAxiVdma_DmaStart(FbPtr->InstancePtr, FbPtr->Direction);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	return XAxiVdma_StartParking(FbPtr->InstancePtr, FbPtr->HwFrame,
+	    FbPtr->Direction);
+}
+
+/*****************************************************************************/
+/**
+ * Acquire a frame store for the CPU
+ *
+ * On the write channel this returns the newest captured frame, and releases
+ * the frame the CPU held before, if any. On the read channel this returns a
+ * store the CPU can render into, which is neither displayed nor queued.
+ *
+ * @param FbPtr is the pointer to the manager
+ * @param AddrPtr is where the start address of the frame store is returned
+ *
+ * @return
+ * - XST_SUCCESS if a frame store was acquired
+ * - XST_NO_DATA on the write channel if no frame was captured since the
+ *   last call
+ * - XST_DEVICE_BUSY on the read channel if the CPU already holds a store
+ *   or none is free
+ *
+ * @note
+ * The manager does no cache maintenance on the frame stores.
+ *****************************************************************************/
+int XAxiVdma_FbAcquire(XAxiVdma_FrameBuf *FbPtr, UINTPTR *AddrPtr)
+{
+	u32 Seq;
+	u8 Frame;
+	u8 Pending;
+
+	Xil_AssertNonvoid(FbPtr != NULL);
+	Xil_AssertNonvoid(AddrPtr != NULL);
+	Xil_AssertNonvoid(FbPtr->IsGenlocked == 0);
+
+	if (FbPtr->Direction == XAXIVDMA_WRITE) {
+		/* Claim the ready frame, then check it was not replaced in the
+		 * meantime. Once CpuFrame is set the interrupt handler will not
+		 * park on it.
+		 */
+		do {
+			Seq = FbPtr->ReadySeq;
+			if (Seq == FbPtr->TakenSeq) {
+				return XST_NO_DATA;
+			}
+
+			Frame = FbPtr->ReadyFrame;
+			FbPtr->CpuFrame = Frame;
+		} while (Seq != FbPtr->ReadySeq);
+
+		FbPtr->TakenSeq = Seq;
+	}
+	else {
+		if (FbPtr->CpuFrame != XAXIVDMA_FB_NONE) {
+			return XST_DEVICE_BUSY;
+		}
+
+		/* The queued frame must be sampled before the parked one: if
+		 * the interrupt handler takes it in between, it shows up as
+		 * the parked frame instead.
+		 */
+		Pending = (FbPtr->ReadySeq != FbPtr->TakenSeq) ?
+		    FbPtr->ReadyFrame : XAXIVDMA_FB_NONE;
+
+		Frame = XAxiVdma_FbFindFree(FbPtr, Pending, FbPtr->HwFrame,
+		    XAXIVDMA_FB_NONE);
+		if (Frame == XAXIVDMA_FB_NONE) {
+			return XST_DEVICE_BUSY;
+		}
+
+		FbPtr->CpuFrame = Frame;
+	}
+
+	*AddrPtr = FbPtr->FrameAddr[Frame];
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * Release the frame store held by the CPU
+ *
+ * On the write channel the store is handed back for capture. On the read
+ * channel it is queued for display from the next frame sync, replacing a
+ * queued frame that was not shown yet.
+ *
+ * @param FbPtr is the pointer to the manager
+ *
+ * @return
+ *  None
+ *
+ * @note
+ * Nothing is done if the CPU holds no store.
+ *****************************************************************************/
+void XAxiVdma_FbRelease(XAxiVdma_FrameBuf *FbPtr)
+{
+	u8 Frame;
+
+	Xil_AssertVoid(FbPtr != NULL);
+	Xil_AssertVoid(FbPtr->IsGenlocked == 0);
+
+	Frame = FbPtr->CpuFrame;
+	if (Frame == XAXIVDMA_FB_NONE) {
+		return;
+	}
+
+	if (FbPtr->Direction == XAXIVDMA_READ) {
+		XAxiVdma_FbPublish(FbPtr, Frame);
+	}
+
+	FbPtr->CpuFrame = XAXIVDMA_FB_NONE;
+}
+
+/*****************************************************************************/
+/**
+ * Advance the manager by one frame. This is called from the frame count
+ * interrupt of the channel by the callback installed by XAxiVdma_FbStart();
+ * applications that install their own general callback call it from there
+ * instead.
+ *
+ * @param FbPtr is the pointer to the manager
+ *
+ * @return
+ *  None
+ *
+ * @note
+ * Must not be called concurrently with itself or with the handler of a
+ * genlocked manager.
+ *****************************************************************************/
+void XAxiVdma_FbFrameDone(XAxiVdma_FrameBuf *FbPtr)
+{
+	XAxiVdma_FrameBuf *ReadFbPtr;
+	u32 Seq;
+	u8 Completed;
+	u8 Next;
+	u8 Frame;
+
+	Xil_AssertVoid(FbPtr != NULL);
+	Xil_AssertVoid(FbPtr->InstancePtr != NULL);
+	Xil_AssertVoid((FbPtr->Direction == XAXIVDMA_READ) ||
+	    (FbPtr->Direction == XAXIVDMA_WRITE));
+
+	FbPtr->FrameCount++;
+
+	if (FbPtr->Direction == XAXIVDMA_WRITE) {
+		ReadFbPtr = FbPtr->GenlockPtr;
+		Completed = FbPtr->HwFrame;
+
+		Next = XAxiVdma_FbFindFree(FbPtr, Completed, FbPtr->CpuFrame,
+		    (ReadFbPtr != NULL) ? ReadFbPtr->HwFrame :
+		    XAXIVDMA_FB_NONE);
+		if (Next == XAXIVDMA_FB_NONE) {
+			/* Nowhere else to go, the frame will be overwritten
+			 */
+			FbPtr->DroppedCount++;
+			return;
+		}
+
+		XAxiVdma_FbPark(FbPtr, Next);
+
+		if (ReadFbPtr != NULL) {
+			XAxiVdma_FbPublish(ReadFbPtr, Completed);
+
+			FbPtr->ReadyFrame = Completed;
+			FbPtr->ReadySeq++;
+		}
+		else {
+			XAxiVdma_FbPublish(FbPtr, Completed);
+		}
+	}
+	else {
+		Seq = FbPtr->ReadySeq;
+		if (Seq == FbPtr->TakenSeq) {
+			FbPtr->RepeatedCount++;
+			return;
+		}
+
+		Frame = FbPtr->ReadyFrame;
+		FbPtr->TakenSeq = Seq;
+
+		if (Frame != FbPtr->HwFrame) {
+			XAxiVdma_FbPark(FbPtr, Frame);
+		}
+		else {
+			FbPtr->RepeatedCount++;
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+ * Get the frame statistics of the manager
+ *
+ * @param FbPtr is the pointer to the manager
+ * @param FramesPtr is where the number of frames handled is returned
+ * @param DroppedPtr is where the number of dropped frames is returned
+ * @param RepeatedPtr is where the number of repeated frames is returned,
+ *        always 0 for the write channel
+ *
+ * @return
+ *  None
+ *
+ *****************************************************************************/
+void XAxiVdma_FbGetStats(XAxiVdma_FrameBuf *FbPtr, u32 *FramesPtr,
+        u32 *DroppedPtr, u32 *RepeatedPtr)
+{
+	Xil_AssertVoid(FbPtr != NULL);
+
+	if (FramesPtr != NULL) {
+		*FramesPtr = FbPtr->FrameCount;
+	}
+	if (DroppedPtr != NULL) {
+		*DroppedPtr = FbPtr->DroppedCount;
+	}
+	if (RepeatedPtr != NULL) {
+		*RepeatedPtr = FbPtr->RepeatedCount;
+	}
+}
+
+/*****************************************************************************/
+/*
+ * General callback installed by XAxiVdma_FbStart()
+ *
+ * @param CallBackRef is the manager of the channel
+ * @param InterruptTypes is the mask of pending completion interrupts
+ *
+ * @return
+ *  None
+ *
+ *****************************************************************************/
+static void XAxiVdma_FbCallBack(void *CallBackRef, u32 InterruptTypes)
+{
+	if (InterruptTypes & XAXIVDMA_IXR_FRMCNT_MASK) {
+		XAxiVdma_FbFrameDone((XAxiVdma_FrameBuf *)CallBackRef);
+	}
+}
+
+/*****************************************************************************/
+/*
+ * Park the channel on a frame. Only the park pointer register is written,
+ * the channel is already in park mode.
+ *
+ * @param FbPtr is the pointer to the manager
+ * @param Frame is the frame to park on
+ *
+ * @return
+ *  None
+ *
+ *****************************************************************************/
+static void XAxiVdma_FbPark(XAxiVdma_FrameBuf *FbPtr, u8 Frame)
+{
+	u32 RegValue;
+
+	RegValue = XAxiVdma_ReadReg(FbPtr->InstancePtr->BaseAddr,
+	    XAXIVDMA_PARKPTR_OFFSET);
+
+	if (FbPtr->Direction == XAXIVDMA_READ) {
+		RegValue &= ~XAXIVDMA_PARKPTR_READREF_MASK;
+		RegValue |= (u32)Frame & XAXIVDMA_PARKPTR_READREF_MASK;
+	}
+	else {
+		RegValue &= ~XAXIVDMA_PARKPTR_WRTREF_MASK;
+		RegValue |= ((u32)Frame << XAXIVDMA_WRTREF_SHIFT) &
+		    XAXIVDMA_PARKPTR_WRTREF_MASK;
+	}
+
+	XAxiVdma_WriteReg(FbPtr->InstancePtr->BaseAddr,
+	    XAXIVDMA_PARKPTR_OFFSET, RegValue);
+
+	FbPtr->HwFrame = Frame;
+}
+
+/*****************************************************************************/
+/*
+ * Find a frame store that is none of the given ones. The search starts after
+ * the parked frame so that the stores are used in turn.
+ *
+ * @param FbPtr is the pointer to the manager
+ * @param Busy0 is a frame in use, or XAXIVDMA_FB_NONE
+ * @param Busy1 is a frame in use, or XAXIVDMA_FB_NONE
+ * @param Busy2 is a frame in use, or XAXIVDMA_FB_NONE
+ *
+ * @return
+ * The free frame, or XAXIVDMA_FB_NONE if there is none
+ *
+ *****************************************************************************/
+static u8 XAxiVdma_FbFindFree(XAxiVdma_FrameBuf *FbPtr, u8 Busy0, u8 Busy1,
+        u8 Busy2)
+{
+	u8 Frame;
+	u8 Count;
+
+	Frame = FbPtr->HwFrame;
+
+	for (Count = 0; Count < FbPtr->NumFrames; Count++) {
+		Frame++;
+		if (Frame >= FbPtr->NumFrames) {
+			Frame = 0;
+		}
+
+		if ((Frame != Busy0) && (Frame != Busy1) && (Frame != Busy2)) {
+			return Frame;
+		}
+	}
+
+	return XAXIVDMA_FB_NONE;
+}
+
+/*****************************************************************************/
+/*
+ * Publish a frame to the consumer of the manager. Only the producer side of
+ * the manager may call this.
+ *
+ * @param FbPtr is the pointer to the manager
+ * @param Frame is the frame to publish
+ *
+ * @return
+ *  None
+ *
+ *****************************************************************************/
+static void XAxiVdma_FbPublish(XAxiVdma_FrameBuf *FbPtr, u8 Frame)
+{
+	/* The previous frame was never taken by the consumer
+	 */
+	if (FbPtr->TakenSeq != FbPtr->ReadySeq) {
+		FbPtr->DroppedCount++;
+	}
+
+	/* The frame must be visible before the sequence moves on
+	 */
+	FbPtr->ReadyFrame = Frame;
+	FbPtr->ReadySeq++;
+}
+/** @} */
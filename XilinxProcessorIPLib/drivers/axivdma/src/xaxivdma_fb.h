@@ -0,0 +1,170 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxivdma_fb.h
+* @addtogroup axivdma_v6_0
+* @{
+*
+* Frame-buffer manager for one VDMA channel running in park mode.
+*
+* The manager owns the channel's frame stores and decides which one the
+* hardware is parked on. Every frame it is told of the completed frame
+* through the frame count interrupt (frame count of 1) and moves the park
+* pointer:
+*
+* - On the write channel (S2MM) the hardware is the producer. The frame just
+*   written is published as the ready frame and the channel is parked on a
+*   store that is neither ready nor held by the CPU. XAxiVdma_FbAcquire()
+*   hands the newest ready frame to the CPU. A ready frame that is replaced
+*   before the CPU takes it is counted as dropped.
+*
+* - On the read channel (MM2S) the CPU is the producer. XAxiVdma_FbAcquire()
+*   returns a store that is neither displayed nor queued, and
+*   XAxiVdma_FbRelease() queues it for display. The interrupt parks the
+*   channel on the queued frame. A frame period without a new frame is
+*   counted as repeated, and a queued frame replaced before it is shown is
+*   counted as dropped.
+*
+* XAxiVdma_FbGenlock() links a write manager to a read manager that uses the
+* same frame stores. Every captured frame is then queued for display straight
+* from the write channel interrupt, and the write channel never parks on the
+* store being displayed.
+*
+* The handoff between the application and the interrupt handler uses
+* sequence counters that each have a single writer, so neither side has to
+* disable interrupts. This assumes the application and the VDMA interrupts
+* run on the same processor and that the interrupts do not nest with each
+* other. The park pointer is latched by the hardware at frame sync, so the
+* interrupt must be serviced within the vertical blanking period.
+*
+* At least 3 frame stores are needed, 4 when a write manager is linked with
+* XAxiVdma_FbGenlock() and the CPU also acquires captured frames.
+*
+* Usage:
+*  1. Configure the channel with XAxiVdma_DmaConfig(), with
+*     EnableCircularBuf set to 0.
+*  2. Call XAxiVdma_FbInitialize() with the frame store addresses.
+*  3. Register an error callback with XAxiVdma_SetCallBack(); the general
+*     callback is installed by XAxiVdma_FbStart().
+*  4. Call XAxiVdma_FbStart().
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 6.2        10/18/26 First release
+* </pre>
+*
+******************************************************************************/
+
+#ifndef XAXIVDMA_FB_H_     /* Prevent circular inclusions */
+#define XAXIVDMA_FB_H_     /* by using protection macros */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xaxivdma.h"
+
+/************************** Constant Definitions *****************************/
+
+/**
+ * Largest number of frame stores a manager can own, limited by the frames
+ * XAxiVdma_StartParking() accepts
+ */
+#define XAXIVDMA_FB_MAX_FRAMES	(XAXIVDMA_FRM_MAX + 1)
+
+/**
+ * Frame index meaning no frame
+ */
+#define XAXIVDMA_FB_NONE	0xFF
+
+/**************************** Type Definitions *******************************/
+
+/**
+ * Frame-buffer manager for one channel. All the fields are private to the
+ * manager; use XAxiVdma_FbGetStats() to read the counters.
+ */
+typedef struct XAxiVdma_FrameBufStruct {
+    XAxiVdma *InstancePtr;         /**< VDMA the channel belongs to */
+    u16 Direction;                 /**< XAXIVDMA_READ or XAXIVDMA_WRITE */
+    u8 NumFrames;                  /**< Number of frame stores owned */
+    UINTPTR FrameAddr[XAXIVDMA_MAX_FRAMESTORE];
+                                   /**< Frame store start addresses */
+
+    volatile u8 HwFrame;           /**< Store the channel is parked on,
+                                     *  written by the interrupt handler */
+    volatile u8 CpuFrame;          /**< Store held by the CPU, or
+                                     *  XAXIVDMA_FB_NONE */
+    volatile u8 ReadyFrame;        /**< Last published frame */
+    volatile u32 ReadySeq;         /**< Bumped each time ReadyFrame is
+                                     *  published, by the producer only */
+    volatile u32 TakenSeq;         /**< ReadySeq last taken, by the
+                                     *  consumer only */
+
+    volatile u32 FrameCount;       /**< Frame interrupts handled */
+    volatile u32 DroppedCount;     /**< Frames replaced before being
+                                     *  consumed */
+    volatile u32 RepeatedCount;    /**< Read channel frames shown again
+                                     *  for lack of a new one */
+
+    struct XAxiVdma_FrameBufStruct *GenlockPtr;
+                                   /**< Read manager fed by this write
+                                     *  manager, or NULL */
+    int IsGenlocked;               /**< Read manager fed by a write manager
+                                     *  rather than by the CPU */
+} XAxiVdma_FrameBuf;
+
+/************************** Function Prototypes ******************************/
+
+int XAxiVdma_FbInitialize(XAxiVdma_FrameBuf *FbPtr, XAxiVdma *InstancePtr,
+        u16 Direction, const UINTPTR *FrameAddr, u8 NumFrames);
+int XAxiVdma_FbStart(XAxiVdma_FrameBuf *FbPtr);
+int XAxiVdma_FbGenlock(XAxiVdma_FrameBuf *WriteFbPtr,
+        XAxiVdma_FrameBuf *ReadFbPtr);
+int XAxiVdma_FbAcquire(XAxiVdma_FrameBuf *FbPtr, UINTPTR *AddrPtr);
+void XAxiVdma_FbRelease(XAxiVdma_FrameBuf *FbPtr);
+void XAxiVdma_FbFrameDone(XAxiVdma_FrameBuf *FbPtr);
+void XAxiVdma_FbGetStats(XAxiVdma_FrameBuf *FbPtr, u32 *FramesPtr,
+        u32 *DroppedPtr, u32 *RepeatedPtr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of protection macro */
+/** @} */
@@ -0,0 +1,906 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xaxivdma_fb_sim.c
+*
+* Host test of the frame-buffer manager against a register model of the
+* VDMA in direct register mode.
+*
+* The model keeps the channel control and status registers, the park
+* pointer register and the frame store addresses. A reset self-clears and
+* halts the channel, Run/Stop clears the halted bit and the interrupt bits in
+* the status register are write one to clear. A started channel runs on its
+* own video timing: at each frame sync it latches the park reference into
+* the park pointer store field and accesses that frame store until the end of
+* the active period, then counts the frame and raises the frame count
+* interrupt. The interrupt handler of the driver runs a fixed latency later,
+* within vertical blanking. The CPU acquires and releases frame stores at
+* random points of the frame; its actions and the interrupts are atomic with
+* respect to each other.
+*
+* Every scenario checks that:
+*  - the channels never start on a frame store the CPU holds,
+*  - a genlocked read channel never shows a store the write channel is
+*    writing and the write channel never writes the store being shown,
+*  - frames are shown, and captured frames acquired, in order,
+*  - the dropped and repeated counts of the manager match the frames the
+*    model saw lost and shown again.
+* It also checks the programming done by XAxiVdma_FbStart() and that the
+* manager functions assert on bad arguments. The frame counts and the
+* latency from the end of capture or rendering to the start of display, or
+* to the CPU acquiring the frame, are printed.
+*
+* Usage: xaxivdma_fb_sim [seconds] [interrupt latency in us] [seed]
+*
+* The defaults are 20 s, 50 us and 1. A latency longer than vertical
+* blanking (833 us at 60 Hz) misses the frame sync, which the checks report.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 6.2        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xaxivdma.h"
+#include "xaxivdma_fb.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE	0x43000000U	/* VDMA registers */
+#define SIM_REGS	0x100U		/* Size of the register space */
+#define SIM_VERSION	0x62000000U	/* Version 6.2 */
+#define SIM_STORE_BASE	0x10000000U	/* First frame store */
+#define SIM_STORE_SIZE	0x00400000U	/* Frame store spacing */
+#define SIM_BLANK_PCT	5U		/* Vertical blanking, % of the frame */
+#define SIM_NONE	0xFFFFFFFFU
+#define SIM_NEVER	(~(u64)0U)
+
+#define SIM_RD		0U		/* MM2S */
+#define SIM_WR		1U		/* S2MM */
+
+/**************************** Type Definitions *******************************/
+
+typedef unsigned long long u64t;
+
+typedef struct {
+	u32 ChanBase;		/* Offset of the channel registers */
+	u32 AddrBase;		/* Offset of the frame size/address block */
+	u32 Started;		/* VSIZE written with Run/Stop set */
+	u32 FrmCnt;		/* Frames left before the frame count intr */
+	u64t Period;		/* Frame period, ns */
+	u64t NextSync;
+	u64t NextEnd;
+	u64t NextIrq;
+	u32 Store;		/* Store accessed in this frame, or SIM_NONE */
+} SimChan;
+
+typedef struct {
+	u32 Tag;		/* Sequence number of the content, 0 if blank */
+	u64t DoneAt;		/* Time the content was completed */
+	u32 Writing;		/* S2MM writes it in this frame */
+	u32 Reading;		/* MM2S reads it in this frame */
+	u32 CpuHeld;		/* CPU works on the captured frame */
+	u32 CpuWriting;		/* CPU renders into it */
+} SimStore;
+
+typedef struct {
+	const char *Name;
+	u32 NumFrames;
+	u32 InHz;		/* Capture rate, 0 without write channel */
+	u32 OutHz;		/* Display rate, 0 without read channel */
+	u32 Genlock;
+	u32 Consume;		/* CPU acquires captured frames */
+	u32 RenderHz;		/* CPU renders for display, 0 if it does not */
+} SimScenario;
+
+typedef struct {
+	u32 Errors;		/* Checks failed */
+	u32 Shown;		/* Distinct frames shown or acquired */
+	u32 LastTag;		/* Newest of those */
+	u32 Repeated;		/* Frame periods showing the previous frame */
+	u32 Displayed;		/* Frame periods shown */
+	u32 PrevTag;
+	double LatSum;
+	double LatMax;
+} SimStats;
+
+/************************** Variable Definitions *****************************/
+
+static u32 SimReg[SIM_REGS / 4U];
+static SimChan Chan[2];
+static SimStore Store[XAXIVDMA_FB_MAX_FRAMES];
+static u32 NumStores;
+static u64t SimNow;
+static u64t IrqLatency = 50000U;
+static u64t Seed = 1U;
+
+static u32 CaptureSeq;		/* Tag of the newest capture started */
+static u32 RenderSeq;		/* Tag of the newest frame rendered */
+
+/* CPU */
+static u32 CpuStore = SIM_NONE;
+static u32 CpuTag;		/* Tag of the captured frame acquired last */
+static u64t CpuAt;
+static u64t CpuFrameStart;
+
+static XAxiVdma Vdma;
+static XAxiVdma_FrameBuf WriteFb;
+static XAxiVdma_FrameBuf ReadFb;
+static SimStats Stats;
+static u32 ErrIntr;
+
+static jmp_buf AssertJmp;
+
+/************************** Function Definitions *****************************/
+
+static u32 SimRand(u32 Range)
+{
+	Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+	return (u32)(Seed >> 33) % Range;
+}
+
+static void SimFail(const char *What, u32 Frame)
+{
+	if (Stats.Errors < 10U) {
+		printf("  FAIL at %.3f ms: %s (store %u)\n", SimNow / 1e6,
+			What, Frame);
+	}
+	Stats.Errors++;
+}
+
+/* Next frame sync of a channel after the current time */
+static u64t SimNextSync(const SimChan *Ch, u64t Phase)
+{
+	return ((SimNow / Ch->Period) + 1U) * Ch->Period + Phase;
+}
+
+static void SimWriteCr(SimChan *Ch, u32 Value)
+{
+	u32 *Cr = &SimReg[(Ch->ChanBase + XAXIVDMA_CR_OFFSET) / 4U];
+	u32 *Sr = &SimReg[(Ch->ChanBase + XAXIVDMA_SR_OFFSET) / 4U];
+
+	if (Value & XAXIVDMA_CR_RESET_MASK) {
+		/* The reset completes at once */
+		*Cr = 1U << XAXIVDMA_FRMCNT_SHIFT;
+		*Sr = XAXIVDMA_SR_HALTED_MASK;
+		Ch->Started = 0U;
+		Ch->FrmCnt = 1U;
+		Ch->NextIrq = SIM_NEVER;
+		return;
+	}
+
+	if ((Value ^ *Cr) & XAXIVDMA_FRMCNT_MASK) {
+		Ch->FrmCnt = (Value & XAXIVDMA_FRMCNT_MASK) >>
+			XAXIVDMA_FRMCNT_SHIFT;
+	}
+
+	*Cr = Value;
+	if (Value & XAXIVDMA_CR_RUNSTOP_MASK) {
+		*Sr &= ~XAXIVDMA_SR_HALTED_MASK;
+	}
+	else {
+		*Sr |= XAXIVDMA_SR_HALTED_MASK;
+		Ch->Started = 0U;
+	}
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Offset = (u32)(Addr - SIM_BASE);
+
+	if ((Addr < SIM_BASE) || (Offset >= SIM_REGS) || (Offset & 3U)) {
+		printf("read outside the register space: %lx\n",
+			(unsigned long)Addr);
+		exit(1);
+	}
+
+	if (Offset == XAXIVDMA_VERSION_OFFSET) {
+		return SIM_VERSION;
+	}
+
+	return SimReg[Offset / 4U];
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset = (u32)(Addr - SIM_BASE);
+	u32 Index;
+	SimChan *Ch;
+
+	if ((Addr < SIM_BASE) || (Offset >= SIM_REGS) || (Offset & 3U)) {
+		printf("write outside the register space: %lx\n",
+			(unsigned long)Addr);
+		exit(1);
+	}
+
+	for (Index = 0U; Index < 2U; Index++) {
+		Ch = &Chan[Index];
+
+		if (Offset == (Ch->ChanBase + XAXIVDMA_CR_OFFSET)) {
+			SimWriteCr(Ch, Value);
+			return;
+		}
+
+		if (Offset == (Ch->ChanBase + XAXIVDMA_SR_OFFSET)) {
+			SimReg[Offset / 4U] &= ~(Value &
+				(XAXIVDMA_IXR_ALL_MASK |
+				 XAXIVDMA_SR_ERR_ALL_MASK));
+			return;
+		}
+
+		if (Offset == (Ch->AddrBase + XAXIVDMA_VSIZE_OFFSET)) {
+			SimReg[Offset / 4U] = Value;
+			if ((SimReg[(Ch->ChanBase + XAXIVDMA_CR_OFFSET) / 4U] &
+				XAXIVDMA_CR_RUNSTOP_MASK) && !Ch->Started) {
+				Ch->Started = 1U;
+			}
+			return;
+		}
+	}
+
+	if (Offset == XAXIVDMA_PARKPTR_OFFSET) {
+		/* Only the park references are writable */
+		SimReg[Offset / 4U] = (SimReg[Offset / 4U] &
+			(XAXIVDMA_PARKPTR_READSTR_MASK |
+			 XAXIVDMA_PARKPTR_WRTSTR_MASK)) |
+			(Value & (XAXIVDMA_PARKPTR_READREF_MASK |
+				  XAXIVDMA_PARKPTR_WRTREF_MASK));
+		return;
+	}
+
+	SimReg[Offset / 4U] = Value;
+}
+
+static void ErrCallBack(void *CallBackRef, u32 ErrorMask)
+{
+	(void)CallBackRef;
+	(void)ErrorMask;
+
+	ErrIntr++;
+}
+
+static void SimAssert(const char8 *File, s32 Line)
+{
+	(void)File;
+	(void)Line;
+
+	longjmp(AssertJmp, 1);
+}
+
+/* Display accounting at the start of a read frame */
+static void SimShow(u32 Frame)
+{
+	u32 Tag = Store[Frame].Tag;
+
+	if (Stats.Displayed != 0U) {
+		if (Tag == Stats.PrevTag) {
+			Stats.Repeated++;
+		}
+		else if (Tag < Stats.PrevTag) {
+			SimFail("frame shown out of order", Frame);
+		}
+	}
+	Stats.Displayed++;
+
+	if ((Tag != 0U) && (Tag != Stats.PrevTag)) {
+		double Lat = (SimNow - Store[Frame].DoneAt) / 1e6;
+
+		Stats.Shown++;
+		Stats.LastTag = Tag;
+		Stats.LatSum += Lat;
+		if (Lat > Stats.LatMax) {
+			Stats.LatMax = Lat;
+		}
+	}
+	Stats.PrevTag = Tag;
+}
+
+static void SimFrameSync(u32 Index)
+{
+	SimChan *Ch = &Chan[Index];
+	u32 *Park = &SimReg[XAXIVDMA_PARKPTR_OFFSET / 4U];
+	u32 Cr = SimReg[(Ch->ChanBase + XAXIVDMA_CR_OFFSET) / 4U];
+	u32 Frame;
+
+	Ch->NextSync += Ch->Period;
+
+	if (Cr & XAXIVDMA_CR_TAIL_EN_MASK) {
+		SimFail("channel not in park mode", SIM_NONE);
+		return;
+	}
+
+	if (Index == SIM_RD) {
+		Frame = *Park & XAXIVDMA_PARKPTR_READREF_MASK;
+		*Park = (*Park & ~XAXIVDMA_PARKPTR_READSTR_MASK) |
+			(Frame << XAXIVDMA_READSTR_SHIFT);
+	}
+	else {
+		Frame = (*Park & XAXIVDMA_PARKPTR_WRTREF_MASK) >>
+			XAXIVDMA_WRTREF_SHIFT;
+		*Park = (*Park & ~XAXIVDMA_PARKPTR_WRTSTR_MASK) |
+			(Frame << XAXIVDMA_WRTSTR_SHIFT);
+	}
+
+	if (Frame >= NumStores) {
+		SimFail("parked outside the frame stores", Frame);
+		return;
+	}
+
+	if (Index == SIM_RD) {
+		if (Store[Frame].CpuWriting) {
+			SimFail("showing a store the CPU renders", Frame);
+		}
+		if (Store[Frame].Writing) {
+			SimFail("showing the store being written", Frame);
+		}
+		Store[Frame].Reading = 1U;
+		SimShow(Frame);
+	}
+	else {
+		if (Store[Frame].CpuHeld) {
+			SimFail("writing a store the CPU holds", Frame);
+		}
+		if (Store[Frame].Reading) {
+			SimFail("writing the store being shown", Frame);
+		}
+		Store[Frame].Writing = 1U;
+		Store[Frame].Tag = ++CaptureSeq;
+	}
+
+	Ch->Store = Frame;
+	Ch->NextEnd = SimNow + (Ch->Period * (100U - SIM_BLANK_PCT)) / 100U;
+}
+
+static void SimFrameEnd(u32 Index)
+{
+	SimChan *Ch = &Chan[Index];
+	u32 Cr = SimReg[(Ch->ChanBase + XAXIVDMA_CR_OFFSET) / 4U];
+
+	if (Index == SIM_RD) {
+		Store[Ch->Store].Reading = 0U;
+	}
+	else {
+		Store[Ch->Store].Writing = 0U;
+		Store[Ch->Store].DoneAt = SimNow;
+	}
+	Ch->Store = SIM_NONE;
+	Ch->NextEnd = SIM_NEVER;
+
+	if (--Ch->FrmCnt == 0U) {
+		Ch->FrmCnt = (Cr & XAXIVDMA_FRMCNT_MASK) >>
+			XAXIVDMA_FRMCNT_SHIFT;
+		SimReg[(Ch->ChanBase + XAXIVDMA_SR_OFFSET) / 4U] |=
+			XAXIVDMA_IXR_FRMCNT_MASK;
+		if (Cr & XAXIVDMA_IXR_FRMCNT_MASK) {
+			Ch->NextIrq = SimNow + IrqLatency;
+		}
+	}
+}
+
+static void SimIrq(u32 Index)
+{
+	SimChan *Ch = &Chan[Index];
+
+	Ch->NextIrq = SIM_NEVER;
+
+	if (SimReg[(Ch->ChanBase + XAXIVDMA_SR_OFFSET) / 4U] &
+		SimReg[(Ch->ChanBase + XAXIVDMA_CR_OFFSET) / 4U] &
+		XAXIVDMA_IXR_ALL_MASK) {
+		if (Index == SIM_RD) {
+			XAxiVdma_ReadIntrHandler(&Vdma);
+		}
+		else {
+			XAxiVdma_WriteIntrHandler(&Vdma);
+		}
+	}
+}
+
+static u32 SimStoreOf(UINTPTR Addr)
+{
+	u32 Frame = (u32)((Addr - SIM_STORE_BASE) / SIM_STORE_SIZE);
+
+	if ((Addr < SIM_STORE_BASE) || (Frame >= NumStores) ||
+		(Addr != SIM_STORE_BASE + Frame * SIM_STORE_SIZE)) {
+		SimFail("acquired address is not a frame store", SIM_NONE);
+		return SIM_NONE;
+	}
+
+	return Frame;
+}
+
+/* The CPU takes the newest captured frame and works on it for a while */
+static void SimConsume(const SimScenario *Sc)
+{
+	u64t InPeriod = 1000000000U / Sc->InHz;
+	UINTPTR Addr;
+	u32 Frame;
+	double Lat;
+
+	if ((CpuStore != SIM_NONE) && SimRand(2U)) {
+		Store[CpuStore].CpuHeld = 0U;
+		CpuStore = SIM_NONE;
+		XAxiVdma_FbRelease(&WriteFb);
+	}
+
+	if (XAxiVdma_FbAcquire(&WriteFb, &Addr) != XST_SUCCESS) {
+		CpuAt = SimNow + 1000000U;
+		return;
+	}
+
+	Frame = SimStoreOf(Addr);
+	if (Frame == SIM_NONE) {
+		return;
+	}
+
+	if (CpuStore != SIM_NONE) {
+		Store[CpuStore].CpuHeld = 0U;
+	}
+	CpuStore = Frame;
+	Store[Frame].CpuHeld = 1U;
+
+	if (Store[Frame].Writing || (Store[Frame].Tag == 0U)) {
+		SimFail("acquired a frame not yet captured", Frame);
+	}
+	else if (Store[Frame].Tag <= CpuTag) {
+		SimFail("acquired an older frame", Frame);
+	}
+	else if (!Sc->OutHz) {
+		/* Without a display the acquired frames are the output */
+		Lat = (SimNow - Store[Frame].DoneAt) / 1e6;
+		Stats.Shown++;
+		Stats.LastTag = Store[Frame].Tag;
+		Stats.LatSum += Lat;
+		if (Lat > Stats.LatMax) {
+			Stats.LatMax = Lat;
+		}
+	}
+	CpuTag = Store[Frame].Tag;
+
+	/* Hold it for 0.2 to 2.5 input frames */
+	CpuAt = SimNow + InPeriod / 5U + SimRand((u32)(InPeriod * 23U / 10U));
+}
+
+/* The CPU renders frames for display at its own rate */
+static void SimRender(const SimScenario *Sc)
+{
+	u64t RenderPeriod = 1000000000U / Sc->RenderHz;
+	UINTPTR Addr;
+	u32 Frame;
+
+	if (CpuStore != SIM_NONE) {
+		/* Rendering done */
+		Store[CpuStore].Tag = ++RenderSeq;
+		Store[CpuStore].DoneAt = SimNow;
+		Store[CpuStore].CpuWriting = 0U;
+		CpuStore = SIM_NONE;
+		XAxiVdma_FbRelease(&ReadFb);
+
+		CpuFrameStart += RenderPeriod;
+		CpuAt = (CpuFrameStart > SimNow) ? CpuFrameStart : SimNow;
+		return;
+	}
+
+	if (XAxiVdma_FbAcquire(&ReadFb, &Addr) != XST_SUCCESS) {
+		CpuAt = SimNow + 1000000U;
+		return;
+	}
+
+	Frame = SimStoreOf(Addr);
+	if (Frame == SIM_NONE) {
+		return;
+	}
+
+	if (Store[Frame].Reading) {
+		SimFail("acquired the store being shown", Frame);
+	}
+	CpuStore = Frame;
+	Store[Frame].CpuWriting = 1U;
+
+	/* Rendering takes 30 to 90% of the frame period */
+	CpuAt = SimNow + (RenderPeriod * 3U) / 10U +
+		SimRand((u32)((RenderPeriod * 6U) / 10U));
+}
+
+static void SimRun(const SimScenario *Sc, u64t End)
+{
+	u64t Next;
+	u32 Index;
+	u32 Event;
+
+	while (1) {
+		Next = (Sc->Consume || Sc->RenderHz) ? CpuAt : SIM_NEVER;
+		Event = 6U;
+
+		for (Index = 0U; Index < 2U; Index++) {
+			if (!Chan[Index].Started) {
+				continue;
+			}
+			if (Chan[Index].NextIrq < Next) {
+				Next = Chan[Index].NextIrq;
+				Event = Index * 3U;
+			}
+			if (Chan[Index].NextEnd < Next) {
+				Next = Chan[Index].NextEnd;
+				Event = Index * 3U + 1U;
+			}
+			if (Chan[Index].NextSync < Next) {
+				Next = Chan[Index].NextSync;
+				Event = Index * 3U + 2U;
+			}
+		}
+
+		if (Next > End) {
+			break;
+		}
+		SimNow = Next;
+
+		switch (Event) {
+		case 0U:
+		case 3U:
+			SimIrq(Event / 3U);
+			break;
+		case 1U:
+		case 4U:
+			SimFrameEnd(Event / 3U);
+			break;
+		case 2U:
+		case 5U:
+			SimFrameSync(Event / 3U);
+			break;
+		default:
+			if (Sc->Consume) {
+				SimConsume(Sc);
+			}
+			else {
+				SimRender(Sc);
+			}
+			break;
+		}
+	}
+}
+
+static void SimReset(u32 NumFrames)
+{
+	u32 Index;
+
+	memset(SimReg, 0, sizeof(SimReg));
+	memset(Chan, 0, sizeof(Chan));
+	memset(Store, 0, sizeof(Store));
+	memset(&Stats, 0, sizeof(Stats));
+
+	Chan[SIM_RD].ChanBase = XAXIVDMA_TX_OFFSET;
+	Chan[SIM_RD].AddrBase = XAXIVDMA_MM2S_ADDR_OFFSET;
+	Chan[SIM_WR].ChanBase = XAXIVDMA_RX_OFFSET;
+	Chan[SIM_WR].AddrBase = XAXIVDMA_S2MM_ADDR_OFFSET;
+
+	for (Index = 0U; Index < 2U; Index++) {
+		SimReg[(Chan[Index].ChanBase + XAXIVDMA_CR_OFFSET) / 4U] =
+			1U << XAXIVDMA_FRMCNT_SHIFT;
+		SimReg[(Chan[Index].ChanBase + XAXIVDMA_SR_OFFSET) / 4U] =
+			XAXIVDMA_SR_HALTED_MASK;
+		Chan[Index].FrmCnt = 1U;
+		Chan[Index].Store = SIM_NONE;
+		Chan[Index].NextSync = SIM_NEVER;
+		Chan[Index].NextEnd = SIM_NEVER;
+		Chan[Index].NextIrq = SIM_NEVER;
+	}
+
+	NumStores = NumFrames;
+	SimNow = 0U;
+	CaptureSeq = 0U;
+	RenderSeq = 0U;
+	CpuStore = SIM_NONE;
+	CpuTag = 0U;
+	CpuAt = 0U;
+	CpuFrameStart = 0U;
+	ErrIntr = 0U;
+}
+
+/* Checks the registers XAxiVdma_FbStart() programmed for a channel */
+static u32 CheckStart(XAxiVdma_FrameBuf *FbPtr, u32 Index)
+{
+	SimChan *Ch = &Chan[Index];
+	u32 Cr = SimReg[(Ch->ChanBase + XAXIVDMA_CR_OFFSET) / 4U];
+	u32 Park = SimReg[XAXIVDMA_PARKPTR_OFFSET / 4U];
+	u32 Failed = 0U;
+	u32 Frame;
+
+	for (Frame = 0U; Frame < NumStores; Frame++) {
+		if (SimReg[(Ch->AddrBase + XAXIVDMA_START_ADDR_OFFSET) / 4U +
+			Frame] != SIM_STORE_BASE + Frame * SIM_STORE_SIZE) {
+			Failed++;
+		}
+	}
+
+	if (!(Cr & XAXIVDMA_CR_RUNSTOP_MASK) ||
+		(Cr & XAXIVDMA_CR_TAIL_EN_MASK) ||
+		!(Cr & XAXIVDMA_IXR_FRMCNT_MASK) ||
+		(((Cr & XAXIVDMA_FRMCNT_MASK) >> XAXIVDMA_FRMCNT_SHIFT) != 1U) ||
+		!Ch->Started) {
+		Failed++;
+	}
+
+	Frame = (Index == SIM_RD) ? (Park & XAXIVDMA_PARKPTR_READREF_MASK) :
+		((Park & XAXIVDMA_PARKPTR_WRTREF_MASK) >> XAXIVDMA_WRTREF_SHIFT);
+	if (Frame != FbPtr->HwFrame) {
+		Failed++;
+	}
+
+	if (Failed) {
+		printf("  FAIL: channel %u not set up as expected\n", Index);
+	}
+
+	return Failed;
+}
+
+static u32 Setup(const SimScenario *Sc)
+{
+	static XAxiVdma_Config Config;
+	XAxiVdma_DmaSetup DmaSetup;
+	UINTPTR Addr[XAXIVDMA_FB_MAX_FRAMES];
+	u32 Index;
+	u32 Failed = 0U;
+
+	SimReset(Sc->NumFrames);
+
+	memset(&Config, 0, sizeof(Config));
+	Config.BaseAddress = SIM_BASE;
+	Config.MaxFrameStoreNum = Sc->NumFrames;
+	Config.HasMm2S = 1;
+	Config.HasS2Mm = 1;
+	Config.Mm2SWordLen = 32;
+	Config.S2MmWordLen = 32;
+	Config.Mm2SStreamWidth = 32;
+	Config.S2MmStreamWidth = 32;
+	Config.UseFsync = 1;
+	Config.EnableAllDbgFeatures = 1;
+	Config.AddrWidth = 32;
+
+	memset(&Vdma, 0, sizeof(Vdma));
+	if (XAxiVdma_CfgInitialize(&Vdma, &Config, SIM_BASE) != XST_SUCCESS) {
+		printf("  FAIL: XAxiVdma_CfgInitialize\n");
+		return 1U;
+	}
+
+	memset(&DmaSetup, 0, sizeof(DmaSetup));
+	DmaSetup.VertSizeInput = 720;
+	DmaSetup.HoriSizeInput = 1280 * 4;
+	DmaSetup.Stride = 1280 * 4;
+
+	for (Index = 0U; Index < Sc->NumFrames; Index++) {
+		Addr[Index] = SIM_STORE_BASE + Index * SIM_STORE_SIZE;
+	}
+
+	if (Sc->InHz) {
+		Failed += (XAxiVdma_DmaConfig(&Vdma, XAXIVDMA_WRITE,
+			&DmaSetup) != XST_SUCCESS);
+		Failed += (XAxiVdma_FbInitialize(&WriteFb, &Vdma,
+			XAXIVDMA_WRITE, Addr, Sc->NumFrames) != XST_SUCCESS);
+		Failed += (XAxiVdma_SetCallBack(&Vdma, XAXIVDMA_HANDLER_ERROR,
+			(void *)ErrCallBack, NULL, XAXIVDMA_WRITE) !=
+			XST_SUCCESS);
+		Chan[SIM_WR].Period = 1000000000U / Sc->InHz;
+	}
+
+	if (Sc->OutHz) {
+		Failed += (XAxiVdma_DmaConfig(&Vdma, XAXIVDMA_READ,
+			&DmaSetup) != XST_SUCCESS);
+		Failed += (XAxiVdma_FbInitialize(&ReadFb, &Vdma,
+			XAXIVDMA_READ, Addr, Sc->NumFrames) != XST_SUCCESS);
+		Failed += (XAxiVdma_SetCallBack(&Vdma, XAXIVDMA_HANDLER_ERROR,
+			(void *)ErrCallBack, NULL, XAXIVDMA_READ) !=
+			XST_SUCCESS);
+		Chan[SIM_RD].Period = 1000000000U / Sc->OutHz;
+	}
+
+	if (Sc->Genlock) {
+		Failed += (XAxiVdma_FbGenlock(&WriteFb, &ReadFb) !=
+			XST_SUCCESS);
+	}
+
+	if (Sc->InHz) {
+		Failed += (XAxiVdma_FbStart(&WriteFb) != XST_SUCCESS);
+		Failed += CheckStart(&WriteFb, SIM_WR);
+		Chan[SIM_WR].NextSync = SimNextSync(&Chan[SIM_WR], 0U);
+	}
+
+	if (Sc->OutHz) {
+		Failed += (XAxiVdma_FbStart(&ReadFb) != XST_SUCCESS);
+		Failed += CheckStart(&ReadFb, SIM_RD);
+		/* Display timing a third of a frame behind the capture */
+		Chan[SIM_RD].NextSync = SimNextSync(&Chan[SIM_RD],
+			Chan[SIM_RD].Period / 3U);
+	}
+
+	if (Failed) {
+		printf("  FAIL: set up\n");
+	}
+
+	return Failed;
+}
+
+/* Compares a count of the manager with the one seen by the model */
+static u32 CheckCount(const char *What, u32 Driver, u32 Model, u32 Slack)
+{
+	if ((Driver < Model) || (Driver > Model + Slack)) {
+		printf("  FAIL: %s: manager %u, model %u\n", What, Driver,
+			Model);
+		return 1U;
+	}
+
+	return 0U;
+}
+
+static u32 RunScenario(const SimScenario *Sc, u64t Duration)
+{
+	u32 WrDropped = 0U;
+	u32 RdDropped = 0U;
+	u32 Repeated = 0U;
+	u32 Frames = 0U;
+	u32 Failed;
+
+	Failed = Setup(Sc);
+	if (Failed) {
+		return Failed;
+	}
+
+	SimRun(Sc, Duration);
+
+	if (Sc->InHz) {
+		XAxiVdma_FbGetStats(&WriteFb, &Frames, &WrDropped, NULL);
+	}
+	if (Sc->OutHz) {
+		XAxiVdma_FbGetStats(&ReadFb, &Frames, &RdDropped, &Repeated);
+	}
+
+	/* Every frame up to the newest one shown that was not shown is
+	 * lost. The manager may also have replaced frames after it that the
+	 * model cannot tell apart yet.
+	 */
+	Failed += CheckCount("dropped", WrDropped + RdDropped,
+		Stats.LastTag - Stats.Shown, 2U);
+	if (Sc->OutHz) {
+		Failed += CheckCount("repeated", Repeated, Stats.Repeated, 1U);
+	}
+	if (ErrIntr) {
+		printf("  FAIL: %u error interrupts\n", ErrIntr);
+		Failed++;
+	}
+	Failed += Stats.Errors;
+
+	printf("%-24s %7u %7u %8u %8u %8.2f %8.2f %6s\n", Sc->Name,
+		Sc->InHz ? CaptureSeq : RenderSeq,
+		Sc->OutHz ? Stats.Displayed : Stats.Shown,
+		WrDropped + RdDropped, Repeated,
+		Stats.Shown ? Stats.LatSum / Stats.Shown : 0.0, Stats.LatMax,
+		Failed ? "FAIL" : "ok");
+
+	return Failed;
+}
+
+/* The manager functions must assert on bad arguments */
+static u32 CheckAsserts(void)
+{
+	static XAxiVdma_FrameBuf BadFb;
+	volatile u32 Missed = 0U;
+	u32 Case;
+
+	Xil_AssertSetCallback(SimAssert);
+
+	for (Case = 0U; Case < 3U; Case++) {
+		memset(&BadFb, 0, sizeof(BadFb));
+		BadFb.InstancePtr = &Vdma;
+		BadFb.Direction = XAXIVDMA_WRITE;
+		BadFb.NumFrames = 3U;
+
+		if (setjmp(AssertJmp) == 0) {
+			switch (Case) {
+			case 0U:
+				XAxiVdma_FbFrameDone(NULL);
+				break;
+			case 1U:
+				BadFb.InstancePtr = NULL;
+				XAxiVdma_FbFrameDone(&BadFb);
+				break;
+			default:
+				BadFb.Direction = 0U;
+				XAxiVdma_FbFrameDone(&BadFb);
+				break;
+			}
+			printf("  FAIL: XAxiVdma_FbFrameDone case %u did not "
+				"assert\n", Case);
+			Missed++;
+		}
+	}
+
+	Xil_AssertSetCallback(NULL);
+
+	return Missed;
+}
+
+int main(int argc, char *argv[])
+{
+	static const SimScenario Scenarios[] = {
+		{ "capture", 3U, 60U, 0U, 0U, 1U, 0U },
+		{ "display, render 50 Hz", 3U, 0U, 60U, 0U, 0U, 50U },
+		{ "display, render 75 Hz", 3U, 0U, 60U, 0U, 0U, 75U },
+		{ "genlock 60 -> 60", 3U, 60U, 60U, 1U, 0U, 0U },
+		{ "genlock 50 -> 60", 3U, 50U, 60U, 1U, 0U, 0U },
+		{ "genlock 60 -> 50", 3U, 60U, 50U, 1U, 0U, 0U },
+		{ "genlock + capture, 3", 3U, 60U, 60U, 1U, 1U, 0U },
+		{ "genlock + capture, 4", 4U, 60U, 60U, 1U, 1U, 0U },
+	};
+	u64t Duration = 20U;
+	u32 Index;
+	u32 Failed = 0U;
+
+	if (argc > 1) {
+		Duration = strtoull(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		IrqLatency = strtoull(argv[2], NULL, 0) * 1000U;
+	}
+	if (argc > 3) {
+		Seed = strtoull(argv[3], NULL, 0);
+	}
+	Duration *= 1000000000U;
+
+	printf("model: %llu s, interrupt latency %llu us, %u%% blanking\n\n",
+		Duration / 1000000000U, IrqLatency / 1000U, SIM_BLANK_PCT);
+	printf("%-24s %7s %7s %8s %8s %8s %8s\n", "scenario", "in", "out",
+		"dropped", "repeated", "lat ms", "max ms");
+
+	for (Index = 0U; Index < sizeof(Scenarios) / sizeof(Scenarios[0]);
+			Index++) {
+		Failed += RunScenario(&Scenarios[Index], Duration);
+	}
+
+	Failed += CheckAsserts();
+
+	printf("\n%s\n", (Failed == 0U) ? "all checks passed" :
+						"CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}
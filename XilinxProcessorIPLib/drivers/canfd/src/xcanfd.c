@@ -449,12 +449,7 @@ int XCanFd_Send(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 {
 	u32 Result;
 	u32 FreeTxBuffer;
-	u32 DwIndex=0;
 	u32 Value;
-	u32 Dlc;
-	u32 Len;
-	u32 CanEDL;
-	u32 OutValue;
 
 	Xil_AssertNonvoid(InstancePtr != NULL);
 	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
@@ -468,51 +463,8 @@ int XCanFd_Send(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 	if (FreeTxBuffer == XST_NOBUFFER){
 		return XST_FIFO_NO_ROOM;
 	}
-	else {
 
-		/* Write ID to ID Register */
-		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXID_OFFSET(FreeTxBuffer), FramePtr[0]);
-
-		/* Write DLC to DLC Register */
-		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXDLC_OFFSET(FreeTxBuffer), FramePtr[1]);
-		CanEDL = XCanFd_ReadReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXDLC_OFFSET(FreeTxBuffer));
-
-		if (CanEDL & XCANFD_DLCR_EDL_MASK) {
-
-			/* CAN FD Frames. */
-			Dlc = XCanFd_GetDlc2len(FramePtr[1] &
-				XCANFD_DLCR_DLC_MASK);
-			/* Write Data to Data Register */
-
-			for (Len = 0;Len < Dlc;Len += 4) {
-				OutValue = Xil_EndianSwap32(
-						FramePtr[2+DwIndex]);
-				XCanFd_WriteReg(
-					InstancePtr->CanFdConfig.BaseAddress,
-					(XCANFD_TXDW_OFFSET(FreeTxBuffer)+
-					(DwIndex*XCANFD_DW_BYTES)), OutValue);
-				DwIndex++;
-			}
-		}
-		else {
-
-			/* Legacy CAN Frames */
-			Dlc = XCanFd_GetDlc2len(FramePtr[1] &
-				XCANFD_DLCR_DLC_MASK);
-			for (Len = 0;Len < Dlc;Len += 4) {
-				OutValue = Xil_EndianSwap32(
-						FramePtr[2+DwIndex]);
-				XCanFd_WriteReg(
-					InstancePtr->CanFdConfig.BaseAddress,
-					(XCANFD_TXDW_OFFSET(FreeTxBuffer)+
-					(Len)), OutValue);
-				DwIndex++;
-			}
-		}
-	}
+	XCanFd_WriteTxBuffer(InstancePtr, FreeTxBuffer, FramePtr);
 
 	Value = XCanFd_ReadReg(InstancePtr->CanFdConfig.BaseAddress,
 			XCANFD_TRR_OFFSET);
@@ -554,11 +506,6 @@ int XCanFd_Addto_Queue(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 {
 	u32 Result;
 	u32 FreeTxBuffer;
-	u32 DwIndex=0;
-	u32 Len;
-	u32 Dlc;
-	u32 CanEDL;
-	u32 OutValue;
 
 	Xil_AssertNonvoid(InstancePtr != NULL);
 	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
@@ -577,48 +524,8 @@ int XCanFd_Addto_Queue(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 			return XST_BUFFER_ALREADY_FILLED;
 		InstancePtr->MultiBuffTrr |= 1 << FreeTxBuffer;
 
-		/* Write ID to ID Register*/
-		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXID_OFFSET(FreeTxBuffer),FramePtr[0]);
-
-		/* Write DLC to DLC Register*/
-		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXDLC_OFFSET(FreeTxBuffer),FramePtr[1]);
-
-		CanEDL = XCanFd_ReadReg(InstancePtr->CanFdConfig.BaseAddress,
-				XCANFD_TXDLC_OFFSET(FreeTxBuffer));
-
-		Dlc = XCanFd_GetDlc2len(FramePtr[1] & XCANFD_DLCR_DLC_MASK);
-
-		if (CanEDL & XCANFD_DLCR_EDL_MASK) {
-
-			/* CAN FD Frames */
-			for (Len = 0;Len < Dlc;Len += 4) {
-				OutValue = Xil_EndianSwap32(
-						FramePtr[2+DwIndex]);
-				XCanFd_WriteReg(
-					InstancePtr->CanFdConfig.BaseAddress,
-						(XCANFD_TXDW_OFFSET(
-						FreeTxBuffer)+(DwIndex*
-						XCANFD_DW_BYTES)),OutValue);
-				DwIndex++;
-			}
-		}
-
-		else {
+		XCanFd_WriteTxBuffer(InstancePtr, FreeTxBuffer, FramePtr);
 
-			/* Legacy CAN Frames */
-			for (Len = 0;Len < Dlc;Len += 4) {
-				OutValue = Xil_EndianSwap32(
-						FramePtr[2+DwIndex]);
-				XCanFd_WriteReg(
-					InstancePtr->CanFdConfig.BaseAddress,
-						(XCANFD_TXDW_OFFSET(
-						FreeTxBuffer)+(Len)),
-						OutValue);
-				DwIndex++;
-			}
-		}
 		/* Assign  Buffer to user */
 		*TxBufferNumber = FreeTxBuffer;
 
@@ -629,6 +536,58 @@ int XCanFd_Addto_Queue(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber)
 	}
 }
 
+/*****************************************************************************/
+/**
+*
+* This function writes a CAN/CAN FD frame into a TxBuffer. It does not request
+* the transmission of the buffer, that is done by setting the bit of the
+* buffer in the TRR Register.
+*
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	FreeTxBuffer is the TxBuffer to write, which must not have a
+*		pending transmission request.
+* @param	FramePtr is a pointer to a 32-bit aligned buffer containing the
+*		CAN frame to be written.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XCanFd_WriteTxBuffer(XCanFd *InstancePtr, u32 FreeTxBuffer,
+				u32 *FramePtr)
+{
+	u32 DwIndex=0;
+	u32 Dlc;
+	u32 Len;
+	u32 OutValue;
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(FramePtr != NULL);
+	Xil_AssertVoid(FreeTxBuffer < 32);
+
+	/* Write ID to ID Register */
+	XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
+			XCANFD_TXID_OFFSET(FreeTxBuffer), FramePtr[0]);
+
+	/* Write DLC to DLC Register */
+	XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
+			XCANFD_TXDLC_OFFSET(FreeTxBuffer), FramePtr[1]);
+
+	/*
+	 * Write Data to Data Register, CAN FD and legacy CAN frames use the
+	 * same layout.
+	 */
+	Dlc = XCanFd_GetDlc2len(FramePtr[1] & XCANFD_DLCR_DLC_MASK);
+	for (Len = 0;Len < Dlc;Len += 4) {
+		OutValue = Xil_EndianSwap32(FramePtr[2+DwIndex]);
+		XCanFd_WriteReg(InstancePtr->CanFdConfig.BaseAddress,
+				(XCANFD_TXDW_OFFSET(FreeTxBuffer)+
+				(DwIndex*XCANFD_DW_BYTES)), OutValue);
+		DwIndex++;
+	}
+}
+
 /*****************************************************************************/
 /**
 *
@@ -127,6 +127,26 @@
 * If the incoming identifier passes through any acceptance filter then the
 * frame is stored in the RX FIFO.
 *
+* <b>Software TX Scheduling and RX Dispatch</b>
+*
+* XCanFd_TxSched_Submit() queues frames in software ordered by the ID
+* Register value, which orders frames the way bus arbitration does, and keeps
+* the TxBuffers filled with the highest priority frames. Frames of the same ID
+* are sent in submission order. When all TxBuffers are in use and a queued
+* frame has a higher priority than one in a TxBuffer, the lower priority
+* frame is cancelled and queued again if the driver is built with
+* XCANFD_TXSCHED_PREEMPT 1. The cancellation is requested without waiting for
+* the core, and the TxBuffer is refilled by the next call of
+* XCanFd_TxSched_Service() after the core has served it, so the
+* XCANFD_IXR_TXCRS_MASK event should call XCanFd_TxSched_Service() too. The
+* core cannot tell whether a frame that was on the bus when its cancellation
+* was requested went out, so such a frame may be sent twice, which is why
+* preemption is off by default.
+*
+* XCanFd_RxDispatch_Register() routes frames of one ID to a handler through a
+* hash table, and XCanFd_RxDispatch_Run() reads all received frames and calls
+* their handlers.
+*
 * <b>PHY Communication</b>
 *
 * This driver does not provide any mechanism for directly programming PHY.
@@ -249,6 +269,24 @@ extern "C" {
 #define XCANFD_HANDLER_EVENT  4 /**< Handler type for all other interrupts */
 /* @} */
 
+/** @name Software TX scheduler and RX dispatch configuration
+ *  @{
+ */
+#ifndef XCANFD_TXSCHED_DEPTH
+#define XCANFD_TXSCHED_DEPTH	32 /**< Frames in the software TX queue */
+#endif
+#ifndef XCANFD_TXSCHED_PREEMPT
+#define XCANFD_TXSCHED_PREEMPT	0 /**< Cancel lower priority TxBuffers for
+					higher priority queued frames */
+#endif
+#ifndef XCANFD_RXDISPATCH_SLOTS
+#define XCANFD_RXDISPATCH_SLOTS	64 /**< Slots in the RX dispatch table, a
+					power of 2 up to 65536 */
+#endif
+#define XCANFD_FRAME_WORDS	18 /**< Words of the largest frame, ID, DLC
+					and 64 data bytes */
+/* @} */
+
 /**************************** Type Definitions *******************************/
 
 /**
@@ -327,6 +365,81 @@ typedef struct {
 
 }XCanFd;
 
+/**
+ * @struct
+ * Statistics of the software TX scheduler.
+ */
+typedef struct {
+	u32 Submitted;		/**< Frames accepted into the queue */
+	u32 Sent;		/**< Frames sent from a TxBuffer */
+	u32 Preempted;		/**< Frames cancelled from a TxBuffer and
+				  *  queued again */
+	u32 QueueFull;		/**< Frames refused, queue full */
+	u32 MaxQueued;		/**< Highest number of frames waiting for a
+				  *  TxBuffer */
+} XCanFd_TxSchedStats;
+
+/**
+ * @struct
+ * A software TX queue ordered by arbitration priority. Frames wait here until
+ * a TxBuffer is available for them and the TxBuffers always hold the highest
+ * priority frames submitted.
+ */
+typedef struct {
+	XCanFd *InstancePtr;	/**< Instance the queue sends on */
+	u32 Frame[XCANFD_TXSCHED_DEPTH][XCANFD_FRAME_WORDS];
+				/**< Frame storage */
+	u32 Seq[XCANFD_TXSCHED_DEPTH];
+				/**< Submission order of each frame */
+	u16 Heap[XCANFD_TXSCHED_DEPTH];
+				/**< Queued frames, highest priority first */
+	u16 FreeList[XCANFD_TXSCHED_DEPTH];
+				/**< Unused frame storage */
+	u16 BufFrame[32];	/**< Frame held in each TxBuffer */
+	u32 NumQueued;		/**< Frames in Heap */
+	u32 NumFree;		/**< Entries in FreeList */
+	u32 NextSeq;		/**< Submission counter */
+	u32 BusyMask;		/**< TxBuffers holding a frame of the queue */
+	u32 CancelMask;		/**< TxBuffers with a cancellation requested */
+	XCanFd_TxSchedStats Stats;
+} XCanFd_TxSched;
+
+/*****************************************************************************/
+/**
+* Callback type for frames delivered by the RX dispatch table.
+*
+* @param	CallBackRef is the reference registered with the handler.
+* @param	FramePtr is the received frame, valid during the call only.
+*
+******************************************************************************/
+typedef void (*XCanFd_RxDispatchHandler) (void *CallBackRef, u32 *FramePtr);
+
+/**
+ * @struct
+ * One slot of the RX dispatch table.
+ */
+typedef struct {
+	u32 Key;				/**< Identifier bits of the ID */
+	XCanFd_RxDispatchHandler Handler;	/**< Handler, NULL if unused */
+	void *CallBackRef;			/**< Handler reference */
+} XCanFd_RxDispatchSlot;
+
+/**
+ * @struct
+ * Hashed table routing received frames to a handler per ID.
+ */
+typedef struct {
+	XCanFd *InstancePtr;	/**< Instance the frames are received on */
+	XCanFd_RxDispatchSlot Slot[XCANFD_RXDISPATCH_SLOTS];
+	XCanFd_RxDispatchHandler DefaultHandler;
+				/**< Handler for unregistered IDs, may be NULL */
+	void *DefaultRef;	/**< Default handler reference */
+	u32 Frame[XCANFD_FRAME_WORDS];
+				/**< Frame being dispatched */
+	u32 Dispatched;		/**< Frames given to a registered handler */
+	u32 Unhandled;		/**< Frames with no registered handler */
+} XCanFd_RxDispatch;
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /*****************************************************************************/
@@ -853,6 +966,30 @@ typedef struct {
 #define XCanFd_Get_RxBuffers(InstancePtr)	\
 		InstancePtr->CanFdConfig.NumofRxMbBuf;
 
+/****************************************************************************/
+/**
+*
+* This macro returns the slot of the RX dispatch table where the probe
+* sequence of a key starts. The identifier is shifted down to bit 0 first,
+* as a standard ID sits in bits [31:21] of the key, and the slot is taken
+* from the upper bits of a multiplicative hash of it, so that IDs which
+* differ in any bit spread over the whole table.
+*
+* @param	Key is the identifier bits of an ID Register value, with the
+*		extended ID bits cleared for standard frames.
+*
+* @return	The home slot, less than XCANFD_RXDISPATCH_SLOTS.
+*
+* @note		C-Style signature:
+*		u32 XCanFd_RxDispatch_HomeSlot(u32 Key);
+*
+*****************************************************************************/
+#define XCanFd_RxDispatch_HomeSlot(Key)					\
+	((((((((Key) & XCANFD_IDR_IDE_MASK) != 0U) ?			\
+	     ((Key) >> XCANFD_IDR_ID2_SHIFT) :				\
+	     ((Key) >> XCANFD_IDR_ID1_SHIFT)) * 0x9E3779B1U) >> 16) *	\
+	  (u32)XCANFD_RXDISPATCH_SLOTS) >> 16)
+
 /* Functions in xcan.c */
 int XCanFd_CfgInitialize(XCanFd *InstancePtr, XCanFd_Config *ConfigPtr,
 						UINTPTR EffectiveAddr);
@@ -882,6 +1019,8 @@ int XCanFd_GetNofMessages_Stored(XCanFd *InstancePtr);
 int XCanFd_Addto_Queue(XCanFd *InstancePtr, u32 *FramePtr,u32 *TxBufferNumber);
 void XCanFd_PollQueue_Buffer(XCanFd *InstancePtr);
 
+void XCanFd_WriteTxBuffer(XCanFd *InstancePtr, u32 FreeTxBuffer,
+				u32 *FramePtr);
 int XCanFd_TxBuffer_Cancel_Request(XCanFd *InstancePtr,u32 BufferNumber);
 int XCanFd_Get_Tranceiver_Delay_Compensation(XCanFd *InstancePtr);
 
@@ -928,6 +1067,22 @@ u32 XCanFd_Set_MailBox_IdMask(XCanFd *InstancePtr, u32 RxBuffer,
 u32 XCanFd_Recv_Sequential(XCanFd *InstancePtr, u32 *FramePtr);
 u32 XCanFd_Recv_Mailbox(XCanFd *InstancePtr, u32 *FramePtr);
 
+/* Functions in xcanfd_txsched.c */
+void XCanFd_TxSched_Initialize(XCanFd_TxSched *SchedPtr, XCanFd *InstancePtr);
+int XCanFd_TxSched_Submit(XCanFd_TxSched *SchedPtr, u32 *FramePtr);
+void XCanFd_TxSched_Service(XCanFd_TxSched *SchedPtr);
+void XCanFd_TxSched_GetStats(XCanFd_TxSched *SchedPtr,
+				XCanFd_TxSchedStats *StatsPtr);
+
+/* Functions in xcanfd_rxdispatch.c */
+void XCanFd_RxDispatch_Initialize(XCanFd_RxDispatch *DispatchPtr,
+		XCanFd *InstancePtr, XCanFd_RxDispatchHandler DefaultHandler,
+		void *DefaultRef);
+int XCanFd_RxDispatch_Register(XCanFd_RxDispatch *DispatchPtr, u32 Id,
+		XCanFd_RxDispatchHandler Handler, void *CallBackRef);
+int XCanFd_RxDispatch_Unregister(XCanFd_RxDispatch *DispatchPtr, u32 Id);
+u32 XCanFd_RxDispatch_Run(XCanFd_RxDispatch *DispatchPtr);
+
 /* Functions in xcanfd_sinit.c */
 XCanFd_Config *XCanFd_LookupConfig(u16 Deviceid);
 
@@ -0,0 +1,371 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xcanfd_rxdispatch.c
+* @addtogroup canfd_v1_0
+* @{
+*
+* This file contains the RX dispatch table. Handlers are registered per ID in
+* an open addressed hash table, so routing a received frame to its handler
+* takes constant time however many IDs are registered. The table uses linear
+* probing, and unregistering an ID moves the following entries of its probe
+* sequence back instead of leaving a marker, so lookups stay short however
+* often handlers are registered and removed. See xcanfd.h for a description
+* of the dispatch table.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date      Changes
+* ----- ---- --------- -------------------------------------------------------
+* 1.2        10/18/26  First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xcanfd.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Bits of the ID Register that identify a frame. SRR and RTR are left out so
+ * data and remote frames of an ID go to the same handler.
+ */
+#define XCANFD_RXDISPATCH_KEY_MASK	(XCANFD_IDR_ID1_MASK | \
+					 XCANFD_IDR_IDE_MASK | \
+					 XCANFD_IDR_ID2_MASK)
+
+/**************************** Type Definitions *******************************/
+
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+
+/************************** Variable Definitions *****************************/
+
+
+/************************** Function Prototypes ******************************/
+
+static void RxDispatchRecvHandler(void *CallBackRef);
+static u32 RxDispatchKey(u32 Id);
+static XCanFd_RxDispatchSlot *RxDispatchLookup(XCanFd_RxDispatch *DispatchPtr,
+						u32 Key);
+
+/****************************************************************************/
+/**
+*
+* This routine initializes an RX dispatch table and installs it as the
+* XCANFD_HANDLER_RECV handler of the instance, so received frames are
+* dispatched from the receive interrupt.
+*
+* @param	DispatchPtr is a pointer to the dispatch table.
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+* @param	DefaultHandler is called for frames of IDs without a
+*		registered handler, it may be NULL to drop them.
+* @param	DefaultRef is the reference passed to DefaultHandler.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XCanFd_RxDispatch_Initialize(XCanFd_RxDispatch *DispatchPtr,
+		XCanFd *InstancePtr, XCanFd_RxDispatchHandler DefaultHandler,
+		void *DefaultRef)
+{
+	u32 Index;
+
+	Xil_AssertVoid(DispatchPtr != NULL);
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertVoid((XCANFD_RXDISPATCH_SLOTS &
+			(XCANFD_RXDISPATCH_SLOTS - 1)) == 0);
+	Xil_AssertVoid(XCANFD_RXDISPATCH_SLOTS <= 0x10000);
+
+	DispatchPtr->InstancePtr = InstancePtr;
+	DispatchPtr->DefaultHandler = DefaultHandler;
+	DispatchPtr->DefaultRef = DefaultRef;
+	DispatchPtr->Dispatched = 0;
+	DispatchPtr->Unhandled = 0;
+
+	for (Index = 0; Index < XCANFD_RXDISPATCH_SLOTS; Index++) {
+		DispatchPtr->Slot[Index].Handler = NULL;
+	}
+
+	(void)XCanFd_SetHandler(InstancePtr, XCANFD_HANDLER_RECV,
+			(void *)RxDispatchRecvHandler, (void *)DispatchPtr);
+}
+
+/****************************************************************************/
+/**
+*
+* This routine registers the handler for the frames of one ID. A handler
+* already registered for the ID is replaced.
+*
+* @param	DispatchPtr is a pointer to the dispatch table.
+* @param	Id is the ID as written in the ID Register, see
+*		XCanFd_CreateIdValue(). The SRR and RTR bits are ignored.
+* @param	Handler is the handler of the frames.
+* @param	CallBackRef is the reference passed to Handler.
+*
+* @return	- XST_SUCCESS if the handler was registered.
+*		- XST_FAILURE if the table is full.
+*
+* @note		The table should not be filled to more than about three
+*		quarters of XCANFD_RXDISPATCH_SLOTS to keep lookups short.
+*
+*****************************************************************************/
+int XCanFd_RxDispatch_Register(XCanFd_RxDispatch *DispatchPtr, u32 Id,
+		XCanFd_RxDispatchHandler Handler, void *CallBackRef)
+{
+	XCanFd_RxDispatchSlot *SlotPtr;
+	XCanFd_RxDispatchSlot *FreePtr = NULL;
+	u32 Key = RxDispatchKey(Id);
+	u32 Index;
+	u32 Probe;
+
+	Xil_AssertNonvoid(DispatchPtr != NULL);
+	Xil_AssertNonvoid(Handler != NULL);
+
+	SlotPtr = RxDispatchLookup(DispatchPtr, Key);
+	if (SlotPtr == NULL) {
+
+		/* Take the first unused slot of the probe sequence */
+		Index = XCanFd_RxDispatch_HomeSlot(Key);
+		for (Probe = 0; Probe < XCANFD_RXDISPATCH_SLOTS; Probe++) {
+			if (DispatchPtr->Slot[Index].Handler == NULL) {
+				FreePtr = &DispatchPtr->Slot[Index];
+				break;
+			}
+			Index = (Index + 1) & (XCANFD_RXDISPATCH_SLOTS - 1);
+		}
+		if (FreePtr == NULL) {
+			return XST_FAILURE;
+		}
+		SlotPtr = FreePtr;
+		SlotPtr->Key = Key;
+	}
+
+	SlotPtr->CallBackRef = CallBackRef;
+	SlotPtr->Handler = Handler;
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This routine removes the handler of an ID. Frames of the ID go to the
+* default handler afterwards.
+*
+* @param	DispatchPtr is a pointer to the dispatch table.
+* @param	Id is the ID as written in the ID Register.
+*
+* @return	- XST_SUCCESS if the handler was removed.
+*		- XST_FAILURE if no handler was registered for the ID.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XCanFd_RxDispatch_Unregister(XCanFd_RxDispatch *DispatchPtr, u32 Id)
+{
+	XCanFd_RxDispatchSlot *SlotPtr;
+	u32 Hole;
+	u32 Index;
+	u32 Home;
+
+	Xil_AssertNonvoid(DispatchPtr != NULL);
+
+	SlotPtr = RxDispatchLookup(DispatchPtr, RxDispatchKey(Id));
+	if (SlotPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Move back each following entry of the run whose home slot does not
+	 * lie between the hole and the entry, so every entry stays reachable
+	 * from its home slot without crossing an unused slot.
+	 */
+	Hole = (u32)(SlotPtr - DispatchPtr->Slot);
+	SlotPtr->Handler = NULL;
+	Index = (Hole + 1) & (XCANFD_RXDISPATCH_SLOTS - 1);
+	while (DispatchPtr->Slot[Index].Handler != NULL) {
+		Home = XCanFd_RxDispatch_HomeSlot(DispatchPtr->Slot[Index].Key);
+		if (((Index - Home) & (XCANFD_RXDISPATCH_SLOTS - 1)) >=
+			((Index - Hole) & (XCANFD_RXDISPATCH_SLOTS - 1))) {
+			DispatchPtr->Slot[Hole] = DispatchPtr->Slot[Index];
+			DispatchPtr->Slot[Index].Handler = NULL;
+			Hole = Index;
+		}
+		Index = (Index + 1) & (XCANFD_RXDISPATCH_SLOTS - 1);
+	}
+
+	return XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This routine reads all received frames and passes each one to the handler
+* of its ID, or to the default handler.
+*
+* @param	DispatchPtr is a pointer to the dispatch table.
+*
+* @return	The number of frames read.
+*
+* @note		Frames are read with XCanFd_Recv_Mailbox() or
+*		XCanFd_Recv_Sequential() depending on the RX mode of the core.
+*
+*****************************************************************************/
+u32 XCanFd_RxDispatch_Run(XCanFd_RxDispatch *DispatchPtr)
+{
+	XCanFd *InstancePtr;
+	XCanFd_RxDispatchSlot *SlotPtr;
+	u32 Status;
+	u32 Count = 0;
+
+	Xil_AssertNonvoid(DispatchPtr != NULL);
+
+	InstancePtr = DispatchPtr->InstancePtr;
+
+	for (;;) {
+		if (XCANFD_GET_RX_MODE(InstancePtr) == 1) {
+			Status = XCanFd_Recv_Mailbox(InstancePtr,
+					DispatchPtr->Frame);
+		}
+		else {
+			Status = XCanFd_Recv_Sequential(InstancePtr,
+					DispatchPtr->Frame);
+		}
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+		Count++;
+
+		SlotPtr = RxDispatchLookup(DispatchPtr,
+				RxDispatchKey(DispatchPtr->Frame[0]));
+		if (SlotPtr != NULL) {
+			DispatchPtr->Dispatched++;
+			SlotPtr->Handler(SlotPtr->CallBackRef,
+					DispatchPtr->Frame);
+		}
+		else {
+			DispatchPtr->Unhandled++;
+			if (DispatchPtr->DefaultHandler != NULL) {
+				DispatchPtr->DefaultHandler(
+					DispatchPtr->DefaultRef,
+					DispatchPtr->Frame);
+			}
+		}
+	}
+
+	return Count;
+}
+
+/*****************************************************************************/
+/*
+*
+* The XCANFD_HANDLER_RECV handler installed by XCanFd_RxDispatch_Initialize().
+*
+* @param	CallBackRef is a pointer to the dispatch table.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void RxDispatchRecvHandler(void *CallBackRef)
+{
+	(void)XCanFd_RxDispatch_Run((XCanFd_RxDispatch *)CallBackRef);
+}
+
+/*****************************************************************************/
+/*
+*
+* This routine returns the hash key of an ID Register value.
+*
+* @param	Id is the ID Register value.
+*
+* @return	The identifier bits of Id, with the extended ID bits cleared
+*		for standard frames.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 RxDispatchKey(u32 Id)
+{
+	if (Id & XCANFD_IDR_IDE_MASK) {
+		return Id & XCANFD_RXDISPATCH_KEY_MASK;
+	}
+
+	return Id & XCANFD_IDR_ID1_MASK;
+}
+
+/*****************************************************************************/
+/*
+*
+* This routine finds the slot registered for a key.
+*
+* @param	DispatchPtr is a pointer to the dispatch table.
+* @param	Key is the key to look up.
+*
+* @return	The slot, or NULL if no handler is registered for the key.
+*
+* @note		None.
+*
+******************************************************************************/
+static XCanFd_RxDispatchSlot *RxDispatchLookup(XCanFd_RxDispatch *DispatchPtr,
+						u32 Key)
+{
+	XCanFd_RxDispatchSlot *SlotPtr;
+	u32 Index = XCanFd_RxDispatch_HomeSlot(Key);
+	u32 Probe;
+
+	for (Probe = 0; Probe < XCANFD_RXDISPATCH_SLOTS; Probe++) {
+		SlotPtr = &DispatchPtr->Slot[Index];
+		if (SlotPtr->Handler == NULL) {
+			/* End of the probe sequence */
+			break;
+		}
+		if (SlotPtr->Key == Key) {
+			return SlotPtr;
+		}
+		Index = (Index + 1) & (XCANFD_RXDISPATCH_SLOTS - 1);
+	}
+
+	return NULL;
+}
+/** @} */
@@ -0,0 +1,548 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xcanfd_txsched.c
+* @addtogroup canfd_v1_0
+* @{
+*
+* This file contains the software TX scheduler. Submitted frames are kept in
+* a binary heap ordered by ID Register value and submission order, and the
+* TxBuffers are refilled from the top of the heap whenever a frame has been
+* sent. See xcanfd.h for a description of the scheduler.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date      Changes
+* ----- ---- --------- -------------------------------------------------------
+* 1.2        10/18/26  First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xcanfd.h"
+
+/************************** Constant Definitions *****************************/
+
+
+/**************************** Type Definitions *******************************/
+
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/*
+ * Number of TxBuffers the scheduler may use.
+ */
+#define XCanFd_TxSched_NumBuffers(SchedPtr)				\
+	(((SchedPtr)->InstancePtr->CanFdConfig.NumofTxBuf < 32) ?	\
+		(SchedPtr)->InstancePtr->CanFdConfig.NumofTxBuf : 32)
+
+/************************** Variable Definitions *****************************/
+
+
+/************************** Function Prototypes ******************************/
+
+static void TxSchedSendHandler(void *CallBackRef);
+static int TxSchedBefore(XCanFd_TxSched *SchedPtr, u32 FrameA, u32 FrameB);
+static void TxSchedPush(XCanFd_TxSched *SchedPtr, u32 FrameIndex);
+static u32 TxSchedPop(XCanFd_TxSched *SchedPtr);
+static void TxSchedReap(XCanFd_TxSched *SchedPtr);
+static void TxSchedFill(XCanFd_TxSched *SchedPtr);
+static int TxSchedIdBusy(XCanFd_TxSched *SchedPtr, u32 Id);
+#if XCANFD_TXSCHED_PREEMPT
+static void TxSchedPreempt(XCanFd_TxSched *SchedPtr);
+#endif
+
+/****************************************************************************/
+/**
+*
+* This routine initializes a software TX scheduler and installs it as the
+* XCANFD_HANDLER_SEND handler of the instance, so the TxBuffers are refilled
+* from the TX OK interrupt. The XCANFD_IXR_TXOK_MASK interrupt must be
+* enabled by the user.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	InstancePtr is a pointer to the XCanFd instance to be worked on.
+*
+* @return	None.
+*
+* @note		The scheduler uses every TxBuffer that has no pending
+*		transmission request, so XCanFd_Send() should not be used on
+*		the same instance.
+*
+*****************************************************************************/
+void XCanFd_TxSched_Initialize(XCanFd_TxSched *SchedPtr, XCanFd *InstancePtr)
+{
+	u32 Index;
+
+	Xil_AssertVoid(SchedPtr != NULL);
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	SchedPtr->InstancePtr = InstancePtr;
+	SchedPtr->NumQueued = 0;
+	SchedPtr->NextSeq = 0;
+	SchedPtr->BusyMask = 0;
+	SchedPtr->CancelMask = 0;
+
+	for (Index = 0; Index < XCANFD_TXSCHED_DEPTH; Index++) {
+		SchedPtr->FreeList[Index] = (u16)Index;
+	}
+	SchedPtr->NumFree = XCANFD_TXSCHED_DEPTH;
+
+	SchedPtr->Stats.Submitted = 0;
+	SchedPtr->Stats.Sent = 0;
+	SchedPtr->Stats.Preempted = 0;
+	SchedPtr->Stats.QueueFull = 0;
+	SchedPtr->Stats.MaxQueued = 0;
+
+	(void)XCanFd_SetHandler(InstancePtr, XCANFD_HANDLER_SEND,
+			(void *)TxSchedSendHandler, (void *)SchedPtr);
+}
+
+/****************************************************************************/
+/**
+*
+* This routine submits a CAN/CAN FD frame to the scheduler. The frame is
+* copied, and written into a TxBuffer at once if its priority allows it.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	FramePtr is a pointer to a 32-bit aligned buffer containing the
+*		CAN frame to be sent.
+*
+* @return	- XST_SUCCESS if the frame was queued.
+*		- XST_FIFO_NO_ROOM if the software queue is full.
+*
+* @note		None.
+*
+*****************************************************************************/
+int XCanFd_TxSched_Submit(XCanFd_TxSched *SchedPtr, u32 *FramePtr)
+{
+	u32 IntrValue;
+	u32 FrameIndex;
+	u32 Dlc;
+	u32 Index;
+	int Status = XST_SUCCESS;
+
+	Xil_AssertNonvoid(SchedPtr != NULL);
+	Xil_AssertNonvoid(FramePtr != NULL);
+
+	/*
+	 * Keep the TX OK interrupt out while the queue is updated, the other
+	 * interrupts stay enabled.
+	 */
+	IntrValue = XCanFd_InterruptGetEnabled(SchedPtr->InstancePtr);
+	XCanFd_InterruptDisable(SchedPtr->InstancePtr, XCANFD_IXR_TXOK_MASK);
+
+	if (SchedPtr->NumFree == 0) {
+		SchedPtr->Stats.QueueFull++;
+		Status = XST_FIFO_NO_ROOM;
+	}
+	else {
+		SchedPtr->NumFree--;
+		FrameIndex = SchedPtr->FreeList[SchedPtr->NumFree];
+
+		Dlc = XCanFd_GetDlc2len(FramePtr[1] & XCANFD_DLCR_DLC_MASK);
+		for (Index = 0; Index < 2 + ((Dlc + 3) / 4); Index++) {
+			SchedPtr->Frame[FrameIndex][Index] = FramePtr[Index];
+		}
+		SchedPtr->Seq[FrameIndex] = SchedPtr->NextSeq++;
+
+		TxSchedPush(SchedPtr, FrameIndex);
+		SchedPtr->Stats.Submitted++;
+
+		XCanFd_TxSched_Service(SchedPtr);
+	}
+
+	if (IntrValue & XCANFD_IXR_TXOK_MASK) {
+		XCanFd_InterruptEnable(SchedPtr->InstancePtr,
+				XCANFD_IXR_TXOK_MASK);
+	}
+
+	return Status;
+}
+
+/****************************************************************************/
+/**
+*
+* This routine frees the TxBuffers whose frames have been sent and refills
+* them with the highest priority queued frames. It is called from the TX OK
+* interrupt and after each submission, and may also be called by the user
+* when the TX OK interrupt is not used.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	None.
+*
+* @note		The routine does not wait for the core, so it may be called
+*		from the XCANFD_IXR_TXCRS_MASK event to refill a cancelled
+*		TxBuffer at once.
+*
+*****************************************************************************/
+void XCanFd_TxSched_Service(XCanFd_TxSched *SchedPtr)
+{
+	Xil_AssertVoid(SchedPtr != NULL);
+
+	TxSchedReap(SchedPtr);
+	TxSchedFill(SchedPtr);
+
+#if XCANFD_TXSCHED_PREEMPT
+	TxSchedPreempt(SchedPtr);
+#endif
+
+	if (SchedPtr->NumQueued > SchedPtr->Stats.MaxQueued) {
+		SchedPtr->Stats.MaxQueued = SchedPtr->NumQueued;
+	}
+}
+
+/****************************************************************************/
+/**
+*
+* This routine returns the statistics of a software TX scheduler.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	StatsPtr is a pointer to the structure the statistics are
+*		copied to.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XCanFd_TxSched_GetStats(XCanFd_TxSched *SchedPtr,
+				XCanFd_TxSchedStats *StatsPtr)
+{
+	Xil_AssertVoid(SchedPtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+
+	*StatsPtr = SchedPtr->Stats;
+}
+
+/*****************************************************************************/
+/*
+*
+* The XCANFD_HANDLER_SEND handler installed by XCanFd_TxSched_Initialize().
+*
+* @param	CallBackRef is a pointer to the scheduler.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void TxSchedSendHandler(void *CallBackRef)
+{
+	XCanFd_TxSched_Service((XCanFd_TxSched *)CallBackRef);
+}
+
+/*****************************************************************************/
+/*
+*
+* This routine compares the priority of two queued frames. A lower ID
+* Register value wins arbitration, frames of equal ID keep submission order.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	FrameA is the index of the first frame.
+* @param	FrameB is the index of the second frame.
+*
+* @return	TRUE if FrameA is to be sent before FrameB, FALSE otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int TxSchedBefore(XCanFd_TxSched *SchedPtr, u32 FrameA, u32 FrameB)
+{
+	u32 IdA = SchedPtr->Frame[FrameA][0];
+	u32 IdB = SchedPtr->Frame[FrameB][0];
+
+	if (IdA != IdB) {
+		return (IdA < IdB) ? TRUE : FALSE;
+	}
+
+	return ((int)(SchedPtr->Seq[FrameA] - SchedPtr->Seq[FrameB]) < 0) ?
+			TRUE : FALSE;
+}
+
+/*****************************************************************************/
+/*
+*
+* This routine inserts a frame into the heap.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	FrameIndex is the index of the frame.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void TxSchedPush(XCanFd_TxSched *SchedPtr, u32 FrameIndex)
+{
+	u32 Pos = SchedPtr->NumQueued++;
+	u32 Parent;
+
+	while (Pos > 0) {
+		Parent = (Pos - 1) / 2;
+		if (TxSchedBefore(SchedPtr, FrameIndex,
+				SchedPtr->Heap[Parent]) == FALSE) {
+			break;
+		}
+		SchedPtr->Heap[Pos] = SchedPtr->Heap[Parent];
+		Pos = Parent;
+	}
+	SchedPtr->Heap[Pos] = (u16)FrameIndex;
+}
+
+/*****************************************************************************/
+/*
+*
+* This routine removes the highest priority frame from the heap. The heap
+* must not be empty.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	The index of the frame.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 TxSchedPop(XCanFd_TxSched *SchedPtr)
+{
+	u32 Top = SchedPtr->Heap[0];
+	u32 Last = SchedPtr->Heap[--SchedPtr->NumQueued];
+	u32 Pos = 0;
+	u32 Child;
+
+	while ((Child = (2 * Pos) + 1) < SchedPtr->NumQueued) {
+		if (((Child + 1) < SchedPtr->NumQueued) &&
+			(TxSchedBefore(SchedPtr, SchedPtr->Heap[Child + 1],
+				SchedPtr->Heap[Child]) == TRUE)) {
+			Child++;
+		}
+		if (TxSchedBefore(SchedPtr, SchedPtr->Heap[Child],
+				Last) == FALSE) {
+			break;
+		}
+		SchedPtr->Heap[Pos] = SchedPtr->Heap[Child];
+		Pos = Child;
+	}
+	SchedPtr->Heap[Pos] = (u16)Last;
+
+	return Top;
+}
+
+/*****************************************************************************/
+/*
+*
+* This routine frees the TxBuffers of the scheduler that no longer have a
+* pending transmission request. The frames of cancelled TxBuffers are queued
+* again.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void TxSchedReap(XCanFd_TxSched *SchedPtr)
+{
+	u32 Done;
+	u32 Cancelled;
+	u32 Buffer;
+
+	Done = SchedPtr->BusyMask &
+		~XCanFd_ReadReg(SchedPtr->InstancePtr->CanFdConfig.BaseAddress,
+				XCANFD_TRR_OFFSET);
+	SchedPtr->BusyMask &= ~Done;
+	Cancelled = Done & SchedPtr->CancelMask;
+	SchedPtr->CancelMask &= ~Done;
+
+	for (Buffer = 0; Done != 0; Buffer++) {
+		if (Done & (1 << Buffer)) {
+			Done &= ~(1 << Buffer);
+			if (Cancelled & (1 << Buffer)) {
+				TxSchedPush(SchedPtr, SchedPtr->BufFrame[Buffer]);
+				SchedPtr->Stats.Preempted++;
+			}
+			else {
+				SchedPtr->FreeList[SchedPtr->NumFree++] =
+					SchedPtr->BufFrame[Buffer];
+				SchedPtr->Stats.Sent++;
+			}
+		}
+	}
+}
+
+/*****************************************************************************/
+/*
+*
+* This routine writes the highest priority queued frames into the free
+* TxBuffers and requests their transmission.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void TxSchedFill(XCanFd_TxSched *SchedPtr)
+{
+	u32 Trr;
+	u32 Buffer;
+	u32 FrameIndex;
+	u32 NumBuffers = XCanFd_TxSched_NumBuffers(SchedPtr);
+
+	Trr = XCanFd_ReadReg(SchedPtr->InstancePtr->CanFdConfig.BaseAddress,
+			XCANFD_TRR_OFFSET);
+
+	for (Buffer = 0; (Buffer < NumBuffers) && (SchedPtr->NumQueued != 0);
+			Buffer++) {
+		if ((SchedPtr->BusyMask | Trr) & (1 << Buffer)) {
+			continue;
+		}
+
+		/*
+		 * The core sends TxBuffers of equal ID in buffer order, so a
+		 * frame waits while an earlier frame of its ID is pending.
+		 */
+		if (TxSchedIdBusy(SchedPtr,
+			SchedPtr->Frame[SchedPtr->Heap[0]][0]) == TRUE) {
+			break;
+		}
+
+		FrameIndex = TxSchedPop(SchedPtr);
+		XCanFd_WriteTxBuffer(SchedPtr->InstancePtr, Buffer,
+				SchedPtr->Frame[FrameIndex]);
+		SchedPtr->BufFrame[Buffer] = (u16)FrameIndex;
+		SchedPtr->BusyMask |= 1 << Buffer;
+
+		/* Writing 0 to a TRR bit has no effect */
+		XCanFd_WriteReg(SchedPtr->InstancePtr->CanFdConfig.BaseAddress,
+				XCANFD_TRR_OFFSET, 1 << Buffer);
+	}
+}
+
+/*****************************************************************************/
+/*
+*
+* This routine checks whether a TxBuffer of the scheduler holds a frame with
+* the given ID Register value.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+* @param	Id is the ID Register value.
+*
+* @return	TRUE if such a frame is in a TxBuffer, FALSE otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static int TxSchedIdBusy(XCanFd_TxSched *SchedPtr, u32 Id)
+{
+	u32 Busy = SchedPtr->BusyMask;
+	u32 Buffer;
+
+	for (Buffer = 0; Busy != 0; Buffer++) {
+		if (Busy & (1 << Buffer)) {
+			Busy &= ~(1 << Buffer);
+			if (SchedPtr->Frame[SchedPtr->BufFrame[Buffer]][0] == Id) {
+				return TRUE;
+			}
+		}
+	}
+
+	return FALSE;
+}
+
+#if XCANFD_TXSCHED_PREEMPT
+/*****************************************************************************/
+/*
+*
+* This routine requests the cancellation of the TxBuffer holding the lowest
+* priority frame when the highest priority queued frame outranks it. It only
+* has work to do when all TxBuffers are in use. The routine does not wait for
+* the core to serve the request, TxSchedReap() queues the frame again once
+* the transmission request of the TxBuffer is cleared.
+*
+* @param	SchedPtr is a pointer to the scheduler.
+*
+* @return	None.
+*
+* @note		One cancellation is outstanding at a time.
+*
+******************************************************************************/
+static void TxSchedPreempt(XCanFd_TxSched *SchedPtr)
+{
+	u32 Buffer;
+	u32 Victim;
+	u32 Busy;
+
+	Busy = SchedPtr->BusyMask;
+	if ((SchedPtr->NumQueued == 0) || (Busy == 0) ||
+			(SchedPtr->CancelMask != 0)) {
+		return;
+	}
+	if (TxSchedIdBusy(SchedPtr,
+			SchedPtr->Frame[SchedPtr->Heap[0]][0]) == TRUE) {
+		return;
+	}
+
+	/* Find the lowest priority frame in a TxBuffer */
+	Victim = 32;
+	for (Buffer = 0; Busy != 0; Buffer++) {
+		if (Busy & (1 << Buffer)) {
+			Busy &= ~(1 << Buffer);
+			if ((Victim == 32) || (TxSchedBefore(SchedPtr,
+				SchedPtr->BufFrame[Victim],
+				SchedPtr->BufFrame[Buffer]) == TRUE)) {
+				Victim = Buffer;
+			}
+		}
+	}
+
+	if (TxSchedBefore(SchedPtr, SchedPtr->Heap[0],
+			SchedPtr->BufFrame[Victim]) == FALSE) {
+		return;
+	}
+
+	/* Writing 0 to a TCR bit has no effect */
+	XCanFd_WriteReg(SchedPtr->InstancePtr->CanFdConfig.BaseAddress,
+			XCANFD_TCR_OFFSET, 1 << Victim);
+	SchedPtr->CancelMask = 1 << Victim;
+}
+#endif
+/** @} */
@@ -0,0 +1,931 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xcanfd_bus_sim.c
+*
+* Host test of the software TX scheduler and the RX dispatch table against a
+* register model of the CAN FD core on a simulated bus.
+*
+* The model keeps the TxBuffers, the TRR, TCR, ISR, IER and ICR registers and
+* a sequential RX FIFO. Whenever the bus is idle the pending TxBuffer with
+* the lowest ID arbitrates against the frames of the other nodes, and the
+* lowest ID is sent. A frame takes its nominal and data phase bits at 500
+* kbit/s and 2 Mbit/s with BRS, followed by the intermission. At the end of
+* the frame the TRR bit is cleared and TX OK is raised; the interrupt handler
+* of the driver runs a fixed latency later. A cancellation request of a
+* TxBuffer that is not on the bus is served at once and raises TXCRS, one of
+* a TxBuffer on the bus is served when the frame ends, and the frame is sent.
+*
+* The node sends periodic frames of four IDs and bursts of bulk frames of
+* eight low priority IDs, the other nodes send random frames. Each frame carries its
+* sequence number in its first data word, and the latency from submission to
+* the end of its transmission is recorded per ID, for the scheduler and for
+* the usual application queue in submission order that writes frames into
+* any TxBuffer without a pending request.
+*
+* The checks are that:
+*  - every submitted frame is sent and, without preemption, sent once,
+*  - the scheduler sends the frames of an ID in submission order,
+*  - the scheduler statistics match the frames the model sent,
+*  - with the scheduler the worst case latency of the highest priority ID
+*    stays within two frames of the longest length, the bulk bursts
+*    notwithstanding,
+*  - the RX dispatch table routes received frames to the handler of their
+*    ID and to the default handler, through a long series of registrations
+*    and removals,
+*  - the probe sequences of the dispatch table stay short, for random IDs
+*    and for blocks of consecutive standard and extended IDs.
+*
+* Usage: xcanfd_bus_sim [seconds] [interrupt latency in us] [seed]
+*
+* The defaults are 10 s, 2 us and 1. The second build,
+* xcanfd_bus_sim_preempt, enables XCANFD_TXSCHED_PREEMPT and reports the
+* frames sent twice when a cancelled frame was already on the bus.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.2        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xcanfd.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE	0x43C00000U	/* CAN FD registers */
+#define SIM_REGS	0x4000U		/* Size of the register space */
+#define SIM_TXBUF	8U		/* TxBuffers of the core */
+#define SIM_TXBUF_BASE	0x0100U		/* TxBuffer 0 ID register */
+#define SIM_RXBUF_BASE	0x1100U		/* RxBuffer 0 ID register */
+#define SIM_RXBUF	32U		/* RxBuffers in sequential mode */
+#define SIM_BUF_SIZE	XCANFD_MAX_FRAME_SIZE
+
+#define SIM_NOM_NS	2000U		/* Nominal bit time, 500 kbit/s */
+#define SIM_DATA_NS	500U		/* Data bit time, 2 Mbit/s */
+#define SIM_IFS_NS	(3U * SIM_NOM_NS)
+#define SIM_MAX_FRAMES	400000U		/* Frames tracked per run */
+#define SIM_OTHER_MAX	64U		/* Frames queued by the other nodes */
+#define SIM_NONE	0xFFFFFFFFU
+#define SIM_NEVER	(~(u64t)0U)
+
+#define SIM_FIFO	0U		/* Application queue, submission order */
+#define SIM_SCHED	1U		/* Software TX scheduler */
+
+#define SIM_DISPATCH_IDS	48U	/* IDs registered at most */
+#define SIM_MAX_PROBE	10U	/* Longest probe allowed, on average for
+					   random IDs */
+
+/**************************** Type Definitions *******************************/
+
+typedef unsigned long long u64t;
+
+typedef struct {
+	u32 Id;			/* Standard ID */
+	u32 NumIds;		/* IDs from Id used in turn */
+	u32 Len;		/* Data bytes */
+	u64t Period;		/* ns */
+	u32 Burst;		/* Frames submitted each period */
+	u64t NextAt;
+	u32 Frames;
+	double LatSum;
+	u64t LatMax;
+} SimStream;
+
+typedef struct {
+	u32 Stream;
+	u64t SubmitAt;
+	u32 SentCount;
+} SimFrame;
+
+/************************** Variable Definitions *****************************/
+
+static u32 SimReg[SIM_REGS / 4U];
+static u64t SimNow;
+static u64t IrqLatency = 2000U;
+static u64t Seed = 1U;
+
+/* Bus */
+static u32 BusBusy;
+static u32 BusBuffer;		/* TxBuffer on the bus, SIM_NONE for others */
+static u64t TxDoneAt = SIM_NEVER;
+static u64t BusFreeAt = SIM_NEVER;
+static u64t IrqAt = SIM_NEVER;
+
+/* Other nodes, lowest ID sent first */
+static u32 OtherId[SIM_OTHER_MAX];
+static u32 OtherLen[SIM_OTHER_MAX];
+static u32 NumOther;
+static u64t OtherAt;
+
+/* RX FIFO */
+static u32 RxRead;
+static u32 RxFill;
+
+static SimStream Streams[] = {
+	{ 0x010U, 1U,  8U,  1000000U,  1U },
+	{ 0x080U, 1U, 16U,  5000000U,  1U },
+	{ 0x100U, 1U, 32U, 10000000U,  1U },
+	{ 0x200U, 1U, 64U, 20000000U,  1U },
+	{ 0x600U, 8U, 64U, 50000000U, 24U },
+};
+#define SIM_STREAMS	(sizeof(Streams) / sizeof(Streams[0]))
+
+static SimFrame Frames[SIM_MAX_FRAMES];
+static u32 LastSent[0x800U];	/* Sequence number sent last per ID */
+static u32 NumFrames;
+static u32 Duplicates;
+static u32 Errors;
+static u32 Mode;
+
+static XCanFd CanFd;
+XCanFd_Config XCanFd_ConfigTable[XPAR_XCANFD_NUM_INSTANCES] = {
+	{ 0U, SIM_BASE, 0U, 0U, SIM_TXBUF }
+};
+static XCanFd_TxSched Sched;
+
+/* Application queue of the SIM_FIFO runs */
+static u32 AppQueue[XCANFD_TXSCHED_DEPTH][XCANFD_FRAME_WORDS];
+static u32 AppHead;
+static u32 AppCount;
+static u32 AppFull;
+
+/* RX dispatch */
+static XCanFd_RxDispatch Dispatch;
+static u32 DispatchRef[0x800U];	/* Handler reference of each ID, 0 if none */
+static u32 Delivered;		/* Reference passed to the last call */
+static u32 DeliveredId;
+
+/************************** Function Definitions *****************************/
+
+static u32 SimRand(u32 Range)
+{
+	Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+	return (u32)(Seed >> 33) % Range;
+}
+
+static void SimFail(const char *What, u32 Value)
+{
+	if (Errors < 10U) {
+		printf("  FAIL at %.3f ms: %s (%u)\n", SimNow / 1e6, What,
+			Value);
+	}
+	Errors++;
+}
+
+static u32 SimLen2Dlc(u32 Len)
+{
+	static const u8 Dlc[] = { 8U, 9U, 10U, 11U, 12U, 13U, 14U, 15U };
+	static const u8 Bytes[] = { 8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U };
+	u32 Index;
+
+	if (Len <= 8U) {
+		return Len;
+	}
+	for (Index = 0U; Bytes[Index] < Len; Index++) {
+	}
+
+	return Dlc[Index];
+}
+
+/* Duration of a CAN FD frame with BRS and a standard ID, without stuff bits */
+static u64t SimFrameNs(u32 Len)
+{
+	u32 NomBits = 17U + 11U;	/* SOF to BRS, CRC delimiter to EOF */
+	u32 DataBits = 5U + (8U * Len) + 4U + ((Len > 16U) ? 21U : 17U);
+
+	return ((u64t)NomBits * SIM_NOM_NS) + ((u64t)DataBits * SIM_DATA_NS);
+}
+
+/* Lowest priority of the bus, used as the bound of the checks */
+static u64t SimMaxFrameNs(void)
+{
+	return SimFrameNs(64U) + SIM_IFS_NS;
+}
+
+/*****************************************************************************/
+/*
+* Register model
+*/
+static void SimRaise(u32 Mask)
+{
+	SimReg[XCANFD_ISR_OFFSET / 4U] |= Mask;
+	if ((SimReg[XCANFD_ISR_OFFSET / 4U] & SimReg[XCANFD_IER_OFFSET / 4U]) &&
+			(IrqAt == SIM_NEVER)) {
+		IrqAt = SimNow + IrqLatency;
+	}
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Offset = (u32)(Addr - SIM_BASE);
+
+	if (Offset == XCANFD_FSR_OFFSET) {
+		return (RxFill << 8) | RxRead;
+	}
+
+	return SimReg[Offset / 4U];
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset = (u32)(Addr - SIM_BASE);
+	u32 Served;
+
+	switch (Offset) {
+	case XCANFD_SRR_OFFSET:
+		if (Value & XCANFD_SRR_SRST_MASK) {
+			memset(SimReg, 0, sizeof(SimReg));
+			RxRead = 0U;
+			RxFill = 0U;
+		}
+		else {
+			SimReg[Offset / 4U] = Value;
+		}
+		break;
+
+	case XCANFD_TRR_OFFSET:
+		/* Writing 0 to a bit has no effect */
+		SimReg[Offset / 4U] |= Value & ((1U << SIM_TXBUF) - 1U);
+		break;
+
+	case XCANFD_TCR_OFFSET:
+		Value &= SimReg[XCANFD_TRR_OFFSET / 4U];
+		if (BusBusy && (BusBuffer != SIM_NONE)) {
+			/* Served when the frame on the bus ends */
+			SimReg[Offset / 4U] |= Value & (1U << BusBuffer);
+			Value &= ~(1U << BusBuffer);
+		}
+		Served = Value;
+		if (Served != 0U) {
+			SimReg[XCANFD_TRR_OFFSET / 4U] &= ~Served;
+			SimRaise(XCANFD_IXR_TXCRS_MASK);
+		}
+		break;
+
+	case XCANFD_ICR_OFFSET:
+		SimReg[XCANFD_ISR_OFFSET / 4U] &= ~Value;
+		break;
+
+	case XCANFD_ISR_OFFSET:
+		break;
+
+	case XCANFD_IER_OFFSET:
+		SimReg[Offset / 4U] = Value;
+		SimRaise(0U);
+		break;
+
+	case XCANFD_FSR_OFFSET:
+		if ((Value & XCANFD_FSR_IRI_MASK) && (RxFill != 0U)) {
+			RxRead = (RxRead + 1U) % SIM_RXBUF;
+			RxFill--;
+		}
+		break;
+
+	default:
+		SimReg[Offset / 4U] = Value;
+		break;
+	}
+}
+
+/*****************************************************************************/
+/*
+* Traffic
+*/
+static void SimBuildFrame(u32 *FramePtr, u32 Id, u32 Len, u32 Seq)
+{
+	memset(FramePtr, 0, XCANFD_FRAME_WORDS * 4U);
+	FramePtr[0] = XCanFd_CreateIdValue(Id, 0U, 0U, 0U, 0U);
+	FramePtr[1] = XCanFd_Create_CanFD_Dlc_BrsValue(SimLen2Dlc(Len));
+	FramePtr[2] = Seq;
+}
+
+static void AppFill(void)
+{
+	u32 Trr = XCanFd_ReadReg(SIM_BASE, XCANFD_TRR_OFFSET);
+	u32 Buffer;
+
+	for (Buffer = 0U; (Buffer < SIM_TXBUF) && (AppCount != 0U); Buffer++) {
+		if ((Trr & (1U << Buffer)) == 0U) {
+			XCanFd_WriteTxBuffer(&CanFd, Buffer, AppQueue[AppHead]);
+			XCanFd_WriteReg(SIM_BASE, XCANFD_TRR_OFFSET,
+					1U << Buffer);
+			AppHead = (AppHead + 1U) % XCANFD_TXSCHED_DEPTH;
+			AppCount--;
+		}
+	}
+}
+
+static void AppSendHandler(void *CallBackRef)
+{
+	(void)CallBackRef;
+	AppFill();
+}
+
+static void SimEventHandler(void *CallBackRef, u32 Mask)
+{
+	(void)CallBackRef;
+	if ((Mode == SIM_SCHED) && (Mask & XCANFD_IXR_TXCRS_MASK)) {
+		XCanFd_TxSched_Service(&Sched);
+	}
+}
+
+static void SimErrorHandler(void *CallBackRef, u32 Mask)
+{
+	(void)CallBackRef;
+	SimFail("error interrupt", Mask);
+}
+
+static void SimSubmit(u32 StreamIndex)
+{
+	SimStream *St = &Streams[StreamIndex];
+	u32 Frame[XCANFD_FRAME_WORDS];
+	u32 Count;
+
+	for (Count = 0U; Count < St->Burst; Count++) {
+		if (NumFrames == SIM_MAX_FRAMES) {
+			return;
+		}
+		SimBuildFrame(Frame, St->Id + (Count % St->NumIds), St->Len,
+				NumFrames);
+
+		if (Mode == SIM_SCHED) {
+			if (XCanFd_TxSched_Submit(&Sched, Frame) !=
+					XST_SUCCESS) {
+				continue;
+			}
+		}
+		else {
+			if (AppCount == XCANFD_TXSCHED_DEPTH) {
+				AppFull++;
+				continue;
+			}
+			memcpy(AppQueue[(AppHead + AppCount) %
+				XCANFD_TXSCHED_DEPTH], Frame, sizeof(Frame));
+			AppCount++;
+			AppFill();
+		}
+
+		Frames[NumFrames].Stream = StreamIndex;
+		Frames[NumFrames].SubmitAt = SimNow;
+		Frames[NumFrames].SentCount = 0U;
+		NumFrames++;
+	}
+}
+
+static void SimOtherArrival(void)
+{
+	static const u32 Ids[] = { 0x020U, 0x180U, 0x400U, 0x700U };
+
+	if (NumOther < SIM_OTHER_MAX) {
+		OtherId[NumOther] = Ids[SimRand(4U)];
+		OtherLen[NumOther] = 16U;
+		NumOther++;
+	}
+	OtherAt = SimNow + 1U + SimRand(4000000U);
+}
+
+/* Arbitration among the pending TxBuffers and the other nodes */
+static void SimArbitrate(void)
+{
+	u32 Trr = SimReg[XCANFD_TRR_OFFSET / 4U];
+	u32 BestId = SIM_NONE;
+	u32 Best = SIM_NONE;
+	u32 Other = SIM_NONE;
+	u32 Buffer;
+	u32 Id;
+	u32 Index;
+	u32 Len;
+
+	for (Buffer = 0U; Buffer < SIM_TXBUF; Buffer++) {
+		if (Trr & (1U << Buffer)) {
+			Id = SimReg[(SIM_TXBUF_BASE + (Buffer * SIM_BUF_SIZE)) /
+					4U] >> XCANFD_IDR_ID1_SHIFT;
+			if (Id < BestId) {
+				BestId = Id;
+				Best = Buffer;
+			}
+		}
+	}
+	for (Index = 0U; Index < NumOther; Index++) {
+		if (OtherId[Index] < BestId) {
+			BestId = OtherId[Index];
+			Other = Index;
+		}
+	}
+	if (BestId == SIM_NONE) {
+		return;
+	}
+
+	if (Other != SIM_NONE) {
+		Len = OtherLen[Other];
+		NumOther--;
+		OtherId[Other] = OtherId[NumOther];
+		OtherLen[Other] = OtherLen[NumOther];
+		BusBuffer = SIM_NONE;
+	}
+	else {
+		Len = XCanFd_GetDlc2len(SimReg[(SIM_TXBUF_BASE + 4U +
+			(Best * SIM_BUF_SIZE)) / 4U] & XCANFD_DLCR_DLC_MASK);
+		BusBuffer = Best;
+	}
+	BusBusy = 1U;
+	TxDoneAt = SimNow + SimFrameNs(Len);
+	BusFreeAt = TxDoneAt + SIM_IFS_NS;
+}
+
+static void SimTxDone(void)
+{
+	u32 Buffer = BusBuffer;
+	u32 Seq;
+	u32 Id;
+	SimFrame *Fr;
+	SimStream *St;
+	u64t Latency;
+
+	TxDoneAt = SIM_NEVER;
+	if (Buffer == SIM_NONE) {
+		return;
+	}
+
+	Id = SimReg[(SIM_TXBUF_BASE + (Buffer * SIM_BUF_SIZE)) / 4U] >>
+			XCANFD_IDR_ID1_SHIFT;
+	Seq = Xil_EndianSwap32(SimReg[(SIM_TXBUF_BASE + 8U +
+			(Buffer * SIM_BUF_SIZE)) / 4U]);
+	SimReg[XCANFD_TRR_OFFSET / 4U] &= ~(1U << Buffer);
+	SimReg[XCANFD_TCR_OFFSET / 4U] &= ~(1U << Buffer);
+	BusBuffer = SIM_NONE;
+	SimRaise(XCANFD_IXR_TXOK_MASK);
+
+	if (Seq >= NumFrames) {
+		SimFail("unknown frame sent", Seq);
+		return;
+	}
+	Fr = &Frames[Seq];
+	St = &Streams[Fr->Stream];
+	Fr->SentCount++;
+	if (Fr->SentCount > 1U) {
+		Duplicates++;
+		return;
+	}
+
+	if ((Mode == SIM_SCHED) && (LastSent[Id] != SIM_NONE) &&
+			(Seq < LastSent[Id])) {
+		SimFail("frames of an ID sent out of order", Id);
+	}
+	if ((LastSent[Id] == SIM_NONE) || (Seq > LastSent[Id])) {
+		LastSent[Id] = Seq;
+	}
+
+	Latency = SimNow - Fr->SubmitAt;
+	St->Frames++;
+	St->LatSum += (double)Latency;
+	if (Latency > St->LatMax) {
+		St->LatMax = Latency;
+	}
+}
+
+static void SimStep(u64t End)
+{
+	u64t Next = SIM_NEVER;
+	u32 Index;
+	u32 Which = SIM_NONE;
+
+	if (TxDoneAt < Next) {
+		Next = TxDoneAt;
+		Which = 100U;
+	}
+	if (BusBusy && (BusFreeAt < Next)) {
+		Next = BusFreeAt;
+		Which = 101U;
+	}
+	if (IrqAt < Next) {
+		Next = IrqAt;
+		Which = 102U;
+	}
+	if ((End != SIM_NEVER) && (OtherAt < Next)) {
+		Next = OtherAt;
+		Which = 103U;
+	}
+	for (Index = 0U; (End != SIM_NEVER) && (Index < SIM_STREAMS);
+			Index++) {
+		if (Streams[Index].NextAt < Next) {
+			Next = Streams[Index].NextAt;
+			Which = Index;
+		}
+	}
+
+	SimNow = Next;
+	switch (Which) {
+	case 100U:
+		SimTxDone();
+		break;
+	case 101U:
+		BusBusy = 0U;
+		BusFreeAt = SIM_NEVER;
+		break;
+	case 102U:
+		IrqAt = SIM_NEVER;
+		XCanFd_IntrHandler(&CanFd);
+		SimRaise(0U);
+		break;
+	case 103U:
+		SimOtherArrival();
+		break;
+	default:
+		SimSubmit(Which);
+		Streams[Which].NextAt += Streams[Which].Period;
+		break;
+	}
+
+	if (!BusBusy) {
+		SimArbitrate();
+	}
+}
+
+static u32 RunMode(u32 RunMode, u64t Duration)
+{
+	u64t FirstSeed = Seed;
+	u32 Index;
+	u32 Lost = 0U;
+	u32 Sent = 0U;
+	u32 StartErrors = Errors;
+	XCanFd_TxSchedStats Stats;
+
+	Mode = RunMode;
+	SimNow = 0U;
+	BusBusy = 0U;
+	BusBuffer = SIM_NONE;
+	TxDoneAt = SIM_NEVER;
+	BusFreeAt = SIM_NEVER;
+	IrqAt = SIM_NEVER;
+	NumOther = 0U;
+	NumFrames = 0U;
+	Duplicates = 0U;
+	AppHead = 0U;
+	AppCount = 0U;
+	AppFull = 0U;
+
+	(void)XCanFd_CfgInitialize(&CanFd, &XCanFd_ConfigTable[0], SIM_BASE);
+	XCanFd_SetHandler(&CanFd, XCANFD_HANDLER_EVENT,
+			(void *)SimEventHandler, NULL);
+	XCanFd_SetHandler(&CanFd, XCANFD_HANDLER_ERROR,
+			(void *)SimErrorHandler, NULL);
+	if (Mode == SIM_SCHED) {
+		XCanFd_TxSched_Initialize(&Sched, &CanFd);
+	}
+	else {
+		XCanFd_SetHandler(&CanFd, XCANFD_HANDLER_SEND,
+				(void *)AppSendHandler, NULL);
+	}
+	XCanFd_InterruptEnable(&CanFd, XCANFD_IXR_TXOK_MASK |
+			XCANFD_IXR_TXCRS_MASK);
+
+	/* The same traffic for both runs */
+	for (Index = 0U; Index < SIM_STREAMS; Index++) {
+		Streams[Index].NextAt = SimRand(1000000U);
+		Streams[Index].Frames = 0U;
+		Streams[Index].LatSum = 0.0;
+		Streams[Index].LatMax = 0U;
+	}
+	OtherAt = SimRand(4000000U);
+	memset(LastSent, 0xFF, sizeof(LastSent));
+
+	while (SimNow < Duration) {
+		SimStep(Duration);
+	}
+
+	/* Drain the queues */
+	while ((TxDoneAt != SIM_NEVER) || (IrqAt != SIM_NEVER) ||
+			(BusFreeAt != SIM_NEVER)) {
+		SimStep(SIM_NEVER);
+	}
+	Seed = FirstSeed;
+
+	for (Index = 0U; Index < NumFrames; Index++) {
+		if (Frames[Index].SentCount == 0U) {
+			Lost++;
+		}
+		else {
+			Sent++;
+		}
+	}
+
+	printf("%s\n", (Mode == SIM_SCHED) ? "software TX scheduler" :
+			"application queue in submission order");
+	printf("  %-11s %6s %8s %8s %10s %10s\n", "ID", "bytes", "period",
+		"frames", "mean us", "worst us");
+	for (Index = 0U; Index < SIM_STREAMS; Index++) {
+		if (Streams[Index].NumIds > 1U) {
+			printf("  0x%03x-0x%03x", Streams[Index].Id,
+				Streams[Index].Id + Streams[Index].NumIds - 1U);
+		}
+		else {
+			printf("  0x%03x      ", Streams[Index].Id);
+		}
+		printf(" %6u %5llu ms %8u %10.1f %10.1f\n", Streams[Index].Len,
+			Streams[Index].Period / 1000000U,
+			Streams[Index].Frames,
+			(Streams[Index].Frames != 0U) ?
+			Streams[Index].LatSum / Streams[Index].Frames / 1e3 :
+			0.0, Streams[Index].LatMax / 1e3);
+	}
+
+	if (Lost != 0U) {
+		SimFail("frames never sent", Lost);
+	}
+	if (Mode == SIM_SCHED) {
+		XCanFd_TxSched_GetStats(&Sched, &Stats);
+		printf("  submitted %u, sent %u, preempted %u, sent twice %u, "
+			"queue full %u, most queued %u\n", Stats.Submitted,
+			Stats.Sent, Stats.Preempted, Duplicates,
+			Stats.QueueFull, Stats.MaxQueued);
+		if ((Stats.Submitted != NumFrames) ||
+				(Stats.Sent != Sent + Duplicates)) {
+			SimFail("statistics do not match the bus", Stats.Sent);
+		}
+		if (Stats.QueueFull != 0U) {
+			SimFail("queue full", Stats.QueueFull);
+		}
+#if !XCANFD_TXSCHED_PREEMPT
+		if (Duplicates != 0U) {
+			SimFail("frames sent twice", Duplicates);
+		}
+#endif
+		if (Streams[0].LatMax > 2U * SimMaxFrameNs()) {
+			SimFail("highest priority ID waited too long, us",
+				(u32)(Streams[0].LatMax / 1000U));
+		}
+	}
+	else {
+		printf("  submitted %u, queue full %u\n", NumFrames, AppFull);
+	}
+	printf("\n");
+
+	return Errors - StartErrors;
+}
+
+/*****************************************************************************/
+/*
+* RX dispatch
+*/
+static void DispatchHandler(void *CallBackRef, u32 *FramePtr)
+{
+	Delivered = (u32)(UINTPTR)CallBackRef;
+	DeliveredId = FramePtr[0] >> XCANFD_IDR_ID1_SHIFT;
+}
+
+static void DispatchDefault(void *CallBackRef, u32 *FramePtr)
+{
+	(void)CallBackRef;
+	Delivered = 0U;
+	DeliveredId = FramePtr[0] >> XCANFD_IDR_ID1_SHIFT;
+}
+
+static void RxPush(u32 Id, u32 Seq)
+{
+	u32 Index = (RxRead + RxFill) % SIM_RXBUF;
+	u32 Offset = SIM_RXBUF_BASE + (Index * SIM_BUF_SIZE);
+
+	SimReg[Offset / 4U] = XCanFd_CreateIdValue(Id, 0U, 0U, 0U, 0U);
+	SimReg[(Offset + 4U) / 4U] = XCanFd_Create_CanFD_DlcValue(8U);
+	SimReg[(Offset + 8U) / 4U] = Xil_EndianSwap32(Seq);
+	SimReg[(Offset + 12U) / 4U] = 0U;
+	RxFill++;
+}
+
+/*
+ * Returns the longest distance of an entry of the table from its home slot.
+ */
+static u32 DispatchMaxProbe(void)
+{
+	u32 Index;
+	u32 Probe;
+	u32 MaxProbe = 0U;
+
+	for (Index = 0U; Index < XCANFD_RXDISPATCH_SLOTS; Index++) {
+		if (Dispatch.Slot[Index].Handler == NULL) {
+			continue;
+		}
+		Probe = (Index - XCanFd_RxDispatch_HomeSlot(
+				Dispatch.Slot[Index].Key)) &
+			(XCANFD_RXDISPATCH_SLOTS - 1U);
+		if (Probe > MaxProbe) {
+			MaxProbe = Probe;
+		}
+	}
+
+	return MaxProbe;
+}
+
+/*
+ * Registers a block of consecutive standard or extended IDs, as
+ * applications usually allocate them, and returns the longest probe.
+ */
+static u32 DispatchDenseIds(u32 Extended)
+{
+	u32 Count;
+	u32 Id;
+
+	XCanFd_RxDispatch_Initialize(&Dispatch, &CanFd, DispatchDefault, NULL);
+	for (Count = 0U; Count < SIM_DISPATCH_IDS; Count++) {
+		if (Extended != 0U) {
+			Id = XCanFd_CreateIdValue(0x123U, 1U, 1U,
+					0x20000U + Count, 0U);
+		}
+		else {
+			Id = XCanFd_CreateIdValue(0x100U + Count, 0U, 0U, 0U,
+					0U);
+		}
+		if (XCanFd_RxDispatch_Register(&Dispatch, Id, DispatchHandler,
+				NULL) != XST_SUCCESS) {
+			SimFail("register failed", Id);
+		}
+	}
+
+	return DispatchMaxProbe();
+}
+
+static u32 RunDispatch(u32 Rounds)
+{
+	u32 Ids[SIM_DISPATCH_IDS];
+	u32 NumIds = 0U;
+	u32 StartErrors = Errors;
+	u32 Round;
+	u32 Index;
+	u32 Id;
+	u32 Used;
+	u32 Count;
+	u32 Frames = 0U;
+	u32 Probe;
+	u32 MaxProbe;
+	u64t SumProbe = 0U;
+	u32 DenseStd;
+	u32 DenseExt;
+
+	memset(DispatchRef, 0, sizeof(DispatchRef));
+	XCanFd_ConfigTable[0].Rx_Mode = 0U;
+	(void)XCanFd_CfgInitialize(&CanFd, &XCanFd_ConfigTable[0], SIM_BASE);
+
+	DenseStd = DispatchDenseIds(0U);
+	DenseExt = DispatchDenseIds(1U);
+	if ((DenseStd > SIM_MAX_PROBE) || (DenseExt > SIM_MAX_PROBE)) {
+		SimFail("probe too long, consecutive standard IDs", DenseStd);
+		SimFail("probe too long, consecutive extended IDs", DenseExt);
+	}
+
+	MaxProbe = 0U;
+	XCanFd_RxDispatch_Initialize(&Dispatch, &CanFd, DispatchDefault, NULL);
+
+	for (Round = 0U; Round < Rounds; Round++) {
+
+		/* Register or remove an ID, keeping the table 40-75% full */
+		if ((NumIds < 26U) || ((NumIds < SIM_DISPATCH_IDS) &&
+				(SimRand(2U) == 0U))) {
+			do {
+				Id = SimRand(0x800U);
+			} while (DispatchRef[Id] != 0U);
+			DispatchRef[Id] = Round + 1U;
+			Ids[NumIds++] = Id;
+			if (XCanFd_RxDispatch_Register(&Dispatch,
+				XCanFd_CreateIdValue(Id, 0U, 0U, 0U, 0U),
+				DispatchHandler,
+				(void *)(UINTPTR)DispatchRef[Id]) !=
+					XST_SUCCESS) {
+				SimFail("register failed", Id);
+			}
+		}
+		else {
+			Index = SimRand(NumIds);
+			Id = Ids[Index];
+			Ids[Index] = Ids[--NumIds];
+			DispatchRef[Id] = 0U;
+			if (XCanFd_RxDispatch_Unregister(&Dispatch,
+				XCanFd_CreateIdValue(Id, 0U, 0U, 0U, 0U)) !=
+					XST_SUCCESS) {
+				SimFail("unregister failed", Id);
+			}
+		}
+
+		/* Receive registered and unregistered IDs */
+		for (Count = 0U; Count < 4U; Count++) {
+			Id = (Count & 1U) ? Ids[SimRand(NumIds)] :
+					SimRand(0x800U);
+			RxPush(Id, Frames++);
+			Delivered = SIM_NONE;
+			if (XCanFd_RxDispatch_Run(&Dispatch) != 1U) {
+				SimFail("frame not read", Id);
+			}
+			if ((DeliveredId != Id) ||
+					(Delivered != DispatchRef[Id])) {
+				SimFail("frame given to the wrong handler", Id);
+			}
+		}
+
+		/* Every entry of the table is a registered ID */
+		Used = 0U;
+		for (Index = 0U; Index < XCANFD_RXDISPATCH_SLOTS; Index++) {
+			if (Dispatch.Slot[Index].Handler != NULL) {
+				Used++;
+			}
+		}
+		if (Used != NumIds) {
+			SimFail("table entries do not match the IDs", Used);
+		}
+
+		/* Lookups stay short */
+		Probe = DispatchMaxProbe();
+		SumProbe += Probe;
+		if (Probe > MaxProbe) {
+			MaxProbe = Probe;
+		}
+	}
+
+	/*
+	 * At the fill of this test the longest probe of random IDs is about 6
+	 * slots on average with a good hash, single tables reach 35 or more.
+	 */
+	if (SumProbe > (u64t)SIM_MAX_PROBE * Rounds) {
+		SimFail("probe sequences too long, average of the longest",
+			(u32)(SumProbe / Rounds));
+	}
+
+	printf("RX dispatch: %u registrations and removals, %u frames, "
+		"%u dispatched, %u to the default handler\n", Rounds,
+		Frames, Dispatch.Dispatched, Dispatch.Unhandled);
+	printf("longest probe: random IDs %.1f on average, %u at most, "
+		"consecutive IDs %u standard, %u extended\n\n",
+		(double)SumProbe / Rounds, MaxProbe, DenseStd, DenseExt);
+
+	return Errors - StartErrors;
+}
+
+int main(int argc, char *argv[])
+{
+	u64t Duration = 10U;
+	u32 Failed = 0U;
+
+	if (argc > 1) {
+		Duration = strtoull(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		IrqLatency = strtoull(argv[2], NULL, 0) * 1000U;
+	}
+	if (argc > 3) {
+		Seed = strtoull(argv[3], NULL, 0);
+	}
+	Duration *= 1000000000U;
+
+	printf("model: %llu s, %u TxBuffers, interrupt latency %llu us, "
+		"preemption %s\n\n", Duration / 1000000000U, SIM_TXBUF,
+		IrqLatency / 1000U, XCANFD_TXSCHED_PREEMPT ? "on" : "off");
+
+	Failed += RunMode(SIM_FIFO, Duration);
+	Failed += RunMode(SIM_SCHED, Duration);
+	Failed += RunDispatch(200000U);
+
+	printf("%s\n", (Failed == 0U) ? "all checks passed" :
+						"CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}
@@ -0,0 +1,26 @@
+# Common part of the host builds of the driver tests. A driver's tests
+# Makefile sets TESTS, and optionally CFLAGS and extra CPPFLAGS, includes
+# this file and then adds one rule per test. The driver sources are compiled
+# against the stand-in headers of this directory and the common BSP headers.
+# Headers in the driver's own tests directory take precedence.
+#
+#   make        build the tests
+#   make run    build and run them
+
+HOST_TESTS := $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))
+
+CC ?= gcc
+BSP_COMMON = ../../../../lib/bsp/standalone/src/common
+CFLAGS ?= -O2 -g -Wall
+CPPFLAGS += -I. -I../src -I$(HOST_TESTS) -I$(BSP_COMMON) -include stdio.h \
+	-Dxil_printf=printf
+
+all: $(TESTS)
+
+run: all
+	@set -e; for Test in $(TESTS); do echo ./$$Test; ./$$Test; done
+
+clean:
+	rm -f $(TESTS)
+
+.PHONY: all run clean
@@ -0,0 +1,58 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xil_cache.h
+*
+* Host build stand-in for the BSP xil_cache.h, shared by the driver tests.
+* The host is cache coherent. Tests that count or charge the cache
+* maintenance define SIM_CACHE_CALLS and implement the functions. Otherwise
+* only the length is evaluated, because some drivers cast the address to u32
+* for their 32-bit targets.
+*
+******************************************************************************/
+
+#ifndef XIL_CACHE_H	/* prevent circular inclusions */
+#define XIL_CACHE_H	/* by using protection macros */
+
+#ifdef SIM_CACHE_CALLS
+#include "xil_types.h"
+
+void Xil_DCacheFlushRange(UINTPTR Addr, u32 Len);
+void Xil_DCacheInvalidateRange(UINTPTR Addr, u32 Len);
+#else
+#define Xil_DCacheFlushRange(Addr, Len)		((void)(Len))
+#define Xil_DCacheInvalidateRange(Addr, Len)	((void)(Len))
+#endif
+
+#endif /* end of protection macro */
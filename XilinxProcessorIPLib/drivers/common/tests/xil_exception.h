@@ -0,0 +1,67 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xil_exception.h
+*
+* Host build stand-in for the BSP xil_exception.h, shared by the driver
+* tests. The IRQ mask bit of the CPSR is simulated by SimCpsr, which the test
+* program defines. Enabling nested interrupts calls SimEnableNested(), so a
+* test that dispatches nested interrupts can unmask SimCpsr and take a
+* nested exception while a handler runs.
+*
+******************************************************************************/
+
+#ifndef XIL_EXCEPTION_H	/* prevent circular inclusions */
+#define XIL_EXCEPTION_H	/* by using protection macros */
+
+#include "xil_types.h"
+
+#define XIL_EXCEPTION_IRQ	0x80U
+
+typedef void (*Xil_ExceptionHandler)(void *data);
+typedef void (*Xil_InterruptHandler)(void *data);
+
+extern u32 SimCpsr;
+
+void SimEnableNested(void);
+void SimDisableNested(void);
+
+#define mfcpsr()		(SimCpsr)
+#define Xil_ExceptionEnable()	(SimCpsr &= ~XIL_EXCEPTION_IRQ)
+#define Xil_ExceptionDisable()	(SimCpsr |= XIL_EXCEPTION_IRQ)
+
+#define Xil_EnableNestedInterrupts()	SimEnableNested()
+#define Xil_DisableNestedInterrupts()	SimDisableNested()
+
+#endif /* end of protection macro */
@@ -0,0 +1,58 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xtime_l.h
+*
+* Host build stand-in for the BSP xtime_l.h, shared by the driver tests. The
+* time is SimTime, which the test program defines and advances. Its unit is
+* up to the test, nanoseconds unless the Makefile sets COUNTS_PER_SECOND.
+*
+******************************************************************************/
+
+#ifndef XTIME_H	/* prevent circular inclusions */
+#define XTIME_H	/* by using protection macros */
+
+#include "xil_types.h"
+
+#ifndef COUNTS_PER_SECOND
+#define COUNTS_PER_SECOND	1000000000U
+#endif
+
+typedef u64 XTime;
+
+extern u64 SimTime;
+
+#define XTime_GetTime(Xtime)	(*(Xtime) = SimTime)
+
+#endif /* end of protection macro */
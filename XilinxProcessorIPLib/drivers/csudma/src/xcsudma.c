@@ -501,6 +501,37 @@ void XCsuDma_ClearCheckSum(XCsuDma *InstancePtr)
 		(u32)(XCSUDMA_CRC_OFFSET), (u32)(XCSUDMA_CRC_RESET_MASK));
 }
 
+/*****************************************************************************/
+/**
+*
+* This function acknowledges all the completed transfers of the selected
+* channel, resetting the done count reported by XCsuDma_GetDoneCount to zero.
+*
+* @param	InstancePtr is a pointer to XCsuDma instance to be worked on.
+* @param	Channel represents the type of channel either it is Source or
+*		Destination.
+*		Source channel      - XCSUDMA_SRC_CHANNEL
+*		Destination Channel - XCSUDMA_DST_CHANNEL
+*
+* @return	None.
+*
+* @note		The done count saturates at 7, so it should be cleared before
+*		it is used to track a new sequence of transfers.
+*
+******************************************************************************/
+void XCsuDma_ClearDoneCount(XCsuDma *InstancePtr, XCsuDma_Channel Channel)
+{
+	/* Verify arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid((Channel == (XCSUDMA_SRC_CHANNEL)) ||
+					(Channel == (XCSUDMA_DST_CHANNEL)));
+
+	XCsuDma_WriteReg(InstancePtr->Config.BaseAddress,
+		((u32)(XCSUDMA_STS_OFFSET) +
+			((u32)Channel * (u32)(XCSUDMA_OFFSET_DIFF))),
+				(u32)(XCSUDMA_STS_DONE_CNT_MASK));
+}
+
 /*****************************************************************************/
 /**
 * This function cofigures all the values of CSU_DMA's Channels with the values
@@ -150,6 +150,32 @@ typedef enum {
 
 /*@}*/
 
+/** @name Chained transfer options
+ * @{
+ */
+/**
+ * Number of commands kept queued on each channel by the chained transfer
+ * API. With 2 the next chunk is programmed while the current one is moving
+ * data, so the channel does not idle between chunks. Each channel buffers
+ * the command it is executing and one more; a further write to the SIZE
+ * register is dropped and flagged with INVALID_APB in the channel's I_STS
+ * register (Zynq UltraScale+ MPSoC TRM UG1085, "CSU DMA", and register
+ * reference UG1087, CSUDMA_SRC_I_STS/CSUDMA_DST_I_STS). 2 is therefore also
+ * the maximum.
+ */
+#ifndef XCSUDMA_CHAIN_DEPTH
+#define XCSUDMA_CHAIN_DEPTH	2U
+#endif
+
+/**
+ * When non-zero the chained transfer API timestamps each transfer with
+ * XTime so its throughput can be read back. Requires xtime_l.h in the BSP.
+ */
+#ifndef XCSUDMA_CHAIN_STATS
+#define XCSUDMA_CHAIN_STATS	0
+#endif
+/*@}*/
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /*****************************************************************************/
@@ -362,6 +388,40 @@ typedef struct {
 				  *  commands */
 }XCsuDma_Configure;
 
+/******************************************************************************/
+/**
+* This typedef contains the state of a chained transfer. A large transfer is
+* split into chunks of at most ChunkBytes, and up to XCSUDMA_CHAIN_DEPTH
+* chunks are kept queued on each channel so that the DMA is never left idle
+* waiting for software to program the next chunk. All the fields are private
+* to the driver.
+*/
+typedef struct {
+	XCsuDma *InstancePtr;		/**< CSU_DMA used for the transfer */
+	UINTPTR Addr[2];		/**< Next address to be issued, per
+					  *  channel */
+	u64 Remaining[2];		/**< Bytes not yet issued, per channel */
+	u32 Outstanding[2];		/**< Issued chunks not yet completed,
+					  *  per channel */
+	u32 ChunkBytes;			/**< Maximum bytes per command */
+	u8 EnDataLast;			/**< Assert data_inp_last on the final
+					  *  source chunk */
+	UINTPTR NextAddr;		/**< Source buffer appended behind the
+					  *  one being issued */
+	u64 NextSize;			/**< Size of the appended buffer, 0 if
+					  *  none */
+	u32 EndMask;			/**< Outstanding source chunks that end
+					  *  a buffer, oldest in bit 0 */
+	u32 Buffers;			/**< Source buffers completed */
+	u8 Channels;			/**< Bit mask of the channels still
+					  *  active, indexed by XCsuDma_Channel */
+	u64 Bytes;			/**< Size of the current transfer */
+	u64 StartTime;			/**< XTime at start, when
+					  *  XCSUDMA_CHAIN_STATS is set */
+	u64 Cycles;			/**< XTime ticks taken by the last
+					  *  completed transfer */
+}XCsuDma_Chain;
+
 /*****************************************************************************/
 
 
@@ -409,6 +469,20 @@ u32 XCsuDma_GetIntrMask(XCsuDma *InstancePtr, XCsuDma_Channel Channel);
 
 s32 XCsuDma_SelfTest(XCsuDma *InstancePtr);
 
+/* Chained transfer APIs */
+void XCsuDma_ChainInit(XCsuDma *InstancePtr, XCsuDma_Chain *ChainPtr,
+							u32 ChunkBytes);
+s32 XCsuDma_ChainStart(XCsuDma_Chain *ChainPtr, UINTPTR SrcAddr, u64 SrcSize,
+			UINTPTR DstAddr, u64 DstSize, u8 EnDataLast);
+s32 XCsuDma_ChainAppend(XCsuDma_Chain *ChainPtr, UINTPTR SrcAddr,
+							u64 SrcSize);
+s32 XCsuDma_ChainPoll(XCsuDma_Chain *ChainPtr);
+u32 XCsuDma_ChainGetBuffers(XCsuDma_Chain *ChainPtr);
+void XCsuDma_ChainWait(XCsuDma_Chain *ChainPtr);
+s32 XCsuDma_ChainTransfer(XCsuDma *InstancePtr, UINTPTR SrcAddr, u64 SrcSize,
+			UINTPTR DstAddr, u64 DstSize, u8 EnDataLast);
+u64 XCsuDma_ChainGetThroughput(XCsuDma_Chain *ChainPtr);
+
 /******************************************************************************/
 
 #ifdef __cplusplus
@@ -0,0 +1,571 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+*
+* @file xcsudma_chain.c
+* @addtogroup csudma_v1_0
+* @{
+*
+* This file contains the chained transfer functions of the CSU_DMA driver.
+*
+* A chained transfer splits a buffer of any size into chunks no larger than
+* the SIZE register allows (or a smaller, caller chosen chunk) and keeps up
+* to XCSUDMA_CHAIN_DEPTH chunks queued on each channel. The next chunk,
+* including its cache maintenance, is programmed while the current one is
+* moving data, so the channel does not idle between commands the way it does
+* with back to back XCsuDma_Transfer/XCsuDma_WaitForDone calls.
+*
+* Completion is tracked with the per channel done count, which this driver
+* acknowledges as it goes. The DONE interrupt status bit of each channel used
+* is cleared once the whole transfer has completed.
+*
+* Further source buffers can be appended to a transfer in progress with
+* XCsuDma_ChainAppend. The first chunk of an appended buffer is queued right
+* behind the last chunk of the one before it, so a consumer fed buffer by
+* buffer (SHA, PCAP) sees one continuous stream. XCsuDma_ChainGetBuffers
+* tells how many of the buffers have completed.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who     Date     Changes
+* ----- ------  -------- ---------------------------------------------------
+* 1.1           10/18/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xcsudma.h"
+#if XCSUDMA_CHAIN_STATS
+#include "xtime_l.h"
+#endif
+
+/************************** Constant Definitions *****************************/
+
+/** Largest chunk a single command can move, in bytes */
+#define XCSUDMA_CHAIN_MAX_CHUNK	((u32)(XCSUDMA_SIZE_MAX) << \
+					(u32)(XCSUDMA_SIZE_SHIFT))
+
+/* The command queue of a channel holds two commands, see xcsudma.h */
+#if (XCSUDMA_CHAIN_DEPTH < 1) || (XCSUDMA_CHAIN_DEPTH > 2)
+#error "XCSUDMA_CHAIN_DEPTH must be 1 or 2"
+#endif
+
+/************************** Function Prototypes ******************************/
+
+static void XCsuDma_ChainIssue(XCsuDma_Chain *ChainPtr,
+					XCsuDma_Channel Channel);
+static void XCsuDma_ChainReap(XCsuDma_Chain *ChainPtr,
+					XCsuDma_Channel Channel);
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+*
+* This function initializes a chained transfer context for the given CSU_DMA.
+*
+* @param	InstancePtr is a pointer to XCsuDma instance to be worked on.
+* @param	ChainPtr is a pointer to the chained transfer context.
+* @param	ChunkBytes is the maximum number of bytes moved by a single
+*		command. It must be a multiple of 4. Pass 0 to use the largest
+*		size the hardware supports.
+*
+* @return	None.
+*
+* @note		Smaller chunks let the cache maintenance of the next chunk
+*		overlap with the current one, at the cost of more commands.
+*
+******************************************************************************/
+void XCsuDma_ChainInit(XCsuDma *InstancePtr, XCsuDma_Chain *ChainPtr,
+							u32 ChunkBytes)
+{
+	/* Verify arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(ChainPtr != NULL);
+	Xil_AssertVoid((ChunkBytes & (u32)(XCSUDMA_ADDR_LSB_MASK)) == 0U);
+	Xil_AssertVoid(ChunkBytes <= (u32)(XCSUDMA_CHAIN_MAX_CHUNK));
+	Xil_AssertVoid(InstancePtr->IsReady == (u32)(XIL_COMPONENT_IS_READY));
+
+	ChainPtr->InstancePtr = InstancePtr;
+	ChainPtr->Remaining[XCSUDMA_SRC_CHANNEL] = 0U;
+	ChainPtr->Remaining[XCSUDMA_DST_CHANNEL] = 0U;
+	ChainPtr->Outstanding[XCSUDMA_SRC_CHANNEL] = 0U;
+	ChainPtr->Outstanding[XCSUDMA_DST_CHANNEL] = 0U;
+	ChainPtr->Channels = 0U;
+	ChainPtr->NextSize = 0U;
+	ChainPtr->EndMask = 0U;
+	ChainPtr->Buffers = 0U;
+	ChainPtr->Bytes = 0U;
+	ChainPtr->StartTime = 0U;
+	ChainPtr->Cycles = 0U;
+	if (ChunkBytes == 0U) {
+		ChainPtr->ChunkBytes = (u32)(XCSUDMA_CHAIN_MAX_CHUNK);
+	}
+	else {
+		ChainPtr->ChunkBytes = ChunkBytes;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This function starts a chained transfer on the source and/or destination
+* channel and returns without waiting for it to complete. Use
+* XCsuDma_ChainPoll or XCsuDma_ChainWait to drive it to completion.
+*
+* @param	ChainPtr is a pointer to an initialized chained transfer
+*		context.
+* @param	SrcAddr is the address data is read from by the source channel.
+* @param	SrcSize is the number of bytes to read, a multiple of 4. Pass 0
+*		to leave the source channel unused.
+* @param	DstAddr is the address data is written to by the destination
+*		channel.
+* @param	DstSize is the number of bytes to write, a multiple of 4. Pass 0
+*		to leave the destination channel unused.
+* @param	EnDataLast asserts data_inp_last when set to 1. It applies only
+*		to the final chunk of the source channel.
+*
+* @return
+*		- XST_SUCCESS if the transfer was started, or both sizes are 0.
+*		- XST_DEVICE_BUSY if a transfer on this context is still in
+*		progress.
+*
+* @note		The channels used must be idle; the done count of each one is
+*		cleared before the first chunk is issued.
+*
+******************************************************************************/
+s32 XCsuDma_ChainStart(XCsuDma_Chain *ChainPtr, UINTPTR SrcAddr, u64 SrcSize,
+			UINTPTR DstAddr, u64 DstSize, u8 EnDataLast)
+{
+	/* Verify arguments */
+	Xil_AssertNonvoid(ChainPtr != NULL);
+	Xil_AssertNonvoid(ChainPtr->InstancePtr != NULL);
+	Xil_AssertNonvoid((SrcAddr & (UINTPTR)(XCSUDMA_ADDR_LSB_MASK)) == 0U);
+	Xil_AssertNonvoid((DstAddr & (UINTPTR)(XCSUDMA_ADDR_LSB_MASK)) == 0U);
+	Xil_AssertNonvoid((SrcSize & (u64)(XCSUDMA_ADDR_LSB_MASK)) == 0U);
+	Xil_AssertNonvoid((DstSize & (u64)(XCSUDMA_ADDR_LSB_MASK)) == 0U);
+
+	if (ChainPtr->Channels != 0U) {
+		return (s32)(XST_DEVICE_BUSY);
+	}
+
+	ChainPtr->Addr[XCSUDMA_SRC_CHANNEL] = SrcAddr;
+	ChainPtr->Remaining[XCSUDMA_SRC_CHANNEL] = SrcSize;
+	ChainPtr->Outstanding[XCSUDMA_SRC_CHANNEL] = 0U;
+	ChainPtr->Addr[XCSUDMA_DST_CHANNEL] = DstAddr;
+	ChainPtr->Remaining[XCSUDMA_DST_CHANNEL] = DstSize;
+	ChainPtr->Outstanding[XCSUDMA_DST_CHANNEL] = 0U;
+	ChainPtr->EnDataLast = EnDataLast;
+	ChainPtr->NextSize = 0U;
+	ChainPtr->EndMask = 0U;
+	ChainPtr->Buffers = 0U;
+	ChainPtr->Bytes = (SrcSize != 0U) ? SrcSize : DstSize;
+
+	if (SrcSize != 0U) {
+		ChainPtr->Channels |= (u8)(1U << (u32)XCSUDMA_SRC_CHANNEL);
+		XCsuDma_ClearDoneCount(ChainPtr->InstancePtr,
+						XCSUDMA_SRC_CHANNEL);
+	}
+	if (DstSize != 0U) {
+		ChainPtr->Channels |= (u8)(1U << (u32)XCSUDMA_DST_CHANNEL);
+		XCsuDma_ClearDoneCount(ChainPtr->InstancePtr,
+						XCSUDMA_DST_CHANNEL);
+	}
+
+#if XCSUDMA_CHAIN_STATS
+	{
+		XTime Now;
+
+		XTime_GetTime(&Now);
+		ChainPtr->StartTime = (u64)Now;
+	}
+#endif
+
+	/*
+	 * The destination is queued first so that the data produced by the
+	 * source always has somewhere to go.
+	 */
+	XCsuDma_ChainIssue(ChainPtr, XCSUDMA_DST_CHANNEL);
+	XCsuDma_ChainIssue(ChainPtr, XCSUDMA_SRC_CHANNEL);
+
+	return (s32)(XST_SUCCESS);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function appends a source buffer to the chained transfer in progress.
+* Its chunks are issued once the buffers before it have been fully issued,
+* the first one as soon as there is room in the command queue.
+*
+* @param	ChainPtr is a pointer to the chained transfer context.
+* @param	SrcAddr is the address data is read from by the source channel.
+* @param	SrcSize is the number of bytes to read, a non-zero multiple
+*		of 4.
+*
+* @return
+*		- XST_SUCCESS if the buffer was appended.
+*		- XST_DEVICE_BUSY if an appended buffer is still waiting to be
+*		issued. Call again after XCsuDma_ChainPoll.
+*		- XST_FAILURE if the source channel of this context is not
+*		active. Use XCsuDma_ChainStart instead.
+*
+* @note		Only source only transfers started with EnDataLast 0 can be
+*		appended to.
+*
+******************************************************************************/
+s32 XCsuDma_ChainAppend(XCsuDma_Chain *ChainPtr, UINTPTR SrcAddr, u64 SrcSize)
+{
+	/* Verify arguments */
+	Xil_AssertNonvoid(ChainPtr != NULL);
+	Xil_AssertNonvoid((SrcAddr & (UINTPTR)(XCSUDMA_ADDR_LSB_MASK)) == 0U);
+	Xil_AssertNonvoid((SrcSize & (u64)(XCSUDMA_ADDR_LSB_MASK)) == 0U);
+	Xil_AssertNonvoid(SrcSize != 0U);
+	Xil_AssertNonvoid(ChainPtr->EnDataLast == 0U);
+
+	if (ChainPtr->Channels != (u8)(1U << (u32)XCSUDMA_SRC_CHANNEL)) {
+		return (s32)(XST_FAILURE);
+	}
+	if (ChainPtr->NextSize != 0U) {
+		return (s32)(XST_DEVICE_BUSY);
+	}
+
+	ChainPtr->NextAddr = SrcAddr;
+	ChainPtr->NextSize = SrcSize;
+	ChainPtr->Bytes += SrcSize;
+
+	XCsuDma_ChainIssue(ChainPtr, XCSUDMA_SRC_CHANNEL);
+
+	return (s32)(XST_SUCCESS);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function collects the chunks completed since the last call, queues the
+* following ones and reports whether the whole transfer has completed.
+*
+* @param	ChainPtr is a pointer to the chained transfer context.
+*
+* @return
+*		- XST_SUCCESS if the transfer has completed, or none was
+*		started.
+*		- XST_DEVICE_BUSY if it is still in progress.
+*
+* @note		None.
+*
+******************************************************************************/
+s32 XCsuDma_ChainPoll(XCsuDma_Chain *ChainPtr)
+{
+	u32 Index;
+
+	/* Verify arguments */
+	Xil_AssertNonvoid(ChainPtr != NULL);
+
+	if (ChainPtr->Channels == 0U) {
+		return (s32)(XST_SUCCESS);
+	}
+
+	for (Index = 0U; Index < 2U; Index++) {
+		if ((ChainPtr->Channels & (u8)(1U << Index)) == 0U) {
+			continue;
+		}
+
+		XCsuDma_ChainReap(ChainPtr, (XCsuDma_Channel)Index);
+		XCsuDma_ChainIssue(ChainPtr, (XCsuDma_Channel)Index);
+
+		if ((ChainPtr->Remaining[Index] == 0U) &&
+				(ChainPtr->Outstanding[Index] == 0U)) {
+			/*
+			 * Leave the DONE status clear, as callers that mix
+			 * this with XCsuDma_WaitForDone expect.
+			 */
+			XCsuDma_IntrClear(ChainPtr->InstancePtr,
+				(XCsuDma_Channel)Index,
+					(u32)(XCSUDMA_IXR_DONE_MASK));
+			ChainPtr->Channels &= (u8)~(1U << Index);
+		}
+	}
+
+	if (ChainPtr->Channels != 0U) {
+		return (s32)(XST_DEVICE_BUSY);
+	}
+
+#if XCSUDMA_CHAIN_STATS
+	{
+		XTime Now;
+
+		XTime_GetTime(&Now);
+		ChainPtr->Cycles = (u64)(XTime)(Now -
+					(XTime)ChainPtr->StartTime);
+	}
+#endif
+
+	return (s32)(XST_SUCCESS);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the number of source buffers of the current chained
+* transfer, the one passed to XCsuDma_ChainStart and each appended one, that
+* have completed.
+*
+* @param	ChainPtr is a pointer to the chained transfer context.
+*
+* @return	Number of completed source buffers, as of the last
+*		XCsuDma_ChainPoll.
+*
+* @note		Buffers complete in the order they were given.
+*
+******************************************************************************/
+u32 XCsuDma_ChainGetBuffers(XCsuDma_Chain *ChainPtr)
+{
+	/* Verify arguments */
+	Xil_AssertNonvoid(ChainPtr != NULL);
+
+	return ChainPtr->Buffers;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function busy waits until the chained transfer has completed.
+*
+* @param	ChainPtr is a pointer to the chained transfer context.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void XCsuDma_ChainWait(XCsuDma_Chain *ChainPtr)
+{
+	/* Verify arguments */
+	Xil_AssertVoid(ChainPtr != NULL);
+
+	while (XCsuDma_ChainPoll(ChainPtr) != (s32)(XST_SUCCESS)) {
+		;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This function performs a blocking chained transfer with the largest chunk
+* size. It is a drop-in replacement for a XCsuDma_Transfer and
+* XCsuDma_WaitForDone sequence that also accepts transfers larger than
+* XCSUDMA_SIZE_MAX words.
+*
+* @param	InstancePtr is a pointer to XCsuDma instance to be worked on.
+* @param	SrcAddr is the address data is read from by the source channel.
+* @param	SrcSize is the number of bytes to read, 0 if unused.
+* @param	DstAddr is the address data is written to by the destination
+*		channel.
+* @param	DstSize is the number of bytes to write, 0 if unused.
+* @param	EnDataLast asserts data_inp_last on the final source word
+*		when set to 1.
+*
+* @return	XST_SUCCESS once the transfer has completed.
+*
+* @note		None.
+*
+******************************************************************************/
+s32 XCsuDma_ChainTransfer(XCsuDma *InstancePtr, UINTPTR SrcAddr, u64 SrcSize,
+			UINTPTR DstAddr, u64 DstSize, u8 EnDataLast)
+{
+	XCsuDma_Chain Chain;
+	s32 Status;
+
+	XCsuDma_ChainInit(InstancePtr, &Chain, 0U);
+
+	Status = XCsuDma_ChainStart(&Chain, SrcAddr, SrcSize, DstAddr, DstSize,
+								EnDataLast);
+	if (Status == (s32)(XST_SUCCESS)) {
+		XCsuDma_ChainWait(&Chain);
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function returns the throughput of the last completed chained transfer.
+*
+* @param	ChainPtr is a pointer to the chained transfer context.
+*
+* @return	Throughput in bytes per second, or 0 if XCSUDMA_CHAIN_STATS is
+*		not enabled or no transfer has completed yet.
+*
+* @note		The figure covers the time from XCsuDma_ChainStart to the
+*		XCsuDma_ChainPoll call that saw the completion, so it
+*		includes the cache maintenance done by the driver.
+*
+******************************************************************************/
+u64 XCsuDma_ChainGetThroughput(XCsuDma_Chain *ChainPtr)
+{
+	u64 Rate = 0U;
+
+	/* Verify arguments */
+	Xil_AssertNonvoid(ChainPtr != NULL);
+
+#if XCSUDMA_CHAIN_STATS
+	if (ChainPtr->Cycles != 0U) {
+		Rate = ((ChainPtr->Bytes / ChainPtr->Cycles) *
+				(u64)COUNTS_PER_SECOND) +
+			(((ChainPtr->Bytes % ChainPtr->Cycles) *
+				(u64)COUNTS_PER_SECOND) / ChainPtr->Cycles);
+	}
+#endif
+
+	return Rate;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function queues chunks on a channel until either the transfer has been
+* fully issued or XCSUDMA_CHAIN_DEPTH chunks are outstanding.
+*
+* @param	ChainPtr is a pointer to the chained transfer context.
+* @param	Channel is the channel to be topped up.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XCsuDma_ChainIssue(XCsuDma_Chain *ChainPtr,
+					XCsuDma_Channel Channel)
+{
+	u32 Chunk;
+	u8 Last;
+
+	while (ChainPtr->Outstanding[Channel] < (u32)(XCSUDMA_CHAIN_DEPTH)) {
+		if ((Channel == XCSUDMA_SRC_CHANNEL) &&
+				(ChainPtr->Remaining[Channel] == 0U) &&
+				(ChainPtr->NextSize != 0U)) {
+			/* Move on to the appended buffer */
+			ChainPtr->Addr[Channel] = ChainPtr->NextAddr;
+			ChainPtr->Remaining[Channel] = ChainPtr->NextSize;
+			ChainPtr->NextSize = 0U;
+		}
+		if (ChainPtr->Remaining[Channel] == 0U) {
+			break;
+		}
+
+		if (ChainPtr->Remaining[Channel] > (u64)ChainPtr->ChunkBytes) {
+			Chunk = ChainPtr->ChunkBytes;
+		}
+		else {
+			Chunk = (u32)ChainPtr->Remaining[Channel];
+		}
+
+		Last = 0U;
+		if ((Channel == XCSUDMA_SRC_CHANNEL) &&
+			((u64)Chunk == ChainPtr->Remaining[Channel])) {
+			Last = ChainPtr->EnDataLast;
+			ChainPtr->EndMask |= (u32)1U <<
+					ChainPtr->Outstanding[Channel];
+		}
+
+		XCsuDma_Transfer(ChainPtr->InstancePtr, Channel,
+			ChainPtr->Addr[Channel],
+			Chunk >> (u32)(XCSUDMA_SIZE_SHIFT), Last);
+
+		ChainPtr->Addr[Channel] += Chunk;
+		ChainPtr->Remaining[Channel] -= Chunk;
+		ChainPtr->Outstanding[Channel]++;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This function retires the chunks completed on a channel.
+*
+* @param	ChainPtr is a pointer to the chained transfer context.
+* @param	Channel is the channel to be checked.
+*
+* @return	None.
+*
+* @note		A chunk that completes between reading the done count and
+*		acknowledging it is not counted, but once the channel is seen
+*		idle everything issued on it must have completed.
+*
+******************************************************************************/
+static void XCsuDma_ChainReap(XCsuDma_Chain *ChainPtr,
+					XCsuDma_Channel Channel)
+{
+	u32 Status;
+	u32 Done;
+	u32 Index;
+
+	if (ChainPtr->Outstanding[Channel] == 0U) {
+		return;
+	}
+
+	Status = XCsuDma_ReadReg(ChainPtr->InstancePtr->Config.BaseAddress,
+			((u32)(XCSUDMA_STS_OFFSET) +
+			((u32)Channel * (u32)(XCSUDMA_OFFSET_DIFF))));
+
+	if ((Status & (u32)(XCSUDMA_STS_BUSY_MASK)) == 0U) {
+		Done = ChainPtr->Outstanding[Channel];
+	}
+	else {
+		Done = (Status & (u32)(XCSUDMA_STS_DONE_CNT_MASK)) >>
+				(u32)(XCSUDMA_STS_DONE_CNT_SHIFT);
+		if (Done > ChainPtr->Outstanding[Channel]) {
+			Done = ChainPtr->Outstanding[Channel];
+		}
+	}
+
+	if (Done != 0U) {
+		XCsuDma_ClearDoneCount(ChainPtr->InstancePtr, Channel);
+		ChainPtr->Outstanding[Channel] -= Done;
+	}
+
+	if (Channel == XCSUDMA_SRC_CHANNEL) {
+		/* Chunks complete in order, count the buffers they end */
+		for (Index = 0U; Index < Done; Index++) {
+			ChainPtr->Buffers += ChainPtr->EndMask & 1U;
+			ChainPtr->EndMask >>= 1U;
+		}
+	}
+}
+/** @} */
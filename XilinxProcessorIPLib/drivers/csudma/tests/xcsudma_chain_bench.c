@@ -0,0 +1,468 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xcsudma_chain_bench.c
+*
+* Host test and benchmark of the chained CSU_DMA transfers.
+*
+* The driver runs against a model of the source and destination channels of
+* the CSU_DMA. Each channel holds the command it is executing and one more;
+* a third write to SIZE is dropped and flagged with INVALID_APB, as on the
+* target. The source channel moves one word per tick into the stream, the
+* destination channel one word per tick out of it. In loopback mode the
+* stream is a FIFO between the two channels, in sink mode (SHA, PCAP) the
+* source data is consumed as it arrives. A channel starts its next command a
+* fixed time after the previous one has completed. The model keeps the done
+* count and the DONE and INVALID_APB interrupt status bits.
+*
+* Time only moves when the CPU accesses a register or does cache maintenance:
+* each access costs a fixed time and cache maintenance a time per cache line.
+* So the benchmark shows how much of the cache maintenance and command set up
+* is hidden behind the data movement.
+*
+* Each configuration is first checked: the data must arrive intact, no
+* command may be dropped, data_inp_last must be set on the final source
+* command only, and the DONE status, and for chained transfers the done
+* count, must be clear afterwards.
+* Then 4 MB is moved with:
+*  - a XCsuDma_Transfer/XCsuDma_WaitForDone loop per chunk, as the callers
+*    used before the chained API,
+*  - XCsuDma_ChainTransfer with the same chunk size,
+* and the modelled throughput is printed. The program is built twice, with
+* the default XCSUDMA_CHAIN_DEPTH and with 1.
+*
+* Usage: xcsudma_chain_bench [MB/s] [ns per access] [ns per cache line]
+*        [ns per command]
+*
+* The defaults are 400 MB/s, 40 ns, 8 ns and 100 ns.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.1        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xcsudma.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE	0xFFC80000U	/* CSU_DMA */
+#define SIM_QUEUE	2U		/* Commands buffered per channel */
+#define SIM_FIFO	512U		/* Loopback stream FIFO, bytes */
+#define SIM_LINE	64U		/* Cache line, bytes */
+
+#define BENCH_BYTES	(4U * 1024U * 1024U)
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u8 *Ptr;
+	u32 Bytes;
+	u32 Moved;
+	u32 Last;
+} SimCmd;
+
+typedef struct {
+	u32 Reg[0x30U / 4U];
+	SimCmd Queue[SIM_QUEUE];
+	u32 Count;
+	double StartAt;
+	u32 DoneCnt;
+	u32 Drops;
+	u32 Commands;
+	u32 LastSeen;
+	u32 LastOnFinal;
+} SimChannel;
+
+/************************** Variable Definitions *****************************/
+
+static SimChannel Sim[2];
+static u8 SimFifo[SIM_FIFO];
+static u32 SimFifoHead;
+static u32 SimFifoLevel;
+static u32 SimLoopback;
+static u8 *SimSinkCheck;
+static u32 SimSinkPos;
+static u32 SimSinkBad;
+
+static double SimNow;
+static double SimTickNs;
+static double SimMBps = 400.0;
+static double SimApbNs = 40.0;
+static double SimLineNs = 8.0;
+static double SimCmdNs = 100.0;
+
+static XCsuDma CsuDma;
+
+/************************** Function Definitions *****************************/
+
+/* Completes the active command of a channel */
+static void SimRetire(SimChannel *Ch)
+{
+	if (Ch->DoneCnt < 7U) {
+		Ch->DoneCnt++;
+	}
+	Ch->Reg[XCSUDMA_I_STS_OFFSET / 4U] |= XCSUDMA_IXR_DONE_MASK;
+	Ch->Queue[0] = Ch->Queue[1];
+	Ch->Count--;
+	Ch->StartAt = SimNow + SimCmdNs;
+}
+
+/* Runs the channels up to time End */
+static void SimAdvance(double End)
+{
+	SimChannel *Src = &Sim[XCSUDMA_SRC_CHANNEL];
+	SimChannel *Dst = &Sim[XCSUDMA_DST_CHANNEL];
+	SimCmd *Cmd;
+
+	while ((SimNow + SimTickNs) <= End) {
+		SimNow += SimTickNs;
+
+		Cmd = &Src->Queue[0];
+		if ((Src->Count != 0U) && (SimNow >= Src->StartAt) &&
+			((SimLoopback == 0U) || (SimFifoLevel < SIM_FIFO))) {
+			if (SimLoopback != 0U) {
+				memcpy(&SimFifo[(SimFifoHead + SimFifoLevel) %
+					SIM_FIFO], Cmd->Ptr + Cmd->Moved, 4U);
+				SimFifoLevel += 4U;
+			}
+			else if (SimSinkCheck != NULL) {
+				if (memcmp(Cmd->Ptr + Cmd->Moved,
+					SimSinkCheck + SimSinkPos, 4U) != 0) {
+					SimSinkBad++;
+				}
+				SimSinkPos += 4U;
+			}
+			Cmd->Moved += 4U;
+			if (Cmd->Moved == Cmd->Bytes) {
+				SimRetire(Src);
+			}
+		}
+
+		Cmd = &Dst->Queue[0];
+		if ((Dst->Count != 0U) && (SimNow >= Dst->StartAt) &&
+				(SimFifoLevel != 0U)) {
+			memcpy(Cmd->Ptr + Cmd->Moved, &SimFifo[SimFifoHead],
+				4U);
+			SimFifoHead = (SimFifoHead + 4U) % SIM_FIFO;
+			SimFifoLevel -= 4U;
+			Cmd->Moved += 4U;
+			if (Cmd->Moved == Cmd->Bytes) {
+				SimRetire(Dst);
+			}
+		}
+
+		if ((Src->Count == 0U) && (Dst->Count == 0U)) {
+			/* Nothing in flight, skip ahead */
+			SimNow = End;
+		}
+	}
+}
+
+static SimChannel *SimDecode(UINTPTR Addr, u32 *Offset)
+{
+	u32 Rel = (u32)(Addr - SIM_BASE);
+
+	if ((Addr < SIM_BASE) || ((Rel % XCSUDMA_OFFSET_DIFF) >= 0x30U) ||
+			(Rel >= (2U * XCSUDMA_OFFSET_DIFF))) {
+		fprintf(stderr, "access outside the model: 0x%lx\n",
+				(unsigned long)Addr);
+		exit(1);
+	}
+	*Offset = Rel % XCSUDMA_OFFSET_DIFF;
+	return &Sim[Rel / XCSUDMA_OFFSET_DIFF];
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Offset;
+	SimChannel *Ch;
+
+	SimAdvance(SimNow + SimApbNs);
+	Ch = SimDecode(Addr, &Offset);
+	if (Offset == XCSUDMA_STS_OFFSET) {
+		return (Ch->DoneCnt << XCSUDMA_STS_DONE_CNT_SHIFT) |
+			((Ch->Count != 0U) ? XCSUDMA_STS_BUSY_MASK : 0U);
+	}
+	return Ch->Reg[Offset / 4U];
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset;
+	SimChannel *Ch;
+	SimCmd *Cmd;
+
+	SimAdvance(SimNow + SimApbNs);
+	if (Addr == (XCSU_BASEADDRESS + XCSU_DMA_RESET_OFFSET)) {
+		return;
+	}
+	Ch = SimDecode(Addr, &Offset);
+
+	switch (Offset) {
+	case XCSUDMA_SIZE_OFFSET:
+		if (Ch->Count == SIM_QUEUE) {
+			Ch->Drops++;
+			Ch->Reg[XCSUDMA_I_STS_OFFSET / 4U] |=
+					XCSUDMA_IXR_INVALID_APB_MASK;
+			break;
+		}
+		Cmd = &Ch->Queue[Ch->Count];
+		Cmd->Ptr = (u8 *)(UINTPTR)
+			(((u64)Ch->Reg[XCSUDMA_ADDR_MSB_OFFSET / 4U] << 32) |
+			Ch->Reg[XCSUDMA_ADDR_OFFSET / 4U]);
+		Cmd->Bytes = Value & ~XCSUDMA_LAST_WORD_MASK;
+		Cmd->Moved = 0U;
+		Cmd->Last = Value & XCSUDMA_LAST_WORD_MASK;
+		if (Ch->Count == 0U) {
+			Ch->StartAt = SimNow;
+		}
+		Ch->Count++;
+		Ch->Commands++;
+		if (Cmd->Last != 0U) {
+			Ch->LastSeen++;
+			Ch->LastOnFinal = Ch->Commands;
+		}
+		if (Cmd->Bytes == 0U) {
+			SimRetire(Ch);
+		}
+		break;
+	case XCSUDMA_STS_OFFSET:
+		if ((Value & XCSUDMA_STS_DONE_CNT_MASK) != 0U) {
+			Ch->DoneCnt = 0U;
+		}
+		break;
+	case XCSUDMA_I_STS_OFFSET:
+		Ch->Reg[Offset / 4U] &= ~Value;
+		break;
+	default:
+		Ch->Reg[Offset / 4U] = Value;
+		break;
+	}
+}
+
+static void SimCacheRange(UINTPTR Addr, u32 Len)
+{
+	u32 Lines = (u32)(((Addr + Len + SIM_LINE - 1U) / SIM_LINE) -
+				(Addr / SIM_LINE));
+
+	SimAdvance(SimNow + (Lines * SimLineNs));
+}
+
+void Xil_DCacheFlushRange(UINTPTR Addr, u32 Len)
+{
+	SimCacheRange(Addr, Len);
+}
+
+void Xil_DCacheInvalidateRange(UINTPTR Addr, u32 Len)
+{
+	SimCacheRange(Addr, Len);
+}
+
+static void SimReset(u32 Loopback)
+{
+	XCsuDma_Config Config = { 0U, SIM_BASE };
+
+	memset(Sim, 0, sizeof(Sim));
+	SimFifoHead = 0U;
+	SimFifoLevel = 0U;
+	SimLoopback = Loopback;
+	SimSinkCheck = NULL;
+	SimSinkPos = 0U;
+	SimSinkBad = 0U;
+	SimNow = 0.0;
+	XCsuDma_CfgInitialize(&CsuDma, &Config, SIM_BASE);
+}
+
+/* Moves Bytes with one XCsuDma_Transfer/XCsuDma_WaitForDone per chunk */
+static void TransferLoop(u8 *Dst, const u8 *Src, u32 Bytes, u32 Chunk)
+{
+	u32 Offset;
+	u32 Size;
+	u8 Last;
+
+	for (Offset = 0U; Offset < Bytes; Offset += Size) {
+		Size = ((Bytes - Offset) > Chunk) ? Chunk : (Bytes - Offset);
+		Last = ((Offset + Size) == Bytes) ? 1U : 0U;
+		if (Dst != NULL) {
+			XCsuDma_Transfer(&CsuDma, XCSUDMA_DST_CHANNEL,
+				(UINTPTR)(Dst + Offset), Size >> 2, 0U);
+		}
+		XCsuDma_Transfer(&CsuDma, XCSUDMA_SRC_CHANNEL,
+			(UINTPTR)(Src + Offset), Size >> 2, Last);
+		if (Dst != NULL) {
+			XCsuDma_WaitForDone(&CsuDma, XCSUDMA_DST_CHANNEL);
+			XCsuDma_IntrClear(&CsuDma, XCSUDMA_DST_CHANNEL,
+					XCSUDMA_IXR_DONE_MASK);
+		}
+		XCsuDma_WaitForDone(&CsuDma, XCSUDMA_SRC_CHANNEL);
+		XCsuDma_IntrClear(&CsuDma, XCSUDMA_SRC_CHANNEL,
+				XCSUDMA_IXR_DONE_MASK);
+	}
+}
+
+/* Moves Bytes with a chained transfer of the given chunk size */
+static void ChainLoop(u8 *Dst, const u8 *Src, u32 Bytes, u32 Chunk)
+{
+	XCsuDma_Chain Chain;
+
+	XCsuDma_ChainInit(&CsuDma, &Chain, Chunk);
+	(void)XCsuDma_ChainStart(&Chain, (UINTPTR)Src, Bytes,
+			(UINTPTR)Dst, (Dst != NULL) ? Bytes : 0U, 1U);
+	XCsuDma_ChainWait(&Chain);
+}
+
+static u32 Check(const char *Name, u8 *Dst, const u8 *Src, u32 Bytes,
+		u32 DoneCntClear)
+{
+	SimChannel *S = &Sim[XCSUDMA_SRC_CHANNEL];
+	u32 Index;
+	u32 Failed = 0U;
+
+	if ((Dst != NULL) && (memcmp(Dst, Src, Bytes) != 0)) {
+		printf("FAIL %s: data corrupted\n", Name);
+		Failed++;
+	}
+	if (SimSinkBad != 0U) {
+		printf("FAIL %s: %u words out of order\n", Name, SimSinkBad);
+		Failed++;
+	}
+	for (Index = 0U; Index < 2U; Index++) {
+		if (Sim[Index].Drops != 0U) {
+			printf("FAIL %s: %u commands dropped on channel %u\n",
+				Name, Sim[Index].Drops, Index);
+			Failed++;
+		}
+		if (((DoneCntClear != 0U) && (Sim[Index].DoneCnt != 0U)) ||
+				((Sim[Index].Reg[XCSUDMA_I_STS_OFFSET / 4U] &
+				XCSUDMA_IXR_DONE_MASK) != 0U)) {
+			printf("FAIL %s: done count or DONE left set on "
+				"channel %u\n", Name, Index);
+			Failed++;
+		}
+	}
+	if ((S->LastSeen != 1U) || (S->LastOnFinal != S->Commands)) {
+		printf("FAIL %s: data_inp_last on %u commands, last on %u of "
+			"%u\n", Name, S->LastSeen, S->LastOnFinal,
+			S->Commands);
+		Failed++;
+	}
+
+	return Failed;
+}
+
+int main(int argc, char *argv[])
+{
+	static const u32 Chunks[] = { 4096U, 16384U, 65536U, 262144U,
+				      BENCH_BYTES };
+	static const char *Modes[] = { "sink", "loopback" };
+	u8 *Src;
+	u8 *Dst;
+	u8 *Out;
+	u32 Mode;
+	u32 Index;
+	u32 Failed = 0U;
+	double Loop;
+	double Chain;
+
+	if (argc > 1) {
+		SimMBps = atof(argv[1]);
+	}
+	if (argc > 2) {
+		SimApbNs = atof(argv[2]);
+	}
+	if (argc > 3) {
+		SimLineNs = atof(argv[3]);
+	}
+	if (argc > 4) {
+		SimCmdNs = atof(argv[4]);
+	}
+	SimTickNs = 4000.0 / SimMBps;
+
+	Src = aligned_alloc(64, BENCH_BYTES);
+	Dst = aligned_alloc(64, BENCH_BYTES);
+	if ((Src == NULL) || (Dst == NULL)) {
+		return 1;
+	}
+	for (Index = 0U; Index < BENCH_BYTES; Index++) {
+		Src[Index] = (u8)((Index * 7U) + (Index >> 9));
+	}
+
+	printf("XCSUDMA_CHAIN_DEPTH %u, model: %.0f MB/s, %.0f ns per "
+		"access, %.0f ns per cache line, %.0f ns per command\n\n",
+		(u32)XCSUDMA_CHAIN_DEPTH, SimMBps, SimApbNs, SimLineNs,
+		SimCmdNs);
+	printf("%-9s %8s %14s %14s\n", "mode", "chunk", "loop MB/s",
+		"chain MB/s");
+
+	for (Mode = 0U; Mode < 2U; Mode++) {
+		Out = (Mode != 0U) ? Dst : NULL;
+		for (Index = 0U; Index < sizeof(Chunks) / sizeof(Chunks[0]);
+				Index++) {
+			SimReset(Mode);
+			SimSinkCheck = Src;
+			memset(Dst, 0, BENCH_BYTES);
+			TransferLoop(Out, Src, BENCH_BYTES, Chunks[Index]);
+			Failed += Check("loop", Out, Src, BENCH_BYTES, 0U);
+			Loop = BENCH_BYTES * 1000.0 / SimNow;
+
+			SimReset(Mode);
+			SimSinkCheck = Src;
+			memset(Dst, 0, BENCH_BYTES);
+			ChainLoop(Out, Src, BENCH_BYTES, Chunks[Index]);
+			Failed += Check("chain", Out, Src, BENCH_BYTES, 1U);
+			Chain = BENCH_BYTES * 1000.0 / SimNow;
+
+			printf("%-9s %8u %14.1f %14.1f\n", Modes[Mode],
+				Chunks[Index], Loop, Chain);
+		}
+	}
+
+	free(Src);
+	free(Dst);
+
+	printf("\n%s\n", (Failed == 0U) ? "all checks passed" :
+						"CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}
@@ -42,6 +42,7 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- -----------------------------------------------
 * 1.00  MH   10/30/15 First Release
+* 1.01       10/18/26 Hash incrementally instead of through local buffers
 *</pre>
 *
 *****************************************************************************/
@@ -82,26 +83,21 @@
 * @param	HashedData is the output of this function.
 *
 * @return	- XST_SUCCESS if no errors occured
-*			- XST_FAILURE if the datasize execeeds the size of the local buffer.
+*			- XST_FAILURE if DataSize or KeySize is negative.
 *
-* @note		None.
+* @note		The pads and data are hashed incrementally, so there is no
+*			limit on DataSize and no copy of the data is made.
 *
 ******************************************************************************/
 int XHdcp22Cmn_HmacSha256Hash(const u8 *Data, int DataSize, const u8 *Key, int KeySize, u8  *HashedData)
 {
-	u8 Ipad[65];   /* inner padding-key XORd with ipad */
-	u8 Opad[65];   /* outer padding-key XORd with opad */
+	XHdcp22Cmn_Sha256Ctx Ctx;
+	u8 Pad[64];    /* padding-key XORd with ipad, then opad */
 	u8 Ktemp[SHA256_SIZE];
 	u8 Ktemp2[SHA256_SIZE];
-	u8 BufferIn[256];
-	u8 BufferOut[256];
 	int i;
 
-	memset(BufferIn, 0x00, 256);
-	memset(BufferOut, 0x00, 256);
-
-	/* If the input size exceeds the local buffers, return an error */
-	if(DataSize + 64 >  256) {
+	if((DataSize < 0) || (KeySize < 0)) {
 		return XST_FAILURE;
 	}
 
@@ -112,28 +108,31 @@ int XHdcp22Cmn_HmacSha256Hash(const u8 *Data, int DataSize, const u8 *Key, int K
 		KeySize = SHA256_SIZE;
 	}
 
-	/* start out by storing Key in pads */
-	memset(Ipad, 0, sizeof Ipad );
-	memset(Opad, 0, sizeof Opad );
-	memcpy(Ipad, Key, KeySize );
-	memcpy(Opad, Key, KeySize );
+	/* start out by storing Key in pad */
+	memset(Pad, 0, sizeof Pad );
+	memcpy(Pad, Key, KeySize );
 
-	/* XOR Key with Ipad and Opad values */
+	/* XOR Key with Ipad value */
 	for(i = 0; i < 64; i++) {
-		Ipad[i] ^= 0x36;
-		Opad[i] ^= 0x5c;
+		Pad[i] ^= 0x36;
 	}
 
 	/* Execute inner SHA256 */
-	memcpy(BufferIn, Ipad, 64 );
-	memcpy(BufferIn + 64, Data, DataSize );
-	XHdcp22Cmn_Sha256Hash(BufferIn, 64 + DataSize, Ktemp2 );
+	XHdcp22Cmn_Sha256Init(&Ctx);
+	XHdcp22Cmn_Sha256Update(&Ctx, Pad, 64);
+	XHdcp22Cmn_Sha256Update(&Ctx, Data, DataSize);
+	XHdcp22Cmn_Sha256Final(&Ctx, Ktemp2);
+
+	/* Turn the Ipad into the Opad */
+	for(i = 0; i < 64; i++) {
+		Pad[i] ^= 0x36 ^ 0x5c;
+	}
 
 	/* Execute outer SHA256 */
-	memcpy(BufferOut, Opad, 64);
-	memcpy(BufferOut + 64, Ktemp2, SHA256_SIZE );
-	XHdcp22Cmn_Sha256Hash(BufferOut, 64 + SHA256_SIZE,
-						(u8 *)HashedData );
+	XHdcp22Cmn_Sha256Init(&Ctx);
+	XHdcp22Cmn_Sha256Update(&Ctx, Pad, 64);
+	XHdcp22Cmn_Sha256Update(&Ctx, Ktemp2, SHA256_SIZE);
+	XHdcp22Cmn_Sha256Final(&Ctx, (u8 *)HashedData);
 
 	return XST_SUCCESS;
 }
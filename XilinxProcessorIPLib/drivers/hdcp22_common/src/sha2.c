@@ -35,12 +35,23 @@
 *
 * This file contains the implementation of the SHA-2 Secure Hashing Algorithm.
 *
+* Full 64 byte blocks are processed straight from the caller's buffer by a
+* block function selected on first use. On AArch64 the SHA256H/SHA256H2
+* instructions are used when ID_AA64ISAR0_EL1 reports them, otherwise a
+* portable unrolled implementation is used. The instruction path is always
+* built, for the Cryptography Extension only, so the same binary runs on
+* processors without it. Define XHDCP22_SHA256_PORTABLE to always use the
+* portable implementation.
+*
 * <pre>
 * MODIFICATION HISTORY:
 *
 * Ver   Who  Date     Changes
 * ----- ---- -------- -----------------------------------------------
 * 1.00  MH   10/30/15 First Release
+* 1.01       10/18/26 Added incremental API, word oriented unrolled block
+*                    function and ARMv8 Cryptography Extension path,
+*                    selected at run time on any AArch64 build
 *</pre>
 *
 *****************************************************************************/
@@ -48,28 +59,49 @@
 /***************************** Include Files ********************************/
 #include "string.h"
 #include "xil_types.h"
+#include "xhdcp22_common.h"
+
+#if defined(__aarch64__) && !defined(XHDCP22_SHA256_PORTABLE)
+#define SHA256_ARMV8
+#include <arm_neon.h>
+#endif
+
+/************************** Constant Definitions ****************************/
+#define SHA256_BLOCK_SIZE	64	/**< SHA256 block size in bytes */
 
 /**************************** Type Definitions ******************************/
-typedef struct {
-   u8 data[64];
-   u32 datalen;
-   u32 bitlen[2];
-   u32 state[8];
-} Sha256Type;
+/** Block function, hashes NumBlocks consecutive 64 byte blocks */
+typedef void (*Sha256BlocksType)(u32 *State, const u8 *Data, u32 NumBlocks);
 
 /***************** Macros (Inline Functions) Definitions ********************/
-// DBL_INT_ADD treats two unsigned ints a and b as one 64-bit integer and adds c to it
-#define DBL_INT_ADD(a,b,c) if (a > 0xffffffff - (c)) ++b; a += c;
-#define ROTLEFT(a,b) (((a) << (b)) | ((a) >> (32-(b))))
 #define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
 
-#define CH(x,y,z) (((x) & (y)) ^ (~(x) & (z)))
-#define MAJ(x,y,z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define CH(x,y,z) ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x,y,z) (((x) & (y)) | ((z) & ((x) | (y))))
 #define EP0(x) (ROTRIGHT(x,2) ^ ROTRIGHT(x,13) ^ ROTRIGHT(x,22))
 #define EP1(x) (ROTRIGHT(x,6) ^ ROTRIGHT(x,11) ^ ROTRIGHT(x,25))
 #define SIG0(x) (ROTRIGHT(x,7) ^ ROTRIGHT(x,18) ^ ((x) >> 3))
 #define SIG1(x) (ROTRIGHT(x,17) ^ ROTRIGHT(x,19) ^ ((x) >> 10))
 
+/* Big endian load and store */
+#define LOAD32(p) (((u32)(p)[0] << 24) | ((u32)(p)[1] << 16) | \
+		((u32)(p)[2] << 8) | ((u32)(p)[3]))
+#define STORE32(p,v) do { (p)[0] = (u8)((v) >> 24); (p)[1] = (u8)((v) >> 16); \
+		(p)[2] = (u8)((v) >> 8); (p)[3] = (u8)(v); } while (0)
+
+/*
+ * One round. Instead of shifting all eight working variables, callers
+ * rotate the argument order, so only d and h are written.
+ */
+#define ROUND(a,b,c,d,e,f,g,h,i,w) do { \
+		u32 T1 = (h) + EP1(e) + CH(e,f,g) + k[i] + (w); \
+		(d) += T1; \
+		(h) = T1 + EP0(a) + MAJ(a,b,c); } while (0)
+
+/* Message schedule kept in a rolling window of 16 words */
+#define SCHED(W,i) ((W)[(i) & 15] += SIG1((W)[((i) - 2) & 15]) + \
+		(W)[((i) - 7) & 15] + SIG0((W)[((i) - 15) & 15]))
+
 /************************** Variable Definitions ****************************/
 static const u32 k[64] = {
    0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
@@ -82,13 +114,18 @@ static const u32 k[64] = {
    0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
 };
 
+/** Block function in use, selected on first use */
+static Sha256BlocksType Sha256Blocks = NULL;
+
 /************************** Function Prototypes *****************************/
 
 /* SHA-256 Hashing */
-static void Sha256Transform(Sha256Type *Ctx, u8 *Data);
-static void Sha256Init(Sha256Type *Ctx);
-static void Sha256Update(Sha256Type *Ctx, const u8 *Data, u32 Len);
-static void Sha256Final(Sha256Type *Ctx, u8 *Hash);
+static void Sha256BlocksSw(u32 *State, const u8 *Data, u32 NumBlocks);
+#ifdef SHA256_ARMV8
+static void Sha256BlocksArmv8(u32 *State, const u8 *Data, u32 NumBlocks)
+	__attribute__((target("+crypto")));
+#endif
+static Sha256BlocksType Sha256SelectBlocks(void);
 
 /************************** Function Implementation *****************************/
 
@@ -108,177 +145,294 @@ static void Sha256Final(Sha256Type *Ctx, u8 *Hash);
 ******************************************************************************/
 void XHdcp22Cmn_Sha256Hash(const u8 *Data, u32 DataSize, u8 *HashedData)
 {
-	Sha256Type Ctx;
+	XHdcp22Cmn_Sha256Ctx Ctx;
 
-	Sha256Init(&Ctx);
+	XHdcp22Cmn_Sha256Init(&Ctx);
 
-	Sha256Update(&Ctx, Data, DataSize);
-	Sha256Final(&Ctx, HashedData);
+	XHdcp22Cmn_Sha256Update(&Ctx, Data, DataSize);
+	XHdcp22Cmn_Sha256Final(&Ctx, HashedData);
 }
 
 /*****************************************************************************/
 /**
-* This function executes a SHA256 transformation.
+* This function initializes the context data for a SHA 256 hash calculation.
 *
 * @param  Ctx is the context data for SHA256.
-* @param  Data is the data to transform.
 *
 * @return None.
 *
-* @note   None.
+* @note   The first call also selects the block function.
 *
 ******************************************************************************/
-static void Sha256Transform(Sha256Type *Ctx, u8 *Data)
+void XHdcp22Cmn_Sha256Init(XHdcp22Cmn_Sha256Ctx *Ctx)
 {
-   u32 a,b,c,d,e,f,g,h,i,j,t1,t2,m[64];
-
-   for (i=0,j=0; i < 16; ++i, j += 4)
-      m[i] = (Data[j] << 24) | (Data[j+1] << 16) | (Data[j+2] << 8) | (Data[j+3]);
-   for ( ; i < 64; ++i)
-      m[i] = SIG1(m[i-2]) + m[i-7] + SIG0(m[i-15]) + m[i-16];
-
-   a = Ctx->state[0];
-   b = Ctx->state[1];
-   c = Ctx->state[2];
-   d = Ctx->state[3];
-   e = Ctx->state[4];
-   f = Ctx->state[5];
-   g = Ctx->state[6];
-   h = Ctx->state[7];
-
-   for (i = 0; i < 64; ++i) {
-      t1 = h + EP1(e) + CH(e,f,g) + k[i] + m[i];
-      t2 = EP0(a) + MAJ(a,b,c);
-      h = g;
-      g = f;
-      f = e;
-      e = d + t1;
-      d = c;
-      c = b;
-      b = a;
-      a = t1 + t2;
-   }
-
-   Ctx->state[0] += a;
-   Ctx->state[1] += b;
-   Ctx->state[2] += c;
-   Ctx->state[3] += d;
-   Ctx->state[4] += e;
-   Ctx->state[5] += f;
-   Ctx->state[6] += g;
-   Ctx->state[7] += h;
+	if (Sha256Blocks == NULL) {
+		Sha256Blocks = Sha256SelectBlocks();
+	}
+
+	Ctx->Length = 0;
+	Ctx->BufferLen = 0;
+	Ctx->State[0] = 0x6a09e667;
+	Ctx->State[1] = 0xbb67ae85;
+	Ctx->State[2] = 0x3c6ef372;
+	Ctx->State[3] = 0xa54ff53a;
+	Ctx->State[4] = 0x510e527f;
+	Ctx->State[5] = 0x9b05688c;
+	Ctx->State[6] = 0x1f83d9ab;
+	Ctx->State[7] = 0x5be0cd19;
 }
 
 /*****************************************************************************/
 /**
-* This function initializes the context data for a SHA 256 hash calculation.
+*
+* This function adds data to a SHA 256 hash calculation.
 *
 * @param  Ctx is the context data for SHA256.
+* @param  Data is the input data. May be NULL if DataSize is 0.
+* @param  DataSize is size of the input data array.
 *
 * @return None.
 *
-* @note   None.
+* @note   Whole blocks are hashed directly from Data, only a partial
+*         block at either end is copied into the context.
 *
 ******************************************************************************/
-static void Sha256Init(Sha256Type *Ctx)
+void XHdcp22Cmn_Sha256Update(XHdcp22Cmn_Sha256Ctx *Ctx, const u8 *Data,
+		u32 DataSize)
 {
-   Ctx->datalen = 0;
-   Ctx->bitlen[0] = 0;
-   Ctx->bitlen[1] = 0;
-   Ctx->state[0] = 0x6a09e667;
-   Ctx->state[1] = 0xbb67ae85;
-   Ctx->state[2] = 0x3c6ef372;
-   Ctx->state[3] = 0xa54ff53a;
-   Ctx->state[4] = 0x510e527f;
-   Ctx->state[5] = 0x9b05688c;
-   Ctx->state[6] = 0x1f83d9ab;
-   Ctx->state[7] = 0x5be0cd19;
+	u32 Len;
+
+	if (DataSize == 0) {
+		return;
+	}
+
+	Ctx->Length += DataSize;
+
+	/* Complete a partial block left by the previous call */
+	if (Ctx->BufferLen > 0) {
+		Len = SHA256_BLOCK_SIZE - Ctx->BufferLen;
+		if (Len > DataSize) {
+			Len = DataSize;
+		}
+		memcpy(Ctx->Buffer + Ctx->BufferLen, Data, Len);
+		Ctx->BufferLen += Len;
+		Data += Len;
+		DataSize -= Len;
+
+		if (Ctx->BufferLen < SHA256_BLOCK_SIZE) {
+			return;
+		}
+		Sha256Blocks(Ctx->State, Ctx->Buffer, 1);
+		Ctx->BufferLen = 0;
+	}
+
+	/* Hash the whole blocks in place */
+	if (DataSize >= SHA256_BLOCK_SIZE) {
+		Len = DataSize / SHA256_BLOCK_SIZE;
+		Sha256Blocks(Ctx->State, Data, Len);
+		Data += Len * SHA256_BLOCK_SIZE;
+		DataSize -= Len * SHA256_BLOCK_SIZE;
+	}
+
+	/* Keep the tail for the next call */
+	if (DataSize > 0) {
+		memcpy(Ctx->Buffer, Data, DataSize);
+		Ctx->BufferLen = DataSize;
+	}
 }
 
 /*****************************************************************************/
 /**
 *
-* This function updates the SHA data before adding padding data.
+* This function adds padding and returns the hash.
 *
 * @param  Ctx is the context data for SHA256.
-* @param  Data is the input data.
-* @param  Len is size of the input data array.
+* @param  HashedData is the calculated hash (256-bits).
 *
 * @return None.
 *
-* @note   None.
+* @note   The context must be initialized again before reuse.
 *
 ******************************************************************************/
-static void Sha256Update(Sha256Type *Ctx, const u8 *Data, u32 Len)
+void XHdcp22Cmn_Sha256Final(XHdcp22Cmn_Sha256Ctx *Ctx, u8 *HashedData)
 {
-   u32 i;
-
-   for (i=0; i < Len; ++i) {
-      Ctx->data[Ctx->datalen] = Data[i];
-      Ctx->datalen++;
-      if (Ctx->datalen == 64) {
-	  Sha256Transform(Ctx,Ctx->data);
-         DBL_INT_ADD(Ctx->bitlen[0],Ctx->bitlen[1],512);
-         Ctx->datalen = 0;
-      }
-   }
+	u64 BitLen = Ctx->Length * 8;
+	u32 i = Ctx->BufferLen;
+
+	/* Pad whatever data is left in the buffer. */
+	Ctx->Buffer[i++] = 0x80;
+	if (i > SHA256_BLOCK_SIZE - 8) {
+		memset(Ctx->Buffer + i, 0, SHA256_BLOCK_SIZE - i);
+		Sha256Blocks(Ctx->State, Ctx->Buffer, 1);
+		i = 0;
+	}
+	memset(Ctx->Buffer + i, 0, SHA256_BLOCK_SIZE - 8 - i);
+
+	/* Append to the padding the total message's length in bits and transform. */
+	STORE32(Ctx->Buffer + 56, (u32)(BitLen >> 32));
+	STORE32(Ctx->Buffer + 60, (u32)BitLen);
+	Sha256Blocks(Ctx->State, Ctx->Buffer, 1);
+
+	/* SHA uses big endian, store the final state accordingly. */
+	for (i = 0; i < 8; ++i) {
+		STORE32(HashedData + (i * 4), Ctx->State[i]);
+	}
 }
 
 /*****************************************************************************/
 /**
+* This function executes the SHA256 transformation on whole blocks, in
+* portable C.
 *
-* This function adds padding
+* @param  State is the hash state to update.
+* @param  Data is the data to transform.
+* @param  NumBlocks is the number of 64 byte blocks in Data.
 *
-* @param  Ctx is the context data for SHA256.
-* @param  Hash is the calculated hash (256-bits).
+* @return None.
+*
+* @note   The rounds are unrolled by eight, so the working variables never
+*         have to be shifted.
+*
+******************************************************************************/
+static void Sha256BlocksSw(u32 *State, const u8 *Data, u32 NumBlocks)
+{
+	u32 a, b, c, d, e, f, g, h, i;
+	u32 W[16];
+
+	while (NumBlocks-- > 0) {
+		for (i = 0; i < 16; i++) {
+			W[i] = LOAD32(Data + (i * 4));
+		}
+
+		a = State[0];
+		b = State[1];
+		c = State[2];
+		d = State[3];
+		e = State[4];
+		f = State[5];
+		g = State[6];
+		h = State[7];
+
+		for (i = 0; i < 16; i += 8) {
+			ROUND(a, b, c, d, e, f, g, h, i + 0, W[i + 0]);
+			ROUND(h, a, b, c, d, e, f, g, i + 1, W[i + 1]);
+			ROUND(g, h, a, b, c, d, e, f, i + 2, W[i + 2]);
+			ROUND(f, g, h, a, b, c, d, e, i + 3, W[i + 3]);
+			ROUND(e, f, g, h, a, b, c, d, i + 4, W[i + 4]);
+			ROUND(d, e, f, g, h, a, b, c, i + 5, W[i + 5]);
+			ROUND(c, d, e, f, g, h, a, b, i + 6, W[i + 6]);
+			ROUND(b, c, d, e, f, g, h, a, i + 7, W[i + 7]);
+		}
+
+		for ( ; i < 64; i += 8) {
+			ROUND(a, b, c, d, e, f, g, h, i + 0, SCHED(W, i + 0));
+			ROUND(h, a, b, c, d, e, f, g, i + 1, SCHED(W, i + 1));
+			ROUND(g, h, a, b, c, d, e, f, i + 2, SCHED(W, i + 2));
+			ROUND(f, g, h, a, b, c, d, e, i + 3, SCHED(W, i + 3));
+			ROUND(e, f, g, h, a, b, c, d, i + 4, SCHED(W, i + 4));
+			ROUND(d, e, f, g, h, a, b, c, i + 5, SCHED(W, i + 5));
+			ROUND(c, d, e, f, g, h, a, b, i + 6, SCHED(W, i + 6));
+			ROUND(b, c, d, e, f, g, h, a, i + 7, SCHED(W, i + 7));
+		}
+
+		State[0] += a;
+		State[1] += b;
+		State[2] += c;
+		State[3] += d;
+		State[4] += e;
+		State[5] += f;
+		State[6] += g;
+		State[7] += h;
+
+		Data += SHA256_BLOCK_SIZE;
+	}
+}
+
+#ifdef SHA256_ARMV8
+/*****************************************************************************/
+/**
+* This function executes the SHA256 transformation on whole blocks with the
+* ARMv8 Cryptography Extension.
+*
+* @param  State is the hash state to update.
+* @param  Data is the data to transform.
+* @param  NumBlocks is the number of 64 byte blocks in Data.
 *
 * @return None.
 *
-* @note   None.
+* @note   Each iteration of the inner loop does four rounds. The message
+*         schedule for rounds 16 to 63 is computed four words at a time
+*         with SHA256SU0/SHA256SU1. Only this function is compiled for the
+*         Cryptography Extension, it is called after
+*         Sha256SelectBlocks() found the instructions.
 *
 ******************************************************************************/
-static void Sha256Final(Sha256Type *Ctx, u8 *Hash)
+__attribute__((target("+crypto")))
+static void Sha256BlocksArmv8(u32 *State, const u8 *Data, u32 NumBlocks)
 {
-   u32 i;
-
-   i = Ctx->datalen;
-
-   // Pad whatever data is left in the buffer.
-   if (Ctx->datalen < 56) {
-      Ctx->data[i++] = 0x80;
-      while (i < 56)
-         Ctx->data[i++] = 0x00;
-   }
-   else {
-      Ctx->data[i++] = 0x80;
-      while (i < 64)
-         Ctx->data[i++] = 0x00;
-      Sha256Transform(Ctx,Ctx->data);
-      memset(Ctx->data,0,56);
-   }
-
-   // Append to the padding the total message's length in bits and transform.
-   DBL_INT_ADD(Ctx->bitlen[0],Ctx->bitlen[1],Ctx->datalen * 8);
-   Ctx->data[63] = Ctx->bitlen[0];
-   Ctx->data[62] = Ctx->bitlen[0] >> 8;
-   Ctx->data[61] = Ctx->bitlen[0] >> 16;
-   Ctx->data[60] = Ctx->bitlen[0] >> 24;
-   Ctx->data[59] = Ctx->bitlen[1];
-   Ctx->data[58] = Ctx->bitlen[1] >> 8;
-   Ctx->data[57] = Ctx->bitlen[1] >> 16;
-   Ctx->data[56] = Ctx->bitlen[1] >> 24;
-   Sha256Transform(Ctx,Ctx->data);
-
-   // Since this implementation uses little endian byte ordering and SHA uses big endian,
-   // reverse all the bytes when copying the final state to the output hash.
-   for (i=0; i < 4; ++i) {
-      Hash[i]    = (Ctx->state[0] >> (24-i*8)) & 0x000000ff;
-      Hash[i+4]  = (Ctx->state[1] >> (24-i*8)) & 0x000000ff;
-      Hash[i+8]  = (Ctx->state[2] >> (24-i*8)) & 0x000000ff;
-      Hash[i+12] = (Ctx->state[3] >> (24-i*8)) & 0x000000ff;
-      Hash[i+16] = (Ctx->state[4] >> (24-i*8)) & 0x000000ff;
-      Hash[i+20] = (Ctx->state[5] >> (24-i*8)) & 0x000000ff;
-      Hash[i+24] = (Ctx->state[6] >> (24-i*8)) & 0x000000ff;
-      Hash[i+28] = (Ctx->state[7] >> (24-i*8)) & 0x000000ff;
-   }
+	uint32x4_t Abcd = vld1q_u32(&State[0]);
+	uint32x4_t Efgh = vld1q_u32(&State[4]);
+	uint32x4_t AbcdSave, EfghSave, Prev, Wk;
+	uint32x4_t M[4];
+	u32 j;
+
+	while (NumBlocks-- > 0) {
+		AbcdSave = Abcd;
+		EfghSave = Efgh;
+
+		for (j = 0; j < 4; j++) {
+			M[j] = vreinterpretq_u32_u8(vrev32q_u8(
+					vld1q_u8(Data + (j * 16))));
+		}
+
+		for (j = 0; j < 16; j++) {
+			Wk = vaddq_u32(M[j & 3], vld1q_u32(&k[j * 4]));
+
+			/* W[4j+16..4j+19] replaces W[4j..4j+3] */
+			if (j < 12) {
+				M[j & 3] = vsha256su1q_u32(
+					vsha256su0q_u32(M[j & 3],
+						M[(j + 1) & 3]),
+					M[(j + 2) & 3], M[(j + 3) & 3]);
+			}
+
+			Prev = Abcd;
+			Abcd = vsha256hq_u32(Abcd, Efgh, Wk);
+			Efgh = vsha256h2q_u32(Efgh, Prev, Wk);
+		}
+
+		Abcd = vaddq_u32(Abcd, AbcdSave);
+		Efgh = vaddq_u32(Efgh, EfghSave);
+
+		Data += SHA256_BLOCK_SIZE;
+	}
+
+	vst1q_u32(&State[0], Abcd);
+	vst1q_u32(&State[4], Efgh);
+}
+#endif
+
+/*****************************************************************************/
+/**
+* This function selects the fastest block function the processor supports.
+*
+* @return The block function to use.
+*
+* @note   The SHA2 field of ID_AA64ISAR0_EL1 is non-zero when the SHA256
+*         instructions are implemented.
+*
+******************************************************************************/
+static Sha256BlocksType Sha256SelectBlocks(void)
+{
+	Sha256BlocksType Blocks = Sha256BlocksSw;
+#ifdef SHA256_ARMV8
+	u64 IsaR0;
+
+	__asm__ __volatile__("mrs %0, ID_AA64ISAR0_EL1" : "=r" (IsaR0));
+	if (((IsaR0 >> 12) & 0xF) != 0) {
+		Blocks = Sha256BlocksArmv8;
+	}
+#endif
+
+	return Blocks;
 }
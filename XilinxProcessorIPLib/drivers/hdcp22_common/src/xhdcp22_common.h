@@ -42,6 +42,7 @@
 * ----- ---- -------- -----------------------------------------------
 * 1.00  MH   10/30/15 First Release.
 * 1.01  MH   01/15/16 Added prefix to function names.
+* 1.02       10/18/26 Added incremental SHA256 functions.
 *</pre>
 *
 *****************************************************************************/
@@ -54,11 +55,22 @@ extern "C" {
 #endif
 
 /***************************** Include Files ********************************/
+#include "xil_types.h"
 #include "bigdigits.h"
 
 /************************** Constant Definitions ****************************/
+#define XHDCP22_CMN_SHA256_SIZE		32	/**< SHA256 Hash size in bytes */
 
 /**************************** Type Definitions ******************************/
+/**
+* Context of an incremental SHA256 hash calculation.
+*/
+typedef struct {
+	u32 State[8];		/**< Intermediate hash value */
+	u64 Length;		/**< Number of bytes hashed */
+	u8  Buffer[64];		/**< Partial block */
+	u32 BufferLen;		/**< Number of bytes in Buffer */
+} XHdcp22Cmn_Sha256Ctx;
 
 /***************** Macros (Inline Functions) Definitions ********************/
 
@@ -66,6 +78,9 @@ extern "C" {
 
 /* Cryptographic functions */
 void XHdcp22Cmn_Sha256Hash(const u8 *Data, u32 DataSize, u8 *HashedData);
+void XHdcp22Cmn_Sha256Init(XHdcp22Cmn_Sha256Ctx *Ctx);
+void XHdcp22Cmn_Sha256Update(XHdcp22Cmn_Sha256Ctx *Ctx, const u8 *Data, u32 DataSize);
+void XHdcp22Cmn_Sha256Final(XHdcp22Cmn_Sha256Ctx *Ctx, u8 *HashedData);
 int  XHdcp22Cmn_HmacSha256Hash(const u8 *Data, int DataSize, const u8 *Key, int KeySize, u8  *HashedData);
 void XHdcp22Cmn_Aes128Encrypt(const u8 *Data, const u8 *Key, u8 *Output);
 void XHdcp22Cmn_Aes128Decrypt(const u8 *Data, const u8 *Key, u8 *Output);
@@ -0,0 +1,439 @@
+/******************************************************************************
+*
+* Copyright (C) 2015 - 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+* @file xhdcp22_sha256_test.c
+*
+* Host known answer tests and benchmark of the SHA256 and HMAC-SHA256
+* functions.
+*
+* Checked:
+*  - the FIPS 180-4 example messages, including the 1,000,000 x 'a' one,
+*  - the RFC 4231 HMAC-SHA256 test cases 1 to 7,
+*  - every length from 0 to 1199 bytes, and random splits of the same data
+*    over several XHdcp22Cmn_Sha256Update calls, against a reference
+*    implementation in this file.
+*
+* The checks run on the block function sha2.c selects for the processor.
+* xhdcp22_sha256_test_portable, built with XHDCP22_SHA256_PORTABLE, runs
+* them on the portable implementation, so on an AArch64 host with the
+* Cryptography Extension both paths are covered.
+*
+* The reference implementation is the byte at a time code this driver used
+* before version 1.01: each byte is copied into the context, and each block
+* expands all 64 schedule words and shifts the eight working variables every
+* round. The benchmark hashes messages of the sizes used during HDCP 2.2
+* authentication and a bulk buffer with both, and prints cycles per byte
+* (time stamp counter cycles on x86, ns elsewhere) and the speed up.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.01       10/18/26 First release
+*</pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xhdcp22_common.h"
+
+/************************** Constant Definitions ****************************/
+#define MAX_LEN		1200	/**< Lengths checked against the reference */
+#define SPLIT_RUNS	2000	/**< Random split runs */
+#define BULK_LEN	16384	/**< Bulk benchmark buffer */
+
+/**************************** Type Definitions ******************************/
+/** Context of the reference implementation */
+typedef struct {
+	u8 Data[64];
+	u32 DataLen;
+	u64 BitLen;
+	u32 State[8];
+} RefCtx;
+
+/***************** Macros (Inline Functions) Definitions ********************/
+#define ROTRIGHT(a,b) (((a) >> (b)) | ((a) << (32-(b))))
+#define CH(x,y,z) (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x,y,z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define EP0(x) (ROTRIGHT(x,2) ^ ROTRIGHT(x,13) ^ ROTRIGHT(x,22))
+#define EP1(x) (ROTRIGHT(x,6) ^ ROTRIGHT(x,11) ^ ROTRIGHT(x,25))
+#define SIG0(x) (ROTRIGHT(x,7) ^ ROTRIGHT(x,18) ^ ((x) >> 3))
+#define SIG1(x) (ROTRIGHT(x,17) ^ ROTRIGHT(x,19) ^ ((x) >> 10))
+
+/************************** Variable Definitions ****************************/
+static const u32 RefK[64] = {
+   0x428a2f98,0x71374491,0xb5c0fbcf,0xe9b5dba5,0x3956c25b,0x59f111f1,0x923f82a4,0xab1c5ed5,
+   0xd807aa98,0x12835b01,0x243185be,0x550c7dc3,0x72be5d74,0x80deb1fe,0x9bdc06a7,0xc19bf174,
+   0xe49b69c1,0xefbe4786,0x0fc19dc6,0x240ca1cc,0x2de92c6f,0x4a7484aa,0x5cb0a9dc,0x76f988da,
+   0x983e5152,0xa831c66d,0xb00327c8,0xbf597fc7,0xc6e00bf3,0xd5a79147,0x06ca6351,0x14292967,
+   0x27b70a85,0x2e1b2138,0x4d2c6dfc,0x53380d13,0x650a7354,0x766a0abb,0x81c2c92e,0x92722c85,
+   0xa2bfe8a1,0xa81a664b,0xc24b8b70,0xc76c51a3,0xd192e819,0xd6990624,0xf40e3585,0x106aa070,
+   0x19a4c116,0x1e376c08,0x2748774c,0x34b0bcb5,0x391c0cb3,0x4ed8aa4a,0x5b9cca4f,0x682e6ff3,
+   0x748f82ee,0x78a5636f,0x84c87814,0x8cc70208,0x90befffa,0xa4506ceb,0xbef9a3f7,0xc67178f2
+};
+
+/** FIPS 180-4 example messages */
+static const struct {
+	const char *Msg;
+	u32 Repeat;
+	const char *Hash;
+} ShaKat[] = {
+	{ "", 1,
+	  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+	{ "abc", 1,
+	  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" },
+	{ "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 1,
+	  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" },
+	{ "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+	  "ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu", 1,
+	  "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1" },
+	{ "a", 1000000,
+	  "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" },
+};
+
+/** RFC 4231 test cases, key and data in hex unless Text is set */
+static const struct {
+	const char *Key;
+	u32 KeyRepeat;
+	const char *Data;
+	u32 DataRepeat;
+	u32 Text;
+	const char *Hmac;
+} HmacKat[] = {
+	{ "0b", 20, "Hi There", 1, 1,
+	  "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7" },
+	{ "4a656665", 1, "what do ya want for nothing?", 1, 1,
+	  "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843" },
+	{ "aa", 20, "dd", 50, 0,
+	  "773ea91e36800e46854db8ebd09181a72959098b3ef8c122d9635514ced565fe" },
+	{ "0102030405060708090a0b0c0d0e0f10111213141516171819", 1, "cd", 50, 0,
+	  "82558a389a443c0ea4cc819899f2083a85f0faa3e578f8077a2e3ff46729665b" },
+	/* Test case 5 only specifies the first 128 bits */
+	{ "0c", 20, "Test With Truncation", 1, 1,
+	  "a3b6167473100ee06e0c796c2955552b" },
+	{ "aa", 131, "Test Using Larger Than Block-Size Key - Hash Key First",
+	  1, 1,
+	  "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54" },
+	{ "aa", 131, "This is a test using a larger than block-size key and a "
+	  "larger than block-size data. The key needs to be hashed before "
+	  "being used by the HMAC algorithm.", 1, 1,
+	  "9b09ffa71b942fcb27635fbcd5b0e944bfdc63644f0713938a7f51535c3a35e2" },
+};
+
+static u32 Failed;
+
+/************************** Function Implementation *****************************/
+
+static void Check(u32 Cond, const char *What)
+{
+	if (Cond == 0U) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+static void RefTransform(RefCtx *Ctx, const u8 *Data)
+{
+	u32 a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
+
+	for (i = 0, j = 0; i < 16; ++i, j += 4)
+		m[i] = ((u32)Data[j] << 24) | ((u32)Data[j + 1] << 16) |
+			((u32)Data[j + 2] << 8) | (u32)Data[j + 3];
+	for ( ; i < 64; ++i)
+		m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
+
+	a = Ctx->State[0]; b = Ctx->State[1]; c = Ctx->State[2];
+	d = Ctx->State[3]; e = Ctx->State[4]; f = Ctx->State[5];
+	g = Ctx->State[6]; h = Ctx->State[7];
+
+	for (i = 0; i < 64; ++i) {
+		t1 = h + EP1(e) + CH(e, f, g) + RefK[i] + m[i];
+		t2 = EP0(a) + MAJ(a, b, c);
+		h = g; g = f; f = e; e = d + t1;
+		d = c; c = b; b = a; a = t1 + t2;
+	}
+
+	Ctx->State[0] += a; Ctx->State[1] += b; Ctx->State[2] += c;
+	Ctx->State[3] += d; Ctx->State[4] += e; Ctx->State[5] += f;
+	Ctx->State[6] += g; Ctx->State[7] += h;
+}
+
+static void RefHash(const u8 *Data, u32 Len, u8 *Hash)
+{
+	static const u32 Iv[8] = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+	RefCtx Ctx;
+	u32 i;
+
+	memcpy(Ctx.State, Iv, sizeof(Iv));
+	Ctx.DataLen = 0;
+	Ctx.BitLen = 0;
+
+	for (i = 0; i < Len; ++i) {
+		Ctx.Data[Ctx.DataLen++] = Data[i];
+		if (Ctx.DataLen == 64) {
+			RefTransform(&Ctx, Ctx.Data);
+			Ctx.BitLen += 512;
+			Ctx.DataLen = 0;
+		}
+	}
+
+	Ctx.BitLen += (u64)Ctx.DataLen * 8;
+	i = Ctx.DataLen;
+	Ctx.Data[i++] = 0x80;
+	if (i > 56) {
+		while (i < 64)
+			Ctx.Data[i++] = 0x00;
+		RefTransform(&Ctx, Ctx.Data);
+		i = 0;
+	}
+	while (i < 56)
+		Ctx.Data[i++] = 0x00;
+	for (i = 0; i < 8; i++)
+		Ctx.Data[63 - i] = (u8)(Ctx.BitLen >> (8 * i));
+	RefTransform(&Ctx, Ctx.Data);
+
+	for (i = 0; i < 32; i++)
+		Hash[i] = (u8)(Ctx.State[i / 4] >> (24 - (8 * (i % 4))));
+}
+
+/* Converts Hex, repeated Repeat times, into Out and returns its length */
+static u32 FromHex(const char *Hex, u32 Repeat, u8 *Out)
+{
+	u32 Len = strlen(Hex) / 2;
+	u32 i;
+	u32 r;
+	unsigned int Byte;
+
+	for (r = 0; r < Repeat; r++) {
+		for (i = 0; i < Len; i++) {
+			sscanf(&Hex[2 * i], "%2x", &Byte);
+			Out[(r * Len) + i] = (u8)Byte;
+		}
+	}
+	return Len * Repeat;
+}
+
+static void TestKat(void)
+{
+	XHdcp22Cmn_Sha256Ctx Ctx;
+	u8 Hash[XHDCP22_CMN_SHA256_SIZE];
+	u8 Expect[XHDCP22_CMN_SHA256_SIZE];
+	u8 Key[256];
+	u8 Data[256];
+	u32 KeyLen;
+	u32 DataLen;
+	u32 Index;
+	u32 r;
+	char What[64];
+
+	for (Index = 0; Index < sizeof(ShaKat) / sizeof(ShaKat[0]); Index++) {
+		FromHex(ShaKat[Index].Hash, 1, Expect);
+		XHdcp22Cmn_Sha256Init(&Ctx);
+		for (r = 0; r < ShaKat[Index].Repeat; r++) {
+			XHdcp22Cmn_Sha256Update(&Ctx,
+				(const u8 *)ShaKat[Index].Msg,
+				strlen(ShaKat[Index].Msg));
+		}
+		XHdcp22Cmn_Sha256Final(&Ctx, Hash);
+		snprintf(What, sizeof(What), "FIPS 180-4 example %u", Index);
+		Check(memcmp(Hash, Expect, sizeof(Hash)) == 0, What);
+
+		if (ShaKat[Index].Repeat == 1) {
+			XHdcp22Cmn_Sha256Hash((const u8 *)ShaKat[Index].Msg,
+				strlen(ShaKat[Index].Msg), Hash);
+			snprintf(What, sizeof(What),
+				"FIPS 180-4 example %u, one shot", Index);
+			Check(memcmp(Hash, Expect, sizeof(Hash)) == 0, What);
+		}
+	}
+
+	for (Index = 0; Index < sizeof(HmacKat) / sizeof(HmacKat[0]);
+			Index++) {
+		KeyLen = FromHex(HmacKat[Index].Key, HmacKat[Index].KeyRepeat,
+				Key);
+		if (HmacKat[Index].Text) {
+			DataLen = strlen(HmacKat[Index].Data);
+			memcpy(Data, HmacKat[Index].Data, DataLen);
+		}
+		else {
+			DataLen = FromHex(HmacKat[Index].Data,
+					HmacKat[Index].DataRepeat, Data);
+		}
+		FromHex(HmacKat[Index].Hmac, 1, Expect);
+
+		snprintf(What, sizeof(What), "RFC 4231 test case %u",
+			Index + 1);
+		Check((XHdcp22Cmn_HmacSha256Hash(Data, DataLen, Key, KeyLen,
+			Hash) == XST_SUCCESS) &&
+			(memcmp(Hash, Expect,
+			strlen(HmacKat[Index].Hmac) / 2) == 0), What);
+	}
+}
+
+static void TestReference(void)
+{
+	XHdcp22Cmn_Sha256Ctx Ctx;
+	u8 *Data = malloc(MAX_LEN);
+	u8 Hash[XHDCP22_CMN_SHA256_SIZE];
+	u8 Ref[XHDCP22_CMN_SHA256_SIZE];
+	u32 Len;
+	u32 Offset;
+	u32 Part;
+	u32 Run;
+	u32 Bad = 0;
+	u32 BadSplit = 0;
+
+	srand(1);
+	for (Len = 0; Len < MAX_LEN; Len++) {
+		Data[Len] = (u8)rand();
+	}
+
+	for (Len = 0; Len < MAX_LEN; Len++) {
+		RefHash(Data, Len, Ref);
+		XHdcp22Cmn_Sha256Hash(Data, Len, Hash);
+		Bad += (memcmp(Hash, Ref, sizeof(Hash)) != 0);
+	}
+	Check(Bad == 0, "lengths 0 to 1199 against the reference");
+
+	for (Run = 0; Run < SPLIT_RUNS; Run++) {
+		Len = rand() % MAX_LEN;
+		RefHash(Data, Len, Ref);
+		XHdcp22Cmn_Sha256Init(&Ctx);
+		for (Offset = 0; Offset < Len; Offset += Part) {
+			/* Mostly short pieces, some over a block long */
+			Part = ((rand() % 4) == 0) ? (rand() % 200) :
+							(rand() % 17);
+			if (Part > (Len - Offset)) {
+				Part = Len - Offset;
+			}
+			XHdcp22Cmn_Sha256Update(&Ctx, Data + Offset, Part);
+		}
+		XHdcp22Cmn_Sha256Final(&Ctx, Hash);
+		BadSplit += (memcmp(Hash, Ref, sizeof(Hash)) != 0);
+	}
+	Check(BadSplit == 0, "random incremental splits");
+
+	free(Data);
+}
+
+static u64 Now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return ((u64)Ts.tv_sec * 1000000000ULL) + (u64)Ts.tv_nsec;
+#endif
+}
+
+/* Best of several runs of Count hashes of Len bytes, per byte */
+static double Bench(u32 Len, u32 Count, u32 UseRef, const u8 *Data)
+{
+	u8 Hash[XHDCP22_CMN_SHA256_SIZE];
+	double Best = 0.0;
+	double Per;
+	u64 Start;
+	u32 Rep;
+	u32 i;
+
+	for (Rep = 0; Rep < 9; Rep++) {
+		Start = Now();
+		for (i = 0; i < Count; i++) {
+			if (UseRef) {
+				RefHash(Data, Len, Hash);
+			}
+			else {
+				XHdcp22Cmn_Sha256Hash(Data, Len, Hash);
+			}
+		}
+		Per = (double)(Now() - Start) / ((double)Len * Count);
+		if ((Rep == 0) || (Per < Best)) {
+			Best = Per;
+		}
+	}
+	return Best;
+}
+
+int main(void)
+{
+	/* Message sizes of the HDCP 2.2 key derivation and V', and bulk */
+	static const u32 Lens[] = { 32, 64, 128, 192, 1024, BULK_LEN };
+	u8 *Data = malloc(BULK_LEN);
+	double Ref;
+	double New;
+	u32 Index;
+
+	TestKat();
+	TestReference();
+
+	for (Index = 0; Index < BULK_LEN; Index++) {
+		Data[Index] = (u8)(Index * 7);
+	}
+
+#if defined(__x86_64__) || defined(__i386__)
+	printf("\n%8s %16s %16s %8s\n", "bytes", "1.00 cycles/B",
+		"1.01 cycles/B", "speedup");
+#else
+	printf("\n%8s %16s %16s %8s\n", "bytes", "1.00 ns/B", "1.01 ns/B",
+		"speedup");
+#endif
+	for (Index = 0; Index < sizeof(Lens) / sizeof(Lens[0]); Index++) {
+		u32 Count = (4U * 1024U * 1024U) / Lens[Index];
+
+		Ref = Bench(Lens[Index], Count, 1, Data);
+		New = Bench(Lens[Index], Count, 0, Data);
+		printf("%8u %16.2f %16.2f %7.2fx\n", Lens[Index], Ref, New,
+			Ref / New);
+	}
+
+	free(Data);
+
+	printf("\n%s\n", (Failed == 0U) ? "all checks passed" :
+						"CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}
@@ -46,6 +46,11 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- -----------------------------------------------
 * 1.00  MH   10/30/15 First Release
+* 1.01       10/18/26 Replaced the binary square and multiply in MontExp with
+*                     a constant time fixed window method and added the
+*                     _XHDCP22_RX_CRT_PARALLEL_ option to compute the CRT
+*                     halves on the MMULT core and the processor in parallel.
+*                     The exponentiation contexts are kept off the stack.
 *</pre>
 *
 *****************************************************************************/
@@ -60,13 +65,53 @@
 #include "xhdcp22_common.h"
 
 /************************** Constant Definitions ****************************/
+/**
+* Window size in bits used by the fixed window modular exponentiation.
+* The table of precomputed powers holds 2^XHDCP22_RX_MONTEXP_WINDOW
+* n-residues. Must be 1, 2 or 4 so that windows do not straddle digits.
+*/
+#ifndef XHDCP22_RX_MONTEXP_WINDOW
+#define XHDCP22_RX_MONTEXP_WINDOW	4
+#endif
+
+#if (32 % XHDCP22_RX_MONTEXP_WINDOW) != 0 || XHDCP22_RX_MONTEXP_WINDOW > 4
+#error "XHDCP22_RX_MONTEXP_WINDOW must be 1, 2 or 4"
+#endif
+
+#define XHDCP22_RX_MONTEXP_TABLE_SIZE	(1 << XHDCP22_RX_MONTEXP_WINDOW)
 
 /**************************** Type Definitions ******************************/
+/**
+* This typedef contains the state of one modular exponentiation,
+* C = A^E*mod(N), while it is stepped through the fixed window schedule.
+* A, E, N and C are XHDCP22_RX_N_SIZE/4 digits in size.
+*/
+typedef struct
+{
+	DIGIT_T *C;				/**< Result */
+	DIGIT_T *A;				/**< Base */
+	DIGIT_T *E;				/**< Exponent */
+	DIGIT_T *N;				/**< Modulus */
+	const DIGIT_T *NPrime;	/**< Pre-computed Montgomery constant */
+	u8 UseMmult;			/**< Run the multiplications on the MMULT core */
+	DIGIT_T *OpU;			/**< Pending multiplication, U = MontMult(A,B,N) */
+	DIGIT_T *OpA;
+	DIGIT_T *OpB;
+	DIGIT_T Xbar[XHDCP22_RX_P_SIZE/4];	/**< Running result n-residue */
+	DIGIT_T Sel[XHDCP22_RX_P_SIZE/4];	/**< Selected table entry */
+	DIGIT_T Table[XHDCP22_RX_MONTEXP_TABLE_SIZE][XHDCP22_RX_P_SIZE/4]; /**< n-residues of A^i */
+} XHdcp22Rx_MontExpCtx;
 
 /***************** Macros (Inline Functions) Definitions ********************/
 #define XHdcp22Rx_MpSizeof(A) (sizeof(A)/sizeof(DIGIT_T))
 
 /************************** Variable Definitions ****************************/
+/**
+* Exponentiation contexts of the two CRT halves used by
+* XHdcp22Rx_Pkcs1Rsadp. At 2.3 KB they are kept off the stack, and they are
+* cleared after every decryption since the tables are key dependent.
+*/
+static XHdcp22Rx_MontExpCtx XHdcp22Rx_RsadpCtx[2];
 
 /************************** Function Prototypes *****************************/
 /* Functions for implementing PCKS1 */
@@ -79,8 +124,12 @@ static void XHdcp22Rx_Pkcs1MontMultAdd(DIGIT_T *A, DIGIT_T C, int SDigit, int ND
 static void XHdcp22Rx_Pkcs1MontMult(DIGIT_T *U, DIGIT_T *A, DIGIT_T *B, DIGIT_T *N, const DIGIT_T *NPrime, int NDigits);
 static void XHdcp22Rx_Pkcs1MontMultFiosStub(DIGIT_T *U, DIGIT_T *A, DIGIT_T *B, DIGIT_T *N, const DIGIT_T *NPrime, int NDigits);
 static void XHdcp22Rx_Pkcs1MontMultFiosInit(XHdcp22_Rx *InstancePtr, DIGIT_T *N, const DIGIT_T *NPrime, int NDigits);
+static void XHdcp22Rx_Pkcs1MontMultFiosStart(XHdcp22_Rx *InstancePtr, DIGIT_T *A, DIGIT_T *B, int NDigits);
+static void XHdcp22Rx_Pkcs1MontMultFiosWait(XHdcp22_Rx *InstancePtr, DIGIT_T *U, int NDigits);
 static void XHdcp22Rx_Pkcs1MontMultFios(XHdcp22_Rx *InstancePtr, DIGIT_T *U, DIGIT_T *A, DIGIT_T *B, int NDigits);
-static int  XHdcp22Rx_Pkcs1MontExp(XHdcp22_Rx *InstancePtr, DIGIT_T *C, DIGIT_T *A, DIGIT_T *E, DIGIT_T *N, const DIGIT_T *NPrime, int NDigits);
+static void XHdcp22Rx_Pkcs1MontExpMult(XHdcp22_Rx *InstancePtr, XHdcp22Rx_MontExpCtx *Ctx, int Count, int NDigits);
+static void XHdcp22Rx_Pkcs1MontExpSelect(DIGIT_T *Sel, DIGIT_T Table[][XHDCP22_RX_P_SIZE/4], DIGIT_T Index, int NDigits);
+static int  XHdcp22Rx_Pkcs1MontExp(XHdcp22_Rx *InstancePtr, XHdcp22Rx_MontExpCtx *Ctx, int Count, int NDigits);
 
 /* Functions for implementing other cryptographic tasks */
 static void XHdcp22Rx_ComputeDKey(const u8* Rrx, const u8* Rtx, const u8 *Km, const u8 *Rn, u8 *Ctr, u8 *DKey);
@@ -335,7 +384,10 @@ static int XHdcp22Rx_Pkcs1Rsaep(const XHdcp22_Rx_KpubRx *KpubRx, u8 *Message, u8
 /****************************************************************************/
 /**
 * This function implements the RSADP primitive using the Chinese Remainder
-* Theorem (CRT).
+* Theorem (CRT). When _XHDCP22_RX_CRT_PARALLEL_ is defined, the two CRT
+* halves are computed in parallel, m1 on the MMULT core and m2 on the
+* processor. This only pays off when the processor computes a software
+* Montgomery multiplication about as fast as the MMULT core.
 *
 * Reference: PKCS#1 v2.1, Section 5.1.2
 *
@@ -356,53 +408,80 @@ static int XHdcp22Rx_Pkcs1Rsadp(XHdcp22_Rx *InstancePtr, const XHdcp22_Rx_KprivR
 	Xil_AssertNonvoid(EncryptedMessage != NULL);
 	Xil_AssertNonvoid(Message != NULL);
 
-	DIGIT_T A[XHDCP22_RX_N_SIZE/4];
-	DIGIT_T B[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T P[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T Q[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T Dp[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T Dq[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T NPrimeP[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T NPrimeQ[XHDCP22_RX_N_SIZE/4];
 	DIGIT_T C[XHDCP22_RX_N_SIZE/4];
 	DIGIT_T D[XHDCP22_RX_N_SIZE/4];
 	DIGIT_T M1[XHDCP22_RX_N_SIZE/4];
 	DIGIT_T M2[XHDCP22_RX_N_SIZE/4];
+	XHdcp22Rx_MontExpCtx *Ctx = XHdcp22Rx_RsadpCtx;
 	u32 Status;
 
 	/* Clear variables */
-	memset(A, 0, sizeof(A));
-	memset(B, 0, sizeof(B));
+	memset(P, 0, sizeof(P));
+	memset(Q, 0, sizeof(Q));
+	memset(Dp, 0, sizeof(Dp));
+	memset(Dq, 0, sizeof(Dq));
+	memset(NPrimeP, 0, sizeof(NPrimeP));
+	memset(NPrimeQ, 0, sizeof(NPrimeQ));
 	memset(C, 0, sizeof(C));
 	memset(D, 0, sizeof(D));
 	memset(M1, 0, sizeof(M1));
 	memset(M2, 0, sizeof(M2));
 
-	/* Step 2b part I: Generate m1 = c^dP * mod(p) */
-	mpConvFromOctets(A, XHdcp22Rx_MpSizeof(A), KprivRx->p, XHDCP22_RX_P_SIZE);
-	mpConvFromOctets(B, XHdcp22Rx_MpSizeof(B), KprivRx->dp, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(P, XHdcp22Rx_MpSizeof(P), KprivRx->p, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(Q, XHdcp22Rx_MpSizeof(Q), KprivRx->q, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(Dp, XHdcp22Rx_MpSizeof(Dp), KprivRx->dp, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(Dq, XHdcp22Rx_MpSizeof(Dq), KprivRx->dq, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(NPrimeP, XHdcp22Rx_MpSizeof(NPrimeP), InstancePtr->NPrimeP, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(NPrimeQ, XHdcp22Rx_MpSizeof(NPrimeQ), InstancePtr->NPrimeQ, XHDCP22_RX_P_SIZE);
 	mpConvFromOctets(C, XHdcp22Rx_MpSizeof(C), EncryptedMessage, XHDCP22_RX_N_SIZE);
-	mpConvFromOctets(D, XHdcp22Rx_MpSizeof(D), InstancePtr->NPrimeP, XHDCP22_RX_P_SIZE);
-	//Status = mpModExp(M1, C, B, A, XHDCP22_RX_N_SIZE/4);
-	Status = XHdcp22Rx_Pkcs1MontExp(InstancePtr, M1, C, B, A, D, 16);
 
-	/* Step 2b part I: Generate m2 = c^dQ * mod(q) */
-	mpConvFromOctets(A, XHdcp22Rx_MpSizeof(A), KprivRx->q, XHDCP22_RX_P_SIZE);
-	mpConvFromOctets(B, XHdcp22Rx_MpSizeof(B), KprivRx->dq, XHDCP22_RX_P_SIZE);
-	mpConvFromOctets(D, XHdcp22Rx_MpSizeof(D), InstancePtr->NPrimeQ, XHDCP22_RX_P_SIZE);
-	//Status = mpModExp(M2, C, D, B, XHDCP22_RX_N_SIZE/4);
-	Status = XHdcp22Rx_Pkcs1MontExp(InstancePtr, M2, C, B, A, D, 16);
+	/* Step 2b part I: Generate m1 = c^dP * mod(p) and m2 = c^dQ * mod(q) */
+	Ctx[0].C = M1;
+	Ctx[0].A = C;
+	Ctx[0].E = Dp;
+	Ctx[0].N = P;
+	Ctx[0].NPrime = NPrimeP;
+	Ctx[0].UseMmult = TRUE;
+
+	Ctx[1].C = M2;
+	Ctx[1].A = C;
+	Ctx[1].E = Dq;
+	Ctx[1].N = Q;
+	Ctx[1].NPrime = NPrimeQ;
+	Ctx[1].UseMmult = TRUE;
+
+#if defined(_XHDCP22_RX_CRT_PARALLEL_) && !defined(_XHDCP22_RX_SW_MMULT_)
+	/* Compute m1 on the MMULT core while the processor computes m2 */
+	Ctx[1].UseMmult = FALSE;
+	Status = XHdcp22Rx_Pkcs1MontExp(InstancePtr, Ctx, 2, 16);
+#else
+	Status = XHdcp22Rx_Pkcs1MontExp(InstancePtr, &Ctx[0], 1, 16);
+	Status = XHdcp22Rx_Pkcs1MontExp(InstancePtr, &Ctx[1], 1, 16);
+#endif
+
+	/* Clear the key dependent n-residues */
+	memset(XHdcp22Rx_RsadpCtx, 0, sizeof(XHdcp22Rx_RsadpCtx));
 
 	/* Step 2b part II: Skip since u=2 */
 
 	/* Step 2b part III: Generate h = (m1 - m2) * qInv * mod(p) */
-	mpConvFromOctets(A, XHdcp22Rx_MpSizeof(A), KprivRx->p, XHDCP22_RX_P_SIZE);
 	Status = mpSubtract(D, M1, M2, XHdcp22Rx_MpSizeof(D)); // mdiff = m1 -m2
 	if(Status != XST_SUCCESS)
 	{
-		mpAdd(M1, M1, A, XHdcp22Rx_MpSizeof(M1));
+		mpAdd(M1, M1, P, XHdcp22Rx_MpSizeof(M1));
 		mpSubtract(D, M1, M2, XHdcp22Rx_MpSizeof(D));
 	}
 	mpConvFromOctets(C, XHdcp22Rx_MpSizeof(C), KprivRx->qinv, XHDCP22_RX_P_SIZE);
-	Status = mpModMult(C, D, C, A, XHDCP22_RX_N_SIZE/4); // h = mdiff * qInv * mod(p)
+	Status = mpModMult(C, D, C, P, XHDCP22_RX_N_SIZE/4); // h = mdiff * qInv * mod(p)
 
 	/* Step 2b part IV: Generate m = m2 + q * h */
-	mpConvFromOctets(A, XHdcp22Rx_MpSizeof(A), KprivRx->q, XHDCP22_RX_P_SIZE);
-	Status = mpMultiply(D, A, C, XHDCP22_RX_P_SIZE/4); // qh = q * h
+	Status = mpMultiply(D, Q, C, XHDCP22_RX_P_SIZE/4); // qh = q * h
 	Status = mpAdd(C, M2, D, XHDCP22_RX_N_SIZE/4); // m = m2 + qh
 
 	/* Convert integer to octet string */
@@ -893,26 +972,24 @@ static void XHdcp22Rx_Pkcs1MontMultFiosInit(XHdcp22_Rx *InstancePtr, DIGIT_T *N,
 
 /****************************************************************************/
 /**
-* This function runs the Montgomery Multiplier (MMULT) hardware to perform
-* the modular multiplication operation required by RSA decryption.
-*
-* U = MontMult(A,B,N)
+* This function loads the operands into the Montgomery Multiplier (MMULT)
+* hardware and starts the modular multiplication without waiting for
+* it to complete. The result is collected with
+* XHdcp22Rx_Pkcs1MontMultFiosWait.
 *
 * @param	InstancePtr is a pointer to the MMULT instance.
-* @param	U is the MMM result
 * @param	A is the n-residue input, A' = A*R mod N
 * @param	B is the n-residue input, B' = B*R mod N
-* @param	NDigits is the integer precision of the arguments (C,A,B,N,NPrime)
+* @param	NDigits is the integer precision of the arguments (A,B)
 *
 * @return	None.
 *
 * @note		None.
 *****************************************************************************/
-static void XHdcp22Rx_Pkcs1MontMultFios(XHdcp22_Rx *InstancePtr, DIGIT_T *U, DIGIT_T *A, DIGIT_T *B, int NDigits)
+static void XHdcp22Rx_Pkcs1MontMultFiosStart(XHdcp22_Rx *InstancePtr, DIGIT_T *A, DIGIT_T *B, int NDigits)
 {
 	/* Verify arguments */
 	Xil_AssertVoid(InstancePtr != NULL);
-	Xil_AssertVoid(U != NULL);
 	Xil_AssertVoid(A != NULL);
 	Xil_AssertVoid(B != NULL);
 	Xil_AssertVoid(NDigits == 16);
@@ -928,6 +1005,27 @@ static void XHdcp22Rx_Pkcs1MontMultFios(XHdcp22_Rx *InstancePtr, DIGIT_T *U, DIG
 
 	/* Run MontMult */
 	XHdcp22_mmult_Start(&InstancePtr->MmultInst);
+}
+
+/****************************************************************************/
+/**
+* This function waits for the modular multiplication started by
+* XHdcp22Rx_Pkcs1MontMultFiosStart to complete and reads the result.
+*
+* @param	InstancePtr is a pointer to the MMULT instance.
+* @param	U is the MMM result
+* @param	NDigits is the integer precision of the arguments (U)
+*
+* @return	None.
+*
+* @note		None.
+*****************************************************************************/
+static void XHdcp22Rx_Pkcs1MontMultFiosWait(XHdcp22_Rx *InstancePtr, DIGIT_T *U, int NDigits)
+{
+	/* Verify arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(U != NULL);
+	Xil_AssertVoid(NDigits == 16);
 
 	/* Poll Result */
 	while(XHdcp22_mmult_IsDone(&InstancePtr->MmultInst) == 0);
@@ -936,77 +1034,244 @@ static void XHdcp22Rx_Pkcs1MontMultFios(XHdcp22_Rx *InstancePtr, DIGIT_T *U, DIG
 	XHdcp22_mmult_Read_U_Words(&InstancePtr->MmultInst, 0, (int *)U, NDigits);
 }
 
+/****************************************************************************/
+/**
+* This function runs the Montgomery Multiplier (MMULT) hardware to perform
+* the modular multiplication operation required by RSA decryption.
+*
+* U = MontMult(A,B,N)
+*
+* @param	InstancePtr is a pointer to the MMULT instance.
+* @param	U is the MMM result
+* @param	A is the n-residue input, A' = A*R mod N
+* @param	B is the n-residue input, B' = B*R mod N
+* @param	NDigits is the integer precision of the arguments (C,A,B,N,NPrime)
+*
+* @return	None.
+*
+* @note		None.
+*****************************************************************************/
+static void XHdcp22Rx_Pkcs1MontMultFios(XHdcp22_Rx *InstancePtr, DIGIT_T *U, DIGIT_T *A, DIGIT_T *B, int NDigits)
+{
+	XHdcp22Rx_Pkcs1MontMultFiosStart(InstancePtr, A, B, NDigits);
+	XHdcp22Rx_Pkcs1MontMultFiosWait(InstancePtr, U, NDigits);
+}
+
+/****************************************************************************/
+/**
+* This function performs the pending Montgomery multiplication,
+* OpU = MontMult(OpA,OpB,N), of each exponentiation context. The
+* multiplication of the context using the MMULT core is started first so
+* that it runs while the processor computes the software multiplications
+* of the other contexts.
+*
+* @param	InstancePtr is a pointer to the MMULT instance.
+* @param	Ctx is an array of exponentiation contexts.
+* @param	Count is the number of contexts in the array.
+* @param	NDigits is the integer precision of the operands.
+*
+* @return	None.
+*
+* @note		At most one context may have UseMmult set.
+*****************************************************************************/
+static void XHdcp22Rx_Pkcs1MontExpMult(XHdcp22_Rx *InstancePtr, XHdcp22Rx_MontExpCtx *Ctx, int Count, int NDigits)
+{
+	int i;
+
+#ifndef _XHDCP22_RX_SW_MMULT_
+	for(i=0; i<Count; i++)
+	{
+		if(Ctx[i].UseMmult)
+		{
+			XHdcp22Rx_Pkcs1MontMultFiosStart(InstancePtr, Ctx[i].OpA, Ctx[i].OpB, NDigits);
+		}
+	}
+#endif
+
+	for(i=0; i<Count; i++)
+	{
+		if(!Ctx[i].UseMmult)
+		{
+			XHdcp22Rx_Pkcs1MontMultFiosStub(Ctx[i].OpU, Ctx[i].OpA, Ctx[i].OpB,
+				Ctx[i].N, Ctx[i].NPrime, NDigits);
+		}
+	}
+
+#ifndef _XHDCP22_RX_SW_MMULT_
+	for(i=0; i<Count; i++)
+	{
+		if(Ctx[i].UseMmult)
+		{
+			XHdcp22Rx_Pkcs1MontMultFiosWait(InstancePtr, Ctx[i].OpU, NDigits);
+		}
+	}
+#endif
+}
+
+/****************************************************************************/
+/**
+* This function copies entry Index of the table of precomputed powers to
+* Sel. Every entry is read and masked so that the memory access pattern
+* does not depend on the secret exponent bits.
+*
+* @param	Sel is the selected n-residue.
+* @param	Table is the table of XHDCP22_RX_MONTEXP_TABLE_SIZE n-residues.
+* @param	Index is the table entry to select.
+* @param	NDigits is the integer precision of the table entries.
+*
+* @return	None.
+*
+* @note		None.
+*****************************************************************************/
+static void XHdcp22Rx_Pkcs1MontExpSelect(DIGIT_T *Sel, DIGIT_T Table[][XHDCP22_RX_P_SIZE/4], DIGIT_T Index, int NDigits)
+{
+	int i, j;
+	DIGIT_T Diff;
+	DIGIT_T Mask;
+
+	memset(Sel, 0, 4*NDigits);
+
+	for(i=0; i<XHDCP22_RX_MONTEXP_TABLE_SIZE; i++)
+	{
+		/* Mask is all ones when i == Index, otherwise zero */
+		Diff = (DIGIT_T)i ^ Index;
+		Mask = ((Diff | (0 - Diff)) >> 31) - 1;
+
+		for(j=0; j<NDigits; j++)
+		{
+			Sel[j] |= Table[i][j] & Mask;
+		}
+	}
+}
+
 /****************************************************************************/
 /**
 * This function performs the modular exponentation operation using the
-* binary square and multiply method.
+* fixed window (k-ary) method with a table of precomputed powers.
 *
 * C = ModExp(A, E, N) = A^E*mod(N)
 *
-* @param	C is result of the modular exponentiation
-* @param	A is the base
-* @param	E is the exponent
-* @param	N is the modulus
-* @param	NPrime is a constant
-* @param	NDigits is the integer precision of the arguments (C,A,B,N,NPrime).
+* Every window of XHDCP22_RX_MONTEXP_WINDOW exponent bits costs the same
+* number of squarings and one multiplication, including windows of zero
+* bits, so the sequence of multiplications is independent of the exponent.
+* For a 512-bit exponent this takes 650 multiplications where the binary
+* method takes 768 on average.
+*
+* When more than one context is given, the exponentiations are stepped in
+* lockstep. This is used to compute the two CRT halves in parallel, one
+* on the MMULT core and the other on the processor.
+*
+* @param	InstancePtr is a pointer to the MMULT instance.
+* @param	Ctx is an array of exponentiation contexts with C, A, E, N,
+* 			NPrime and UseMmult set.
+* @param	Count is the number of contexts in the array.
+* @param	NDigits is the integer precision of the arguments (C,A,E,N,NPrime).
 * 			Maximum integer precision is 16.
 *
-* @return	None.
+* @return	XST_SUCCESS.
 *
-* @note		None.
+* @note		At most one context may have UseMmult set.
 *****************************************************************************/
-static int  XHdcp22Rx_Pkcs1MontExp(XHdcp22_Rx *InstancePtr, DIGIT_T *C, DIGIT_T *A, DIGIT_T *E, DIGIT_T *N, const DIGIT_T *NPrime, int NDigits)
+static int  XHdcp22Rx_Pkcs1MontExp(XHdcp22_Rx *InstancePtr, XHdcp22Rx_MontExpCtx *Ctx, int Count, int NDigits)
 {
-	int Offset;
+	int i, k, Offset;
 	DIGIT_T R[XHDCP22_RX_N_SIZE/4];
 	DIGIT_T Abar[XHDCP22_RX_N_SIZE/4];
 	DIGIT_T Xbar[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T One[XHDCP22_RX_P_SIZE/4];
 
-	memset(R, 0, sizeof(R));
-	memset(Abar, 0, sizeof(Abar));
-	memset(Xbar, 0, sizeof(Xbar));
+	/* Verify arguments */
+	Xil_AssertNonvoid(Ctx != NULL);
+	Xil_AssertNonvoid(Count > 0);
+	Xil_AssertNonvoid(NDigits == 16);
+
+	for(k=0; k<Count; k++)
+	{
+		memset(R, 0, sizeof(R));
+		memset(Abar, 0, sizeof(Abar));
+		memset(Xbar, 0, sizeof(Xbar));
 
 #ifndef _XHDCP22_RX_SW_MMULT_
-	XHdcp22Rx_Pkcs1MontMultFiosInit(InstancePtr, N, NPrime, NDigits);
+		if(Ctx[k].UseMmult)
+		{
+			XHdcp22Rx_Pkcs1MontMultFiosInit(InstancePtr, Ctx[k].N, Ctx[k].NPrime, NDigits);
+		}
+#else
+		Ctx[k].UseMmult = FALSE;
 #endif
 
-	/* Step 0: R = 2^(NDigits*32) */
-	mpConvFromDecimal(R, XHDCP22_RX_N_SIZE/4, "1");
-	mpShiftLeft(R, R, NDigits*32, XHDCP22_RX_N_SIZE/4);
+		/* Step 0: R = 2^(NDigits*32) */
+		mpConvFromDecimal(R, XHDCP22_RX_N_SIZE/4, "1");
+		mpShiftLeft(R, R, NDigits*32, XHDCP22_RX_N_SIZE/4);
 
-	/* Step 1: Xbar = 1*R*mod(N) */
-	mpModulo(Xbar, R, XHDCP22_RX_N_SIZE/4, N, NDigits); // Optimization
+		/* Step 1: Xbar = 1*R*mod(N) */
+		mpModulo(Xbar, R, XHDCP22_RX_N_SIZE/4, Ctx[k].N, NDigits); // Optimization
 
-	/* Step 2: Abar = A*R*mod(N) */
-	mpModMult(Abar, A, Xbar, N, 2*NDigits);
+		/* Step 2: Abar = A*R*mod(N) */
+		mpModMult(Abar, Ctx[k].A, Xbar, Ctx[k].N, 2*NDigits);
 
-	/* Step 3: Binary square and multiply */
-	for(Offset=32*NDigits-1; Offset>=0; Offset--)
+		memcpy(Ctx[k].Table[0], Xbar, 4*NDigits);
+		memcpy(Ctx[k].Table[1], Abar, 4*NDigits);
+	}
+
+	/* Step 3: Table[i] = Abar^i */
+	for(i=2; i<XHDCP22_RX_MONTEXP_TABLE_SIZE; i++)
 	{
-#ifndef _XHDCP22_RX_SW_MMULT_
-		XHdcp22Rx_Pkcs1MontMultFios(InstancePtr, Xbar, Xbar, Xbar, NDigits);
-#else
-		XHdcp22Rx_Pkcs1MontMultFiosStub(Xbar, Xbar, Xbar, N, NPrime, NDigits);
-#endif
+		for(k=0; k<Count; k++)
+		{
+			Ctx[k].OpU = Ctx[k].Table[i];
+			Ctx[k].OpA = Ctx[k].Table[i-1];
+			Ctx[k].OpB = Ctx[k].Table[1];
+		}
+		XHdcp22Rx_Pkcs1MontExpMult(InstancePtr, Ctx, Count, NDigits);
+	}
 
-		if(mpGetBit(E, NDigits, Offset) == TRUE)
+	/* Step 4: Fixed window square and multiply, starting from the
+	   power selected by the most significant window */
+	Offset = 32*NDigits - XHDCP22_RX_MONTEXP_WINDOW;
+	for(k=0; k<Count; k++)
+	{
+		XHdcp22Rx_Pkcs1MontExpSelect(Ctx[k].Xbar, Ctx[k].Table,
+			(Ctx[k].E[Offset/32] >> (Offset%32)) & (XHDCP22_RX_MONTEXP_TABLE_SIZE-1),
+			NDigits);
+	}
+
+	for(Offset-=XHDCP22_RX_MONTEXP_WINDOW; Offset>=0; Offset-=XHDCP22_RX_MONTEXP_WINDOW)
+	{
+		for(i=0; i<XHDCP22_RX_MONTEXP_WINDOW; i++)
 		{
-#ifndef _XHDCP22_RX_SW_MMULT_
-			XHdcp22Rx_Pkcs1MontMultFios(InstancePtr, Xbar, Xbar, Abar, NDigits);
-#else
-			XHdcp22Rx_Pkcs1MontMultFiosStub(Xbar, Xbar, Abar, N, NPrime, NDigits);
-#endif
+			for(k=0; k<Count; k++)
+			{
+				Ctx[k].OpU = Ctx[k].Xbar;
+				Ctx[k].OpA = Ctx[k].Xbar;
+				Ctx[k].OpB = Ctx[k].Xbar;
+			}
+			XHdcp22Rx_Pkcs1MontExpMult(InstancePtr, Ctx, Count, NDigits);
 		}
+
+		for(k=0; k<Count; k++)
+		{
+			XHdcp22Rx_Pkcs1MontExpSelect(Ctx[k].Sel, Ctx[k].Table,
+				(Ctx[k].E[Offset/32] >> (Offset%32)) & (XHDCP22_RX_MONTEXP_TABLE_SIZE-1),
+				NDigits);
+			Ctx[k].OpU = Ctx[k].Xbar;
+			Ctx[k].OpA = Ctx[k].Xbar;
+			Ctx[k].OpB = Ctx[k].Sel;
+		}
+		XHdcp22Rx_Pkcs1MontExpMult(InstancePtr, Ctx, Count, NDigits);
 	}
 
-	/* Step 4: C=MonPro(Xbar,1) */
-	mpConvFromDecimal(R, XHDCP22_RX_N_SIZE/4, "1");
+	/* Step 5: C=MonPro(Xbar,1) */
+	memset(One, 0, sizeof(One));
+	One[0] = 1;
 
-#ifndef _XHDCP22_RX_SW_MMULT_
-	XHdcp22Rx_Pkcs1MontMultFios(InstancePtr, C, Xbar, R, NDigits);
-#else
-	XHdcp22Rx_Pkcs1MontMultFiosStub(C, Xbar, R, N, NPrime, NDigits);
-#endif
+	for(k=0; k<Count; k++)
+	{
+		Ctx[k].OpU = Ctx[k].C;
+		Ctx[k].OpA = Ctx[k].Xbar;
+		Ctx[k].OpB = One;
+	}
+	XHdcp22Rx_Pkcs1MontExpMult(InstancePtr, Ctx, Count, NDigits);
 
 	return XST_SUCCESS;
 }
@@ -0,0 +1,486 @@
+/******************************************************************************
+*
+* Copyright (C) 2015 - 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+* @file xhdcp22_rx_rsadp_sim.c
+*
+* Host test and benchmark of the RSA decryption primitive (RSADP) of the
+* HDCP 2.2 receiver, run against a model of the Montgomery multiplier
+* (MMULT) core.
+*
+* The model keeps the core registers in a page of host memory. Writing
+* ap_start computes U = MontMult(A,B,N) from the register contents and
+* raises ap_done once the configured latency has elapsed. Time is host time
+* minus the time spent inside the model, so a multiplication on the core
+* costs exactly its latency and runs in parallel with the software that
+* follows the start.
+*
+* Checked:
+*  - decrypting the R2 test vector Ekm gives Km,
+*  - RSADP of random ciphertexts matches a reference implementation in
+*    this file,
+*  - the number of multiplications run on the core,
+*  - the exponentiation contexts are cleared after every decryption.
+*
+* The reference implementation is the binary square and multiply this
+* driver used before version 1.01, with every multiplication on the core.
+* The benchmark decrypts Ekm with the reference and the driver for MMULT
+* latencies of a quarter, half and one times the software multiplication
+* time and prints the time of one decryption. The test is built twice, with
+* and without _XHDCP22_RX_CRT_PARALLEL_.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -----------------------------------------------
+* 1.01       10/18/26 First release
+*</pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "xil_io.h"
+/* The driver source is included to reach its static functions */
+#include "xhdcp22_rx_crypt.c"
+
+/************************** Constant Definitions ****************************/
+#define RUNS			7	/**< Timed decryptions, the best is kept */
+#define RANDOM_RUNS		16	/**< Random ciphertexts checked */
+#define SW_MULT_RUNS	2000	/**< Software multiplications timed */
+
+#define MMULT_AP_START	0x01	/**< ap_start bit of the control register */
+#define MMULT_AP_DONE	0x02	/**< ap_done bit, clear on read */
+#define MMULT_AP_IDLE	0x04	/**< ap_idle bit */
+#define MMULT_AP_READY	0x08	/**< ap_ready bit */
+
+/************************** Variable Definitions ****************************/
+/* Test vectors from xhdcp22_rx_test.c */
+/** This variable is the test private key for R2 */
+static const u8 XHdcp22_Rx_Test_PrivateKey[] =
+{
+		/* P */
+		0xf5, 0xf6, 0xfa, 0x44, 0xa2, 0x16, 0x2f, 0xa7, 0x1f, 0x7f, 0x16, 0x05, 0x99, 0x26, 0xc4,
+		0x1b, 0x80, 0x7f, 0xfa, 0x52, 0x4e, 0x3e, 0xaa, 0x3d, 0x1e, 0xb0, 0xf1, 0x9a, 0xc6, 0x3d,
+		0x8f, 0x57, 0x2b, 0x9e, 0xcd, 0xe8, 0x03, 0xd6, 0xf3, 0x91, 0x75, 0xe2, 0x19, 0x44, 0x9e,
+		0x11, 0x58, 0x5f, 0xd6, 0x88, 0x7c, 0xc4, 0xc1, 0x5b, 0x45, 0x9b, 0x84, 0xcf, 0x72, 0x1d,
+		0x35, 0xbf, 0x24, 0xd5,
+		/* Q */
+		0xed, 0xba, 0x08, 0xbf, 0x42, 0x2c, 0x0e, 0xfa, 0x3a, 0xc4, 0xd2, 0xc7, 0x01, 0x51, 0x25,
+		0xae, 0xb0, 0xa1, 0xcc, 0xdb, 0x67, 0x9b, 0xaa, 0x50, 0xf0, 0x80, 0xac, 0x4b, 0x9f, 0x5c,
+		0xba, 0x1e, 0xf4, 0x7f, 0xa9, 0xb3, 0x21, 0x8b, 0x62, 0x2c, 0x36, 0xda, 0xcd, 0xa7, 0x4d,
+		0xa4, 0xd6, 0x44, 0xed, 0xb1, 0x34, 0xe7, 0x69, 0x10, 0x77, 0x5a, 0x6a, 0xff, 0xf5, 0x63,
+		0x8a, 0x2c, 0x43, 0x09,
+		/* DP, d*mod(p-1)*/
+		0x61, 0x5a, 0xc4, 0x6c, 0x6e, 0x0b, 0x82, 0x09, 0x10, 0x3a, 0x69, 0x29, 0x06, 0x19, 0x85,
+		0xfd, 0xac, 0xba, 0xfb, 0x05, 0xa0, 0xda, 0xc4, 0xdf, 0x34, 0x4a, 0xad, 0x16, 0xa9, 0xe8,
+		0xab, 0xd7, 0xc0, 0xf8, 0x36, 0x5f, 0xe3, 0x45, 0x2d, 0x5b, 0x21, 0xe1, 0xc0, 0x46, 0x9c,
+		0x9a, 0x18, 0xf4, 0xb6, 0x21, 0x87, 0xe1, 0x08, 0xf7, 0x6b, 0x71, 0xc6, 0xfb, 0xa5, 0x1b,
+		0x52, 0xae, 0xb9, 0x91,
+		/* DQ, d*mod(q-1) */
+		0x5a, 0x83, 0x7f, 0xbb, 0x1a, 0xbd, 0xdd, 0xc2, 0x06, 0xc8, 0x54, 0x1c, 0xb3, 0x72, 0xab,
+		0x2f, 0x55, 0x4f, 0x75, 0xc9, 0x80, 0x2c, 0x73, 0xef, 0xb7, 0x72, 0xb6, 0xa7, 0x60, 0x79,
+		0x14, 0xe0, 0x9e, 0x65, 0x51, 0x3e, 0xc4, 0x21, 0xe6, 0xf2, 0x40, 0xbc, 0x94, 0x9b, 0x03,
+		0xe4, 0x24, 0x35, 0x40, 0x6f, 0x3d, 0x5e, 0x72, 0xd1, 0x73, 0x30, 0x39, 0x17, 0x55, 0xde,
+		0x5d, 0x88, 0xb6, 0xc9,
+		/* QINV, (q^-1)*mod(p) */
+		0xbc, 0x91, 0x2a, 0x93, 0x6a, 0x8d, 0x24, 0x3c, 0xd5, 0x7d, 0x12, 0x3b, 0xa3, 0x71, 0xc7,
+		0x3a, 0xf0, 0x64, 0x72, 0x50, 0x7e, 0x18, 0x71, 0xe1, 0xb4, 0x3b, 0x1e, 0xfc, 0x38, 0xca,
+		0xe6, 0x8c, 0x16, 0x51, 0x97, 0xd6, 0x3f, 0x04, 0xee, 0x23, 0x8b, 0x45, 0x0c, 0x4b, 0x98,
+		0x36, 0x18, 0x27, 0x29, 0x1b, 0x4d, 0x73, 0x7e, 0xe8, 0xb0, 0x1a, 0xc7, 0xfb, 0x5c, 0xea,
+		0x78, 0xd0, 0x6e, 0x97
+};
+
+/** This variable is the test master key Km for R2 */
+static const u8 XHdcp22_Rx_Test_Km[] =
+{
+		0xca, 0x9f, 0x83, 0x95, 0x70, 0xd0, 0xd0, 0xf9, 0xcf, 0xe4, 0xeb, 0x54, 0x7e, 0x09, 0xfa, 0x3b
+};
+
+/** This variable is the test encrypted master key EkpubKm for R2 */
+static const u8 XHdcp22_Rx_Test_Ekm[] =
+{
+		0xa8, 0x55, 0xc2, 0xc4, 0xc6, 0xbe,
+		0xef, 0xcd, 0xcb, 0x9f, 0xe3, 0x9f,
+		0x2a, 0xb7, 0x29, 0x76, 0xfe, 0xd8,
+		0xda, 0xc9, 0x38, 0xfa, 0x39, 0xf0,
+		0xab, 0xca, 0x8a, 0xed, 0x95, 0x7b,
+		0x93, 0xb2, 0xdf, 0xd0, 0x7d, 0x09,
+		0x9d, 0x05, 0x96, 0x66, 0x03, 0x6e,
+		0xba, 0xe0, 0x63, 0x0f, 0x30, 0x77,
+		0xc2, 0xbb, 0xe2, 0x11, 0x39, 0xe5,
+		0x27, 0x78, 0xee, 0x64, 0xf2, 0x85,
+		0x36, 0x57, 0xc3, 0x39, 0xd2, 0x7b,
+		0x79, 0x03, 0xb7, 0xcc, 0x82, 0xcb,
+		0xf0, 0x62, 0x82, 0x43, 0x38, 0x09,
+		0x9b, 0x71, 0xaa, 0x38, 0xa6, 0x3f,
+		0x48, 0x12, 0x6d, 0x8c, 0x5e, 0x07,
+		0x90, 0x76, 0xac, 0x90, 0x99, 0x51,
+		0x5b, 0x06, 0xa5, 0xfa, 0x50, 0xe4,
+		0xf9, 0x25, 0xc3, 0x07, 0x12, 0x37,
+		0x64, 0x92, 0xd7, 0xdb, 0xd3, 0x34,
+		0x1c, 0xe4, 0xfa, 0xdd, 0x09, 0xe6,
+		0x28, 0x3d, 0x0c, 0xad, 0xa9, 0xd8,
+		0xe1, 0xb5
+};
+
+static u32 *MmultRegs;		/**< Register space of the MMULT model */
+static u64 MmultNs;			/**< Latency of one multiplication */
+static u64 MmultDoneAt;		/**< Completion time of the running one */
+static u32 MmultBusy;		/**< A multiplication is running */
+static u32 MmultStarts;		/**< Multiplications started */
+static u64 ModelNs;			/**< Host time spent inside the model */
+static u32 Failed;
+
+static XHdcp22_Rx Rx;
+
+/************************** Function Definitions ****************************/
+static void Check(u32 Cond, const char *What)
+{
+	if (!Cond) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+static u64 HostNs(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return ((u64)Ts.tv_sec * 1000000000ULL) + (u64)Ts.tv_nsec;
+}
+
+static u64 SimNow(void)
+{
+	return HostNs() - ModelNs;
+}
+
+static void MmultStart(void)
+{
+	u64 Start = HostNs();
+	DIGIT_T U[XHDCP22_RX_P_SIZE/4];
+	DIGIT_T N[XHDCP22_RX_N_SIZE/4];
+
+	/* The software multiplier reads NDigits+3 words of N */
+	memset(N, 0, sizeof(N));
+	memcpy(N, &MmultRegs[XHDCP22_MMULT_CTRL_ADDR_N_BASE/4], XHDCP22_RX_P_SIZE);
+
+	XHdcp22Rx_Pkcs1MontMultFiosStub(U,
+		(DIGIT_T *)&MmultRegs[XHDCP22_MMULT_CTRL_ADDR_A_BASE/4],
+		(DIGIT_T *)&MmultRegs[XHDCP22_MMULT_CTRL_ADDR_B_BASE/4], N,
+		(DIGIT_T *)&MmultRegs[XHDCP22_MMULT_CTRL_ADDR_NPRIME_BASE/4], 16);
+	memcpy(&MmultRegs[XHDCP22_MMULT_CTRL_ADDR_U_BASE/4], U, sizeof(U));
+	ModelNs += HostNs() - Start;
+
+	MmultDoneAt = SimNow() + MmultNs;
+	MmultBusy = 1;
+	MmultStarts++;
+	MmultRegs[XHDCP22_MMULT_CTRL_ADDR_AP_CTRL/4] = MMULT_AP_START;
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Off = (u32)(Addr - (UINTPTR)MmultRegs);
+	u32 Value;
+
+	if (Off != XHDCP22_MMULT_CTRL_ADDR_AP_CTRL) {
+		return MmultRegs[Off/4];
+	}
+
+	if (MmultBusy && (SimNow() >= MmultDoneAt)) {
+		MmultBusy = 0;
+		MmultRegs[Off/4] = MMULT_AP_DONE | MMULT_AP_IDLE | MMULT_AP_READY;
+	}
+	Value = MmultRegs[Off/4];
+	MmultRegs[Off/4] &= ~MMULT_AP_DONE;
+
+	return Value;
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Off = (u32)(Addr - (UINTPTR)MmultRegs);
+
+	if (Off != XHDCP22_MMULT_CTRL_ADDR_AP_CTRL) {
+		MmultRegs[Off/4] = Value;
+	} else if ((Value & MMULT_AP_START) && !MmultBusy) {
+		MmultStart();
+	}
+}
+
+/* The driver log and random number generator are not used by RSADP */
+void XHdcp22Rx_LogWr(XHdcp22_Rx *InstancePtr, u16 Evt, u16 Data)
+{
+}
+
+void XHdcp22Rng_GetRandom(XHdcp22_Rng *InstancePtr, u8 *BufferPtr,
+	u16 BufferLength, u16 RandomLength)
+{
+}
+
+/* Reference: the binary square and multiply used before version 1.01 */
+static void RefMontExp(XHdcp22_Rx *InstancePtr, DIGIT_T *C, DIGIT_T *A,
+	DIGIT_T *E, DIGIT_T *N, const DIGIT_T *NPrime)
+{
+	int Offset;
+	DIGIT_T R[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T Abar[XHDCP22_RX_N_SIZE/4];
+	DIGIT_T Xbar[XHDCP22_RX_N_SIZE/4];
+
+	memset(R, 0, sizeof(R));
+	memset(Abar, 0, sizeof(Abar));
+	memset(Xbar, 0, sizeof(Xbar));
+
+	XHdcp22Rx_Pkcs1MontMultFiosInit(InstancePtr, N, NPrime, 16);
+
+	mpConvFromDecimal(R, XHDCP22_RX_N_SIZE/4, "1");
+	mpShiftLeft(R, R, 16*32, XHDCP22_RX_N_SIZE/4);
+	mpModulo(Xbar, R, XHDCP22_RX_N_SIZE/4, N, 16);
+	mpModMult(Abar, A, Xbar, N, 2*16);
+
+	for (Offset = 32*16-1; Offset >= 0; Offset--) {
+		XHdcp22Rx_Pkcs1MontMultFios(InstancePtr, Xbar, Xbar, Xbar, 16);
+		if (mpGetBit(E, 16, Offset) == TRUE) {
+			XHdcp22Rx_Pkcs1MontMultFios(InstancePtr, Xbar, Xbar, Abar, 16);
+		}
+	}
+
+	mpConvFromDecimal(R, XHDCP22_RX_N_SIZE/4, "1");
+	XHdcp22Rx_Pkcs1MontMultFios(InstancePtr, C, Xbar, R, 16);
+}
+
+static void RefRsadp(XHdcp22_Rx *InstancePtr, const XHdcp22_Rx_KprivRx *KprivRx,
+	const u8 *EncryptedMessage, u8 *Message)
+{
+	DIGIT_T P[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T Q[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T Dp[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T Dq[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T NPrimeP[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T NPrimeQ[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T C[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T D[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T M1[XHDCP22_RX_N_SIZE/4] = { 0 };
+	DIGIT_T M2[XHDCP22_RX_N_SIZE/4] = { 0 };
+
+	mpConvFromOctets(P, 32, KprivRx->p, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(Q, 32, KprivRx->q, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(Dp, 32, KprivRx->dp, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(Dq, 32, KprivRx->dq, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(NPrimeP, 32, InstancePtr->NPrimeP, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(NPrimeQ, 32, InstancePtr->NPrimeQ, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(C, 32, EncryptedMessage, XHDCP22_RX_N_SIZE);
+
+	RefMontExp(InstancePtr, M1, C, Dp, P, NPrimeP);
+	RefMontExp(InstancePtr, M2, C, Dq, Q, NPrimeQ);
+
+	if (mpSubtract(D, M1, M2, 32) != 0) {
+		mpAdd(M1, M1, P, 32);
+		mpSubtract(D, M1, M2, 32);
+	}
+	mpConvFromOctets(C, 32, KprivRx->qinv, XHDCP22_RX_P_SIZE);
+	mpModMult(C, D, C, P, XHDCP22_RX_N_SIZE/4);
+	mpMultiply(D, Q, C, XHDCP22_RX_P_SIZE/4);
+	mpAdd(C, M2, D, XHDCP22_RX_N_SIZE/4);
+
+	mpConvToOctets(C, 32, Message, XHDCP22_RX_N_SIZE);
+}
+
+/* Best time of RUNS decryptions of Ekm, in simulated ns */
+static u64 Bench(u32 UseRef)
+{
+	const XHdcp22_Rx_KprivRx *KprivRx =
+		(const XHdcp22_Rx_KprivRx *)XHdcp22_Rx_Test_PrivateKey;
+	u8 Em[XHDCP22_RX_N_SIZE];
+	u64 Best = 0;
+	u64 Start;
+	u64 Ns;
+	u32 Run;
+
+	for (Run = 0; Run < RUNS; Run++) {
+		Start = SimNow();
+		if (UseRef) {
+			RefRsadp(&Rx, KprivRx, XHdcp22_Rx_Test_Ekm, Em);
+		} else {
+			XHdcp22Rx_Pkcs1Rsadp(&Rx, KprivRx, (u8 *)XHdcp22_Rx_Test_Ekm, Em);
+		}
+		Ns = SimNow() - Start;
+		if ((Run == 0) || (Ns < Best)) {
+			Best = Ns;
+		}
+	}
+	return Best;
+}
+
+/* Software multiplication time, in ns */
+static double SwMultNs(void)
+{
+	const XHdcp22_Rx_KprivRx *KprivRx =
+		(const XHdcp22_Rx_KprivRx *)XHdcp22_Rx_Test_PrivateKey;
+	DIGIT_T P[XHDCP22_RX_P_SIZE/4];
+	DIGIT_T NPrimeP[XHDCP22_RX_P_SIZE/4];
+	DIGIT_T X[XHDCP22_RX_P_SIZE/4];
+	double Best = 0.0;
+	double Ns;
+	u64 Start;
+	u32 Rep;
+	u32 i;
+
+	mpConvFromOctets(P, 16, KprivRx->p, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(NPrimeP, 16, Rx.NPrimeP, XHDCP22_RX_P_SIZE);
+	mpConvFromOctets(X, 16, KprivRx->dp, XHDCP22_RX_P_SIZE);
+
+	for (Rep = 0; Rep < RUNS; Rep++) {
+		Start = HostNs();
+		for (i = 0; i < SW_MULT_RUNS; i++) {
+			XHdcp22Rx_Pkcs1MontMultFiosStub(X, X, X, P, NPrimeP, 16);
+		}
+		Ns = (double)(HostNs() - Start) / SW_MULT_RUNS;
+		if ((Rep == 0) || (Ns < Best)) {
+			Best = Ns;
+		}
+	}
+	return Best;
+}
+
+static u32 CtxCleared(void)
+{
+	const u8 *Bytes = (const u8 *)XHdcp22Rx_RsadpCtx;
+	u32 i;
+
+	for (i = 0; i < sizeof(XHdcp22Rx_RsadpCtx); i++) {
+		if (Bytes[i] != 0) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+int main(void)
+{
+	static const double Ratios[] = { 0.25, 0.5, 1.0 };
+	const XHdcp22_Rx_KprivRx *KprivRx =
+		(const XHdcp22_Rx_KprivRx *)XHdcp22_Rx_Test_PrivateKey;
+	u8 Cipher[XHDCP22_RX_N_SIZE];
+	u8 Em[XHDCP22_RX_N_SIZE];
+	u8 RefEm[XHDCP22_RX_N_SIZE];
+	u8 Km[XHDCP22_RX_N_SIZE];
+	int KmLen = 0;
+	u32 Starts;
+	u64 Ref;
+	u64 Drv;
+	double SwNs;
+	u32 Run;
+	u32 i;
+
+#ifdef _XHDCP22_RX_CRT_PARALLEL_
+	printf("RSADP with _XHDCP22_RX_CRT_PARALLEL_\n");
+#else
+	printf("RSADP\n");
+#endif
+
+	/* The driver keeps the core base address in a u32 */
+	MmultRegs = mmap(NULL, 4096, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (MmultRegs == MAP_FAILED) {
+		printf("mmap failed\n");
+		return 1;
+	}
+	MmultRegs[XHDCP22_MMULT_CTRL_ADDR_AP_CTRL/4] = MMULT_AP_IDLE;
+
+	Rx.MmultInst.Config.BaseAddress = (u32)(UINTPTR)MmultRegs;
+	Rx.MmultInst.IsReady = XIL_COMPONENT_IS_READY;
+	Check(XHdcp22Rx_CalcMontNPrime(Rx.NPrimeP, KprivRx->p, 16) == XST_SUCCESS,
+		"NPrimeP");
+	Check(XHdcp22Rx_CalcMontNPrime(Rx.NPrimeQ, KprivRx->q, 16) == XST_SUCCESS,
+		"NPrimeQ");
+
+	/* Test vector */
+	Check(XHdcp22Rx_RsaesOaepDecrypt(&Rx, KprivRx, (u8 *)XHdcp22_Rx_Test_Ekm,
+		Km, &KmLen) == XST_SUCCESS, "Ekm decryption status");
+	Check((KmLen == sizeof(XHdcp22_Rx_Test_Km)) &&
+		(memcmp(Km, XHdcp22_Rx_Test_Km, sizeof(XHdcp22_Rx_Test_Km)) == 0),
+		"Ekm decrypts to Km");
+	Check(CtxCleared(), "contexts cleared after decryption");
+
+	/* Multiplications on the core: 14 for the table, 127 windows of four
+	   squarings and a multiplication, and the final conversion */
+	MmultStarts = 0;
+	XHdcp22Rx_Pkcs1Rsadp(&Rx, KprivRx, (u8 *)XHdcp22_Rx_Test_Ekm, Em);
+	Starts = MmultStarts;
+#ifdef _XHDCP22_RX_CRT_PARALLEL_
+	Check(Starts == 650, "MMULT multiplications, one CRT half");
+#else
+	Check(Starts == 2*650, "MMULT multiplications, both CRT halves");
+#endif
+	MmultStarts = 0;
+	RefRsadp(&Rx, KprivRx, XHdcp22_Rx_Test_Ekm, RefEm);
+	printf("MMULT multiplications: reference %u, driver %u\n",
+		MmultStarts, Starts);
+	Check(memcmp(Em, RefEm, sizeof(Em)) == 0, "Ekm matches the reference");
+
+	/* Random ciphertexts below the modulus */
+	srand(1);
+	for (Run = 0; Run < RANDOM_RUNS; Run++) {
+		for (i = 0; i < sizeof(Cipher); i++) {
+			Cipher[i] = (u8)rand();
+		}
+		Cipher[0] &= 0x7F;
+		XHdcp22Rx_Pkcs1Rsadp(&Rx, KprivRx, Cipher, Em);
+		RefRsadp(&Rx, KprivRx, Cipher, RefEm);
+		Check(memcmp(Em, RefEm, sizeof(Em)) == 0,
+			"random ciphertext matches the reference");
+	}
+	Check(CtxCleared(), "contexts cleared after random decryptions");
+
+	/* Benchmark */
+	SwNs = SwMultNs();
+	printf("\nsoftware multiplication %.2f us\n", SwNs / 1000.0);
+	printf("MMULT latency   reference   driver      speed up\n");
+	for (i = 0; i < sizeof(Ratios)/sizeof(Ratios[0]); i++) {
+		MmultNs = (u64)(SwNs * Ratios[i]);
+		Ref = Bench(TRUE);
+		Drv = Bench(FALSE);
+		printf("%6.2f us       %7.0f us  %7.0f us  %.2fx\n",
+			MmultNs / 1000.0, Ref / 1000.0, Drv / 1000.0,
+			(double)Ref / (double)Drv);
+	}
+
+	printf("\n%s\n", (Failed == 0U) ? "all checks passed" : "CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}
@@ -143,6 +143,15 @@
 * bit is set. Due to this errata, repeated start cannot be used if a receive
 * transfer is followed by any other transfer.
 *
+* <b>Transaction Queue</b>
+*
+* XIicPs_XferSubmit() queues a transaction made of write and read segments to
+* one slave. The segments are started one after the other from the interrupt
+* handler, joined with repeated starts, and the next queued transaction is
+* started as soon as one finishes, so a sequence of register accesses needs no
+* processor involvement between segments. Because of the errata above a read
+* segment on Zynq is ended with a stop when more segments follow.
+*
 * <pre> MODIFICATION HISTORY:
 *
 * Ver   Who     Date     Changes
@@ -250,6 +259,15 @@ extern "C" {
 /* Maximum transfer size */
 #define XIICPS_MAX_TRANSFER_SIZE	(u32)(255U - 3U)
 
+/** @name Transaction queue message flags
+ *
+ * These flags describe one segment of a queued transaction.
+ * @{
+ */
+#define XIICPS_MSG_WRITE	0x0000U  /**< Segment writes to the slave */
+#define XIICPS_MSG_READ		0x0001U  /**< Segment reads from the slave */
+/*@}*/
+
 /**************************** Type Definitions *******************************/
 
 /**
@@ -298,6 +316,71 @@ typedef struct {
 	void *CallBackRef;	/* Callback reference for event handler */
 } XIicPs;
 
+/**
+ * One segment of a queued transaction. Consecutive segments of a transaction
+ * are joined with repeated starts.
+ */
+typedef struct {
+	u8 *BufferPtr;		/**< Data to write or buffer to read into */
+	u16 ByteCount;		/**< Number of bytes in the segment */
+	u16 Flags;		/**< XIICPS_MSG_WRITE or XIICPS_MSG_READ */
+} XIicPs_Msg;
+
+typedef struct XIicPs_XferStruct XIicPs_Xfer;
+
+/**
+ * Completion callback of a queued transaction, called in interrupt context.
+ *
+ * @param	CallBackRef is the reference given in the transaction.
+ * @param	XferPtr is the transaction that finished.
+ */
+typedef void (*XIicPs_XferHandler) (void *CallBackRef, XIicPs_Xfer *XferPtr);
+
+/**
+ * A queued transaction: a list of segments to one slave. The structure
+ * belongs to the driver from XIicPs_XferSubmit() until its handler is called.
+ */
+struct XIicPs_XferStruct {
+	XIicPs_Msg *MsgPtr;		/**< Segments of the transaction */
+	u32 NumMsgs;			/**< Number of segments */
+	u16 SlaveAddr;			/**< Slave address */
+	XIicPs_XferHandler Handler;	/**< Completion callback, may be NULL */
+	void *CallBackRef;		/**< Completion callback reference */
+	s32 Status;			/**< XST_SUCCESS or XST_FAILURE */
+	u32 StatusEvent;		/**< XIICPS_EVENT_* that ended a failed
+					  *  transaction */
+	u32 MsgDone;			/**< Number of segments completed */
+	XIicPs_Xfer *NextPtr;		/**< Driver use, next in queue */
+};
+
+/**
+ * Statistics of a transaction queue.
+ */
+typedef struct {
+	u32 Transactions;	/**< Transactions completed successfully */
+	u32 Failures;		/**< Transactions ended by an error */
+	u32 Segments;		/**< Segments completed */
+	u32 BytesSent;		/**< Bytes written to slaves */
+	u32 BytesRecv;		/**< Bytes read from slaves */
+	u32 Nacks;		/**< NACKs received */
+	u32 ArbLost;		/**< Arbitration losses */
+	u32 Errors;		/**< FIFO and other errors */
+} XIicPs_XferStats;
+
+/**
+ * The transaction queue of one IIC bus. While the queue is in use it owns
+ * the status handler of the XIicPs instance.
+ */
+typedef struct {
+	XIicPs *IicPtr;		/**< Instance the queue runs on */
+	XIicPs_Xfer *HeadPtr;	/**< Transaction in progress */
+	XIicPs_Xfer *TailPtr;	/**< Last queued transaction */
+	u32 MsgIndex;		/**< Segment in progress */
+	s32 SavedRepeatedStart;	/**< User repeated start setting */
+	u32 Platform;		/**< Platform the queue runs on */
+	XIicPs_XferStats Stats;	/**< Bus statistics */
+} XIicPs_XferQueue;
+
 /***************** Macros (Inline Functions) Definitions *********************/
 /****************************************************************************/
 /*
@@ -347,6 +430,22 @@ typedef struct {
 	 (InstancePtr)->RecvByteCount --; 				\
 }
 
+/****************************************************************************/
+/**
+*
+* Check whether a transaction queue has no transaction in progress.
+*
+* @param	QueuePtr is a pointer to the transaction queue.
+*
+* @return	TRUE if the queue is idle, FALSE otherwise.
+*
+* @note		C-Style signature:
+*		u32 XIicPs_XferQueueIsIdle(XIicPs_XferQueue *QueuePtr)
+*
+*****************************************************************************/
+#define XIicPs_XferQueueIsIdle(QueuePtr)				\
+	(((QueuePtr)->HeadPtr == NULL) ? (u32)TRUE : (u32)FALSE)
+
 /************************** Function Prototypes ******************************/
 
 /*
@@ -397,6 +496,15 @@ s32 XIicPs_SlaveSendPolled(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount);
 s32 XIicPs_SlaveRecvPolled(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount);
 void XIicPs_SlaveInterruptHandler(XIicPs *InstancePtr);
 
+/*
+ * Functions for queued transactions, in xiicps_xfer.c
+ */
+void XIicPs_XferQueueInit(XIicPs_XferQueue *QueuePtr, XIicPs *InstancePtr);
+void XIicPs_XferSubmit(XIicPs_XferQueue *QueuePtr, XIicPs_Xfer *XferPtr);
+void XIicPs_XferGetStats(XIicPs_XferQueue *QueuePtr,
+		XIicPs_XferStats *StatsPtr);
+void XIicPs_XferResetStats(XIicPs_XferQueue *QueuePtr);
+
 /*
  * Functions for selftest, in xiicps_selftest.c
  */
@@ -0,0 +1,419 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xiicps_xfer.c
+* @addtogroup iicps_v3_0
+* @{
+*
+* Contains the transaction queue of the master mode. A transaction is a list
+* of write and read segments to one slave. Each segment is run with the
+* interrupt-driven XIicPs_MasterSend() and XIicPs_MasterRecv(), and the status
+* handler of the queue starts the following segment, with the bus held for a
+* repeated start, as soon as the previous one completes. When the last segment
+* of a transaction completes the bus is released, the completion callback of
+* the transaction is called and the next queued transaction is started.
+*
+* The queue owns the status handler of the instance, so the instance should
+* not be used for other transfers while the queue is in use.
+*
+* See xiicps.h for a detailed description of the device and driver.
+*
+* <pre> MODIFICATION HISTORY:
+*
+* Ver   Who     Date     Changes
+* ----- ------  -------- -----------------------------------------------
+* 3.1           10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xiicps.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Events that end a transaction with an error.
+ */
+#define XIICPS_XFER_ERROR_EVENTS	(XIICPS_EVENT_TIME_OUT | \
+					 XIICPS_EVENT_ERROR | \
+					 XIICPS_EVENT_ARB_LOST | \
+					 XIICPS_EVENT_NACK | \
+					 XIICPS_EVENT_RX_OVR | \
+					 XIICPS_EVENT_TX_OVR | \
+					 XIICPS_EVENT_RX_UNF)
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+static void XferStatusHandler(void *CallBackRef, u32 StatusEvent);
+static void XferStartMsg(XIicPs_XferQueue *QueuePtr);
+static void XferComplete(XIicPs_XferQueue *QueuePtr, s32 Status,
+		u32 StatusEvent);
+static void XferReleaseBus(XIicPs *InstancePtr);
+
+/************************* Variable Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* This function initializes a transaction queue for an IIC instance and
+* installs the status handler of the queue.
+*
+* @param	QueuePtr is a pointer to the transaction queue.
+* @param	InstancePtr is a pointer to the XIicPs instance.
+*
+* @return	None.
+*
+* @note		The interrupt handler of the instance must be connected to
+*		the interrupt system, and the instance must not be in use.
+*
+****************************************************************************/
+void XIicPs_XferQueueInit(XIicPs_XferQueue *QueuePtr, XIicPs *InstancePtr)
+{
+	/*
+	 * Assert validates the input arguments.
+	 */
+	Xil_AssertVoid(QueuePtr != NULL);
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == (u32)XIL_COMPONENT_IS_READY);
+
+	QueuePtr->IicPtr = InstancePtr;
+	QueuePtr->HeadPtr = NULL;
+	QueuePtr->TailPtr = NULL;
+	QueuePtr->MsgIndex = 0U;
+	QueuePtr->SavedRepeatedStart = InstancePtr->IsRepeatedStart;
+	QueuePtr->Platform = XGetPlatform_Info();
+
+	XIicPs_XferResetStats(QueuePtr);
+
+	XIicPs_SetStatusHandler(InstancePtr, (void *)QueuePtr,
+			XferStatusHandler);
+}
+
+/*****************************************************************************/
+/**
+* This function queues a transaction. If the queue is idle the transaction is
+* started at once, otherwise it is started from the interrupt handler when the
+* transactions before it have finished.
+*
+* @param	QueuePtr is a pointer to the transaction queue.
+* @param	XferPtr is a pointer to the transaction. The transaction and its
+*		segments must stay valid until its handler is called.
+*
+* @return	None.
+*
+* @note		This function may be called from the completion callback of
+*		a transaction.
+*
+****************************************************************************/
+void XIicPs_XferSubmit(XIicPs_XferQueue *QueuePtr, XIicPs_Xfer *XferPtr)
+{
+	u32 BaseAddr;
+	u32 IntrMaskReg;
+	u32 IsIdle;
+
+	/*
+	 * Assert validates the input arguments.
+	 */
+	Xil_AssertVoid(QueuePtr != NULL);
+	Xil_AssertVoid(QueuePtr->IicPtr != NULL);
+	Xil_AssertVoid(XferPtr != NULL);
+	Xil_AssertVoid(XferPtr->MsgPtr != NULL);
+	Xil_AssertVoid(XferPtr->NumMsgs != 0U);
+	Xil_AssertVoid(XIICPS_ADDR_MASK >= XferPtr->SlaveAddr);
+
+	BaseAddr = QueuePtr->IicPtr->Config.BaseAddress;
+
+	XferPtr->Status = (s32)XST_SUCCESS;
+	XferPtr->StatusEvent = 0U;
+	XferPtr->MsgDone = 0U;
+	XferPtr->NextPtr = NULL;
+
+	/*
+	 * Enter a critical section, so disable the interrupts while the
+	 * queue is updated.
+	 */
+	IntrMaskReg = XIicPs_ReadReg(BaseAddr, XIICPS_IMR_OFFSET);
+	XIicPs_WriteReg(BaseAddr, XIICPS_IDR_OFFSET, XIICPS_IXR_ALL_INTR_MASK);
+
+	if (QueuePtr->HeadPtr == NULL) {
+		QueuePtr->HeadPtr = XferPtr;
+		IsIdle = (u32)TRUE;
+	} else {
+		QueuePtr->TailPtr->NextPtr = XferPtr;
+		IsIdle = (u32)FALSE;
+	}
+	QueuePtr->TailPtr = XferPtr;
+
+	/*
+	 * Restore the interrupt state.
+	 */
+	IntrMaskReg = XIICPS_IXR_ALL_INTR_MASK & (~IntrMaskReg);
+	XIicPs_WriteReg(BaseAddr, XIICPS_IER_OFFSET, IntrMaskReg);
+
+	/*
+	 * The interrupt handler only touches the queue while a transaction
+	 * is in progress, so the new head can be started outside the
+	 * critical section.
+	 */
+	if (IsIdle != (u32)FALSE) {
+		QueuePtr->SavedRepeatedStart = QueuePtr->IicPtr->IsRepeatedStart;
+		QueuePtr->MsgIndex = 0U;
+		XferStartMsg(QueuePtr);
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function returns the statistics of a transaction queue.
+*
+* @param	QueuePtr is a pointer to the transaction queue.
+* @param	StatsPtr is a pointer to the structure the statistics are
+*		copied to.
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+void XIicPs_XferGetStats(XIicPs_XferQueue *QueuePtr,
+		XIicPs_XferStats *StatsPtr)
+{
+	Xil_AssertVoid(QueuePtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+
+	*StatsPtr = QueuePtr->Stats;
+}
+
+/*****************************************************************************/
+/**
+* This function clears the statistics of a transaction queue.
+*
+* @param	QueuePtr is a pointer to the transaction queue.
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+void XIicPs_XferResetStats(XIicPs_XferQueue *QueuePtr)
+{
+	Xil_AssertVoid(QueuePtr != NULL);
+
+	QueuePtr->Stats.Transactions = 0U;
+	QueuePtr->Stats.Failures = 0U;
+	QueuePtr->Stats.Segments = 0U;
+	QueuePtr->Stats.BytesSent = 0U;
+	QueuePtr->Stats.BytesRecv = 0U;
+	QueuePtr->Stats.Nacks = 0U;
+	QueuePtr->Stats.ArbLost = 0U;
+	QueuePtr->Stats.Errors = 0U;
+}
+
+/*****************************************************************************/
+/*
+* The status handler of the queue, called from XIicPs_MasterInterruptHandler()
+* when a segment completes or fails.
+*
+* @param	CallBackRef is a pointer to the transaction queue.
+* @param	StatusEvent is the events reported by the driver.
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void XferStatusHandler(void *CallBackRef, u32 StatusEvent)
+{
+	XIicPs_XferQueue *QueuePtr = (XIicPs_XferQueue *)CallBackRef;
+	XIicPs_Xfer *XferPtr = QueuePtr->HeadPtr;
+	XIicPs_Msg *MsgPtr;
+
+	if (XferPtr == NULL) {
+		return;
+	}
+
+	if ((StatusEvent & (u32)XIICPS_XFER_ERROR_EVENTS) != 0U) {
+		if ((StatusEvent & (u32)XIICPS_EVENT_NACK) != 0U) {
+			QueuePtr->Stats.Nacks++;
+		} else if ((StatusEvent & (u32)XIICPS_EVENT_ARB_LOST) != 0U) {
+			QueuePtr->Stats.ArbLost++;
+		} else {
+			QueuePtr->Stats.Errors++;
+		}
+		XferComplete(QueuePtr, (s32)XST_FAILURE, StatusEvent);
+		return;
+	}
+
+	if ((StatusEvent & ((u32)XIICPS_EVENT_COMPLETE_SEND |
+			(u32)XIICPS_EVENT_COMPLETE_RECV)) == 0U) {
+		return;
+	}
+
+	MsgPtr = &XferPtr->MsgPtr[QueuePtr->MsgIndex];
+	if ((MsgPtr->Flags & XIICPS_MSG_READ) != 0U) {
+		QueuePtr->Stats.BytesRecv += MsgPtr->ByteCount;
+	} else {
+		QueuePtr->Stats.BytesSent += MsgPtr->ByteCount;
+	}
+	QueuePtr->Stats.Segments++;
+	XferPtr->MsgDone++;
+	QueuePtr->MsgIndex++;
+
+	if (QueuePtr->MsgIndex < XferPtr->NumMsgs) {
+		XferStartMsg(QueuePtr);
+	} else {
+		XferComplete(QueuePtr, (s32)XST_SUCCESS, 0U);
+	}
+}
+
+/*****************************************************************************/
+/*
+* This function starts the current segment of the transaction at the head of
+* the queue. The bus is held at the end of the segment if more segments
+* follow, except after a read on Zynq where the hold bit would hide the
+* completion of the receive.
+*
+* @param	QueuePtr is a pointer to the transaction queue.
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void XferStartMsg(XIicPs_XferQueue *QueuePtr)
+{
+	XIicPs *InstancePtr = QueuePtr->IicPtr;
+	XIicPs_Xfer *XferPtr = QueuePtr->HeadPtr;
+	XIicPs_Msg *MsgPtr = &XferPtr->MsgPtr[QueuePtr->MsgIndex];
+	s32 IsHold;
+
+	IsHold = ((QueuePtr->MsgIndex + 1U) < XferPtr->NumMsgs) ? 1 : 0;
+
+	if ((MsgPtr->Flags & XIICPS_MSG_READ) != 0U) {
+		if (QueuePtr->Platform == (u32)XPLAT_ZYNQ) {
+			IsHold = 0;
+		}
+		InstancePtr->IsRepeatedStart = IsHold;
+		XIicPs_MasterRecv(InstancePtr, MsgPtr->BufferPtr,
+				(s32)MsgPtr->ByteCount, XferPtr->SlaveAddr);
+	} else {
+		InstancePtr->IsRepeatedStart = IsHold;
+		XIicPs_MasterSend(InstancePtr, MsgPtr->BufferPtr,
+				(s32)MsgPtr->ByteCount, XferPtr->SlaveAddr);
+	}
+}
+
+/*****************************************************************************/
+/*
+* This function ends the transaction at the head of the queue, starts the
+* next one if there is one and calls the completion callback.
+*
+* @param	QueuePtr is a pointer to the transaction queue.
+* @param	Status is XST_SUCCESS or XST_FAILURE.
+* @param	StatusEvent is the events that ended a failed transaction.
+*
+* @return	None.
+*
+* @note		The next transaction is started before the callback so that
+*		a transaction submitted from the callback is queued behind it.
+*		Starting it waits for the bus to be free, which after a lost
+*		arbitration lasts until the other master sends its stop.
+*
+****************************************************************************/
+static void XferComplete(XIicPs_XferQueue *QueuePtr, s32 Status,
+		u32 StatusEvent)
+{
+	XIicPs_Xfer *XferPtr = QueuePtr->HeadPtr;
+
+	XferReleaseBus(QueuePtr->IicPtr);
+
+	XferPtr->Status = Status;
+	XferPtr->StatusEvent = StatusEvent;
+	if (Status == (s32)XST_SUCCESS) {
+		QueuePtr->Stats.Transactions++;
+	} else {
+		QueuePtr->Stats.Failures++;
+	}
+
+	QueuePtr->HeadPtr = XferPtr->NextPtr;
+	QueuePtr->MsgIndex = 0U;
+	if (QueuePtr->HeadPtr != NULL) {
+		/*
+		 * XIicPs_SetupMaster() does not set up the controller while
+		 * the bus is busy, so wait for the stop sent above, or for the
+		 * master that won the arbitration, to free the bus.
+		 */
+		while (XIicPs_BusIsBusy(QueuePtr->IicPtr) == (s32)TRUE) {
+		}
+		XferStartMsg(QueuePtr);
+	} else {
+		QueuePtr->TailPtr = NULL;
+		QueuePtr->IicPtr->IsRepeatedStart = QueuePtr->SavedRepeatedStart;
+	}
+
+	if (XferPtr->Handler != NULL) {
+		XferPtr->Handler(XferPtr->CallBackRef, XferPtr);
+	}
+}
+
+/*****************************************************************************/
+/*
+* This function clears the hold bit so the controller sends a stop. It does
+* nothing if the bus is not held.
+*
+* @param	InstancePtr is a pointer to the XIicPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+****************************************************************************/
+static void XferReleaseBus(XIicPs *InstancePtr)
+{
+	u32 BaseAddr = InstancePtr->Config.BaseAddress;
+	u32 ControlReg;
+
+	ControlReg = XIicPs_ReadReg(BaseAddr, (u32)XIICPS_CR_OFFSET);
+	if ((ControlReg & (u32)XIICPS_CR_HOLD_MASK) != 0U) {
+		XIicPs_WriteReg(BaseAddr, (u32)XIICPS_CR_OFFSET,
+				ControlReg & (u32)(~XIICPS_CR_HOLD_MASK));
+	}
+}
+/** @} */
@@ -0,0 +1,764 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xiicps_xfer_sim.c
+*
+* Host test of the transaction queue of the IIC PS driver against a register
+* model of the controller and of the slaves on its bus.
+*
+* The model keeps the 16 byte FIFO, the hold bit, the transfer size register,
+* the interrupt registers and the bus active status bit. It moves one byte
+* per step. A transfer is started by a write to the address register, with a
+* repeated start if the bus is held. When the TX FIFO runs empty, or the last
+* byte of a read has arrived, the complete interrupt is raised and the bus is
+* held if the hold bit is set, otherwise the stop is sent. A stop sent by
+* clearing the hold bit of a held bus takes a few status reads to complete,
+* and after a lost arbitration the other master keeps the bus for a while.
+*
+* The slave at 0x50 is a 256 byte memory: the first byte written sets the
+* address of the following accesses. The slave at 0x51 is the same memory but
+* NACKs the third data byte of a write, and no slave answers at 0x30.
+*
+* The checks are that:
+*  - transactions of write and read segments of every length up to 40 bytes
+*    complete, with one repeated start between consecutive segments, the
+*    FIFO refilled and drained across its depth, and the data read back,
+*  - queued transactions, and one submitted from a completion callback, run
+*    in order with one start each, and the bus is released at the end,
+*  - a NACK on the address of a held segment, a NACK on the data and a lost
+*    arbitration end their transaction with XST_FAILURE and the event that
+*    caused it, and the transactions queued behind still complete,
+*  - no transfer is started while the bus is busy,
+*  - the statistics count the transactions, segments, bytes and errors.
+*
+* Usage: xiicps_xfer_sim
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 3.1        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "xiicps.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE	0xFF020000U	/* IIC registers */
+#define SIM_REGS	0x30U		/* Size of the register space */
+#define SIM_FIFO	XIICPS_FIFO_DEPTH
+#define SIM_MEM_ADDR	0x50U		/* Memory slave */
+#define SIM_WP_ADDR	0x51U		/* Memory slave that NACKs writes */
+#define SIM_WP_NACK	3U		/* Data byte it NACKs */
+#define SIM_NONE_ADDR	0x30U		/* No slave */
+#define SIM_STOP_POLLS	4U		/* Status reads a stop takes */
+#define SIM_OTHER_POLLS	20U		/* Status reads the winner holds */
+#define SIM_MAX_STEPS	100000U
+#define SIM_MAX_LEN	40U
+
+/**************************** Type Definitions *******************************/
+
+typedef enum {
+	SIM_IDLE,
+	SIM_ADDR,	/* Start and address byte */
+	SIM_WRITE,
+	SIM_READ,
+	SIM_HELD,	/* Transfer done, clock held low */
+	SIM_STOPPING,	/* Stop sent after the hold bit was cleared */
+	SIM_OTHER	/* Bus taken by the master that won the arbitration */
+} SimState;
+
+typedef struct {
+	u32 Order;	/* Position the callback was called at */
+	u32 Calls;
+} SimDone;
+
+/************************** Variable Definitions *****************************/
+
+static u32 SimReg[SIM_REGS / 4U];
+static u32 Cr;
+static u32 Isr;
+static u32 Imr = XIICPS_IXR_ALL_INTR_MASK;
+static u32 TransSize;
+static u8 TxFifo[SIM_FIFO];
+static u32 TxHead;
+static u32 TxCount;
+static u8 RxFifo[SIM_FIFO];
+static u32 RxHead;
+static u32 RxCount;
+
+static SimState State;
+static u32 StartPending;
+static u32 Polls;
+static u32 SlaveRead;		/* Direction of the transfer in progress */
+static u32 SlaveAddr;
+static u32 SlaveBytes;		/* Data bytes of the transfer so far */
+static u8 SlaveMem[256];
+static u8 SlavePtr;
+static u32 ArbLoseAt = ~0U;	/* Start that loses the arbitration,
+				   counted from 1 */
+
+static u32 Starts;
+static u32 RepeatedStarts;
+static u32 BusyStarts;
+static u32 WireSent;
+static u32 WireRecv;
+static u32 Errors;
+
+static XIicPs Iic;
+static XIicPs_Config IicConfig = { 0U, SIM_BASE, 111111111U };
+static XIicPs_XferQueue Queue;
+static u32 DoneCount;
+
+/*****************************************************************************/
+
+static void SimFail(const char *What, u32 Value)
+{
+	printf("FAIL: %s (%u)\n", What, Value);
+	Errors++;
+}
+
+u32 XGetPlatform_Info(void)
+{
+	return XPLAT_ZYNQ_ULTRA_MP;
+}
+
+static u32 SimBusActive(void)
+{
+	if ((State == SIM_STOPPING) || (State == SIM_OTHER)) {
+		/* The status reads of the driver are the model's clock here */
+		Polls--;
+		if (Polls == 0U) {
+			State = SIM_IDLE;
+		}
+	}
+
+	return (State != SIM_IDLE) || (StartPending != 0U);
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Value;
+
+	switch (Addr - SIM_BASE) {
+	case XIICPS_CR_OFFSET:
+		return Cr;
+	case XIICPS_SR_OFFSET:
+		Value = SimBusActive() ? XIICPS_SR_BA_MASK : 0U;
+		if (RxCount != 0U) {
+			Value |= XIICPS_SR_RXDV_MASK;
+		}
+		if (TxCount != 0U) {
+			Value |= XIICPS_SR_TXDV_MASK;
+		}
+		return Value;
+	case XIICPS_DATA_OFFSET:
+		if (RxCount == 0U) {
+			Isr |= XIICPS_IXR_RX_UNF_MASK;
+			return 0U;
+		}
+		Value = RxFifo[RxHead];
+		RxHead = (RxHead + 1U) % SIM_FIFO;
+		RxCount--;
+		return Value;
+	case XIICPS_ISR_OFFSET:
+		return Isr;
+	case XIICPS_TRANS_SIZE_OFFSET:
+		/* Bytes left to read, or bytes in the TX FIFO */
+		return ((Cr & XIICPS_CR_RD_WR_MASK) != 0U) ? TransSize :
+							      TxCount;
+	case XIICPS_IMR_OFFSET:
+		return Imr;
+	default:
+		return SimReg[(Addr - SIM_BASE) / 4U];
+	}
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	switch (Addr - SIM_BASE) {
+	case XIICPS_CR_OFFSET:
+		if ((Value & XIICPS_CR_CLR_FIFO_MASK) != 0U) {
+			TxCount = 0U;
+			RxCount = 0U;
+			TransSize = 0U;
+		}
+		Cr = Value & ~XIICPS_CR_CLR_FIFO_MASK;
+		if ((State == SIM_HELD) && (TxCount == 0U) &&
+		    ((Cr & XIICPS_CR_HOLD_MASK) == 0U)) {
+			/* Releasing a held bus sends the stop at once */
+			State = SIM_STOPPING;
+			Polls = SIM_STOP_POLLS;
+		}
+		break;
+	case XIICPS_ADDR_OFFSET:
+		SimReg[XIICPS_ADDR_OFFSET / 4U] = Value;
+		if ((Cr & XIICPS_CR_MS_MASK) == 0U) {
+			break;
+		}
+		if ((State == SIM_STOPPING) || (State == SIM_OTHER)) {
+			BusyStarts++;
+		}
+		StartPending = 1U;
+		break;
+	case XIICPS_DATA_OFFSET:
+		if (TxCount == SIM_FIFO) {
+			Isr |= XIICPS_IXR_TX_OVR_MASK;
+			break;
+		}
+		TxFifo[(TxHead + TxCount) % SIM_FIFO] = (u8)Value;
+		TxCount++;
+		break;
+	case XIICPS_ISR_OFFSET:
+		Isr &= ~Value;
+		break;
+	case XIICPS_TRANS_SIZE_OFFSET:
+		TransSize = Value;
+		break;
+	case XIICPS_IER_OFFSET:
+		Imr &= ~Value;
+		break;
+	case XIICPS_IDR_OFFSET:
+		Imr |= Value & XIICPS_IXR_ALL_INTR_MASK;
+		break;
+	default:
+		SimReg[(Addr - SIM_BASE) / 4U] = Value;
+		break;
+	}
+}
+
+/*
+ * Ends the transfer in progress: the bus stays held if the hold bit is set,
+ * otherwise the stop is sent before the interrupt is raised.
+ */
+static void SimEnd(u32 Event)
+{
+	Isr |= Event;
+	State = ((Cr & XIICPS_CR_HOLD_MASK) != 0U) ? SIM_HELD : SIM_IDLE;
+}
+
+static void SimAddress(void)
+{
+	SlaveAddr = SimReg[XIICPS_ADDR_OFFSET / 4U];
+	SlaveRead = Cr & XIICPS_CR_RD_WR_MASK;
+	SlaveBytes = 0U;
+
+	if ((Starts + RepeatedStarts) == ArbLoseAt) {
+		Isr |= XIICPS_IXR_ARB_LOST_MASK;
+		TxCount = 0U;
+		State = SIM_OTHER;
+		Polls = SIM_OTHER_POLLS;
+	} else if ((SlaveAddr != SIM_MEM_ADDR) && (SlaveAddr != SIM_WP_ADDR)) {
+		TxCount = 0U;
+		SimEnd(XIICPS_IXR_NACK_MASK);
+	} else {
+		State = (SlaveRead != 0U) ? SIM_READ : SIM_WRITE;
+	}
+}
+
+static void SimWriteByte(void)
+{
+	u8 Data;
+
+	if (TxCount == 0U) {
+		SimEnd(XIICPS_IXR_COMP_MASK);
+		return;
+	}
+	Data = TxFifo[TxHead];
+	TxHead = (TxHead + 1U) % SIM_FIFO;
+	TxCount--;
+	SlaveBytes++;
+
+	if ((SlaveAddr == SIM_WP_ADDR) && (SlaveBytes == SIM_WP_NACK)) {
+		TxCount = 0U;
+		SimEnd(XIICPS_IXR_NACK_MASK);
+		return;
+	}
+	WireSent++;
+	if (SlaveBytes == 1U) {
+		SlavePtr = Data;
+	} else {
+		SlaveMem[SlavePtr++] = Data;
+	}
+	if (TxCount == 0U) {
+		SimEnd(XIICPS_IXR_COMP_MASK);
+	}
+}
+
+static void SimReadByte(void)
+{
+	if (TransSize != 0U) {
+		if (RxCount == SIM_FIFO) {
+			if ((Cr & XIICPS_CR_HOLD_MASK) != 0U) {
+				return;
+			}
+			Isr |= XIICPS_IXR_RX_OVR_MASK;
+		} else {
+			RxFifo[(RxHead + RxCount) % SIM_FIFO] =
+				SlaveMem[SlavePtr];
+			RxCount++;
+			if (RxCount == XIICPS_DATA_INTR_DEPTH) {
+				Isr |= XIICPS_IXR_DATA_MASK;
+			}
+		}
+		SlavePtr++;
+		WireRecv++;
+		TransSize--;
+	}
+	if (TransSize == 0U) {
+		SimEnd(XIICPS_IXR_COMP_MASK);
+	}
+}
+
+/*
+ * Moves the bus on by one byte and runs the interrupt handler of the driver
+ * while an enabled interrupt is pending.
+ */
+static void SimStep(void)
+{
+	u32 Loops = 0U;
+
+	switch (State) {
+	case SIM_IDLE:
+	case SIM_HELD:
+		if (StartPending != 0U) {
+			StartPending = 0U;
+			if (State == SIM_HELD) {
+				RepeatedStarts++;
+			} else {
+				Starts++;
+			}
+			State = SIM_ADDR;
+		} else if ((State == SIM_HELD) && (SlaveRead == 0U) &&
+			   (TxCount != 0U)) {
+			State = SIM_WRITE;
+			SimWriteByte();
+		}
+		break;
+	case SIM_ADDR:
+		SimAddress();
+		break;
+	case SIM_WRITE:
+		SimWriteByte();
+		break;
+	case SIM_READ:
+		SimReadByte();
+		break;
+	default:
+		(void)SimBusActive();
+		break;
+	}
+
+	while ((Isr & ~Imr & XIICPS_IXR_ALL_INTR_MASK) != 0U) {
+		XIicPs_MasterInterruptHandler(&Iic);
+		if (++Loops == 8U) {
+			SimFail("interrupt stuck", Isr);
+			Isr = 0U;
+		}
+	}
+}
+
+/*
+ * Runs the bus until the queue is empty and the bus is free.
+ */
+static void SimRun(void)
+{
+	u32 Steps = 0U;
+
+	while ((XIicPs_XferQueueIsIdle(&Queue) == FALSE) ||
+	       (State != SIM_IDLE) || (StartPending != 0U)) {
+		SimStep();
+		if (++Steps == SIM_MAX_STEPS) {
+			SimFail("bus stalled in state", State);
+			State = SIM_IDLE;
+			StartPending = 0U;
+			XIicPs_Reset(&Iic);
+			XIicPs_XferQueueInit(&Queue, &Iic);
+			break;
+		}
+	}
+	if ((Cr & XIICPS_CR_HOLD_MASK) != 0U) {
+		SimFail("bus left held", Cr);
+	}
+}
+
+static void XferDone(void *CallBackRef, XIicPs_Xfer *XferPtr)
+{
+	SimDone *DonePtr = (SimDone *)CallBackRef;
+
+	(void)XferPtr;
+	DonePtr->Order = DoneCount++;
+	DonePtr->Calls++;
+}
+
+static void SimSetup(XIicPs_Xfer *XferPtr, XIicPs_Msg *MsgPtr, u32 NumMsgs,
+		     u16 Addr, SimDone *DonePtr)
+{
+	memset(XferPtr, 0, sizeof(*XferPtr));
+	memset(DonePtr, 0, sizeof(*DonePtr));
+	XferPtr->MsgPtr = MsgPtr;
+	XferPtr->NumMsgs = NumMsgs;
+	XferPtr->SlaveAddr = Addr;
+	XferPtr->Handler = XferDone;
+	XferPtr->CallBackRef = DonePtr;
+}
+
+static void SimMsg(XIicPs_Msg *MsgPtr, u8 *Buffer, u32 Len, u16 Flags)
+{
+	MsgPtr->BufferPtr = Buffer;
+	MsgPtr->ByteCount = (u16)Len;
+	MsgPtr->Flags = Flags;
+}
+
+static void CheckDone(const char *Name, XIicPs_Xfer *XferPtr,
+		      SimDone *DonePtr, u32 Order, s32 Status, u32 Event)
+{
+	if (DonePtr->Calls != 1U) {
+		printf("%s: ", Name);
+		SimFail("callbacks", DonePtr->Calls);
+	} else if (DonePtr->Order != Order) {
+		printf("%s: ", Name);
+		SimFail("completed out of order", DonePtr->Order);
+	}
+	if (XferPtr->Status != Status) {
+		printf("%s: ", Name);
+		SimFail("status", (u32)XferPtr->Status);
+	}
+	if ((XferPtr->StatusEvent & Event) != Event) {
+		printf("%s: ", Name);
+		SimFail("status event", XferPtr->StatusEvent);
+	}
+}
+
+/*
+ * For every length, one transaction writes a block to the memory slave and
+ * a second one sets the address and reads it back with a repeated start.
+ */
+static void TestLengths(void)
+{
+	static u8 Out[SIM_MAX_LEN + 1U];
+	static u8 In[SIM_MAX_LEN];
+	XIicPs_Msg WriteMsg;
+	XIicPs_Msg ReadMsgs[2];
+	XIicPs_Xfer Write;
+	XIicPs_Xfer Read;
+	SimDone WriteDone;
+	SimDone ReadDone;
+	XIicPs_XferStats Stats;
+	u32 Len;
+	u32 Index;
+	u32 Sent = 0U;
+	u32 Segments = 0U;
+
+	XIicPs_XferResetStats(&Queue);
+	Starts = 0U;
+	RepeatedStarts = 0U;
+	WireSent = 0U;
+	WireRecv = 0U;
+
+	for (Len = 1U; Len <= SIM_MAX_LEN; Len++) {
+		Out[0] = (u8)(Len * 7U);
+		for (Index = 1U; Index <= Len; Index++) {
+			Out[Index] = (u8)(Len * 31U + Index);
+		}
+		memset(In, 0, sizeof(In));
+
+		SimMsg(&WriteMsg, Out, Len + 1U, XIICPS_MSG_WRITE);
+		SimSetup(&Write, &WriteMsg, 1U, SIM_MEM_ADDR, &WriteDone);
+		SimMsg(&ReadMsgs[0], Out, 1U, XIICPS_MSG_WRITE);
+		SimMsg(&ReadMsgs[1], In, Len, XIICPS_MSG_READ);
+		SimSetup(&Read, ReadMsgs, 2U, SIM_MEM_ADDR, &ReadDone);
+
+		DoneCount = 0U;
+		XIicPs_XferSubmit(&Queue, &Write);
+		XIicPs_XferSubmit(&Queue, &Read);
+		SimRun();
+
+		CheckDone("write", &Write, &WriteDone, 0U, XST_SUCCESS, 0U);
+		CheckDone("read", &Read, &ReadDone, 1U, XST_SUCCESS, 0U);
+		if (memcmp(In, &Out[1], Len) != 0) {
+			SimFail("data read back differs at length", Len);
+		}
+		Sent += Len + 2U;
+		Segments += 3U;
+	}
+
+	if ((Starts != 2U * SIM_MAX_LEN) ||
+	    (RepeatedStarts != SIM_MAX_LEN)) {
+		SimFail("starts", Starts);
+		SimFail("repeated starts", RepeatedStarts);
+	}
+
+	XIicPs_XferGetStats(&Queue, &Stats);
+	if ((Stats.Transactions != 2U * SIM_MAX_LEN) ||
+	    (Stats.Failures != 0U) || (Stats.Segments != Segments)) {
+		SimFail("transactions", Stats.Transactions);
+		SimFail("segments", Stats.Segments);
+	}
+	if ((Stats.BytesSent != Sent) || (Stats.BytesSent != WireSent)) {
+		SimFail("bytes sent", Stats.BytesSent);
+	}
+	if ((Stats.BytesRecv != WireRecv) ||
+	    (Stats.BytesRecv != SIM_MAX_LEN * (SIM_MAX_LEN + 1U) / 2U)) {
+		SimFail("bytes received", Stats.BytesRecv);
+	}
+
+	printf("lengths 1 to %u: %u transactions, %u segments, %u bytes "
+	       "sent, %u received\n", SIM_MAX_LEN, Stats.Transactions,
+	       Stats.Segments, Stats.BytesSent, Stats.BytesRecv);
+}
+
+/*
+ * Queued transactions of up to three segments, one of them submitted from
+ * the callback of the first.
+ */
+static XIicPs_Xfer Late;
+
+static void SubmitLate(void *CallBackRef, XIicPs_Xfer *XferPtr)
+{
+	XferDone(CallBackRef, XferPtr);
+	XIicPs_XferSubmit(&Queue, &Late);
+}
+
+static void TestChaining(void)
+{
+	static u8 Fill[] = { 0x80U, 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U };
+	static u8 Ptr[] = { 0x82U };
+	static u8 Ptr2[] = { 0x86U };
+	u8 Got[4];
+	u8 Got2[2];
+	XIicPs_Msg FillMsg;
+	XIicPs_Msg ThreeMsgs[3];
+	XIicPs_Msg LateMsg;
+	XIicPs_Xfer First;
+	XIicPs_Xfer Three;
+	SimDone FirstDone;
+	SimDone ThreeDone;
+	SimDone LateDone;
+	XIicPs_XferStats Stats;
+
+	XIicPs_XferResetStats(&Queue);
+	Starts = 0U;
+	RepeatedStarts = 0U;
+
+	SimMsg(&FillMsg, Fill, sizeof(Fill), XIICPS_MSG_WRITE);
+	SimSetup(&First, &FillMsg, 1U, SIM_MEM_ADDR, &FirstDone);
+	First.Handler = SubmitLate;
+
+	/* Read 4 bytes at 0x82, then set the address to 0x86 */
+	SimMsg(&ThreeMsgs[0], Ptr, 1U, XIICPS_MSG_WRITE);
+	SimMsg(&ThreeMsgs[1], Got, sizeof(Got), XIICPS_MSG_READ);
+	SimMsg(&ThreeMsgs[2], Ptr2, 1U, XIICPS_MSG_WRITE);
+	SimSetup(&Three, ThreeMsgs, 3U, SIM_MEM_ADDR, &ThreeDone);
+
+	/* Queued behind the previous one, so it reads at 0x86 */
+	SimMsg(&LateMsg, Got2, sizeof(Got2), XIICPS_MSG_READ);
+	SimSetup(&Late, &LateMsg, 1U, SIM_MEM_ADDR, &LateDone);
+
+	DoneCount = 0U;
+	XIicPs_XferSubmit(&Queue, &First);
+	XIicPs_XferSubmit(&Queue, &Three);
+	SimRun();
+
+	CheckDone("first", &First, &FirstDone, 0U, XST_SUCCESS, 0U);
+	CheckDone("three segments", &Three, &ThreeDone, 1U, XST_SUCCESS, 0U);
+	CheckDone("from callback", &Late, &LateDone, 2U, XST_SUCCESS, 0U);
+	if ((memcmp(Got, &Fill[3], sizeof(Got)) != 0) ||
+	    (memcmp(Got2, &Fill[7], sizeof(Got2)) != 0)) {
+		SimFail("data read back differs", 0U);
+	}
+
+	if ((Starts != 3U) || (RepeatedStarts != 2U)) {
+		SimFail("starts", Starts);
+		SimFail("repeated starts", RepeatedStarts);
+	}
+	XIicPs_XferGetStats(&Queue, &Stats);
+	if ((Stats.Transactions != 3U) || (Stats.Segments != 5U) ||
+	    (Stats.BytesSent != sizeof(Fill) + 2U) ||
+	    (Stats.BytesRecv != sizeof(Got) + sizeof(Got2))) {
+		SimFail("transactions", Stats.Transactions);
+		SimFail("segments", Stats.Segments);
+	}
+
+	printf("chaining: %u transactions, %u starts, %u repeated starts\n",
+	       Stats.Transactions, Starts, RepeatedStarts);
+}
+
+/*
+ * A NACK on the address of a held segment, a NACK on the data and a lost
+ * arbitration, each followed by a transaction that must still complete.
+ */
+static void TestErrors(void)
+{
+	static u8 Ptr[] = { 0x00U };
+	static u8 Data[] = { 0x10U, 0xAAU, 0xBBU, 0xCCU, 0xDDU };
+	u8 Got[6];
+	XIicPs_Msg AbsentMsgs[2];
+	XIicPs_Msg WpMsg;
+	XIicPs_Msg ArbMsg;
+	XIicPs_Msg OkMsgs[2];
+	XIicPs_Msg AfterMsg;
+	XIicPs_Xfer Absent;
+	XIicPs_Xfer Wp;
+	XIicPs_Xfer Arb;
+	XIicPs_Xfer Ok;
+	XIicPs_Xfer After;
+	SimDone AbsentDone;
+	SimDone WpDone;
+	SimDone ArbDone;
+	SimDone OkDone;
+	SimDone AfterDone;
+	XIicPs_XferStats Stats;
+
+	XIicPs_XferResetStats(&Queue);
+	Starts = 0U;
+	RepeatedStarts = 0U;
+	memset(SlaveMem, 0x5A, sizeof(SlaveMem));
+
+	SimMsg(&AbsentMsgs[0], Ptr, 1U, XIICPS_MSG_WRITE);
+	SimMsg(&AbsentMsgs[1], Got, sizeof(Got), XIICPS_MSG_READ);
+	SimSetup(&Absent, AbsentMsgs, 2U, SIM_NONE_ADDR, &AbsentDone);
+
+	SimMsg(&WpMsg, Data, sizeof(Data), XIICPS_MSG_WRITE);
+	SimSetup(&Wp, &WpMsg, 1U, SIM_WP_ADDR, &WpDone);
+
+	SimMsg(&ArbMsg, Data, sizeof(Data), XIICPS_MSG_WRITE);
+	SimSetup(&Arb, &ArbMsg, 1U, SIM_MEM_ADDR, &ArbDone);
+
+	SimMsg(&OkMsgs[0], Data, 1U, XIICPS_MSG_WRITE);
+	SimMsg(&OkMsgs[1], Got, sizeof(Got), XIICPS_MSG_READ);
+	SimSetup(&Ok, OkMsgs, 2U, SIM_MEM_ADDR, &OkDone);
+
+	SimMsg(&AfterMsg, Data, sizeof(Data), XIICPS_MSG_WRITE);
+	SimSetup(&After, &AfterMsg, 1U, SIM_MEM_ADDR, &AfterDone);
+
+	/* Starts: absent, write protected, then the lost one */
+	ArbLoseAt = 3U;
+	DoneCount = 0U;
+	XIicPs_XferSubmit(&Queue, &Absent);
+	XIicPs_XferSubmit(&Queue, &Wp);
+	XIicPs_XferSubmit(&Queue, &Arb);
+	XIicPs_XferSubmit(&Queue, &Ok);
+	SimRun();
+	ArbLoseAt = ~0U;
+
+	CheckDone("address NACK", &Absent, &AbsentDone, 0U, XST_FAILURE,
+		  XIICPS_EVENT_NACK);
+	if (Absent.MsgDone != 0U) {
+		SimFail("segments done before the address NACK",
+			Absent.MsgDone);
+	}
+	CheckDone("data NACK", &Wp, &WpDone, 1U, XST_FAILURE,
+		  XIICPS_EVENT_NACK);
+	CheckDone("arbitration", &Arb, &ArbDone, 2U, XST_FAILURE,
+		  XIICPS_EVENT_ARB_LOST);
+	CheckDone("after errors", &Ok, &OkDone, 3U, XST_SUCCESS, 0U);
+	/* Only the data byte before the NACK reached the memory */
+	if ((Got[0] != Data[1]) || (Got[1] != 0x5AU) || (Got[5] != 0x5AU)) {
+		SimFail("data written by the failed transactions", Got[1]);
+	}
+
+	/* A lost arbitration with nothing queued behind, then a new one */
+	ArbLoseAt = Starts + RepeatedStarts + 1U;
+	SimSetup(&Arb, &ArbMsg, 1U, SIM_MEM_ADDR, &ArbDone);
+	DoneCount = 0U;
+	XIicPs_XferSubmit(&Queue, &Arb);
+	SimRun();
+	ArbLoseAt = ~0U;
+	XIicPs_XferSubmit(&Queue, &After);
+	SimRun();
+	CheckDone("arbitration, idle", &Arb, &ArbDone, 0U, XST_FAILURE,
+		  XIICPS_EVENT_ARB_LOST);
+	CheckDone("after arbitration", &After, &AfterDone, 1U, XST_SUCCESS,
+		  0U);
+	if (memcmp(&SlaveMem[0x10], &Data[1], sizeof(Data) - 1U) != 0) {
+		SimFail("data not written after errors", SlaveMem[0x10]);
+	}
+
+	XIicPs_XferGetStats(&Queue, &Stats);
+	if ((Stats.Transactions != 2U) || (Stats.Failures != 4U)) {
+		SimFail("transactions", Stats.Transactions);
+		SimFail("failures", Stats.Failures);
+	}
+	if ((Stats.Nacks != 2U) || (Stats.ArbLost != 2U) ||
+	    (Stats.Errors != 0U)) {
+		SimFail("NACKs", Stats.Nacks);
+		SimFail("arbitration losses", Stats.ArbLost);
+		SimFail("other errors", Stats.Errors);
+	}
+	if ((Stats.Segments != 3U) ||
+	    (Stats.BytesSent != 1U + sizeof(Data)) ||
+	    (Stats.BytesRecv != sizeof(Got))) {
+		SimFail("segments", Stats.Segments);
+		SimFail("bytes sent", Stats.BytesSent);
+	}
+
+	printf("errors: %u NACKs, %u arbitration losses, %u failures, "
+	       "%u transactions\n", Stats.Nacks, Stats.ArbLost,
+	       Stats.Failures, Stats.Transactions);
+
+	XIicPs_XferResetStats(&Queue);
+	XIicPs_XferGetStats(&Queue, &Stats);
+	if ((Stats.Transactions | Stats.Failures | Stats.Segments |
+	     Stats.BytesSent | Stats.BytesRecv | Stats.Nacks |
+	     Stats.ArbLost | Stats.Errors) != 0U) {
+		SimFail("statistics not reset", Stats.Failures);
+	}
+}
+
+int main(void)
+{
+	(void)XIicPs_CfgInitialize(&Iic, &IicConfig, SIM_BASE);
+	XIicPs_XferQueueInit(&Queue, &Iic);
+
+	TestLengths();
+	TestChaining();
+	TestErrors();
+
+	if (BusyStarts != 0U) {
+		SimFail("transfers started while the bus was busy", BusyStarts);
+	}
+
+	printf("\n%s\n", (Errors == 0U) ? "all checks passed" :
+					  "CHECKS FAILED");
+	return (Errors == 0U) ? 0 : 1;
+}
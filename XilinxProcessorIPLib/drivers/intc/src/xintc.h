@@ -277,8 +277,35 @@ extern "C" {
 					       interrupt pins */
 /*@}*/
 
+/**
+ * @name Interrupt statistics
+ * Define XINTC_INTR_STATS to 1 in the BSP compiler flags to have
+ * XIntc_DeviceInterruptHandler() record, for every interrupt source, how often
+ * its handler ran and the total and maximum time spent in it. Times are
+ * taken with XIntc_StatsCycles(). Its weak default uses XTime_GetTime() on
+ * ARM. MicroBlaze has no standard free running counter, so there the default
+ * returns 0 and only the counts are recorded, unless the application
+ * provides XIntc_StatsCycles(), for example by reading an AXI Timer counter
+ * register.
+ * @{
+ */
+#ifndef XINTC_INTR_STATS
+#define XINTC_INTR_STATS	0
+#endif
+/*@}*/
+
 /**************************** Type Definitions *******************************/
 
+/**
+ * Per interrupt source statistics returned by XIntc_GetIntrStats(). Only
+ * updated when the driver is built with XINTC_INTR_STATS.
+ */
+typedef struct {
+	u32 Count;		/**< Number of times the handler was called */
+	u64 TotalCycles;	/**< Total counter ticks spent in the handler */
+	u32 MaxCycles;		/**< Longest single handler run in ticks */
+} XIntc_IntrStats;
+
 /**
  * This typedef contains configuration information for the device.
  */
@@ -350,6 +377,12 @@ void XIntc_SetNormalIntrMode(XIntc *InstancePtr, u8 Id);
  */
 void XIntc_VoidInterruptHandler(void);
 void XIntc_InterruptHandler(XIntc * InstancePtr);
+int XIntc_GetIntrStats(XIntc * InstancePtr, u8 Id, XIntc_IntrStats *StatsPtr);
+void XIntc_ResetIntrStats(XIntc * InstancePtr);
+void XIntc_PrintIntrStats(XIntc * InstancePtr);
+#if XINTC_INTR_STATS
+u32 XIntc_StatsCycles(void);
+#endif
 
 /*
  * Options functions in xintc_options.c
@@ -85,6 +85,11 @@ extern u32 XIntc_BitPosMask[];
 
 extern XIntc_Config XIntc_ConfigTable[];
 
+#if XINTC_INTR_STATS
+extern XIntc_IntrStats
+	XIntc_IntrStatsTable[XPAR_XINTC_NUM_INSTANCES][XIN_CONTROLLER_MAX_INTRS];
+#endif
+
 #ifdef __cplusplus
 }
 #endif
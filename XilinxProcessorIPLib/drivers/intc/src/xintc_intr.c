@@ -99,6 +99,10 @@
 #include "xil_assert.h"
 #include "xparameters.h"
 #include "xintc.h"
+#include "xintc_i.h"
+#if XINTC_INTR_STATS
+#include "xil_printf.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -173,4 +177,129 @@ void XIntc_InterruptHandler(XIntc * InstancePtr)
 	XIntc_DeviceInterruptHandler((void *)
 				     ((u32) (InstancePtr->CfgPtr->DeviceId)));
 }
+
+/*****************************************************************************/
+/**
+*
+* Take a snapshot of the statistics recorded for an interrupt source by
+* XIntc_DeviceInterruptHandler(). In Cascade mode the interrupt ID selects
+* the slave controller the same way as XIntc_Connect().
+*
+* @param	InstancePtr is a pointer to the XIntc instance to be worked on.
+* @param	Id is the interrupt ID.
+* @param	StatsPtr is where the statistics are copied to.
+*
+* @return
+*		- XST_SUCCESS if the statistics were copied.
+*		- XST_NO_FEATURE if the driver was built without
+*		  XINTC_INTR_STATS.
+*
+* @note		Interrupts are not masked while copying, so a dispatch that
+*		completes meanwhile may be partially included.
+*
+******************************************************************************/
+int XIntc_GetIntrStats(XIntc * InstancePtr, u8 Id, XIntc_IntrStats *StatsPtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid(Id < XPAR_INTC_MAX_NUM_INTR_INPUTS);
+	Xil_AssertNonvoid(StatsPtr != NULL);
+
+#if XINTC_INTR_STATS
+	if (Id > 31) {
+		*StatsPtr = XIntc_IntrStatsTable[Id/32][Id%32];
+	}
+	else {
+		*StatsPtr = XIntc_IntrStatsTable
+				[InstancePtr->CfgPtr->DeviceId][Id];
+	}
+
+	return XST_SUCCESS;
+#else
+	StatsPtr->Count = 0;
+	StatsPtr->TotalCycles = 0;
+	StatsPtr->MaxCycles = 0;
+
+	return XST_NO_FEATURE;
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Clear the interrupt statistics of the controller and, in Cascade mode, of
+* all its slave controllers.
+*
+* @param	InstancePtr is a pointer to the XIntc instance to be worked on.
+*
+* @return	None.
+*
+* @note		Does nothing if the driver was built without XINTC_INTR_STATS.
+*
+******************************************************************************/
+void XIntc_ResetIntrStats(XIntc * InstancePtr)
+{
+#if XINTC_INTR_STATS
+	int Index;
+	int Last;
+	int Intr;
+#endif
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+#if XINTC_INTR_STATS
+	Index = InstancePtr->CfgPtr->DeviceId;
+	Last = Index;
+	if (InstancePtr->CfgPtr->IntcType != XIN_INTC_NOCASCADE) {
+		Last = XPAR_XINTC_NUM_INSTANCES - 1;
+	}
+
+	for (; Index <= Last; Index++) {
+		for (Intr = 0; Intr < XIN_CONTROLLER_MAX_INTRS; Intr++) {
+			XIntc_IntrStatsTable[Index][Intr].Count = 0;
+			XIntc_IntrStatsTable[Index][Intr].TotalCycles = 0;
+			XIntc_IntrStatsTable[Index][Intr].MaxCycles = 0;
+		}
+	}
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* Print the statistics of every interrupt source that has been serviced at
+* least once since the last reset. Each line shows the interrupt ID, the
+* number of calls and the average and maximum handler time in
+* XIntc_StatsCycles() ticks.
+*
+* @param	InstancePtr is a pointer to the XIntc instance to be worked on.
+*
+* @return	None.
+*
+* @note		Does nothing if the driver was built without XINTC_INTR_STATS.
+*
+******************************************************************************/
+void XIntc_PrintIntrStats(XIntc * InstancePtr)
+{
+#if XINTC_INTR_STATS
+	int Id;
+	XIntc_IntrStats Stats;
+#endif
+
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+#if XINTC_INTR_STATS
+	xil_printf("ID    Count       Avg         Max\r\n");
+	for (Id = 0; Id < XPAR_INTC_MAX_NUM_INTR_INPUTS; Id++) {
+		(void)XIntc_GetIntrStats(InstancePtr, (u8)Id, &Stats);
+		if (Stats.Count != 0) {
+			xil_printf("%-5d %-11u %-11u %u\r\n", Id, Stats.Count,
+				   (u32)(Stats.TotalCycles / Stats.Count),
+				   Stats.MaxCycles);
+		}
+	}
+#endif
+}
 /** @} */
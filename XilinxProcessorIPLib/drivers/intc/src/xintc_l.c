@@ -85,6 +85,9 @@
 #include "xil_assert.h"
 #include "xintc.h"
 #include "xintc_i.h"
+#if XINTC_INTR_STATS && !defined(__MICROBLAZE__)
+#include "xtime_l.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -93,6 +96,17 @@
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
+/*
+ * Call the handler of an interrupt source, recording its statistics when the
+ * driver is built with XINTC_INTR_STATS.
+ */
+#if XINTC_INTR_STATS
+#define XIntc_CallHandler(DeviceId, IntrNumber, TablePtr) \
+	XIntc_StatsCallHandler((DeviceId), (IntrNumber), (TablePtr))
+#else
+#define XIntc_CallHandler(DeviceId, IntrNumber, TablePtr) \
+	(TablePtr)->Handler((TablePtr)->CallBackRef)
+#endif
 
 /************************** Function Prototypes ******************************/
 
@@ -102,8 +116,22 @@ static XIntc_Config *LookupConfigByBaseAddress(UINTPTR BaseAddress);
 static void XIntc_CascadeHandler(void *DeviceId);
 #endif
 
+#if XINTC_INTR_STATS
+static void XIntc_StatsCallHandler(u32 DeviceId, int IntrNumber,
+				   XIntc_VectorTableEntry *TablePtr);
+#endif
+
 /************************** Variable Definitions *****************************/
 
+#if XINTC_INTR_STATS
+/*
+ * Statistics of every interrupt source, indexed by device ID and interrupt
+ * number within that controller.
+ */
+XIntc_IntrStats
+	XIntc_IntrStatsTable[XPAR_XINTC_NUM_INSTANCES][XIN_CONTROLLER_MAX_INTRS];
+#endif
+
 /*****************************************************************************/
 /**
 *
@@ -256,7 +284,8 @@ void XIntc_DeviceInterruptHandler(void *DeviceId)
 				 * the specified parameter
 				 */
 				TablePtr = &(CfgPtr->HandlerTable[IntrNumber]);
-				TablePtr->Handler(TablePtr->CallBackRef);
+				XIntc_CallHandler((u32)DeviceId, IntrNumber,
+						  TablePtr);
 
 				/* If the interrupt has been setup to
 				 * acknowledge it after it has been serviced
@@ -628,7 +657,8 @@ static void XIntc_CascadeHandler(void *DeviceId)
 				 * the specified parameter
 				 */
 				TablePtr = &(CfgPtr->HandlerTable[IntrNumber]);
-				TablePtr->Handler(TablePtr->CallBackRef);
+				XIntc_CallHandler((u32)DeviceId, IntrNumber,
+						  TablePtr);
 			}
 			/* If the interrupt has been setup to acknowledge it
 			 * after it has been serviced then ack it
@@ -666,4 +696,68 @@ static void XIntc_CascadeHandler(void *DeviceId)
 	}
 }
 #endif
+
+#if XINTC_INTR_STATS
+/*****************************************************************************/
+/**
+*
+* Call the handler of an interrupt source and record how long it ran in the
+* statistics table.
+*
+* @param	DeviceId is the device ID of the interrupt controller.
+* @param	IntrNumber is the interrupt number within that controller.
+* @param	TablePtr is the vector table entry of the interrupt.
+*
+* @return	None.
+*
+* @note		With nested interrupts the time includes any handlers of
+*		higher priority interrupts that preempted this one.
+*
+******************************************************************************/
+static void XIntc_StatsCallHandler(u32 DeviceId, int IntrNumber,
+				   XIntc_VectorTableEntry *TablePtr)
+{
+	XIntc_IntrStats *StatsPtr;
+	u32 Start;
+	u32 Cycles;
+
+	Start = XIntc_StatsCycles();
+	TablePtr->Handler(TablePtr->CallBackRef);
+	Cycles = XIntc_StatsCycles() - Start;
+
+	StatsPtr = &XIntc_IntrStatsTable[DeviceId][IntrNumber];
+	StatsPtr->Count++;
+	StatsPtr->TotalCycles += Cycles;
+	if (Cycles > StatsPtr->MaxCycles) {
+		StatsPtr->MaxCycles = Cycles;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* Return a free running timestamp used for the interrupt statistics.
+*
+* @return	The low 32 bits of XTime_GetTime(). On MicroBlaze, which has
+*		no standard free running counter, 0.
+*
+* @note		This is a weak default. An application can provide its own
+*		XIntc_StatsCycles(), for example one that reads an AXI Timer
+*		counter register, to get handler times on MicroBlaze. With the
+*		default there only the counts are recorded.
+*
+******************************************************************************/
+__attribute__((weak)) u32 XIntc_StatsCycles(void)
+{
+#ifndef __MICROBLAZE__
+	XTime Now;
+
+	XTime_GetTime(&Now);
+
+	return (u32)Now;
+#else
+	return 0U;
+#endif
+}
+#endif
 /** @} */
@@ -57,6 +57,7 @@
  * 5.1   sk   11/10/15 Used UINTPTR instead of u32 for Baseaddress CR# 867425.
  *                     Changed the prototypes of XLlFifo_CfgInitialize,
  *                     XLlFifo_Initialize APIs.
+ * 5.2        10/18/26 Added the XLLF_AXI4_INCR_BURST data port loops.
  * </pre>
  ******************************************************************************/
 
@@ -70,6 +71,47 @@
 /************************** Constant Definitions *****************************/
 #define FIFO_WIDTH_BYTES 4
 
+/*
+ * Words moved per iteration of the unrolled data port loops in
+ * XLlFifo_iRead_Aligned() and XLlFifo_iWrite_Aligned()
+ */
+#define XLLF_XFER_UNROLL 4
+
+/*
+ * With the AXI4 data interface the core takes transmit data written anywhere
+ * in the 4 KB TDFD window at XLLF_AXI4_TDFD_OFFSET and returns receive data
+ * read anywhere in the RDFD window at XLLF_AXI4_RDFD_OFFSET (PG080, AXI4 data
+ * interface), so it accepts INCR as well as FIXED bursts. When
+ * XLLF_AXI4_INCR_BURST is defined the aligned data loops step through the
+ * window instead of accessing its first word, so that a processor that maps
+ * the window as normal non-cacheable memory can gather the accesses into
+ * INCR bursts. The stepping restarts at the start of the window every
+ * XLLF_AXI4_BURST_BYTES, so no burst crosses the window.
+ */
+#ifdef XLLF_AXI4_INCR_BURST
+#ifndef XLLF_AXI4_BURST_BYTES
+#define XLLF_AXI4_BURST_BYTES 1024
+#endif
+#if (XLLF_AXI4_BURST_BYTES < 16) || (XLLF_AXI4_BURST_BYTES > 4096) || \
+	(XLLF_AXI4_BURST_BYTES & (XLLF_AXI4_BURST_BYTES - 1))
+#error "XLLF_AXI4_BURST_BYTES must be a power of two from 16 to 4096"
+#endif
+#endif
+
+/**************************** Macros *****************************************/
+
+/*
+ * Address of the receive and transmit data ports, which depend on whether the
+ * core was built with the AXI4 (full) data interface.
+ */
+#define XLlFifo_iRxDataAddr(InstancePtr) \
+	((InstancePtr)->Axi4BaseAddress + ((InstancePtr)->Datainterface ? \
+		XLLF_AXI4_RDFD_OFFSET : XLLF_RDFD_OFFSET))
+
+#define XLlFifo_iTxDataAddr(InstancePtr) \
+	((InstancePtr)->Axi4BaseAddress + ((InstancePtr)->Datainterface ? \
+		XLLF_AXI4_TDFD_OFFSET : XLLF_TDFD_OFFSET))
+
 /*
  * Implementation Notes:
  *
@@ -105,6 +147,84 @@ xdbg_stmnt(u32 _xllfifo_rr_value;)
 xdbg_stmnt(u32 _xllfifo_ipie_value;)
 xdbg_stmnt(u32 _xllfifo_ipis_value;)
 
+#ifdef XLLF_AXI4_INCR_BURST
+/*****************************************************************************/
+/*
+*
+* XLlFifo_iRead_Incr reads <i>WordCount</i> words from the AXI4 receive data
+* window at <i>DataAddr</i>, stepping through the window so that the reads can
+* form INCR bursts.
+*
+* @param    DataAddr is the address of the AXI4 receive data window.
+*
+* @param    BufPtr specifies the 32 bit aligned memory to place the data read.
+*
+* @param    WordCount specifies the number of 32 bit words to read.
+*
+* @return   N/A
+*
+******************************************************************************/
+static void XLlFifo_iRead_Incr(UINTPTR DataAddr, u32 *BufPtr,
+			unsigned WordCount)
+{
+	unsigned Offset = 0;
+
+	while (WordCount >= XLLF_XFER_UNROLL) {
+		BufPtr[0] = Xil_In32(DataAddr + Offset);
+		BufPtr[1] = Xil_In32(DataAddr + Offset + 4);
+		BufPtr[2] = Xil_In32(DataAddr + Offset + 8);
+		BufPtr[3] = Xil_In32(DataAddr + Offset + 12);
+		BufPtr += XLLF_XFER_UNROLL;
+		WordCount -= XLLF_XFER_UNROLL;
+		Offset = (Offset + 16) & (XLLF_AXI4_BURST_BYTES - 1);
+	}
+	while (WordCount) {
+		*BufPtr = Xil_In32(DataAddr + Offset);
+		BufPtr++;
+		WordCount--;
+		Offset += 4;
+	}
+}
+
+/*****************************************************************************/
+/*
+*
+* XLlFifo_iWrite_Incr writes <i>WordCount</i> words to the AXI4 transmit data
+* window at <i>DataAddr</i>, stepping through the window so that the writes can
+* form INCR bursts.
+*
+* @param    DataAddr is the address of the AXI4 transmit data window.
+*
+* @param    BufPtr specifies the 32 bit aligned memory to take the data from.
+*
+* @param    WordCount specifies the number of 32 bit words to write.
+*
+* @return   N/A
+*
+******************************************************************************/
+static void XLlFifo_iWrite_Incr(UINTPTR DataAddr, u32 *BufPtr,
+			unsigned WordCount)
+{
+	unsigned Offset = 0;
+
+	while (WordCount >= XLLF_XFER_UNROLL) {
+		Xil_Out32(DataAddr + Offset, BufPtr[0]);
+		Xil_Out32(DataAddr + Offset + 4, BufPtr[1]);
+		Xil_Out32(DataAddr + Offset + 8, BufPtr[2]);
+		Xil_Out32(DataAddr + Offset + 12, BufPtr[3]);
+		BufPtr += XLLF_XFER_UNROLL;
+		WordCount -= XLLF_XFER_UNROLL;
+		Offset = (Offset + 16) & (XLLF_AXI4_BURST_BYTES - 1);
+	}
+	while (WordCount) {
+		Xil_Out32(DataAddr + Offset, *BufPtr);
+		BufPtr++;
+		WordCount--;
+		Offset += 4;
+	}
+}
+#endif
+
 /*****************************************************************************/
 /*
 *
@@ -187,20 +307,38 @@ u32 XLlFifo_iRxGetLen(XLlFifo *InstancePtr)
 {
 	unsigned WordsRemaining = WordCount;
 	u32 *BufPtrIdx = (u32 *)BufPtr;
+	UINTPTR DataAddr;
 
 	xdbg_printf(XDBG_DEBUG_FIFO_RX, "XLlFifo_iRead_Aligned: start\n");
 	Xil_AssertNonvoid(InstancePtr);
 	Xil_AssertNonvoid(BufPtr);
 	/* assert bufer is 32 bit aligned */
-	Xil_AssertNonvoid(((unsigned)BufPtr & 0x3) == 0x0);
+	Xil_AssertNonvoid(((UINTPTR)BufPtr & 0x3) == 0x0);
 	xdbg_printf(XDBG_DEBUG_FIFO_RX, "XLlFifo_iRead_Aligned: after asserts\n");
 
+	/*
+	 * Resolve the data port once rather than per word as
+	 * XLlFifo_RxGetWord() does, then drain it in groups of
+	 * XLLF_XFER_UNROLL words so the loop overhead is paid once per group.
+	 */
+	DataAddr = XLlFifo_iRxDataAddr(InstancePtr);
+
+#ifdef XLLF_AXI4_INCR_BURST
+	if (InstancePtr->Datainterface) {
+		XLlFifo_iRead_Incr(DataAddr, BufPtrIdx, WordsRemaining);
+		WordsRemaining = 0;
+	}
+#endif
+	while (WordsRemaining >= XLLF_XFER_UNROLL) {
+		BufPtrIdx[0] = Xil_In32(DataAddr);
+		BufPtrIdx[1] = Xil_In32(DataAddr);
+		BufPtrIdx[2] = Xil_In32(DataAddr);
+		BufPtrIdx[3] = Xil_In32(DataAddr);
+		BufPtrIdx += XLLF_XFER_UNROLL;
+		WordsRemaining -= XLLF_XFER_UNROLL;
+	}
 	while (WordsRemaining) {
-/*		xdbg_printf(XDBG_DEBUG_FIFO_RX,
-			    "XLlFifo_iRead_Aligned: WordsRemaining: %d\n",
-			    WordsRemaining);
-*/
-		*BufPtrIdx = XLlFifo_RxGetWord(InstancePtr);
+		*BufPtrIdx = Xil_In32(DataAddr);
 		BufPtrIdx++;
 		WordsRemaining--;
 	}
@@ -293,6 +431,7 @@ void XLlFifo_iTxSetLen(XLlFifo *InstancePtr, u32 Bytes)
 {
 	unsigned WordsRemaining = WordCount;
 	u32 *BufPtrIdx = (u32 *)BufPtr;
+	UINTPTR DataAddr;
 
 	xdbg_printf(XDBG_DEBUG_FIFO_TX,
 		    "XLlFifo_iWrite_Aligned: Inst: %p; Buff: %p; Count: %d\n",
@@ -300,13 +439,31 @@ void XLlFifo_iTxSetLen(XLlFifo *InstancePtr, u32 Bytes)
 	Xil_AssertNonvoid(InstancePtr);
 	Xil_AssertNonvoid(BufPtr);
 	/* assert bufer is 32 bit aligned */
-	Xil_AssertNonvoid(((unsigned)BufPtr & 0x3) == 0x0);
+	Xil_AssertNonvoid(((UINTPTR)BufPtr & 0x3) == 0x0);
 
 	xdbg_printf(XDBG_DEBUG_FIFO_TX,
 		    "XLlFifo_iWrite_Aligned: WordsRemaining: %d\n",
 		    WordsRemaining);
+
+	/* Same as XLlFifo_iRead_Aligned(), in the transmit direction */
+	DataAddr = XLlFifo_iTxDataAddr(InstancePtr);
+
+#ifdef XLLF_AXI4_INCR_BURST
+	if (InstancePtr->Datainterface) {
+		XLlFifo_iWrite_Incr(DataAddr, BufPtrIdx, WordsRemaining);
+		WordsRemaining = 0;
+	}
+#endif
+	while (WordsRemaining >= XLLF_XFER_UNROLL) {
+		Xil_Out32(DataAddr, BufPtrIdx[0]);
+		Xil_Out32(DataAddr, BufPtrIdx[1]);
+		Xil_Out32(DataAddr, BufPtrIdx[2]);
+		Xil_Out32(DataAddr, BufPtrIdx[3]);
+		BufPtrIdx += XLLF_XFER_UNROLL;
+		WordsRemaining -= XLLF_XFER_UNROLL;
+	}
 	while (WordsRemaining) {
-		XLlFifo_TxPutWord(InstancePtr, *BufPtrIdx);
+		Xil_Out32(DataAddr, *BufPtrIdx);
 		BufPtrIdx++;
 		WordsRemaining--;
 	}
@@ -123,6 +123,15 @@
  * twice in a row. Each frame must be written by writting the data for one
  * frame and then calling TxSetLen().
  *
+ * <h2>AXI4 Data Interface</h2>
+ * When the core is built with the AXI4 data interface the driver reads and
+ * writes the first word of the receive and transmit data windows, which the
+ * interconnect turns into single beat transfers. Building the driver with
+ * XLLF_AXI4_INCR_BURST defined makes it step through the windows instead, so
+ * that a processor that maps them as normal non-cacheable memory can gather
+ * the accesses into INCR bursts. XLLF_AXI4_BURST_BYTES (1024 by default)
+ * bounds the length of a step run.
+ *
  * <h2>Interrupts</h2>
  * This driver does not handle interrupts from the FIFO hardware. The
  * software layer above may make use of the interrupts by setting up its
@@ -172,6 +181,7 @@
  *                     XLlFifo_Initialize APIs.
  * 5.1  adk   01/02/15 CR#885653 Fix Incorrect AXI4 Base address being
  *                     Exported to the xparameters.h file.
+ * 5.2        10/18/26 Added the XLLF_AXI4_INCR_BURST build option.
  *
  *
  * </pre>
@@ -52,6 +52,7 @@
 
 /***************************** Include Files *********************************/
 
+#include <string.h>
 #include "xstreamer.h"
 #include "xil_assert.h"
 
@@ -158,6 +159,15 @@
 #define min(x, y) (((x) < (y)) ? (x) : (y))
 #endif
 
+/*
+ * Size, in 32 bit words, of the on-stack bounce buffer used to move data to or
+ * from a buffer that is not 32 bit aligned. Must be a multiple of
+ * LARGEST_FIFO_KEYHOLE_SIZE_WORDS.
+ */
+#ifndef XSTRM_BOUNCE_WORDS
+#define XSTRM_BOUNCE_WORDS 32
+#endif
+
 xdbg_stmnt(u32 _xstrm_ro_value;)
 xdbg_stmnt(u32 _xstrm_buffered;)
 
@@ -302,6 +312,7 @@ void XStrm_Read(XStrm_RxFifoStreamer *InstancePtr, void *BufPtr,
 	unsigned FifoWordsToXfer;
 	unsigned PartialBytes;
 	unsigned i;
+	u32 Bounce[XSTRM_BOUNCE_WORDS];
 
 	while (BytesRemaining) {
 		xdbg_printf(XDBG_DEBUG_FIFO_RX, "XStrm_Read: BytesRemaining: %d\n", BytesRemaining);
@@ -336,7 +347,7 @@ void XStrm_Read(XStrm_RxFifoStreamer *InstancePtr, void *BufPtr,
 		 *      of the fifo into the target buffer.
 		 *   2) Loop back around to transfer the last few bytes.
 		 */
-		else if ((((unsigned)DestPtr & 3) == 0) &&
+		else if ((((UINTPTR)DestPtr & 3) == 0) &&
 			 (BytesRemaining >= InstancePtr->FifoWidth)) {
 			xdbg_printf(XDBG_DEBUG_FIFO_RX, "XStrm_Read: Case 2: DestPtr: %p, BytesRemaining: %d, InstancePtr->FifoWidth: %d\n",
 				    DestPtr, BytesRemaining, InstancePtr->FifoWidth);
@@ -352,15 +363,38 @@ void XStrm_Read(XStrm_RxFifoStreamer *InstancePtr, void *BufPtr,
 				FifoWordsToXfer * InstancePtr->FifoWidth;
 		}
 		/* Case 3: There are no more bytes in the holding buffer and
+		 *         the target buffer is not 32 bit aligned and
+		 *         the number of bytes remaining to transfer is greater
+		 *         than or equal to the fifo width.
+		 *
+		 *   1) Read as many fifo words as fit into an aligned bounce
+		 *      buffer, and copy them out in one go.
+		 *   2) Loop back around to transfer the rest.
+		 */
+		else if (BytesRemaining >= InstancePtr->FifoWidth) {
+			FifoWordsToXfer =
+				min(BytesRemaining / InstancePtr->FifoWidth,
+				    sizeof(Bounce) / InstancePtr->FifoWidth);
+			PartialBytes = FifoWordsToXfer * InstancePtr->FifoWidth;
+			xdbg_printf(XDBG_DEBUG_FIFO_RX, "XStrm_Read: Case 3: DestPtr: %p, FifoWordsToXfer: %d\n",
+				    DestPtr, FifoWordsToXfer);
+
+			(*(InstancePtr->ReadFn)) (InstancePtr->FifoInstance,
+						Bounce, FifoWordsToXfer);
+			memcpy(DestPtr, Bounce, PartialBytes);
+			DestPtr += PartialBytes;
+			BytesRemaining -= PartialBytes;
+			InstancePtr->FrmByteCnt -= PartialBytes;
+		}
+		/* Case 4: There are no more bytes in the holding buffer and
 		 *         the number of bytes remaining to transfer is less than
-		 *         the fifo width or
-		 *         things just don't line up.
+		 *         the fifo width.
 		 *
 		 *   1) Fill the holding buffer.
 		 *   2) Loop back around and handle the rest of the transfer.
 		 */
 		else {
-			xdbg_printf(XDBG_DEBUG_FIFO_RX, "XStrm_Read: Case 3\n");
+			xdbg_printf(XDBG_DEBUG_FIFO_RX, "XStrm_Read: Case 4\n");
 			/*
 			 * At the tail end, read one fifo word into the local holding
 			 * buffer and loop back around to take care of the transfer.
@@ -437,6 +471,7 @@ void XStrm_Write(XStrm_TxFifoStreamer *InstancePtr, void *BufPtr,
 	unsigned FifoWordsToXfer;
 	unsigned PartialBytes;
 	unsigned i;
+	u32 Bounce[XSTRM_BOUNCE_WORDS];
 
 	while (BytesRemaining) {
 		xdbg_printf(XDBG_DEBUG_FIFO_TX,
@@ -468,7 +503,7 @@ void XStrm_Write(XStrm_TxFifoStreamer *InstancePtr, void *BufPtr,
 		 */
 		if ((InstancePtr->TailIndex == 0) &&
 		    (BytesRemaining >= InstancePtr->FifoWidth) &&
-		    (((unsigned)SrcPtr & 3) == 0)) {
+		    (((UINTPTR)SrcPtr & 3) == 0)) {
 			FifoWordsToXfer =
 				BytesRemaining / InstancePtr->FifoWidth;
 
@@ -487,9 +522,33 @@ void XStrm_Write(XStrm_TxFifoStreamer *InstancePtr, void *BufPtr,
 			xdbg_printf(XDBG_DEBUG_FIFO_TX, "XStrm_Write: (end case 2) TailIndex: %d; BytesRemaining: %d; SrcPtr: %p\n",
 				    InstancePtr->TailIndex, BytesRemaining, SrcPtr);
 		}
-		/* Case 3: The alignment of the "galaxies" didn't occur in
-		 *         Case 2 above, so we must pump the bytes through the
-		 *         holding buffer.
+		/* Case 3: There are no bytes in the holding buffer and
+		 *         the source buffer is not 32 bit aligned and
+		 *         the number of bytes remaining to transfer is greater
+		 *         than or equal to the fifo width.
+		 *
+		 *   1) Copy as many fifo words as fit into an aligned bounce
+		 *      buffer, and write them to the fifo in one go.
+		 *   2) Loop back around to transfer the rest.
+		 */
+		else if ((InstancePtr->TailIndex == 0) &&
+			 (BytesRemaining >= InstancePtr->FifoWidth)) {
+			FifoWordsToXfer =
+				min(BytesRemaining / InstancePtr->FifoWidth,
+				    sizeof(Bounce) / InstancePtr->FifoWidth);
+			PartialBytes = FifoWordsToXfer * InstancePtr->FifoWidth;
+			xdbg_printf(XDBG_DEBUG_FIFO_TX, "XStrm_Write: (case 3) SrcPtr: %p; FifoWordsToXfer: %d\n",
+				    SrcPtr, FifoWordsToXfer);
+
+			memcpy(Bounce, SrcPtr, PartialBytes);
+			(*InstancePtr->WriteFn) (InstancePtr->FifoInstance,
+						 Bounce, FifoWordsToXfer);
+			SrcPtr += PartialBytes;
+			BytesRemaining -= PartialBytes;
+		}
+		/* Case 4: The alignment of the "galaxies" didn't occur in
+		 *         Cases 2 and 3 above, so we must pump the bytes through
+		 *         the holding buffer.
 		 *
 		 *   1) Write bytes from the source buffer to the holding buffer
 		 *   2) Loop back around and handle the rest of the transfer.
@@ -504,7 +563,7 @@ void XStrm_Write(XStrm_TxFifoStreamer *InstancePtr, void *BufPtr,
 			BytesRemaining -= PartialBytes;
 			InstancePtr->TailIndex += PartialBytes;
 			while (PartialBytes--) {
-				xdbg_printf(XDBG_DEBUG_FIFO_TX, "XStrm_Write: (case 3) PartialBytes: %d\n",
+				xdbg_printf(XDBG_DEBUG_FIFO_TX, "XStrm_Write: (case 4) PartialBytes: %d\n",
 					    PartialBytes);
 				InstancePtr->AlignedBuffer.bytes[i] = *SrcPtr;
 				i++;
@@ -0,0 +1,420 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xllfifo_bench.c
+*
+* Host test and benchmark of the AXI4-Stream FIFO driver and the byte
+* streamer on a memory-backed FIFO model.
+*
+* The model loops the transmit stream back into the receive stream: the words
+* written to the transmit data port are queued as a packet when the transmit
+* length is written, and handed out through the receive data port after the
+* receive length is read. Writing the wrong number of words for the length,
+* reading past the end of a packet or reading the length with no packet
+* queued is flagged. The data ports are at TDFD/RDFD of the register space
+* when the core is built with the AXI4-Lite data interface, and at the start
+* of the 4 KB TDFD and RDFD windows of a separate AXI4 space otherwise.
+*
+* The model also charges bus time for each access: a fixed time per
+* AXI4-Lite access, and for the AXI4 data interface a time per transaction
+* plus a time per beat. An AXI4 access to the word following the previous one
+* joins its INCR burst, up to a burst length, as when the processor gathers
+* accesses to normal non-cacheable memory; an access to the same address
+* starts a new single beat transaction.
+*
+* First, 20000 packets of random length are sent and received at random
+* buffer alignments, split into random chunks, through both data interfaces,
+* and the data is compared. Then packets of fixed sizes are sent and
+* received with one XLlFifo_Write/XLlFifo_Read each at every buffer alignment,
+* and the modelled bus throughput of both data interfaces and the host
+* throughput of the driver with the AXI4-Lite model are printed. The program
+* is built twice, with and without XLLF_AXI4_INCR_BURST.
+*
+* Usage: xllfifo_bench [ns per AXI4-Lite access] [ns per AXI4 transaction]
+*        [ns per beat] [beats per burst]
+*
+* The defaults are 100 ns, 60 ns, 10 ns and 16.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 5.2        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "xllfifo.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE	0x43C00000U	/* AXI4-Lite registers */
+#define SIM_AXI4	0x76000000U	/* AXI4 data windows */
+#define SIM_WINDOW	0x1000U		/* Size of one AXI4 data window */
+#define SIM_MAX_WORDS	4096U		/* Largest packet, words */
+
+#define CHECK_PACKETS	20000U
+#define BENCH_BYTES	(8U * 1024U * 1024U)
+
+/**************************** Type Definitions *******************************/
+
+typedef unsigned long long u64t;
+
+/************************** Variable Definitions *****************************/
+
+static u32 TxBuf[SIM_MAX_WORDS];
+static u32 TxWords;
+static u32 RxBuf[SIM_MAX_WORDS];
+static u32 RxWords;
+static u32 RxPos;
+static u32 RxBytes;
+static u32 RxQueued;
+static u32 SimErrors;
+
+/* Bus time */
+static double SimNs;
+static double LiteNs = 100.0;
+static double Axi4Ns = 60.0;
+static double BeatNs = 10.0;
+static u32 BurstBeats = 16U;
+static UINTPTR LastAddr;
+static u32 LastBeats;
+
+static XLlFifo Fifo;
+
+/************************** Function Definitions *****************************/
+
+static void SimError(const char *What)
+{
+	if (SimErrors < 10U) {
+		printf("  model: %s\n", What);
+	}
+	SimErrors++;
+}
+
+/* Charges an access to the AXI4 data interface */
+static void SimAxi4(UINTPTR Addr)
+{
+	if ((Addr == LastAddr + 4U) && (LastBeats < BurstBeats) &&
+		((Addr & (SIM_WINDOW - 1U)) != 0U)) {
+		LastBeats++;
+		SimNs += BeatNs;
+	}
+	else {
+		LastBeats = 1U;
+		SimNs += Axi4Ns + BeatNs;
+	}
+	LastAddr = Addr;
+}
+
+static void SimLite(void)
+{
+	LastAddr = 0U;
+	SimNs += LiteNs;
+}
+
+static void SimTxData(u32 Value)
+{
+	if (TxWords == SIM_MAX_WORDS) {
+		SimError("transmit overrun");
+		return;
+	}
+	TxBuf[TxWords++] = Value;
+}
+
+static u32 SimRxData(void)
+{
+	if (RxPos == RxWords) {
+		SimError("receive over-read");
+		return 0U;
+	}
+	return RxBuf[RxPos++];
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	if ((Addr >= SIM_AXI4 + SIM_WINDOW) &&
+		(Addr < SIM_AXI4 + 2U * SIM_WINDOW) && ((Addr & 3U) == 0U)) {
+		SimAxi4(Addr);
+		return SimRxData();
+	}
+
+	SimLite();
+
+	switch (Addr - SIM_BASE) {
+	case XLLF_ISR_OFFSET:
+	case XLLF_IER_OFFSET:
+		return 0U;
+	case XLLF_TDFV_OFFSET:
+		return SIM_MAX_WORDS - TxWords;
+	case XLLF_RDFO_OFFSET:
+		return RxQueued ? RxWords : (RxWords - RxPos);
+	case XLLF_RDFD_OFFSET:
+		return SimRxData();
+	case XLLF_RLF_OFFSET:
+		if (!RxQueued) {
+			SimError("receive length read with no packet");
+			return 0U;
+		}
+		if (RxPos != RxWords) {
+			SimError("previous packet not read out");
+		}
+		RxQueued = 0U;
+		RxPos = 0U;
+		return RxBytes;
+	default:
+		SimError("read of an unexpected address");
+		return 0U;
+	}
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	if ((Addr >= SIM_AXI4) && (Addr < SIM_AXI4 + SIM_WINDOW) &&
+		((Addr & 3U) == 0U)) {
+		SimAxi4(Addr);
+		SimTxData(Value);
+		return;
+	}
+
+	SimLite();
+
+	switch (Addr - SIM_BASE) {
+	case XLLF_ISR_OFFSET:
+	case XLLF_IER_OFFSET:
+	case XLLF_LLR_OFFSET:
+		break;
+	case XLLF_TDFR_OFFSET:
+		TxWords = 0U;
+		break;
+	case XLLF_RDFR_OFFSET:
+		RxQueued = 0U;
+		RxWords = 0U;
+		RxPos = 0U;
+		break;
+	case XLLF_TDFD_OFFSET:
+		SimTxData(Value);
+		break;
+	case XLLF_TLF_OFFSET:
+		if (TxWords != (Value + 3U) / 4U) {
+			SimError("transmit length mismatch");
+		}
+		if (RxQueued) {
+			SimError("receive side full");
+		}
+		memcpy(RxBuf, TxBuf, TxWords * 4U);
+		RxWords = TxWords;
+		RxBytes = Value;
+		RxPos = RxWords;
+		RxQueued = 1U;
+		TxWords = 0U;
+		break;
+	default:
+		SimError("write of an unexpected address");
+		break;
+	}
+}
+
+static void FifoInit(u32 Axi4)
+{
+	XLlFifo_Config Config;
+
+	memset(&Config, 0, sizeof(Config));
+	Config.BaseAddress = SIM_BASE;
+	Config.Axi4BaseAddress = SIM_AXI4;
+	Config.Datainterface = Axi4;
+
+	XLlFifo_CfgInitialize(&Fifo, &Config, SIM_BASE);
+}
+
+/* Sends and receives one packet, split into chunks of at most Chunk bytes */
+static u32 Loop(const u8 *Src, u8 *Dst, u32 Bytes, u32 Chunk)
+{
+	u32 Done;
+	u32 Len;
+
+	for (Done = 0U; Done < Bytes; Done += Len) {
+		Len = ((Bytes - Done) < Chunk) ? (Bytes - Done) : Chunk;
+		XLlFifo_Write(&Fifo, (void *)(Src + Done), Len);
+	}
+	XLlFifo_TxSetLen(&Fifo, Bytes);
+
+	if (XLlFifo_RxOccupancy(&Fifo) == 0U) {
+		SimError("nothing received");
+	}
+	Len = XLlFifo_RxGetLen(&Fifo);
+	if (Len != Bytes) {
+		SimError("receive length differs");
+		return 1U;
+	}
+
+	for (Done = 0U; Done < Bytes; Done += Len) {
+		Len = ((Bytes - Done) < Chunk) ? (Bytes - Done) : Chunk;
+		XLlFifo_Read(&Fifo, Dst + Done, Len);
+	}
+
+	return (memcmp(Src, Dst, Bytes) != 0) ? 1U : 0U;
+}
+
+static u32 CheckRandom(const u8 *Src, u8 *Dst)
+{
+	u32 Axi4;
+	u32 Index;
+	u32 Bytes;
+	u32 Chunk;
+	u32 Failed = 0U;
+
+	srand(1);
+
+	for (Axi4 = 0U; Axi4 < 2U; Axi4++) {
+		FifoInit(Axi4);
+		for (Index = 0U; Index < CHECK_PACKETS; Index++) {
+			Bytes = 1U + (u32)rand() % (SIM_MAX_WORDS * 4U);
+			Chunk = (rand() & 1) ? Bytes : 1U + (u32)rand() % 97U;
+			Failed += Loop(Src + rand() % 4, Dst + rand() % 4,
+				Bytes, Chunk);
+		}
+		if (Failed || SimErrors) {
+			printf("  FAIL: %s data interface\n",
+				Axi4 ? "AXI4" : "AXI4-Lite");
+		}
+	}
+
+	return Failed + SimErrors;
+}
+
+static double Now(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+
+	return Ts.tv_sec * 1e9 + Ts.tv_nsec;
+}
+
+int main(int argc, char *argv[])
+{
+	static const u32 Sizes[] = { 64U, 256U, 1514U, 4096U, 16384U };
+	u8 *Src;
+	u8 *Dst;
+	u32 Size;
+	u32 Align;
+	u32 Axi4;
+	u32 Count;
+	u32 Packet;
+	u32 Index;
+	u32 Failed;
+	double Bus[2];
+	double Host;
+	double Start;
+
+	if (argc > 1) {
+		LiteNs = atof(argv[1]);
+	}
+	if (argc > 2) {
+		Axi4Ns = atof(argv[2]);
+	}
+	if (argc > 3) {
+		BeatNs = atof(argv[3]);
+	}
+	if (argc > 4) {
+		BurstBeats = (u32)atoi(argv[4]);
+	}
+
+	Src = aligned_alloc(64, SIM_MAX_WORDS * 4U + 64U);
+	Dst = aligned_alloc(64, SIM_MAX_WORDS * 4U + 64U);
+	if ((Src == NULL) || (Dst == NULL)) {
+		return 1;
+	}
+	for (Index = 0U; Index < SIM_MAX_WORDS * 4U + 64U; Index++) {
+		Src[Index] = (u8)((Index * 13U) + (Index >> 8));
+	}
+
+	Failed = CheckRandom(Src, Dst);
+
+#ifdef XLLF_AXI4_INCR_BURST
+	printf("XLLF_AXI4_INCR_BURST");
+#else
+	printf("fixed address AXI4 data port");
+#endif
+	printf(", model: %.0f ns per AXI4-Lite access, %.0f ns per AXI4 "
+		"transaction, %.0f ns per beat, bursts up to %u beats\n\n",
+		LiteNs, Axi4Ns, BeatNs, BurstBeats);
+	printf("%8s %6s %14s %14s %14s\n", "packet", "align", "AXI4-Lite MB/s",
+		"AXI4 MB/s", "host MB/s");
+
+	for (Index = 0U; Index < sizeof(Sizes) / sizeof(Sizes[0]); Index++) {
+		Size = Sizes[Index];
+		Count = BENCH_BYTES / Size;
+
+		for (Align = 0U; Align < 4U; Align++) {
+			for (Axi4 = 0U; Axi4 < 2U; Axi4++) {
+				FifoInit(Axi4);
+				SimNs = 0.0;
+				Failed += Loop(Src + Align, Dst + Align, Size,
+					Size);
+				Bus[Axi4] = 2.0 * Size * 1000.0 / SimNs;
+			}
+
+			/* Host time of the driver on the AXI4-Lite model */
+			FifoInit(0U);
+			Start = Now();
+			for (Packet = 0U; Packet < Count; Packet++) {
+				Failed += Loop(Src + Align, Dst + Align, Size,
+					Size);
+			}
+			Host = 2.0 * Count * Size * 1000.0 / (Now() - Start);
+
+			printf("%8u %6u %14.1f %14.1f %14.1f\n", Size, Align,
+				Bus[0], Bus[1], Host);
+		}
+	}
+
+	Failed += SimErrors;
+
+	free(Src);
+	free(Dst);
+
+	printf("\n%s\n", (Failed == 0U) ? "all checks passed" :
+						"CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}
@@ -75,9 +75,35 @@
 * user must use XScuGic_Connect() when the interrupt handler takes an
 * argument other than the base address.
 *
+* <b>Interrupt Dispatch Options</b>
+*
+* The behavior of XScuGic_InterruptHandler() can be tuned at compile time by
+* adding the following definitions to the BSP compiler flags:
+*
+*   - XSCUGIC_DRAIN_INTERRUPTS=1 makes the handler keep acknowledging and
+*     dispatching interrupts until the GIC returns the spurious ID, so a
+*     burst of interrupts is serviced in a single exception entry.
+*   - XSCUGIC_NESTED_INTERRUPTS=1 re-enables IRQs around each call into a
+*     device handler. The GIC only signals interrupts whose priority group
+*     (see the Binary Point register) is higher than the running priority,
+*     so a long low-priority handler can be preempted by a more urgent one.
+*     Only available on processors whose BSP provides
+*     Xil_EnableNestedInterrupts() (Cortex-A9 and Cortex-R5).
+*   - XSCUGIC_INTR_STATS=1 keeps a per-interrupt dispatch count and the
+*     maximum time, in XTime ticks, from exception entry until the handler
+*     returned. See XScuGic_GetIntrStats(). The total and maximum time spent
+*     in the handler itself and the maximum delay from exception entry until
+*     the handler was called are kept as well, see XScuGic_GetHandlerStats()
+*     and XScuGic_PrintIntrStats(). XTime ticks are the global timer on
+*     Cortex-A9 and the PMU cycle counter on Cortex-R5.
+*
+* All options default to 0, which keeps the original one interrupt per
+* exception behavior.
+*
 * <b>Nested Interrupts Processing</b>
 *
-* Nested interrupts are not supported by this driver.
+* Nested interrupts are not supported by this driver unless
+* XSCUGIC_NESTED_INTERRUPTS is enabled as described above.
 *
 * NOTE:
 * The generic interrupt controller is not a part of the snoop control unit
@@ -144,6 +170,10 @@
 *             initialized with the corresponding CPU ID on which the application
 *             built over the scugic driver runs.
 *             These changes fix CR#937243.
+* 3.3        10/18/26 Added the XSCUGIC_DRAIN_INTERRUPTS, XSCUGIC_NESTED_INTERRUPTS
+*                     and XSCUGIC_INTR_STATS dispatch options. A host GIC
+*                     model is in the tests directory. Added
+*                     XScuGic_GetHandlerStats() and XScuGic_PrintIntrStats().
 *
 * </pre>
 *
@@ -166,6 +196,22 @@ extern "C" {
 
 /************************** Constant Definitions *****************************/
 
+/** @name Interrupt Dispatch Options
+ * Compile time options for XScuGic_InterruptHandler(). See the file header.
+ * @{
+ */
+#ifndef XSCUGIC_DRAIN_INTERRUPTS
+#define XSCUGIC_DRAIN_INTERRUPTS	0
+#endif
+
+#ifndef XSCUGIC_NESTED_INTERRUPTS
+#define XSCUGIC_NESTED_INTERRUPTS	0
+#endif
+
+#ifndef XSCUGIC_INTR_STATS
+#define XSCUGIC_INTR_STATS		0
+#endif
+/*@}*/
 
 /**************************** Type Definitions *******************************/
 
@@ -179,6 +225,18 @@ typedef struct
 	void *CallBackRef;
 } XScuGic_VectorTableEntry;
 
+/**
+ * Per interrupt ID handler timing returned by XScuGic_GetHandlerStats(). Only
+ * updated when the driver is built with XSCUGIC_INTR_STATS.
+ */
+typedef struct
+{
+	u64 TotalCycles;	/**< Total ticks spent in the handler */
+	u32 MaxCycles;		/**< Longest single handler run in ticks */
+	u32 MaxEntryLatency;	/**< Longest delay in ticks from exception entry
+				  *  until the handler was called */
+} XScuGic_HandlerStats;
+
 /**
  * This typedef contains configuration information for the device.
  */
@@ -313,6 +371,12 @@ XScuGic_Config *XScuGic_LookupConfig(u16 DeviceId);
  * Interrupt functions in xscugic_intr.c
  */
 void XScuGic_InterruptHandler(XScuGic *InstancePtr);
+s32  XScuGic_GetIntrStats(XScuGic *InstancePtr, u32 Int_Id, u32 *CountPtr,
+				u32 *MaxLatencyPtr);
+s32  XScuGic_GetHandlerStats(XScuGic *InstancePtr, u32 Int_Id,
+				XScuGic_HandlerStats *StatsPtr);
+void XScuGic_ResetIntrStats(XScuGic *InstancePtr);
+void XScuGic_PrintIntrStats(XScuGic *InstancePtr);
 
 /*
  * Self-test functions in xscugic_selftest.c
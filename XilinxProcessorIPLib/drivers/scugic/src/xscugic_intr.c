@@ -62,6 +62,9 @@
 * 1.01a sdm  11/09/11 XScuGic_InterruptHandler has changed correspondingly
 *		      since the HandlerTable has now moved to XScuGic_Config.
 * 3.00  kvn  02/13/15 Modified code for MISRA-C:2012 compliance.
+* 3.3        10/18/26 Added the drain loop, nested dispatch and interrupt
+*                     statistics options. EOI is not written for the
+*                     spurious ID.
 *
 * </pre>
 *
@@ -80,18 +83,59 @@
 
 #include "xil_types.h"
 #include "xil_assert.h"
+#include "xparameters.h"
 #include "xscugic.h"
+#if XSCUGIC_INTR_STATS
+#include "xtime_l.h"
+#include "xil_printf.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
+#if XSCUGIC_NESTED_INTERRUPTS && !defined(Xil_EnableNestedInterrupts)
+#error "XSCUGIC_NESTED_INTERRUPTS requires Xil_EnableNestedInterrupts() in the BSP"
+#endif
+
 /**************************** Type Definitions *******************************/
 
+#if XSCUGIC_INTR_STATS
+/*
+ * Statistics kept for each interrupt ID when XSCUGIC_INTR_STATS is enabled.
+ */
+typedef struct {
+	u32 Count;		/**< Number of times the handler was called */
+	u32 MaxLatency;		/**< Max XTime ticks from exception entry to
+				  *  handler return */
+	XScuGic_HandlerStats Handler;	/**< Time spent in the handler */
+} XScuGic_IntrStats;
+#endif
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 
+#if XSCUGIC_NESTED_INTERRUPTS
+#ifdef __GNUC__
+static void XScuGic_NestedDispatch(Xil_InterruptHandler Handler,
+				void *CallBackRef) __attribute__((noinline));
+#else
+static void XScuGic_NestedDispatch(Xil_InterruptHandler Handler,
+				void *CallBackRef);
+#endif
+#endif
+
 /************************** Variable Definitions *****************************/
 
+#if XSCUGIC_INTR_STATS
+/*
+ * Indexed by device ID, the same way XScuGic_DeviceInterruptHandler() indexes
+ * the configuration table. Kept out of the instance structure so that code
+ * built without XSCUGIC_INTR_STATS still sees the same XScuGic layout.
+ */
+static XScuGic_IntrStats
+	IntrStats[XPAR_SCUGIC_NUM_INSTANCES][XSCUGIC_MAX_NUM_INTR_INPUTS];
+#endif
+
 /*****************************************************************************/
 /**
 * This function is the primary interrupt handler for the driver.  It must be
@@ -105,6 +149,10 @@
 * initialized.  It does not verify that entries in the table are valid before
 * calling an interrupt handler.
 *
+* With XSCUGIC_DRAIN_INTERRUPTS enabled, the function keeps acknowledging and
+* dispatching interrupts until the GIC reports that none is pending. With
+* XSCUGIC_NESTED_INTERRUPTS enabled, IRQs are re-enabled while a device
+* handler runs so that interrupts of a higher priority group can preempt it.
 *
 * @param	InstancePtr is a pointer to the XScuGic instance.
 *
@@ -117,57 +165,302 @@ void XScuGic_InterruptHandler(XScuGic *InstancePtr)
 {
 
 	u32 InterruptID;
-	    u32 IntIDFull;
-	    XScuGic_VectorTableEntry *TablePtr;
-
-	    /* Assert that the pointer to the instance is valid
-	     */
-	    Xil_AssertVoid(InstancePtr != NULL);
-
-	    /*
-	     * Read the int_ack register to identify the highest priority interrupt ID
-	     * and make sure it is valid. Reading Int_Ack will clear the interrupt
-	     * in the GIC.
-	     */
-	    IntIDFull = XScuGic_CPUReadReg(InstancePtr, XSCUGIC_INT_ACK_OFFSET);
-	    InterruptID = IntIDFull & XSCUGIC_ACK_INTID_MASK;
-
-	    if(XSCUGIC_MAX_NUM_INTR_INPUTS < InterruptID){
-		goto IntrExit;
-	    }
-
-	    /*
-	     * If the interrupt is shared, do some locking here if there are multiple
-	     * processors.
-	     */
-	    /*
-	     * If pre-eption is required:
-	     * Re-enable pre-emption by setting the CPSR I bit for non-secure ,
-	     * interrupts or the F bit for secure interrupts
-	     */
-
-	    /*
-	     * If we need to change security domains, issue a SMC instruction here.
-	     */
-
-	    /*
-	     * Execute the ISR. Jump into the Interrupt service routine based on the
-	     * IRQSource. A software trigger is cleared by the ACK.
-	     */
-	    TablePtr = &(InstancePtr->Config->HandlerTable[InterruptID]);
+	u32 IntIDFull;
+	XScuGic_VectorTableEntry *TablePtr;
+#if XSCUGIC_INTR_STATS
+	XTime EntryTime;
+	XTime StartTime;
+	XTime EndTime;
+	u32 Cycles;
+	XScuGic_IntrStats *StatsPtr = NULL;
+	XScuGic_HandlerStats *HandlerPtr;
+#endif
+
+	/* Assert that the pointer to the instance is valid
+	 */
+	Xil_AssertVoid(InstancePtr != NULL);
+
+#if XSCUGIC_INTR_STATS
+	XTime_GetTime(&EntryTime);
+	if ((u32)InstancePtr->Config->DeviceId <
+			(u32)XPAR_SCUGIC_NUM_INSTANCES) {
+		StatsPtr = IntrStats[InstancePtr->Config->DeviceId];
+	}
+#endif
+
+	do {
+		/*
+		 * Read the int_ack register to identify the highest priority
+		 * interrupt ID and make sure it is valid. Reading Int_Ack will
+		 * clear the interrupt in the GIC. When nothing is pending the
+		 * spurious ID (1023) is returned, which ends the drain loop.
+		 */
+		IntIDFull = XScuGic_CPUReadReg(InstancePtr,
+						XSCUGIC_INT_ACK_OFFSET);
+		InterruptID = IntIDFull & XSCUGIC_ACK_INTID_MASK;
+
+		if(InterruptID >= XSCUGIC_MAX_NUM_INTR_INPUTS){
+			break;
+		}
+
+		/*
+		 * If the interrupt is shared, do some locking here if there
+		 * are multiple processors.
+		 */
+		/*
+		 * If we need to change security domains, issue a SMC
+		 * instruction here.
+		 */
+
+		/*
+		 * Execute the ISR. Jump into the Interrupt service routine
+		 * based on the IRQSource. A software trigger is cleared by the
+		 * ACK. Until EOI is written the GIC running priority is that
+		 * of this interrupt, so in nested mode only a higher priority
+		 * group can preempt the handler.
+		 */
+		TablePtr = &(InstancePtr->Config->HandlerTable[InterruptID]);
+#if XSCUGIC_INTR_STATS
+		XTime_GetTime(&StartTime);
+#endif
 		if(TablePtr != NULL) {
-	        TablePtr->Handler(TablePtr->CallBackRef);
+#if XSCUGIC_NESTED_INTERRUPTS
+			XScuGic_NestedDispatch(TablePtr->Handler,
+						TablePtr->CallBackRef);
+#else
+			TablePtr->Handler(TablePtr->CallBackRef);
+#endif
+		}
+
+#if XSCUGIC_INTR_STATS
+		XTime_GetTime(&EndTime);
+		if (StatsPtr != NULL) {
+			StatsPtr[InterruptID].Count++;
+			Cycles = (u32)(EndTime - EntryTime);
+			if (Cycles > StatsPtr[InterruptID].MaxLatency) {
+				StatsPtr[InterruptID].MaxLatency = Cycles;
+			}
+			HandlerPtr = &StatsPtr[InterruptID].Handler;
+			Cycles = (u32)(EndTime - StartTime);
+			HandlerPtr->TotalCycles += Cycles;
+			if (Cycles > HandlerPtr->MaxCycles) {
+				HandlerPtr->MaxCycles = Cycles;
+			}
+			Cycles = (u32)(StartTime - EntryTime);
+			if (Cycles > HandlerPtr->MaxEntryLatency) {
+				HandlerPtr->MaxEntryLatency = Cycles;
+			}
+		}
+#endif
+
+		/*
+		 * Write to the EOI register, we are all done with this
+		 * interrupt.
+		 */
+		XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_EOI_OFFSET, IntIDFull);
+	} while (XSCUGIC_DRAIN_INTERRUPTS != 0);
+
+	/*
+	 * Let this function return, the boot code will restore the stack.
+	 * Return from the interrupt. Change security domains could happen here.
+	 */
+}
+
+#if XSCUGIC_NESTED_INTERRUPTS
+/*****************************************************************************/
+/**
+* Call a device handler with IRQs re-enabled. The processor is moved to
+* system mode for the duration of the call so that a nested IRQ does not
+* overwrite the IRQ mode link register.
+*
+* This is kept as a separate function, with its arguments only in registers,
+* because Xil_EnableNestedInterrupts() switches to the system mode stack
+* pointer.
+*
+* @param	Handler is the device handler to call.
+* @param	CallBackRef is the argument passed to the handler.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XScuGic_NestedDispatch(Xil_InterruptHandler Handler,
+				void *CallBackRef)
+{
+	Xil_EnableNestedInterrupts();
+	Handler(CallBackRef);
+	Xil_DisableNestedInterrupts();
+}
+#endif
+
+/*****************************************************************************/
+/**
+* Read the statistics kept for an interrupt ID by XScuGic_InterruptHandler().
+*
+* @param	InstancePtr is a pointer to the XScuGic instance.
+* @param	Int_Id is the interrupt ID.
+* @param	CountPtr is where the number of dispatches is stored.
+* @param	MaxLatencyPtr is where the maximum number of XTime ticks from
+*		exception entry until the handler returned is stored.
+*
+* @return
+*		- XST_SUCCESS if the statistics were read.
+*		- XST_INVALID_PARAM if the device ID has no statistics slot.
+*		- XST_NO_FEATURE if the driver was built without
+*		  XSCUGIC_INTR_STATS.
+*
+* @note		The values are read without masking interrupts and may be
+*		updated concurrently.
+*
+******************************************************************************/
+s32 XScuGic_GetIntrStats(XScuGic *InstancePtr, u32 Int_Id, u32 *CountPtr,
+				u32 *MaxLatencyPtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS);
+	Xil_AssertNonvoid(CountPtr != NULL);
+	Xil_AssertNonvoid(MaxLatencyPtr != NULL);
+
+#if XSCUGIC_INTR_STATS
+	if ((u32)InstancePtr->Config->DeviceId >=
+			(u32)XPAR_SCUGIC_NUM_INSTANCES) {
+		return XST_INVALID_PARAM;
+	}
+
+	*CountPtr = IntrStats[InstancePtr->Config->DeviceId][Int_Id].Count;
+	*MaxLatencyPtr =
+		IntrStats[InstancePtr->Config->DeviceId][Int_Id].MaxLatency;
+
+	return XST_SUCCESS;
+#else
+	*CountPtr = 0U;
+	*MaxLatencyPtr = 0U;
+
+	return XST_NO_FEATURE;
+#endif
+}
+
+/*****************************************************************************/
+/**
+* Take a snapshot of the handler timing kept for an interrupt ID by
+* XScuGic_InterruptHandler(). The dispatch count is read with
+* XScuGic_GetIntrStats().
+*
+* @param	InstancePtr is a pointer to the XScuGic instance.
+* @param	Int_Id is the interrupt ID.
+* @param	StatsPtr is where the handler timing is copied to.
+*
+* @return
+*		- XST_SUCCESS if the statistics were copied.
+*		- XST_INVALID_PARAM if the device ID has no statistics slot.
+*		- XST_NO_FEATURE if the driver was built without
+*		  XSCUGIC_INTR_STATS.
+*
+* @note		The interrupt is not masked while copying, so a dispatch
+*		that completes meanwhile may be partially included.
+*
+******************************************************************************/
+s32 XScuGic_GetHandlerStats(XScuGic *InstancePtr, u32 Int_Id,
+				XScuGic_HandlerStats *StatsPtr)
+{
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS);
+	Xil_AssertNonvoid(StatsPtr != NULL);
+
+#if XSCUGIC_INTR_STATS
+	if ((u32)InstancePtr->Config->DeviceId >=
+			(u32)XPAR_SCUGIC_NUM_INSTANCES) {
+		return XST_INVALID_PARAM;
+	}
+
+	*StatsPtr = IntrStats[InstancePtr->Config->DeviceId][Int_Id].Handler;
+
+	return XST_SUCCESS;
+#else
+	StatsPtr->TotalCycles = 0U;
+	StatsPtr->MaxCycles = 0U;
+	StatsPtr->MaxEntryLatency = 0U;
+
+	return XST_NO_FEATURE;
+#endif
+}
+
+/*****************************************************************************/
+/**
+* Clear the statistics kept by XScuGic_InterruptHandler() for all interrupt
+* IDs of the instance.
+*
+* @param	InstancePtr is a pointer to the XScuGic instance.
+*
+* @return	None.
+*
+* @note		Does nothing if the driver was built without XSCUGIC_INTR_STATS.
+*
+******************************************************************************/
+void XScuGic_ResetIntrStats(XScuGic *InstancePtr)
+{
+#if XSCUGIC_INTR_STATS
+	u32 Index;
+	XScuGic_IntrStats *StatsPtr;
+#endif
+
+	Xil_AssertVoid(InstancePtr != NULL);
+
+#if XSCUGIC_INTR_STATS
+	if ((u32)InstancePtr->Config->DeviceId <
+			(u32)XPAR_SCUGIC_NUM_INSTANCES) {
+		StatsPtr = IntrStats[InstancePtr->Config->DeviceId];
+		for (Index = 0U; Index < XSCUGIC_MAX_NUM_INTR_INPUTS; Index++) {
+			StatsPtr[Index].Count = 0U;
+			StatsPtr[Index].MaxLatency = 0U;
+			StatsPtr[Index].Handler.TotalCycles = 0U;
+			StatsPtr[Index].Handler.MaxCycles = 0U;
+			StatsPtr[Index].Handler.MaxEntryLatency = 0U;
 		}
+	}
+#endif
+}
 
-	IntrExit:
-	    /*
-	     * Write to the EOI register, we are all done here.
-	     * Let this function return, the boot code will restore the stack.
-	     */
-	    XScuGic_CPUWriteReg(InstancePtr, XSCUGIC_EOI_OFFSET, IntIDFull);
+/*****************************************************************************/
+/**
+* Print the statistics of every interrupt ID that has been dispatched at least
+* once since the last reset. Each line shows the ID, the dispatch count, the
+* maximum time from exception entry until the handler returned, the average
+* and maximum handler time and the maximum delay until the handler was
+* called, all in XTime ticks.
+*
+* @param	InstancePtr is a pointer to the XScuGic instance.
+*
+* @return	None.
+*
+* @note		Does nothing if the driver was built without XSCUGIC_INTR_STATS.
+*
+******************************************************************************/
+void XScuGic_PrintIntrStats(XScuGic *InstancePtr)
+{
+#if XSCUGIC_INTR_STATS
+	u32 Index;
+	u32 Count;
+	u32 MaxLatency;
+	XScuGic_HandlerStats Stats;
+#endif
 
-	    /*
-	     * Return from the interrupt. Change security domains could happen here.
-     */
+	Xil_AssertVoid(InstancePtr != NULL);
+
+#if XSCUGIC_INTR_STATS
+	xil_printf("ID    Count       MaxLatency  Avg         Max         "
+		"MaxEntry\r\n");
+	for (Index = 0U; Index < XSCUGIC_MAX_NUM_INTR_INPUTS; Index++) {
+		if ((XScuGic_GetIntrStats(InstancePtr, Index, &Count,
+				&MaxLatency) != XST_SUCCESS) || (Count == 0U)) {
+			continue;
+		}
+		(void)XScuGic_GetHandlerStats(InstancePtr, Index, &Stats);
+		xil_printf("%-5d %-11u %-11u %-11u %-11u %u\r\n", Index, Count,
+			MaxLatency, (u32)(Stats.TotalCycles / Count),
+			Stats.MaxCycles, Stats.MaxEntryLatency);
+	}
+#endif
 }
 /** @} */
@@ -0,0 +1,519 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xscugic_gic_sim.c
+*
+* Host test of XScuGic_InterruptHandler() against a register model of the
+* GIC CPU interface and a simulated processor.
+*
+* The model keeps the pending and active state and the priority of every
+* interrupt ID and a stack of the active interrupts. Reading INT_ACK returns
+* the highest priority pending interrupt if its priority group is higher than
+* the running priority, makes it active and raises the running priority to
+* its own; otherwise the spurious ID is returned. Writing EOI deactivates the
+* interrupt on the top of the stack. An interrupt raised again while it is
+* still pending is merged with the pending one.
+*
+* The processor runs in cycles. Taking an exception and returning from it
+* costs a fixed number of cycles, as does each access to the CPU interface.
+* An exception is taken whenever the IRQ mask bit is clear and the model
+* signals an interrupt, at the top level or, with nested interrupts, inside a
+* device handler. Each device handler records the delay from the moment its
+* interrupt was raised and then runs for a fixed number of cycles.
+*
+* The interrupt sources are a periodic timer, a high priority UART with a
+* short handler, bursts of eight DMA channel interrupts raised together and a
+* low priority bulk handler that runs for 40000 cycles.
+*
+* The checks are that:
+*  - every interrupt raised is handled, once per merged pending state,
+*  - EOI is written for every acknowledged interrupt in nesting order, and
+*    never for the spurious ID,
+*  - without the drain loop there is one exception per interrupt, with it
+*    the DMA bursts share exceptions,
+*  - interrupts nest only in the nested build, and there the worst case
+*    latency of the UART stays within SIM_HIGH_BOUND cycles despite the bulk
+*    handler,
+*  - the driver statistics count the same dispatches per ID as the model.
+*
+* Usage: xscugic_gic_sim [million cycles] [seed]
+*
+* The defaults are 400 and 1. xscugic_gic_sim is built with the default
+* dispatch options, xscugic_gic_sim_drain with XSCUGIC_DRAIN_INTERRUPTS and
+* xscugic_gic_sim_nested with XSCUGIC_DRAIN_INTERRUPTS and
+* XSCUGIC_NESTED_INTERRUPTS. All builds enable XSCUGIC_INTR_STATS.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 3.3        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xscugic.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_CPU_BASE	0xF8F00100U	/* CPU interface registers */
+#define SIM_DIST_BASE	0xF8F01000U	/* Distributor registers */
+#define SIM_SPURIOUS	1023U
+#define SIM_IDLE_PRIO	0x100U		/* Running priority, none active */
+#define SIM_GROUP_MASK	0xF8U		/* Priority bits that preempt */
+#define SIM_MAX_DEPTH	16U
+
+#define SIM_ENTRY	60U	/* Exception entry and context save, cycles */
+#define SIM_EXIT	50U	/* Context restore and return */
+#define SIM_REG		25U	/* CPU interface register access */
+#define SIM_NEST	12U	/* Mode switch to or from nested IRQs */
+#define SIM_HIGH_BOUND	2000U	/* Nested build, UART worst case latency */
+
+#define SIM_NEVER	(~(u64)0U)
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	const char *Name;
+	u32 Id;			/* First interrupt ID */
+	u32 NumIds;		/* IDs from Id raised together */
+	u32 Priority;
+	u32 Work;		/* Handler cycles */
+	u32 Period;		/* Mean cycles between raises */
+	u32 Random;		/* Interval drawn from Period/2..3*Period/2 */
+	u64 NextAt;
+	u32 Raised;
+	u32 Merged;
+	u32 Handled;
+	double LatSum;
+	u64 LatMax;
+} SimSource;
+
+/************************** Variable Definitions *****************************/
+
+u32 SimCpsr = XIL_EXCEPTION_IRQ;
+u64 SimTime;
+
+static SimSource Sources[] = {
+	{ "timer",	29U, 1U, 0xA0U,  2000U, 666667U, 0U },
+	{ "uart",	82U, 1U, 0x20U,   300U,  20000U, 1U },
+	{ "dma",	46U, 8U, 0x80U,   400U, 100000U, 1U },
+	{ "bulk",	61U, 1U, 0xE0U, 40000U, 400000U, 1U },
+};
+#define SIM_SOURCES	(sizeof(Sources) / sizeof(Sources[0]))
+
+static XScuGic_Config GicConfig;
+static XScuGic Gic;
+
+/* GIC model */
+static u8 Pending[XSCUGIC_MAX_NUM_INTR_INPUTS];
+static u8 Active[XSCUGIC_MAX_NUM_INTR_INPUTS];
+static u32 Priority[XSCUGIC_MAX_NUM_INTR_INPUTS];
+static u64 PendingSince[XSCUGIC_MAX_NUM_INTR_INPUTS];
+static u64 AckedSince[XSCUGIC_MAX_NUM_INTR_INPUTS];
+static u32 HandledId[XSCUGIC_MAX_NUM_INTR_INPUTS];
+static u32 ActiveStack[SIM_MAX_DEPTH];
+static u32 ActiveDepth;
+
+/* Processor model */
+static u32 Depth;
+static u32 MaxDepth;
+static u32 Exceptions;
+static u64 BusyStart;
+static u64 BusyCycles;
+static u32 Stopped;
+
+static u32 EoiErrors;
+static u32 SpuriousEoi;
+static u32 BadAccesses;
+static u32 Failed;
+
+static unsigned long long Seed = 1U;
+
+/************************** Function Prototypes ******************************/
+
+static void SimRun(u64 Cycles);
+
+/*****************************************************************************/
+
+static u32 SimRand(u32 Range)
+{
+	Seed = Seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (u32)((Seed >> 33) % Range);
+}
+
+static void Check(int Cond, const char *What)
+{
+	if (!Cond) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+static u32 GicRunning(void)
+{
+	if (ActiveDepth == 0U) {
+		return SIM_IDLE_PRIO;
+	}
+	return Priority[ActiveStack[ActiveDepth - 1U]] & SIM_GROUP_MASK;
+}
+
+/* Highest priority pending ID, the lowest ID among equals */
+static u32 GicHighest(void)
+{
+	u32 Id;
+	u32 Best = SIM_SPURIOUS;
+
+	for (Id = 0U; Id < XSCUGIC_MAX_NUM_INTR_INPUTS; Id++) {
+		if (Pending[Id] != 0U && (Best == SIM_SPURIOUS ||
+				Priority[Id] < Priority[Best])) {
+			Best = Id;
+		}
+	}
+	return Best;
+}
+
+static int GicSignal(void)
+{
+	u32 Id = GicHighest();
+
+	return Id != SIM_SPURIOUS &&
+		(Priority[Id] & SIM_GROUP_MASK) < GicRunning();
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Id = SIM_SPURIOUS;
+
+	if (Addr != SIM_CPU_BASE + XSCUGIC_INT_ACK_OFFSET) {
+		BadAccesses++;
+		return 0U;
+	}
+	if (GicSignal()) {
+		Id = GicHighest();
+		Pending[Id] = 0U;
+		Active[Id] = 1U;
+		AckedSince[Id] = PendingSince[Id];
+		ActiveStack[ActiveDepth++] = Id;
+	}
+	SimRun(SIM_REG);
+	return Id;
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Id = Value & XSCUGIC_ACK_INTID_MASK;
+
+	if (Addr != SIM_CPU_BASE + XSCUGIC_EOI_OFFSET) {
+		BadAccesses++;
+		return;
+	}
+	if (Id >= 1020U) {
+		SpuriousEoi++;
+	} else if (ActiveDepth == 0U || ActiveStack[ActiveDepth - 1U] != Id) {
+		EoiErrors++;
+	} else {
+		ActiveDepth--;
+		Active[Id] = 0U;
+	}
+	SimRun(SIM_REG);
+}
+
+static void SimRaise(SimSource *Src)
+{
+	u32 Id;
+
+	for (Id = Src->Id; Id < Src->Id + Src->NumIds; Id++) {
+		Src->Raised++;
+		if (Pending[Id] != 0U) {
+			Src->Merged++;
+		} else {
+			Pending[Id] = 1U;
+			PendingSince[Id] = SimTime;
+		}
+	}
+	if (Stopped != 0U) {
+		Src->NextAt = SIM_NEVER;
+	} else if (Src->Random != 0U) {
+		Src->NextAt = SimTime + Src->Period / 2U + SimRand(Src->Period);
+	} else {
+		Src->NextAt = SimTime + Src->Period;
+	}
+}
+
+static u64 SimNextRaise(void)
+{
+	u32 Index;
+	u64 Next = SIM_NEVER;
+
+	for (Index = 0U; Index < SIM_SOURCES; Index++) {
+		if (Sources[Index].NextAt < Next) {
+			Next = Sources[Index].NextAt;
+		}
+	}
+	return Next;
+}
+
+static void SimException(void)
+{
+	u32 SavedCpsr = SimCpsr;
+
+	SimCpsr |= XIL_EXCEPTION_IRQ;
+	if (Depth == 0U) {
+		BusyStart = SimTime;
+	}
+	Depth++;
+	if (Depth > MaxDepth) {
+		MaxDepth = Depth;
+	}
+	Exceptions++;
+
+	SimRun(SIM_ENTRY);
+	XScuGic_InterruptHandler(&Gic);
+	SimRun(SIM_EXIT);
+
+	Depth--;
+	if (Depth == 0U) {
+		BusyCycles += SimTime - BusyStart;
+	}
+	SimCpsr = SavedCpsr;
+}
+
+/*
+ * Advance the processor by Cycles of work, raising interrupts as they fall
+ * due and taking exceptions while IRQs are unmasked. Time spent in a nested
+ * exception does not count towards the work.
+ */
+static void SimRun(u64 Cycles)
+{
+	u64 End = SimTime + Cycles;
+	u64 Left;
+	u64 Next;
+	u32 Index;
+
+	for (;;) {
+		if ((SimCpsr & XIL_EXCEPTION_IRQ) == 0U && GicSignal()) {
+			Left = End - SimTime;
+			SimException();
+			End = SimTime + Left;
+			continue;
+		}
+		Next = SimNextRaise();
+		if (Next > End) {
+			SimTime = End;
+			break;
+		}
+		if (Next > SimTime) {
+			SimTime = Next;
+		}
+		for (Index = 0U; Index < SIM_SOURCES; Index++) {
+			if (Sources[Index].NextAt <= SimTime) {
+				SimRaise(&Sources[Index]);
+			}
+		}
+	}
+}
+
+void SimEnableNested(void)
+{
+	SimCpsr &= ~XIL_EXCEPTION_IRQ;
+	SimRun(SIM_NEST);
+}
+
+void SimDisableNested(void)
+{
+	SimCpsr |= XIL_EXCEPTION_IRQ;
+	SimRun(SIM_NEST);
+}
+
+static void SimHandler(void *CallBackRef)
+{
+	SimSource *Src = (SimSource *)CallBackRef;
+	u32 Id;
+	u64 Latency;
+
+	if (ActiveDepth == 0U) {
+		Check(0, "handler called without an active interrupt");
+		return;
+	}
+	Id = ActiveStack[ActiveDepth - 1U];
+	Check(Id >= Src->Id && Id < Src->Id + Src->NumIds,
+		"handler called for the interrupt ID of another source");
+
+	Latency = SimTime - AckedSince[Id];
+	Src->Handled++;
+	Src->LatSum += (double)Latency;
+	if (Latency > Src->LatMax) {
+		Src->LatMax = Latency;
+	}
+	HandledId[Id]++;
+
+	SimRun(Src->Work);
+}
+
+static void SimInit(void)
+{
+	u32 Index;
+	u32 Id;
+	SimSource *Src;
+
+	GicConfig.DeviceId = 0U;
+	GicConfig.CpuBaseAddress = SIM_CPU_BASE;
+	GicConfig.DistBaseAddress = SIM_DIST_BASE;
+	Gic.Config = &GicConfig;
+	Gic.IsReady = XIL_COMPONENT_IS_READY;
+
+	for (Index = 0U; Index < SIM_SOURCES; Index++) {
+		Src = &Sources[Index];
+		for (Id = Src->Id; Id < Src->Id + Src->NumIds; Id++) {
+			Priority[Id] = Src->Priority;
+			GicConfig.HandlerTable[Id].Handler = SimHandler;
+			GicConfig.HandlerTable[Id].CallBackRef = Src;
+		}
+		Src->NextAt = SimRand(Src->Period);
+	}
+	XScuGic_ResetIntrStats(&Gic);
+}
+
+static void SimCheckStats(void)
+{
+	XScuGic_HandlerStats Stats;
+	u32 Count;
+	u32 MaxLatency;
+	u32 Index;
+	u32 Id;
+	u32 Mismatch = 0U;
+	SimSource *Src;
+
+	for (Index = 0U; Index < SIM_SOURCES; Index++) {
+		Src = &Sources[Index];
+		for (Id = Src->Id; Id < Src->Id + Src->NumIds; Id++) {
+			if (XScuGic_GetIntrStats(&Gic, Id, &Count,
+					&MaxLatency) != XST_SUCCESS ||
+					XScuGic_GetHandlerStats(&Gic, Id,
+					&Stats) != XST_SUCCESS ||
+					Count != HandledId[Id] ||
+					(Count != 0U &&
+					 (Stats.MaxCycles < Src->Work ||
+					  MaxLatency < Stats.MaxCycles ||
+					  MaxLatency < Stats.MaxEntryLatency))) {
+				Mismatch++;
+			}
+		}
+	}
+	Check(Mismatch == 0U, "driver statistics match the dispatches");
+}
+
+int main(int argc, char *argv[])
+{
+	u64 Duration = 400000000U;
+	u32 Index;
+	u32 Handled = 0U;
+	u32 Unhandled = 0U;
+	u64 WorkCycles = 0U;
+	SimSource *Src;
+
+	if (argc > 1) {
+		Duration = strtoull(argv[1], NULL, 0) * 1000000U;
+	}
+	if (argc > 2) {
+		Seed = strtoull(argv[2], NULL, 0);
+	}
+
+	printf("GIC dispatch, drain %d, nested %d, %llu million cycles\n\n",
+		XSCUGIC_DRAIN_INTERRUPTS, XSCUGIC_NESTED_INTERRUPTS,
+		(unsigned long long)(Duration / 1000000U));
+
+	SimInit();
+
+	/* The processor idles with IRQs unmasked */
+	SimCpsr &= ~XIL_EXCEPTION_IRQ;
+	SimRun(Duration);
+
+	/* Stop raising interrupts and let the pending ones drain */
+	Stopped = 1U;
+	while (GicHighest() != SIM_SPURIOUS || SimNextRaise() != SIM_NEVER) {
+		SimRun(100000U);
+	}
+
+	printf("source  priority   raised   merged  handled  avg latency"
+		"  max latency\n");
+	for (Index = 0U; Index < SIM_SOURCES; Index++) {
+		Src = &Sources[Index];
+		printf("%-8s    0x%02x %8u %8u %8u %12.0f %12llu\n", Src->Name,
+			(unsigned)Src->Priority, Src->Raised, Src->Merged,
+			Src->Handled,
+			Src->Handled != 0U ? Src->LatSum / Src->Handled : 0.0,
+			(unsigned long long)Src->LatMax);
+		Handled += Src->Handled;
+		WorkCycles += (u64)Src->Handled * Src->Work;
+		if (Src->Raised != Src->Handled + Src->Merged) {
+			Unhandled++;
+		}
+	}
+	printf("\nexceptions %u for %u interrupts, deepest nesting %u\n",
+		Exceptions, Handled, MaxDepth);
+	printf("dispatch overhead %.1f cycles per interrupt, CPU load %.2f%%\n",
+		(double)(BusyCycles - WorkCycles) / Handled,
+		100.0 * (double)BusyCycles / (double)SimTime);
+
+	Check(Unhandled == 0U, "every interrupt raised is handled");
+	Check(BadAccesses == 0U, "only INT_ACK and EOI are accessed");
+	Check(EoiErrors == 0U, "EOI is written in nesting order");
+	Check(SpuriousEoi == 0U, "no EOI is written for the spurious ID");
+	Check(ActiveDepth == 0U, "no interrupt is left active");
+	if (XSCUGIC_DRAIN_INTERRUPTS == 0) {
+		Check(Exceptions == Handled, "one exception per interrupt");
+	} else {
+		Check(Exceptions < Handled, "bursts share exceptions");
+	}
+	if (XSCUGIC_NESTED_INTERRUPTS == 0) {
+		Check(MaxDepth == 1U, "interrupts do not nest");
+	} else {
+		Check(MaxDepth > 1U, "higher priority interrupts nest");
+		Check(Sources[1].LatMax <= SIM_HIGH_BOUND,
+			"UART latency stays bounded");
+	}
+	SimCheckStats();
+
+	printf("\n%s\n", Failed == 0U ? "all checks passed" : "CHECKS FAILED");
+	return Failed == 0U ? 0 : 1;
+}
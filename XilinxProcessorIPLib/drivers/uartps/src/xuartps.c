@@ -49,6 +49,9 @@
 *                       baud rate. CR# 804281.
 * 3.00  kvn    02/13/15 Modified code for MISRA-C:2012 compliance.
 * 3.1	kvn    04/10/15 Modified code for latest RTL changes.
+* 3.2          10/18/26 XUartPs_SetBaudRate() checks the rate against the
+*                       divided reference clock and skips divisors that
+*                       give a zero BAUDGEN value.
 * </pre>
 *
 *****************************************************************************/
@@ -159,6 +162,10 @@ s32 XUartPs_CfgInitialize(XUartPs *InstancePtr,
 
 	InstancePtr->is_rxbs_error = 0U;
 
+	InstancePtr->RxRingPtr = NULL;
+	InstancePtr->TxRingPtr = NULL;
+	InstancePtr->RxTrigger = 0U;
+
 	/* Flag that the driver instance is ready to use */
 	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
 
@@ -544,13 +551,6 @@ s32 XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate)
 	Xil_AssertNonvoid(BaudRate <= (u32)XUARTPS_MAX_RATE);
 	Xil_AssertNonvoid(BaudRate >= (u32)XUARTPS_MIN_RATE);
 
-	/*
-	 * Make sure the baud rate is not impossilby large.
-	 * Fastest possible baud rate is Input Clock / 2.
-	 */
-	if ((BaudRate * 2) > InstancePtr->Config.InputClockHz) {
-		return XST_UART_BAUD_ERROR;
-	}
 	/* Check whether the input clock is divided by 8 */
 	ModeReg = XUartPs_ReadReg( InstancePtr->Config.BaseAddress,
 				 XUARTPS_MR_OFFSET);
@@ -560,14 +560,32 @@ s32 XUartPs_SetBaudRate(XUartPs *InstancePtr, u32 BaudRate)
 		InputClk = InstancePtr->Config.InputClockHz / 8;
 	}
 
+	/*
+	 * Make sure the baud rate is not impossibly large. The fastest
+	 * possible baud rate is Input Clock / (1 * (4 + 1)), the smallest
+	 * BAUDGEN and BAUDDIV values.
+	 */
+	if (BaudRate > (InputClk / 5U)) {
+		return XST_UART_BAUD_ERROR;
+	}
+
 	/*
 	 * Determine the Baud divider. It can be 4to 254.
 	 * Loop through all possible combinations
 	 */
 	for (IterBAUDDIV = 4; IterBAUDDIV < 255; IterBAUDDIV++) {
 
-		/* Calculate the value for BRGR register */
-		BRGR_Value = InputClk / (BaudRate * (IterBAUDDIV + 1));
+		/*
+		 * Calculate the value for BRGR register. Dividing in two
+		 * steps keeps BaudRate * (IterBAUDDIV + 1) from overflowing
+		 * at high rates.
+		 */
+		BRGR_Value = (InputClk / (IterBAUDDIV + 1)) / BaudRate;
+
+		/* A BRGR value of 0 disables the baud rate generator */
+		if (BRGR_Value == 0U) {
+			break;
+		}
 
 		/* Calculate the baud rate from the BRGR value */
 		CalcBaudRate = InputClk/ (BRGR_Value * (IterBAUDDIV + 1));
@@ -161,6 +161,9 @@
 *						platform variable in driver instance structure.
 * 3.1   adk   14/03/16  Include interrupt examples in the peripheral test when
 *			uart is connected to a valid interrupt controller CR#946803.
+* 3.2          10/18/26 Added the ring buffer mode. XUARTPS_MAX_RATE is the
+*                       rate the 100 MHz reference clock allows, the actual
+*                       clock is checked by XUartPs_SetBaudRate().
 *
 * </pre>
 *
@@ -184,11 +187,12 @@ extern "C" {
 /************************** Constant Definitions ****************************/
 
 /*
- * The following constants indicate the max and min baud rates and these
- * numbers are based only on the testing that has been done. The hardware
- * is capable of other baud rates.
+ * The following constants indicate the max and min baud rates. The max is
+ * the 100 MHz maximum of the reference clock divided by the smallest baud
+ * divisor, BAUDGEN 1 times BAUDDIV 4 + 1. Whether a rate is reachable with
+ * the actual reference clock is checked by XUartPs_SetBaudRate().
  */
-#define XUARTPS_MAX_RATE	 921600U
+#define XUARTPS_MAX_RATE	 20000000U
 #define XUARTPS_MIN_RATE	 110U
 
 #define XUARTPS_DFT_BAUDRATE  115200U   /* Default baud rate */
@@ -271,6 +275,18 @@ extern "C" {
 #define XUARTPS_EVENT_RECV_ORERR		7U /**< A receive overrun error detected */
 /*@}*/
 
+/** @name Ring Buffer Mode
+ *
+ * Depth of the hardware TX and RX FIFOs, and the RX trigger level and
+ * timeout (in units of 4 character times) XUartPs_RingStart() programs when
+ * passed 0.
+ * @{
+ */
+#define XUARTPS_FIFO_SIZE		64U
+#define XUARTPS_RING_DFT_RX_TRIGGER	32U
+#define XUARTPS_RING_DFT_RX_TIMEOUT	2U
+/*@}*/
+
 
 /**************************** Type Definitions ******************************/
 
@@ -292,6 +308,24 @@ typedef struct {
 	u32 RemainingBytes;
 } XUartPsBuffer;
 
+/**
+ * Ring buffer used by the ring buffer mode. Each ring has a single producer
+ * and a single consumer, one of them being the interrupt handler. Head and
+ * Tail are free running byte counts, Size must be a power of 2.
+ */
+typedef struct {
+	u8 *BufferPtr;		/**< Ring storage */
+	u32 Size;		/**< Size of the storage in bytes */
+	volatile u32 Head;	/**< Bytes written by the producer */
+	volatile u32 Tail;	/**< Bytes read by the consumer */
+	volatile u32 DroppedBytes; /**< RX bytes discarded because the ring
+				     *  was full */
+	volatile u32 OverrunCount; /**< RX FIFO overrun interrupts, each one
+				     *  is at least one byte lost in hardware */
+	volatile u32 ErrorCount;   /**< RX framing, parity and break
+				     *  interrupts */
+} XUartPs_Ring;
+
 /**
  * Keep track of data format setting of a device.
  */
@@ -339,6 +373,10 @@ typedef struct {
 	void *CallBackRef;	/* Callback reference for event handler */
 	u32 Platform;
 	u8 is_rxbs_error;
+
+	XUartPs_Ring *RxRingPtr;	/* RX ring, NULL unless in ring mode */
+	XUartPs_Ring *TxRingPtr;	/* TX ring, NULL unless in ring mode */
+	u8 RxTrigger;			/* RX FIFO trigger level in ring mode */
 } XUartPs;
 
 
@@ -500,6 +538,18 @@ void XUartPs_InterruptHandler(XUartPs *InstancePtr);
 void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr,
 			 void *CallBackRef);
 
+/* ring buffer mode functions in xuartps_ring.c */
+void XUartPs_RingInit(XUartPs_Ring *RingPtr, u8 *BufferPtr, u32 Size);
+
+s32 XUartPs_RingStart(XUartPs *InstancePtr, XUartPs_Ring *RxRingPtr,
+			XUartPs_Ring *TxRingPtr, u8 RxTrigger, u8 RxTimeout);
+
+void XUartPs_RingStop(XUartPs *InstancePtr);
+
+u32 XUartPs_RingRecv(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes);
+
+u32 XUartPs_RingSend(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes);
+
 /* self-test functions in xuartps_selftest.c */
 s32 XUartPs_SelfTest(XUartPs *InstancePtr);
 
@@ -73,6 +73,10 @@ static void ModemHandler(XUartPs *InstancePtr);
 extern u32 XUartPs_ReceiveBuffer(XUartPs *InstancePtr);
 extern u32 XUartPs_SendBuffer(XUartPs *InstancePtr);
 
+/* Internal function prototypes implemented in xuartps_ring.c */
+extern void XUartPs_RingReceiveHandler(XUartPs *InstancePtr, u32 IsrStatus);
+extern void XUartPs_RingSendHandler(XUartPs *InstancePtr);
+
 /************************** Variable Definitions ****************************/
 
 typedef void (*Handler)(XUartPs *InstancePtr);
@@ -184,6 +188,7 @@ void XUartPs_SetHandler(XUartPs *InstancePtr, XUartPs_Handler FuncPtr,
 void XUartPs_InterruptHandler(XUartPs *InstancePtr)
 {
 	u32 IsrStatus;
+	u32 Pending;
 
 	Xil_AssertVoid(InstancePtr != NULL);
 	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
@@ -198,32 +203,58 @@ void XUartPs_InterruptHandler(XUartPs *InstancePtr)
 	IsrStatus &= XUartPs_ReadReg(InstancePtr->Config.BaseAddress,
 				   XUARTPS_ISR_OFFSET);
 
+	Pending = IsrStatus;
+
+	/*
+	 * In ring buffer mode the data, error and timeout interrupts of the
+	 * ring's direction are all handled by the ring handlers.
+	 */
+	if (InstancePtr->RxRingPtr != NULL) {
+		if ((Pending & ((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXEMPTY |
+			(u32)XUARTPS_IXR_RXFULL | (u32)XUARTPS_IXR_TOUT |
+			(u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
+			(u32)XUARTPS_IXR_PARITY | (u32)XUARTPS_IXR_RBRK)) != (u32)0) {
+			XUartPs_RingReceiveHandler(InstancePtr, Pending);
+		}
+		Pending &= ~((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXEMPTY |
+			(u32)XUARTPS_IXR_RXFULL | (u32)XUARTPS_IXR_TOUT |
+			(u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
+			(u32)XUARTPS_IXR_PARITY | (u32)XUARTPS_IXR_RBRK);
+	}
+
+	if (InstancePtr->TxRingPtr != NULL) {
+		if ((Pending & (u32)XUARTPS_IXR_TXEMPTY) != (u32)0) {
+			XUartPs_RingSendHandler(InstancePtr);
+		}
+		Pending &= ~((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL);
+	}
+
 	/* Dispatch an appropriate handler. */
-	if((IsrStatus & ((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXEMPTY |
+	if((Pending & ((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_RXEMPTY |
 			(u32)XUARTPS_IXR_RXFULL)) != (u32)0) {
 		/* Received data interrupt */
 		ReceiveDataHandler(InstancePtr);
 	}
 
-	if((IsrStatus & ((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL))
+	if((Pending & ((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL))
 									 != (u32)0) {
 		/* Transmit data interrupt */
-		SendDataHandler(InstancePtr, IsrStatus);
+		SendDataHandler(InstancePtr, Pending);
 	}
 
 	/* XUARTPS_IXR_RBRK is applicable only for Zynq Ultrascale+ MP */
-	if ((IsrStatus & ((u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
+	if ((Pending & ((u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
 			(u32)XUARTPS_IXR_PARITY | (u32)XUARTPS_IXR_RBRK)) != (u32)0) {
 		/* Received Error Status interrupt */
-		ReceiveErrorHandler(InstancePtr, IsrStatus);
+		ReceiveErrorHandler(InstancePtr, Pending);
 	}
 
-	if((IsrStatus & ((u32)XUARTPS_IXR_TOUT)) != (u32)0) {
+	if((Pending & ((u32)XUARTPS_IXR_TOUT)) != (u32)0) {
 		/* Received Timeout interrupt */
 		ReceiveTimeoutHandler(InstancePtr);
 	}
 
-	if((IsrStatus & ((u32)XUARTPS_IXR_DMS)) != (u32)0) {
+	if((Pending & ((u32)XUARTPS_IXR_DMS)) != (u32)0) {
 		/* Modem status interrupt */
 		ModemHandler(InstancePtr);
 	}
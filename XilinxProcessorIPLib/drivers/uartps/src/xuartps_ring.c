@@ -0,0 +1,519 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/****************************************************************************/
+/**
+*
+* @file xuartps_ring.c
+* @addtogroup uartps_v3_1
+* @{
+*
+* This file contains the ring buffer mode of the driver.
+*
+* In ring buffer mode received data is moved by the interrupt handler into a
+* caller supplied ring, whether or not the application is currently waiting
+* for it, so a late reader loses nothing as long as the ring does not fill.
+* Bytes that do not fit are counted rather than silently lost. Data to send
+* is queued into a second ring and the interrupt handler refills the TX FIFO
+* from it, a whole FIFO at a time when the FIFO is empty.
+*
+* The RX FIFO trigger level and receive timeout are programmed when the mode
+* is started: a higher trigger means fewer interrupts, the timeout bounds the
+* latency of the bytes left below the trigger at the end of a burst.
+*
+* Each ring has one producer and one consumer, one of them being the
+* interrupt handler, so no locking is needed when the application and the
+* interrupt handler run on the same processor. XUartPs_Send() and
+* XUartPs_Recv() must not be used for a direction that is in ring mode.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date	Changes
+* ----- ------ -------- -----------------------------------------------
+* 3.2          10/18/26 First Release
+* </pre>
+*
+*****************************************************************************/
+
+/***************************** Include Files ********************************/
+
+#include "xuartps.h"
+
+/************************** Constant Definitions ****************************/
+
+/**************************** Type Definitions ******************************/
+
+/***************** Macros (Inline Functions) Definitions ********************/
+
+/************************** Function Prototypes *****************************/
+
+void XUartPs_RingReceiveHandler(XUartPs *InstancePtr, u32 IsrStatus);
+void XUartPs_RingSendHandler(XUartPs *InstancePtr);
+static u32 XUartPs_RingFill(XUartPs *InstancePtr);
+
+/************************** Variable Definitions ****************************/
+
+/****************************************************************************/
+/**
+*
+* This function initializes a ring for use with XUartPs_RingStart().
+*
+* @param	RingPtr is a pointer to the ring.
+* @param	BufferPtr is the storage for the ring.
+* @param	Size is the size of the storage in bytes, a power of 2.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_RingInit(XUartPs_Ring *RingPtr, u8 *BufferPtr, u32 Size)
+{
+	/* Assert validates the input arguments */
+	Xil_AssertVoid(RingPtr != NULL);
+	Xil_AssertVoid(BufferPtr != NULL);
+	Xil_AssertVoid((Size != 0U) && ((Size & (Size - 1U)) == 0U));
+
+	RingPtr->BufferPtr = BufferPtr;
+	RingPtr->Size = Size;
+	RingPtr->Head = 0U;
+	RingPtr->Tail = 0U;
+	RingPtr->DroppedBytes = 0U;
+	RingPtr->OverrunCount = 0U;
+	RingPtr->ErrorCount = 0U;
+}
+
+/****************************************************************************/
+/**
+*
+* This function puts one or both directions of the UART in ring buffer mode
+* and enables the interrupts that mode needs. The interrupt handler of the
+* driver must be connected to the interrupt system.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	RxRingPtr is the ring received data is stored into, or NULL to
+*		leave the receive direction as it is.
+* @param	TxRingPtr is the ring data to be sent is taken from, or NULL to
+*		leave the transmit direction as it is.
+* @param	RxTrigger is the RX FIFO trigger level, 1 to 63, or 0 for
+*		XUARTPS_RING_DFT_RX_TRIGGER.
+* @param	RxTimeout is the receive timeout in units of 4 character
+*		times, or 0 for XUARTPS_RING_DFT_RX_TIMEOUT.
+*
+* @return	XST_SUCCESS.
+*
+* @note		The application handler, if set, is called with
+*		XUARTPS_EVENT_RECV_DATA and the number of bytes taken from the
+*		FIFO on every receive interrupt, with XUARTPS_EVENT_RECV_ORERR
+*		or XUARTPS_EVENT_RECV_ERROR and the matching count when the
+*		receiver reports errors, and with XUARTPS_EVENT_SENT_DATA and
+*		the number of bytes written by that interrupt when the TX ring
+*		has been emptied.
+*
+*****************************************************************************/
+s32 XUartPs_RingStart(XUartPs *InstancePtr, XUartPs_Ring *RxRingPtr,
+			XUartPs_Ring *TxRingPtr, u8 RxTrigger, u8 RxTimeout)
+{
+	u32 Mask;
+	u8 Trigger = RxTrigger;
+	u8 Timeout = RxTimeout;
+
+	/* Assert validates the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+	Xil_AssertNonvoid((RxRingPtr != NULL) || (TxRingPtr != NULL));
+	Xil_AssertNonvoid(RxTrigger < (u8)XUARTPS_FIFO_SIZE);
+
+	Mask = XUartPs_GetInterruptMask(InstancePtr);
+
+	if (RxRingPtr != NULL) {
+		if (Trigger == 0U) {
+			Trigger = (u8)XUARTPS_RING_DFT_RX_TRIGGER;
+		}
+		if (Timeout == 0U) {
+			Timeout = (u8)XUARTPS_RING_DFT_RX_TIMEOUT;
+		}
+
+		XUartPs_SetFifoThreshold(InstancePtr, Trigger);
+		XUartPs_SetRecvTimeout(InstancePtr, Timeout);
+
+		InstancePtr->RxTrigger = Trigger;
+		InstancePtr->RxRingPtr = RxRingPtr;
+
+		Mask |= (u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_TOUT |
+			(u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
+			(u32)XUARTPS_IXR_PARITY;
+		Mask &= ~((u32)XUARTPS_IXR_RXEMPTY | (u32)XUARTPS_IXR_RXFULL);
+
+		/* XUARTPS_IXR_RBRK is applicable only for Zynq Ultrascale+ MP */
+		if (InstancePtr->Platform == XPLAT_ZYNQ_ULTRA_MP) {
+			Mask |= (u32)XUARTPS_IXR_RBRK;
+		}
+	}
+
+	if (TxRingPtr != NULL) {
+		InstancePtr->TxRingPtr = TxRingPtr;
+
+		/* The TX interrupt is only enabled while there is data to send */
+		Mask &= ~((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL);
+	}
+
+	XUartPs_SetInterruptMask(InstancePtr, Mask);
+
+	/*
+	 * The TX empty interrupt is only raised when the FIFO becomes empty,
+	 * so data already in the ring is written to the FIFO here.
+	 */
+	if ((TxRingPtr != NULL) && (TxRingPtr->Head != TxRingPtr->Tail)) {
+		(void)XUartPs_RingFill(InstancePtr);
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				XUARTPS_IER_OFFSET, (u32)XUARTPS_IXR_TXEMPTY);
+	}
+
+	return (s32)XST_SUCCESS;
+}
+
+/****************************************************************************/
+/**
+*
+* This function takes the UART out of ring buffer mode and disables the
+* interrupts that mode enabled. Data still in the rings is left there.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_RingStop(XUartPs *InstancePtr)
+{
+	u32 Mask;
+
+	/* Assert validates the input arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(InstancePtr->IsReady == XIL_COMPONENT_IS_READY);
+
+	Mask = XUartPs_GetInterruptMask(InstancePtr);
+
+	if (InstancePtr->RxRingPtr != NULL) {
+		Mask &= ~((u32)XUARTPS_IXR_RXOVR | (u32)XUARTPS_IXR_TOUT |
+			(u32)XUARTPS_IXR_OVER | (u32)XUARTPS_IXR_FRAMING |
+			(u32)XUARTPS_IXR_PARITY | (u32)XUARTPS_IXR_RBRK);
+	}
+	if (InstancePtr->TxRingPtr != NULL) {
+		Mask &= ~((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL);
+	}
+
+	XUartPs_SetInterruptMask(InstancePtr, Mask);
+
+	InstancePtr->RxRingPtr = NULL;
+	InstancePtr->TxRingPtr = NULL;
+}
+
+/****************************************************************************/
+/**
+*
+* This function copies received data out of the RX ring. It is non-blocking.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	BufferPtr is the buffer the data is copied to.
+* @param	NumBytes is the size of the buffer.
+*
+* @return	The number of bytes copied, 0 if the ring is empty.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingRecv(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes)
+{
+	XUartPs_Ring *RingPtr;
+	u32 Tail;
+	u32 Count;
+	u32 Index;
+
+	/* Assert validates the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(BufferPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->RxRingPtr != NULL);
+
+	RingPtr = InstancePtr->RxRingPtr;
+	Tail = RingPtr->Tail;
+
+	Count = RingPtr->Head - Tail;
+	if (Count > NumBytes) {
+		Count = NumBytes;
+	}
+
+	for (Index = 0U; Index < Count; Index++) {
+		BufferPtr[Index] =
+			RingPtr->BufferPtr[(Tail + Index) & (RingPtr->Size - 1U)];
+	}
+
+	/* Only hand the space back once the bytes have been copied out */
+	RingPtr->Tail = Tail + Count;
+
+	return Count;
+}
+
+/****************************************************************************/
+/**
+*
+* This function queues data into the TX ring and makes sure the transmit
+* interrupt is enabled to send it. It is non-blocking.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	BufferPtr is the data to be sent.
+* @param	NumBytes is the number of bytes to be sent.
+*
+* @return	The number of bytes queued, which is less than NumBytes if the
+*		ring does not have room for all of them.
+*
+* @note		None.
+*
+*****************************************************************************/
+u32 XUartPs_RingSend(XUartPs *InstancePtr, u8 *BufferPtr, u32 NumBytes)
+{
+	XUartPs_Ring *RingPtr;
+	u32 Head;
+	u32 Count;
+	u32 Index;
+
+	/* Assert validates the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(BufferPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->TxRingPtr != NULL);
+
+	RingPtr = InstancePtr->TxRingPtr;
+	Head = RingPtr->Head;
+
+	Count = RingPtr->Size - (Head - RingPtr->Tail);
+	if (Count > NumBytes) {
+		Count = NumBytes;
+	}
+
+	for (Index = 0U; Index < Count; Index++) {
+		RingPtr->BufferPtr[(Head + Index) & (RingPtr->Size - 1U)] =
+			BufferPtr[Index];
+	}
+
+	RingPtr->Head = Head + Count;
+
+	/*
+	 * The TX empty interrupt is only raised when the FIFO becomes empty,
+	 * so an idle transmitter has to be started here. As in XUartPs_Send(),
+	 * the interrupt is disabled while the FIFO is topped up, which keeps
+	 * the interrupt handler away from Tail, and enabled again afterwards.
+	 */
+	if (Count != 0U) {
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				XUARTPS_IDR_OFFSET, (u32)XUARTPS_IXR_TXEMPTY);
+		(void)XUartPs_RingFill(InstancePtr);
+		XUartPs_WriteReg(InstancePtr->Config.BaseAddress,
+				XUARTPS_IER_OFFSET, (u32)XUARTPS_IXR_TXEMPTY);
+	}
+
+	return Count;
+}
+
+/****************************************************************************/
+/*
+*
+* This function handles the receive interrupts in ring buffer mode. It drains
+* the RX FIFO into the RX ring. While the FIFO is at or above the trigger
+* level that many bytes are read without checking the status register in
+* between.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+* @param	IsrStatus is the pending interrupt status.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_RingReceiveHandler(XUartPs *InstancePtr, u32 IsrStatus)
+{
+	XUartPs_Ring *RingPtr = InstancePtr->RxRingPtr;
+	u32 BaseAddress = InstancePtr->Config.BaseAddress;
+	u32 Head = RingPtr->Head;
+	u32 Free = RingPtr->Size - (Head - RingPtr->Tail);
+	u32 ReceivedCount = 0U;
+	u32 Burst;
+	u32 CsrRegister;
+	u8 Data;
+
+	if ((IsrStatus & (u32)XUARTPS_IXR_OVER) != (u32)0) {
+		RingPtr->OverrunCount++;
+	}
+	if ((IsrStatus & ((u32)XUARTPS_IXR_FRAMING | (u32)XUARTPS_IXR_PARITY |
+			(u32)XUARTPS_IXR_RBRK)) != (u32)0) {
+		RingPtr->ErrorCount++;
+	}
+
+	for (;;) {
+		CsrRegister = XUartPs_ReadReg(BaseAddress, XUARTPS_SR_OFFSET);
+
+		if ((CsrRegister & (u32)XUARTPS_SR_RXOVR) != (u32)0) {
+			/* At least RxTrigger bytes are in the FIFO */
+			Burst = InstancePtr->RxTrigger;
+		} else if ((CsrRegister & (u32)XUARTPS_SR_RXEMPTY) == (u32)0) {
+			Burst = 1U;
+		} else {
+			break;
+		}
+
+		ReceivedCount += Burst;
+
+		while (Burst != 0U) {
+			Data = (u8)XUartPs_ReadReg(BaseAddress,
+						XUARTPS_FIFO_OFFSET);
+			if (Free != 0U) {
+				RingPtr->BufferPtr[Head & (RingPtr->Size - 1U)] =
+					Data;
+				Head++;
+				Free--;
+			} else {
+				/* Keep draining so the FIFO does not overrun */
+				RingPtr->DroppedBytes++;
+			}
+			Burst--;
+		}
+	}
+
+	/* Publish the new data only once it is in the ring */
+	RingPtr->Head = Head;
+
+	if (ReceivedCount != (u32)0) {
+		InstancePtr->Handler(InstancePtr->CallBackRef,
+				XUARTPS_EVENT_RECV_DATA, ReceivedCount);
+	}
+
+	if ((IsrStatus & (u32)XUARTPS_IXR_OVER) != (u32)0) {
+		InstancePtr->Handler(InstancePtr->CallBackRef,
+				XUARTPS_EVENT_RECV_ORERR,
+				RingPtr->OverrunCount);
+	}
+
+	if ((IsrStatus & ((u32)XUARTPS_IXR_FRAMING | (u32)XUARTPS_IXR_PARITY |
+			(u32)XUARTPS_IXR_RBRK)) != (u32)0) {
+		InstancePtr->Handler(InstancePtr->CallBackRef,
+				XUARTPS_EVENT_RECV_ERROR,
+				RingPtr->ErrorCount);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* This function handles the TX empty interrupt in ring buffer mode. As the
+* FIFO is empty, up to XUARTPS_FIFO_SIZE bytes are written without checking
+* the status register between them. The interrupt is disabled once the ring
+* is empty.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*****************************************************************************/
+void XUartPs_RingSendHandler(XUartPs *InstancePtr)
+{
+	XUartPs_Ring *RingPtr = InstancePtr->TxRingPtr;
+	u32 BaseAddress = InstancePtr->Config.BaseAddress;
+	u32 Tail = RingPtr->Tail;
+	u32 Available = RingPtr->Head - Tail;
+	u32 SentCount = 0U;
+	u32 Index;
+
+	if ((XUartPs_ReadReg(BaseAddress, XUARTPS_SR_OFFSET) &
+			(u32)XUARTPS_SR_TXEMPTY) != (u32)0) {
+		SentCount = (Available < XUARTPS_FIFO_SIZE) ?
+				Available : XUARTPS_FIFO_SIZE;
+
+		for (Index = 0U; Index < SentCount; Index++) {
+			XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+				(u32)RingPtr->BufferPtr[Tail &
+						(RingPtr->Size - 1U)]);
+			Tail++;
+		}
+		RingPtr->Tail = Tail;
+	} else {
+		/* Not empty yet, top the FIFO up until it is full */
+		SentCount = XUartPs_RingFill(InstancePtr);
+	}
+
+	if (SentCount == Available) {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_IDR_OFFSET,
+				((u32)XUARTPS_IXR_TXEMPTY | (u32)XUARTPS_IXR_TXFULL));
+
+		InstancePtr->Handler(InstancePtr->CallBackRef,
+				XUARTPS_EVENT_SENT_DATA, SentCount);
+	}
+}
+
+/****************************************************************************/
+/*
+*
+* This function writes data from the TX ring to the TX FIFO until the FIFO is
+* full or the ring is empty. The caller must make sure the interrupt handler
+* does not run the TX path at the same time.
+*
+* @param	InstancePtr is a pointer to the XUartPs instance.
+*
+* @return	The number of bytes written.
+*
+* @note		None.
+*
+*****************************************************************************/
+static u32 XUartPs_RingFill(XUartPs *InstancePtr)
+{
+	XUartPs_Ring *RingPtr = InstancePtr->TxRingPtr;
+	u32 BaseAddress = InstancePtr->Config.BaseAddress;
+	u32 Tail = RingPtr->Tail;
+	u32 Available = RingPtr->Head - Tail;
+	u32 SentCount = 0U;
+
+	while ((SentCount < Available) &&
+		(!XUartPs_IsTransmitFull(BaseAddress))) {
+		XUartPs_WriteReg(BaseAddress, XUARTPS_FIFO_OFFSET,
+			(u32)RingPtr->BufferPtr[Tail & (RingPtr->Size - 1U)]);
+		Tail++;
+		SentCount++;
+	}
+
+	RingPtr->Tail = Tail;
+
+	return SentCount;
+}
+/** @} */
@@ -0,0 +1,618 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xuartps_ring_sim.c
+*
+* Host test of the ring buffer mode of the UART PS driver against a register
+* model of the UART in loopback, and of XUartPs_SetBaudRate() up to the
+* highest rates.
+*
+* The model keeps the 64 byte TX and RX FIFOs, the interrupt registers, the
+* RX trigger level and the receive timeout. A byte written to the TX FIFO is
+* moved to the shift register as soon as the transmitter is idle and arrives
+* in the RX FIFO one character time (10 bits) later. As on the hardware, the
+* status bits of the TX empty and RX trigger interrupts are set when the FIFO
+* becomes empty or reaches the trigger level, not while it is. A byte that
+* arrives with the RX FIFO full is lost and raises the overrun interrupt. The
+* interrupt handler of the driver runs a fixed latency after an enabled
+* interrupt is raised.
+*
+* The application queues a pattern into the TX ring whenever there is room
+* and periodically copies the RX ring out. The checks are that:
+*  - XUartPs_SetBaudRate() reaches 4 Mbaud and 20 Mbaud from a 100 MHz
+*    reference clock within the allowed error, and rejects rates above a
+*    fifth of the reference clock,
+*  - at 4 Mbaud with a reader that keeps up, every byte arrives in order and
+*    the line stays busy,
+*  - with a slow reader the bytes that do not fit in the RX ring are counted
+*    as dropped, and with an interrupt latency longer than the RX FIFO the
+*    lost bytes raise overrun events, so no byte is unaccounted for,
+*  - a message shorter than the trigger level is delivered by the receive
+*    timeout,
+*  - a framing error is counted and reported to the event handler.
+*
+* Usage: xuartps_ring_sim [MiB at 4 Mbaud] [interrupt latency in us]
+*
+* The defaults are 1 MiB and 2 us.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 3.2        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xuartps.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE	0xFF000000U	/* UART registers */
+#define SIM_REGS	0x50U		/* Size of the register space */
+#define SIM_FIFO	XUARTPS_FIFO_SIZE
+#define SIM_REF_HZ	100000000U	/* Reference clock */
+#define SIM_NEVER	(~(u64t)0U)
+#define SIM_RING	4096U		/* Default RX and TX ring size */
+#define SIM_CHUNK	1000U		/* Most bytes queued per call */
+#define SIM_MAX_ERROR	3U		/* % baud rate error xuartps.c allows */
+
+/**************************** Type Definitions *******************************/
+
+typedef unsigned long long u64t;
+
+typedef struct {
+	const char *Name;
+	u32 Baud;
+	u32 Total;		/* Bytes sent */
+	u32 RxRingSize;
+	u64t ReadPeriod;	/* ns between two reads of the RX ring */
+	u64t IrqLatency;	/* ns */
+	u32 Lossy;		/* Loss is expected */
+} SimRun;
+
+/************************** Variable Definitions *****************************/
+
+static u32 SimReg[SIM_REGS / 4U];
+static u8 TxFifo[SIM_FIFO];
+static u32 TxHead;
+static u32 TxCount;
+static u8 RxFifo[SIM_FIFO];
+static u32 RxHead;
+static u32 RxCount;
+static u8 TxShift;
+
+static u64t SimNow;
+static u64t CharNs;
+static u64t TxDoneAt = SIM_NEVER;
+static u64t TimeoutAt = SIM_NEVER;
+static u64t IrqAt = SIM_NEVER;
+static u64t IrqLatency = 2000U;
+static u32 InHandler;
+
+static u32 Interrupts;
+static u32 WireBytes;
+static u32 HwLost;
+static u32 Errors;
+
+static u32 EvRecvBytes;
+static u32 EvSent;
+static u32 EvOverruns;
+static u32 EvErrors;
+
+static XUartPs Uart;
+static XUartPs_Config UartConfig = { 0U, SIM_BASE, SIM_REF_HZ, 0 };
+static XUartPs_Ring RxRing;
+static XUartPs_Ring TxRing;
+static u8 RxStore[SIM_RING];
+static u8 TxStore[SIM_RING];
+static u8 *Pattern;
+
+/*****************************************************************************/
+
+static void SimFail(const char *What, u32 Value)
+{
+	printf("FAIL: %s (%u)\n", What, Value);
+	Errors++;
+}
+
+u32 XGetPlatform_Info(void)
+{
+	return XPLAT_ZYNQ_ULTRA_MP;
+}
+
+static u32 SimTrigger(void)
+{
+	return SimReg[XUARTPS_RXWM_OFFSET / 4U] & XUARTPS_RXWM_MASK;
+}
+
+static u32 SimStatus(void)
+{
+	u32 Status = 0U;
+
+	if (RxCount == 0U) {
+		Status |= XUARTPS_SR_RXEMPTY;
+	}
+	if ((SimTrigger() != 0U) && (RxCount >= SimTrigger())) {
+		Status |= XUARTPS_SR_RXOVR;
+	}
+	if (RxCount == SIM_FIFO) {
+		Status |= XUARTPS_SR_RXFULL;
+	}
+	if (TxCount == 0U) {
+		Status |= XUARTPS_SR_TXEMPTY;
+	}
+	if (TxCount == SIM_FIFO) {
+		Status |= XUARTPS_SR_TXFULL;
+	}
+
+	return Status;
+}
+
+static void SimCheckIrq(void)
+{
+	if ((InHandler == 0U) && (IrqAt == SIM_NEVER) &&
+			((SimReg[XUARTPS_ISR_OFFSET / 4U] &
+			  SimReg[XUARTPS_IMR_OFFSET / 4U]) != 0U)) {
+		IrqAt = SimNow + IrqLatency;
+	}
+}
+
+static void SimRaise(u32 Mask)
+{
+	SimReg[XUARTPS_ISR_OFFSET / 4U] |= Mask;
+	SimCheckIrq();
+}
+
+/*
+ * Moves the next byte of the TX FIFO to the shift register. The FIFO
+ * becoming empty raises the TX empty interrupt.
+ */
+static void SimTxStart(void)
+{
+	if ((TxDoneAt != SIM_NEVER) || (TxCount == 0U)) {
+		return;
+	}
+	TxShift = TxFifo[TxHead];
+	TxHead = (TxHead + 1U) % SIM_FIFO;
+	TxCount--;
+	TxDoneAt = SimNow + CharNs;
+	if (TxCount == 0U) {
+		SimRaise(XUARTPS_IXR_TXEMPTY);
+	}
+}
+
+static void SimRxByte(u8 Data)
+{
+	u32 Timeout = SimReg[XUARTPS_RXTOUT_OFFSET / 4U] & XUARTPS_RXTOUT_MASK;
+
+	if (RxCount == SIM_FIFO) {
+		HwLost++;
+		SimRaise(XUARTPS_IXR_OVER);
+		return;
+	}
+	RxFifo[(RxHead + RxCount) % SIM_FIFO] = Data;
+	RxCount++;
+	TimeoutAt = (Timeout != 0U) ? SimNow + (4U * Timeout * CharNs) :
+					SIM_NEVER;
+	if (RxCount == SimTrigger()) {
+		SimRaise(XUARTPS_IXR_RXOVR);
+	}
+	if (RxCount == SIM_FIFO) {
+		SimRaise(XUARTPS_IXR_RXFULL);
+	}
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Offset = (u32)(Addr - SIM_BASE);
+	u32 Value;
+
+	switch (Offset) {
+	case XUARTPS_SR_OFFSET:
+		return SimStatus();
+	case XUARTPS_FIFO_OFFSET:
+		if (RxCount == 0U) {
+			return 0U;
+		}
+		Value = RxFifo[RxHead];
+		RxHead = (RxHead + 1U) % SIM_FIFO;
+		RxCount--;
+		return Value;
+	default:
+		return SimReg[Offset / 4U];
+	}
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset = (u32)(Addr - SIM_BASE);
+
+	switch (Offset) {
+	case XUARTPS_IER_OFFSET:
+		SimReg[XUARTPS_IMR_OFFSET / 4U] |= Value & XUARTPS_IXR_MASK;
+		break;
+	case XUARTPS_IDR_OFFSET:
+		SimReg[XUARTPS_IMR_OFFSET / 4U] &= ~Value;
+		break;
+	case XUARTPS_ISR_OFFSET:
+		SimReg[XUARTPS_ISR_OFFSET / 4U] &= ~Value;
+		break;
+	case XUARTPS_FIFO_OFFSET:
+		if (TxCount == SIM_FIFO) {
+			SimRaise(XUARTPS_IXR_TOVR);
+			break;
+		}
+		TxFifo[(TxHead + TxCount) % SIM_FIFO] = (u8)Value;
+		TxCount++;
+		SimTxStart();
+		break;
+	case XUARTPS_SR_OFFSET:
+	case XUARTPS_IMR_OFFSET:
+		break;
+	default:
+		SimReg[Offset / 4U] = Value;
+		break;
+	}
+	SimCheckIrq();
+}
+
+/*
+ * Runs the model until Until: bytes leave the shift register, the receive
+ * timeout expires and the interrupt handler runs.
+ */
+static void SimAdvance(u64t Until)
+{
+	u64t Next;
+
+	for (;;) {
+		Next = TxDoneAt;
+		if (TimeoutAt < Next) {
+			Next = TimeoutAt;
+		}
+		if (IrqAt < Next) {
+			Next = IrqAt;
+		}
+		if (Next > Until) {
+			break;
+		}
+		SimNow = Next;
+
+		if (Next == IrqAt) {
+			IrqAt = SIM_NEVER;
+			Interrupts++;
+			InHandler = 1U;
+			XUartPs_InterruptHandler(&Uart);
+			InHandler = 0U;
+			SimCheckIrq();
+		} else if (Next == TxDoneAt) {
+			TxDoneAt = SIM_NEVER;
+			WireBytes++;
+			SimRxByte(TxShift);
+			SimTxStart();
+		} else {
+			TimeoutAt = SIM_NEVER;
+			SimRaise(XUARTPS_IXR_TOUT);
+		}
+	}
+	SimNow = Until;
+}
+
+static void EventHandler(void *CallBackRef, u32 Event, u32 EventData)
+{
+	(void)CallBackRef;
+
+	switch (Event) {
+	case XUARTPS_EVENT_RECV_DATA:
+		EvRecvBytes += EventData;
+		break;
+	case XUARTPS_EVENT_SENT_DATA:
+		EvSent++;
+		break;
+	case XUARTPS_EVENT_RECV_ORERR:
+		EvOverruns++;
+		break;
+	case XUARTPS_EVENT_RECV_ERROR:
+		EvErrors++;
+		break;
+	default:
+		SimFail("unexpected event", Event);
+		break;
+	}
+}
+
+/*
+ * Resets the model and the driver and starts ring mode at Baud with an RX
+ * ring of RxSize bytes.
+ */
+static void SimReset(u32 Baud, u32 RxSize, u64t Latency)
+{
+	memset(SimReg, 0, sizeof(SimReg));
+	TxHead = 0U;
+	TxCount = 0U;
+	RxHead = 0U;
+	RxCount = 0U;
+	SimNow = 0U;
+	TxDoneAt = SIM_NEVER;
+	TimeoutAt = SIM_NEVER;
+	IrqAt = SIM_NEVER;
+	IrqLatency = Latency;
+	Interrupts = 0U;
+	WireBytes = 0U;
+	HwLost = 0U;
+	EvRecvBytes = 0U;
+	EvSent = 0U;
+	EvOverruns = 0U;
+	EvErrors = 0U;
+
+	memset(&Uart, 0, sizeof(Uart));
+	if (XUartPs_CfgInitialize(&Uart, &UartConfig, SIM_BASE) !=
+			XST_SUCCESS ||
+			XUartPs_SetBaudRate(&Uart, Baud) != XST_SUCCESS) {
+		SimFail("UART setup at baud", Baud);
+	}
+	CharNs = (10ULL * 1000000000ULL) / Baud;
+
+	XUartPs_SetHandler(&Uart, EventHandler, NULL);
+	XUartPs_RingInit(&RxRing, RxStore, RxSize);
+	XUartPs_RingInit(&TxRing, TxStore, SIM_RING);
+	(void)XUartPs_RingStart(&Uart, &RxRing, &TxRing, 0U, 0U);
+}
+
+static u32 TestBaudRates(void)
+{
+	static const u32 Rates[] = { 115200U, 921600U, 4000000U, 12500000U,
+				     20000000U };
+	u32 StartErrors = Errors;
+	u32 Index;
+	u32 Divisor;
+	u32 Actual;
+
+	printf("%10s %8s %8s %10s\n", "baud", "BAUDGEN", "BAUDDIV", "actual");
+	for (Index = 0U; Index < sizeof(Rates) / sizeof(Rates[0]); Index++) {
+		memset(SimReg, 0, sizeof(SimReg));
+		memset(&Uart, 0, sizeof(Uart));
+		UartConfig.InputClockHz = SIM_REF_HZ;
+		if ((XUartPs_CfgInitialize(&Uart, &UartConfig, SIM_BASE) !=
+				XST_SUCCESS) ||
+				(XUartPs_SetBaudRate(&Uart, Rates[Index]) !=
+				XST_SUCCESS)) {
+			SimFail("rate rejected", Rates[Index]);
+			continue;
+		}
+		Divisor = SimReg[XUARTPS_BAUDGEN_OFFSET / 4U] *
+			(SimReg[XUARTPS_BAUDDIV_OFFSET / 4U] + 1U);
+		Actual = SIM_REF_HZ / Divisor;
+		printf("%10u %8u %8u %10u\n", Rates[Index],
+			SimReg[XUARTPS_BAUDGEN_OFFSET / 4U],
+			SimReg[XUARTPS_BAUDDIV_OFFSET / 4U], Actual);
+		if ((SimReg[XUARTPS_BAUDDIV_OFFSET / 4U] < 4U) ||
+				((Actual > Rates[Index] ?
+				  Actual - Rates[Index] :
+				  Rates[Index] - Actual) * 100U >
+				 Rates[Index] * SIM_MAX_ERROR)) {
+			SimFail("baud rate error too large", Rates[Index]);
+		}
+	}
+
+	/* A fifth of the reference clock is the fastest rate */
+	UartConfig.InputClockHz = 50000000U;
+	memset(SimReg, 0, sizeof(SimReg));
+	memset(&Uart, 0, sizeof(Uart));
+	(void)XUartPs_CfgInitialize(&Uart, &UartConfig, SIM_BASE);
+	if (XUartPs_SetBaudRate(&Uart, 20000000U) != XST_UART_BAUD_ERROR) {
+		SimFail("20 Mbaud accepted from a 50 MHz clock", 0U);
+	}
+	if (Uart.BaudRate != XUARTPS_DFT_BAUDRATE) {
+		SimFail("rejected rate changed the setting", Uart.BaudRate);
+	}
+	UartConfig.InputClockHz = SIM_REF_HZ;
+	printf("\n");
+
+	return Errors - StartErrors;
+}
+
+static u32 RunStream(const SimRun *Run)
+{
+	static u8 Buf[SIM_RING];
+	u32 StartErrors = Errors;
+	u32 Sent = 0U;
+	u32 Received = 0U;
+	u32 Count;
+	u32 Index;
+	u64t NextRead;
+	u64t Deadline;
+	u64t Ideal;
+	u32 Lost;
+
+	SimReset(Run->Baud, Run->RxRingSize, Run->IrqLatency);
+	Ideal = (u64t)Run->Total * CharNs;
+	Deadline = 2U * Ideal + 10000000U;
+	NextRead = Run->ReadPeriod;
+
+	while (SimNow < Deadline) {
+		if (Sent < Run->Total) {
+			Count = Run->Total - Sent;
+			if (Count > SIM_CHUNK) {
+				Count = SIM_CHUNK;
+			}
+			Sent += XUartPs_RingSend(&Uart, &Pattern[Sent], Count);
+		}
+		if (SimNow >= NextRead) {
+			NextRead += Run->ReadPeriod;
+			Count = XUartPs_RingRecv(&Uart, Buf, sizeof(Buf));
+			if ((Run->Lossy == 0U) &&
+					(memcmp(Buf, &Pattern[Received], Count) !=
+					 0)) {
+				for (Index = 0U; Buf[Index] ==
+					Pattern[Received + Index]; Index++) {
+				}
+				SimFail("data mismatch at byte",
+					Received + Index);
+				break;
+			}
+			Received += Count;
+		}
+		Lost = RxRing.DroppedBytes + HwLost;
+		if ((Sent == Run->Total) && (TxDoneAt == SIM_NEVER) &&
+				(Received + Lost == Run->Total)) {
+			break;
+		}
+		SimAdvance(SimNow + 10000U);
+	}
+	Lost = RxRing.DroppedBytes + HwLost;
+
+	printf("%-28s %8.2f %7.3f %8u %8u %8u %5u\n", Run->Name,
+		(double)Interrupts * 1024.0 / Run->Total,
+		(double)SimNow / Ideal, RxRing.DroppedBytes, HwLost,
+		RxRing.OverrunCount, EvSent);
+
+	if (Received + Lost != Run->Total) {
+		SimFail("bytes unaccounted for", Run->Total - Received - Lost);
+	}
+	if (EvRecvBytes != Received + RxRing.DroppedBytes) {
+		SimFail("RECV_DATA events do not match the bytes read",
+			EvRecvBytes);
+	}
+	if (EvOverruns != RxRing.OverrunCount) {
+		SimFail("RECV_ORERR events do not match the overruns",
+			EvOverruns);
+	}
+	if ((HwLost != 0U) && (RxRing.OverrunCount == 0U)) {
+		SimFail("bytes lost in the FIFO without an overrun", HwLost);
+	}
+	if (Run->Lossy == 0U) {
+		if (Lost != 0U) {
+			SimFail("bytes lost", Lost);
+		}
+		/* The line stays busy apart from the interrupt latency */
+		if (SimNow > Ideal + (Ideal / 50U) + 1000000U) {
+			SimFail("line idle, ns", (u32)(SimNow - Ideal));
+		}
+	} else if (Lost == 0U) {
+		SimFail("expected loss did not happen", 0U);
+	}
+
+	return Errors - StartErrors;
+}
+
+static u32 TestTimeout(void)
+{
+	u8 Buf[16];
+	u32 StartErrors = Errors;
+	u32 Count = 0U;
+	u64t Limit;
+
+	SimReset(115200U, SIM_RING, 2000U);
+	(void)XUartPs_RingSend(&Uart, Pattern, 10U);
+
+	/* 10 characters, the timeout of 2 * 4 characters and the latency */
+	Limit = (10U + 8U + 1U) * CharNs + IrqLatency;
+	while ((Count == 0U) && (SimNow < 2U * Limit)) {
+		SimAdvance(SimNow + 1000U);
+		Count = XUartPs_RingRecv(&Uart, Buf, sizeof(Buf));
+	}
+	printf("10 bytes at 115200 baud below the trigger: delivered after "
+		"%llu us\n", SimNow / 1000U);
+	if ((Count != 10U) || (memcmp(Buf, Pattern, 10U) != 0)) {
+		SimFail("short message not delivered, bytes", Count);
+	} else if (SimNow > Limit) {
+		SimFail("short message late, us", (u32)(SimNow / 1000U));
+	}
+
+	/* A framing error is counted and reported */
+	SimRaise(XUARTPS_IXR_FRAMING);
+	SimAdvance(SimNow + 10000U);
+	if ((RxRing.ErrorCount != 1U) || (EvErrors != 1U)) {
+		SimFail("framing error not reported", RxRing.ErrorCount);
+	}
+	printf("\n");
+
+	return Errors - StartErrors;
+}
+
+int main(int argc, char *argv[])
+{
+	SimRun Runs[] = {
+		{ "4 Mbaud", 4000000U, 1U << 20, SIM_RING, 100000U,
+		  2000U, 0U },
+		{ "4 Mbaud, 20 us latency", 4000000U, 1U << 20, SIM_RING,
+		  100000U, 20000U, 0U },
+		{ "921600, slow reader", 921600U, 1U << 18, 1024U, 20000000U,
+		  2000U, 1U },
+		{ "4 Mbaud, 300 us latency", 4000000U, 1U << 18, SIM_RING,
+		  100000U, 300000U, 1U },
+	};
+	u32 Failed = 0U;
+	u32 Index;
+
+	if (argc > 1) {
+		Runs[0].Total = (u32)strtoul(argv[1], NULL, 0) << 20;
+	}
+	if (argc > 2) {
+		Runs[0].IrqLatency = strtoull(argv[2], NULL, 0) * 1000U;
+	}
+
+	Pattern = malloc(Runs[0].Total > (1U << 20) ? Runs[0].Total :
+			 (1U << 20));
+	if (Pattern == NULL) {
+		return 1;
+	}
+	for (Index = 0U; Index < (Runs[0].Total > (1U << 20) ?
+			Runs[0].Total : (1U << 20)); Index++) {
+		Pattern[Index] = (u8)(Index * 131U + (Index >> 9));
+	}
+
+	Failed += TestBaudRates();
+	Failed += TestTimeout();
+
+	printf("%-28s %8s %7s %8s %8s %8s %5s\n", "run", "irq/KiB",
+		"time", "dropped", "hw lost", "overruns", "sent");
+	for (Index = 0U; Index < sizeof(Runs) / sizeof(Runs[0]); Index++) {
+		Failed += RunStream(&Runs[Index]);
+	}
+
+	free(Pattern);
+
+	printf("\n%s\n", (Failed == 0U) ? "all checks passed" :
+						"CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}
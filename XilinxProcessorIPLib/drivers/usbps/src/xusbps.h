@@ -155,6 +155,31 @@
  * function by sending a XUSBPS_EP_EVENT_DATA_TX event.
  *
  *
+ * <h2>Streaming Bulk Transfers</h2>
+ *
+ * For bulk endpoints that move a continuous stream of data the driver
+ * offers a small streaming layer on top of the send/receive calls,
+ * implemented in xusbps_stream.c.
+ *
+ * An IN stream owns a pool of caller supplied buffers. The fill callback
+ * is asked for data for every free buffer and each filled buffer is queued
+ * as a chain of dTDs, so a buffer may be larger than the 16kB a single dTD
+ * can carry. When a buffer completes it goes straight back to the fill
+ * callback and is queued again from the interrupt handler. New work is
+ * appended to the primed list with the add-dTD tripwire, so the endpoint
+ * does not go idle while the pool holds data. If the fill callback runs
+ * dry, the application restarts the stream with XUsbPs_EpStreamKick().
+ *
+ * An OUT stream hands every received buffer to a drain callback. The
+ * buffer is given back to the controller as soon as the callback returns,
+ * ahead of the re-prime the interrupt handler does. Configure the endpoint
+ * with two or more buffers (NumBufs) so the host can fill one buffer while
+ * the previous one is drained.
+ *
+ * Both directions count bytes, completed buffers and stalls per endpoint.
+ * When XUSBPS_STREAM_STATS is set the stream is also timestamped, and
+ * XUsbPs_EpStreamGetThroughput() returns the achieved rate.
+ *
  * <h2>DMA</h2>
  *
  * The driver uses DMA internally to move data from/to memory. This behaviour
@@ -302,6 +327,26 @@ extern "C" {
 /* @} */
 
 
+/**
+ * @name Streaming bulk transfer options
+ * @{
+ */
+/**
+ * Maximum number of buffers in the pool of an IN stream.
+ */
+#ifndef XUSBPS_STREAM_MAX_BUFS
+#define XUSBPS_STREAM_MAX_BUFS		8
+#endif
+
+/**
+ * When non-zero the streaming layer timestamps each stream with XTime so its
+ * throughput can be read back. Requires xtime_l.h in the BSP.
+ */
+#ifndef XUSBPS_STREAM_STATS
+#define XUSBPS_STREAM_STATS		0
+#endif
+/* @} */
+
 /*
  * Maximum packet size for endpoint, 1024
  * @{
@@ -556,6 +601,79 @@ typedef struct {
 } XUsbPs;
 
 
+/******************************************************************************
+ * This data type defines the callback an IN stream uses to fill a buffer.
+ *
+ * @param	CallBackRef is the reference passed to XUsbPs_EpStreamInitIn().
+ * @param	BufferPtr is the pool buffer to fill.
+ * @param	BufferSize is the size of the pool buffer.
+ *
+ * @return	Number of bytes placed in the buffer. 0 means no data is
+ *		available right now.
+ */
+typedef u32 (*XUsbPs_StreamFillFunc)(void *CallBackRef, u8 *BufferPtr,
+					u32 BufferSize);
+
+
+/******************************************************************************
+ * This data type defines the callback an OUT stream uses to drain a buffer.
+ * The buffer goes back to the controller when the callback returns.
+ *
+ * @param	CallBackRef is the reference passed to XUsbPs_EpStreamInitOut().
+ * @param	BufferPtr is the received data.
+ * @param	BufferLen is the number of bytes received.
+ */
+typedef void (*XUsbPs_StreamDrainFunc)(void *CallBackRef, u8 *BufferPtr,
+					u32 BufferLen);
+
+
+/**
+ * Counters kept per stream.
+ */
+typedef struct {
+	u64 Bytes;		/**< Bytes moved since the stream was started */
+	u32 Buffers;		/**< Buffers completed */
+	u32 Stalls;		/**< IN: times a free buffer could not be
+				  *  queued for lack of data or dTDs. OUT:
+				  *  buffers dropped while stopped */
+	u64 StartTime;		/**< XTime at start, when XUSBPS_STREAM_STATS
+				  *  is set */
+	u64 LastTime;		/**< XTime of the last completion, when
+				  *  XUSBPS_STREAM_STATS is set */
+} XUsbPs_StreamStats;
+
+
+/**
+ * The XUsbPs_EpStream structure holds the state of a streaming bulk endpoint.
+ * It is allocated by the caller and must not be accessed directly.
+ */
+typedef struct {
+	XUsbPs	*InstancePtr;	/**< Controller the endpoint belongs to */
+	u8	EpNum;		/**< Endpoint number */
+	u8	Direction;	/**< XUSBPS_EP_DIRECTION_IN or _OUT */
+	u8	Running;	/**< Non-zero between Start and Stop */
+	u8	NumBufs;	/**< IN: number of buffers in the pool */
+	u32	BufSize;	/**< IN: size of each pool buffer */
+	u8	*Buf[XUSBPS_STREAM_MAX_BUFS];
+				/**< IN: pool buffers */
+	u8	*LastPiece[XUSBPS_STREAM_MAX_BUFS];
+				/**< IN: start of the last dTD of each
+				  *  queued buffer */
+	u32	Len[XUSBPS_STREAM_MAX_BUFS];
+				/**< IN: bytes queued from each buffer */
+	u8	NextBuf;	/**< IN: next pool buffer to fill. The pool
+				  *  is used in order, so the Queued buffers
+				  *  before it are the ones in flight */
+	u8	Queued;		/**< IN: number of buffers in flight */
+	u32	dTDsQueued;	/**< IN: dTDs held by buffers in flight */
+	u32	dTDsMax;	/**< IN: dTDs the stream may hold at once */
+	XUsbPs_StreamFillFunc	FillFunc;	/**< IN callback */
+	XUsbPs_StreamDrainFunc	DrainFunc;	/**< OUT callback */
+	void	*CallBackRef;	/**< Reference for the callback */
+	XUsbPs_StreamStats Stats;	/**< Stream counters */
+} XUsbPs_EpStream;
+
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /******************************************************************************
@@ -1070,6 +1188,24 @@ int XUsbPs_EpPrime(XUsbPs *InstancePtr, u8 EpNum, u8 Direction);
 int XUsbPs_ReconfigureEp(XUsbPs *InstancePtr, XUsbPs_DeviceConfig *CfgPtr,
 			int EpNum, unsigned short NewDirection, int DirectionChanged);
 
+/*
+ * Streaming bulk transfers
+ *
+ * Implemented in file xusbps_stream.c
+ */
+int XUsbPs_EpStreamInitIn(XUsbPs_EpStream *StreamPtr, XUsbPs *InstancePtr,
+			u8 EpNum, u8 **BufPool, u8 NumBufs, u32 BufSize,
+			XUsbPs_StreamFillFunc FillFunc, void *CallBackRef);
+int XUsbPs_EpStreamInitOut(XUsbPs_EpStream *StreamPtr, XUsbPs *InstancePtr,
+			u8 EpNum, XUsbPs_StreamDrainFunc DrainFunc,
+			void *CallBackRef);
+int XUsbPs_EpStreamStart(XUsbPs_EpStream *StreamPtr);
+void XUsbPs_EpStreamStop(XUsbPs_EpStream *StreamPtr);
+int XUsbPs_EpStreamKick(XUsbPs_EpStream *StreamPtr);
+void XUsbPs_EpStreamGetStats(const XUsbPs_EpStream *StreamPtr,
+			XUsbPs_StreamStats *StatsPtr);
+u64 XUsbPs_EpStreamGetThroughput(const XUsbPs_EpStream *StreamPtr);
+
 /*
  * Interrupt handling functions
  *
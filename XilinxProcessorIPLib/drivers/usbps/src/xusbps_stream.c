@@ -0,0 +1,570 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/******************************************************************************/
+/**
+ * @file xusbps_stream.c
+* @addtogroup usbps_v2_2
+* @{
+ *
+ * Streaming bulk transfers on top of the endpoint send/receive functions.
+ *
+ * An IN stream keeps a pool of buffers queued on the endpoint. Buffers are
+ * used in order, so the ones in flight always directly precede the next
+ * buffer to fill and completions arrive oldest first. A buffer larger than
+ * XUSBPS_dTD_BUF_MAX_SIZE is split over a chain of dTDs by
+ * XUsbPs_EpBufferSend(). The stream recognises the completion of a buffer
+ * by the TX event for its last dTD, and then refills and re-queues it from
+ * the same interrupt.
+ *
+ * An OUT stream receives, drains and releases each buffer from the RX
+ * event, so the dTD is active again before the interrupt handler re-primes
+ * the endpoint.
+ *
+ * See xusbps.h for a description of the streaming API.
+ *
+ * <pre>
+ * MODIFICATION HISTORY:
+ *
+ * Ver   Who  Date     Changes
+ * ----- ---- -------- --------------------------------------------------------
+ * 2.4        10/18/26 First release
+ * </pre>
+ ******************************************************************************/
+
+/***************************** Include Files **********************************/
+
+#include <string.h>
+
+#include "xusbps.h"
+#include "xusbps_endpoint.h"
+#if XUSBPS_STREAM_STATS
+#include "xtime_l.h"
+#endif
+
+/************************** Constant Definitions ******************************/
+
+/**************************** Type Definitions ********************************/
+
+/***************** Macros (Inline Functions) Definitions **********************/
+
+/*****************************************************************************/
+/**
+ * Returns the number of dTDs XUsbPs_EpBufferSend() uses for a buffer of the
+ * given (non-zero) length.
+ *
+ * @note	C-style signature:
+ *		u32 XUsbPs_StreamdTDCount(u32 Len)
+ *
+ ******************************************************************************/
+#define XUsbPs_StreamdTDCount(Len)					\
+		((((Len) - 1U) / (XUSBPS_dTD_BUF_MAX_SIZE)) + 1U)
+
+/************************** Function Prototypes ******************************/
+
+static void XUsbPs_EpStreamHandler(void *CallBackRef, u8 EpNum,
+					u8 EventType, void *Data);
+static int XUsbPs_EpStreamFill(XUsbPs_EpStream *StreamPtr);
+static void XUsbPs_EpStreamTxDone(XUsbPs_EpStream *StreamPtr, u8 *BufPtr);
+static void XUsbPs_EpStreamRxDone(XUsbPs_EpStream *StreamPtr);
+static void XUsbPs_EpStreamStamp(u64 *TimePtr);
+
+/******************************* Functions ************************************/
+
+/*****************************************************************************/
+/**
+ * This function initializes an IN (transmit) stream on a bulk endpoint.
+ *
+ * @param	StreamPtr is a pointer to the stream to initialize.
+ * @param	InstancePtr is a pointer to the XUsbPs instance of the
+ *		controller.
+ * @param	EpNum is the number of the endpoint to stream on.
+ * @param	BufPool is an array of NumBufs buffer pointers. The buffers
+ *		are owned by the stream until it is stopped and all queued
+ *		buffers have completed.
+ * @param	NumBufs is the number of buffers in the pool,
+ *		1..XUSBPS_STREAM_MAX_BUFS. Use at least 2 so one buffer is
+ *		filled while the other is on the bus.
+ * @param	BufSize is the size of each pool buffer.
+ * @param	FillFunc is the callback that fills a free buffer.
+ * @param	CallBackRef is passed back to FillFunc.
+ *
+ * @return
+ *		- XST_SUCCESS: The stream has been initialized.
+ *		- XST_INVALID_PARAM: The endpoint does not have enough TX
+ *		  descriptors to hold one pool buffer and the terminating
+ *		  descriptor.
+ *
+ * @note	Each buffer needs BufSize / 16kB (rounded up) descriptors while
+ *		in flight. The number of buffers kept queued is limited by the
+ *		NumBufs the endpoint was configured with.
+ *
+ ******************************************************************************/
+int XUsbPs_EpStreamInitIn(XUsbPs_EpStream *StreamPtr, XUsbPs *InstancePtr,
+			u8 EpNum, u8 **BufPool, u8 NumBufs, u32 BufSize,
+			XUsbPs_StreamFillFunc FillFunc, void *CallBackRef)
+{
+	u32 RingSize;
+	u8 Index;
+
+	Xil_AssertNonvoid(StreamPtr   != NULL);
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(EpNum < InstancePtr->DeviceConfig.NumEndpoints);
+	Xil_AssertNonvoid(BufPool     != NULL);
+	Xil_AssertNonvoid((NumBufs > 0U) &&
+			(NumBufs <= (u8)XUSBPS_STREAM_MAX_BUFS));
+	Xil_AssertNonvoid(BufSize     != 0U);
+	Xil_AssertNonvoid(FillFunc    != NULL);
+
+	/* One descriptor of the ring always stays free: it is the one
+	 * XUsbPs_EpBufferSend() terminates the list with.
+	 */
+	RingSize = InstancePtr->DeviceConfig.EpCfg[EpNum].In.NumBufs;
+	if (RingSize < (XUsbPs_StreamdTDCount(BufSize) + 1U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	memset(StreamPtr, 0, sizeof(XUsbPs_EpStream));
+
+	StreamPtr->InstancePtr	= InstancePtr;
+	StreamPtr->EpNum	= EpNum;
+	StreamPtr->Direction	= XUSBPS_EP_DIRECTION_IN;
+	StreamPtr->NumBufs	= NumBufs;
+	StreamPtr->BufSize	= BufSize;
+	StreamPtr->dTDsMax	= RingSize - 1U;
+	StreamPtr->FillFunc	= FillFunc;
+	StreamPtr->CallBackRef	= CallBackRef;
+
+	for (Index = 0U; Index < NumBufs; Index++) {
+		Xil_AssertNonvoid(BufPool[Index] != NULL);
+		StreamPtr->Buf[Index] = BufPool[Index];
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * This function initializes an OUT (receive) stream on a bulk endpoint.
+ *
+ * @param	StreamPtr is a pointer to the stream to initialize.
+ * @param	InstancePtr is a pointer to the XUsbPs instance of the
+ *		controller.
+ * @param	EpNum is the number of the endpoint to stream on.
+ * @param	DrainFunc is the callback that consumes each received buffer.
+ * @param	CallBackRef is passed back to DrainFunc.
+ *
+ * @return
+ *		- XST_SUCCESS: The stream has been initialized.
+ *
+ * @note	The receive buffers are the ones the endpoint was configured
+ *		with (NumBufs of BufSize bytes). Two or more of them double
+ *		buffer the endpoint.
+ *
+ ******************************************************************************/
+int XUsbPs_EpStreamInitOut(XUsbPs_EpStream *StreamPtr, XUsbPs *InstancePtr,
+			u8 EpNum, XUsbPs_StreamDrainFunc DrainFunc,
+			void *CallBackRef)
+{
+	Xil_AssertNonvoid(StreamPtr   != NULL);
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(EpNum < InstancePtr->DeviceConfig.NumEndpoints);
+	Xil_AssertNonvoid(DrainFunc   != NULL);
+
+	memset(StreamPtr, 0, sizeof(XUsbPs_EpStream));
+
+	StreamPtr->InstancePtr	= InstancePtr;
+	StreamPtr->EpNum	= EpNum;
+	StreamPtr->Direction	= XUSBPS_EP_DIRECTION_OUT;
+	StreamPtr->DrainFunc	= DrainFunc;
+	StreamPtr->CallBackRef	= CallBackRef;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * This function starts a stream. It installs the stream as the handler of
+ * its endpoint direction, clears the counters and, for an IN stream, fills
+ * and queues as many pool buffers as data and descriptors allow.
+ *
+ * @param	StreamPtr is a pointer to an initialized stream.
+ *
+ * @return
+ *		- XST_SUCCESS: The stream is running.
+ *		- XST_FAILURE: Queueing an IN buffer failed.
+ *
+ * @note	The endpoint must be enabled. OUT endpoints are primed by the
+ *		application as usual.
+ *
+ ******************************************************************************/
+int XUsbPs_EpStreamStart(XUsbPs_EpStream *StreamPtr)
+{
+	int Status;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->InstancePtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->Queued == 0U);
+
+	memset(&StreamPtr->Stats, 0, sizeof(XUsbPs_StreamStats));
+	XUsbPs_EpStreamStamp(&StreamPtr->Stats.StartTime);
+	StreamPtr->Stats.LastTime = StreamPtr->Stats.StartTime;
+
+	Status = XUsbPs_EpSetHandler(StreamPtr->InstancePtr, StreamPtr->EpNum,
+				StreamPtr->Direction, XUsbPs_EpStreamHandler,
+				StreamPtr);
+	if (XST_SUCCESS != Status) {
+		return XST_FAILURE;
+	}
+
+	StreamPtr->Running = 1U;
+
+	if (StreamPtr->Direction == XUSBPS_EP_DIRECTION_IN) {
+		return XUsbPs_EpStreamKick(StreamPtr);
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * This function stops a stream.
+ *
+ * An IN stream stops queueing buffers. Buffers already queued are still sent
+ * and counted; the pool may be reused once XUsbPs_EpStreamGetStats() shows
+ * no more progress, or the endpoint has been flushed.
+ *
+ * An OUT stream stops calling the drain callback. Buffers that arrive after
+ * this are given back to the controller unread and counted as stalls, so
+ * the application should stop the host through its class protocol first.
+ *
+ * @param	StreamPtr is a pointer to the stream.
+ *
+ * @return	None.
+ *
+ ******************************************************************************/
+void XUsbPs_EpStreamStop(XUsbPs_EpStream *StreamPtr)
+{
+	Xil_AssertVoid(StreamPtr != NULL);
+
+	StreamPtr->Running = 0U;
+}
+
+/*****************************************************************************/
+/**
+ * This function fills and queues free buffers of an IN stream. The stream
+ * does this itself whenever a buffer completes; the application calls it
+ * when new data became available after the fill callback returned 0, since
+ * there is no completion left to restart the stream then.
+ *
+ * @param	StreamPtr is a pointer to a running IN stream.
+ *
+ * @return
+ *		- XST_SUCCESS: All buffers that could be filled are queued.
+ *		- XST_FAILURE: Queueing a buffer failed.
+ *
+ * @note	The USB transaction complete interrupt is masked while the
+ *		buffers are queued, as the same work runs from the interrupt
+ *		handler.
+ *
+ ******************************************************************************/
+int XUsbPs_EpStreamKick(XUsbPs_EpStream *StreamPtr)
+{
+	XUsbPs	*InstancePtr;
+	u32	IntrEnabled;
+	int	Status;
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+	Xil_AssertNonvoid(StreamPtr->Direction == XUSBPS_EP_DIRECTION_IN);
+
+	InstancePtr = StreamPtr->InstancePtr;
+
+	IntrEnabled = XUsbPs_ReadReg(InstancePtr->Config.BaseAddress,
+				XUSBPS_IER_OFFSET) & XUSBPS_IXR_UI_MASK;
+	XUsbPs_IntrDisable(InstancePtr, XUSBPS_IXR_UI_MASK);
+
+	Status = XUsbPs_EpStreamFill(StreamPtr);
+
+	if (IntrEnabled != 0U) {
+		XUsbPs_IntrEnable(InstancePtr, XUSBPS_IXR_UI_MASK);
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ * This function returns a copy of the counters of a stream.
+ *
+ * @param	StreamPtr is a pointer to the stream.
+ * @param	StatsPtr is a pointer to the structure to fill.
+ *
+ * @return	None.
+ *
+ ******************************************************************************/
+void XUsbPs_EpStreamGetStats(const XUsbPs_EpStream *StreamPtr,
+			XUsbPs_StreamStats *StatsPtr)
+{
+	Xil_AssertVoid(StreamPtr != NULL);
+	Xil_AssertVoid(StatsPtr  != NULL);
+
+	*StatsPtr = StreamPtr->Stats;
+}
+
+/*****************************************************************************/
+/**
+ * This function returns the throughput of a stream, from the time it was
+ * started to its last completed buffer.
+ *
+ * @param	StreamPtr is a pointer to the stream.
+ *
+ * @return	Throughput in bytes per second, or 0 if XUSBPS_STREAM_STATS is
+ *		not enabled or no buffer has completed yet.
+ *
+ ******************************************************************************/
+u64 XUsbPs_EpStreamGetThroughput(const XUsbPs_EpStream *StreamPtr)
+{
+	u64 Rate = 0U;
+#if XUSBPS_STREAM_STATS
+	u64 Cycles;
+	u64 Bytes;
+#endif
+
+	Xil_AssertNonvoid(StreamPtr != NULL);
+
+#if XUSBPS_STREAM_STATS
+	Cycles = StreamPtr->Stats.LastTime - StreamPtr->Stats.StartTime;
+	Bytes = StreamPtr->Stats.Bytes;
+	if (Cycles != 0U) {
+		Rate = ((Bytes / Cycles) * (u64)COUNTS_PER_SECOND) +
+			(((Bytes % Cycles) * (u64)COUNTS_PER_SECOND) / Cycles);
+	}
+#endif
+
+	return Rate;
+}
+
+/*****************************************************************************/
+/**
+ * Endpoint handler installed by XUsbPs_EpStreamStart().
+ *
+ * @param	CallBackRef is the stream.
+ * @param	EpNum is the endpoint number.
+ * @param	EventType is the endpoint event.
+ * @param	Data is the buffer of the completed dTD for TX events.
+ *
+ * @return	None.
+ *
+ ******************************************************************************/
+static void XUsbPs_EpStreamHandler(void *CallBackRef, u8 EpNum,
+					u8 EventType, void *Data)
+{
+	XUsbPs_EpStream *StreamPtr = (XUsbPs_EpStream *) CallBackRef;
+
+	switch (EventType) {
+
+	case XUSBPS_EP_EVENT_DATA_TX:
+		XUsbPs_EpStreamTxDone(StreamPtr, (u8 *) Data);
+		break;
+
+	case XUSBPS_EP_EVENT_DATA_RX:
+		XUsbPs_EpStreamRxDone(StreamPtr);
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*****************************************************************************/
+/**
+ * Fills and queues free pool buffers until the pool is exhausted, the fill
+ * callback has no data, or a further buffer might not find enough free
+ * descriptors. The descriptor check is done before the callback runs, so
+ * data handed over by the callback is always queued.
+ *
+ * @param	StreamPtr is a pointer to an IN stream.
+ *
+ * @return	XST_SUCCESS, or XST_FAILURE if XUsbPs_EpBufferSend() failed.
+ *
+ * @note	Must be called with the USB interrupt masked or from the
+ *		interrupt handler.
+ *
+ ******************************************************************************/
+static int XUsbPs_EpStreamFill(XUsbPs_EpStream *StreamPtr)
+{
+	u32	MaxdTDs = XUsbPs_StreamdTDCount(StreamPtr->BufSize);
+	u32	Len;
+	u32	NumdTDs;
+	u8	Index;
+	u8	*BufPtr;
+	int	Status;
+
+	while ((StreamPtr->Running != 0U) &&
+			(StreamPtr->Queued < StreamPtr->NumBufs)) {
+
+		if ((StreamPtr->dTDsQueued + MaxdTDs) > StreamPtr->dTDsMax) {
+			StreamPtr->Stats.Stalls++;
+			break;
+		}
+
+		Index = StreamPtr->NextBuf;
+		BufPtr = StreamPtr->Buf[Index];
+
+		Len = StreamPtr->FillFunc(StreamPtr->CallBackRef, BufPtr,
+					StreamPtr->BufSize);
+		if (Len == 0U) {
+			StreamPtr->Stats.Stalls++;
+			break;
+		}
+		Xil_AssertNonvoid(Len <= StreamPtr->BufSize);
+
+		Status = XUsbPs_EpBufferSend(StreamPtr->InstancePtr,
+					StreamPtr->EpNum, BufPtr, Len);
+		if (XST_SUCCESS != Status) {
+			return XST_FAILURE;
+		}
+
+		/* Remember where the last dTD of this buffer starts; its TX
+		 * event is the completion of the whole buffer.
+		 */
+		NumdTDs = XUsbPs_StreamdTDCount(Len);
+		StreamPtr->LastPiece[Index] = BufPtr +
+				((NumdTDs - 1U) * (XUSBPS_dTD_BUF_MAX_SIZE));
+		StreamPtr->Len[Index] = Len;
+		StreamPtr->dTDsQueued += NumdTDs;
+		StreamPtr->Queued++;
+
+		StreamPtr->NextBuf++;
+		if (StreamPtr->NextBuf == StreamPtr->NumBufs) {
+			StreamPtr->NextBuf = 0U;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+ * Handles the TX event of one dTD of an IN stream.
+ *
+ * @param	StreamPtr is a pointer to an IN stream.
+ * @param	BufPtr is the buffer address of the completed dTD.
+ *
+ * @return	None.
+ *
+ * @note	The interrupt handler only advances its tail past this dTD
+ *		after the event, so the dTD is still counted as held while
+ *		the pool is refilled. Otherwise the refill could reuse the
+ *		descriptor the handler is looking at.
+ *
+ ******************************************************************************/
+static void XUsbPs_EpStreamTxDone(XUsbPs_EpStream *StreamPtr, u8 *BufPtr)
+{
+	u8 Index;
+
+	if (StreamPtr->Queued != 0U) {
+		Index = (u8)((StreamPtr->NextBuf + StreamPtr->NumBufs -
+				StreamPtr->Queued) % StreamPtr->NumBufs);
+
+		if (BufPtr == StreamPtr->LastPiece[Index]) {
+			StreamPtr->Queued--;
+			StreamPtr->Stats.Bytes += StreamPtr->Len[Index];
+			StreamPtr->Stats.Buffers++;
+			XUsbPs_EpStreamStamp(&StreamPtr->Stats.LastTime);
+
+			(void)XUsbPs_EpStreamFill(StreamPtr);
+		}
+	}
+
+	if (StreamPtr->dTDsQueued != 0U) {
+		StreamPtr->dTDsQueued--;
+	}
+}
+
+/*****************************************************************************/
+/**
+ * Handles the RX event of an OUT stream: hands the received buffer to the
+ * drain callback and gives it back to the controller.
+ *
+ * @param	StreamPtr is a pointer to an OUT stream.
+ *
+ * @return	None.
+ *
+ ******************************************************************************/
+static void XUsbPs_EpStreamRxDone(XUsbPs_EpStream *StreamPtr)
+{
+	u8	*BufPtr;
+	u32	Len;
+	u32	Handle;
+	int	Status;
+
+	Status = XUsbPs_EpBufferReceive(StreamPtr->InstancePtr,
+				StreamPtr->EpNum, &BufPtr, &Len, &Handle);
+	if (XST_SUCCESS != Status) {
+		return;
+	}
+
+	if (StreamPtr->Running != 0U) {
+		Xil_DCacheInvalidateRange((unsigned int)BufPtr, Len);
+		StreamPtr->DrainFunc(StreamPtr->CallBackRef, BufPtr, Len);
+
+		StreamPtr->Stats.Bytes += Len;
+		StreamPtr->Stats.Buffers++;
+		XUsbPs_EpStreamStamp(&StreamPtr->Stats.LastTime);
+	} else {
+		StreamPtr->Stats.Stalls++;
+	}
+
+	XUsbPs_EpBufferRelease(Handle);
+}
+
+/*****************************************************************************/
+/**
+ * Stores the current XTime when XUSBPS_STREAM_STATS is enabled.
+ *
+ * @param	TimePtr is where to store the time.
+ *
+ * @return	None.
+ *
+ ******************************************************************************/
+static void XUsbPs_EpStreamStamp(u64 *TimePtr)
+{
+#if XUSBPS_STREAM_STATS
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	*TimePtr = (u64)Now;
+#else
+	(void)TimePtr;
+#endif
+}
+/** @} */
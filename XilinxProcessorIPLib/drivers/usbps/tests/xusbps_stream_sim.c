@@ -0,0 +1,721 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xusbps_stream_sim.c
+*
+* Host test and benchmark of the streaming bulk endpoints against a model of
+* the device controller and its dQH/dTD memory.
+*
+* The model keeps the controller registers the driver uses. Priming an
+* endpoint loads the next dTD pointer of its dQH. A primed endpoint works
+* through the dTD list: an active dTD is moved over the bus in 512 byte
+* packets (13 packets per 125 us microframe), then it is retired with the
+* remaining length cleared and, if IOC is set, the endpoint complete bit and
+* the transaction interrupt are raised. The controller then follows the
+* next link pointer. At a terminated link or an inactive dTD the endpoint is
+* no longer ready and the dQH keeps the dTD it stopped at. The data is
+* copied through the five buffer page pointers of each dTD, and the dTDs
+* and buffers live in memory below 4 GB as the driver keeps 32-bit
+* addresses. The interrupt handler runs as soon as the transaction
+* interrupt is pending and enabled.
+*
+* Time is simulated: each register access, interrupt entry and exit and
+* each byte the application fills or drains costs processor time, while
+* the bus moves data on its own. The IN runs send the same data with:
+*  - one buffer at a time: fill, XUsbPs_EpBufferSend(), wait for the TX
+*    event of its last dTD, so the endpoint is re-primed for every buffer,
+*  - an IN stream with a pool of 1, 2 or 4 buffers of 16 kB, and of 2
+*    buffers of 64 kB (four chained dTDs each).
+* The OUT runs receive through an OUT stream with 1, 2 and 4 buffers.
+*
+* For each run the throughput, the share of time the bus is busy, the
+* interrupts and the primes are printed. The checks are that every byte
+* arrives once and in order, that the dTD page pointers cover every buffer,
+* that the stream counters match the data moved, that the throughput the
+* stream reports matches the measured one, and that a stream with two or
+* more buffers keeps the bus busy.
+*
+* Usage: xusbps_stream_sim [MB per run] [fill/drain ns per kB]
+*
+* The defaults are 8 and 4000.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 2.4        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "xusbps.h"
+#include "xusbps_endpoint.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE	0xE0002000U	/* Simulated controller registers */
+#define SIM_REG_BYTES	0x200U
+
+#define SIM_EP		1U		/* Bulk endpoint under test */
+#define SIM_IN_DTDS	32U		/* TX ring of the bulk endpoint */
+#define SIM_OUT_SIZE	(16U * 1024U)	/* OUT buffer size */
+#define SIM_MAX_BUFS	4U
+#define SIM_MAX_SIZE	(64U * 1024U)
+#define SIM_DMA_BYTES	(256U * 1024U)
+
+#define SIM_PACKET	512U		/* High speed bulk packet */
+#define SIM_PACKET_NS	9615U		/* 13 packets per microframe */
+#define SIM_FETCH_NS	200U		/* Fetch of the next dTD */
+#define SIM_PRIME_NS	3000U		/* Prime to the first packet */
+#define SIM_REG_NS	30U		/* Register access */
+#define SIM_IRQ_NS	800U		/* Interrupt entry plus exit */
+
+#define SIM_NEVER	(~0ULL)
+
+/**************************** Type Definitions *******************************/
+
+/* One endpoint direction of the controller */
+typedef struct {
+	int Ready;		/* Primed, EPRDY set */
+	int Busy;		/* Moving the data of Cur */
+	u32 Cur;		/* dTD being processed */
+	u64 At;			/* Time of the next step */
+} SimEp;
+
+typedef struct {
+	const char *Name;
+	int In;			/* IN run, else OUT */
+	int Stream;		/* Stream, else one buffer at a time */
+	u32 NumBufs;
+	u32 BufSize;
+} SimRunCfg;
+
+/************************** Variable Definitions *****************************/
+
+u64 SimTime;
+
+static u32 Regs[SIM_REG_BYTES / 4U];
+static SimEp Ep[32];
+static u64 BusFree;
+static u64 BusBusy;
+static int InIrq;
+static u32 Irqs;
+static u32 Primes;
+static u32 BadAccesses;
+static u32 DmaErrors;
+static u32 DataErrors;
+
+/* Data moved over the bus and by the application */
+static u64 Total;
+static u64 HostPos;
+static u64 AppPos;
+static u64 DoneTime;
+static u32 FillNsPerKb = 4000U;
+
+/* One buffer at a time */
+static u8 *WaitPiece;
+static int TxDone;
+
+static XUsbPs Usb;
+static XUsbPs_DeviceConfig DevCfg;
+static XUsbPs_EpStream Stream;
+static u8 *DmaMem;
+static u8 *PoolMem;
+static u32 Failed;
+
+/************************** Function Prototypes ******************************/
+
+static void SimAdvance(u64 Ns);
+
+/*****************************************************************************/
+
+static void Check(int Cond, const char *What)
+{
+	if (!Cond) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+static u32 *SimPtr(u32 Addr)
+{
+	return (u32 *)(UINTPTR)Addr;
+}
+
+/* Byte Pos of the data stream */
+static u8 SimPattern(u64 Pos)
+{
+	return (u8)(Pos ^ (Pos >> 8) ^ (Pos >> 16) ^ 0x5A);
+}
+
+/*****************************************************************************/
+/*
+ * Controller model
+ */
+static void SimReset(void)
+{
+	memset(Regs, 0, sizeof(Regs));
+	memset(Ep, 0, sizeof(Ep));
+	BusFree = SimTime;
+	BusBusy = 0U;
+	Irqs = 0U;
+	Primes = 0U;
+}
+
+static u32 SimdQH(u32 Bit)
+{
+	u32 EpNum = Bit & 0xFU;
+	u32 In = (Bit >= 16U) ? 1U : 0U;
+
+	return Regs[XUSBPS_EPLISTADDR_OFFSET / 4U] +
+		((EpNum * 2U) + In) * XUSBPS_dQH_ALIGN;
+}
+
+static void SimPrime(u32 Bit)
+{
+	SimEp *EpPtr = &Ep[Bit];
+	u32 Next;
+
+	if (EpPtr->Ready) {
+		return;
+	}
+	Next = *SimPtr(SimdQH(Bit) + XUSBPS_dQHdTDNLP);
+	if ((Next & XUSBPS_dTDNLP_T_MASK) != 0U) {
+		return;
+	}
+	EpPtr->Ready = 1;
+	EpPtr->Busy = 0;
+	EpPtr->Cur = Next & XUSBPS_dTDNLP_ADDR_MASK;
+	EpPtr->At = SimTime + SIM_PRIME_NS;
+	Primes++;
+}
+
+/* Copies the data of a dTD through its buffer page pointers */
+static void SimMoveData(u32 Dtd, u32 Len, int In)
+{
+	u32 Addr = *SimPtr(Dtd + XUSBPS_dTDBPTR0);
+	u32 Page = 0U;
+	u32 Off = 0U;
+	u32 Chunk;
+	u32 Index;
+	u8 *Ptr;
+
+	while (Off < Len) {
+		if (Page > 4U) {
+			DmaErrors++;
+			return;
+		}
+		Chunk = 0x1000U - (Addr & 0xFFFU);
+		if (Chunk > Len - Off) {
+			Chunk = Len - Off;
+		}
+		Ptr = (u8 *)(UINTPTR)Addr;
+		for (Index = 0U; Index < Chunk; Index++) {
+			if (In) {
+				if (Ptr[Index] != SimPattern(HostPos)) {
+					DataErrors++;
+				}
+			} else {
+				Ptr[Index] = SimPattern(HostPos);
+			}
+			HostPos++;
+		}
+		Off += Chunk;
+		Page++;
+		if (Page <= 4U) {
+			Addr = *SimPtr(Dtd + XUSBPS_dTDBPTR(Page)) & 0xFFFFF000U;
+		}
+	}
+}
+
+/* Completes the dTD the endpoint is moving at time Now */
+static void SimComplete(u32 Bit, SimEp *EpPtr, u64 Now)
+{
+	u32 Dtd = EpPtr->Cur;
+	u32 Token = *SimPtr(Dtd + XUSBPS_dTDTOKEN);
+	u32 Len = (Token & XUSBPS_dTDTOKEN_LEN_MASK) >> 16;
+	u32 Next;
+
+	SimMoveData(Dtd, Len, Bit >= 16U);
+	if (HostPos == Total && Bit >= 16U) {
+		DoneTime = Now;
+	}
+
+	Token &= ~(XUSBPS_dTDTOKEN_ACTIVE_MASK | XUSBPS_dTDTOKEN_LEN_MASK);
+	*SimPtr(Dtd + XUSBPS_dTDTOKEN) = Token;
+	if ((Token & XUSBPS_dTDTOKEN_IOC_MASK) != 0U) {
+		Regs[XUSBPS_EPCOMPL_OFFSET / 4U] |= 1U << Bit;
+		Regs[XUSBPS_ISR_OFFSET / 4U] |= XUSBPS_IXR_UI_MASK;
+	}
+
+	EpPtr->Busy = 0;
+	Next = *SimPtr(Dtd + XUSBPS_dTDNLP);
+	if ((Next & XUSBPS_dTDNLP_T_MASK) != 0U) {
+		EpPtr->Ready = 0;
+		*SimPtr(SimdQH(Bit) + XUSBPS_dQHdTDNLP) = Next;
+		return;
+	}
+	EpPtr->Cur = Next & XUSBPS_dTDNLP_ADDR_MASK;
+	EpPtr->At = Now + SIM_FETCH_NS;
+}
+
+/* Starts the dTD the endpoint points at, or retires the endpoint */
+static void SimStart(u32 Bit, SimEp *EpPtr, u64 Now)
+{
+	u32 Token = *SimPtr(EpPtr->Cur + XUSBPS_dTDTOKEN);
+	u32 Len = (Token & XUSBPS_dTDTOKEN_LEN_MASK) >> 16;
+	u64 Start;
+	u64 Ns;
+
+	if ((Token & XUSBPS_dTDTOKEN_ACTIVE_MASK) == 0U) {
+		EpPtr->Ready = 0;
+		*SimPtr(SimdQH(Bit) + XUSBPS_dQHdTDNLP) = EpPtr->Cur;
+		return;
+	}
+
+	/* The host has no more data for an OUT endpoint: it NAKs */
+	if (Bit < 16U && HostPos >= Total) {
+		EpPtr->At = SIM_NEVER;
+		return;
+	}
+
+	Ns = (u64)((Len + SIM_PACKET - 1U) / SIM_PACKET) * SIM_PACKET_NS;
+	if (Ns == 0U) {
+		Ns = SIM_PACKET_NS;
+	}
+	Start = (Now > BusFree) ? Now : BusFree;
+	EpPtr->Busy = 1;
+	EpPtr->At = Start + Ns;
+	BusFree = EpPtr->At;
+	BusBusy += Ns;
+}
+
+/* Runs the controller up to the current time */
+static void SimBus(void)
+{
+	SimEp *EpPtr;
+	u32 Bit;
+	u32 First;
+	u64 At;
+
+	for (;;) {
+		First = 32U;
+		At = SIM_NEVER;
+		for (Bit = 0U; Bit < 32U; Bit++) {
+			if (Ep[Bit].Ready && Ep[Bit].At <= SimTime &&
+					Ep[Bit].At < At) {
+				At = Ep[Bit].At;
+				First = Bit;
+			}
+		}
+		if (First == 32U) {
+			return;
+		}
+		EpPtr = &Ep[First];
+		if (EpPtr->Busy) {
+			SimComplete(First, EpPtr, At);
+		} else {
+			SimStart(First, EpPtr, At);
+		}
+	}
+}
+
+static void SimIrq(void)
+{
+	while (!InIrq && (Regs[XUSBPS_ISR_OFFSET / 4U] &
+			Regs[XUSBPS_IER_OFFSET / 4U]) != 0U) {
+		InIrq = 1;
+		Irqs++;
+		SimAdvance(SIM_IRQ_NS);
+		XUsbPs_IntrHandler(&Usb);
+		InIrq = 0;
+	}
+}
+
+static void SimAdvance(u64 Ns)
+{
+	SimTime += Ns;
+	SimBus();
+	SimIrq();
+}
+
+/* Waits for the next controller event, returns 0 if there is none */
+static int SimIdle(void)
+{
+	u64 At = SIM_NEVER;
+	u32 Bit;
+
+	for (Bit = 0U; Bit < 32U; Bit++) {
+		if (Ep[Bit].Ready && Ep[Bit].At < At) {
+			At = Ep[Bit].At;
+		}
+	}
+	if (At == SIM_NEVER) {
+		return 0;
+	}
+	if (At > SimTime) {
+		SimTime = At;
+	}
+	SimAdvance(0U);
+	return 1;
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Offset = (u32)(Addr - SIM_BASE);
+	u32 Value;
+	u32 Bit;
+
+	SimAdvance(SIM_REG_NS);
+	if (Addr < SIM_BASE || Offset >= SIM_REG_BYTES) {
+		BadAccesses++;
+		return 0U;
+	}
+	if (Offset == XUSBPS_EPRDY_OFFSET) {
+		Value = 0U;
+		for (Bit = 0U; Bit < 32U; Bit++) {
+			if (Ep[Bit].Ready) {
+				Value |= 1U << Bit;
+			}
+		}
+		return Value;
+	}
+	return Regs[Offset / 4U];
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset = (u32)(Addr - SIM_BASE);
+	u32 Bit;
+
+	if (Addr < SIM_BASE || Offset >= SIM_REG_BYTES) {
+		BadAccesses++;
+		return;
+	}
+	switch (Offset) {
+	case XUSBPS_ISR_OFFSET:
+	case XUSBPS_EPCOMPL_OFFSET:
+	case XUSBPS_EPSTAT_OFFSET:
+	case XUSBPS_EPNAKISR_OFFSET:
+		Regs[Offset / 4U] &= ~Value;
+		break;
+	case XUSBPS_CMD_OFFSET:
+		/* Reset completes at once */
+		Regs[Offset / 4U] = Value & ~XUSBPS_CMD_RST_MASK;
+		break;
+	case XUSBPS_EPPRIME_OFFSET:
+		for (Bit = 0U; Bit < 32U; Bit++) {
+			if ((Value & (1U << Bit)) != 0U) {
+				SimPrime(Bit);
+			}
+		}
+		break;
+	case XUSBPS_EPFLUSH_OFFSET:
+		for (Bit = 0U; Bit < 32U; Bit++) {
+			if ((Value & (1U << Bit)) != 0U) {
+				Ep[Bit].Ready = 0;
+			}
+		}
+		break;
+	default:
+		Regs[Offset / 4U] = Value;
+		break;
+	}
+	SimAdvance(SIM_REG_NS);
+}
+
+/*****************************************************************************/
+/*
+ * Application
+ */
+
+/* Fills a buffer with the next data of the stream */
+static u32 AppFill(void *CallBackRef, u8 *BufferPtr, u32 BufferSize)
+{
+	u32 Len;
+	u32 Index;
+
+	(void)CallBackRef;
+	if (AppPos >= Total) {
+		return 0U;
+	}
+	Len = BufferSize;
+	if ((u64)Len > Total - AppPos) {
+		Len = (u32)(Total - AppPos);
+	}
+	for (Index = 0U; Index < Len; Index++) {
+		BufferPtr[Index] = SimPattern(AppPos + Index);
+	}
+	AppPos += Len;
+	SimAdvance(((u64)Len * FillNsPerKb) / 1024U);
+	return Len;
+}
+
+static void AppDrain(void *CallBackRef, u8 *BufferPtr, u32 BufferLen)
+{
+	u32 Index;
+
+	(void)CallBackRef;
+	for (Index = 0U; Index < BufferLen; Index++) {
+		if (BufferPtr[Index] != SimPattern(AppPos + Index)) {
+			DataErrors++;
+		}
+	}
+	AppPos += BufferLen;
+	SimAdvance(((u64)BufferLen * FillNsPerKb) / 1024U);
+	if (AppPos == Total) {
+		DoneTime = SimTime;
+	}
+}
+
+/* TX handler of the one buffer at a time runs */
+static void AppTxHandler(void *CallBackRef, u8 EpNum, u8 EventType,
+			void *Data)
+{
+	(void)CallBackRef;
+	(void)EpNum;
+	if (EventType == XUSBPS_EP_EVENT_DATA_TX && (u8 *)Data == WaitPiece) {
+		TxDone = 1;
+	}
+}
+
+static int Setup(u32 InBufs, u32 OutBufs)
+{
+	XUsbPs_Config Cfg;
+	int Status;
+
+	SimReset();
+	memset(&Cfg, 0, sizeof(Cfg));
+	Cfg.BaseAddress = SIM_BASE;
+	memset(&Usb, 0, sizeof(Usb));
+	Status = XUsbPs_CfgInitialize(&Usb, &Cfg, 0U);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	memset(&DevCfg, 0, sizeof(DevCfg));
+	DevCfg.NumEndpoints = 2U;
+	DevCfg.EpCfg[0].Out.Type = XUSBPS_EP_TYPE_CONTROL;
+	DevCfg.EpCfg[0].Out.NumBufs = 2U;
+	DevCfg.EpCfg[0].Out.BufSize = 64U;
+	DevCfg.EpCfg[0].Out.MaxPacketSize = 64U;
+	DevCfg.EpCfg[0].In.Type = XUSBPS_EP_TYPE_CONTROL;
+	DevCfg.EpCfg[0].In.NumBufs = 2U;
+	DevCfg.EpCfg[0].In.MaxPacketSize = 64U;
+	DevCfg.EpCfg[SIM_EP].Out.Type = (OutBufs != 0U) ?
+			XUSBPS_EP_TYPE_BULK : XUSBPS_EP_TYPE_NONE;
+	DevCfg.EpCfg[SIM_EP].Out.NumBufs = OutBufs;
+	DevCfg.EpCfg[SIM_EP].Out.BufSize = SIM_OUT_SIZE;
+	DevCfg.EpCfg[SIM_EP].Out.MaxPacketSize = SIM_PACKET;
+	DevCfg.EpCfg[SIM_EP].In.Type = (InBufs != 0U) ?
+			XUSBPS_EP_TYPE_BULK : XUSBPS_EP_TYPE_NONE;
+	DevCfg.EpCfg[SIM_EP].In.NumBufs = InBufs;
+	DevCfg.EpCfg[SIM_EP].In.MaxPacketSize = SIM_PACKET;
+	DevCfg.DMAMemPhys = (u32)(UINTPTR)DmaMem;
+
+	Status = XUsbPs_ConfigureDevice(&Usb, &DevCfg);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+	XUsbPs_IntrEnable(&Usb, XUSBPS_IXR_UI_MASK);
+
+	return XST_SUCCESS;
+}
+
+static void Run(const SimRunCfg *RunCfg, u64 Bytes)
+{
+	XUsbPs_StreamStats Stats;
+	u8 *Pool[SIM_MAX_BUFS];
+	u64 StartTime;
+	u64 Elapsed;
+	u64 Rate;
+	u64 Reported;
+	u64 Expect;
+	u32 Index;
+	u32 Len;
+	u32 Pieces;
+	u32 BusPct;
+	int Status;
+
+	Total = Bytes;
+	HostPos = 0U;
+	AppPos = 0U;
+	DoneTime = 0U;
+	DmaErrors = 0U;
+	DataErrors = 0U;
+	BadAccesses = 0U;
+
+	for (Index = 0U; Index < SIM_MAX_BUFS; Index++) {
+		Pool[Index] = PoolMem + (UINTPTR)Index * SIM_MAX_SIZE;
+	}
+
+	Status = Setup(RunCfg->In ? SIM_IN_DTDS : 0U,
+			RunCfg->In ? 0U : RunCfg->NumBufs);
+	Check(Status == XST_SUCCESS, "setup");
+	if (Status != XST_SUCCESS) {
+		return;
+	}
+	StartTime = SimTime;
+	Status = XST_SUCCESS;
+
+	if (!RunCfg->Stream) {
+		/* Fill, send, wait for the last dTD, and again */
+		XUsbPs_EpSetHandler(&Usb, SIM_EP, XUSBPS_EP_DIRECTION_IN,
+				AppTxHandler, NULL);
+		while (AppPos < Total && Status == XST_SUCCESS) {
+			Len = AppFill(NULL, Pool[0], RunCfg->BufSize);
+			Pieces = (Len - 1U) / (XUSBPS_dTD_BUF_MAX_SIZE);
+			WaitPiece = Pool[0] + Pieces * (XUSBPS_dTD_BUF_MAX_SIZE);
+			TxDone = 0;
+			Status = XUsbPs_EpBufferSend(&Usb, SIM_EP, Pool[0], Len);
+			while (Status == XST_SUCCESS && !TxDone) {
+				if (!SimIdle()) {
+					break;
+				}
+			}
+		}
+		Check(Status == XST_SUCCESS, "buffers are queued");
+	} else if (RunCfg->In) {
+		Status = XUsbPs_EpStreamInitIn(&Stream, &Usb, SIM_EP, Pool,
+				(u8)RunCfg->NumBufs, RunCfg->BufSize, AppFill,
+				NULL);
+		if (Status == XST_SUCCESS) {
+			Status = XUsbPs_EpStreamStart(&Stream);
+		}
+		Check(Status == XST_SUCCESS, "IN stream starts");
+		while (Status == XST_SUCCESS && HostPos < Total) {
+			if (!SimIdle()) {
+				break;
+			}
+		}
+	} else {
+		Status = XUsbPs_EpStreamInitOut(&Stream, &Usb, SIM_EP,
+				AppDrain, NULL);
+		if (Status == XST_SUCCESS) {
+			Status = XUsbPs_EpStreamStart(&Stream);
+		}
+		if (Status == XST_SUCCESS) {
+			Status = XUsbPs_EpPrime(&Usb, SIM_EP,
+					XUSBPS_EP_DIRECTION_OUT);
+		}
+		Check(Status == XST_SUCCESS, "OUT stream starts");
+		while (Status == XST_SUCCESS && AppPos < Total) {
+			if (!SimIdle()) {
+				break;
+			}
+		}
+	}
+
+	Check(HostPos == Total && AppPos == Total, "all data is moved");
+	Check(DataErrors == 0U, "data arrives once and in order");
+	Check(DmaErrors == 0U, "dTD page pointers cover the buffers");
+	Check(BadAccesses == 0U, "only controller registers are accessed");
+
+	Elapsed = DoneTime - StartTime;
+	Rate = (Elapsed != 0U) ? (Total * 1000000000ULL) / Elapsed : 0U;
+	BusPct = (Elapsed != 0U) ? (u32)((BusBusy * 1000U) / Elapsed) : 0U;
+
+	if (RunCfg->Stream) {
+		XUsbPs_EpStreamGetStats(&Stream, &Stats);
+		Expect = (Total + RunCfg->BufSize - 1U) / RunCfg->BufSize;
+		Check(Stats.Bytes == Total, "stream counts every byte");
+		Check(Stats.Buffers == Expect, "stream counts every buffer");
+		Reported = XUsbPs_EpStreamGetThroughput(&Stream);
+		Check(Reported > Rate - Rate / 100U &&
+			Reported < Rate + Rate / 100U,
+			"stream reports the measured throughput");
+		if (RunCfg->NumBufs >= 2U) {
+			Check(BusPct >= 990U, "a pool of 2+ buffers keeps "
+				"the bus busy");
+		}
+	}
+
+	printf("%-24s %6llu.%02llu %5u.%u %8u %8u\n", RunCfg->Name,
+		(unsigned long long)(Rate / 1000000U),
+		(unsigned long long)((Rate / 10000U) % 100U),
+		BusPct / 10U, BusPct % 10U, Irqs, Primes);
+}
+
+int main(int argc, char *argv[])
+{
+	static const SimRunCfg Runs[] = {
+		{ "IN  1 buf at a time 16k",	1, 0, 1U, 16U * 1024U },
+		{ "IN  1 buf at a time 64k",	1, 0, 1U, 64U * 1024U },
+		{ "IN  stream 1 x 16k",		1, 1, 1U, 16U * 1024U },
+		{ "IN  stream 2 x 16k",		1, 1, 2U, 16U * 1024U },
+		{ "IN  stream 4 x 16k",		1, 1, 4U, 16U * 1024U },
+		{ "IN  stream 2 x 64k",		1, 1, 2U, 64U * 1024U },
+		{ "OUT stream 1 x 16k",		0, 1, 1U, SIM_OUT_SIZE },
+		{ "OUT stream 2 x 16k",		0, 1, 2U, SIM_OUT_SIZE },
+		{ "OUT stream 4 x 16k",		0, 1, 4U, SIM_OUT_SIZE },
+	};
+	u64 Bytes = 8U * 1024U * 1024U;
+	u32 Index;
+
+	if (argc > 1) {
+		Bytes = strtoull(argv[1], NULL, 0) * 1024U * 1024U;
+	}
+	if (argc > 2) {
+		FillNsPerKb = (u32)strtoul(argv[2], NULL, 0);
+	}
+
+	/* dTDs and buffers are addressed with 32 bits */
+	DmaMem = mmap(NULL, SIM_DMA_BYTES + SIM_MAX_BUFS * SIM_MAX_SIZE,
+			PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+	if (DmaMem == MAP_FAILED) {
+		printf("cannot map memory below 4 GB\n");
+		return 1;
+	}
+	PoolMem = DmaMem + SIM_DMA_BYTES;
+
+	printf("%llu MB per run, %u ns per kB filled or drained\n\n",
+		(unsigned long long)(Bytes / (1024U * 1024U)), FillNsPerKb);
+	printf("                           MB/s   bus %%     irqs   primes\n");
+	for (Index = 0U; Index < sizeof(Runs) / sizeof(Runs[0]); Index++) {
+		Run(&Runs[Index], Bytes);
+	}
+
+	printf("\n%s\n", Failed == 0U ? "all checks passed" : "CHECKS FAILED");
+	return Failed == 0U ? 0 : 1;
+}
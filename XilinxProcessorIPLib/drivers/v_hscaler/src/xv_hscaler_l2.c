@@ -50,6 +50,9 @@
 * 1.00  rco   07/21/15   Initial Release
 * 2.00  rco   11/05/15   Integrate layer-1 with layer-2
 *       dmc   12/17/15   Updated the XV_HScalerDbgReportStatus routine
+* 2.01        10/18/26   Add phase image cache and skip reloading an
+*                        unchanged coefficient table or rewriting the
+*                        coefficients programmed in the core
 *
 * </pre>
 *
@@ -89,6 +92,13 @@ static void CalculatePhases(XV_Hscaler_l2 *HscPtr,
 
 static void XV_HScalerSetCoeff(XV_Hscaler_l2 *HscPtr);
 static void XV_HScalerSetPhase(XV_Hscaler_l2 *HscPtr);
+static u32 XV_HScalerPackPhase(XV_Hscaler_l2 *HscPtr, u32 *Image);
+static XV_Hscaler_PhaseCache *XV_HScalerLookupPhase(XV_Hscaler_l2 *HscPtr,
+                                                    u32 WidthIn,
+                                                    u32 WidthOut,
+                                                    u32 PixelRate);
+static void XV_HScalerWritePhase(XV_Hscaler_l2 *HscPtr,
+                                 const XV_Hscaler_PhaseCache *Entry);
 
 /*****************************************************************************/
 /**
@@ -256,6 +266,12 @@ static void XV_HScalerSelectCoeff(XV_Hscaler_l2 *InstancePtr,
     numTaps = XV_HSCALER_TAPS_6;
   }
 
+  /* Coefficient storage already holds the selected table */
+  if(coeff == InstancePtr->LoadedCoeff)
+  {
+    return;
+  }
+
   XV_HScalerLoadExtCoeff(InstancePtr,
                          numPhases,
                          numTaps,
@@ -263,6 +279,7 @@ static void XV_HScalerSelectCoeff(XV_Hscaler_l2 *InstancePtr,
 
   /* Disable use of external coefficients */
   InstancePtr->UseExtCoeff = FALSE;
+  InstancePtr->LoadedCoeff = coeff;
 }
 
 /*****************************************************************************/
@@ -338,6 +355,26 @@ void XV_HScalerLoadExtCoeff(XV_Hscaler_l2 *InstancePtr,
 
   /* Enable use of external coefficients */
   InstancePtr->UseExtCoeff = TRUE;
+  InstancePtr->LoadedCoeff = NULL;
+  InstancePtr->CoeffProgrammed = FALSE;
+}
+
+/*****************************************************************************/
+/**
+* This function marks the coefficients as not programmed in the core, so that
+* the next setup writes them again. It must be called after the core has been
+* reset.
+*
+* @param  InstancePtr is a pointer to the core instance to be worked on.
+*
+* @return None
+*
+******************************************************************************/
+void XV_HScalerInvalidateCoeff(XV_Hscaler_l2 *InstancePtr)
+{
+  Xil_AssertVoid(InstancePtr != NULL);
+
+  InstancePtr->CoeffProgrammed = FALSE;
 }
 
 /*****************************************************************************/
@@ -513,6 +550,213 @@ static void XV_HScalerSetPhase(XV_Hscaler_l2 *HscPtr)
 }
 
 
+/*****************************************************************************/
+/**
+* This function packs the computed phase data into the layout of the phase
+* register bank, as written by XV_HScalerSetPhase
+*
+* @param  HscPtr is a pointer to the core instance to be worked on.
+* @param  Image is the buffer for the packed phase data
+*
+* @return Number of 32 bit words in Image
+*
+******************************************************************************/
+static u32 XV_HScalerPackPhase(XV_Hscaler_l2 *HscPtr, u32 *Image)
+{
+  u32 loopWidth, index, i;
+
+  loopWidth = HscPtr->Hsc.Config.MaxWidth/HscPtr->Hsc.Config.PixPerClk;
+  index = 0;
+  switch(HscPtr->Hsc.Config.PixPerClk)
+  {
+    case XVIDC_PPC_1:
+            /* 16bit LSB from 2 consecutive entries per word */
+            for(i=0; i < loopWidth; i+=2)
+            {
+              Image[index++] =
+                  ((u32)(HscPtr->phasesH[i+1] & (u64)XHSC_MASK_LOW_16BITS) << 16) |
+                   (u32)(HscPtr->phasesH[i]   & (u64)XHSC_MASK_LOW_16BITS);
+            }
+            break;
+
+    case XVIDC_PPC_2:
+            /* Lower 32b of each entry */
+            for(i=0; i < loopWidth; ++i)
+            {
+              Image[index++] = (u32)(HscPtr->phasesH[i] & XHSC_MASK_LOW_32BITS);
+            }
+            break;
+
+    case XVIDC_PPC_4:
+            /* 32b LSB then 32b MSB of each entry */
+            for(i=0; i < loopWidth; ++i)
+            {
+              Image[index++] = (u32)(HscPtr->phasesH[i] & XHSC_MASK_LOW_32BITS);
+              Image[index++] = (u32)((HscPtr->phasesH[i]>>32) & XHSC_MASK_LOW_32BITS);
+            }
+            break;
+
+    default:
+            break;
+  }
+
+  return(index);
+}
+
+/*****************************************************************************/
+/**
+* This function looks up the phase image for the given input and output width
+* in the phase cache. On a miss the phases are computed and packed into the
+* least recently used entry.
+*
+* @param  HscPtr is a pointer to the core instance to be worked on.
+* @param  WidthIn is the input frame width
+* @param  WidthOut is the scaled frame width
+* @param  PixelRate is the number of pixels per clock being processed
+*
+* @return Pointer to the cache entry
+*
+******************************************************************************/
+static XV_Hscaler_PhaseCache *XV_HScalerLookupPhase(XV_Hscaler_l2 *HscPtr,
+                                                    u32 WidthIn,
+                                                    u32 WidthOut,
+                                                    u32 PixelRate)
+{
+  XV_Hscaler_PhaseCache *Entry;
+  XV_Hscaler_PhaseCache *Victim = NULL;
+  u32 i;
+
+  HscPtr->PhaseCacheTick++;
+
+  for(i=0; i < HscPtr->PhaseCacheSize; ++i)
+  {
+    Entry = &HscPtr->PhaseCache[i];
+    if((Entry->WidthIn == WidthIn) && (Entry->WidthOut == WidthOut))
+    {
+      Entry->LastUsed = HscPtr->PhaseCacheTick;
+      HscPtr->PhaseCacheHits++;
+      return(Entry);
+    }
+
+    /* Unused entries have LastUsed 0 and are picked first */
+    if((Victim == NULL) || (Entry->LastUsed < Victim->LastUsed))
+    {
+      Victim = Entry;
+    }
+  }
+
+  /* Compute Phase for 1 line and pack it in the register layout */
+  CalculatePhases(HscPtr, WidthIn, WidthOut, PixelRate);
+
+  Victim->NumWords = XV_HScalerPackPhase(HscPtr, Victim->Phase);
+  Victim->WidthIn  = WidthIn;
+  Victim->WidthOut = WidthOut;
+  Victim->LastUsed = HscPtr->PhaseCacheTick;
+  HscPtr->PhaseCacheMisses++;
+
+  return(Victim);
+}
+
+/*****************************************************************************/
+/**
+* This function writes a packed phase image into core registers
+*
+* @param  HscPtr is a pointer to the core instance to be worked on.
+* @param  Entry is the phase cache entry to be programmed
+*
+* @return None
+*
+******************************************************************************/
+static void XV_HScalerWritePhase(XV_Hscaler_l2 *HscPtr,
+                                 const XV_Hscaler_PhaseCache *Entry)
+{
+  const u32 *Phase = Entry->Phase;
+  u32 baseAddr, i;
+
+  baseAddr = XV_hscaler_Get_HwReg_phasesH_V_BaseAddress(&HscPtr->Hsc);
+  for(i=0; i < Entry->NumWords; ++i)
+  {
+    Xil_Out32(baseAddr+(i*4), Phase[i]);
+  }
+}
+
+/*****************************************************************************/
+/**
+* This function sets up the phase cache. Entries are owned by the caller and
+* must stay allocated while the cache is in use. Any previous content of the
+* entries is discarded.
+*
+* @param  InstancePtr is a pointer to the core instance to be worked on.
+* @param  Cache is a pointer to an array of cache entries, or NULL to disable
+*         the cache
+* @param  NumEntries is the number of entries in the array
+*
+* @return None
+*
+******************************************************************************/
+void XV_HScalerSetPhaseCache(XV_Hscaler_l2 *InstancePtr,
+                             XV_Hscaler_PhaseCache *Cache,
+                             u16 NumEntries)
+{
+  /*
+   * validate input arguments
+   */
+  Xil_AssertVoid(InstancePtr != NULL);
+  Xil_AssertVoid((Cache != NULL) || (NumEntries == 0));
+
+  if(NumEntries == 0)
+  {
+    Cache = NULL;
+  }
+  else
+  {
+    memset(Cache, 0, NumEntries*sizeof(XV_Hscaler_PhaseCache));
+  }
+
+  InstancePtr->PhaseCache       = Cache;
+  InstancePtr->PhaseCacheSize   = NumEntries;
+  InstancePtr->PhaseCacheTick   = 0;
+  InstancePtr->PhaseCacheHits   = 0;
+  InstancePtr->PhaseCacheMisses = 0;
+}
+
+/*****************************************************************************/
+/**
+* This function computes the phase image for the given input and output width
+* and stores it in the phase cache without programming the core. It is meant
+* to prebuild the cache for the video modes the system switches between.
+*
+* @param  InstancePtr is a pointer to the core instance to be worked on.
+* @param  WidthIn is the input stream width
+* @param  WidthOut is the output stream width
+*
+* @return XST_SUCCESS if the phase image is in the cache
+*         XST_FAILURE if no phase cache is set up
+*
+******************************************************************************/
+int XV_HScalerFillPhaseCache(XV_Hscaler_l2 *InstancePtr,
+                             u32 WidthIn,
+                             u32 WidthOut)
+{
+  /*
+   * Assert validates the input arguments
+   */
+  Xil_AssertNonvoid(InstancePtr != NULL);
+  Xil_AssertNonvoid((WidthIn>0) && (WidthIn<=InstancePtr->Hsc.Config.MaxWidth));
+  Xil_AssertNonvoid((WidthOut>0) && (WidthOut<=InstancePtr->Hsc.Config.MaxWidth));
+
+  if(InstancePtr->PhaseCache == NULL)
+  {
+    return XST_FAILURE;
+  }
+
+  XV_HScalerLookupPhase(InstancePtr, WidthIn, WidthOut,
+                        (WidthIn * STEP_PRECISION)/WidthOut);
+
+  return XST_SUCCESS;
+}
+
+
 /*****************************************************************************/
 /**
 * This function programs the filter coefficients and phase data into core
@@ -533,6 +777,12 @@ static void XV_HScalerSetCoeff(XV_Hscaler_l2 *HscPtr)
   int val,i,j,offset,rdIndx;
   u32 baseAddr;
 
+  /* Core registers already hold the coefficients */
+  if(HscPtr->CoeffProgrammed)
+  {
+    return;
+  }
+
   offset = (XV_HSCALER_MAX_H_TAPS - HscPtr->Hsc.Config.NumTaps)/2;
   baseAddr = XV_hscaler_Get_HwReg_hfltCoeff_BaseAddress(&HscPtr->Hsc);
   for (i = 0; i < num_phases; i++)
@@ -544,6 +794,7 @@ static void XV_HScalerSetCoeff(XV_Hscaler_l2 *HscPtr)
        Xil_Out32(baseAddr+((i*num_taps+j)*4), val);
     }
   }
+  HscPtr->CoeffProgrammed = TRUE;
 }
 
 /*****************************************************************************/
@@ -596,11 +847,21 @@ int XV_HScalerSetup(XV_Hscaler_l2  *InstancePtr,
     XV_HScalerSetCoeff(InstancePtr);
   }
 
-  /* Compute Phase for 1 line */
-  CalculatePhases(InstancePtr, WidthIn, WidthOut, PixelRate);
+  if(InstancePtr->PhaseCache != NULL)
+  {
+    /* Program the cached Phase, computing it on a miss */
+    XV_HScalerWritePhase(InstancePtr,
+                         XV_HScalerLookupPhase(InstancePtr, WidthIn,
+                                               WidthOut, PixelRate));
+  }
+  else
+  {
+    /* Compute Phase for 1 line */
+    CalculatePhases(InstancePtr, WidthIn, WidthOut, PixelRate);
 
-  /* Program computed Phase into the IP register bank */
-  XV_HScalerSetPhase(InstancePtr);
+    /* Program computed Phase into the IP register bank */
+    XV_HScalerSetPhase(InstancePtr);
+  }
 
   XV_hscaler_Set_HwReg_Height(&InstancePtr->Hsc,     HeightIn);
   XV_hscaler_Set_HwReg_WidthIn(&InstancePtr->Hsc,    WidthIn);
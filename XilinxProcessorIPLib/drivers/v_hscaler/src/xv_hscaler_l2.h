@@ -70,6 +70,16 @@
 * Advanced users always have the capability to directly interact with the IP
 * core using Layer-1 API's that perform low level register peek/poke.
 *
+* <b> Phase Cache </b>
+*
+* Computing the phases of a line is the slowest part of XV_HScalerSetup().
+* Systems that switch between a known set of resolutions can hand the driver
+* an array of XV_Hscaler_PhaseCache entries with XV_HScalerSetPhaseCache().
+* The packed phase image of each input/output width pair is then computed
+* once and written to the core as is on later setups, replacing the least
+* recently used entry when the cache is full. XV_HScalerFillPhaseCache() can
+* be used at start-up to prebuild the entries for the expected video modes.
+*
 * <b> Interrupts </b>
 *
 * This driver does not have any interrupts
@@ -95,6 +105,9 @@
 * 2.00  rco   11/05/15   Integrate layer-1 with layer-2
 *       dmc   12/17/15   Add macro to query the Is422Enabled flag that was
 *                        added to the XV_hscaler_Config structure
+* 2.01        10/18/26   Add cache of packed phase images and skip reloading
+*                        an unchanged coefficient table. Added
+*                        XV_HScalerInvalidateCoeff
 * </pre>
 *
 ******************************************************************************/
@@ -116,6 +129,7 @@ extern "C" {
 #define XV_HSCALER_MAX_H_TAPS           (12)
 #define XV_HSCALER_MAX_H_PHASES         (64)
 #define XV_HSCALER_MAX_LINE_WIDTH       (3840)
+#define XV_HSCALER_MAX_PHASE_WORDS      (XV_HSCALER_MAX_LINE_WIDTH/2)
 
 /**************************** Type Definitions *******************************/
 /**
@@ -139,6 +153,19 @@ typedef enum
   XV_HSCALER_TAPS_12 = 12
 }XV_HSCALER_TAPS;
 
+/**
+ * Phase cache entry. Holds the phase register bank image for one input and
+ * output width, packed in the layout written to the core.
+ */
+typedef struct
+{
+  u32 WidthIn;   /*<< Input width, 0 if the entry is unused */
+  u32 WidthOut;  /*<< Output width */
+  u32 LastUsed;  /*<< Setup count at the last use, for LRU replacement */
+  u32 NumWords;  /*<< Number of valid words in Phase */
+  u32 Phase[XV_HSCALER_MAX_PHASE_WORDS];
+}XV_Hscaler_PhaseCache;
+
 /**
  * H Scaler Layer 2 data. The user is required to allocate a variable
  * of this type for every H Scaler device in the system. A pointer to a
@@ -150,6 +177,13 @@ typedef struct
   u8 UseExtCoeff;
   short coeff[XV_HSCALER_MAX_H_PHASES][XV_HSCALER_MAX_H_TAPS];
   u64 phasesH[XV_HSCALER_MAX_LINE_WIDTH];
+  const short *LoadedCoeff; /*<< Fixed table held in coeff, NULL if none */
+  u8 CoeffProgrammed;      /*<< coeff is programmed in the core registers */
+  XV_Hscaler_PhaseCache *PhaseCache; /*<< User allocated phase cache */
+  u16 PhaseCacheSize;      /*<< Number of entries in PhaseCache */
+  u32 PhaseCacheTick;      /*<< Setup count used for LRU replacement */
+  u32 PhaseCacheHits;
+  u32 PhaseCacheMisses;
 }XV_Hscaler_l2;
 
 /************************** Macros Definitions *******************************/
@@ -174,11 +208,18 @@ void XV_HScalerLoadExtCoeff(XV_Hscaler_l2 *InstancePtr,
                             u16 num_phases,
                             u16 num_taps,
                             const short *Coeff);
+void XV_HScalerInvalidateCoeff(XV_Hscaler_l2 *InstancePtr);
 int XV_HScalerSetup(XV_Hscaler_l2  *InstancePtr,
                      u32 HeightIn,
                      u32 WidthIn,
                      u32 WidthOut,
                      u32 cformat);
+void XV_HScalerSetPhaseCache(XV_Hscaler_l2 *InstancePtr,
+                             XV_Hscaler_PhaseCache *Cache,
+                             u16 NumEntries);
+int XV_HScalerFillPhaseCache(XV_Hscaler_l2 *InstancePtr,
+                             u32 WidthIn,
+                             u32 WidthOut);
 
 void XV_HScalerDbgReportStatus(XV_Hscaler_l2 *InstancePtr);
 
@@ -0,0 +1,353 @@
+/******************************************************************************
+ *
+ * Copyright (C) 2015 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * XILINX CONSORTIUM BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ *
+******************************************************************************/
+/*****************************************************************************/
+/**
+* @file xv_hscaler_setup_sim.c
+*
+* Host test and benchmark of XV_HScalerSetup against a simulated register
+* space.
+*
+* Each check drives two instances through the same sequence of setups. The
+* reference instance has no phase cache and its coefficients are invalidated
+* before every setup, which is how the driver behaved before version 2.01.
+* After every setup the register banks of both instances must be equal, up
+* to the phase words of the active line.
+*
+* Checked, for 1, 2 and 4 pixels per clock:
+*  - the register banks match while switching between modes that select
+*    different coefficient tables,
+*  - coefficient writes are skipped while the selected table is unchanged,
+*  - XV_HScalerLoadExtCoeff and XV_HScalerInvalidateCoeff make the next
+*    setup write the coefficients again,
+*  - the phase cache hit and miss counts.
+*
+* The benchmark runs repeated and alternating resolution changes and prints
+* the register writes and the host time of one setup. On MicroBlaze each
+* AXI-Lite write costs tens of processor cycles, so the writes dominate.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who    Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 2.01        10/18/26   First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "xil_io.h"
+#include "xparameters.h"
+#include "xv_hscaler_l2.h"
+
+/************************** Constant Definitions *****************************/
+#define REG_SPACE       (0x4000)     /**< Size of the register bank */
+#define OPT_BASE        (0x40000000) /**< Instance under test */
+#define REF_BASE        (0x40010000) /**< Reference instance */
+#define CACHE_ENTRIES   (4)
+#define BENCH_SETUPS    (200)
+#define BENCH_RUNS      (5)
+
+#define COEFF_BASE      XV_HSCALER_CTRL_ADDR_HWREG_HFLTCOEFF_BASE
+#define COEFF_WORDS     XV_HSCALER_CTRL_DEPTH_HWREG_HFLTCOEFF
+#define PHASE_BASE      XV_HSCALER_CTRL_ADDR_HWREG_PHASESH_V_BASE
+#define PHASE_HIGH      XV_HSCALER_CTRL_ADDR_HWREG_PHASESH_V_HIGH
+
+/**************************** Type Definitions *******************************/
+typedef struct
+{
+  u32 WidthIn;
+  u32 WidthOut;
+} Mode;
+
+/************************** Variable Definitions *****************************/
+static u32 Regs[2][REG_SPACE/4];
+static u32 Writes;       /**< Register writes to the instance under test */
+static u32 CoeffWrites;
+static u32 PhaseWrites;
+static u32 Failed;
+
+static XV_Hscaler_l2 Opt;
+static XV_Hscaler_l2 Ref;
+static XV_Hscaler_PhaseCache Cache[CACHE_ENTRIES];
+
+/* Scaling ratios 2, 1/1.5, 1, 2, 1.5, 1/1.5, 3 and 1.5 select the 8, 6, 6,
+   8, 6, 6, 10 and 6 tap tables of a 12 tap core */
+static const Mode Modes[] =
+{
+  {3840, 1920}, {1280, 1920}, {1920, 1920}, {3840, 1920},
+  {1920, 1280}, {1280, 1920}, {3840, 1280}, {1920, 1280}
+};
+
+/************************** Function Definitions *****************************/
+static void Check(u32 Cond, const char *What)
+{
+  if(!Cond)
+  {
+    printf("FAILED: %s\n", What);
+    Failed++;
+  }
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+  return(Regs[(Addr >= REF_BASE)][(Addr & (REG_SPACE-1))/4]);
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+  u32 Off = Addr & (REG_SPACE-1);
+
+  Regs[(Addr >= REF_BASE)][Off/4] = Value;
+  if(Addr < REF_BASE)
+  {
+    Writes++;
+    CoeffWrites += ((Off >= COEFF_BASE) && (Off < COEFF_BASE + COEFF_WORDS*4));
+    PhaseWrites += ((Off >= PHASE_BASE) && (Off <= PHASE_HIGH));
+  }
+}
+
+/* Configuration table, entry 0 is the instance under test and entry 1 the
+   reference instance */
+XV_hscaler_Config XV_hscaler_ConfigTable[XPAR_XV_HSCALER_NUM_INSTANCES];
+
+static void InitInstance(XV_Hscaler_l2 *InstancePtr, u16 DeviceId, u16 Ppc)
+{
+  XV_hscaler_Config *ConfigPtr = &XV_hscaler_ConfigTable[DeviceId];
+
+  ConfigPtr->DeviceId         = DeviceId;
+  ConfigPtr->BaseAddress      = (DeviceId == 0) ? OPT_BASE : REF_BASE;
+  ConfigPtr->PixPerClk        = Ppc;
+  ConfigPtr->NumVidComponents = 3;
+  ConfigPtr->MaxWidth         = XV_HSCALER_MAX_LINE_WIDTH;
+  ConfigPtr->MaxHeight        = 2160;
+  ConfigPtr->MaxDataWidth     = 8;
+  ConfigPtr->PhaseShift       = 6;
+  ConfigPtr->ScalerType       = XV_HSCALER_POLYPHASE;
+  ConfigPtr->NumTaps          = XV_HSCALER_TAPS_12;
+  ConfigPtr->Is422Enabled     = TRUE;
+
+  Check(XV_HScalerInitialize(InstancePtr, DeviceId) == XST_SUCCESS,
+        "initialize");
+}
+
+static void Setup(XV_Hscaler_l2 *InstancePtr, const Mode *ModePtr)
+{
+  XV_HScalerSetup(InstancePtr, 1080, ModePtr->WidthIn, ModePtr->WidthOut,
+                  XVIDC_CSF_YCRCB_444);
+}
+
+/* Previous behaviour: no phase cache, coefficients written every time */
+static void SetupRef(const Mode *ModePtr)
+{
+  XV_HScalerInvalidateCoeff(&Ref);
+  Setup(&Ref, ModePtr);
+}
+
+/* Compares the register banks of both instances. Phase words past the active
+   line are left over from earlier setups and are not read by the core. */
+static u32 Match(u16 Ppc, const Mode *ModePtr)
+{
+  u32 Width = (ModePtr->WidthIn > ModePtr->WidthOut) ? ModePtr->WidthIn
+                                                     : ModePtr->WidthOut;
+  u32 LoopWidth = (Width + Ppc - 1)/Ppc;
+  u32 PhaseWords;
+
+  switch(Ppc)
+  {
+    case XVIDC_PPC_1: PhaseWords = (LoopWidth + 1)/2; break;
+    case XVIDC_PPC_4: PhaseWords = LoopWidth*2;       break;
+    default:          PhaseWords = LoopWidth;         break;
+  }
+
+  return((memcmp(Regs[0], Regs[1], PHASE_BASE) == 0) &&
+         (memcmp(&Regs[0][PHASE_BASE/4], &Regs[1][PHASE_BASE/4],
+                 PhaseWords*4) == 0));
+}
+
+static void TestPpc(u16 Ppc)
+{
+  static short ExtCoeff[XV_HSCALER_MAX_H_PHASES][XV_HSCALER_TAPS_6];
+  u32 NumModes = sizeof(Modes)/sizeof(Modes[0]);
+  u32 Round, i, j;
+  char What[96];
+
+  memset(Regs, 0, sizeof(Regs));
+  InitInstance(&Opt, 0, Ppc);
+  InitInstance(&Ref, 1, Ppc);
+  XV_HScalerSetPhaseCache(&Opt, Cache, CACHE_ENTRIES);
+
+  /* Two rounds, the second one hits the phase cache for the modes that
+     survived the LRU replacement */
+  for(Round = 0; Round < 2; ++Round)
+  {
+    for(i = 0; i < NumModes; ++i)
+    {
+      CoeffWrites = 0;
+      Setup(&Opt, &Modes[i]);
+      SetupRef(&Modes[i]);
+
+      snprintf(What, sizeof(What), "%u PPC, %u->%u registers match",
+               Ppc, Modes[i].WidthIn, Modes[i].WidthOut);
+      Check(Match(Ppc, &Modes[i]), What);
+
+      /* The table changes with every mode except the second of the two
+         consecutive 6 tap modes */
+      snprintf(What, sizeof(What), "%u PPC, %u->%u coefficient writes",
+               Ppc, Modes[i].WidthIn, Modes[i].WidthOut);
+      if((i == 2) || (i == 5))
+      {
+        Check(CoeffWrites == 0, What);
+      }
+      else
+      {
+        Check(CoeffWrites == XV_HSCALER_MAX_H_PHASES*XV_HSCALER_TAPS_12/2,
+              What);
+      }
+    }
+  }
+  snprintf(What, sizeof(What), "%u PPC, phase cache hits %u misses %u",
+           Ppc, Opt.PhaseCacheHits, Opt.PhaseCacheMisses);
+  Check((Opt.PhaseCacheHits + Opt.PhaseCacheMisses == 2*NumModes) &&
+        (Opt.PhaseCacheHits > 0), What);
+
+  /* Same mode again, nothing but the phases and the size registers */
+  CoeffWrites = 0;
+  Setup(&Opt, &Modes[NumModes-1]);
+  Check(CoeffWrites == 0, "repeated setup skips the coefficients");
+
+  /* User coefficients */
+  for(i = 0; i < XV_HSCALER_MAX_H_PHASES; ++i)
+  {
+    for(j = 0; j < XV_HSCALER_TAPS_6; ++j)
+    {
+      ExtCoeff[i][j] = (short)(i*16 + j + 1);
+    }
+  }
+  XV_HScalerLoadExtCoeff(&Opt, XV_HSCALER_MAX_H_PHASES, XV_HSCALER_TAPS_6,
+                         &ExtCoeff[0][0]);
+  XV_HScalerLoadExtCoeff(&Ref, XV_HSCALER_MAX_H_PHASES, XV_HSCALER_TAPS_6,
+                         &ExtCoeff[0][0]);
+  CoeffWrites = 0;
+  Setup(&Opt, &Modes[0]);
+  SetupRef(&Modes[0]);
+  Check(CoeffWrites != 0, "external coefficients are written");
+  Check(Match(Ppc, &Modes[0]), "external coefficients, registers match");
+
+  CoeffWrites = 0;
+  Setup(&Opt, &Modes[1]);
+  Check(CoeffWrites == 0, "external coefficients are written once");
+
+  /* Core reset */
+  memset(&Regs[0][COEFF_BASE/4], 0, COEFF_WORDS*4);
+  XV_HScalerInvalidateCoeff(&Opt);
+  CoeffWrites = 0;
+  Setup(&Opt, &Modes[1]);
+  SetupRef(&Modes[1]);
+  Check(CoeffWrites != 0, "invalidated coefficients are written");
+  Check(Match(Ppc, &Modes[1]), "after reset, registers match");
+}
+
+static u64 HostNs(void)
+{
+  struct timespec Ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &Ts);
+  return(((u64)Ts.tv_sec * 1000000000ULL) + (u64)Ts.tv_nsec);
+}
+
+/* Runs BENCH_SETUPS setups cycling through NumModes modes and prints the
+   writes and the best host time of one setup */
+static void Bench(const char *Name, const Mode *ModeList, u32 NumModes)
+{
+  static const char *Configs[] =
+  {
+    "previous", "coefficients skipped", "and phase cache"
+  };
+  u32 Config, Run, i;
+  u64 Start, Ns, Best;
+  u32 SetupWrites = 0;
+
+  printf("%s\n", Name);
+  for(Config = 0; Config < 3; ++Config)
+  {
+    InitInstance(&Opt, 0, XVIDC_PPC_2);
+    if(Config == 2)
+    {
+      XV_HScalerSetPhaseCache(&Opt, Cache, CACHE_ENTRIES);
+    }
+
+    Best = 0;
+    for(Run = 0; Run < BENCH_RUNS; ++Run)
+    {
+      Writes = 0;
+      Start = HostNs();
+      for(i = 0; i < BENCH_SETUPS; ++i)
+      {
+        if(Config == 0)
+        {
+          XV_HScalerInvalidateCoeff(&Opt);
+        }
+        Setup(&Opt, &ModeList[i % NumModes]);
+      }
+      Ns = HostNs() - Start;
+      if((Run == 0) || (Ns < Best))
+      {
+        Best = Ns;
+      }
+      SetupWrites = Writes/BENCH_SETUPS;
+    }
+    printf("  %-22s %5u writes  %6.1f us\n", Configs[Config], SetupWrites,
+           (double)Best/BENCH_SETUPS/1000.0);
+  }
+}
+
+int main(void)
+{
+  static const Mode Same[] = { {1920, 1280} };
+  static const Mode Alternate[] = { {3840, 1920}, {1280, 1920} };
+
+  TestPpc(XVIDC_PPC_1);
+  TestPpc(XVIDC_PPC_2);
+  TestPpc(XVIDC_PPC_4);
+
+  printf("Setup of a 12 tap, 2 pixels per clock core, per setup\n");
+  Bench("repeated 1920->1280", Same, 1);
+  Bench("alternating 3840->1920 and 1280->1920", Alternate, 2);
+
+  printf("\n%s\n", (Failed == 0U) ? "all checks passed" : "CHECKS FAILED");
+  return((Failed == 0U) ? 0 : 1);
+}
@@ -49,6 +49,8 @@
 * ----- ---- -------- -------------------------------------------------------
 * 1.00  rco   07/21/15   Initial Release
 * 2.00  rco   11/05/15   Integrate layer-1 with layer-2
+* 2.01        10/18/26   Skip reloading an unchanged coefficient table or
+*                        rewriting the coefficients programmed in the core
 *
 * </pre>
 *
@@ -244,6 +246,12 @@ static void XV_VScalerSelectCoeff(XV_Vscaler_l2 *InstancePtr,
     numTaps = XV_VSCALER_TAPS_6;
   }
 
+  /* Coefficient storage already holds the selected table */
+  if(coeff == InstancePtr->LoadedCoeff)
+  {
+    return;
+  }
+
   XV_VScalerLoadExtCoeff(InstancePtr,
 		                 numPhases,
 		                 numTaps,
@@ -251,6 +259,7 @@ static void XV_VScalerSelectCoeff(XV_Vscaler_l2 *InstancePtr,
 
   /* Disable use of external coefficients */
   InstancePtr->UseExtCoeff = FALSE;
+  InstancePtr->LoadedCoeff = coeff;
 }
 
 /*****************************************************************************/
@@ -326,6 +335,26 @@ void XV_VScalerLoadExtCoeff(XV_Vscaler_l2 *InstancePtr,
 
   /* Enable use of external coefficients */
   InstancePtr->UseExtCoeff = TRUE;
+  InstancePtr->LoadedCoeff = NULL;
+  InstancePtr->CoeffProgrammed = FALSE;
+}
+
+/*****************************************************************************/
+/**
+* This function marks the coefficients as not programmed in the core, so that
+* the next setup writes them again. It must be called after the core has been
+* reset.
+*
+* @param  InstancePtr is a pointer to the core instance to be worked on.
+*
+* @return None
+*
+******************************************************************************/
+void XV_VScalerInvalidateCoeff(XV_Vscaler_l2 *InstancePtr)
+{
+  Xil_AssertVoid(InstancePtr != NULL);
+
+  InstancePtr->CoeffProgrammed = FALSE;
 }
 
 /*****************************************************************************/
@@ -352,6 +381,12 @@ static void XV_VScalerSetCoeff(XV_Vscaler_l2 *VscPtr)
   int val,i,j,offset,rdIndx;
   u32 baseAddr;
 
+  /* Core registers already hold the coefficients */
+  if(VscPtr->CoeffProgrammed)
+  {
+    return;
+  }
+
   offset = (XV_VSCALER_MAX_V_TAPS - VscPtr->Vsc.Config.NumTaps)/2;
   baseAddr = XV_vscaler_Get_HwReg_vfltCoeff_BaseAddress(&VscPtr->Vsc);
   for (i=0; i < num_phases; i++)
@@ -363,6 +398,7 @@ static void XV_VScalerSetCoeff(XV_Vscaler_l2 *VscPtr)
        Xil_Out32(baseAddr+((i*num_taps+j)*4), val);
     }
   }
+  VscPtr->CoeffProgrammed = TRUE;
 }
 
 /*****************************************************************************/
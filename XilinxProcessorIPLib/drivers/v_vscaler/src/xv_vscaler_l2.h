@@ -93,6 +93,8 @@
 * ----- ---- -------- -------------------------------------------------------
 * 1.00  rco   07/21/15   Initial Release
 * 2.00  rco   11/05/15   Integrate layer-1 with layer-2
+* 2.01        10/18/26   Add LoadedCoeff to skip reloading an unchanged
+*                        coefficient table. Added XV_VScalerInvalidateCoeff
 *
 * </pre>
 *
@@ -148,6 +150,8 @@ typedef struct
   XV_vscaler Vsc; /*<< Layer 1 instance */
   u8 UseExtCoeff;
   short coeff[XV_VSCALER_MAX_V_PHASES][XV_VSCALER_MAX_V_TAPS];
+  const short *LoadedCoeff; /*<< Fixed table held in coeff, NULL if none */
+  u8 CoeffProgrammed;      /*<< coeff is programmed in the core registers */
 }XV_Vscaler_l2;
 
 /************************** Macros Definitions *******************************/
@@ -160,6 +164,7 @@ void XV_VScalerLoadExtCoeff(XV_Vscaler_l2 *InstancePtr,
                             u16 num_phases,
                             u16 num_taps,
                             const short *Coeff);
+void XV_VScalerInvalidateCoeff(XV_Vscaler_l2 *InstancePtr);
 void XV_VScalerSetup(XV_Vscaler_l2 *InstancePtr,
                      u32 WidthIn,
                      u32 HeightIn,
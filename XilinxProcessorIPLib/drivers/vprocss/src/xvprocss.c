@@ -53,6 +53,7 @@
 *       dmc  02/17/16   Modify timing and placement of axis and aximm resets
 *       dmc  02/24/16   Rename some constants and variables
 *       dmc  03/03/16   Init VideoStream structs to 0 in SetPowerOnDefaultState
+* 2.01       10/18/26   Invalidate the scaler coefficients on reset
 * </pre>
 *
 ******************************************************************************/
@@ -776,6 +777,14 @@ void XVprocSs_Reset(XVprocSs *InstancePtr)
   /* Reset start core flags */
   memset(InstancePtr->CtxtData.StartCore, 0, sizeof(InstancePtr->CtxtData.StartCore));
 
+  /* Scaler coefficients must be programmed again after the reset */
+  if(InstancePtr->HscalerPtr) {
+    XV_HScalerInvalidateCoeff(InstancePtr->HscalerPtr);
+  }
+  if(InstancePtr->VscalerPtr) {
+    XV_VScalerInvalidateCoeff(InstancePtr->VscalerPtr);
+  }
+
   XVprocSs_LogWrite(InstancePtr, XVPROCSS_EVT_RESET_VPSS, XVPROCSS_EDAT_SUCCESS);
 }
 
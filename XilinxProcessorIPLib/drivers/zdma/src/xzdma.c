@@ -904,6 +904,7 @@ static void XZDma_ScatterGather(XZDma *InstancePtr, XZDma_Transfer *Data,
 								u32 Num)
 {
 	u32 Count = 0x00U;
+	u32 DscrSize;
 	u8 Last;
 	XZDma_Transfer *LocalData = Data;
 	XZDma_LiDscr *LiSrcDscr =
@@ -949,6 +950,18 @@ static void XZDma_ScatterGather(XZDma *InstancePtr, XZDma_Transfer *Data,
 		} while(Count < Num);
 	}
 
+	/* Flush the source and destination lists, one range each */
+	if (InstancePtr->Descriptor.DscrType == XZDMA_LINEAR) {
+		DscrSize = sizeof(XZDma_LiDscr) * Num;
+	}
+	else {
+		DscrSize = sizeof(XZDma_LlDscr) * Num;
+	}
+	Xil_DCacheFlushRange((INTPTR)InstancePtr->Descriptor.SrcDscrPtr,
+							DscrSize);
+	Xil_DCacheFlushRange((INTPTR)InstancePtr->Descriptor.DstDscrPtr,
+							DscrSize);
+
 	XZDma_WriteReg(InstancePtr->Config.BaseAddress,
 		XZDMA_CH_SRC_START_LSB_OFFSET,
 		((UINTPTR)(InstancePtr->Descriptor.SrcDscrPtr) &
@@ -1053,9 +1066,6 @@ static void XZDma_ConfigLinear(XZDma_LiDscr *DscrPtr, u64 Addr, u32 Size,
 	DscrPtr->Address = Addr;
 	DscrPtr->Size = Size & XZDMA_WORD2_SIZE_MASK;
 	DscrPtr->Cntl = CtrlValue;
-
-	Xil_DCacheFlushRange((UINTPTR)DscrPtr, sizeof(XZDma_LlDscr));
-
 }
 
 /*****************************************************************************/
@@ -1162,8 +1172,6 @@ static void XZDma_ConfigLinkedList(XZDma_LlDscr *DscrPtr, u64 Addr, u32 Size,
 	DscrPtr->Cntl = CtrlValue;
 	DscrPtr->NextDscr = NextDscrAddr;
 	DscrPtr->Reserved = 0U;
-
-	Xil_DCacheFlushRange((UINTPTR)DscrPtr, sizeof(XZDma_LlDscr));
 }
 
 /*****************************************************************************/
@@ -104,6 +104,13 @@ void XZDma_IntrHandler(void *Instance)
 	PendingIntr = (u32)(XZDma_IntrGetStatus(InstancePtr));
 	PendingIntr &= (~XZDma_GetIntrMask(InstancePtr));
 
+	/*
+	 * Clear pending interrupt(s) before calling the handlers, a done
+	 * handler may start the next transfer and its interrupt must not be
+	 * cleared along with this one
+	 */
+	XZDma_IntrClear(InstancePtr, PendingIntr);
+
 	/* ZDMA transfer has completed */
 	ErrorStatus = (PendingIntr) & (XZDMA_IXR_DMA_DONE_MASK);
 	if ((ErrorStatus) != 0U) {
@@ -129,9 +136,6 @@ void XZDma_IntrHandler(void *Instance)
 		}
 		InstancePtr->ErrorHandler(InstancePtr->ErrorRef, ErrorStatus);
 	}
-
-	/* Clear pending interrupt(s) */
-	XZDma_IntrClear(InstancePtr, PendingIntr);
 }
 
 /*****************************************************************************/
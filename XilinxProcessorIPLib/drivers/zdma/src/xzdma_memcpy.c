@@ -0,0 +1,491 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xzdma_memcpy.c
+* @addtogroup zdma_v1_0
+* @{
+*
+* This file contains the asynchronous memory copy service of the ZDMA driver.
+* Please see xzdma_memcpy.h for more details.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who     Date     Changes
+* ----- ------  -------- ------------------------------------------------------
+* 1.2           10/18/26 First release
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xzdma_memcpy.h"
+#include "xil_exception.h"
+
+/************************** Constant Definitions *****************************/
+
+/* Channel interrupts the service relies on */
+#define XZDMA_MEMCPY_INTR_MASK	(XZDMA_IXR_DMA_DONE_MASK | \
+				 XZDMA_IXR_AXI_WR_DATA_MASK | \
+				 XZDMA_IXR_AXI_RD_DATA_MASK | \
+				 XZDMA_IXR_AXI_RD_DST_DSCR_MASK | \
+				 XZDMA_IXR_AXI_RD_SRC_DSCR_MASK)
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+
+/**************************** Type Definitions *******************************/
+
+
+/************************** Function Prototypes ******************************/
+
+static u32 XZDma_MemcpyLock(void);
+static void XZDma_MemcpyUnlock(u32 IrqWasEnabled);
+static void XZDma_MemcpyDispatch(XZDma_Memcpy *MemcpyPtr);
+static void XZDma_MemcpyComplete(XZDma_MemcpyChannel *ChanPtr, s32 Status);
+static void XZDma_MemcpyDoneHandler(void *CallBackRef);
+static void XZDma_MemcpyErrorHandler(void *CallBackRef, u32 ErrorMask);
+
+/************************** Variable Definitions *****************************/
+
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+*
+* This function initializes a memory copy service instance without any
+* channels. Until channels are added all copies are done by the CPU.
+*
+* @param	MemcpyPtr is a pointer to the service instance.
+* @param	CpuThreshold is the size in bytes below which copies are done
+*		by the CPU.
+* @param	IsCoherent specifies whether the ZDMA channels access memory
+*		cache coherently.
+*		- TRUE - No cache maintenance is done around copies.
+*		- FALSE - Source and destination are flushed and invalidated
+*		  around copies.
+*
+* @return	XST_SUCCESS.
+*
+* @note		None.
+*
+******************************************************************************/
+s32 XZDma_MemcpyInitialize(XZDma_Memcpy *MemcpyPtr, u32 CpuThreshold,
+				u8 IsCoherent)
+{
+	/* Verify arguments */
+	Xil_AssertNonvoid(MemcpyPtr != NULL);
+	Xil_AssertNonvoid((IsCoherent == TRUE) || (IsCoherent == FALSE));
+
+	(void)memset(MemcpyPtr, 0, sizeof(XZDma_Memcpy));
+	MemcpyPtr->CpuThreshold = CpuThreshold;
+	MemcpyPtr->IsCoherent = IsCoherent;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function adds a ZDMA channel to a memory copy service. The channel is
+* put in scatter gather mode with a linear descriptor list in the memory
+* provided, and its done and error callbacks are taken over by the service.
+*
+* @param	MemcpyPtr is a pointer to the service instance.
+* @param	InstancePtr is a pointer to the XZDma instance of the channel,
+*		initialized with XZDma_CfgInitialize().
+* @param	DscrMemPtr is the memory for the descriptor list, aligned to
+*		64 bytes.
+* @param	DscrBytes is the size of the descriptor memory. Each request
+*		in a list takes 32 bytes, and at most XZDMA_MEMCPY_MAX_BATCH
+*		requests are started at once.
+*
+* @return
+*		- XST_SUCCESS if the channel was added.
+*		- XST_FAILURE if the service already has
+*		  XZDMA_MEMCPY_MAX_CHANNELS channels or the channel is busy.
+*		- XST_INVALID_PARAM if the descriptor memory cannot hold one
+*		  descriptor pair.
+*
+* @note		The interrupt of the channel has to be connected to
+*		XZDma_IntrHandler() by the application.
+*
+******************************************************************************/
+s32 XZDma_MemcpyAddChannel(XZDma_Memcpy *MemcpyPtr, XZDma *InstancePtr,
+				UINTPTR DscrMemPtr, u32 DscrBytes)
+{
+	XZDma_MemcpyChannel *ChanPtr;
+	u32 DscrCount;
+	u32 IrqWasEnabled;
+	s32 Status;
+
+	/* Verify arguments */
+	Xil_AssertNonvoid(MemcpyPtr != NULL);
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(InstancePtr->IsReady ==
+				(u32)(XIL_COMPONENT_IS_READY));
+	Xil_AssertNonvoid((DscrMemPtr & 0x3FU) == 0x00U);
+
+	if (MemcpyPtr->NumChannels >= XZDMA_MEMCPY_MAX_CHANNELS) {
+		return XST_FAILURE;
+	}
+
+	Status = XZDma_SetMode(InstancePtr, TRUE, XZDMA_NORMAL_MODE);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	DscrCount = XZDma_CreateBDList(InstancePtr, XZDMA_LINEAR, DscrMemPtr,
+					DscrBytes);
+	if (DscrCount == 0x00U) {
+		return XST_INVALID_PARAM;
+	}
+
+	ChanPtr = &MemcpyPtr->Channel[MemcpyPtr->NumChannels];
+	ChanPtr->InstancePtr = InstancePtr;
+	ChanPtr->MemcpyPtr = MemcpyPtr;
+	ChanPtr->ActiveCnt = 0U;
+	if (DscrCount > XZDMA_MEMCPY_MAX_BATCH) {
+		ChanPtr->MaxBatch = XZDMA_MEMCPY_MAX_BATCH;
+	}
+	else {
+		ChanPtr->MaxBatch = DscrCount;
+	}
+
+	(void)XZDma_SetCallBack(InstancePtr, XZDMA_HANDLER_DONE,
+			(void *)XZDma_MemcpyDoneHandler, ChanPtr);
+	(void)XZDma_SetCallBack(InstancePtr, XZDMA_HANDLER_ERROR,
+			(void *)XZDma_MemcpyErrorHandler, ChanPtr);
+	XZDma_EnableIntr(InstancePtr, XZDMA_MEMCPY_INTR_MASK);
+
+	/* Publish the channel only once it is fully set up */
+	IrqWasEnabled = XZDma_MemcpyLock();
+	MemcpyPtr->NumChannels++;
+	XZDma_MemcpyUnlock(IrqWasEnabled);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function starts an asynchronous copy of Size bytes from Src to Dst.
+* Copies below the CPU threshold, and all copies while the service has no
+* channels, are done by the CPU before this function returns. Other copies
+* are queued and started on the next idle ZDMA channel.
+*
+* @param	MemcpyPtr is a pointer to the service instance.
+* @param	ReqPtr is a pointer to the request, which must not be in use
+*		by an earlier copy that has not completed.
+* @param	Dst is the destination address.
+* @param	Src is the source address. The buffers must not overlap.
+* @param	Size is the number of bytes to copy, less than 1 GB.
+* @param	Handler is called when the copy has completed, NULL for none.
+*		It is called from the ZDMA interrupt handler for DMA copies
+*		and from this function for CPU copies.
+* @param	CallBackRef is passed to the handler.
+*
+* @return
+*		- XST_SUCCESS if the copy was done or queued.
+*		- XST_INVALID_PARAM if Size is too large for a descriptor.
+*
+* @note		This function may be called from a completion handler.
+*
+******************************************************************************/
+s32 XZDma_MemcpyAsync(XZDma_Memcpy *MemcpyPtr, XZDma_MemcpyReq *ReqPtr,
+		void *Dst, const void *Src, u32 Size,
+		XZDma_MemcpyHandler Handler, void *CallBackRef)
+{
+	u32 IrqWasEnabled;
+
+	/* Verify arguments */
+	Xil_AssertNonvoid(MemcpyPtr != NULL);
+	Xil_AssertNonvoid(ReqPtr != NULL);
+	Xil_AssertNonvoid((Dst != NULL) && (Src != NULL));
+
+	if (Size > XZDMA_WORD2_SIZE_MASK) {
+		return XST_INVALID_PARAM;
+	}
+
+	ReqPtr->DstAddr = (UINTPTR)Dst;
+	ReqPtr->SrcAddr = (UINTPTR)Src;
+	ReqPtr->Size = Size;
+	ReqPtr->Handler = Handler;
+	ReqPtr->CallBackRef = CallBackRef;
+	ReqPtr->NextPtr = NULL;
+
+	if ((Size < MemcpyPtr->CpuThreshold) || (Size == 0x00U) ||
+			(MemcpyPtr->NumChannels == 0x00U)) {
+		(void)memcpy(Dst, Src, Size);
+		ReqPtr->Status = XST_SUCCESS;
+		ReqPtr->State = XZDMA_MEMCPY_DONE;
+		if (Handler != NULL) {
+			Handler(CallBackRef, XST_SUCCESS);
+		}
+		return XST_SUCCESS;
+	}
+
+	if (MemcpyPtr->IsCoherent == FALSE) {
+		Xil_DCacheFlushRange((INTPTR)Src, Size);
+		Xil_DCacheFlushRange((INTPTR)Dst, Size);
+	}
+
+	ReqPtr->Status = XST_SUCCESS;
+	ReqPtr->State = XZDMA_MEMCPY_QUEUED;
+
+	/* The queue is shared with the completion handlers */
+	IrqWasEnabled = XZDma_MemcpyLock();
+
+	if (MemcpyPtr->PendTail == NULL) {
+		MemcpyPtr->PendHead = ReqPtr;
+	}
+	else {
+		MemcpyPtr->PendTail->NextPtr = ReqPtr;
+	}
+	MemcpyPtr->PendTail = ReqPtr;
+	MemcpyPtr->PendCnt++;
+
+	XZDma_MemcpyDispatch(MemcpyPtr);
+
+	XZDma_MemcpyUnlock(IrqWasEnabled);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function masks the IRQ exception and returns whether it was
+* enabled before. Sections protected this way nest: a completion handler,
+* called from an interrupt or from a dispatch inside XZDma_MemcpyAsync(), may
+* queue a new copy and leaves the exception masked for its caller.
+*
+* @return	TRUE if the IRQ exception was enabled, FALSE otherwise.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 XZDma_MemcpyLock(void)
+{
+	u32 IrqWasEnabled;
+
+	if ((mfcpsr() & XIL_EXCEPTION_IRQ) == 0x00U) {
+		IrqWasEnabled = TRUE;
+	}
+	else {
+		IrqWasEnabled = FALSE;
+	}
+	Xil_ExceptionDisable();
+
+	return IrqWasEnabled;
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function ends a section started with XZDma_MemcpyLock().
+*
+* @param	IrqWasEnabled is the value returned by XZDma_MemcpyLock().
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XZDma_MemcpyUnlock(u32 IrqWasEnabled)
+{
+	if (IrqWasEnabled == TRUE) {
+		Xil_ExceptionEnable();
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function starts queued requests on the idle channels. Each
+* idle channel takes its share of the queue as if it were spread over all
+* channels, at most one descriptor list, so that the first channel to
+* become idle does not take work that the others would finish sooner.
+*
+* @param	MemcpyPtr is a pointer to the service instance.
+*
+* @return	None.
+*
+* @note		Called with interrupts disabled.
+*
+******************************************************************************/
+static void XZDma_MemcpyDispatch(XZDma_Memcpy *MemcpyPtr)
+{
+	XZDma_MemcpyChannel *ChanPtr;
+	XZDma_MemcpyReq *ReqPtr;
+	u32 Share;
+	u32 Index;
+	u32 Count;
+	s32 Status;
+
+	for (Index = 0x00U; (Index < MemcpyPtr->NumChannels) &&
+			(MemcpyPtr->PendCnt != 0x00U); Index++) {
+		ChanPtr = &MemcpyPtr->Channel[Index];
+		if (ChanPtr->ActiveCnt != 0x00U) {
+			continue;
+		}
+
+		Share = (MemcpyPtr->PendCnt + MemcpyPtr->NumChannels - 1U) /
+					MemcpyPtr->NumChannels;
+		if (Share > ChanPtr->MaxBatch) {
+			Share = ChanPtr->MaxBatch;
+		}
+
+		for (Count = 0x00U; Count < Share; Count++) {
+			ReqPtr = MemcpyPtr->PendHead;
+			MemcpyPtr->PendHead = ReqPtr->NextPtr;
+
+			ReqPtr->State = XZDMA_MEMCPY_ACTIVE;
+			ChanPtr->Active[Count] = ReqPtr;
+			ChanPtr->Xfer[Count].SrcAddr = ReqPtr->SrcAddr;
+			ChanPtr->Xfer[Count].DstAddr = ReqPtr->DstAddr;
+			ChanPtr->Xfer[Count].Size = ReqPtr->Size;
+			ChanPtr->Xfer[Count].SrcCoherent = MemcpyPtr->IsCoherent;
+			ChanPtr->Xfer[Count].DstCoherent = MemcpyPtr->IsCoherent;
+			ChanPtr->Xfer[Count].Pause = FALSE;
+		}
+		if (MemcpyPtr->PendHead == NULL) {
+			MemcpyPtr->PendTail = NULL;
+		}
+		MemcpyPtr->PendCnt -= Share;
+		ChanPtr->ActiveCnt = Share;
+
+		Status = XZDma_Start(ChanPtr->InstancePtr, ChanPtr->Xfer,
+					Share);
+		if (Status != XST_SUCCESS) {
+			XZDma_MemcpyComplete(ChanPtr, Status);
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function completes the requests active on a channel and calls
+* their handlers.
+*
+* @param	ChanPtr is a pointer to the channel.
+* @param	Status is the result to report.
+*
+* @return	None.
+*
+* @note		The channel stays marked busy while the handlers run, so that
+*		a request queued by a handler is not started on it before the
+*		completed list has been walked.
+*
+******************************************************************************/
+static void XZDma_MemcpyComplete(XZDma_MemcpyChannel *ChanPtr, s32 Status)
+{
+	XZDma_MemcpyReq *ReqPtr;
+	XZDma_MemcpyHandler Handler;
+	u32 Index;
+
+	for (Index = 0x00U; Index < ChanPtr->ActiveCnt; Index++) {
+		ReqPtr = ChanPtr->Active[Index];
+		Handler = ReqPtr->Handler;
+
+		/* Drop lines speculatively loaded during the copy */
+		if (ChanPtr->MemcpyPtr->IsCoherent == FALSE) {
+			Xil_DCacheInvalidateRange((INTPTR)ReqPtr->DstAddr,
+						ReqPtr->Size);
+		}
+
+		ReqPtr->Status = Status;
+		ReqPtr->State = XZDMA_MEMCPY_DONE;
+		if (Handler != NULL) {
+			Handler(ReqPtr->CallBackRef, Status);
+		}
+	}
+
+	ChanPtr->ActiveCnt = 0x00U;
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function is the done callback of the channels of the service.
+* It completes the requests of the channel and starts the next batch.
+*
+* @param	CallBackRef is a pointer to the channel.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XZDma_MemcpyDoneHandler(void *CallBackRef)
+{
+	XZDma_MemcpyChannel *ChanPtr = (XZDma_MemcpyChannel *)CallBackRef;
+	XZDma_Memcpy *MemcpyPtr = ChanPtr->MemcpyPtr;
+
+	XZDma_MemcpyComplete(ChanPtr, XST_SUCCESS);
+	XZDma_MemcpyDispatch(MemcpyPtr);
+}
+
+/*****************************************************************************/
+/**
+*
+* This static function is the error callback of the channels of the service.
+* On an AXI error the channel has stopped; its requests are completed with
+* XST_FAILURE and the next batch is started.
+*
+* @param	CallBackRef is a pointer to the channel.
+* @param	ErrorMask is the error interrupt status.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void XZDma_MemcpyErrorHandler(void *CallBackRef, u32 ErrorMask)
+{
+	XZDma_MemcpyChannel *ChanPtr = (XZDma_MemcpyChannel *)CallBackRef;
+	XZDma_Memcpy *MemcpyPtr = ChanPtr->MemcpyPtr;
+
+	if (ChanPtr->InstancePtr->ChannelState != XZDMA_IDLE) {
+		return;
+	}
+
+	XZDma_MemcpyComplete(ChanPtr, XST_FAILURE);
+	XZDma_MemcpyDispatch(MemcpyPtr);
+}
+/** @} */
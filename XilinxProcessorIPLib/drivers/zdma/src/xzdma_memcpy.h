@@ -0,0 +1,218 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xzdma_memcpy.h
+* @addtogroup zdma_v1_0
+* @{
+* @details
+*
+* This file contains an asynchronous memory copy service built on the ZDMA
+* driver. It spreads copy requests over the GDMA/ADMA channels given to it,
+* so that it can be used in place of memcpy() for large buffers.
+*
+* Each channel is run in scatter gather mode with a linear descriptor list.
+* Requests are queued in software, and whenever a channel becomes idle up to
+* one descriptor list worth of queued requests is started on it with a single
+* XZDma_Start() call. A channel takes its share of the queue as if it were
+* spread over all channels, so that the work stays balanced between them.
+*
+* Copies smaller than a threshold are done by the CPU with memcpy() straight
+* away, since for these the set up and interrupt cost of the DMA is higher
+* than the copy itself.
+*
+* A request is described by an XZDma_MemcpyReq owned by the caller, which
+* also serves as the completion handle. It must stay valid until the request
+* has completed, which is signalled by XZDma_MemcpyIsDone() and, if one is
+* given, by a completion handler called from the ZDMA interrupt handler.
+*
+* Unless the service is told that the channels are cache coherent, the
+* source buffer is flushed and the destination buffer flushed and invalidated
+* around each DMA copy. The destination buffer should be cache line aligned
+* and a multiple of cache lines in size, otherwise data sharing a cache line
+* with it must not be written while the copy is in progress.
+*
+* The application initializes each ZDMA channel with XZDma_CfgInitialize()
+* and connects XZDma_IntrHandler() of each channel to the interrupt
+* controller, as for direct use of the driver. The service installs its own
+* done and error callbacks.
+*
+* Typical use:
+* <pre>
+*	XZDma_MemcpyInitialize(&Memcpy, 4096, FALSE);
+*	for (Index = 0; Index < NUM_CHANNELS; Index++) {
+*		XZDma_MemcpyAddChannel(&Memcpy, &ZDma[Index],
+*			(UINTPTR)DscrMem[Index], sizeof(DscrMem[Index]));
+*	}
+*
+*	XZDma_MemcpyAsync(&Memcpy, &Req, DstBuf, SrcBuf, Size, NULL, NULL);
+*	...
+*	while (!XZDma_MemcpyIsDone(&Req));
+* </pre>
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who     Date     Changes
+* ----- ------  -------- ------------------------------------------------------
+* 1.2           10/18/26 First release
+* </pre>
+*
+******************************************************************************/
+#ifndef XZDMA_MEMCPY_H_
+#define XZDMA_MEMCPY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+
+#include "xzdma.h"
+
+/************************** Constant Definitions *****************************/
+
+/** @name Memcpy service limits
+ * @{
+ */
+#define XZDMA_MEMCPY_MAX_CHANNELS	8U	/**< Channels per service,
+						  *  one GDMA or ADMA */
+#define XZDMA_MEMCPY_MAX_BATCH		32U	/**< Requests started on a
+						  *  channel at once */
+/*@}*/
+
+/** @name Memcpy request states
+ * @{
+ */
+#define XZDMA_MEMCPY_DONE		0U	/**< Completed */
+#define XZDMA_MEMCPY_QUEUED		1U	/**< Waiting for a channel */
+#define XZDMA_MEMCPY_ACTIVE		2U	/**< Being copied */
+/*@}*/
+
+/**************************** Type Definitions *******************************/
+
+/******************************************************************************/
+/**
+* Callback type for completion of a copy request.
+*
+* @param	CallBackRef is the reference passed to XZDma_MemcpyAsync().
+* @param	Status is XST_SUCCESS, or XST_FAILURE if the channel reported
+*		an AXI error.
+*******************************************************************************/
+typedef void (*XZDma_MemcpyHandler) (void *CallBackRef, s32 Status);
+
+/******************************************************************************/
+/**
+* This typedef contains a copy request. It is filled in by
+* XZDma_MemcpyAsync() and doubles as the completion handle.
+*/
+typedef struct XZDma_MemcpyReq {
+	UINTPTR DstAddr;		/**< Destination address */
+	UINTPTR SrcAddr;		/**< Source address */
+	u32 Size;			/**< Number of bytes to copy */
+	XZDma_MemcpyHandler Handler;	/**< Completion handler or NULL */
+	void *CallBackRef;		/**< Passed to the handler */
+	volatile u32 State;		/**< XZDMA_MEMCPY_* state */
+	volatile s32 Status;		/**< Result once done */
+	struct XZDma_MemcpyReq *NextPtr;/**< Next request in the queue */
+} XZDma_MemcpyReq;
+
+struct XZDma_Memcpy;
+
+/******************************************************************************/
+/**
+* This typedef contains the state of one ZDMA channel used by the service.
+*/
+typedef struct {
+	XZDma *InstancePtr;		/**< ZDMA channel */
+	struct XZDma_Memcpy *MemcpyPtr;	/**< Service the channel belongs to */
+	u32 MaxBatch;			/**< Requests per descriptor list */
+	u32 ActiveCnt;			/**< Requests being copied */
+	XZDma_MemcpyReq *Active[XZDMA_MEMCPY_MAX_BATCH];
+					/**< Requests being copied */
+	XZDma_Transfer Xfer[XZDMA_MEMCPY_MAX_BATCH];
+					/**< Transfers of the requests */
+} XZDma_MemcpyChannel;
+
+/******************************************************************************/
+/**
+* The memory copy service instance data structure.
+*/
+typedef struct XZDma_Memcpy {
+	XZDma_MemcpyChannel Channel[XZDMA_MEMCPY_MAX_CHANNELS];
+					/**< Channels of the service */
+	u32 NumChannels;		/**< Number of channels added */
+	XZDma_MemcpyReq *PendHead;	/**< Oldest queued request */
+	XZDma_MemcpyReq *PendTail;	/**< Newest queued request */
+	u32 PendCnt;			/**< Number of queued requests */
+	u32 CpuThreshold;		/**< Copies below this size are done
+					  *  by the CPU */
+	u8 IsCoherent;			/**< Channels are cache coherent */
+} XZDma_Memcpy;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/*****************************************************************************/
+/**
+*
+* This macro tells whether a copy request has completed.
+*
+* @param	ReqPtr is a pointer to the request.
+*
+* @return	TRUE if the request has completed, FALSE otherwise. The result
+*		is then in ReqPtr->Status.
+*
+* @note		C-style signature:
+*		u32 XZDma_MemcpyIsDone(XZDma_MemcpyReq *ReqPtr)
+*
+******************************************************************************/
+#define XZDma_MemcpyIsDone(ReqPtr) \
+	(((ReqPtr)->State == XZDMA_MEMCPY_DONE) ? TRUE : FALSE)
+
+/************************ Prototypes of functions **************************/
+
+s32 XZDma_MemcpyInitialize(XZDma_Memcpy *MemcpyPtr, u32 CpuThreshold,
+				u8 IsCoherent);
+s32 XZDma_MemcpyAddChannel(XZDma_Memcpy *MemcpyPtr, XZDma *InstancePtr,
+				UINTPTR DscrMemPtr, u32 DscrBytes);
+s32 XZDma_MemcpyAsync(XZDma_Memcpy *MemcpyPtr, XZDma_MemcpyReq *ReqPtr,
+		void *Dst, const void *Src, u32 Size,
+		XZDma_MemcpyHandler Handler, void *CallBackRef);
+
+#ifdef __cplusplus
+}
+
+#endif
+
+#endif /* XZDMA_MEMCPY_H_ */
+/** @} */
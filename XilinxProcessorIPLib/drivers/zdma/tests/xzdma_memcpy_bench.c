@@ -0,0 +1,526 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xzdma_memcpy_bench.c
+*
+* Host test and benchmark of the ZDMA memory copy service.
+*
+* The ZDMA driver and the memcpy service are run against a model of up to
+* eight GDMA channels. The model keeps the interrupt status (write one to
+* clear), mask, enable and disable registers of each channel. Enabling a
+* channel walks the linear descriptor list given by the SRC/DST_START
+* registers; once the modelled transfer time has passed the data is copied,
+* DONE is raised and, if it is unmasked and the simulated CPSR lets IRQs
+* through, XZDma_IntrHandler() is called with the IRQ masked, as on the
+* target. The modelled time of a list is a start latency, a fixed cost per
+* descriptor pair and the bytes at a per channel bandwidth. Bandwidth shared
+* between channels in the interconnect and DDR is not modelled, so results
+* for several channels are an upper bound.
+*
+* The first part checks that the service saves and restores the IRQ mask
+* rather than enabling it unconditionally: a request completed from inside
+* XZDma_MemcpyAsync() with an error, whose handler queues another request,
+* must leave the IRQ masked inside the handler and enabled afterwards, and a
+* call made with the IRQ masked, as from an interrupt handler, must leave it
+* masked.
+*
+* The second part copies batches of requests of sizes from 256 bytes to 4 MB
+* and prints, for each size, the host memcpy() throughput, the host CPU time
+* the service spends per request (submission and interrupt handling, without
+* the modelled copy) and the modelled throughput with 1, 2, 4 and 8 channels.
+* The CPU time is measured on the host and only indicates the relative cost
+* per request; the memcpy() throughput of the target has to be measured on
+* the target.
+*
+* Usage: xzdma_memcpy_bench [MB/s per channel] [ns per descriptor]
+*        [start ns]
+*
+* The defaults are 1500 MB/s, 300 ns and 1000 ns.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.2        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "xzdma_memcpy.h"
+#include "xil_exception.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_BASE		0xFD500000U	/* GDMA channel 0 */
+#define SIM_STRIDE		0x10000U
+#define SIM_CHANNELS		8U
+#define SIM_REGS		(0x210U / 4U)
+
+#define BENCH_TOTAL		(16U * 1024U * 1024U)
+#define BENCH_MAX_REQS		1024U
+#define BENCH_DSCR_BYTES	(2U * XZDMA_MEMCPY_MAX_BATCH * \
+					sizeof(XZDma_LiDscr))
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Reg[SIM_REGS];
+	u32 Busy;
+	double DoneAt;
+	XZDma_LiDscr *SrcDscr;
+	XZDma_LiDscr *DstDscr;
+} SimChannel;
+
+/************************** Variable Definitions *****************************/
+
+u32 SimCpsr;
+
+static SimChannel Sim[SIM_CHANNELS];
+static double SimNow;
+static double SimMBps = 1500.0;
+static double SimDscrNs = 300.0;
+static double SimStartNs = 1000.0;
+static double CpuNs;
+
+static XZDma ZDma[SIM_CHANNELS];
+static XZDma_Memcpy Memcpy;
+static XZDma_MemcpyReq Req[BENCH_MAX_REQS];
+static u8 DscrMem[SIM_CHANNELS][BENCH_DSCR_BYTES]
+				__attribute__ ((aligned(64)));
+static u32 DoneCount;
+static u32 FailCount;
+
+/************************** Function Definitions *****************************/
+
+static double NowNs(void)
+{
+	struct timespec Ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &Ts);
+	return (double)Ts.tv_sec * 1e9 + (double)Ts.tv_nsec;
+}
+
+static SimChannel *SimDecode(UINTPTR Addr, u32 *Offset)
+{
+	u32 Index = (u32)((Addr - SIM_BASE) / SIM_STRIDE);
+
+	if ((Addr < SIM_BASE) || (Index >= SIM_CHANNELS)) {
+		fprintf(stderr, "access outside the model: 0x%lx\n",
+				(unsigned long)Addr);
+		exit(1);
+	}
+	*Offset = (u32)((Addr - SIM_BASE) % SIM_STRIDE);
+	return &Sim[Index];
+}
+
+/*
+ * Walks the descriptor lists of a channel that has just been enabled and
+ * works out when the transfer completes.
+ */
+static void SimStart(SimChannel *Ch)
+{
+	XZDma_LiDscr *Src;
+	double Time = SimStartNs;
+	u32 Count = 0U;
+
+	Ch->SrcDscr = (XZDma_LiDscr *)(UINTPTR)
+		(((u64)Ch->Reg[XZDMA_CH_SRC_START_MSB_OFFSET / 4U] << 32) |
+		Ch->Reg[XZDMA_CH_SRC_START_LSB_OFFSET / 4U]);
+	Ch->DstDscr = (XZDma_LiDscr *)(UINTPTR)
+		(((u64)Ch->Reg[XZDMA_CH_DST_START_MSB_OFFSET / 4U] << 32) |
+		Ch->Reg[XZDMA_CH_DST_START_LSB_OFFSET / 4U]);
+
+	Src = Ch->SrcDscr;
+	do {
+		Time += SimDscrNs + (double)Src->Size * 1000.0 / SimMBps;
+		Count++;
+	} while (((Src++)->Cntl & XZDMA_WORD3_CMD_STOP_MASK) == 0U);
+
+	if (Ch->Busy != 0U) {
+		fprintf(stderr, "channel enabled while busy\n");
+		exit(1);
+	}
+	Ch->Busy = 1U;
+	Ch->DoneAt = SimNow + Time;
+}
+
+/* Does the copy of a completed list and raises DONE */
+static void SimFinish(SimChannel *Ch)
+{
+	XZDma_LiDscr *Src = Ch->SrcDscr;
+	XZDma_LiDscr *Dst = Ch->DstDscr;
+	u32 Stop;
+
+	do {
+		memcpy((void *)(UINTPTR)Dst->Address,
+			(void *)(UINTPTR)Src->Address, Src->Size);
+		Stop = Src->Cntl & XZDMA_WORD3_CMD_STOP_MASK;
+		Src++;
+		Dst++;
+	} while (Stop == 0U);
+
+	Ch->Busy = 0U;
+	Ch->Reg[XZDMA_CH_ISR_OFFSET / 4U] |= XZDMA_IXR_DMA_DONE_MASK;
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Offset;
+	SimChannel *Ch = SimDecode(Addr, &Offset);
+
+	/* The enable and disable registers are write only */
+	if ((Offset == XZDMA_CH_IEN_OFFSET) || (Offset == XZDMA_CH_IDS_OFFSET)) {
+		return 0U;
+	}
+	return Ch->Reg[Offset / 4U];
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Offset;
+	SimChannel *Ch = SimDecode(Addr, &Offset);
+
+	switch (Offset) {
+	case XZDMA_CH_ISR_OFFSET:
+		Ch->Reg[Offset / 4U] &= ~Value;
+		break;
+	case XZDMA_CH_IEN_OFFSET:
+		Ch->Reg[XZDMA_CH_IMR_OFFSET / 4U] &= ~Value;
+		break;
+	case XZDMA_CH_IDS_OFFSET:
+		Ch->Reg[XZDMA_CH_IMR_OFFSET / 4U] |=
+					Value & XZDMA_IXR_ALL_INTR_MASK;
+		break;
+	case XZDMA_CH_CTRL2_OFFSET:
+		Ch->Reg[Offset / 4U] = Value;
+		if ((Value & XZDMA_CH_CTRL2_EN_MASK) != 0U) {
+			SimStart(Ch);
+		}
+		break;
+	default:
+		Ch->Reg[Offset / 4U] = Value;
+		break;
+	}
+}
+
+/* Calls the handler of every channel with an unmasked pending interrupt */
+static void SimDeliver(void)
+{
+	u32 Index;
+	u32 Pending;
+	double Start;
+
+	for (Index = 0U; Index < SIM_CHANNELS; Index++) {
+		Pending = Sim[Index].Reg[XZDMA_CH_ISR_OFFSET / 4U] &
+			~Sim[Index].Reg[XZDMA_CH_IMR_OFFSET / 4U];
+		if ((Pending == 0U) ||
+				((SimCpsr & XIL_EXCEPTION_IRQ) != 0U)) {
+			continue;
+		}
+		SimCpsr |= XIL_EXCEPTION_IRQ;
+		Start = NowNs();
+		XZDma_IntrHandler(&ZDma[Index]);
+		CpuNs += NowNs() - Start;
+		SimCpsr &= ~XIL_EXCEPTION_IRQ;
+	}
+}
+
+/* Runs the model until all channels are idle */
+static void SimRun(void)
+{
+	SimChannel *Next;
+	u32 Index;
+
+	for (;;) {
+		Next = NULL;
+		for (Index = 0U; Index < SIM_CHANNELS; Index++) {
+			if ((Sim[Index].Busy != 0U) && ((Next == NULL) ||
+					(Sim[Index].DoneAt < Next->DoneAt))) {
+				Next = &Sim[Index];
+			}
+		}
+		if (Next == NULL) {
+			break;
+		}
+		SimNow = Next->DoneAt;
+		SimFinish(Next);
+		SimDeliver();
+	}
+}
+
+static void SimReset(u32 Channels)
+{
+	XZDma_Config Config;
+	u32 Index;
+
+	memset(Sim, 0, sizeof(Sim));
+	SimNow = 0.0;
+	SimCpsr = 0U;
+
+	XZDma_MemcpyInitialize(&Memcpy, 0U, FALSE);
+	for (Index = 0U; Index < Channels; Index++) {
+		Sim[Index].Reg[XZDMA_CH_IMR_OFFSET / 4U] =
+						XZDMA_IXR_ALL_INTR_MASK;
+		Config.DeviceId = (u16)Index;
+		Config.BaseAddress = SIM_BASE + (Index * SIM_STRIDE);
+		Config.DmaType = 0U;
+		XZDma_CfgInitialize(&ZDma[Index], &Config,
+					Config.BaseAddress);
+		if (XZDma_MemcpyAddChannel(&Memcpy, &ZDma[Index],
+				(UINTPTR)DscrMem[Index],
+				BENCH_DSCR_BYTES) != XST_SUCCESS) {
+			fprintf(stderr, "adding channel %u failed\n", Index);
+			exit(1);
+		}
+	}
+}
+
+static void CountDone(void *CallBackRef, s32 Status)
+{
+	(void)CallBackRef;
+
+	DoneCount++;
+	if (Status != XST_SUCCESS) {
+		FailCount++;
+	}
+}
+
+static u32 NestedIrqMasked;
+static XZDma_MemcpyReq NestedReq;
+static u8 NestedSrc[4096] __attribute__ ((aligned(64)));
+static u8 NestedDst[2][4096] __attribute__ ((aligned(64)));
+
+static void NestedHandler(void *CallBackRef, s32 Status)
+{
+	(void)CallBackRef;
+	(void)Status;
+
+	(void)XZDma_MemcpyAsync(&Memcpy, &NestedReq, NestedDst[1], NestedSrc,
+			sizeof(NestedSrc), NULL, NULL);
+	NestedIrqMasked = SimCpsr & XIL_EXCEPTION_IRQ;
+}
+
+/*
+ * Checks the IRQ save and restore of the service. A start failure, forced by
+ * marking the channel busy with a one entry descriptor list, completes the
+ * request from inside XZDma_MemcpyAsync() and its handler queues another.
+ */
+static u32 TestIrqNesting(void)
+{
+	XZDma_MemcpyReq ReqA;
+	XZDma_MemcpyReq ReqC;
+	u32 Failed = 0U;
+
+	SimReset(0U);
+	Sim[0].Reg[XZDMA_CH_IMR_OFFSET / 4U] = XZDMA_IXR_ALL_INTR_MASK;
+	{
+		XZDma_Config Config = { 0U, SIM_BASE, 0U };
+
+		XZDma_CfgInitialize(&ZDma[0], &Config, SIM_BASE);
+	}
+	XZDma_MemcpyAddChannel(&Memcpy, &ZDma[0], (UINTPTR)DscrMem[0],
+			2U * sizeof(XZDma_LiDscr));
+	ZDma[0].ChannelState = XZDMA_BUSY;
+
+	NestedIrqMasked = 0U;
+	(void)XZDma_MemcpyAsync(&Memcpy, &ReqA, NestedDst[0], NestedSrc,
+			sizeof(NestedSrc), NestedHandler, NULL);
+	if ((ReqA.State != XZDMA_MEMCPY_DONE) ||
+			(ReqA.Status != XST_FAILURE)) {
+		printf("FAIL: forced start failure was not reported\n");
+		Failed++;
+	}
+	if (NestedIrqMasked == 0U) {
+		printf("FAIL: nested request enabled the IRQ inside the "
+			"handler\n");
+		Failed++;
+	}
+	if ((SimCpsr & XIL_EXCEPTION_IRQ) != 0U) {
+		printf("FAIL: IRQ left masked after the request\n");
+		Failed++;
+	}
+
+	/* A call from interrupt context keeps the IRQ masked */
+	SimCpsr = XIL_EXCEPTION_IRQ;
+	(void)XZDma_MemcpyAsync(&Memcpy, &ReqC, NestedDst[0], NestedSrc,
+			sizeof(NestedSrc), NULL, NULL);
+	if ((SimCpsr & XIL_EXCEPTION_IRQ) == 0U) {
+		printf("FAIL: call with the IRQ masked enabled it\n");
+		Failed++;
+	}
+	SimCpsr = 0U;
+
+	printf("IRQ save/restore: %s\n", (Failed == 0U) ? "ok" : "FAILED");
+	return Failed;
+}
+
+/*
+ * Copies Count requests of Size bytes through the service with Channels
+ * channels. Returns the modelled throughput in MB/s and the host CPU time of
+ * the service per request.
+ */
+static u32 BenchDma(u8 *Dst, const u8 *Src, u32 Size, u32 Count,
+		u32 Channels, double *MBps, double *NsPerReq)
+{
+	double Start;
+	u32 Index;
+
+	SimReset(Channels);
+	memset(Dst, 0, (size_t)Size * Count);
+	DoneCount = 0U;
+	FailCount = 0U;
+	CpuNs = 0.0;
+
+	for (Index = 0U; Index < Count; Index++) {
+		Start = NowNs();
+		(void)XZDma_MemcpyAsync(&Memcpy, &Req[Index],
+			Dst + ((size_t)Index * Size),
+			Src + ((size_t)Index * Size), Size, CountDone, NULL);
+		CpuNs += NowNs() - Start;
+	}
+	SimRun();
+
+	if ((DoneCount != Count) || (FailCount != 0U) ||
+			(memcmp(Dst, Src, (size_t)Size * Count) != 0)) {
+		printf("FAIL: %u byte copies on %u channels: %u of %u done, "
+			"%u failed\n", Size, Channels, DoneCount, Count,
+			FailCount);
+		*MBps = 0.0;
+		*NsPerReq = 0.0;
+		return 1U;
+	}
+
+	*MBps = (double)Size * Count * 1000.0 / SimNow;
+	*NsPerReq = CpuNs / Count;
+	return 0U;
+}
+
+static double BenchMemcpy(u8 *Dst, const u8 *Src, u32 Size, u32 Count)
+{
+	double Best = 0.0;
+	double Start;
+	double Time;
+	u32 Rep;
+	u32 Index;
+
+	for (Rep = 0U; Rep < 5U; Rep++) {
+		Start = NowNs();
+		for (Index = 0U; Index < Count; Index++) {
+			memcpy(Dst + ((size_t)Index * Size),
+				Src + ((size_t)Index * Size), Size);
+		}
+		__asm__ volatile ("" : : "r" (Dst) : "memory");
+		Time = NowNs() - Start;
+		if ((Rep == 0U) || (Time < Best)) {
+			Best = Time;
+		}
+	}
+
+	return (double)Size * Count * 1000.0 / Best;
+}
+
+int main(int argc, char *argv[])
+{
+	static const u32 Channels[] = { 1U, 2U, 4U, 8U };
+	u8 *Src;
+	u8 *Dst;
+	u32 Size;
+	u32 Count;
+	u32 Index;
+	u32 Failed;
+	double MBps = 0.0;
+	double NsPerReq = 0.0;
+	double Cost;
+
+	if (argc > 1) {
+		SimMBps = atof(argv[1]);
+	}
+	if (argc > 2) {
+		SimDscrNs = atof(argv[2]);
+	}
+	if (argc > 3) {
+		SimStartNs = atof(argv[3]);
+	}
+
+	Failed = TestIrqNesting();
+
+	Src = aligned_alloc(64, BENCH_TOTAL);
+	Dst = aligned_alloc(64, BENCH_TOTAL);
+	if ((Src == NULL) || (Dst == NULL)) {
+		return 1;
+	}
+	for (Index = 0U; Index < BENCH_TOTAL; Index++) {
+		Src[Index] = (u8)(Index * 131U + (Index >> 11));
+	}
+
+	printf("\nmodel: %.0f MB/s per channel, %.0f ns per descriptor, "
+		"%.0f ns start\n\n", SimMBps, SimDscrNs, SimStartNs);
+	printf("%8s %5s %12s %12s %10s %10s %10s %10s\n", "size", "reqs",
+		"memcpy MB/s", "svc ns/req", "1 ch MB/s", "2 ch", "4 ch",
+		"8 ch");
+
+	for (Size = 256U; Size <= 4U * 1024U * 1024U; Size <<= 2) {
+		Count = BENCH_TOTAL / Size;
+		if (Count > BENCH_MAX_REQS) {
+			Count = BENCH_MAX_REQS;
+		}
+		printf("%8u %5u %12.0f", Size, Count,
+			BenchMemcpy(Dst, Src, Size, Count));
+
+		Cost = 0.0;
+		for (Index = 0U; Index < 4U; Index++) {
+			Failed += BenchDma(Dst, Src, Size, Count,
+					Channels[Index], &MBps, &NsPerReq);
+			if (Index == 0U) {
+				Cost = NsPerReq;
+				printf(" %12.0f", Cost);
+			}
+			printf(" %10.0f", MBps);
+		}
+		printf("\n");
+	}
+
+	free(Src);
+	free(Dst);
+
+	return (Failed == 0U) ? 0 : 1;
+}
@@ -43,6 +43,11 @@
 int main_thread();
 void print_echo_app_header();
 void echo_application_thread(void *);
+#ifdef ECHO_PERF_SERVERS
+void print_perf_app_header();
+void perf_rx_application_thread(void *);
+void perf_tx_application_thread(void *);
+#endif
 
 void lwip_init();
 
@@ -148,10 +153,21 @@ void network_thread(void *p)
     xil_printf("%20s %6s %s\r\n", "--------------------", "------", "--------------------");
 
     print_echo_app_header();
+#ifdef ECHO_PERF_SERVERS
+    print_perf_app_header();
+#endif
     xil_printf("\r\n");
     sys_thread_new("echod", echo_application_thread, 0,
 		THREAD_STACKSIZE,
 		DEFAULT_THREAD_PRIO);
+#ifdef ECHO_PERF_SERVERS
+    sys_thread_new("rxperfd", perf_rx_application_thread, 0,
+		THREAD_STACKSIZE,
+		DEFAULT_THREAD_PRIO);
+    sys_thread_new("txperfd", perf_tx_application_thread, 0,
+		THREAD_STACKSIZE,
+		DEFAULT_THREAD_PRIO);
+#endif
     vTaskDelete(NULL);
 #endif
     return;
@@ -177,10 +193,21 @@ int main_thread()
 			xil_printf("DHCP request success\r\n");
 			print_ip_settings(&(server_netif.ip_addr), &(server_netif.netmask), &(server_netif.gw));
 			print_echo_app_header();
+#ifdef ECHO_PERF_SERVERS
+			print_perf_app_header();
+#endif
 			xil_printf("\r\n");
 			sys_thread_new("echod", echo_application_thread, 0,
 					THREAD_STACKSIZE,
 					DEFAULT_THREAD_PRIO);
+#ifdef ECHO_PERF_SERVERS
+			sys_thread_new("rxperfd", perf_rx_application_thread, 0,
+					THREAD_STACKSIZE,
+					DEFAULT_THREAD_PRIO);
+			sys_thread_new("txperfd", perf_tx_application_thread, 0,
+					THREAD_STACKSIZE,
+					DEFAULT_THREAD_PRIO);
+#endif
 			break;
 		}
 		mscnt += DHCP_FINE_TIMER_MSECS;
@@ -197,10 +224,21 @@ int main_thread()
 			xil_printf("%20s %6s %s\r\n", "--------------------", "------", "--------------------");
 
 			print_echo_app_header();
+#ifdef ECHO_PERF_SERVERS
+			print_perf_app_header();
+#endif
 			xil_printf("\r\n");
 			sys_thread_new("echod", echo_application_thread, 0,
 					THREAD_STACKSIZE,
 					DEFAULT_THREAD_PRIO);
+#ifdef ECHO_PERF_SERVERS
+			sys_thread_new("rxperfd", perf_rx_application_thread, 0,
+					THREAD_STACKSIZE,
+					DEFAULT_THREAD_PRIO);
+			sys_thread_new("txperfd", perf_tx_application_thread, 0,
+					THREAD_STACKSIZE,
+					DEFAULT_THREAD_PRIO);
+#endif
 			break;
 		}
 	}
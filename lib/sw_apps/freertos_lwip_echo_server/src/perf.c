@@ -0,0 +1,253 @@
+/******************************************************************************
+*
+* Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in
+* all copies or substantial portions of the Software.
+*
+* Use of the Software is limited solely to applications:
+* (a) running on a Xilinx device, or
+* (b) that interact with a Xilinx device through a bus or interconnect.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+* XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+* WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+* OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*
+* Except as contained in this notice, the name of the Xilinx shall not be used
+* in advertising or otherwise to promote the sale, use or other dealings in
+* this Software without prior written authorization from Xilinx.
+*
+******************************************************************************/
+
+/*
+ * Bulk TCP throughput servers used to measure the socket mode data path.
+ *
+ * Port 5001 (RX): discards everything the client sends, e.g.
+ *	$ iperf -c <board_ip> -p 5001 -t 30
+ * Port 5002 (TX): streams data to the client until it disconnects, e.g.
+ *	$ nc <board_ip> 5002 > /dev/null
+ *
+ * When lwIP is built with LWIP_NETCONN_ZEROCOPY (socket_zero_copy_api),
+ * received pbufs are consumed in place with lwip_recv_pbuf() and transmit
+ * segments reference perf_tx_buf through lwip_send_ref(); otherwise the
+ * copying lwip_recv()/lwip_send() calls are used, so both builds can be
+ * compared with the same host command.
+ *
+ * The servers are only built when ECHO_PERF_SERVERS is defined in the
+ * application's compiler flags, so the echo server keeps its footprint.
+ */
+
+#ifdef ECHO_PERF_SERVERS
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lwip/sockets.h"
+#include "netif/xadapter.h"
+#include "lwipopts.h"
+#include "xil_printf.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define PERF_RX_PORT		5001
+#define PERF_TX_PORT		5002
+#define PERF_BUF_SIZE		(TCP_SND_BUF / 2)
+#define PERF_REPORT_MSECS	5000
+
+static u8_t perf_tx_buf[PERF_BUF_SIZE];
+#if !LWIP_NETCONN_ZEROCOPY
+static u8_t perf_rx_buf[PERF_BUF_SIZE];
+#endif
+
+struct perf_stats {
+	u32_t start_tick;
+	u32_t last_tick;
+	u64_t total_bytes;
+	u64_t last_bytes;
+};
+
+static void perf_stats_start(struct perf_stats *stats)
+{
+	stats->start_tick = xTaskGetTickCount();
+	stats->last_tick = stats->start_tick;
+	stats->total_bytes = 0;
+	stats->last_bytes = 0;
+}
+
+static void perf_stats_print(const char *name, u64_t bytes, u32_t ticks)
+{
+	u32_t msecs = ticks * portTICK_RATE_MS;
+	u32_t kbps;
+
+	if (msecs == 0)
+		return;
+
+	kbps = (u32_t)((bytes * 8) / msecs);
+	xil_printf("%s: %d KBytes in %d ms, %d.%03d Mbits/sec\r\n", name,
+			(u32_t)(bytes >> 10), msecs, kbps / 1000, kbps % 1000);
+}
+
+static void perf_stats_update(const char *name, struct perf_stats *stats,
+		u32_t bytes)
+{
+	u32_t now = xTaskGetTickCount();
+
+	stats->total_bytes += bytes;
+	if ((now - stats->last_tick) * portTICK_RATE_MS >= PERF_REPORT_MSECS) {
+		perf_stats_print(name, stats->total_bytes - stats->last_bytes,
+				now - stats->last_tick);
+		stats->last_tick = now;
+		stats->last_bytes = stats->total_bytes;
+	}
+}
+
+static void perf_stats_end(const char *name, struct perf_stats *stats)
+{
+	xil_printf("%s total: ", name);
+	perf_stats_print(name, stats->total_bytes,
+			xTaskGetTickCount() - stats->start_tick);
+}
+
+/* thread spawned for each RX connection */
+static void perf_rx_thread(void *p)
+{
+	int sd = (int)p;
+	struct perf_stats stats;
+	int n;
+#if LWIP_NETCONN_ZEROCOPY
+	struct pbuf *pb;
+#endif
+
+	perf_stats_start(&stats);
+	while (1) {
+#if LWIP_NETCONN_ZEROCOPY
+		n = lwip_recv_pbuf(sd, &pb, 0);
+		if (n > 0)
+			pbuf_free(pb);
+#else
+		n = lwip_recv(sd, perf_rx_buf, PERF_BUF_SIZE, 0);
+#endif
+		if (n <= 0)
+			break;
+		perf_stats_update("rxperf", &stats, n);
+	}
+	perf_stats_end("rxperf", &stats);
+
+	lwip_close(sd);
+	vTaskDelete(NULL);
+}
+
+#if LWIP_NETCONN_ZEROCOPY
+/*
+ * perf_tx_buf is never modified, so a released buffer needs no recycling;
+ * the callback only reports connection errors.
+ */
+static void perf_tx_release(struct netconn *conn, void *arg,
+		const void *dataptr, size_t len, err_t err)
+{
+	(void)conn;
+	(void)arg;
+	(void)dataptr;
+	(void)len;
+
+	if (err != ERR_OK)
+		xil_printf("txperf: buffer released on error %d\r\n", err);
+}
+#endif
+
+/* thread spawned for each TX connection */
+static void perf_tx_thread(void *p)
+{
+	int sd = (int)p;
+	struct perf_stats stats;
+	int n;
+
+	perf_stats_start(&stats);
+	while (1) {
+#if LWIP_NETCONN_ZEROCOPY
+		n = lwip_send_ref(sd, perf_tx_buf, PERF_BUF_SIZE, 0,
+				perf_tx_release, NULL);
+#else
+		n = lwip_send(sd, perf_tx_buf, PERF_BUF_SIZE, 0);
+#endif
+		if (n <= 0)
+			break;
+		perf_stats_update("txperf", &stats, n);
+	}
+	perf_stats_end("txperf", &stats);
+
+	lwip_close(sd);
+	vTaskDelete(NULL);
+}
+
+static void perf_server(u16_t port, void (*handler)(void *), const char *name)
+{
+	int sock, new_sd;
+	struct sockaddr_in address, remote;
+	int size;
+
+	if ((sock = lwip_socket(AF_INET, SOCK_STREAM, 0)) < 0)
+		return;
+
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = INADDR_ANY;
+
+	if (lwip_bind(sock, (struct sockaddr *)&address, sizeof (address)) < 0)
+		return;
+
+	lwip_listen(sock, 0);
+
+	size = sizeof(remote);
+
+	while (1) {
+		if ((new_sd = lwip_accept(sock, (struct sockaddr *)&remote, (socklen_t *)&size)) > 0) {
+			sys_thread_new(name, handler,
+				(void*)new_sd,
+				4096,
+				DEFAULT_THREAD_PRIO);
+		}
+	}
+}
+
+void print_perf_app_header()
+{
+	xil_printf("%20s %6d %s\r\n", "rxperf server",
+			PERF_RX_PORT,
+			"$ iperf -c <board_ip> -p 5001");
+	xil_printf("%20s %6d %s\r\n", "txperf server",
+			PERF_TX_PORT,
+			"$ nc <board_ip> 5002 > /dev/null");
+}
+
+void perf_rx_application_thread(void *p)
+{
+	(void)p;
+	perf_server(PERF_RX_PORT, perf_rx_thread, "rxperf");
+	vTaskDelete(NULL);
+}
+
+void perf_tx_application_thread(void *p)
+{
+	u32_t i;
+
+	(void)p;
+	for (i = 0; i < PERF_BUF_SIZE; i++)
+		perf_tx_buf[i] = (u8_t)i;
+
+	perf_server(PERF_TX_PORT, perf_tx_thread, "txperf");
+	vTaskDelete(NULL);
+}
+
+#endif /* ECHO_PERF_SERVERS */
@@ -111,6 +111,14 @@ extern "C" {
 /* Size of OCM buffer to store data chunks in case of DDR less system */
 #define READ_BUFFER_SIZE			(4*1024U)
 
+/*
+ * Set to 1 to use a second OCM buffer of READ_BUFFER_SIZE to read the next
+ * chunk of an encrypted bitstream from flash while the current one is
+ * decrypted, in case of DDR less system. Off by default to keep the OCM
+ * footprint of FSBL unchanged.
+ */
+#define FSBL_AES_DOUBLE_BUFFER_VAL		(0U)
+
 /**
  * @name FSBL code include options
  *
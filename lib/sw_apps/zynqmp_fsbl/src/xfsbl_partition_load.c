@@ -103,6 +103,11 @@ static XSecure_Aes SecureAes;
 #ifndef XFSBL_PS_DDR
 extern u8 ReadBuffer[READ_BUFFER_SIZE];
 #endif
+
+#if defined(XFSBL_AES) && !defined(XFSBL_PS_DDR) && FSBL_AES_DOUBLE_BUFFER_VAL
+/* Second OCM buffer for double buffered decryption of bitstream chunks */
+static u8 ReadBuffer2[READ_BUFFER_SIZE];
+#endif
 /*****************************************************************************/
 /**
  * This function loads the partition
@@ -1323,6 +1328,10 @@ static u32 XFsbl_PartitionValidation(XFsblPs * FsblInstancePtr,
 			XSecure_AesSetChunkConfig(&SecureAes, ReadBuffer,
 					READ_BUFFER_SIZE,
 					FsblInstancePtr->DeviceOps.DeviceCopy);
+#if FSBL_AES_DOUBLE_BUFFER_VAL
+			/* Read the next chunk while the current one decrypts */
+			XSecure_AesSetChunkBuffer2(&SecureAes, ReadBuffer2);
+#endif
 
 			/**
 			 * In case of DDR less system, pass the partition source
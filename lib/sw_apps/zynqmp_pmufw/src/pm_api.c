@@ -45,88 +45,116 @@ typedef struct {
 	const u8 argTypes[PAYLOAD_API_ARGS_CNT];
 } PmApiEntry;
 
-static const PmApiEntry pmApiTable[] = {
-	{
+/*
+ * Indexed by API id. Entries of unused ids are zero, so their apiId does not
+ * match and the id is treated as unsupported.
+ */
+static const PmApiEntry pmApiTable[PM_API_MAX + 1U] = {
+	[PM_SELF_SUSPEND] = {
 		.apiId = PM_SELF_SUSPEND,
 		.argTypes = { ARG_NODE, ARG_LATENCY, ARG_STATE, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_REQUEST_SUSPEND] = {
 		.apiId = PM_REQUEST_SUSPEND,
 		.argTypes = { ARG_NODE, ARG_ACK, ARG_LATENCY, ARG_STATE,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_FORCE_POWERDOWN] = {
 		.apiId = PM_FORCE_POWERDOWN,
 		.argTypes = { ARG_NODE, ARG_ACK, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_ABORT_SUSPEND] = {
 		.apiId = PM_ABORT_SUSPEND,
 		.argTypes = { ARG_ABORT_REASON, ARG_NODE, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_REQUEST_WAKEUP] = {
 		.apiId = PM_REQUEST_WAKEUP,
 		.argTypes = { ARG_NODE, ARG_UINT32, ARG_UINT32, ARG_ACK,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_SET_WAKEUP_SOURCE] = {
 		.apiId = PM_SET_WAKEUP_SOURCE,
 		.argTypes = { ARG_NODE, ARG_NODE, ARG_ENABLE, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_SYSTEM_SHUTDOWN] = {
 		.apiId = PM_SYSTEM_SHUTDOWN,
 		.argTypes = { ARG_RESTART, ARG_UNDEF, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_REQUEST_NODE] = {
 		.apiId = PM_REQUEST_NODE,
 		.argTypes = { ARG_NODE, ARG_CAPABILITIES, ARG_QOS, ARG_ACK,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_RELEASE_NODE] = {
 		.apiId = PM_RELEASE_NODE,
 		.argTypes = { ARG_NODE, ARG_UNDEF, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_SET_REQUIREMENT] = {
 		.apiId = PM_SET_REQUIREMENT,
 		.argTypes = {ARG_NODE, ARG_CAPABILITIES, ARG_QOS, ARG_ACK,
 			     ARG_UNDEF }
-	}, {
+	},
+	[PM_SET_MAX_LATENCY] = {
 		.apiId = PM_SET_MAX_LATENCY,
 		.argTypes = {ARG_NODE, ARG_LATENCY, ARG_UNDEF, ARG_UNDEF,
 			     ARG_UNDEF }
-	}, {
+	},
+	[PM_GET_API_VERSION] = {
 		.apiId = PM_GET_API_VERSION,
 		.argTypes = { ARG_UNDEF, ARG_UNDEF, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_SET_CONFIGURATION] = {
 		.apiId = PM_SET_CONFIGURATION,
 		.argTypes = { ARG_UINT32, ARG_UNDEF, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_GET_NODE_STATUS] = {
 		.apiId = PM_GET_NODE_STATUS,
 		.argTypes = { ARG_NODE, ARG_UNDEF, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_GET_OP_CHARACTERISTIC] = {
 		.apiId = PM_GET_OP_CHARACTERISTIC,
 		.argTypes = { ARG_NODE, ARG_OP_CH_TYPE, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_REGISTER_NOTIFIER] = {
 		.apiId = PM_REGISTER_NOTIFIER,
 		.argTypes = { ARG_NODE, ARG_EVENT_ID, ARG_WAKE, ARG_ENABLE,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_RESET_ASSERT] = {
 		.apiId = PM_RESET_ASSERT,
 		.argTypes = { ARG_UINT32, ARG_UINT32, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_RESET_GET_STATUS] = {
 		.apiId = PM_RESET_GET_STATUS,
 		.argTypes = { ARG_UINT32, ARG_UNDEF, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_MMIO_WRITE] = {
 		.apiId = PM_MMIO_WRITE,
 		.argTypes = { ARG_UINT32, ARG_UINT32, ARG_UINT32, ARG_UNDEF,
 			      ARG_UNDEF }
-	}, {
+	},
+	[PM_MMIO_READ] = {
 		.apiId = PM_MMIO_READ,
 		.argTypes = { ARG_UINT32, ARG_UNDEF, ARG_UNDEF, ARG_UNDEF,
 			      ARG_UNDEF }
 	},
+	[PM_BATCH] = {
+		.apiId = PM_BATCH,
+		.argTypes = { ARG_UINT32, ARG_UINT32, ARG_UINT32, ARG_UNDEF,
+			      ARG_UNDEF }
+	},
 };
 
 /**
@@ -140,6 +168,23 @@ bool PmIsApiIdValid(const u32 api)
 	return (api >= PM_API_MIN) && (api <= PM_API_MAX);
 }
 
+/**
+ * PmGetApiEntry() - Get the table entry of a PM API call
+ * @api     PM API call id
+ *
+ * @return  Pointer to the entry, or NULL if the api id is not supported
+ */
+static const PmApiEntry* PmGetApiEntry(const u32 api)
+{
+	const PmApiEntry* entry = NULL;
+
+	if ((true == PmIsApiIdValid(api)) && (api == pmApiTable[api].apiId)) {
+		entry = &pmApiTable[api];
+	}
+
+	return entry;
+}
+
 /**
  * PmCheckArgument() - API argument checking
  * @argType     Argument type
@@ -247,22 +292,8 @@ done:
  */
 PmPayloadStatus PmCheckPayload(const u32 args[PAYLOAD_ELEM_CNT])
 {
-	u32 i;
 	PmPayloadStatus ret;
-	const PmApiEntry* entry = NULL;
-	bool status = PmIsApiIdValid(args[0]);
-
-	if (false == status) {
-		ret = PM_PAYLOAD_ERR_API_ID;
-		goto done;
-	}
-
-	for (i = 0U; i < ARRAY_SIZE(pmApiTable); i++) {
-		if (args[0] == pmApiTable[i].apiId) {
-			entry = &pmApiTable[i];
-			break;
-		}
-	}
+	const PmApiEntry* entry = PmGetApiEntry(args[0]);
 
 	if (NULL == entry) {
 		ret = PM_PAYLOAD_ERR_API_ID;
@@ -287,14 +318,7 @@ u32 PmRequestAcknowledge(const u32 *args)
 {
 	u32 i;
 	u32 ack = REQUEST_ACK_NO;
-	const PmApiEntry* entry = NULL;
-
-	for (i = 0U; i < ARRAY_SIZE(pmApiTable); i++) {
-		if (args[0] == pmApiTable[i].apiId) {
-			entry = &pmApiTable[i];
-			break;
-		}
-	}
+	const PmApiEntry* entry = PmGetApiEntry(args[0]);
 
 	if (NULL == entry) {
 		goto done;
@@ -42,6 +42,7 @@
 #include "pm_notifier.h"
 #include "ipi_buffer.h"
 #include "pm_power.h"
+#include "pm_profile.h"
 
 /*
  * Macro for all wake events in GPI1 that PM handles.
@@ -88,6 +89,9 @@ void XPfw_PmInit(void)
 	PmSetupInitialMasterRequirements();
 	/* Enable all IPI interrupts so masters' requests can be received */
 	PmEnableAllMasterIpis();
+#ifdef ENABLE_PM_PROFILE
+	PmProfileInit();
+#endif
 }
 
 /**
@@ -127,6 +131,9 @@ int XPfw_PmIpiHandler(const u32 isrMask, const u32 apiId, u32* const isrClr)
 	u32 bufferBase;
 	u32 offset = 0U;
 	const PmMaster* master = PmGetMasterByIpiMask(isrMask);
+#ifdef ENABLE_PM_PROFILE
+	u32 start;
+#endif
 
 	if ((NULL == isrClr) || (NULL == master)) {
 		/* Never happens if IPI irq handler is implemented correctly */
@@ -143,7 +150,13 @@ int XPfw_PmIpiHandler(const u32 isrMask, const u32 apiId, u32* const isrClr)
 		payload[i] = XPfw_Read32(bufferBase + offset);
 	}
 
+#ifdef ENABLE_PM_PROFILE
+	start = PmProfileStart();
+#endif
 	PmProcessRequest(master, payload);
+#ifdef ENABLE_PM_PROFILE
+	PmProfileEnd(apiId, start);
+#endif
 
 	/*
 	 * Master's bitfield in isr register will be cleared based on isrClr
@@ -808,6 +808,148 @@ done:
 	IPI_RESPONSE1(master->buffer, status);
 }
 
+static void PmProcessApiCall(const PmMaster *const master, const u32 *pload);
+
+/**
+ * PmBatchAllowed() - Check whether a PM API call may be part of a batch
+ * @apiId   PM API id of the call
+ *
+ * @return  Return true unless the call suspends or shuts down the requesting
+ *          master, its subsystem or the system, or is a batch itself
+ *
+ * @note    Such calls do not complete within the batch: the calls after them
+ *          would run while the master is going down, and the batch response
+ *          could not be delivered.
+ */
+static bool PmBatchAllowed(const u32 apiId)
+{
+	bool allowed;
+
+	switch (apiId) {
+	case PM_BATCH:
+	case PM_SELF_SUSPEND:
+	case PM_REQUEST_SUSPEND:
+	case PM_SYSTEM_SHUTDOWN:
+		allowed = false;
+		break;
+	default:
+		allowed = true;
+		break;
+	}
+
+	return allowed;
+}
+
+/*
+ * Batch windows
+ *
+ * The call arrays of PM_BATCH live in OCM, in one window per master placed
+ * back to back from XPFW_CFG_PM_BATCH_WINDOW_BASE (xpfw_config.h, default
+ * 0xFFFE9000, the 4 kB below the ARM trusted firmware):
+ *
+ *   base + 0x000  PM_BATCH_WINDOW_APU    1280 bytes, APU only
+ *   base + 0x500  PM_BATCH_WINDOW_RPU_0  1280 bytes, RPU_0 only
+ *   base + 0xA00  PM_BATCH_WINDOW_RPU_1  1280 bytes, RPU_1 only
+ *   base + 0xF00  end
+ *
+ * A window holds PM_BATCH_MAX_CALLS entries of PM_BATCH_ENTRY_WORDS words:
+ *
+ *   word 0      PM API id
+ *   words 1-5   arguments
+ *   words 6-9   response, status first (PM_BATCH_RESP_WORD)
+ *
+ * The windows are made accessible to their master only by pmAccessTable
+ * (pm_mmio_access.c). The base must match the batch_window_base parameter
+ * of the xilpm library, and the linker scripts of the masters must leave
+ * the windows unused.
+ */
+
+/**
+ * PmBatch() - Process an array of PM API calls in one IPI request
+ * @master  Initiator of the request
+ * @address Address of the call array, must be in the master's batch window
+ * @count   Number of calls in the array
+ * @flags   PM_BATCH_STOP_ON_ERROR to skip the calls after a failed one
+ *
+ * @note    Each entry of the array holds the payload of one call followed by
+ *          room for its response (PM_BATCH_ENTRY_WORDS words). The calls are
+ *          checked and processed in order, and whatever a call
+ *          writes to the master's IPI response buffer is copied back to its
+ *          entry. Calls that do not return a status (no or non-blocking
+ *          acknowledge) report XST_SUCCESS. Calls rejected by PmBatchAllowed()
+ *          fail with XST_INVALID_PARAM.
+ *          The whole array must lie in a region of pmAccessTable the master
+ *          may access, normally its batch window in OCM (PM_BATCH_WINDOW_*).
+ *          This keeps a master from having the PMU write to memory it does
+ *          not own, and keeps the array reachable whatever the state of DDR.
+ *          The response of the batch itself is the status of the first call
+ *          that failed (or XST_SUCCESS) and the number of calls processed.
+ */
+static void PmBatch(const PmMaster *const master, const u32 address,
+		    const u32 count, const u32 flags)
+{
+	int status = XST_SUCCESS;
+	u32 pload[PAYLOAD_ELEM_CNT];
+	u32 resp[PM_BATCH_ENTRY_WORDS - PM_BATCH_RESP_WORD];
+	u32 entry;
+	u32 done = 0U;
+	u32 i;
+
+	PmDbg("(0x%lx, %lu, 0x%lx)\n", address, count, flags);
+
+	if ((0U == count) || (count > PM_BATCH_MAX_CALLS) ||
+	    (0U != (address & (PAYLOAD_ELEM_SIZE - 1U))) ||
+	    (false == PmGetMmioAccessRange(master, address, count *
+					   PM_BATCH_ENTRY_WORDS *
+					   PAYLOAD_ELEM_SIZE))) {
+		status = XST_INVALID_PARAM;
+		goto done;
+	}
+
+	for (entry = address; done < count;
+	     entry += PM_BATCH_ENTRY_WORDS * PAYLOAD_ELEM_SIZE) {
+		for (i = 0U; i < PAYLOAD_ELEM_CNT; i++) {
+			pload[i] = XPfw_Read32(entry + (i * PAYLOAD_ELEM_SIZE));
+		}
+
+		for (i = 0U; i < ARRAY_SIZE(resp); i++) {
+			resp[i] = 0U;
+		}
+
+		if ((false == PmBatchAllowed(pload[0])) ||
+		    (PM_PAYLOAD_OK != PmCheckPayload(pload))) {
+			resp[0] = XST_INVALID_PARAM;
+		} else {
+			/* Preset the response for calls that do not write one */
+			IPI_RESPONSE4(master->buffer, XST_SUCCESS, 0U, 0U, 0U);
+			PmProcessApiCall(master, pload);
+			for (i = 0U; i < ARRAY_SIZE(resp); i++) {
+				resp[i] = XPfw_Read32(master->buffer +
+						      IPI_BUFFER_RESP_OFFSET +
+						      (i * PAYLOAD_ELEM_SIZE));
+			}
+		}
+
+		for (i = 0U; i < ARRAY_SIZE(resp); i++) {
+			XPfw_Write32(entry + ((PM_BATCH_RESP_WORD + i) *
+					      PAYLOAD_ELEM_SIZE), resp[i]);
+		}
+		done++;
+
+		if (XST_SUCCESS != (int)resp[0]) {
+			if (XST_SUCCESS == status) {
+				status = (int)resp[0];
+			}
+			if (0U != (flags & PM_BATCH_STOP_ON_ERROR)) {
+				break;
+			}
+		}
+	}
+
+done:
+	IPI_RESPONSE2(master->buffer, status, done);
+}
+
 /**
  * PmProcessApiCall() - Called to process PM API call
  * @master  Pointer to a requesting master structure
@@ -889,6 +1031,9 @@ static void PmProcessApiCall(const PmMaster *const master, const u32 *pload)
 	case PM_MMIO_READ:
 		PmMmioRead(master, pload[1]);
 		break;
+	case PM_BATCH:
+		PmBatch(master, pload[1], pload[2], pload[3]);
+		break;
 	default:
 		PmDbg("ERROR unsupported PM API #%lu\n", pload[0]);
 		PmProcessAckRequest(PmRequestAcknowledge(pload), master,
@@ -93,8 +93,29 @@
 #define PM_MMIO_WRITE               19U
 #define PM_MMIO_READ                20U
 
+#define PM_BATCH                    21U
+
 #define PM_API_MIN	PM_GET_API_VERSION
-#define PM_API_MAX	PM_MMIO_READ
+#define PM_API_MAX	PM_BATCH
+
+/* Layout of the call array passed with PM_BATCH */
+#define PM_BATCH_MAX_CALLS	32U	/* Calls accepted in one batch */
+#define PM_BATCH_ENTRY_WORDS	10U	/* api id + 5 args, status + 3 values */
+#define PM_BATCH_RESP_WORD	6U	/* Word at which the response starts */
+
+/*
+ * OCM windows for the call arrays of PM_BATCH, one per master, starting at
+ * XPFW_CFG_PM_BATCH_WINDOW_BASE (xpfw_config.h), see PmBatch() for the
+ * layout. The PMU only accepts an array that lies within a window of the
+ * requesting master.
+ */
+#define PM_BATCH_WINDOW_SIZE	(PM_BATCH_MAX_CALLS * PM_BATCH_ENTRY_WORDS * 4U)
+#define PM_BATCH_WINDOW_APU	XPFW_CFG_PM_BATCH_WINDOW_BASE
+#define PM_BATCH_WINDOW_RPU_0	(PM_BATCH_WINDOW_APU + PM_BATCH_WINDOW_SIZE)
+#define PM_BATCH_WINDOW_RPU_1	(PM_BATCH_WINDOW_RPU_0 + PM_BATCH_WINDOW_SIZE)
+
+/* PM_BATCH flags */
+#define PM_BATCH_STOP_ON_ERROR	0x1U	/* Skip the calls after a failed one */
 
 /* PM API callback ids */
 #define PM_INIT_SUSPEND_CB      30U
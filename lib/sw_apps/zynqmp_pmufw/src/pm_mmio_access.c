@@ -30,6 +30,7 @@
 
 #include "pm_master.h"
 #include "pm_mmio_access.h"
+#include "pm_defs.h"
 #include "crl_apb.h"
 #include "crf_apb.h"
 #include "pmu_iomodule.h"
@@ -47,6 +48,10 @@ typedef struct PmAccessRegion {
 	const u32 access;
 } PmAccessRegion;
 
+/*
+ * Regions must be sorted by start address and must not overlap, since
+ * PmGetMmioAccess() looks them up with a binary search.
+ */
 static const PmAccessRegion pmAccessTable[] = {
 	/* Module clock controller full power domain (CRF_APB) */
 	{
@@ -88,8 +93,55 @@ static const PmAccessRegion pmAccessTable[] = {
 			  IPI_PMU_0_IER_RPU_0_MASK |
 			  IPI_PMU_0_IER_RPU_1_MASK,
 	},
+
+	/* Batch windows in OCM, holding the call arrays of PM_BATCH */
+	{
+		.startAddr = PM_BATCH_WINDOW_APU,
+		.endAddr = PM_BATCH_WINDOW_APU + PM_BATCH_WINDOW_SIZE - 1U,
+		.access = IPI_PMU_0_IER_APU_MASK,
+	},
+	{
+		.startAddr = PM_BATCH_WINDOW_RPU_0,
+		.endAddr = PM_BATCH_WINDOW_RPU_0 + PM_BATCH_WINDOW_SIZE - 1U,
+		.access = IPI_PMU_0_IER_RPU_0_MASK,
+	},
+	{
+		.startAddr = PM_BATCH_WINDOW_RPU_1,
+		.endAddr = PM_BATCH_WINDOW_RPU_1 + PM_BATCH_WINDOW_SIZE - 1U,
+		.access = IPI_PMU_0_IER_RPU_1_MASK,
+	},
 };
 
+/**
+ * PmFindAccessRegion() - Find the access region containing an address
+ * @address    Address to look up
+ *
+ * @return     Pointer to the region, or NULL if no region contains the address
+ */
+static const PmAccessRegion* PmFindAccessRegion(const u32 address)
+{
+	u32 low = 0U;
+	u32 high = ARRAY_SIZE(pmAccessTable);
+	u32 mid;
+	const PmAccessRegion* region = NULL;
+
+	/* Find the last region that starts at or below the address */
+	while (low < high) {
+		mid = (low + high) / 2U;
+		if (pmAccessTable[mid].startAddr <= address) {
+			low = mid + 1U;
+		} else {
+			high = mid;
+		}
+	}
+
+	if ((0U != low) && (address <= pmAccessTable[low - 1U].endAddr)) {
+		region = &pmAccessTable[low - 1U];
+	}
+
+	return region;
+}
+
 /**
  * PmGetMmioAccess() - Retrieve access info for a particular address
  * @master     Master who requests access permission
@@ -100,20 +152,45 @@ static const PmAccessRegion pmAccessTable[] = {
  */
 bool PmGetMmioAccess(const PmMaster *const master, const u32 address)
 {
-	u32 i;
+	const PmAccessRegion* region;
 	bool permission = false;
 
 	if (NULL == master) {
 		goto done;
 	}
 
-	for (i = 0U; i < ARRAY_SIZE(pmAccessTable); i++) {
-		if ((address >= pmAccessTable[i].startAddr) &&
-		    (address <= pmAccessTable[i].endAddr)) {
-			permission = !!(pmAccessTable[i].access &
-					master->ipiMask);
-			break;
-		}
+	region = PmFindAccessRegion(address);
+	if (NULL != region) {
+		permission = !!(region->access & master->ipiMask);
+	}
+
+done:
+	return permission;
+}
+
+/**
+ * PmGetMmioAccessRange() - Retrieve access info for a range of addresses
+ * @master     Master who requests access permission
+ * @address    Start address of the range
+ * @size       Size of the range in bytes
+ *
+ * @return     Return true if the whole range lies within one region of the
+ *             access region table and master's IPI bit is present in it
+ */
+bool PmGetMmioAccessRange(const PmMaster *const master, const u32 address,
+			  const u32 size)
+{
+	const PmAccessRegion* region;
+	bool permission = false;
+
+	if ((NULL == master) || (0U == size) ||
+	    ((size - 1U) > (0xFFFFFFFFU - address))) {
+		goto done;
+	}
+
+	region = PmFindAccessRegion(address);
+	if ((NULL != region) && ((address + size - 1U) <= region->endAddr)) {
+		permission = !!(region->access & master->ipiMask);
 	}
 
 done:
@@ -35,5 +35,7 @@
  * Function declarations
  ********************************************************************/
 bool PmGetMmioAccess(const PmMaster *const master, const u32 address);
+bool PmGetMmioAccessRange(const PmMaster *const master, const u32 address,
+			  const u32 size);
 
 #endif
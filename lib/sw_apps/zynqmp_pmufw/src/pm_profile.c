@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ */
+
+/*********************************************************************
+ * Per-API latency profiling of PM requests, see pm_profile.h.
+ * PIT2 is run free running with auto-reload and is not used otherwise
+ * by the firmware. It must not be prescaled (GPO0 PIT2 prescale left
+ * at its reset value), so it counts at the PMU clock frequency.
+ *********************************************************************/
+
+#include "pm_profile.h"
+
+#ifdef ENABLE_PM_PROFILE
+
+#include "xpfw_default.h"
+#include "pm_defs.h"
+#include "pm_common.h"
+
+/* PIT2 counts per microsecond */
+#define PM_PROFILE_COUNT_PER_US	(XPFW_CFG_PMU_CLK_FREQ / 1000000U)
+
+/* PIT2 control: count enable with auto-reload */
+#define PM_PROFILE_PIT_CONTROL	(PMU_IOMODULE_PIT2_CONTROL_PRELOAD_MASK | \
+				 PMU_IOMODULE_PIT2_CONTROL_EN_MASK)
+
+static PmProfileStats pmProfileStats[PM_API_MAX + 1U];
+
+/**
+ * PmProfileInit() - Start the profiling time base and clear statistics
+ */
+void PmProfileInit(void)
+{
+	XPfw_Write32(PMU_IOMODULE_PIT2_CONTROL, 0U);
+	XPfw_Write32(PMU_IOMODULE_PIT2_PRELOAD, ~0U);
+	XPfw_Write32(PMU_IOMODULE_PIT2_CONTROL, PM_PROFILE_PIT_CONTROL);
+	PmProfileReset();
+}
+
+/**
+ * PmProfileStart() - Take a timestamp at the start of a PM API call
+ *
+ * @return  Current PIT2 count, to be passed to PmProfileEnd()
+ */
+u32 PmProfileStart(void)
+{
+	return XPfw_Read32(PMU_IOMODULE_PIT2_COUNTER);
+}
+
+/**
+ * PmProfileEnd() - Account a completed PM API call
+ * @apiId   Id of the PM API that was processed
+ * @start   Timestamp returned by PmProfileStart() for this call
+ *
+ * @note    Calls with an unknown API id are not accounted.
+ */
+void PmProfileEnd(const u32 apiId, const u32 start)
+{
+	/* PIT2 counts down, wrap-around is handled by unsigned arithmetic */
+	u32 elapsed = start - XPfw_Read32(PMU_IOMODULE_PIT2_COUNTER);
+	u32 us = elapsed / PM_PROFILE_COUNT_PER_US;
+	u32 bucket = 0U;
+	PmProfileStats* stats;
+
+	if ((apiId < PM_API_MIN) || (apiId > PM_API_MAX)) {
+		goto done;
+	}
+
+	stats = &pmProfileStats[apiId];
+	if ((0U == stats->count) || (elapsed < stats->min)) {
+		stats->min = elapsed;
+	}
+	if (elapsed > stats->max) {
+		stats->max = elapsed;
+	}
+	stats->total += elapsed;
+	stats->count++;
+
+	while ((us > 1U) && (bucket < (PM_PROFILE_BUCKETS - 1U))) {
+		us >>= 1U;
+		bucket++;
+	}
+	stats->histogram[bucket]++;
+
+done:
+	return;
+}
+
+/**
+ * PmProfileGetStats() - Get latency statistics of a PM API
+ * @apiId   Id of the PM API
+ *
+ * @return  Pointer to the statistics or NULL if the API id is not valid
+ */
+const PmProfileStats* PmProfileGetStats(const u32 apiId)
+{
+	const PmProfileStats* stats = NULL;
+
+	if ((apiId >= PM_API_MIN) && (apiId <= PM_API_MAX)) {
+		stats = &pmProfileStats[apiId];
+	}
+
+	return stats;
+}
+
+/**
+ * PmProfileReset() - Clear the statistics of all PM APIs
+ */
+void PmProfileReset(void)
+{
+	u32 i, j;
+
+	for (i = 0U; i < ARRAY_SIZE(pmProfileStats); i++) {
+		pmProfileStats[i].count = 0U;
+		pmProfileStats[i].min = 0U;
+		pmProfileStats[i].max = 0U;
+		pmProfileStats[i].total = 0U;
+		for (j = 0U; j < PM_PROFILE_BUCKETS; j++) {
+			pmProfileStats[i].histogram[j] = 0U;
+		}
+	}
+}
+
+/**
+ * PmProfilePrint() - Print statistics of all PM APIs that were called
+ *
+ * @note    Times are printed in microseconds. Histogram buckets are printed
+ *          from shortest (<2us) to longest.
+ */
+void PmProfilePrint(void)
+{
+	u32 i, j;
+	const PmProfileStats* stats;
+
+	for (i = PM_API_MIN; i <= PM_API_MAX; i++) {
+		stats = &pmProfileStats[i];
+		if (0U == stats->count) {
+			continue;
+		}
+		fw_printf("PM API %lu: calls %lu min %luus max %luus avg %luus\r\n",
+			  i, stats->count,
+			  stats->min / PM_PROFILE_COUNT_PER_US,
+			  stats->max / PM_PROFILE_COUNT_PER_US,
+			  (u32)((stats->total / stats->count) /
+				PM_PROFILE_COUNT_PER_US));
+		fw_printf("  histogram:");
+		for (j = 0U; j < PM_PROFILE_BUCKETS; j++) {
+			fw_printf(" %lu", stats->histogram[j]);
+		}
+		fw_printf("\r\n");
+	}
+}
+
+#endif /* ENABLE_PM_PROFILE */
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ */
+
+/*********************************************************************
+ * Per-API latency profiling of PM requests. PmProcessRequest() is timed
+ * with the free running PIT2 for each PM API call received over IPI,
+ * and accounted in a histogram with power-of-two microsecond buckets,
+ * so the cost of PM policy changes can be measured on the target.
+ * Build with ENABLE_PM_PROFILE defined in xpfw_config.h, or with
+ * XPFW_CFG_PM_PROFILE defined on the command line, to enable.
+ *********************************************************************/
+
+#ifndef PM_PROFILE_H_
+#define PM_PROFILE_H_
+
+#include "xil_types.h"
+#include "xpfw_config.h"
+
+#ifdef ENABLE_PM_PROFILE
+
+/*
+ * Number of histogram buckets. Bucket 0 counts calls shorter than 2us,
+ * bucket n counts calls in [2^n, 2^(n+1)) us and the last bucket counts
+ * everything longer.
+ */
+#define PM_PROFILE_BUCKETS	16U
+
+/**
+ * PmProfileStats - Latency statistics of one PM API
+ * @count       Number of calls accounted
+ * @min         Shortest call, in PIT2 counts
+ * @max         Longest call, in PIT2 counts
+ * @total       Sum of all calls, in PIT2 counts
+ * @histogram   Number of calls per microsecond bucket
+ */
+typedef struct PmProfileStats {
+	u32 count;
+	u32 min;
+	u32 max;
+	u64 total;
+	u32 histogram[PM_PROFILE_BUCKETS];
+} PmProfileStats;
+
+/*********************************************************************
+ * Function declarations
+ ********************************************************************/
+void PmProfileInit(void);
+u32 PmProfileStart(void);
+void PmProfileEnd(const u32 apiId, const u32 start);
+const PmProfileStats* PmProfileGetStats(const u32 apiId);
+void PmProfileReset(void);
+void PmProfilePrint(void);
+
+#endif /* ENABLE_PM_PROFILE */
+
+#endif
@@ -42,6 +42,15 @@
 #define XPFW_CFG_PMU_CLK_FREQ XPAR_PSU_PSS_REF_CLK_FREQ_HZ
 #endif
 
+/*
+ * OCM address of the PM_BATCH call arrays of the masters, see pm_core.c. It
+ * must match the batch_window_base parameter of the xilpm library, and the
+ * masters must not place anything else there.
+ */
+#ifndef XPFW_CFG_PM_BATCH_WINDOW_BASE
+#define XPFW_CFG_PM_BATCH_WINDOW_BASE 0xFFFE9000U
+#endif
+
 /* Let the MB sleep when it is Idle in Main Loop */
 #define SLEEP_WHEN_IDLE
 
@@ -58,4 +67,15 @@
 #undef ENABLE_RTC_TEST
 #undef ENABLE_SCHEDULER
 
+/*
+ * Define ENABLE_PM_PROFILE to collect per-API latency histograms of PM
+ * requests (uses PIT2), see pm_profile.h. Defining XPFW_CFG_PM_PROFILE on
+ * the compiler command line enables it as well.
+ */
+#ifdef XPFW_CFG_PM_PROFILE
+#define ENABLE_PM_PROFILE
+#else
+#undef ENABLE_PM_PROFILE
+#endif
+
 #endif /* XPFW_CONFIG_H_ */
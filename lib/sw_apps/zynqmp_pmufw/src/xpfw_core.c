@@ -205,6 +205,21 @@ XStatus XPfw_CoreScheduleTask(const XPfw_Module_t *ModPtr, u32 Interval,
 	return Status;
 }
 
+XStatus XPfw_CoreScheduleOneShotTask(const XPfw_Module_t *ModPtr, u32 Delay,
+		VoidFunction_t CallbackRef)
+{
+	XStatus Status;
+
+	if ((ModPtr != NULL) && (CorePtr != NULL)) {
+		Status = XPfw_SchedulerAddOneShotTask(&CorePtr->Scheduler,
+				ModPtr->ModId, Delay, CallbackRef);
+	} else {
+		Status = XST_FAILURE;
+	}
+
+	return Status;
+}
+
 s32 XPfw_CoreRemoveTask(const XPfw_Module_t *ModPtr, u32 Interval,
 		VoidFunction_t CallbackRef)
 {
@@ -260,7 +275,10 @@ XStatus XPfw_CoreLoop(void)
 		do {
 
 		#ifdef SLEEP_WHEN_IDLE
-				/*Sleep. Will be waken up when a interrupt occurs*/
+				/*
+				 * Sleep. Will be waken up when a interrupt occurs, the PIT
+				 * only fires at the next task deadline
+				 */
 				mb_sleep();
 		#endif
 
@@ -285,6 +303,7 @@ void XPfw_CorePrintStats(void)
 	fw_printf("Module Count: %d (%d)\r\n", CorePtr->ModCount, XPFW_MAX_MOD_COUNT);
 	fw_printf("Scheduler State: %s\r\n",((CorePtr->Scheduler.Enabled == TRUE)?"ENABLED":"DISABLED"));
 	fw_printf("Scheduler Ticks: %lu\r\n",CorePtr->Scheduler.Tick);
+	fw_printf("Scheduler Overruns: %lu\r\n",CorePtr->Scheduler.Overruns);
 	fw_printf("######################################################\r\n");
 	}
 }
@@ -28,14 +28,14 @@
 * this Software without prior written authorization from Xilinx.
 ******************************************************************************/
 
+
 #include "xpfw_scheduler.h"
 
 /**
- * PMU PIT Clock Frequency and Tick Calculation
+ * PMU PIT Clock Frequency and count per millisecond
  */
 #define PMU_PIT_CLK_FREQ	XPFW_CFG_PMU_CLK_FREQ
-#define TICK_MILLISECONDS	10U
-#define COUNT_PER_TICK ((PMU_PIT_CLK_FREQ / 1000U)* TICK_MILLISECONDS )
+#define COUNT_PER_MS	(PMU_PIT_CLK_FREQ / 1000U)
 
 /**
  * Microblaze IOModule PIT Register Offsets
@@ -45,6 +45,150 @@
 #define PIT_COUNTER_OFFSET	4U
 #define PIT_CONTROL_OFFSET	8U
 
+/* PIT control: count enable, no auto-reload (one-shot) */
+#define PIT_CONTROL_EN_ONESHOT	1U
+
+/* Largest count the 32-bit PIT can be loaded with */
+#define PIT_MAX_COUNT	0xFFFFFFFFU
+
+/*
+ * Smallest count the PIT is loaded with (10us). The interrupt handler acks
+ * the PIT interrupt after the tick handler has re-armed the PIT, so an
+ * expiry before the handler returns would be lost.
+ */
+#define PIT_MIN_COUNT	(COUNT_PER_MS / 100U)
+
+/* IRQ_PENDING/IRQ_ACK bit of the PIT with registers at PitBaseAddr */
+#define PIT_IRQ_MASK(PitBaseAddr)	(PMU_IOMODULE_IRQ_ACK_PIT0_MASK << \
+		(((PitBaseAddr) - PMU_IOMODULE_PIT0_PRELOAD) / \
+		 (PMU_IOMODULE_PIT1_PRELOAD - PMU_IOMODULE_PIT0_PRELOAD)))
+
+/* Interrupt enable bit in the MicroBlaze MSR */
+#define MSR_IE_MASK	0x2U
+
+/**
+ * Mask interrupts while the task time line is updated, since it is shared
+ * with the PIT1 handler. Returns the previous MSR so that interrupts are only
+ * re-enabled if they were enabled on entry.
+ */
+static u32 XPfw_SchedulerLock(void)
+{
+	u32 Msr = mfmsr();
+
+	microblaze_disable_interrupts();
+
+	return Msr;
+}
+
+static void XPfw_SchedulerUnlock(u32 Msr)
+{
+	if ((Msr & MSR_IE_MASK) != 0U) {
+		microblaze_enable_interrupts();
+	}
+}
+
+/**
+ * Current position on the scheduler time line, in PIT counts.
+ * The PIT counts down from Loaded, so the elapsed time since Base is the
+ * difference between the loaded value and the current count.
+ */
+static u64 XPfw_SchedulerNow(const XPfw_Scheduler_t *SchedPtr)
+{
+	u32 Count;
+	u64 Now = SchedPtr->Base;
+
+	if (SchedPtr->Loaded != 0U) {
+		Count = XPfw_Read32(SchedPtr->PitBaseAddr + PIT_COUNTER_OFFSET);
+		if (Count <= SchedPtr->Loaded) {
+			Now += (u64)(SchedPtr->Loaded - Count);
+		} else {
+			Now += (u64)SchedPtr->Loaded;
+		}
+	}
+
+	return Now;
+}
+
+/**
+ * Insert task Idx in Order, keeping it sorted by deadline.
+ * Tasks with equal deadlines keep the order in which they were inserted.
+ */
+static void XPfw_SchedulerInsert(XPfw_Scheduler_t *SchedPtr, u32 Idx)
+{
+	u32 Pos = SchedPtr->TaskCount;
+	u64 Deadline = SchedPtr->TaskList[Idx].Deadline;
+
+	while ((Pos > 0U) &&
+	       (SchedPtr->TaskList[SchedPtr->Order[Pos - 1U]].Deadline > Deadline)) {
+		SchedPtr->Order[Pos] = SchedPtr->Order[Pos - 1U];
+		Pos--;
+	}
+	SchedPtr->Order[Pos] = (u8)Idx;
+	SchedPtr->TaskCount++;
+}
+
+/**
+ * Remove task Idx from Order, if it is armed
+ */
+static void XPfw_SchedulerUnlink(XPfw_Scheduler_t *SchedPtr, u32 Idx)
+{
+	u32 Pos;
+
+	for (Pos = 0U; Pos < SchedPtr->TaskCount; Pos++) {
+		if (SchedPtr->Order[Pos] == Idx) {
+			break;
+		}
+	}
+
+	if (Pos < SchedPtr->TaskCount) {
+		SchedPtr->TaskCount--;
+		for (; Pos < SchedPtr->TaskCount; Pos++) {
+			SchedPtr->Order[Pos] = SchedPtr->Order[Pos + 1U];
+		}
+	}
+}
+
+/**
+ * Program the PIT for the earliest armed deadline, relative to Now.
+ * The PIT is left stopped if the scheduler is disabled or nothing is armed,
+ * so the PMU is not woken up needlessly.
+ * An expiry of the previous load that is still pending is acked, otherwise
+ * the tick handler would run for it on the new time line.
+ */
+static void XPfw_SchedulerArm(XPfw_Scheduler_t *SchedPtr, u64 Now)
+{
+	u64 Deadline;
+	u32 Delta;
+
+	SchedPtr->Base = Now;
+	SchedPtr->Loaded = 0U;
+	XPfw_Write32(SchedPtr->PitBaseAddr + PIT_CONTROL_OFFSET, 0U);
+	XPfw_Write32(PMU_IOMODULE_IRQ_ACK, PIT_IRQ_MASK(SchedPtr->PitBaseAddr));
+
+	if ((TRUE != SchedPtr->Enabled) || (0U == SchedPtr->TaskCount)) {
+		goto done;
+	}
+
+	Deadline = SchedPtr->TaskList[SchedPtr->Order[0]].Deadline;
+	if (Deadline <= (Now + PIT_MIN_COUNT)) {
+		/* Already or almost due, fire as soon as possible */
+		Delta = PIT_MIN_COUNT;
+	} else if ((Deadline - Now) > (u64)PIT_MAX_COUNT) {
+		/* Too far out for one load, re-arm on the intermediate expiry */
+		Delta = PIT_MAX_COUNT;
+	} else {
+		Delta = (u32)(Deadline - Now);
+	}
+
+	XPfw_Write32(SchedPtr->PitBaseAddr + PIT_PRELOAD_OFFSET, Delta);
+	XPfw_Write32(SchedPtr->PitBaseAddr + PIT_CONTROL_OFFSET,
+			PIT_CONTROL_EN_ONESHOT);
+	SchedPtr->Loaded = Delta;
+
+done:
+	return;
+}
+
 XStatus XPfw_SchedulerInit(XPfw_Scheduler_t *SchedPtr, u32 PitBaseAddr)
 {
 	u32 Idx;
@@ -58,13 +202,22 @@ XStatus XPfw_SchedulerInit(XPfw_Scheduler_t *SchedPtr, u32 PitBaseAddr)
 	/* Disable all the tasks */
 	for (Idx = 0U; Idx < XPFW_SCHED_MAX_TASK; Idx++) {
 		SchedPtr->TaskList[Idx].Interval = 0U;
+		SchedPtr->TaskList[Idx].OwnerId = 0U;
 		SchedPtr->TaskList[Idx].Callback = NULL;
 		SchedPtr->TaskList[Idx].Status = XPFW_TASK_STATUS_DISABLED;
+		SchedPtr->TaskList[Idx].Type = XPFW_TASK_TYPE_PERIODIC;
+		SchedPtr->TaskList[Idx].Period = 0U;
+		SchedPtr->TaskList[Idx].Deadline = 0U;
+		SchedPtr->TaskList[Idx].Overruns = 0U;
 	}
 
+	SchedPtr->TaskCount = 0U;
 	SchedPtr->Enabled = FALSE;
 	SchedPtr->PitBaseAddr = PitBaseAddr;
 	SchedPtr->Tick = 0U;
+	SchedPtr->Base = 0U;
+	SchedPtr->Loaded = 0U;
+	SchedPtr->Overruns = 0U;
 	XPfw_Write32(SchedPtr->PitBaseAddr + PIT_CONTROL_OFFSET, 0U);
 
 	/* Successfully completed init */
@@ -77,17 +230,39 @@ done:
 XStatus XPfw_SchedulerStart(XPfw_Scheduler_t *SchedPtr)
 {
 	XStatus Status;
+	u8 Armed[XPFW_SCHED_MAX_TASK];
+	u32 Count;
+	u32 Idx;
+	u32 Msr;
+	u64 Now;
 
 	if (SchedPtr == NULL) {
 		Status = XST_FAILURE;
 		goto done;
 	}
 
+	Msr = XPfw_SchedulerLock();
+
+	/*
+	 * Time did not advance while the scheduler was stopped, so start every
+	 * armed task with a full interval from now
+	 */
+	Now = XPfw_SchedulerNow(SchedPtr);
+	Count = SchedPtr->TaskCount;
+	for (Idx = 0U; Idx < Count; Idx++) {
+		Armed[Idx] = SchedPtr->Order[Idx];
+	}
+	SchedPtr->TaskCount = 0U;
+	for (Idx = 0U; Idx < Count; Idx++) {
+		SchedPtr->TaskList[Armed[Idx]].Deadline = Now +
+				(u64)SchedPtr->TaskList[Armed[Idx]].Period;
+		XPfw_SchedulerInsert(SchedPtr, Armed[Idx]);
+	}
+
 	SchedPtr->Enabled = TRUE;
+	XPfw_SchedulerArm(SchedPtr, Now);
 
-	XPfw_Write32(SchedPtr->PitBaseAddr + PIT_PRELOAD_OFFSET,
-			COUNT_PER_TICK);
-	XPfw_Write32(SchedPtr->PitBaseAddr + PIT_CONTROL_OFFSET, 3U);
+	XPfw_SchedulerUnlock(Msr);
 	Status = XST_SUCCESS;
 
 done:
@@ -96,28 +271,67 @@ done:
 
 XStatus XPfw_SchedulerStop(XPfw_Scheduler_t *SchedPtr)
 {
-	SchedPtr->Enabled =FALSE;
+	u32 Msr = XPfw_SchedulerLock();
+
+	SchedPtr->Enabled = FALSE;
+
+	/* Freeze the time line where the PIT stopped */
+	SchedPtr->Base = XPfw_SchedulerNow(SchedPtr);
+	SchedPtr->Loaded = 0U;
 
 	XPfw_Write32(SchedPtr->PitBaseAddr + PIT_PRELOAD_OFFSET, 0U );
 	XPfw_Write32(SchedPtr->PitBaseAddr + PIT_CONTROL_OFFSET, 0U );
+	XPfw_Write32(PMU_IOMODULE_IRQ_ACK, PIT_IRQ_MASK(SchedPtr->PitBaseAddr));
+
+	XPfw_SchedulerUnlock(Msr);
 
 	return XST_SUCCESS;
 }
 
 void XPfw_SchedulerTickHandler(XPfw_Scheduler_t *SchedPtr)
 {
+	struct XPfw_Task_t *TaskPtr;
 	u32 Idx;
-	/* TODO: Add check to detect task misses */
+	u64 Now;
+
 	SchedPtr->Tick++;
-	for (Idx = 0U; Idx < XPFW_SCHED_MAX_TASK; Idx++) {
-		/* Check if it this task can be triggered */
-		if ((0U != SchedPtr->TaskList[Idx].Interval) &&
-			(NULL != SchedPtr->TaskList[Idx].Callback) &&
-			(0U == (SchedPtr->Tick % SchedPtr->TaskList[Idx].Interval))) {
-			/* Mark the Task as TRIGGERED */
-			SchedPtr->TaskList[Idx].Status = XPFW_TASK_STATUS_TRIGGERED;
+
+	/*
+	 * Read the time line from the PIT rather than assuming the loaded
+	 * interval elapsed, so that a stale or spurious tick does not move
+	 * time forward. The PIT stops at zero, so interrupt latency is not
+	 * accounted for and shows up as a small drift.
+	 */
+	Now = XPfw_SchedulerNow(SchedPtr);
+	SchedPtr->Loaded = 0U;
+
+	while ((SchedPtr->TaskCount > 0U) &&
+	       (SchedPtr->TaskList[SchedPtr->Order[0]].Deadline <= Now)) {
+		Idx = SchedPtr->Order[0];
+		TaskPtr = &SchedPtr->TaskList[Idx];
+		XPfw_SchedulerUnlink(SchedPtr, Idx);
+
+		/* Previous expiry has not been processed yet */
+		if (XPFW_TASK_STATUS_TRIGGERED == TaskPtr->Status) {
+			TaskPtr->Overruns++;
+			SchedPtr->Overruns++;
+		}
+		/* Mark the Task as TRIGGERED */
+		TaskPtr->Status = XPFW_TASK_STATUS_TRIGGERED;
+
+		if (XPFW_TASK_TYPE_PERIODIC == TaskPtr->Type) {
+			TaskPtr->Deadline += (u64)TaskPtr->Period;
+			/* Skip, and count, the periods that were missed entirely */
+			while (TaskPtr->Deadline <= Now) {
+				TaskPtr->Deadline += (u64)TaskPtr->Period;
+				TaskPtr->Overruns++;
+				SchedPtr->Overruns++;
+			}
+			XPfw_SchedulerInsert(SchedPtr, Idx);
 		}
 	}
+
+	XPfw_SchedulerArm(SchedPtr, Now);
 }
 
 XStatus XPfw_SchedulerProcess(XPfw_Scheduler_t *SchedPtr)
@@ -125,15 +339,29 @@ XStatus XPfw_SchedulerProcess(XPfw_Scheduler_t *SchedPtr)
 	u32 Idx;
 	XStatus Status;
 	u32 CallCount = 0U;
+	XPfw_Callback_t Callback;
 
 	for (Idx = 0U; Idx < XPFW_SCHED_MAX_TASK; Idx++) {
 		/* Check if the task is triggered and has a valid Callback */
 		if ((XPFW_TASK_STATUS_TRIGGERED == SchedPtr->TaskList[Idx].Status) &&
 			(NULL != SchedPtr->TaskList[Idx].Callback)) {
-			/* Execute the Task */
-			SchedPtr->TaskList[Idx].Callback();
-			/* Disable the executed Task */
+			Callback = SchedPtr->TaskList[Idx].Callback;
+			/*
+			 * Clear the trigger before the Task runs, so an expiry
+			 * during the callback is not lost
+			 */
 			SchedPtr->TaskList[Idx].Status = XPFW_TASK_STATUS_DISABLED;
+			/*
+			 * One-shot tasks are no longer armed, release the slot
+			 * so the callback can schedule itself again
+			 */
+			if (XPFW_TASK_TYPE_ONESHOT == SchedPtr->TaskList[Idx].Type) {
+				SchedPtr->TaskList[Idx].Interval = 0U;
+				SchedPtr->TaskList[Idx].OwnerId = 0U;
+				SchedPtr->TaskList[Idx].Callback = NULL;
+			}
+			/* Execute the Task */
+			Callback();
 			CallCount++;
 		}
 	}
@@ -148,11 +376,24 @@ XStatus XPfw_SchedulerProcess(XPfw_Scheduler_t *SchedPtr)
 	return Status;
 }
 
-XStatus XPfw_SchedulerAddTask(XPfw_Scheduler_t *SchedPtr, u32 OwnerId,u32 MilliSeconds, XPfw_Callback_t Callback)
+static XStatus XPfw_SchedulerAdd(XPfw_Scheduler_t *SchedPtr, u32 OwnerId,
+		u32 MilliSeconds, XPfw_Callback_t Callback, u32 Type)
 {
 	u32 Idx;
+	u32 Msr;
+	u64 Now;
 	XStatus Status;
 
+	/* Interval must be non-zero and fit in a single PIT load */
+	if ((SchedPtr == NULL) || (Callback == NULL) || (0U == MilliSeconds) ||
+	    (MilliSeconds > (PIT_MAX_COUNT / COUNT_PER_MS))) {
+		Status = XST_FAILURE;
+		goto done;
+	}
+
+	/* Claim the slot under the lock, interrupt handlers also add tasks */
+	Msr = XPfw_SchedulerLock();
+
 	/* Get the Next Free Task Index */
 	for (Idx=0U;Idx < XPFW_SCHED_MAX_TASK;Idx++) {
 		if (0U == SchedPtr->TaskList[Idx].Interval) {
@@ -162,38 +403,77 @@ XStatus XPfw_SchedulerAddTask(XPfw_Scheduler_t *SchedPtr, u32 OwnerId,u32 MilliS
 
 	/* Check if we have reached Max Task limit */
 	if (XPFW_SCHED_MAX_TASK == Idx) {
+		XPfw_SchedulerUnlock(Msr);
 		Status = XST_FAILURE;
 		goto done;
 	}
 
-	/* Add Interval as a factor of TICK_MILLISECONDS */
-	SchedPtr->TaskList[Idx].Interval = MilliSeconds/TICK_MILLISECONDS;
+	Now = XPfw_SchedulerNow(SchedPtr);
+	SchedPtr->TaskList[Idx].Interval = MilliSeconds;
 	SchedPtr->TaskList[Idx].OwnerId = OwnerId;
 	SchedPtr->TaskList[Idx].Callback = Callback;
+	SchedPtr->TaskList[Idx].Status = XPFW_TASK_STATUS_DISABLED;
+	SchedPtr->TaskList[Idx].Type = Type;
+	SchedPtr->TaskList[Idx].Period = MilliSeconds * COUNT_PER_MS;
+	SchedPtr->TaskList[Idx].Deadline = Now +
+			(u64)SchedPtr->TaskList[Idx].Period;
+	SchedPtr->TaskList[Idx].Overruns = 0U;
+	XPfw_SchedulerInsert(SchedPtr, Idx);
+
+	/* Re-program the PIT if this is now the earliest deadline */
+	if ((TRUE == SchedPtr->Enabled) && (SchedPtr->Order[0] == Idx)) {
+		XPfw_SchedulerArm(SchedPtr, Now);
+	}
+
+	XPfw_SchedulerUnlock(Msr);
 	Status = XST_SUCCESS;
 
 done:
 	return Status;
 }
 
+XStatus XPfw_SchedulerAddTask(XPfw_Scheduler_t *SchedPtr, u32 OwnerId,u32 MilliSeconds, XPfw_Callback_t Callback)
+{
+	return XPfw_SchedulerAdd(SchedPtr, OwnerId, MilliSeconds, Callback,
+			XPFW_TASK_TYPE_PERIODIC);
+}
+
+XStatus XPfw_SchedulerAddOneShotTask(XPfw_Scheduler_t *SchedPtr, u32 OwnerId, u32 MilliSeconds, XPfw_Callback_t Callback)
+{
+	return XPfw_SchedulerAdd(SchedPtr, OwnerId, MilliSeconds, Callback,
+			XPFW_TASK_TYPE_ONESHOT);
+}
+
 XStatus XPfw_SchedulerRemoveTask(XPfw_Scheduler_t *SchedPtr, u32 OwnerId, u32 MilliSeconds, XPfw_Callback_t Callback)
 {
 	u32 Idx;
 	u32 TaskCount = 0;
+	u32 Msr;
+
+	Msr = XPfw_SchedulerLock();
 
 	/*Find the Task Index */
 	for (Idx = 0U; Idx < XPFW_SCHED_MAX_TASK; Idx++) {
 		if ((Callback == SchedPtr->TaskList[Idx].Callback) &&
 		    (SchedPtr->TaskList[Idx].OwnerId == OwnerId) &&
-		    ((SchedPtr->TaskList[Idx].Interval == MilliSeconds/TICK_MILLISECONDS) ||
+		    ((SchedPtr->TaskList[Idx].Interval == MilliSeconds) ||
 				(0U == MilliSeconds))) {
+			XPfw_SchedulerUnlink(SchedPtr, Idx);
 			SchedPtr->TaskList[Idx].Interval = 0U;
 			SchedPtr->TaskList[Idx].OwnerId = 0U;
 			SchedPtr->TaskList[Idx].Callback = NULL;
+			SchedPtr->TaskList[Idx].Status = XPFW_TASK_STATUS_DISABLED;
 			TaskCount++;
 		}
 	}
 
+	/* Drop the PIT expiry of a removed task, if it was the next one */
+	if ((TaskCount > 0U) && (TRUE == SchedPtr->Enabled)) {
+		XPfw_SchedulerArm(SchedPtr, XPfw_SchedulerNow(SchedPtr));
+	}
+
+	XPfw_SchedulerUnlock(Msr);
+
 	fw_printf("%s: Removed %lu tasks\r\n", __func__, TaskCount);
 
 	return ((TaskCount > 0) ? XST_SUCCESS : XST_FAILURE);
@@ -39,21 +39,39 @@
 #define XPFW_TASK_STATUS_TRIGGERED	0x5AFEC0C0U
 #define XPFW_TASK_STATUS_DISABLED	0x00000000U
 
+/* Values for TaskPtr->Type */
+#define XPFW_TASK_TYPE_PERIODIC	0U
+#define XPFW_TASK_TYPE_ONESHOT	1U
+
 typedef void (*XPfw_Callback_t) (void);
 
 struct XPfw_Task_t{
-	u32 Interval;
+	u32 Interval;	/* Period or delay in ms, 0 for a free slot */
 	u32 OwnerId;
 	u32 Status;
 	XPfw_Callback_t Callback;
+	u32 Type;
+	u32 Period;	/* Interval in PIT counts */
+	u64 Deadline;	/* Next expiry on the scheduler time line */
+	u32 Overruns;	/* Expiries missed or not processed in time */
 };
 
+/*
+ * The scheduler runs PIT1 in one-shot mode and programs it for the nearest
+ * task deadline, so the PMU is only woken up when a task is due. Time is
+ * kept in PIT counts on a 64-bit time line: Base is the time at which the
+ * PIT was last loaded with Loaded counts.
+ */
 typedef struct {
 	struct XPfw_Task_t TaskList[XPFW_SCHED_MAX_TASK];
-	u32 TaskCount;
+	u8 Order[XPFW_SCHED_MAX_TASK];	/* Armed tasks, earliest deadline first */
+	u32 TaskCount;			/* Number of entries in Order */
 	u32 PitBaseAddr;
-	u32 Tick;
+	u32 Tick;			/* Number of PIT expiries handled */
 	u32 Enabled;
+	u64 Base;
+	u32 Loaded;
+	u32 Overruns;			/* Sum of the task overruns */
 } XPfw_Scheduler_t ;
 
 void XPfw_SchedulerTickHandler(XPfw_Scheduler_t *SchedPtr);
@@ -62,6 +80,7 @@ XStatus XPfw_SchedulerStart(XPfw_Scheduler_t *SchedPtr);
 XStatus XPfw_SchedulerStop(XPfw_Scheduler_t *SchedPtr);
 XStatus XPfw_SchedulerProcess(XPfw_Scheduler_t *SchedPtr);
 XStatus XPfw_SchedulerAddTask(XPfw_Scheduler_t *SchedPtr, u32 OwnerId,u32 MilliSeconds, XPfw_Callback_t Callback);
+XStatus XPfw_SchedulerAddOneShotTask(XPfw_Scheduler_t *SchedPtr, u32 OwnerId, u32 MilliSeconds, XPfw_Callback_t Callback);
 XStatus XPfw_SchedulerRemoveTask(XPfw_Scheduler_t *SchedPtr, u32 OwnerId, u32 MilliSeconds, XPfw_Callback_t Callback);
 
 #endif /* XPFW_SCHEDULER_H_ */
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ */
+
+/*********************************************************************
+ * Host benchmark of PmProcessRequest() per PM API id, on PIT2.
+ *
+ * PIT2, which the firmware does not use, is run free running and read
+ * around every PmProcessRequest() call; pm_sim.c runs it at
+ * XPFW_CFG_PMU_CLK_FREQ on the host clock. Each API in the table below
+ * is called for the APU the given number of times, with the response
+ * written to its IPI buffer as for a call received over IPI. Calls that
+ * change state alternate between two payloads, or are paired with an
+ * untimed call of another API before or after them, so that every call
+ * succeeds and the state returns to where it was.
+ *
+ * For every API the PIT2 counts of PmProcessRequest() (min, average,
+ * max), the average in ns and the register accesses per call are
+ * printed. On the host the counts measure host execution time; on the
+ * target the same PIT2 reads give the PMU cycles for the same calls, and
+ * the register accesses, each a round trip on the PMU bus, carry over.
+ *
+ * The checks are that every call succeeds and that the statistics are
+ * consistent.
+ *
+ * Usage: pm_api_bench [calls per API]
+ *
+ * The default is 20000.
+ *********************************************************************/
+
+#include <stdlib.h>
+#include "pm_sim.h"
+#include "pm_defs.h"
+#include "pm_core.h"
+#include "ipi_buffer.h"
+#include "xpfw_default.h"
+
+#define MMIO_TEST_ADDR	0xFFFC0000U
+
+/* PIT2 control: count enable with auto-reload */
+#define BENCH_PIT_CONTROL	(PMU_IOMODULE_PIT2_CONTROL_PRELOAD_MASK | \
+				 PMU_IOMODULE_PIT2_CONTROL_EN_MASK)
+
+typedef struct {
+	const char *Name;
+	u32 Payload[2][PAYLOAD_ELEM_CNT];
+	/* Untimed calls before and after, not made if the API id is 0 */
+	u32 Before[2][PAYLOAD_ELEM_CNT];
+	u32 After[2][PAYLOAD_ELEM_CNT];
+} BenchApi;
+
+static const BenchApi Apis[] = {
+	{ "GET_API_VERSION",
+	  { { PM_GET_API_VERSION }, { PM_GET_API_VERSION } } },
+	{ "GET_NODE_STATUS",
+	  { { PM_GET_NODE_STATUS, NODE_UART_0 },
+	    { PM_GET_NODE_STATUS, NODE_GPIO } } },
+	{ "GET_OP_CHARACTERISTIC",
+	  { { PM_GET_OP_CHARACTERISTIC, NODE_APU_0, PM_OPCHAR_TYPE_POWER },
+	    { PM_GET_OP_CHARACTERISTIC, NODE_APU_0, PM_OPCHAR_TYPE_POWER } } },
+	{ "REGISTER_NOTIFIER",
+	  { { PM_REGISTER_NOTIFIER, NODE_TTC_0, EVENT_STATE_CHANGE, 0U, 1U },
+	    { PM_REGISTER_NOTIFIER, NODE_TTC_0, EVENT_STATE_CHANGE, 0U, 0U } } },
+	{ "SET_WAKEUP_SOURCE",
+	  { { PM_SET_WAKEUP_SOURCE, NODE_APU, NODE_UART_0, 1U },
+	    { PM_SET_WAKEUP_SOURCE, NODE_APU, NODE_UART_0, 0U } } },
+	{ "RELEASE_NODE",
+	  { { PM_RELEASE_NODE, NODE_TTC_0 }, { PM_RELEASE_NODE, NODE_SPI_0 } },
+	  { { 0U } },
+	  { { PM_REQUEST_NODE, NODE_TTC_0, PM_CAP_ACCESS, MAX_QOS,
+	      REQUEST_ACK_BLOCKING },
+	    { PM_REQUEST_NODE, NODE_SPI_0, PM_CAP_ACCESS, MAX_QOS,
+	      REQUEST_ACK_BLOCKING } } },
+	{ "REQUEST_NODE",
+	  { { PM_REQUEST_NODE, NODE_TTC_0, PM_CAP_ACCESS, MAX_QOS,
+	      REQUEST_ACK_BLOCKING },
+	    { PM_REQUEST_NODE, NODE_SPI_0, PM_CAP_ACCESS, MAX_QOS,
+	      REQUEST_ACK_BLOCKING } },
+	  { { PM_RELEASE_NODE, NODE_TTC_0 }, { PM_RELEASE_NODE, NODE_SPI_0 } } },
+	{ "SET_REQUIREMENT",
+	  { { PM_SET_REQUIREMENT, NODE_UART_0, PM_CAP_ACCESS | PM_CAP_CONTEXT,
+	      MAX_QOS, REQUEST_ACK_BLOCKING },
+	    { PM_SET_REQUIREMENT, NODE_UART_0, PM_CAP_ACCESS, MAX_QOS,
+	      REQUEST_ACK_BLOCKING } } },
+	{ "SET_MAX_LATENCY",
+	  { { PM_SET_MAX_LATENCY, NODE_UART_0, MAX_LATENCY },
+	    { PM_SET_MAX_LATENCY, NODE_UART_0, MAX_LATENCY } } },
+	{ "RESET_GET_STATUS",
+	  { { PM_RESET_GET_STATUS, PM_RESET_GPIO },
+	    { PM_RESET_GET_STATUS, PM_RESET_TTC0 } } },
+	{ "MMIO_WRITE",
+	  { { PM_MMIO_WRITE, MMIO_TEST_ADDR, 0xFFFFFFFFU, 0x12345678U },
+	    { PM_MMIO_WRITE, MMIO_TEST_ADDR, 0x0000FFFFU, 0x9ABCDEF0U } } },
+	{ "MMIO_READ",
+	  { { PM_MMIO_READ, MMIO_TEST_ADDR }, { PM_MMIO_READ, MMIO_TEST_ADDR } } },
+};
+
+typedef struct {
+	u32 Count;
+	u32 Min;
+	u32 Max;
+	u64 Total;
+} BenchStats;
+
+static u32 Failed;
+
+static void Check(int Cond, const char *What)
+{
+	if (!Cond) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+/* Makes one call with PmProcessRequest() timed on PIT2 */
+static void BenchCall(const u32 *const Payload, u32 *const Resp,
+		      BenchStats *const Stats)
+{
+	u32 Base = pmMasterApu_g.buffer + IPI_BUFFER_RESP_OFFSET;
+	u32 Start;
+	u32 Elapsed;
+	u32 Index;
+
+	/* Calls that answer with fewer words leave the rest 0 */
+	for (Index = 0U; Index < 4U; Index++) {
+		SimPoke(Base + (Index * PAYLOAD_ELEM_SIZE), 0U);
+	}
+
+	Start = XPfw_Read32(PMU_IOMODULE_PIT2_COUNTER);
+	PmProcessRequest(&pmMasterApu_g, Payload);
+	/* PIT2 counts down, wrap-around is handled by unsigned arithmetic */
+	Elapsed = Start - XPfw_Read32(PMU_IOMODULE_PIT2_COUNTER);
+
+	for (Index = 0U; Index < 4U; Index++) {
+		Resp[Index] = SimPeek(Base + (Index * PAYLOAD_ELEM_SIZE));
+	}
+
+	if ((0U == Stats->Count) || (Elapsed < Stats->Min)) {
+		Stats->Min = Elapsed;
+	}
+	if (Elapsed > Stats->Max) {
+		Stats->Max = Elapsed;
+	}
+	Stats->Total += Elapsed;
+	Stats->Count++;
+}
+
+int main(int argc, char *argv[])
+{
+	u32 Calls = 20000U;
+	u32 Resp[4];
+	u32 Index;
+	u32 Call;
+	u32 ApiId;
+	u64 Accesses;
+	u64 Start;
+	const BenchApi *Api;
+	BenchStats Stats;
+	int AllOk = 1;
+	int Counted = 1;
+	int Ordered = 1;
+
+	if (argc > 1) {
+		Calls = (u32)strtoul(argv[1], NULL, 0);
+	}
+	Calls += Calls & 1U;
+
+	SimInit();
+	XPfw_Write32(PMU_IOMODULE_PIT2_CONTROL, 0U);
+	XPfw_Write32(PMU_IOMODULE_PIT2_PRELOAD, ~0U);
+	XPfw_Write32(PMU_IOMODULE_PIT2_CONTROL, BENCH_PIT_CONTROL);
+
+	printf("%u calls per API, PIT2 at %u Hz\n\n", Calls,
+	       (u32)XPFW_CFG_PMU_CLK_FREQ);
+	printf("api name                   PIT2 min    avg    max"
+	       "     avg ns  reg acc/call\n");
+	for (Index = 0U; Index < ARRAY_SIZE(Apis); Index++) {
+		ApiId = Apis[Index].Payload[0][0];
+		memset(&Stats, 0, sizeof(Stats));
+		Accesses = 0U;
+		for (Call = 0U; Call < Calls; Call++) {
+			Api = &Apis[Index];
+			if (0U != Api->Before[Call & 1U][0]) {
+				SimIpiCall(&pmMasterApu_g, Api->Before[Call & 1U],
+					   Resp);
+			}
+			/* The two PIT2 reads are not accounted */
+			Start = SimReads + SimWrites + 2U;
+			BenchCall(Api->Payload[Call & 1U], Resp, &Stats);
+			Accesses += SimReads + SimWrites - Start;
+			if ((XST_SUCCESS != (int)Resp[0]) && (0 != AllOk)) {
+				printf("%s returned %d\n", Apis[Index].Name,
+				       (int)Resp[0]);
+				AllOk = 0;
+			}
+			if (0U != Api->After[Call & 1U][0]) {
+				SimIpiCall(&pmMasterApu_g, Api->After[Call & 1U],
+					   Resp);
+			}
+		}
+
+		if (Calls != Stats.Count) {
+			Counted = 0;
+		}
+		if ((Stats.Min > (Stats.Total / Stats.Count)) ||
+		    ((Stats.Total / Stats.Count) > Stats.Max)) {
+			Ordered = 0;
+		}
+		printf("%3u %-21s %8u %6.1f %6u %10.0f %13.1f\n", ApiId,
+		       Apis[Index].Name, Stats.Min,
+		       (double)Stats.Total / Stats.Count, Stats.Max,
+		       ((double)Stats.Total * 1e9) /
+		       ((double)XPFW_CFG_PMU_CLK_FREQ * Stats.Count),
+		       (double)Accesses / Calls);
+	}
+
+	Check(AllOk, "every benchmarked call succeeds");
+	Check(Counted, "every call is timed");
+	Check(Ordered, "min <= average <= max for every API");
+
+	printf("\n%s\n", Failed == 0U ? "all checks passed" : "CHECKS FAILED");
+	return Failed == 0U ? 0 : 1;
+}
@@ -0,0 +1,363 @@
+/*
+ * Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ */
+
+/*********************************************************************
+ * Host test and benchmark of PM_BATCH against the simulated address
+ * space of pm_sim.c.
+ *
+ * A sequence of calls that takes down and brings back up a set of
+ * peripherals of the APU (release six of the nodes the APU holds after
+ * boot, two MMIO writes and reads, request the nodes again) is issued once call by call through the APU's IPI
+ * buffer and once as a single PM_BATCH whose call array is in the APU
+ * batch window. Every call must return the same response both ways.
+ *
+ * The batch checks are that an array is only accepted when it lies in
+ * its entirety within a region the requesting master may access (its
+ * own batch window, not another master's, not the rest of OCM or DDR,
+ * and not crossing the end of the window), that nothing outside the
+ * array is written, that self suspend, request suspend, system shutdown
+ * and nested batches are rejected per entry, and that
+ * PM_BATCH_STOP_ON_ERROR stops at the first failure.
+ *
+ * The benchmark repeats the sequence both ways and prints the calls per
+ * second through the firmware (on the host), the register accesses
+ * per call and the IPI round trips per call, and the calls per second
+ * once an IPI round trip of the given length is added per request.
+ *
+ * Usage: pm_batch_sim [rounds] [IPI round trip in ns]
+ *
+ * The defaults are 20000 and 20000.
+ *********************************************************************/
+
+#include <stdlib.h>
+#include "pm_sim.h"
+#include "pm_defs.h"
+#include "ipi_buffer.h"
+
+/* Calls of the bring-up sequence */
+#define SEQ_CALLS	16U
+
+#define ENTRY_BYTES	(PM_BATCH_ENTRY_WORDS * PAYLOAD_ELEM_SIZE)
+#define RESP_WORDS	(PM_BATCH_ENTRY_WORDS - PM_BATCH_RESP_WORD)
+
+/* MMIO region all masters may access */
+#define MMIO_TEST_ADDR	0xFFFC0000U
+
+/* Marks memory the firmware must not write */
+#define SENTINEL	0xDEADBEEFU
+
+static const u32 SeqNodes[] = {
+	NODE_TTC_0, NODE_SPI_0, NODE_I2C_0, NODE_SD_0, NODE_GPIO, NODE_USB_0,
+};
+
+static u32 Seq[SEQ_CALLS][PAYLOAD_ELEM_CNT];
+static u32 Failed;
+
+static void Check(int Cond, const char *What)
+{
+	if (!Cond) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+static void SetCall(u32 *const Call, const u32 ApiId, const u32 Arg1,
+		    const u32 Arg2, const u32 Arg3, const u32 Arg4)
+{
+	Call[0] = ApiId;
+	Call[1] = Arg1;
+	Call[2] = Arg2;
+	Call[3] = Arg3;
+	Call[4] = Arg4;
+	Call[5] = 0U;
+}
+
+static void BuildSequence(void)
+{
+	u32 Index;
+	u32 Call = 0U;
+
+	for (Index = 0U; Index < ARRAY_SIZE(SeqNodes); Index++) {
+		SetCall(Seq[Call++], PM_RELEASE_NODE, SeqNodes[Index], 0U, 0U,
+			0U);
+	}
+	SetCall(Seq[Call++], PM_MMIO_WRITE, MMIO_TEST_ADDR, 0xFFFFFFFFU,
+		0x12345678U, 0U);
+	SetCall(Seq[Call++], PM_MMIO_WRITE, MMIO_TEST_ADDR + 4U, 0x0000FFFFU,
+		0x9ABCDEF0U, 0U);
+	SetCall(Seq[Call++], PM_MMIO_READ, MMIO_TEST_ADDR, 0U, 0U, 0U);
+	SetCall(Seq[Call++], PM_MMIO_READ, MMIO_TEST_ADDR + 4U, 0U, 0U, 0U);
+	for (Index = 0U; Index < ARRAY_SIZE(SeqNodes); Index++) {
+		SetCall(Seq[Call++], PM_REQUEST_NODE, SeqNodes[Index],
+			PM_CAP_ACCESS, MAX_QOS, REQUEST_ACK_BLOCKING);
+	}
+}
+
+/* Writes a call array, followed by a sentinel word */
+static void WriteArray(const u32 Addr, u32 (*const Calls)[PAYLOAD_ELEM_CNT],
+		       const u32 Count)
+{
+	u32 Call;
+	u32 Word;
+
+	for (Call = 0U; Call < Count; Call++) {
+		for (Word = 0U; Word < PM_BATCH_ENTRY_WORDS; Word++) {
+			SimPoke(Addr + (Call * ENTRY_BYTES) +
+				(Word * PAYLOAD_ELEM_SIZE),
+				(Word < PAYLOAD_ELEM_CNT) ?
+				Calls[Call][Word] : SENTINEL);
+		}
+	}
+	SimPoke(Addr + (Count * ENTRY_BYTES), SENTINEL);
+}
+
+static u32 EntryResp(const u32 Addr, const u32 Call, const u32 Word)
+{
+	return SimPeek(Addr + (Call * ENTRY_BYTES) +
+		       ((PM_BATCH_RESP_WORD + Word) * PAYLOAD_ELEM_SIZE));
+}
+
+static void SendBatch(const PmMaster *const Master, const u32 Addr,
+		      const u32 Count, const u32 Flags, u32 *const Resp)
+{
+	u32 Payload[PAYLOAD_ELEM_CNT] = { PM_BATCH, Addr, Count, Flags, 0U, 0U };
+
+	SimIpiCall(Master, Payload, Resp);
+}
+
+/* The sequence call by call and as a batch gives the same responses */
+static void TestSequence(void)
+{
+	u32 Single[SEQ_CALLS][RESP_WORDS];
+	u32 Resp[4];
+	u32 Call;
+	u32 Word;
+	int Same = 1;
+	int AllOk = 1;
+
+	SimInit();
+	for (Call = 0U; Call < SEQ_CALLS; Call++) {
+		SimIpiCall(&pmMasterApu_g, Seq[Call], Single[Call]);
+		if (XST_SUCCESS != (int)Single[Call][0]) {
+			printf("call %u (api %u) returned %d\n", Call,
+			       Seq[Call][0], (int)Single[Call][0]);
+			AllOk = 0;
+		}
+	}
+	Check(AllOk, "every call of the sequence succeeds");
+
+	SimInit();
+	WriteArray(PM_BATCH_WINDOW_APU, Seq, SEQ_CALLS);
+	SendBatch(&pmMasterApu_g, PM_BATCH_WINDOW_APU, SEQ_CALLS, 0U, Resp);
+	Check(XST_SUCCESS == (int)Resp[0] && SEQ_CALLS == Resp[1],
+	      "the batch succeeds and processes every call");
+	for (Call = 0U; Call < SEQ_CALLS; Call++) {
+		for (Word = 0U; Word < RESP_WORDS; Word++) {
+			if (EntryResp(PM_BATCH_WINDOW_APU, Call, Word) !=
+			    Single[Call][Word]) {
+				Same = 0;
+			}
+		}
+	}
+	Check(Same, "batched calls respond as the calls one by one");
+	Check(SENTINEL == SimPeek(PM_BATCH_WINDOW_APU +
+				  (SEQ_CALLS * ENTRY_BYTES)),
+	      "nothing is written after the array");
+}
+
+/* Returns 1 if the batch was refused without touching the array */
+static int Refused(const PmMaster *const Master, const u32 Addr,
+		   const u32 Count, const u32 Written)
+{
+	u32 Resp[4];
+
+	SimInit();
+	WriteArray(Addr, Seq, Written);
+	SendBatch(Master, Addr, Count, 0U, Resp);
+
+	return (XST_INVALID_PARAM == (int)Resp[0]) && (0U == Resp[1]) &&
+		(SENTINEL == EntryResp(Addr, 0U, 0U));
+}
+
+static void TestWindows(void)
+{
+	u32 Resp[4];
+	u32 Tail = PM_BATCH_WINDOW_APU + PM_BATCH_WINDOW_SIZE -
+		(2U * ENTRY_BYTES);
+
+	Check(Refused(&pmMasterApu_g, PM_BATCH_WINDOW_RPU_0, 4U, 4U),
+	      "APU array in the RPU_0 window is refused");
+	Check(Refused(&pmMasterRpu0_g, PM_BATCH_WINDOW_APU, 4U, 4U),
+	      "RPU_0 array in the APU window is refused");
+	Check(Refused(&pmMasterApu_g, Tail, 3U, 2U),
+	      "array crossing the end of the window is refused");
+	Check(Refused(&pmMasterApu_g, 0xFFFD0000U, 4U, 4U),
+	      "array elsewhere in OCM is refused");
+	Check(Refused(&pmMasterApu_g, 0x10000000U, 4U, 4U),
+	      "array in DDR is refused");
+	Check(Refused(&pmMasterApu_g, PM_BATCH_WINDOW_APU, 0U, 1U),
+	      "empty batch is refused");
+	Check(Refused(&pmMasterApu_g, PM_BATCH_WINDOW_APU,
+		      PM_BATCH_MAX_CALLS + 1U, 1U),
+	      "batch over PM_BATCH_MAX_CALLS is refused");
+	Check(Refused(&pmMasterApu_g, PM_BATCH_WINDOW_APU + 2U, 1U, 1U),
+	      "unaligned array is refused");
+
+	SimInit();
+	WriteArray(Tail, Seq, 2U);
+	SendBatch(&pmMasterApu_g, Tail, 2U, 0U, Resp);
+	Check(XST_SUCCESS == (int)Resp[0] && 2U == Resp[1],
+	      "array ending at the end of the window is accepted");
+
+	SimInit();
+	WriteArray(PM_BATCH_WINDOW_RPU_0, &Seq[6], 4U);
+	SendBatch(&pmMasterRpu0_g, PM_BATCH_WINDOW_RPU_0, 4U, 0U, Resp);
+	Check(XST_SUCCESS == (int)Resp[0] && 4U == Resp[1],
+	      "RPU_0 array in its own window is accepted");
+}
+
+static void TestRejectedCalls(void)
+{
+	static const u32 Rejected[] = {
+		PM_SELF_SUSPEND, PM_REQUEST_SUSPEND, PM_SYSTEM_SHUTDOWN,
+		PM_BATCH,
+	};
+	u32 Calls[3][PAYLOAD_ELEM_CNT];
+	u32 Resp[4];
+	u32 Index;
+
+	for (Index = 0U; Index < ARRAY_SIZE(Rejected); Index++) {
+		SetCall(Calls[0], PM_MMIO_READ, MMIO_TEST_ADDR, 0U, 0U, 0U);
+		SetCall(Calls[1], Rejected[Index], NODE_APU, 0U, 0U, 0U);
+		if (PM_BATCH == Rejected[Index]) {
+			SetCall(Calls[1], PM_BATCH, PM_BATCH_WINDOW_APU, 1U,
+				0U, 0U);
+		} else if (PM_SYSTEM_SHUTDOWN == Rejected[Index]) {
+			SetCall(Calls[1], PM_SYSTEM_SHUTDOWN, 0U, 0U, 0U, 0U);
+		} else if (PM_SELF_SUSPEND == Rejected[Index]) {
+			SetCall(Calls[1], PM_SELF_SUSPEND, NODE_APU_0,
+				MAX_LATENCY, 0U, 0U);
+		} else {
+			SetCall(Calls[1], PM_REQUEST_SUSPEND, NODE_RPU,
+				REQUEST_ACK_NO, MAX_LATENCY, 0U);
+		}
+		SetCall(Calls[2], PM_MMIO_READ, MMIO_TEST_ADDR, 0U, 0U, 0U);
+
+		SimInit();
+		WriteArray(PM_BATCH_WINDOW_APU, Calls, 3U);
+		SendBatch(&pmMasterApu_g, PM_BATCH_WINDOW_APU, 3U, 0U, Resp);
+		Check(XST_INVALID_PARAM == (int)Resp[0] && 3U == Resp[1] &&
+		      XST_SUCCESS == (int)EntryResp(PM_BATCH_WINDOW_APU, 0U, 0U) &&
+		      XST_INVALID_PARAM ==
+		      (int)EntryResp(PM_BATCH_WINDOW_APU, 1U, 0U) &&
+		      XST_SUCCESS == (int)EntryResp(PM_BATCH_WINDOW_APU, 2U, 0U),
+		      "suspend, shutdown and nested batches are rejected");
+
+		SimInit();
+		WriteArray(PM_BATCH_WINDOW_APU, Calls, 3U);
+		SendBatch(&pmMasterApu_g, PM_BATCH_WINDOW_APU, 3U,
+			  PM_BATCH_STOP_ON_ERROR, Resp);
+		Check(XST_INVALID_PARAM == (int)Resp[0] && 2U == Resp[1] &&
+		      SENTINEL == EntryResp(PM_BATCH_WINDOW_APU, 2U, 0U),
+		      "PM_BATCH_STOP_ON_ERROR skips the rest of the batch");
+	}
+}
+
+static void Bench(const u32 Rounds, const u64 RoundTripNs)
+{
+	u32 Resp[4];
+	u32 Round;
+	u32 Call;
+	u64 Start;
+	u64 Ns[2];
+	u64 Accesses[2];
+	u64 Trips[2];
+	u64 Calls = (u64)Rounds * SEQ_CALLS;
+	u32 Mode;
+
+	SimInit();
+	Start = SimHostNs();
+	for (Round = 0U; Round < Rounds; Round++) {
+		for (Call = 0U; Call < SEQ_CALLS; Call++) {
+			SimIpiCall(&pmMasterApu_g, Seq[Call], Resp);
+		}
+	}
+	Ns[0] = SimHostNs() - Start;
+	Accesses[0] = SimReads + SimWrites;
+	Trips[0] = Calls;
+
+	SimInit();
+	Start = SimHostNs();
+	for (Round = 0U; Round < Rounds; Round++) {
+		WriteArray(PM_BATCH_WINDOW_APU, Seq, SEQ_CALLS);
+		SendBatch(&pmMasterApu_g, PM_BATCH_WINDOW_APU, SEQ_CALLS, 0U,
+			  Resp);
+	}
+	Ns[1] = SimHostNs() - Start;
+	Accesses[1] = SimReads + SimWrites;
+	Trips[1] = Rounds;
+
+	printf("\n%u rounds of %u calls, %llu ns per IPI round trip\n\n",
+	       Rounds, SEQ_CALLS, (unsigned long long)RoundTripNs);
+	printf("              fw calls/s   reg acc/call  trips/call"
+	       "    calls/s with trips\n");
+	for (Mode = 0U; Mode < 2U; Mode++) {
+		printf("%-12s %12llu %12llu.%u %11.3f %14llu\n",
+		       (0U == Mode) ? "call by call" : "batched",
+		       (unsigned long long)((Calls * 1000000000U) / Ns[Mode]),
+		       (unsigned long long)(Accesses[Mode] / Calls),
+		       (u32)(((Accesses[Mode] * 10U) / Calls) % 10U),
+		       (double)Trips[Mode] / (double)Calls,
+		       (unsigned long long)((Calls * 1000000000U) /
+				(Ns[Mode] + (Trips[Mode] * RoundTripNs))));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	u32 Rounds = 20000U;
+	u64 RoundTripNs = 20000U;
+
+	if (argc > 1) {
+		Rounds = (u32)strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		RoundTripNs = strtoull(argv[2], NULL, 0);
+	}
+
+	BuildSequence();
+	TestSequence();
+	TestWindows();
+	TestRejectedCalls();
+	Bench(Rounds, RoundTripNs);
+
+	printf("\n%s\n", Failed == 0U ? "all checks passed" : "CHECKS FAILED");
+	return Failed == 0U ? 0 : 1;
+}
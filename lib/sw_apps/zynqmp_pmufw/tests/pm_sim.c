@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ */
+
+/*********************************************************************
+ * Host build model of the PMU address space, see pm_sim.h.
+ *********************************************************************/
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <time.h>
+#include "pm_sim.h"
+#include "pm_binding.h"
+#include "ipi_buffer.h"
+#include "xpfw_platform.h"
+#include "xpfw_rom_interface.h"
+#include "xpfw_config.h"
+#include "pmu_iomodule.h"
+
+/* Words of the sparse memory, must be a power of 2 */
+#define SIM_MEM_WORDS	(1U << 16)
+
+/* Reads of one address in a row after which the firmware is stuck */
+#define SIM_POLL_MAX	1000000U
+
+/* Number of IOModule PITs and the distance between their registers */
+#define SIM_PITS	4U
+#define SIM_PIT_STRIDE	(PMU_IOMODULE_PIT1_PRELOAD - PMU_IOMODULE_PIT0_PRELOAD)
+
+typedef struct {
+	u32 Addr;
+	u32 Value;
+	int Used;
+} SimWord;
+
+/* State of a PIT, the counter is computed from the time it was started */
+typedef struct {
+	u32 Preload;
+	u32 Control;
+	u32 Stopped;
+	u32 Fired;	/* Expiry of this one-shot load was latched */
+	u64 StartNs;
+} SimPit;
+
+static SimWord SimMem[SIM_MEM_WORDS];
+static SimPit SimPits[SIM_PITS];
+static u32 SimIrqPending;
+static u32 SimLastRead;
+static u32 SimSameReads;
+
+u64 SimReads;
+u64 SimWrites;
+int SimVerbose;
+int SimVirtualTime;
+u64 SimTimeNs;
+u32 SimMsr;
+
+static SimWord *SimFind(const u32 Addr, const int Create)
+{
+	u32 Index = ((Addr >> 2) * 2654435761U) & (SIM_MEM_WORDS - 1U);
+
+	while (SimMem[Index].Used && SimMem[Index].Addr != Addr) {
+		Index = (Index + 1U) & (SIM_MEM_WORDS - 1U);
+	}
+	if (!SimMem[Index].Used) {
+		if (!Create) {
+			return NULL;
+		}
+		SimMem[Index].Used = 1;
+		SimMem[Index].Addr = Addr;
+		SimMem[Index].Value = 0U;
+	}
+
+	return &SimMem[Index];
+}
+
+u32 SimPeek(const u32 Addr)
+{
+	const SimWord *Word = SimFind(Addr, 0);
+
+	return (NULL != Word) ? Word->Value : 0U;
+}
+
+void SimPoke(const u32 Addr, const u32 Value)
+{
+	SimFind(Addr, 1)->Value = Value;
+}
+
+u64 SimNowNs(void)
+{
+	return (0 != SimVirtualTime) ? SimTimeNs : SimHostNs();
+}
+
+/* Returns the PIT whose register is at Addr, or NULL */
+static SimPit *SimPitAt(const u32 Addr)
+{
+	u32 Pit = (Addr - PMU_IOMODULE_PIT0_PRELOAD) / SIM_PIT_STRIDE;
+
+	if ((Addr < PMU_IOMODULE_PIT0_PRELOAD) || (Pit >= SIM_PITS) ||
+	    ((Addr & (SIM_PIT_STRIDE - 1U)) > 8U)) {
+		return NULL;
+	}
+
+	return &SimPits[Pit];
+}
+
+/*
+ * Counts of a PIT since it was started, at the PMU clock. A one-shot
+ * PIT stops at 0, a PIT with auto-reload starts over from its preload.
+ */
+static u32 SimPitCounter(const SimPit *const Pit)
+{
+	u64 Counts;
+
+	if (0U == (Pit->Control & PMU_IOMODULE_PIT0_CONTROL_EN_MASK)) {
+		return Pit->Stopped;
+	}
+	Counts = ((SimNowNs() - Pit->StartNs) * XPFW_CFG_PMU_CLK_FREQ) /
+		1000000000U;
+	if (0U != (Pit->Control & PMU_IOMODULE_PIT0_CONTROL_PRELOAD_MASK)) {
+		return Pit->Preload - (u32)(Counts % ((u64)Pit->Preload + 1U));
+	}
+
+	return (Counts >= Pit->Preload) ? 0U : Pit->Preload - (u32)Counts;
+}
+
+static void SimPitWrite(SimPit *const Pit, const u32 Reg, const u32 Value)
+{
+	if (0U == Reg) {
+		Pit->Preload = Value;
+	} else if (8U == Reg) {
+		if (0U == (Value & PMU_IOMODULE_PIT0_CONTROL_EN_MASK)) {
+			Pit->Stopped = SimPitCounter(Pit);
+		} else if (0U == (Pit->Control &
+				  PMU_IOMODULE_PIT0_CONTROL_EN_MASK)) {
+			Pit->StartNs = SimNowNs();
+			Pit->Fired = 0U;
+		}
+		Pit->Control = Value;
+	}
+}
+
+/*
+ * Latches the interrupt of every one-shot PIT that reached 0 since it was
+ * started. PITs with auto-reload are only used as time bases here, their
+ * interrupts are not modelled.
+ */
+static void SimPitUpdate(void)
+{
+	u32 Index;
+	SimPit *Pit;
+
+	for (Index = 0U; Index < SIM_PITS; Index++) {
+		Pit = &SimPits[Index];
+		if ((0U != (Pit->Control & PMU_IOMODULE_PIT0_CONTROL_EN_MASK)) &&
+		    (0U == (Pit->Control &
+			    PMU_IOMODULE_PIT0_CONTROL_PRELOAD_MASK)) &&
+		    (0U == Pit->Fired) && (0U == SimPitCounter(Pit))) {
+			Pit->Fired = 1U;
+			SimIrqPending |= PMU_IOMODULE_IRQ_PENDING_PIT0_MASK << Index;
+		}
+	}
+}
+
+u64 SimPitExpiryNs(const u32 Index)
+{
+	const SimPit *Pit = &SimPits[Index];
+	u64 Ns;
+
+	if ((0U == (Pit->Control & PMU_IOMODULE_PIT0_CONTROL_EN_MASK)) ||
+	    (0U != (Pit->Control & PMU_IOMODULE_PIT0_CONTROL_PRELOAD_MASK)) ||
+	    (0U != Pit->Fired)) {
+		return ~(u64)0U;
+	}
+	/* First time at which the counter reads 0 */
+	Ns = (((u64)Pit->Preload * 1000000000U) + XPFW_CFG_PMU_CLK_FREQ - 1U) /
+		XPFW_CFG_PMU_CLK_FREQ;
+
+	return Pit->StartNs + Ns;
+}
+
+u32 SimIrqRead(void)
+{
+	SimPitUpdate();
+
+	return SimIrqPending;
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	SimPit *Pit = SimPitAt((u32)Addr);
+
+	SimReads++;
+	if ((u32)Addr == SimLastRead) {
+		if (++SimSameReads == SIM_POLL_MAX) {
+			printf("firmware polls 0x%08x forever\n", (u32)Addr);
+			exit(2);
+		}
+	} else {
+		SimLastRead = (u32)Addr;
+		SimSameReads = 0U;
+	}
+
+	if ((NULL != Pit) && (4U == (Addr & (SIM_PIT_STRIDE - 1U)))) {
+		return SimPitCounter(Pit);
+	}
+	if (PMU_IOMODULE_IRQ_PENDING == (u32)Addr) {
+		return SimIrqRead();
+	}
+
+	return SimPeek((u32)Addr);
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	SimPit *Pit = SimPitAt((u32)Addr);
+
+	SimWrites++;
+	SimLastRead = 0U;
+	if (NULL != Pit) {
+		SimPitWrite(Pit, (u32)Addr & (SIM_PIT_STRIDE - 1U), Value);
+	}
+	if (PMU_IOMODULE_IRQ_ACK == (u32)Addr) {
+		SimPitUpdate();
+		SimIrqPending &= ~Value;
+	}
+	SimPoke((u32)Addr, Value);
+}
+
+int SimPrint(const char *Format, ...)
+{
+	va_list Args;
+	int Len = 0;
+
+	if (SimVerbose) {
+		va_start(Args, Format);
+		Len = vprintf(Format, Args);
+		va_end(Args);
+	}
+
+	return Len;
+}
+
+static u32 SimRomService(void)
+{
+	return XST_SUCCESS;
+}
+
+const XpbrServHndlr_t XpbrServHndlrTbl[XPBR_SERV_EXT_TBL_MAX] = {
+	[0 ... XPBR_SERV_EXT_TBL_MAX - 1U] = SimRomService,
+};
+
+u8 XPfw_PlatformGetPsVersion(void)
+{
+	return XPFW_PLATFORM_PS_V1 + 1U;
+}
+
+/* Clears the address space and initializes the PM firmware */
+void SimInit(void)
+{
+	memset(SimMem, 0, sizeof(SimMem));
+	memset(SimPits, 0, sizeof(SimPits));
+	SimIrqPending = 0U;
+	SimTimeNs = 0U;
+	XPfw_PmInit();
+	SimReads = 0U;
+	SimWrites = 0U;
+}
+
+void SimIpiCall(const PmMaster *const Master, const u32 *const Payload,
+		u32 *const Resp)
+{
+	u32 IsrClr = 0U;
+	u32 Index;
+
+	for (Index = 0U; Index < PAYLOAD_ELEM_CNT; Index++) {
+		SimPoke(Master->buffer + IPI_BUFFER_REQ_OFFSET +
+			(Index * PAYLOAD_ELEM_SIZE), Payload[Index]);
+	}
+	/* Calls that answer with fewer words leave the rest 0 */
+	for (Index = 0U; Index < 4U; Index++) {
+		SimPoke(Master->buffer + IPI_BUFFER_RESP_OFFSET +
+			(Index * PAYLOAD_ELEM_SIZE), 0U);
+	}
+	(void)XPfw_PmIpiHandler(Master->ipiMask, Payload[0], &IsrClr);
+	for (Index = 0U; Index < 4U; Index++) {
+		Resp[Index] = SimPeek(Master->buffer + IPI_BUFFER_RESP_OFFSET +
+				      (Index * PAYLOAD_ELEM_SIZE));
+	}
+}
+
+u64 SimHostNs(void)
+{
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	return ((u64)Now.tv_sec * 1000000000U) + (u64)Now.tv_nsec;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ */
+
+/*********************************************************************
+ * Host build model of the address space seen by the PMU firmware.
+ * Registers, IPI buffers and OCM are kept in one sparse memory that
+ * reads 0 where nothing was written. The ROM service handlers all
+ * succeed. SimIpiCall() issues a PM API call the way a master does:
+ * it writes the payload to the master's IPI buffer, runs the IPI
+ * handler of the firmware and reads back the response.
+ * The IOModule PITs count down at XPFW_CFG_PMU_CLK_FREQ, on the host
+ * clock or, with SimVirtualTime set, on SimTimeNs as advanced by the
+ * test. A one-shot PIT that reaches 0 latches its bit in IRQ_PENDING
+ * until it is acked.
+ *********************************************************************/
+
+#ifndef PM_SIM_H_
+#define PM_SIM_H_
+
+#include "pm_master.h"
+#include "pm_api.h"
+
+/* Register accesses of the firmware since SimInit() */
+extern u64 SimReads;
+extern u64 SimWrites;
+
+/* Print the firmware's debug output */
+extern int SimVerbose;
+
+/* Run the PITs on SimTimeNs instead of the host clock */
+extern int SimVirtualTime;
+extern u64 SimTimeNs;
+
+void SimInit(void);
+u32 SimPeek(const u32 Addr);
+void SimPoke(const u32 Addr, const u32 Value);
+void SimIpiCall(const PmMaster *const Master, const u32 *const Payload,
+		u32 *const Resp);
+u64 SimHostNs(void);
+u64 SimNowNs(void);
+u64 SimPitExpiryNs(const u32 Index);
+u32 SimIrqRead(void);
+
+#endif /* PM_SIM_H_ */
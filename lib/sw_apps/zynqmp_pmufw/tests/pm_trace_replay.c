@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ */
+
+/*********************************************************************
+ * Replays a recorded sequence of PM requests against the host build of
+ * the PM framework and prints the per-API latency statistics and
+ * histograms of pm_profile.c (PmProcessRequest() timed on PIT2, which
+ * pm_sim.c runs at XPFW_CFG_PMU_CLK_FREQ on the host clock).
+ *
+ * A trace has one event per line, '#' starts a comment:
+ *
+ *   <apu|rpu0|rpu1> <api> [arg ...] [= status]
+ *       PM API call of a master through its IPI buffer. The API is
+ *       given by name without the PM_ prefix (REQUEST_NODE) or by id,
+ *       arguments are numbers or node names (NODE_UART_0). With
+ *       "= status" the status returned by the call is checked.
+ *   wfi <GPI2 mask>
+ *       Processors of the mask executed WFI (XPfw_PmWfiHandler()).
+ *   wake <GPI1 mask>
+ *       Wake request of the mask (XPfw_PmWakeHandler()).
+ *
+ * The whole trace is replayed the given number of times in a row after
+ * the framework is initialized, so the trace should leave the framework
+ * in the state it found it. apu_runtime.trace in this directory is an example.
+ *
+ * Usage: pm_trace_replay <trace> [rounds] [-v]
+ *
+ * The default is 1000 rounds. With -v the firmware's debug output is
+ * printed during the first round.
+ *********************************************************************/
+
+#include <stdlib.h>
+#include "pm_sim.h"
+#include "pm_defs.h"
+#include "pm_common.h"
+#include "pm_binding.h"
+#include "pm_profile.h"
+
+#define LINE_MAX	256U
+#define EVENTS_MAX	4096U
+
+#define EVENT_CALL	0U
+#define EVENT_WFI	1U
+#define EVENT_WAKE	2U
+
+typedef struct {
+	u32 Type;
+	const PmMaster *Master;
+	u32 Payload[PAYLOAD_ELEM_CNT];
+	int Check;
+	int Status;
+	u32 Line;
+} Event;
+
+static const char *const ApiNames[PM_API_MAX + 1U] = {
+	[PM_GET_API_VERSION] = "GET_API_VERSION",
+	[PM_SET_CONFIGURATION] = "SET_CONFIGURATION",
+	[PM_GET_NODE_STATUS] = "GET_NODE_STATUS",
+	[PM_GET_OP_CHARACTERISTIC] = "GET_OP_CHARACTERISTIC",
+	[PM_REGISTER_NOTIFIER] = "REGISTER_NOTIFIER",
+	[PM_REQUEST_SUSPEND] = "REQUEST_SUSPEND",
+	[PM_SELF_SUSPEND] = "SELF_SUSPEND",
+	[PM_FORCE_POWERDOWN] = "FORCE_POWERDOWN",
+	[PM_ABORT_SUSPEND] = "ABORT_SUSPEND",
+	[PM_REQUEST_WAKEUP] = "REQUEST_WAKEUP",
+	[PM_SET_WAKEUP_SOURCE] = "SET_WAKEUP_SOURCE",
+	[PM_SYSTEM_SHUTDOWN] = "SYSTEM_SHUTDOWN",
+	[PM_REQUEST_NODE] = "REQUEST_NODE",
+	[PM_RELEASE_NODE] = "RELEASE_NODE",
+	[PM_SET_REQUIREMENT] = "SET_REQUIREMENT",
+	[PM_SET_MAX_LATENCY] = "SET_MAX_LATENCY",
+	[PM_RESET_ASSERT] = "RESET_ASSERT",
+	[PM_RESET_GET_STATUS] = "RESET_GET_STATUS",
+	[PM_MMIO_WRITE] = "MMIO_WRITE",
+	[PM_MMIO_READ] = "MMIO_READ",
+	[PM_BATCH] = "BATCH",
+};
+
+static Event Events[EVENTS_MAX];
+static u32 EventCount;
+
+/* Parses a number, API or node name. Returns 0 if Token is none of them. */
+static int ParseValue(const char *Token, u32 *const Value)
+{
+	char *End;
+	u32 Id;
+
+	for (Id = PM_API_MIN; Id <= PM_API_MAX; Id++) {
+		if (0 == strcmp(Token, ApiNames[Id])) {
+			*Value = Id;
+			return 1;
+		}
+	}
+	for (Id = 0U; Id <= NODE_MAX; Id++) {
+		if (0 == strcmp(Token, PmStrNode(Id))) {
+			*Value = Id;
+			return 1;
+		}
+	}
+	*Value = (u32)strtoul(Token, &End, 0);
+
+	return ('\0' == *End) && (End != Token);
+}
+
+static int ParseLine(char *Text, const u32 Line)
+{
+	Event *Ev = &Events[EventCount];
+	char *Token;
+	u32 Arg = 0U;
+	u32 Value;
+
+	if (NULL != strchr(Text, '#')) {
+		*strchr(Text, '#') = '\0';
+	}
+	Token = strtok(Text, " \t\r\n");
+	if (NULL == Token) {
+		return 1;
+	}
+	if (EVENTS_MAX == EventCount) {
+		printf("line %u: more than %u events\n", Line, EVENTS_MAX);
+		return 0;
+	}
+
+	memset(Ev, 0, sizeof(*Ev));
+	Ev->Line = Line;
+	if (0 == strcmp(Token, "apu")) {
+		Ev->Master = &pmMasterApu_g;
+	} else if (0 == strcmp(Token, "rpu0")) {
+		Ev->Master = &pmMasterRpu0_g;
+	} else if (0 == strcmp(Token, "rpu1")) {
+		Ev->Master = &pmMasterRpu1_g;
+	} else if (0 == strcmp(Token, "wfi")) {
+		Ev->Type = EVENT_WFI;
+	} else if (0 == strcmp(Token, "wake")) {
+		Ev->Type = EVENT_WAKE;
+	} else {
+		printf("line %u: unknown event %s\n", Line, Token);
+		return 0;
+	}
+
+	while (NULL != (Token = strtok(NULL, " \t\r\n"))) {
+		if ((EVENT_CALL == Ev->Type) && (0 == strcmp(Token, "="))) {
+			Token = strtok(NULL, " \t\r\n");
+			if ((NULL == Token) || !ParseValue(Token, &Value)) {
+				printf("line %u: status expected\n", Line);
+				return 0;
+			}
+			Ev->Check = 1;
+			Ev->Status = (int)Value;
+			break;
+		}
+		if ((Arg == PAYLOAD_ELEM_CNT) ||
+		    ((EVENT_CALL != Ev->Type) && (1U == Arg)) ||
+		    !ParseValue(Token, &Ev->Payload[Arg])) {
+			printf("line %u: bad argument %s\n", Line, Token);
+			return 0;
+		}
+		Arg++;
+	}
+	if ((0U == Arg) || ((EVENT_CALL == Ev->Type) &&
+			    ((Ev->Payload[0] < PM_API_MIN) ||
+			     (Ev->Payload[0] > PM_API_MAX)))) {
+		printf("line %u: API or mask expected\n", Line);
+		return 0;
+	}
+	EventCount++;
+
+	return 1;
+}
+
+static int Load(const char *Path)
+{
+	FILE *File = fopen(Path, "r");
+	char Text[LINE_MAX];
+	u32 Line = 0U;
+	int Ok = 1;
+
+	if (NULL == File) {
+		printf("cannot open %s\n", Path);
+		return 0;
+	}
+	while (Ok && (NULL != fgets(Text, sizeof(Text), File))) {
+		Ok = ParseLine(Text, ++Line);
+	}
+	fclose(File);
+
+	return Ok;
+}
+
+/* Replays the trace once, returns the number of unexpected statuses */
+static u32 Replay(void)
+{
+	u32 Index;
+	u32 Resp[4];
+	u32 Mismatches = 0U;
+	const Event *Ev;
+	int Status;
+
+	for (Index = 0U; Index < EventCount; Index++) {
+		Ev = &Events[Index];
+		if (EVENT_WFI == Ev->Type) {
+			Status = XPfw_PmWfiHandler(Ev->Payload[0]);
+		} else if (EVENT_WAKE == Ev->Type) {
+			Status = XPfw_PmWakeHandler(Ev->Payload[0]);
+		} else {
+			SimIpiCall(Ev->Master, Ev->Payload, Resp);
+			Status = (int)Resp[0];
+		}
+		if ((Ev->Check || (EVENT_CALL != Ev->Type)) &&
+		    (Status != Ev->Status)) {
+			printf("line %u: status %d, expected %d\n", Ev->Line,
+			       Status, Ev->Status);
+			Mismatches++;
+		}
+	}
+
+	return Mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+	u32 Rounds = 1000U;
+	u32 Round;
+	u32 Mismatches = 0U;
+	u32 ApiId;
+	const PmProfileStats *Stats;
+	int Verbose = 0;
+	int Arg;
+
+	for (Arg = 2; Arg < argc; Arg++) {
+		if (0 == strcmp(argv[Arg], "-v")) {
+			Verbose = 1;
+		} else {
+			Rounds = (u32)strtoul(argv[Arg], NULL, 0);
+		}
+	}
+	if ((argc < 2) || !Load(argv[1])) {
+		printf("usage: %s <trace> [rounds] [-v]\n", argv[0]);
+		return 2;
+	}
+
+	SimInit();
+	for (Round = 0U; Round < Rounds; Round++) {
+		SimVerbose = Verbose && (0U == Round);
+		Mismatches += Replay();
+	}
+
+	printf("%u events replayed %u times\n\n", EventCount, Rounds);
+	printf("api name                    calls  PIT2 min    avg    max"
+	       "     avg ns\n");
+	for (ApiId = PM_API_MIN; ApiId <= PM_API_MAX; ApiId++) {
+		Stats = PmProfileGetStats(ApiId);
+		if (0U == Stats->count) {
+			continue;
+		}
+		printf("%3u %-21s %8u %8u %6.1f %6u %10.0f\n", ApiId,
+		       ApiNames[ApiId], Stats->count, Stats->min,
+		       (double)Stats->total / Stats->count, Stats->max,
+		       ((double)Stats->total * 1e9) /
+		       ((double)XPFW_CFG_PMU_CLK_FREQ * Stats->count));
+	}
+
+	printf("\nhistograms of pm_profile.c:\n");
+	SimVerbose = 1;
+	PmProfilePrint();
+
+	printf("\n%s\n", Mismatches == 0U ? "all statuses as expected" :
+	       "STATUS MISMATCHES");
+	return Mismatches == 0U ? 0 : 1;
+}
@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2016 Xilinx, Inc.  All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * Use of the Software is limited solely to applications:
+ * (a) running on a Xilinx device, or
+ * (b) that interact with a Xilinx device through a bus or interconnect.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * XILINX  BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+ * OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ * Except as contained in this notice, the name of the Xilinx shall not be used
+ * in advertising or otherwise to promote the sale, use or other dealings in
+ * this Software without prior written authorization from Xilinx.
+ */
+
+/*********************************************************************
+ * Host test and benchmark of the PMU firmware scheduler on a simulated
+ * PIT1, see pm_sim.c.
+ *
+ * Time is virtual. The test advances it to the next PIT1 expiry and
+ * runs the firmware interrupt path for it: the tick handler with
+ * interrupts masked, a return path of the given length, and the ack of
+ * PIT1 in IRQ_ACK, as XPfw_InterruptHandler() does. The triggered
+ * tasks are then run with XPfw_SchedulerProcess() as the main loop
+ * does.
+ *
+ * The checks are:
+ * - periodic tasks run once per period with no drift and share the
+ *   PIT wake-ups of coinciding deadlines,
+ * - an expiry that is pending while the PIT is re-armed does not run
+ *   the tick handler on the new time line,
+ * - a deadline due right after the tick handler re-armed the PIT is not
+ *   lost to the ack on the interrupt return path,
+ * - one-shot tasks run once and free their slot,
+ * - a full task table is reported and leaves interrupts as they were.
+ *
+ * The benchmark runs sets of tasks for a simulated time and prints the
+ * PIT wake-ups per second against the 100 per second of a fixed 10 ms
+ * tick, and the host time of the tick handler.
+ *
+ * Usage: xpfw_sched_sim [simulated seconds] [return path in ns]
+ *
+ * The defaults are 100 and 2000.
+ *********************************************************************/
+
+#include <stdlib.h>
+#include "pm_sim.h"
+#include "xpfw_scheduler.h"
+
+#define MS	1000000U	/* ns */
+#define OWNER	1U
+
+/* Tolerance of a task run against its deadline */
+#define SLACK_NS	50000U
+
+#define PIT1_IRQ	PMU_IOMODULE_IRQ_PENDING_PIT1_MASK
+
+static XPfw_Scheduler_t Sched;
+static u64 ReturnNs = 2000U;
+static u64 Ticks;
+static u64 TickHostNs;
+static u32 Runs[4];
+static u64 RunNs[4][128];
+static u32 Failed;
+
+static void Check(int Cond, const char *What)
+{
+	if (!Cond) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+static void Record(const u32 Task)
+{
+	if (Runs[Task] < ARRAY_SIZE(RunNs[Task])) {
+		RunNs[Task][Runs[Task]] = SimTimeNs;
+	}
+	Runs[Task]++;
+}
+
+static void Task0(void) { Record(0U); }
+static void Task1(void) { Record(1U); }
+static void Task2(void) { Record(2U); }
+static void Task3(void) { Record(3U); }
+
+/* The interrupt path of the firmware for a pending PIT1 expiry */
+static void Dispatch(void)
+{
+	u64 Start;
+
+	Ticks++;
+	SimMsr &= ~SIM_MSR_IE;
+	Start = SimHostNs();
+	XPfw_SchedulerTickHandler(&Sched);
+	TickHostNs += SimHostNs() - Start;
+	SimTimeNs += ReturnNs;
+	XPfw_Write32(PMU_IOMODULE_IRQ_ACK, PIT1_IRQ);
+	SimMsr |= SIM_MSR_IE;
+}
+
+/* Runs the firmware until EndNs */
+static void RunUntil(const u64 EndNs)
+{
+	u64 Next;
+
+	for (;;) {
+		if (0U != (SimIrqRead() & PIT1_IRQ)) {
+			Dispatch();
+			(void)XPfw_SchedulerProcess(&Sched);
+			continue;
+		}
+		Next = SimPitExpiryNs(1U);
+		if (Next > EndNs) {
+			break;
+		}
+		SimTimeNs = Next;
+	}
+	SimTimeNs = EndNs;
+}
+
+static void Reset(void)
+{
+	SimInit();
+	SimVirtualTime = 1;
+	SimMsr = SIM_MSR_IE;
+	Ticks = 0U;
+	TickHostNs = 0U;
+	memset(Runs, 0, sizeof(Runs));
+	(void)XPfw_SchedulerInit(&Sched, PMU_IOMODULE_PIT1_PRELOAD);
+	(void)XPfw_SchedulerStart(&Sched);
+}
+
+/* Period of a task in ns, as the scheduler rounds it to PIT counts */
+static u64 PeriodNs(const u32 Ms)
+{
+	return ((u64)Ms * (XPFW_CFG_PMU_CLK_FREQ / 1000U) * 1000000000U) /
+		XPFW_CFG_PMU_CLK_FREQ;
+}
+
+/* Every run of Task was at its deadline, counted from StartNs */
+static int OnTime(const u32 Task, const u32 Ms, const u64 StartNs)
+{
+	u32 Run;
+	u64 Due;
+
+	for (Run = 0U; (Run < Runs[Task]) && (Run < ARRAY_SIZE(RunNs[Task]));
+	     Run++) {
+		Due = StartNs + ((u64)(Run + 1U) * PeriodNs(Ms));
+		if ((RunNs[Task][Run] < Due) ||
+		    (RunNs[Task][Run] > (Due + SLACK_NS))) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void TestPeriodic(void)
+{
+	Reset();
+	(void)XPfw_SchedulerAddTask(&Sched, OWNER, 10U, Task0);
+	(void)XPfw_SchedulerAddTask(&Sched, OWNER, 25U, Task1);
+	RunUntil(1000U * MS);
+
+	Check(100U == Runs[0] && 40U == Runs[1],
+	      "periodic tasks run once per period");
+	Check(OnTime(0U, 10U, 0U) && OnTime(1U, 25U, 0U),
+	      "periodic tasks run at their deadlines");
+	Check(120U == Ticks, "coinciding deadlines share a PIT wake-up");
+	Check(0U == Sched.Overruns, "no overruns");
+}
+
+static void TestStalePending(void)
+{
+	Reset();
+	(void)XPfw_SchedulerAddTask(&Sched, OWNER, 10U, Task0);
+	(void)XPfw_SchedulerAddTask(&Sched, OWNER, 30U, Task1);
+	RunUntil(9U * MS);
+
+	/* PIT1 expires while interrupts are masked */
+	SimTimeNs = 10500000U;
+	Check(0U != (SimIrqRead() & PIT1_IRQ), "PIT1 expiry is pending");
+	SimMsr &= ~SIM_MSR_IE;
+	(void)XPfw_SchedulerRemoveTask(&Sched, OWNER, 10U, Task0);
+	SimMsr |= SIM_MSR_IE;
+	Check(0U == (SimIrqRead() & PIT1_IRQ),
+	      "re-arming the PIT acks the pending expiry");
+
+	/*
+	 * The PIT stopped at 0 while the expiry was pending, so the time line
+	 * lags by those 0.5 ms
+	 */
+	RunUntil(61U * MS);
+	Check(0U == Runs[0], "removed task does not run");
+	Check(2U == Runs[1] && OnTime(1U, 30U, 500000U),
+	      "the other task runs at its deadlines, not early");
+}
+
+static void TestNearDeadline(void)
+{
+	Reset();
+	(void)XPfw_SchedulerAddTask(&Sched, OWNER, 10U, Task0);
+	SimTimeNs = 1000U;
+	(void)XPfw_SchedulerAddTask(&Sched, OWNER, 10U, Task1);
+	RunUntil(1001U * MS);
+
+	Check(100U == Runs[0] && 100U == Runs[1],
+	      "deadline right after a tick is not lost to the ack");
+	Check(OnTime(0U, 10U, 0U) && OnTime(1U, 10U, 1000U),
+	      "both tasks run at their deadlines");
+}
+
+static void TestOneShot(void)
+{
+	Reset();
+	(void)XPfw_SchedulerAddTask(&Sched, OWNER, 10U, Task0);
+	(void)XPfw_SchedulerAddOneShotTask(&Sched, OWNER, 15U, Task1);
+	RunUntil(100U * MS);
+
+	Check(10U == Runs[0], "periodic task runs beside a one-shot task");
+	Check(1U == Runs[1] && OnTime(1U, 15U, 0U),
+	      "one-shot task runs once at its deadline");
+	Check(0U == Sched.TaskList[1].Interval, "one-shot task frees its slot");
+}
+
+static void TestFull(void)
+{
+	u32 Task;
+	XStatus Status = XST_SUCCESS;
+
+	Reset();
+	for (Task = 0U; Task < XPFW_SCHED_MAX_TASK; Task++) {
+		if (XST_SUCCESS != XPfw_SchedulerAddTask(&Sched, OWNER,
+							 10U + Task, Task0)) {
+			Status = XST_FAILURE;
+		}
+	}
+	Check(XST_SUCCESS == Status, "a task fits in every slot");
+	Check(XST_FAILURE == XPfw_SchedulerAddTask(&Sched, OWNER, 5U, Task1),
+	      "no task is added to a full table");
+	Check(SIM_MSR_IE == SimMsr, "interrupts are unmasked after the failure");
+
+	SimMsr = 0U;
+	(void)XPfw_SchedulerAddTask(&Sched, OWNER, 5U, Task1);
+	Check(0U == SimMsr, "interrupts stay masked if they were masked");
+
+	Check(XST_SUCCESS == XPfw_SchedulerRemoveTask(&Sched, OWNER, 12U, Task0),
+	      "a task is removed");
+	Check(XST_SUCCESS == XPfw_SchedulerAddTask(&Sched, OWNER, 5U, Task1),
+	      "its slot is reused");
+}
+
+static void Bench(const u32 Seconds)
+{
+	static const u32 Sets[][4] = {
+		{ 10U, 25U, 100U, 1000U },
+		{ 20U, 50U, 100U, 1000U },
+		{ 100U, 250U, 500U, 1000U },
+	};
+	static const XPfw_Callback_t Tasks[4] = { Task0, Task1, Task2, Task3 };
+	u32 Set;
+	u32 Task;
+	u32 TaskRuns;
+	int AllRun = 1;
+
+	printf("\n%u s per task set, return path %llu ns\n\n", Seconds,
+	       (unsigned long long)ReturnNs);
+	printf("tasks (ms)            wake-ups/s  runs/s  tick handler ns\n");
+	for (Set = 0U; Set < ARRAY_SIZE(Sets); Set++) {
+		Reset();
+		for (Task = 0U; Task < 4U; Task++) {
+			(void)XPfw_SchedulerAddTask(&Sched, OWNER, Sets[Set][Task],
+						    Tasks[Task]);
+		}
+		RunUntil((u64)Seconds * 1000U * MS);
+
+		TaskRuns = 0U;
+		for (Task = 0U; Task < 4U; Task++) {
+			TaskRuns += Runs[Task];
+			if (((u64)Seconds * 1000U / Sets[Set][Task]) !=
+			    Runs[Task]) {
+				AllRun = 0;
+			}
+		}
+		printf("%4u %4u %4u %4u %14.1f %7.1f %16.0f\n",
+		       Sets[Set][0], Sets[Set][1], Sets[Set][2], Sets[Set][3],
+		       (double)Ticks / Seconds, (double)TaskRuns / Seconds,
+		       (double)TickHostNs / (double)Ticks);
+	}
+	printf("fixed 10 ms tick               100.0\n");
+
+	Check(AllRun, "benchmark tasks run once per period");
+	Check(0U == Sched.Overruns, "no overruns in the benchmark");
+}
+
+int main(int argc, char *argv[])
+{
+	u32 Seconds = 100U;
+
+	if (argc > 1) {
+		Seconds = (u32)strtoul(argv[1], NULL, 0);
+	}
+	if (argc > 2) {
+		ReturnNs = strtoull(argv[2], NULL, 0);
+	}
+
+	TestPeriodic();
+	TestStalePending();
+	TestNearDeadline();
+	TestOneShot();
+	TestFull();
+	Bench(Seconds);
+
+	printf("\n%s\n", Failed == 0U ? "all checks passed" : "CHECKS FAILED");
+	return Failed == 0U ? 0 : 1;
+}
@@ -86,6 +86,15 @@ proc execs_generate {libhandle} {
 
 proc xgen_opts_file {libhandle} {
 
+	# Open xparameters.h file
+	set file_handle [hsi::utils::open_include_file "xparameters.h"]
+
+	puts $file_handle "/* Xilinx Power Management Library (XilPM) User Settings */"
+	set batch_window_base [common::get_property CONFIG.batch_window_base $libhandle]
+	puts $file_handle [format "\#define XPAR_XILPM_BATCH_WINDOW_BASE 0x%08XU" $batch_window_base]
+
+	close $file_handle
+
 	# Copy the include files to the include directory
 	set srcdir src
 	set dstdir [file join .. .. include]
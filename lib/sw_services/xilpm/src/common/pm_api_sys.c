@@ -33,6 +33,7 @@
 #include "pm_client.h"
 #include "pm_common.h"
 #include "pm_api_sys.h"
+#include "xil_cache.h"
 
 /**
  * Assigning of argument values into array elements.
@@ -823,3 +824,222 @@ XStatus XPm_MmioRead(const u32 address, u32 *const value)
 	/* Return result from IPI return buffer */
 	return pm_ipi_buff_read32(primary_master, value, NULL, NULL);
 }
+
+/**
+ * XPm_BatchInit() - Prepare an empty batch of PM API calls
+ * @batch	Batch to initialize
+ * @calls	Call array used by the batch. The PMU reads and writes it
+ *		directly, so it must be located in the batch window of the
+ *		calling master (PM_BATCH_WINDOW_APU, _RPU_0 or _RPU_1).
+ * @max		Number of entries in @calls
+ *
+ * A batch collects calls with the XPm_Batch* functions and sends them
+ * with XPm_BatchSend(), which costs one IPI round trip instead of one per
+ * call. Calls are numbered in the order they are added, starting at 0.
+ */
+void XPm_BatchInit(XPm_Batch *const batch, XPm_BatchCall *const calls,
+		   const u32 max)
+{
+	batch->calls = calls;
+	batch->max = (max > PM_BATCH_MAX_CALLS) ? PM_BATCH_MAX_CALLS : max;
+	batch->count = 0;
+	batch->done = 0;
+}
+
+/**
+ * XPm_BatchAdd() - Add a PM API call to a batch
+ * @batch	Batch to add the call to
+ * @api_id	PM API id of the call
+ * @arg1-5	Arguments, as passed in the IPI request of the call
+ *
+ * Calls that take an acknowledge argument should use REQUEST_ACK_BLOCKING
+ * to get their status back in the batch. PM_SELF_SUSPEND,
+ * PM_REQUEST_SUSPEND, PM_SYSTEM_SHUTDOWN and PM_BATCH are rejected by the
+ * PMU.
+ *
+ * @return	Returns XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the batch is
+ *		full
+ */
+XStatus XPm_BatchAdd(XPm_Batch *const batch, const u32 api_id,
+		     const u32 arg1, const u32 arg2, const u32 arg3,
+		     const u32 arg4, const u32 arg5)
+{
+	XPm_BatchCall *call;
+
+	if (batch->count >= batch->max)
+		return XST_BUFFER_TOO_SMALL;
+
+	call = &batch->calls[batch->count];
+	PACK_PAYLOAD5(call->args, api_id, arg1, arg2, arg3, arg4, arg5);
+	call->resp[0] = XST_FAILURE;
+	batch->count++;
+
+	return XST_SUCCESS;
+}
+
+/**
+ * XPm_BatchRequestNode() - Add XPm_RequestNode() to a batch
+ * @batch	Batch to add the call to
+ * @node	Node id of the slave
+ * @capabilities Requested capabilities of the slave
+ * @qos		Quality of service (not supported)
+ *
+ * @return	Returns XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the batch is
+ *		full
+ */
+XStatus XPm_BatchRequestNode(XPm_Batch *const batch,
+			     const enum XPmNodeId node,
+			     const u32 capabilities,
+			     const u32 qos)
+{
+	return XPm_BatchAdd(batch, PM_REQUEST_NODE, node, capabilities, qos,
+			    REQUEST_ACK_BLOCKING, 0);
+}
+
+/**
+ * XPm_BatchReleaseNode() - Add XPm_ReleaseNode() to a batch
+ * @batch	Batch to add the call to
+ * @node	Node id of the slave
+ *
+ * @return	Returns XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the batch is
+ *		full
+ */
+XStatus XPm_BatchReleaseNode(XPm_Batch *const batch,
+			     const enum XPmNodeId node)
+{
+	return XPm_BatchAdd(batch, PM_RELEASE_NODE, node, 0, 0, 0, 0);
+}
+
+/**
+ * XPm_BatchSetRequirement() - Add XPm_SetRequirement() to a batch
+ * @batch	Batch to add the call to
+ * @node	Node id of the slave
+ * @capabilities Requested capabilities of the slave
+ * @qos		Quality of service (not supported)
+ *
+ * @return	Returns XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the batch is
+ *		full
+ */
+XStatus XPm_BatchSetRequirement(XPm_Batch *const batch,
+				const enum XPmNodeId node,
+				const u32 capabilities,
+				const u32 qos)
+{
+	return XPm_BatchAdd(batch, PM_SET_REQUIREMENT, node, capabilities, qos,
+			    REQUEST_ACK_BLOCKING, 0);
+}
+
+/**
+ * XPm_BatchResetAssert() - Add XPm_ResetAssert() to a batch
+ * @batch	Batch to add the call to
+ * @reset	ID of the reset line
+ * @assert	Identifies action: release, assert, pulse
+ *
+ * @return	Returns XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the batch is
+ *		full
+ */
+XStatus XPm_BatchResetAssert(XPm_Batch *const batch,
+			     const enum XPmReset reset,
+			     const enum XPmResetAction assert)
+{
+	return XPm_BatchAdd(batch, PM_RESET_ASSERT, reset, assert, 0, 0, 0);
+}
+
+/**
+ * XPm_BatchMmioWrite() - Add XPm_MmioWrite() to a batch
+ * @batch	Batch to add the call to
+ * @address	Address to write to
+ * @mask	Mask to apply
+ * @value	Value to write
+ *
+ * @return	Returns XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the batch is
+ *		full
+ */
+XStatus XPm_BatchMmioWrite(XPm_Batch *const batch, const u32 address,
+			   const u32 mask, const u32 value)
+{
+	return XPm_BatchAdd(batch, PM_MMIO_WRITE, address, mask, value, 0, 0);
+}
+
+/**
+ * XPm_BatchMmioRead() - Add XPm_MmioRead() to a batch
+ * @batch	Batch to add the call to
+ * @address	Address to read from
+ *
+ * The value read is returned by XPm_BatchGetResult() once the batch has
+ * been sent.
+ *
+ * @return	Returns XST_SUCCESS, or XST_BUFFER_TOO_SMALL if the batch is
+ *		full
+ */
+XStatus XPm_BatchMmioRead(XPm_Batch *const batch, const u32 address)
+{
+	return XPm_BatchAdd(batch, PM_MMIO_READ, address, 0, 0, 0, 0);
+}
+
+/**
+ * XPm_BatchSend() - Send all calls of a batch to the PMU in one IPI request
+ * @batch	Batch to send
+ * @flags	PM_BATCH_STOP_ON_ERROR to skip the calls after a failed one
+ *
+ * This is a blocking call, it will return only once PMU has processed the
+ * batch. The number of calls processed is left in batch->done, and the
+ * result of each call can be read with XPm_BatchGetResult(). The calls
+ * stay in the batch, so it can be sent again or re-initialized with
+ * XPm_BatchInit().
+ *
+ * @return	Returns XST_SUCCESS if all calls succeeded, otherwise the
+ *		status of the first call that failed, or the error of the IPI
+ *		transfer itself
+ */
+XStatus XPm_BatchSend(XPm_Batch *const batch, const u32 flags)
+{
+	XStatus status;
+	u32 payload[PAYLOAD_ARG_CNT];
+	u32 size;
+
+	if ((NULL == batch) || (0 == batch->count))
+		return XST_INVALID_PARAM;
+
+	size = batch->count * sizeof(XPm_BatchCall);
+	batch->done = 0;
+
+	/* The PMU accesses the call array in memory, not through the cache */
+	Xil_DCacheFlushRange((INTPTR)batch->calls, size);
+
+	/* Send request to the PMU */
+	PACK_PAYLOAD3(payload, PM_BATCH, (u32)(UINTPTR)batch->calls,
+		      batch->count, flags);
+	status = pm_ipi_send(primary_master, payload);
+
+	if (XST_SUCCESS != status)
+		return status;
+
+	/* Return result from IPI return buffer */
+	status = pm_ipi_buff_read32(primary_master, &batch->done, NULL, NULL);
+
+	Xil_DCacheInvalidateRange((INTPTR)batch->calls, size);
+
+	return status;
+}
+
+/**
+ * XPm_BatchGetResult() - Get the result of one call of a sent batch
+ * @batch	Batch that has been sent
+ * @index	Number of the call, in the order the calls were added
+ * @value	Used to return the first value returned by the call (optional)
+ *
+ * @return	Returns status of the call, either success or error+reason.
+ *		Calls the PMU did not process return XST_FAILURE.
+ */
+XStatus XPm_BatchGetResult(const XPm_Batch *const batch, const u32 index,
+			   u32 *const value)
+{
+	if (index >= batch->done)
+		return XST_FAILURE;
+
+	if (NULL != value)
+		*value = batch->calls[index].resp[1];
+
+	return batch->calls[index].resp[0];
+}
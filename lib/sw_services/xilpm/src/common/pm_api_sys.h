@@ -149,6 +149,35 @@ typedef struct XPm_NodeStatus {
 	u32 usage;
 } XPm_NodeStatus;
 
+/**
+ * XPm_BatchCall - One PM API call of a batch
+ * @args	API id and arguments, laid out as in the IPI request
+ * @resp	Status and return values, written back by the PMU
+ *
+ * The layout must match PM_BATCH_ENTRY_WORDS/PM_BATCH_RESP_WORD.
+ */
+typedef struct XPm_BatchCall {
+	u32 args[PAYLOAD_ARG_CNT];
+	u32 resp[RESPONSE_ARG_CNT];
+} XPm_BatchCall;
+
+/**
+ * XPm_Batch - PM API calls sent to the PMU with a single IPI request
+ * @calls	Call array provided by the caller. Must be located in the
+ *		batch window of the calling master (PM_BATCH_WINDOW_*).
+ * @max		Number of entries in @calls (at most PM_BATCH_MAX_CALLS are
+ *		sent)
+ * @count	Number of calls added
+ * @done	Number of calls processed by the PMU in the last
+ *		XPm_BatchSend()
+ */
+typedef struct XPm_Batch {
+	XPm_BatchCall *calls;
+	u32 max;
+	u32 count;
+	u32 done;
+} XPm_Batch;
+
 /*********************************************************************
  * Global data declarations
  ********************************************************************/
@@ -204,4 +233,39 @@ XStatus XPm_MmioWrite(const u32 address, const u32 mask, const u32 value);
 
 XStatus XPm_MmioRead(const u32 address, u32 *const value);
 
+/* Batching of API calls */
+void XPm_BatchInit(XPm_Batch *const batch, XPm_BatchCall *const calls,
+		   const u32 max);
+
+XStatus XPm_BatchAdd(XPm_Batch *const batch, const u32 api_id,
+		     const u32 arg1, const u32 arg2, const u32 arg3,
+		     const u32 arg4, const u32 arg5);
+
+XStatus XPm_BatchRequestNode(XPm_Batch *const batch,
+			     const enum XPmNodeId node,
+			     const u32 capabilities,
+			     const u32 qos);
+
+XStatus XPm_BatchReleaseNode(XPm_Batch *const batch,
+			     const enum XPmNodeId node);
+
+XStatus XPm_BatchSetRequirement(XPm_Batch *const batch,
+				const enum XPmNodeId node,
+				const u32 capabilities,
+				const u32 qos);
+
+XStatus XPm_BatchResetAssert(XPm_Batch *const batch,
+			     const enum XPmReset reset,
+			     const enum XPmResetAction assert);
+
+XStatus XPm_BatchMmioWrite(XPm_Batch *const batch, const u32 address,
+			   const u32 mask, const u32 value);
+
+XStatus XPm_BatchMmioRead(XPm_Batch *const batch, const u32 address);
+
+XStatus XPm_BatchSend(XPm_Batch *const batch, const u32 flags);
+
+XStatus XPm_BatchGetResult(const XPm_Batch *const batch, const u32 index,
+			   u32 *const value);
+
 #endif /* _PM_API_SYS_H_ */
@@ -85,10 +85,31 @@ enum XPmApiId {
 	PM_RESET_GET_STATUS,
 	PM_MMIO_WRITE,
 	PM_MMIO_READ,
+	/* Batching of API calls: */
+	PM_BATCH,
 };
 
 #define PM_API_MIN	PM_GET_API_VERSION
-#define PM_API_MAX	PM_MMIO_READ
+#define PM_API_MAX	PM_BATCH
+
+/* Layout of the call array passed with PM_BATCH */
+#define PM_BATCH_MAX_CALLS	32U	/* Calls accepted in one batch */
+#define PM_BATCH_ENTRY_WORDS	10U	/* api id + 5 args, status + 3 values */
+#define PM_BATCH_RESP_WORD	6U	/* Word at which the response starts */
+
+/*
+ * OCM windows for the call arrays of PM_BATCH, one per master, starting at
+ * the batch_window_base parameter of the library (xparameters.h). The PMU
+ * only accepts an array that lies within a window of the requesting master,
+ * so the base must match the one the PMU firmware is built with.
+ */
+#define PM_BATCH_WINDOW_SIZE	(PM_BATCH_MAX_CALLS * PM_BATCH_ENTRY_WORDS * 4U)
+#define PM_BATCH_WINDOW_APU	XPAR_XILPM_BATCH_WINDOW_BASE
+#define PM_BATCH_WINDOW_RPU_0	(PM_BATCH_WINDOW_APU + PM_BATCH_WINDOW_SIZE)
+#define PM_BATCH_WINDOW_RPU_1	(PM_BATCH_WINDOW_RPU_0 + PM_BATCH_WINDOW_SIZE)
+
+/* PM_BATCH flags */
+#define PM_BATCH_STOP_ON_ERROR	0x1U	/* Skip the calls after a failed one */
 
 enum XPmApiCbId {
 	PM_INIT_SUSPEND_CB = 30,
@@ -55,6 +55,10 @@
 * 1.00  ba  09/10/14 Initial release
 * 1.1   ba  11/10/15 Modified Key loading logic in AES encryption
 * 1.1	ba  12/22/15 Added Chunking support in decryption
+* 1.2       10/18/26 Added double buffered chunk decryption and chunk
+*                    statistics
+* 1.2       10/18/26 Stream decrypted blocks with the chained CSU DMA
+*                    transfer
 *
 * </pre>
 *
@@ -65,9 +69,16 @@
 /***************************** Include Files *********************************/
 
 #include "xsecure_aes.h"
+#if XSECURE_AES_CHUNK_STATS
+#include "xtime_l.h"
+#endif
 
 /************************** Function Prototypes ******************************/
 
+static u64 XSecure_AesChunkTime(void);
+static s32 XSecure_AesChunkCopy(XSecure_Aes *InstancePtr, u32 SrcAddress,
+					u8 *Buffer, u32 Length);
+
 /************************** Function Definitions *****************************/
 
 /*****************************************************************************/
@@ -106,6 +117,10 @@ s32 XSecure_AesInitialize(XSecure_Aes *InstancePtr, XCsuDma *CsuDmaPtr,
 
 	InstancePtr->Key = Key;
 	InstancePtr->IsChunkingEnabled = XSECURE_CSU_AES_CHUNKING_DISABLED;
+	InstancePtr->ReadBuffer2 = NULL;
+	InstancePtr->ChunkStats.Chunks = 0U;
+	InstancePtr->ChunkStats.CopyTime = 0U;
+	InstancePtr->ChunkStats.WaitTime = 0U;
 
 	return XST_SUCCESS;
 }
@@ -148,7 +163,8 @@ void XSecure_AesSetChunking(XSecure_Aes *InstancePtr, u8 Chunking)
  *
  * @return	None
  *
- * @note	None
+ * @note	This clears any second buffer set with
+ *		XSecure_AesSetChunkBuffer2 and the chunk statistics.
  *
  ******************************************************************************/
 void XSecure_AesSetChunkConfig(XSecure_Aes *InstancePtr, u8 *ReadBuffer,
@@ -164,6 +180,117 @@ void XSecure_AesSetChunkConfig(XSecure_Aes *InstancePtr, u8 *ReadBuffer,
 	InstancePtr->ReadBuffer = ReadBuffer;
 	InstancePtr->ChunkSize = ChunkSize;
 	InstancePtr->DeviceCopy = DeviceCopy;
+	InstancePtr->ReadBuffer2 = NULL;
+	InstancePtr->ChunkStats.Chunks = 0U;
+	InstancePtr->ChunkStats.CopyTime = 0U;
+	InstancePtr->ChunkStats.WaitTime = 0U;
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Set a second buffer for double buffered data chunking. The next chunk is
+ * copied into one buffer while the current one is decrypted from the other.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Aes instance.
+ * @param	ReadBuffer2 is a buffer of the ChunkSize given to
+ *		XSecure_AesSetChunkConfig, or NULL to go back to a single
+ *		buffer.
+ *
+ * @return	None
+ *
+ * @note	Call after XSecure_AesSetChunkConfig. DeviceCopy must not use
+ *		the CSU DMA, as it runs while the CSU DMA is decrypting.
+ *
+ ******************************************************************************/
+void XSecure_AesSetChunkBuffer2(XSecure_Aes *InstancePtr, u8 *ReadBuffer2)
+{
+	/* Assert validates the input arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(ReadBuffer2 != InstancePtr->ReadBuffer);
+
+	InstancePtr->ReadBuffer2 = ReadBuffer2;
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Get the chunked decryption statistics accumulated since the last call to
+ * XSecure_AesSetChunkConfig.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Aes instance.
+ * @param	StatsPtr is a pointer to the structure to be filled in.
+ *
+ * @return	None
+ *
+ * @note	CopyTime and WaitTime are in XTime ticks and stay 0 unless
+ *		XSECURE_AES_CHUNK_STATS is set. With double buffering, a
+ *		WaitTime close to 0 means decryption is entirely hidden behind
+ *		the device copy.
+ *
+ ******************************************************************************/
+void XSecure_AesGetChunkStats(const XSecure_Aes *InstancePtr,
+				XSecure_AesChunkStats *StatsPtr)
+{
+	/* Assert validates the input arguments */
+	Xil_AssertVoid(InstancePtr != NULL);
+	Xil_AssertVoid(StatsPtr != NULL);
+
+	*StatsPtr = InstancePtr->ChunkStats;
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Current time for the chunk statistics.
+ *
+ * @return	XTime now, or 0 if XSECURE_AES_CHUNK_STATS is not set.
+ *
+ ******************************************************************************/
+static u64 XSecure_AesChunkTime(void)
+{
+	u64 Now = 0U;
+
+#if XSECURE_AES_CHUNK_STATS
+	XTime Time;
+
+	XTime_GetTime(&Time);
+	Now = (u64)Time;
+#endif
+
+	return Now;
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Copy one chunk from the device into a chunk buffer.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Aes instance.
+ * @param	SrcAddress is the address of the chunk in the device.
+ * @param	Buffer is the chunk buffer to copy into.
+ * @param	Length is the length of the chunk in bytes.
+ *
+ * @return	XST_SUCCESS or XSECURE_CSU_AES_DEVICE_COPY_ERROR
+ *
+ ******************************************************************************/
+static s32 XSecure_AesChunkCopy(XSecure_Aes *InstancePtr, u32 SrcAddress,
+					u8 *Buffer, u32 Length)
+{
+	s32 Status;
+	u64 Start = XSecure_AesChunkTime();
+
+	Status = (s32)InstancePtr->DeviceCopy(SrcAddress, (UINTPTR)Buffer,
+						Length);
+
+	InstancePtr->ChunkStats.CopyTime += XSecure_AesChunkTime() - Start;
+
+	if (XST_SUCCESS != Status)
+	{
+		Status = XSECURE_CSU_AES_DEVICE_COPY_ERROR;
+	}
+
+	return Status;
 }
 
 /*****************************************************************************/
@@ -410,27 +537,15 @@ void XSecure_AesEncrypt(XSecure_Aes *InstancePtr, u8 *Dst, const u8 *Src,
 	XCsuDma_SetConfig(InstancePtr->CsuDmaPtr, XCSUDMA_DST_CHANNEL,
 			&ConfigurValues);
 
-	/* Configure the CSU DMA Tx/Rx.*/
-	XCsuDma_Transfer(InstancePtr->CsuDmaPtr, XCSUDMA_DST_CHANNEL,
-				(UINTPTR) Dst,
-				(Len + XSECURE_SECURE_GCM_TAG_SIZE)/4U, 0);
-	XCsuDma_Transfer(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL,
-				(UINTPTR) Src,
-				Len/4U, 1);
-
-	/* Wait for Src DMA done. */
-	XCsuDma_WaitForDone(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL);
-
-	/* Acknowledge the transfer has completed */
-	XCsuDma_IntrClear(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL,
-						XCSUDMA_IXR_DONE_MASK);
-
-	/* Wait for Dst DMA done. */
-	XCsuDma_WaitForDone(InstancePtr->CsuDmaPtr, XCSUDMA_DST_CHANNEL);
-
-	/* Acknowledge the transfer has completed */
-	XCsuDma_IntrClear(InstancePtr->CsuDmaPtr, XCSUDMA_DST_CHANNEL,
-						XCSUDMA_IXR_DONE_MASK);
+	/*
+	 * Configure the CSU DMA Tx/Rx and wait for both channels. Data and
+	 * tag are streamed in chunks so the next one is always queued.
+	 */
+	(void)XCsuDma_ChainTransfer(InstancePtr->CsuDmaPtr,
+			(UINTPTR) Src, (u64)(Len & ~(u32)0x3U),
+			(UINTPTR) Dst,
+			(u64)((Len + XSECURE_SECURE_GCM_TAG_SIZE) & ~(u32)0x3U),
+			1U);
 
 	/* Disble CSU DMA Dst channel for byte swapping. */
 
@@ -466,47 +581,68 @@ void XSecure_AesEncrypt(XSecure_Aes *InstancePtr, u8 *Dst, const u8 *Src,
  *
  * @return	returns XST_SUCCESS if bitstream block is decrypted by AES.
  *
- * @note	None
+ * @note	With a second buffer the next chunk is copied from the device
+ *		while the current one is being decrypted, otherwise the copy
+ *		and the decryption of each chunk alternate.
  *
  ******************************************************************************/
 static s32 XSecure_AesChunkDecrypt(XSecure_Aes *InstancePtr, const u8 *Src,
 					u32 Len)
 {
 	/* Assert validates the input arguments */
-	Xil_AssertVoid(InstancePtr != NULL);
-	Xil_AssertVoid(Len != 0U);
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(Len != 0U);
 
 	s32 Status = XST_SUCCESS;
 
-	u32 NumChunks = Len / (InstancePtr->ChunkSize);
-	u32 RemainingBytes = Len % (InstancePtr->ChunkSize);
-	u32 Index = 0U;
+	u8 *Buffer[2];
+	u32 Cur = 0U;
+	u32 Offset = 0U;
+	u32 Size = 0U;
+	u32 NextSize = 0U;
 	u32 StartAddrByte = (u32)(INTPTR)Src;
+	u8 DoubleBuffer = (InstancePtr->ReadBuffer2 != NULL) ? 1U : 0U;
+	u64 WaitStart = 0U;
+
+	Buffer[0] = InstancePtr->ReadBuffer;
+	Buffer[1] = (DoubleBuffer != 0U) ? InstancePtr->ReadBuffer2 :
+						InstancePtr->ReadBuffer;
 
 	/*
 	 * Start the chunking process, copy encrypted chunks into OCM and push
 	 * decrypted data to PCAP
 	 */
+	Size = (Len > InstancePtr->ChunkSize) ? InstancePtr->ChunkSize : Len;
+	Status = XSecure_AesChunkCopy(InstancePtr, StartAddrByte, Buffer[Cur],
+					Size);
+	if (XST_SUCCESS != Status)
+	{
+		goto END;
+	}
 
-	for(Index = 0; Index < NumChunks; Index++)
+	while (Offset < Len)
 	{
-		Status = InstancePtr->DeviceCopy(StartAddrByte,
-					(UINTPTR)(InstancePtr->ReadBuffer),
-					InstancePtr->ChunkSize);
+		XCsuDma_Transfer(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL,
+					(UINTPTR)(Buffer[Cur]), Size/4U, 0);
 
-		if (XST_SUCCESS != Status)
+		Offset += Size;
+		NextSize = Len - Offset;
+		if (NextSize > InstancePtr->ChunkSize)
 		{
-			Status = XSECURE_CSU_AES_DEVICE_COPY_ERROR;
-			return Status;
+			NextSize = InstancePtr->ChunkSize;
 		}
 
-		XCsuDma_Transfer(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL,
-					(UINTPTR)(InstancePtr->ReadBuffer),
-					(InstancePtr->ChunkSize)/4U, 0);
+		/* Fetch the next chunk while this one is being decrypted */
+		if ((NextSize != 0U) && (DoubleBuffer != 0U))
+		{
+			Status = XSecure_AesChunkCopy(InstancePtr,
+					StartAddrByte + Offset,
+					Buffer[Cur ^ 1U], NextSize);
+		}
 
-		/*
-		 * wait for the SRC_DMA to complete
-		 */
+		WaitStart = XSecure_AesChunkTime();
+
+		/* wait for the SRC_DMA to complete and the pcap to be IDLE */
 		XCsuDma_WaitForDone(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL);
 
 		/* Acknowledge the transfers has completed */
@@ -515,34 +651,32 @@ static s32 XSecure_AesChunkDecrypt(XSecure_Aes *InstancePtr, const u8 *Src,
 
 		XSecure_PcapWaitForDone();
 
-		StartAddrByte += InstancePtr->ChunkSize;
-	}
-
-	if((RemainingBytes != 0))
-	{
-		Status = InstancePtr->DeviceCopy(StartAddrByte,
-				(UINTPTR)(InstancePtr->ReadBuffer), RemainingBytes);
+		InstancePtr->ChunkStats.WaitTime +=
+				XSecure_AesChunkTime() - WaitStart;
+		InstancePtr->ChunkStats.Chunks++;
 
+		/* A failed overlapped copy is reported once the DMA is idle */
 		if (XST_SUCCESS != Status)
 		{
-			Status = XSECURE_CSU_AES_DEVICE_COPY_ERROR;
-			return Status;
+			goto END;
 		}
 
-		XCsuDma_Transfer(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL,
-			(UINTPTR)(InstancePtr->ReadBuffer), RemainingBytes/4U, 0);
-
-		/* wait for the SRC_DMA to complete and the pcap to be IDLE */
-		XCsuDma_WaitForDone(InstancePtr->CsuDmaPtr,
-					XCSUDMA_SRC_CHANNEL);
-
-		/* Acknowledge the transfers have completed */
-		XCsuDma_IntrClear(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL,
-							XCSUDMA_IXR_DONE_MASK);
-		XSecure_PcapWaitForDone();
+		if ((NextSize != 0U) && (DoubleBuffer == 0U))
+		{
+			Status = XSecure_AesChunkCopy(InstancePtr,
+					StartAddrByte + Offset,
+					Buffer[Cur ^ 1U], NextSize);
+			if (XST_SUCCESS != Status)
+			{
+				goto END;
+			}
+		}
 
-		StartAddrByte += RemainingBytes;
+		Cur ^= 1U;
+		Size = NextSize;
 	}
+
+END:
 	return Status;
 }
 
@@ -574,6 +708,7 @@ static s32 XSecure_AesDecryptBlk(XSecure_Aes *InstancePtr, u8 *Dst,
 
 	u32 GcmStatus = 0U;
 	u32 StartAddrByte = (u32)(INTPTR)Src;
+	XCsuDma_Chain Chain;
 
 	/* Start the message. */
 	XSecure_WriteReg(InstancePtr->BaseAddress,
@@ -618,29 +753,32 @@ static s32 XSecure_AesDecryptBlk(XSecure_Aes *InstancePtr, u8 *Dst,
 			XCsuDma_SetConfig(InstancePtr->CsuDmaPtr,
 						XCSUDMA_DST_CHANNEL,
 						&ConfigurValues);
-			/* Configure the CSU DMA Tx/Rx for the incoming Block. */
-			XCsuDma_Transfer(InstancePtr->CsuDmaPtr,
-						XCSUDMA_DST_CHANNEL,
-						(UINTPTR)Dst, Len/4U, 0);
 		}
 
 		if (InstancePtr->IsChunkingEnabled
 			== XSECURE_CSU_AES_CHUNKING_DISABLED)
 		{
-			XCsuDma_Transfer(InstancePtr->CsuDmaPtr,
-						XCSUDMA_SRC_CHANNEL,
-						(UINTPTR)Src, Len/4U, 0);
-
+			/*
+			 * Stream the Block through the AES engine, keeping
+			 * the next chunk queued on each channel. The PCAP
+			 * consumes the output directly.
+			 */
+			XCsuDma_ChainInit(InstancePtr->CsuDmaPtr, &Chain, 0U);
 			if (Dst != (u8*)XSECURE_DESTINATION_PCAP_ADDR)
 			{
-				/* Wait for the Dst DMA completion. */
-				XCsuDma_WaitForDone(InstancePtr->CsuDmaPtr,
-							XCSUDMA_DST_CHANNEL);
-
-				XCsuDma_IntrClear(InstancePtr->CsuDmaPtr,
-							XCSUDMA_DST_CHANNEL,
-							XCSUDMA_IXR_DONE_MASK);
+				(void)XCsuDma_ChainStart(&Chain, (UINTPTR)Src,
+						(u64)Len, (UINTPTR)Dst,
+						(u64)Len, 0U);
+			}
+			else
+			{
+				(void)XCsuDma_ChainStart(&Chain, (UINTPTR)Src,
+						(u64)Len, 0U, 0U, 0U);
+			}
+			XCsuDma_ChainWait(&Chain);
 
+			if (Dst != (u8*)XSECURE_DESTINATION_PCAP_ADDR)
+			{
 				/* Disble CSU DMA Dst channel for byte swapping */
 
 				XCsuDma_GetConfig(InstancePtr->CsuDmaPtr,
@@ -655,16 +793,8 @@ static s32 XSecure_AesDecryptBlk(XSecure_Aes *InstancePtr, u8 *Dst,
 			}
 			else
 			{
-				/* Wait for the Src DMA completion. */
-				XCsuDma_WaitForDone(InstancePtr->CsuDmaPtr,
-							XCSUDMA_SRC_CHANNEL);
 				XSecure_PcapWaitForDone();
 			}
-
-			/* Acknowledge the transfers have completed */
-			XCsuDma_IntrClear(InstancePtr->CsuDmaPtr,
-						XCSUDMA_SRC_CHANNEL,
-						XCSUDMA_IXR_DONE_MASK);
 		}
 		else
 		{
@@ -50,6 +50,8 @@
 *
 * - AES decryption with/without keyrolling
 * - Authentication using GCM tag
+* - Chunked decryption from devices not reachable by CSU DMA, optionally
+*   double buffered
 *
 * <b>Initialization & Configuration</b>
 *
@@ -67,6 +69,17 @@
 * The initial Initialization vector will be used for decrypting secure header
 * and block 0 of given encrypted data.
 *
+* <b>Data Chunking</b>
+*
+* When the encrypted data cannot be read by CSU DMA directly (for example a
+* bitstream in QSPI on a DDR less system), chunking copies it chunk by chunk
+* into ReadBuffer with the DeviceCopy callback before decryption. If a second
+* buffer is given with XSecure_AesSetChunkBuffer2, chunks are double buffered:
+* chunk N+1 is copied into one buffer while chunk N is decrypted from the
+* other, so the device read overlaps with decryption. Both buffers must be
+* ChunkSize bytes. XSecure_AesGetChunkStats reports the number of chunks and,
+* with XSECURE_AES_CHUNK_STATS set, the time spent in each stage.
+*
 *
 * @note
 *	-The format of encrypted data(boot image) has to be exactly as
@@ -80,6 +93,8 @@
 * ----- ---- -------- -------------------------------------------------------
 * 1.00  ba   10/10/14 Initial release
 * 1.1   ba   11/10/15 Modified Key loading logic in AES encryption
+* 1.2        10/18/26 Added double buffered chunk decryption and chunk
+*                     statistics
 *
 * </pre>
 *
@@ -162,9 +177,29 @@
 
 #define XSECURE_DESTINATION_PCAP_ADDR    (0XFFFFFFFFU)
 
+/**
+ * When non-zero, chunked decryption timestamps each stage with XTime so the
+ * time spent copying from the device and waiting for decryption can be read
+ * back with XSecure_AesGetChunkStats. Requires xtime_l.h in the BSP.
+ */
+#ifndef XSECURE_AES_CHUNK_STATS
+#define XSECURE_AES_CHUNK_STATS	0
+#endif
+
 
 /************************** Type Definitions ********************************/
 
+/**
+ * Statistics of chunked decryption, accumulated since the last call to
+ * XSecure_AesSetChunkConfig.
+ */
+typedef struct {
+	u32 Chunks; /**< Number of chunks decrypted */
+	u64 CopyTime; /**< XTime ticks spent in DeviceCopy */
+	u64 WaitTime; /**< XTime ticks spent waiting for CSU DMA and PCAP
+			after the next chunk was copied */
+} XSecure_AesChunkStats;
+
 /**
  * The AES-GCM driver instance data structure. A pointer to an instance data
  * structure is passed around by functions to refer to a specific driver
@@ -187,6 +222,9 @@ typedef struct {
 		 * Length: Length of data in bytes.
 		 * Return value should be 0 in case of success and 1 for failure.
 		 */
+	u8* ReadBuffer2; /**< Second buffer for double buffered chunking,
+			  * NULL to use ReadBuffer only */
+	XSecure_AesChunkStats ChunkStats; /**< Chunked decryption statistics */
 } XSecure_Aes;
 
 /************************** Function Prototypes ******************************/
@@ -202,6 +240,9 @@ void XSecure_AesSetChunking(XSecure_Aes *InstancePtr, u8 Chunking);
 /* Configuring Data chunking settings */
 void XSecure_AesSetChunkConfig(XSecure_Aes *InstancePtr, u8 *ReadBuffer,
 				u32 ChunkSize, u32(*DeviceCopy)(u32, UINTPTR, u32));
+void XSecure_AesSetChunkBuffer2(XSecure_Aes *InstancePtr, u8 *ReadBuffer2);
+void XSecure_AesGetChunkStats(const XSecure_Aes *InstancePtr,
+				XSecure_AesChunkStats *StatsPtr);
 
 /* Decryption */
 s32 XSecure_AesDecrypt(XSecure_Aes *InstancePtr, u8 *Dst, const u8 *Src,
@@ -51,6 +51,8 @@
 * Ver   Who  Date     Changes
 * ----- ---- -------- -------------------------------------------------------
 * 1.00  ba   08/10/14 Initial release
+* 1.1        10/18/26 Added non-blocking update queue and scatter list
+*                     update
 *
 * </pre>
 *
@@ -68,6 +70,9 @@
 
 /************************** Function Prototypes ******************************/
 
+static s32 XSecure_Sha3Kick(XSecure_Sha3 *InstancePtr);
+static void XSecure_Sha3Drain(XSecure_Sha3 *InstancePtr);
+
 /************************** Variable Definitions *****************************/
 
 /************************** Function Definitions *****************************/
@@ -96,6 +101,13 @@ s32 XSecure_Sha3Initialize(XSecure_Sha3 *InstancePtr, XCsuDma* CsuDmaPtr)
 	InstancePtr->BaseAddress = XSECURE_CSU_SHA3_BASE;
 	InstancePtr->Sha3Len = 0U;
 	InstancePtr->CsuDmaPtr = CsuDmaPtr;
+	InstancePtr->QueueHead = 0U;
+	InstancePtr->QueueCount = 0U;
+	InstancePtr->Completed = 0U;
+	InstancePtr->Issued = 0U;
+	InstancePtr->Retired = 0U;
+	InstancePtr->Active = 0U;
+	XCsuDma_ChainInit(CsuDmaPtr, &InstancePtr->Chain, 0U);
 	return XST_SUCCESS;
 }
 
@@ -140,6 +152,9 @@ void XSecure_Sha3Start(XSecure_Sha3 *InstancePtr)
 
 	InstancePtr->Sha3Len = 0U;
 
+	/* Let blocks still queued from a previous hash complete first. */
+	XSecure_Sha3Drain(InstancePtr);
+
 	/* Reset SHA3 engine. */
 	XSecure_WriteReg(InstancePtr->BaseAddress,
 			XSECURE_CSU_SHA3_RESET_OFFSET,
@@ -178,17 +193,17 @@ void XSecure_Sha3Update(XSecure_Sha3 *InstancePtr, const u8 *Data,
 	Xil_AssertVoid(InstancePtr != NULL);
 	Xil_AssertVoid(Size != (u32)0x00U);
 
-	InstancePtr->Sha3Len += Size;
-
-	XCsuDma_Transfer(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL,
-					(UINTPTR)Data, (u32)Size/4, 0);
+	/* Data queued earlier must reach the engine first. */
+	XSecure_Sha3Drain(InstancePtr);
 
-	/* Checking the CSU DMA done bit should be enough. */
-	XCsuDma_WaitForDone(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL);
+	InstancePtr->Sha3Len += Size;
 
-	/* Acknowledge the transfer has completed */
-	XCsuDma_IntrClear(InstancePtr->CsuDmaPtr, XCSUDMA_SRC_CHANNEL,
-						XCSUDMA_IXR_DONE_MASK);
+	/*
+	 * Chained transfer keeps the next chunk queued behind the current one
+	 * and acknowledges the DONE status once all of them have completed.
+	 */
+	(void)XCsuDma_ChainTransfer(InstancePtr->CsuDmaPtr, (UINTPTR)Data,
+				(u64)(Size & ~(u32)0x3U), (UINTPTR)0U, 0U, 0U);
 }
 
 
@@ -239,8 +254,13 @@ void XSecure_Sha3Finish(XSecure_Sha3 *InstancePtr, u8 *Hash)
 	Xil_AssertVoid(Hash != NULL);
 
 	u32 *HashPtr = (u32 *)Hash;
-	u32 PartialLen = InstancePtr->Sha3Len % XSECURE_SHA3_BLOCK_LEN;
-	u8 XSecure_RsaSha3Array[512] = {0U};
+	u32 PartialLen;
+	u8 XSecure_RsaSha3Array[XSECURE_SHA3_BLOCK_LEN];
+
+	/* Complete the queued data before padding is sent. */
+	XSecure_Sha3Drain(InstancePtr);
+
+	PartialLen = InstancePtr->Sha3Len % XSECURE_SHA3_BLOCK_LEN;
 
 	PartialLen = (PartialLen == 0U)?(XSECURE_SHA3_BLOCK_LEN) :
 		(XSECURE_SHA3_BLOCK_LEN - PartialLen);
@@ -303,3 +323,255 @@ void XSecure_Sha3Digest(XSecure_Sha3 *InstancePtr, const u8 *In, const u32 Size,
 	XSecure_Sha3Update(InstancePtr, In, Size);
 	XSecure_Sha3Finish(InstancePtr, Out);
 }
+
+/*****************************************************************************/
+/**
+ *
+ * Queue a data block for hashing and return without waiting for it to be
+ * transferred.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Sha3 instance.
+ * @param	Data is the pointer to the input data for hashing. It must be
+ *		word aligned and left untouched until the block has completed.
+ * @param	Size of the input data in bytes, a multiple of 4
+ *
+ * @return
+ *		- XST_SUCCESS if the block was queued
+ *		- XST_DEVICE_BUSY if the queue is full
+ *
+ * @note	Blocks are hashed in the order they are queued. Completion can
+ *		be checked with XSecure_Sha3Poll and XSecure_Sha3GetCompleted.
+ *
+ ******************************************************************************/
+s32 XSecure_Sha3UpdateAsync(XSecure_Sha3 *InstancePtr, const u8 *Data,
+						const u32 Size)
+{
+	XSecure_Sha3Sg Block;
+
+	/* Asserts validate the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(Data != NULL);
+	Xil_AssertNonvoid(Size != (u32)0x00U);
+	Xil_AssertNonvoid((Size & (u32)0x3U) == 0U);
+
+	Block.Data = Data;
+	Block.Size = Size;
+
+	return XSecure_Sha3UpdateSg(InstancePtr, &Block, 1U);
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Queue a list of non-contiguous data blocks for hashing, in list order, and
+ * return without waiting for them to be transferred.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Sha3 instance.
+ * @param	List is the pointer to the array of blocks. The array itself
+ *		may be reused on return, the blocks may not until completed.
+ * @param	Count is the number of blocks in List, at most
+ *		XSECURE_SHA3_QUEUE_DEPTH
+ *
+ * @return
+ *		- XST_SUCCESS if all the blocks were queued
+ *		- XST_DEVICE_BUSY if the queue does not have room for all of
+ *		them, in which case none is queued
+ *		- XST_FAILURE if the CSU DMA transfer could not be started,
+ *		the blocks stay queued and are retried by XSecure_Sha3Poll
+ *
+ * @note	Every block must be word aligned and a multiple of 4 bytes.
+ *
+ ******************************************************************************/
+s32 XSecure_Sha3UpdateSg(XSecure_Sha3 *InstancePtr, const XSecure_Sha3Sg *List,
+						const u32 Count)
+{
+	u32 Index;
+	u32 Slot;
+	s32 Status;
+
+	/* Asserts validate the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+	Xil_AssertNonvoid(List != NULL);
+	Xil_AssertNonvoid(Count != 0U);
+	Xil_AssertNonvoid(Count <= XSECURE_SHA3_QUEUE_DEPTH);
+
+	/* Retire completed blocks to make room. */
+	(void)XSecure_Sha3Poll(InstancePtr);
+
+	if ((XSECURE_SHA3_QUEUE_DEPTH - InstancePtr->QueueCount) < Count) {
+		Status = XST_DEVICE_BUSY;
+		goto END;
+	}
+
+	for (Index = 0U; Index < Count; Index++) {
+		Xil_AssertNonvoid(List[Index].Data != NULL);
+		Xil_AssertNonvoid((List[Index].Size & (u32)0x3U) == 0U);
+
+		if (List[Index].Size == 0U) {
+			continue;
+		}
+
+		Slot = (InstancePtr->QueueHead + InstancePtr->QueueCount) %
+					XSECURE_SHA3_QUEUE_DEPTH;
+		InstancePtr->Queue[Slot] = List[Index];
+		InstancePtr->QueueCount++;
+		InstancePtr->Sha3Len += List[Index].Size;
+	}
+
+	Status = XSecure_Sha3Kick(InstancePtr);
+
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Advance the queue of blocks submitted with the non-blocking update APIs.
+ * Completed blocks are retired and queued blocks are handed to the CSU DMA
+ * as soon as it has room for them.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Sha3 instance.
+ *
+ * @return
+ *		- XST_SUCCESS if every queued block has completed
+ *		- XST_DEVICE_BUSY if blocks are still in progress
+ *		- XST_FAILURE if the CSU DMA transfer could not be started
+ *
+ * @note	Up to three blocks are in the hands of the CSU DMA at a time,
+ *		see XSecure_Sha3Kick, and the engine moves from one to the
+ *		next without software. Call this regularly while more blocks
+ *		are queued, they are only handed over from here.
+ *
+ ******************************************************************************/
+s32 XSecure_Sha3Poll(XSecure_Sha3 *InstancePtr)
+{
+	s32 Status;
+	u32 Done;
+
+	/* Asserts validate the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	if (InstancePtr->Active != 0U) {
+		Status = XCsuDma_ChainPoll(&InstancePtr->Chain);
+
+		/* Retire the blocks the CSU DMA has finished with. */
+		Done = XCsuDma_ChainGetBuffers(&InstancePtr->Chain) -
+					InstancePtr->Retired;
+		InstancePtr->Retired += Done;
+		InstancePtr->QueueHead = (InstancePtr->QueueHead + Done) %
+					XSECURE_SHA3_QUEUE_DEPTH;
+		InstancePtr->QueueCount -= Done;
+		InstancePtr->Issued -= Done;
+		InstancePtr->Completed += Done;
+
+		if (Status == XST_SUCCESS) {
+			InstancePtr->Active = 0U;
+		}
+	}
+
+	Status = XSecure_Sha3Kick(InstancePtr);
+	if ((Status == XST_SUCCESS) && (InstancePtr->QueueCount != 0U)) {
+		Status = XST_DEVICE_BUSY;
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Get the number of blocks completed since XSecure_Sha3Initialize.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Sha3 instance.
+ *
+ * @return	Number of completed blocks. Blocks complete in the order they
+ *		were queued, so a caller that counts its submissions knows
+ *		which buffers can be reused.
+ *
+ * @note	The count wraps around at 2^32.
+ *
+ ******************************************************************************/
+u32 XSecure_Sha3GetCompleted(XSecure_Sha3 *InstancePtr)
+{
+	/* Asserts validate the input arguments */
+	Xil_AssertNonvoid(InstancePtr != NULL);
+
+	(void)XSecure_Sha3Poll(InstancePtr);
+
+	return InstancePtr->Completed;
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Hand the queued blocks not yet issued to the CSU DMA. The first one starts
+ * a chained transfer, the following ones are appended to it so that the
+ * first chunk of a block is queued in the CSU DMA right behind the last chunk
+ * of the block before it.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Sha3 instance.
+ *
+ * @return
+ *		- XST_SUCCESS if the blocks were issued, or there is no room
+ *		for more yet
+ *		- XST_FAILURE if the CSU DMA transfer could not be started
+ *
+ * @note	None
+ *
+ ******************************************************************************/
+static s32 XSecure_Sha3Kick(XSecure_Sha3 *InstancePtr)
+{
+	const XSecure_Sha3Sg *Block;
+	s32 Status = XST_SUCCESS;
+
+	while (InstancePtr->Issued < InstancePtr->QueueCount) {
+		Block = &InstancePtr->Queue[(InstancePtr->QueueHead +
+				InstancePtr->Issued) % XSECURE_SHA3_QUEUE_DEPTH];
+
+		if (InstancePtr->Active == 0U) {
+			if (XCsuDma_ChainStart(&InstancePtr->Chain,
+					(UINTPTR)Block->Data, (u64)Block->Size,
+					(UINTPTR)0U, 0U, 0U) != XST_SUCCESS) {
+				/* Leave it queued, Drain must not wait on it */
+				Status = XST_FAILURE;
+				break;
+			}
+			InstancePtr->Active = 1U;
+			InstancePtr->Retired = 0U;
+		}
+		else if (XCsuDma_ChainAppend(&InstancePtr->Chain,
+				(UINTPTR)Block->Data, (u64)Block->Size) !=
+				XST_SUCCESS) {
+			/* The previous block is still being issued */
+			break;
+		}
+		else {
+			/* Appended behind the block in progress */
+		}
+
+		InstancePtr->Issued++;
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ *
+ * Wait until every queued block has been transferred to the engine.
+ *
+ * @param	InstancePtr is a pointer to the XSecure_Sha3 instance.
+ *
+ * @return	None
+ *
+ * @note	Returns early if a transfer could not be started, rather than
+ *		waiting for blocks that will never complete.
+ *
+ ******************************************************************************/
+static void XSecure_Sha3Drain(XSecure_Sha3 *InstancePtr)
+{
+	while (XSecure_Sha3Poll(InstancePtr) == XST_DEVICE_BUSY) {
+		;
+	}
+}
@@ -49,6 +49,7 @@
 * This driver supports the following features:
 *
 * - SHA-3 hash calculation
+* - Non-blocking updates through a submit/complete queue
 *
 * <b>Initialization & Configuration</b>
 *
@@ -60,6 +61,19 @@
 * A pointer to CsuDma instance has to be passed in initialization as CSU
 * DMA will be used for data transfers to SHA module.
 *
+* <b>Non-blocking Updates</b>
+*
+* XSecure_Sha3UpdateAsync and XSecure_Sha3UpdateSg queue buffers for hashing
+* and return immediately. Up to XSECURE_SHA3_QUEUE_DEPTH buffers can be
+* queued. They are fed to the CSU DMA as one chained transfer, each buffer
+* appended behind the one before it, so the engine moves from one buffer to
+* the next without waiting for software, and is kept busy for as long as the
+* caller keeps the queue topped up.
+* XSecure_Sha3Poll drives the queue and XSecure_Sha3GetCompleted returns the
+* number of buffers completed so far, after which they may be reused.
+* XSecure_Sha3Update and XSecure_Sha3Finish drain the queue first, so both
+* styles can be mixed within one hash.
+*
 *
 * @note
 *
@@ -69,6 +83,8 @@
 * Ver   Who  Date        Changes
 * ----- ---- -------- -------------------------------------------------------
 * 1.00  ba   11/05/14 Initial release
+* 1.1        10/18/26 Added XSecure_Sha3UpdateAsync, XSecure_Sha3UpdateSg,
+*                     XSecure_Sha3Poll and XSecure_Sha3GetCompleted
 *
 * </pre>
 *
@@ -101,8 +117,23 @@ extern "C" {
 
 #define XSECURE_SHA3_LAST_PACKET	(0x1U) /**< Last Data Packet */
 
+/**
+ * Number of buffers that can be queued with the non-blocking update APIs.
+ */
+#ifndef XSECURE_SHA3_QUEUE_DEPTH
+#define XSECURE_SHA3_QUEUE_DEPTH	(8U)
+#endif
+
 /***************************** Type Definitions******************************/
 
+/**
+ * A buffer to be hashed, as passed to XSecure_Sha3UpdateSg.
+ */
+typedef struct {
+	const u8 *Data; /**< Word aligned start of the buffer */
+	u32 Size; /**< Size of the buffer in bytes, a multiple of 4 */
+} XSecure_Sha3Sg;
+
 /**
  * The SHA-3 driver instance data structure. A pointer to an instance data
  * structure is passed around by functions to refer to a specific driver
@@ -112,6 +143,14 @@ typedef struct {
 	u32 BaseAddress;  /**< Device Base Address */
 	XCsuDma *CsuDmaPtr; /**< Pointer to CSU DMA Instance */
 	u32 Sha3Len; /**< SHA3 Input Length */
+	XCsuDma_Chain Chain; /**< Transfer of the buffers issued so far */
+	XSecure_Sha3Sg Queue[XSECURE_SHA3_QUEUE_DEPTH]; /**< Queued buffers */
+	u32 QueueHead; /**< Index of the oldest queued buffer */
+	u32 QueueCount; /**< Number of queued buffers */
+	u32 Completed; /**< Number of queued buffers completed */
+	u32 Issued; /**< Queued buffers handed to the CSU DMA */
+	u32 Retired; /**< Buffers of the current transfer retired */
+	u8 Active; /**< Chained transfer is in progress */
 } XSecure_Sha3;
 
 /***************************** Function Prototypes ***************************/
@@ -125,6 +164,14 @@ void XSecure_Sha3Update(XSecure_Sha3 *InstancePtr, const u8 *Data,
 						const u32 Size);
 void XSecure_Sha3Finish(XSecure_Sha3 *InstancePtr, u8 *Hash);
 
+/* Non-blocking Data Transfer */
+s32 XSecure_Sha3UpdateAsync(XSecure_Sha3 *InstancePtr, const u8 *Data,
+						const u32 Size);
+s32 XSecure_Sha3UpdateSg(XSecure_Sha3 *InstancePtr, const XSecure_Sha3Sg *List,
+						const u32 Count);
+s32 XSecure_Sha3Poll(XSecure_Sha3 *InstancePtr);
+u32 XSecure_Sha3GetCompleted(XSecure_Sha3 *InstancePtr);
+
 /* Complete SHA digest calculation */
 void XSecure_Sha3Digest(XSecure_Sha3 *InstancePtr, const u8 *In,
 						const u32 Size, u8 *Out);
@@ -0,0 +1,443 @@
+/******************************************************************************
+*
+* (c) Copyright 2014 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xsecure_aes_chunk_sim.c
+*
+* Host test and benchmark of the chunked AES decryption used for bitstreams
+* on systems without DDR, with one and with two chunk buffers.
+*
+* XSecure_AesChunkDecrypt is static, so this file includes xsecure_aes.c.
+* It runs against a model of the CSU_DMA source channel feeding the AES
+* engine and the PCAP, and of a flash device read by the DeviceCopy
+* callback. The source channel holds the command it is executing and one
+* more, moves one word per tick and keeps the done count and the DONE and
+* INVALID_APB interrupt status bits. The PCAP reports write idle a fixed time
+* after the last word has reached it. DeviceCopy takes a time per byte and
+* lands the data in the chunk buffer when it returns, so a buffer that is
+* refilled while the CSU_DMA is still reading it corrupts the stream.
+*
+* Time only moves when the CPU accesses a register, does cache maintenance or
+* reads the flash.
+*
+* Checked first, with one and two buffers and a length that is not a
+* multiple of the chunk size:
+*  - the PCAP receives the image intact and in order,
+*  - the DONE status of each chunk is acknowledged before the next command
+*    is issued, and is clear on return,
+*  - the number of chunks is reported,
+*  - a failed overlapped copy is reported only once the chunk in flight has
+*    completed.
+* Then a 1 MB image is decrypted in 4 KB chunks (READ_BUFFER_SIZE of the
+* FSBL) with several flash speeds, and the modelled throughput is printed.
+*
+* Usage: xsecure_aes_chunk_sim [MB/s] [ns per access] [ns per cache line]
+*        [ns per command]
+*
+* The defaults are 400 MB/s, 40 ns, 8 ns and 100 ns.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.1        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xsecure_aes.c"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_DMA_BASE	0xFFC80000U	/* CSU_DMA */
+#define SIM_QUEUE	2U		/* Commands buffered per channel */
+#define SIM_LINE	64U		/* Cache line, bytes */
+#define SIM_PCAP_NS	200.0		/* PCAP write idle after last word */
+#define SIM_FLASH_BASE	0x08000000U	/* Image address passed to the driver */
+
+#define BENCH_BYTES	(1024U * 1024U)
+#define BENCH_CHUNK	(4U * 1024U)
+#define CHECK_BYTES	((5U * BENCH_CHUNK) + 1000U)
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u8 *Ptr;
+	u32 Bytes;
+	u32 Moved;
+} SimCmd;
+
+typedef struct {
+	u32 Reg[0x30U / 4U];
+	SimCmd Queue[SIM_QUEUE];
+	u32 Count;
+	double StartAt;
+	u32 DoneCnt;
+	u32 Drops;
+	u32 StaleDone;
+} SimChannel;
+
+/************************** Variable Definitions *****************************/
+
+static SimChannel Sim[2];
+static double SimPcapIdleAt;
+static u32 SimPcapPos;
+static u32 SimPcapBad;
+
+static u8 *SimFlash;
+static double SimFlashNs;
+static u32 SimCopies;
+static u32 SimFailCopy;
+
+static double SimNow;
+static double SimTickNs;
+static double SimMBps = 400.0;
+static double SimApbNs = 40.0;
+static double SimLineNs = 8.0;
+static double SimCmdNs = 100.0;
+
+static XCsuDma CsuDma;
+static XSecure_Aes Aes;
+static u32 Failed;
+
+/************************** Function Definitions *****************************/
+
+static void Check(u32 Cond, const char *What)
+{
+	if (Cond == 0U) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+/* Completes the active command of a channel */
+static void SimRetire(SimChannel *Ch)
+{
+	if (Ch->DoneCnt < 7U) {
+		Ch->DoneCnt++;
+	}
+	Ch->Reg[XCSUDMA_I_STS_OFFSET / 4U] |= XCSUDMA_IXR_DONE_MASK;
+	Ch->Queue[0] = Ch->Queue[1];
+	Ch->Count--;
+	Ch->StartAt = SimNow + SimCmdNs;
+}
+
+/* Runs the source channel into the AES engine and PCAP up to time End */
+static void SimAdvance(double End)
+{
+	SimChannel *Src = &Sim[XCSUDMA_SRC_CHANNEL];
+	SimCmd *Cmd;
+
+	while ((SimNow + SimTickNs) <= End) {
+		if (Src->Count == 0U) {
+			/* Nothing in flight, skip ahead */
+			SimNow = End;
+			break;
+		}
+		SimNow += SimTickNs;
+
+		Cmd = &Src->Queue[0];
+		if (SimNow >= Src->StartAt) {
+			if (memcmp(Cmd->Ptr + Cmd->Moved,
+				&SimFlash[SimPcapPos], 4U) != 0) {
+				SimPcapBad++;
+			}
+			SimPcapPos += 4U;
+			Cmd->Moved += 4U;
+			SimPcapIdleAt = SimNow + SIM_PCAP_NS;
+			if (Cmd->Moved == Cmd->Bytes) {
+				SimRetire(Src);
+			}
+		}
+	}
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	u32 Rel = (u32)(Addr - SIM_DMA_BASE);
+	SimChannel *Ch;
+	u32 Offset;
+
+	SimAdvance(SimNow + SimApbNs);
+	if (Addr == XSECURE_CSU_PCAP_STATUS) {
+		return ((Sim[XCSUDMA_SRC_CHANNEL].Count == 0U) &&
+			(SimNow >= SimPcapIdleAt)) ?
+			XSECURE_CSU_PCAP_STATUS_PCAP_WR_IDLE_MASK : 0U;
+	}
+	if ((Addr < SIM_DMA_BASE) || (Rel >= (2U * XCSUDMA_OFFSET_DIFF)) ||
+			((Rel % XCSUDMA_OFFSET_DIFF) >= 0x30U)) {
+		fprintf(stderr, "read outside the model: 0x%lx\n",
+				(unsigned long)Addr);
+		exit(1);
+	}
+	Ch = &Sim[Rel / XCSUDMA_OFFSET_DIFF];
+	Offset = Rel % XCSUDMA_OFFSET_DIFF;
+	if (Offset == XCSUDMA_STS_OFFSET) {
+		return (Ch->DoneCnt << XCSUDMA_STS_DONE_CNT_SHIFT) |
+			((Ch->Count != 0U) ? XCSUDMA_STS_BUSY_MASK : 0U);
+	}
+	return Ch->Reg[Offset / 4U];
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	u32 Rel = (u32)(Addr - SIM_DMA_BASE);
+	SimChannel *Ch;
+	SimCmd *Cmd;
+	u32 Offset;
+
+	SimAdvance(SimNow + SimApbNs);
+	if (Addr == (XCSU_BASEADDRESS + XCSU_DMA_RESET_OFFSET)) {
+		return;
+	}
+	if ((Addr < SIM_DMA_BASE) || (Rel >= (2U * XCSUDMA_OFFSET_DIFF)) ||
+			((Rel % XCSUDMA_OFFSET_DIFF) >= 0x30U)) {
+		fprintf(stderr, "write outside the model: 0x%lx\n",
+				(unsigned long)Addr);
+		exit(1);
+	}
+	Ch = &Sim[Rel / XCSUDMA_OFFSET_DIFF];
+	Offset = Rel % XCSUDMA_OFFSET_DIFF;
+
+	switch (Offset) {
+	case XCSUDMA_SIZE_OFFSET:
+		/* A DONE left over would end the next wait early */
+		if ((Ch->Reg[XCSUDMA_I_STS_OFFSET / 4U] &
+				XCSUDMA_IXR_DONE_MASK) != 0U) {
+			Ch->StaleDone++;
+		}
+		if (Ch->Count == SIM_QUEUE) {
+			Ch->Drops++;
+			Ch->Reg[XCSUDMA_I_STS_OFFSET / 4U] |=
+					XCSUDMA_IXR_INVALID_APB_MASK;
+			break;
+		}
+		Cmd = &Ch->Queue[Ch->Count];
+		Cmd->Ptr = (u8 *)(UINTPTR)
+			(((u64)Ch->Reg[XCSUDMA_ADDR_MSB_OFFSET / 4U] << 32) |
+			Ch->Reg[XCSUDMA_ADDR_OFFSET / 4U]);
+		Cmd->Bytes = Value & ~XCSUDMA_LAST_WORD_MASK;
+		Cmd->Moved = 0U;
+		if (Ch->Count == 0U) {
+			Ch->StartAt = SimNow;
+		}
+		Ch->Count++;
+		if (Cmd->Bytes == 0U) {
+			SimRetire(Ch);
+		}
+		break;
+	case XCSUDMA_STS_OFFSET:
+		if ((Value & XCSUDMA_STS_DONE_CNT_MASK) != 0U) {
+			Ch->DoneCnt = 0U;
+		}
+		break;
+	case XCSUDMA_I_STS_OFFSET:
+		Ch->Reg[Offset / 4U] &= ~Value;
+		break;
+	default:
+		Ch->Reg[Offset / 4U] = Value;
+		break;
+	}
+}
+
+void SimCacheRange(INTPTR Addr, u32 Len)
+{
+	u32 Lines = (u32)(((Addr + Len + SIM_LINE - 1U) / SIM_LINE) -
+				(Addr / SIM_LINE));
+
+	SimAdvance(SimNow + (Lines * SimLineNs));
+}
+
+/* DeviceCopy callback: reads the flash, the data lands when it returns */
+static u32 SimDeviceCopy(u32 SrcAddress, UINTPTR DestAddress, u32 Length)
+{
+	SimCopies++;
+	SimAdvance(SimNow + (Length * SimFlashNs));
+	if (SimCopies == SimFailCopy) {
+		return 1U;
+	}
+	memcpy((u8 *)DestAddress, &SimFlash[SrcAddress - SIM_FLASH_BASE],
+		Length);
+	return 0U;
+}
+
+/* Decrypts Bytes of the image with one or two chunk buffers */
+static s32 Run(u8 **Buffer, u32 Double, u32 Bytes, u32 FailCopy)
+{
+	XCsuDma_Config Config = { 0U, SIM_DMA_BASE };
+
+	memset(Sim, 0, sizeof(Sim));
+	SimPcapIdleAt = 0.0;
+	SimPcapPos = 0U;
+	SimPcapBad = 0U;
+	SimCopies = 0U;
+	SimFailCopy = FailCopy;
+	SimNow = 0.0;
+
+	XCsuDma_CfgInitialize(&CsuDma, &Config, SIM_DMA_BASE);
+	(void)XSecure_AesInitialize(&Aes, &CsuDma, XSECURE_CSU_AES_KEY_SRC_KUP,
+				NULL, NULL);
+	XSecure_AesSetChunking(&Aes, XSECURE_CSU_AES_CHUNKING_ENABLED);
+	XSecure_AesSetChunkConfig(&Aes, Buffer[0], BENCH_CHUNK,
+				SimDeviceCopy);
+	if (Double != 0U) {
+		XSecure_AesSetChunkBuffer2(&Aes, Buffer[1]);
+	}
+
+	return XSecure_AesChunkDecrypt(&Aes,
+			(const u8 *)(UINTPTR)SIM_FLASH_BASE, Bytes);
+}
+
+/* Checks the state of the model once XSecure_AesChunkDecrypt returned */
+static void CheckIdle(const char *Name)
+{
+	SimChannel *Src = &Sim[XCSUDMA_SRC_CHANNEL];
+	char What[96];
+
+	snprintf(What, sizeof(What), "%s: CSU DMA idle on return", Name);
+	Check(Src->Count == 0U, What);
+	snprintf(What, sizeof(What), "%s: DONE acknowledged for every chunk",
+		Name);
+	Check((Src->StaleDone == 0U) &&
+		((Src->Reg[XCSUDMA_I_STS_OFFSET / 4U] &
+		XCSUDMA_IXR_DONE_MASK) == 0U), What);
+	snprintf(What, sizeof(What), "%s: no command dropped", Name);
+	Check(Src->Drops == 0U, What);
+	snprintf(What, sizeof(What), "%s: PCAP data intact", Name);
+	Check(SimPcapBad == 0U, What);
+}
+
+int main(int argc, char *argv[])
+{
+	static const double Flash[] = { 25.0, 50.0, 100.0, 400.0 };
+	static const char *Names[] = { "one buffer", "two buffers" };
+	u8 *Buffer[2];
+	u32 Double;
+	u32 Index;
+	u32 Chunks = (CHECK_BYTES + BENCH_CHUNK - 1U) / BENCH_CHUNK;
+	char What[96];
+	double Rate[2];
+	s32 Status;
+
+	if (argc > 1) {
+		SimMBps = atof(argv[1]);
+	}
+	if (argc > 2) {
+		SimApbNs = atof(argv[2]);
+	}
+	if (argc > 3) {
+		SimLineNs = atof(argv[3]);
+	}
+	if (argc > 4) {
+		SimCmdNs = atof(argv[4]);
+	}
+	SimTickNs = 4000.0 / SimMBps;
+
+	SimFlash = malloc(BENCH_BYTES);
+	Buffer[0] = aligned_alloc(64, BENCH_CHUNK);
+	Buffer[1] = aligned_alloc(64, BENCH_CHUNK);
+	if ((SimFlash == NULL) || (Buffer[0] == NULL) || (Buffer[1] == NULL)) {
+		return 1;
+	}
+	for (Index = 0U; Index < BENCH_BYTES; Index++) {
+		SimFlash[Index] = (u8)((Index * 7U) + (Index >> 9));
+	}
+
+	SimFlashNs = 1000.0 / 50.0;
+	for (Double = 0U; Double < 2U; Double++) {
+		Status = Run(Buffer, Double, CHECK_BYTES, 0U);
+		snprintf(What, sizeof(What), "%s: decrypt status",
+			Names[Double]);
+		Check(Status == XST_SUCCESS, What);
+		snprintf(What, sizeof(What), "%s: whole image sent",
+			Names[Double]);
+		Check(SimPcapPos == CHECK_BYTES, What);
+		snprintf(What, sizeof(What), "%s: chunk count", Names[Double]);
+		Check(Aes.ChunkStats.Chunks == Chunks, What);
+		CheckIdle(Names[Double]);
+
+		/* The third copy fails, overlapped with the second chunk */
+		Status = Run(Buffer, Double, CHECK_BYTES, 3U);
+		snprintf(What, sizeof(What), "%s: copy error reported",
+			Names[Double]);
+		Check(Status == XSECURE_CSU_AES_DEVICE_COPY_ERROR, What);
+		snprintf(What, sizeof(What), "%s: chunks before the error sent",
+			Names[Double]);
+		Check((Aes.ChunkStats.Chunks == 2U) &&
+			(SimPcapPos == (2U * BENCH_CHUNK)), What);
+		CheckIdle(Names[Double]);
+	}
+
+	printf("model: %.0f MB/s, %.0f ns per access, %.0f ns per cache "
+		"line, %.0f ns per command\n\n", SimMBps, SimApbNs, SimLineNs,
+		SimCmdNs);
+	printf("MB/s decrypting %u KB in %u byte chunks\n",
+		BENCH_BYTES / 1024U, BENCH_CHUNK);
+	printf("%11s %12s %12s\n", "flash MB/s", Names[0], Names[1]);
+	for (Index = 0U; Index < sizeof(Flash) / sizeof(Flash[0]); Index++) {
+		SimFlashNs = 1000.0 / Flash[Index];
+		for (Double = 0U; Double < 2U; Double++) {
+			Status = Run(Buffer, Double, BENCH_BYTES, 0U);
+			Check((Status == XST_SUCCESS) &&
+				(SimPcapPos == BENCH_BYTES), "bench: decrypt");
+			CheckIdle("bench");
+			Rate[Double] = BENCH_BYTES * 1000.0 / SimNow;
+		}
+		printf("%11.0f %12.1f %12.1f\n", Flash[Index], Rate[0],
+			Rate[1]);
+	}
+
+	free(SimFlash);
+	free(Buffer[0]);
+	free(Buffer[1]);
+
+	printf("\n%s\n", (Failed == 0U) ? "all checks passed" :
+						"CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}
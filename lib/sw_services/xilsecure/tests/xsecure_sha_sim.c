@@ -0,0 +1,698 @@
+/******************************************************************************
+*
+* (c) Copyright 2014 Xilinx, Inc. All rights reserved.
+*
+* This file contains confidential and proprietary information of Xilinx, Inc.
+* and is protected under U.S. and international copyright and other
+* intellectual property laws.
+*
+* DISCLAIMER
+* This disclaimer is not a license and does not grant any rights to the
+* materials distributed herewith. Except as otherwise provided in a valid
+* license issued to you by Xilinx, and to the maximum extent permitted by
+* applicable law: (1) THESE MATERIALS ARE MADE AVAILABLE "AS IS" AND WITH ALL
+* FAULTS, AND XILINX HEREBY DISCLAIMS ALL WARRANTIES AND CONDITIONS, EXPRESS,
+* IMPLIED, OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF
+* MERCHANTABILITY, NON-INFRINGEMENT, OR FITNESS FOR ANY PARTICULAR PURPOSE
+* and (2) Xilinx shall not be liable (whether in contract or tort, including
+* negligence, or under any other theory of liability) for any loss or damage
+* of any kind or nature related to, arising under or in connection with these
+* materials, including for any direct, or any indirect, special, incidental,
+* or consequential loss or damage (including loss of data, profits, goodwill,
+* or any type of loss or damage suffered as a result of any action brought by
+* a third party) even if such damage or loss was reasonably foreseeable or
+* Xilinx had been advised of the possibility of the same.
+*
+* CRITICAL APPLICATIONS
+* Xilinx products are not designed or intended to be fail-safe, or for use in
+* any application requiring fail-safe performance, such as life-support or
+* safety devices or systems, Class III medical devices, nuclear facilities,
+* applications related to the deployment of airbags, or any other applications
+* that could lead to death, personal injury, or severe property or
+* environmental damage (individually and collectively, "Critical
+* Applications"). Customer assumes the sole risk and liability of any use of
+* Xilinx products in Critical Applications, subject only to applicable laws
+* and regulations governing limitations on product liability.
+*
+* THIS COPYRIGHT NOTICE AND DISCLAIMER MUST BE RETAINED AS PART OF THIS FILE
+* AT ALL TIMES.
+*
+*******************************************************************************/
+/*****************************************************************************/
+/**
+*
+* @file xsecure_sha_sim.c
+*
+* Host test and benchmark of the SHA-3 driver, blocking and queued updates.
+*
+* The driver runs against a model of the CSU_DMA source channel, the secure
+* stream switch and the SHA-3 engine. The source channel holds the command
+* it is executing and one more; a third write to SIZE is dropped and flagged
+* with INVALID_APB, as on the target. It moves one word per tick into the
+* engine and starts its next command a fixed time after the previous one has
+* completed. The engine computes a real Keccak-384 over the words it is fed,
+* so a block that is lost, sent twice or sent out of order changes the
+* digest.
+*
+* Time only moves when the CPU accesses a register or does cache maintenance,
+* each access costing a fixed time and cache maintenance a time per cache
+* line, or when the caller does other work between polls of the queue.
+*
+* Checked first:
+*  - the Keccak model against the FIPS 202 SHA3-384("abc") vector,
+*  - the digest of a message cut into blocks of uneven sizes, through
+*    XSecure_Sha3Update and through XSecure_Sha3UpdateSg, against the digest
+*    of the message in one piece,
+*  - that a block is never reported complete before the engine has seen all
+*    of it, and that no command is dropped,
+*  - that a CSU_DMA transfer that cannot be started is reported, leaves the
+*    queue idle instead of spinning, and is retried by XSecure_Sha3Poll.
+* Then 4 MB is hashed in blocks of 4, 16 and 64 KB:
+*  - with a XSecure_Sha3Update per block,
+*  - queued one block at a time, the next one queued once the previous one
+*    has completed,
+*  - with the queue kept full,
+* the latter two with the caller doing other work between polls, and the
+* modelled throughput is printed.
+*
+* Usage: xsecure_sha_sim [MB/s] [ns per access] [ns per cache line]
+*        [ns per command]
+*
+* The defaults are 400 MB/s, 40 ns, 8 ns and 100 ns.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date     Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.1        10/18/26 First release
+*
+* </pre>
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xsecure_sha.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_DMA_BASE	0xFFC80000U	/* CSU_DMA */
+#define SIM_QUEUE	2U		/* Commands buffered per channel */
+#define SIM_LINE	64U		/* Cache line, bytes */
+#define SIM_SHA_DIGEST	48U		/* Keccak-384 */
+
+#define BENCH_BYTES	(4U * 1024U * 1024U)
+#define CHECK_BLOCKS	40U
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u8 *Ptr;
+	u32 Bytes;
+	u32 Moved;
+	u32 Last;
+} SimCmd;
+
+typedef struct {
+	u32 Reg[0x30U / 4U];
+	SimCmd Queue[SIM_QUEUE];
+	u32 Count;
+	double StartAt;
+	u32 DoneCnt;
+	u32 Drops;
+} SimChannel;
+
+typedef struct {
+	u64 State[25];
+	u8 Buf[XSECURE_SHA3_BLOCK_LEN];
+	u32 Fill;
+	u32 Done;
+	u32 Digest[SIM_SHA_DIGEST / 4U];
+	u64 Fed;
+	u32 Errors;
+} SimSha;
+
+/************************** Variable Definitions *****************************/
+
+static SimChannel Sim[2];
+static SimSha Engine;
+static u32 SimSss;
+
+static double SimNow;
+static double SimTickNs;
+static double SimMBps = 400.0;
+static double SimApbNs = 40.0;
+static double SimLineNs = 8.0;
+static double SimCmdNs = 100.0;
+
+static XCsuDma CsuDma;
+static XSecure_Sha3 Sha;
+static u32 Failed;
+
+/************************** Function Definitions *****************************/
+
+static void Check(u32 Cond, const char *What)
+{
+	if (Cond == 0U) {
+		printf("FAILED: %s\n", What);
+		Failed++;
+	}
+}
+
+/* Keccak-f[1600] */
+static void SimKeccakF(u64 *A)
+{
+	static const u64 Rc[24] = {
+		0x0000000000000001ULL, 0x0000000000008082ULL,
+		0x800000000000808AULL, 0x8000000080008000ULL,
+		0x000000000000808BULL, 0x0000000080000001ULL,
+		0x8000000080008081ULL, 0x8000000000008009ULL,
+		0x000000000000008AULL, 0x0000000000000088ULL,
+		0x0000000080008009ULL, 0x000000008000000AULL,
+		0x000000008000808BULL, 0x800000000000008BULL,
+		0x8000000000008089ULL, 0x8000000000008003ULL,
+		0x8000000000008002ULL, 0x8000000000000080ULL,
+		0x000000000000800AULL, 0x800000008000000AULL,
+		0x8000000080008081ULL, 0x8000000000008080ULL,
+		0x0000000080000001ULL, 0x8000000080008008ULL
+	};
+	static const u32 Rot[25] = {
+		0U, 1U, 62U, 28U, 27U, 36U, 44U, 6U, 55U, 20U, 3U, 10U, 43U,
+		25U, 39U, 41U, 45U, 15U, 21U, 8U, 18U, 2U, 61U, 56U, 14U
+	};
+	u64 B[25];
+	u64 C[5];
+	u64 D;
+	u32 Round;
+	u32 X;
+	u32 Y;
+
+	for (Round = 0U; Round < 24U; Round++) {
+		for (X = 0U; X < 5U; X++) {
+			C[X] = A[X] ^ A[X + 5U] ^ A[X + 10U] ^ A[X + 15U] ^
+				A[X + 20U];
+		}
+		for (X = 0U; X < 5U; X++) {
+			D = C[(X + 4U) % 5U] ^ ((C[(X + 1U) % 5U] << 1) |
+				(C[(X + 1U) % 5U] >> 63));
+			for (Y = 0U; Y < 25U; Y += 5U) {
+				A[Y + X] ^= D;
+			}
+		}
+		for (X = 0U; X < 5U; X++) {
+			for (Y = 0U; Y < 5U; Y++) {
+				u64 V = A[(Y * 5U) + X];
+				u32 R = Rot[(Y * 5U) + X];
+
+				B[(((2U * X) + (3U * Y)) % 5U) * 5U + Y] =
+					(R == 0U) ? V :
+					((V << R) | (V >> (64U - R)));
+			}
+		}
+		for (Y = 0U; Y < 25U; Y += 5U) {
+			for (X = 0U; X < 5U; X++) {
+				A[Y + X] = B[Y + X] ^ (~B[Y + ((X + 1U) % 5U)] &
+					B[Y + ((X + 2U) % 5U)]);
+			}
+		}
+		A[0] ^= Rc[Round];
+	}
+}
+
+static void SimAbsorb(u64 *State, const u8 *Block)
+{
+	u32 Lane;
+	u64 V;
+
+	for (Lane = 0U; Lane < (XSECURE_SHA3_BLOCK_LEN / 8U); Lane++) {
+		memcpy(&V, Block + (Lane * 8U), 8U);
+		State[Lane] ^= V;
+	}
+	SimKeccakF(State);
+}
+
+/* Keccak-384 of a message with the given first padding byte */
+static void SimKeccak384(const u8 *Msg, u32 Len, u8 Pad, u8 *Out)
+{
+	u64 State[25];
+	u8 Block[XSECURE_SHA3_BLOCK_LEN];
+	u32 Offset;
+
+	memset(State, 0, sizeof(State));
+	for (Offset = 0U; (Len - Offset) >= XSECURE_SHA3_BLOCK_LEN;
+			Offset += XSECURE_SHA3_BLOCK_LEN) {
+		SimAbsorb(State, Msg + Offset);
+	}
+	memset(Block, 0, sizeof(Block));
+	memcpy(Block, Msg + Offset, Len - Offset);
+	Block[Len - Offset] = Pad;
+	Block[XSECURE_SHA3_BLOCK_LEN - 1U] |= 0x80U;
+	SimAbsorb(State, Block);
+	memcpy(Out, State, SIM_SHA_DIGEST);
+}
+
+/* The engine takes a word from the stream switch */
+static void SimShaFeed(const u8 *Word, u32 Last)
+{
+	if ((SimSss != XSecure_SssInputSha3(XSECURE_CSU_SSS_SRC_SRC_DMA)) ||
+			(Engine.Done != 0U)) {
+		Engine.Errors++;
+		return;
+	}
+	memcpy(&Engine.Buf[Engine.Fill], Word, 4U);
+	Engine.Fill += 4U;
+	Engine.Fed += 4U;
+	if (Engine.Fill == XSECURE_SHA3_BLOCK_LEN) {
+		SimAbsorb(Engine.State, Engine.Buf);
+		Engine.Fill = 0U;
+	}
+	if (Last != 0U) {
+		u8 Out[SIM_SHA_DIGEST];
+		u32 Index;
+
+		/* The driver pads the message to a whole block */
+		if (Engine.Fill != 0U) {
+			Engine.Errors++;
+		}
+		memcpy(Out, Engine.State, SIM_SHA_DIGEST);
+		/* Read back last register first, see XSecure_Sha3Finish */
+		for (Index = 0U; Index < (SIM_SHA_DIGEST / 4U); Index++) {
+			memcpy(&Engine.Digest[(SIM_SHA_DIGEST / 4U) - 1U -
+				Index], Out + (Index * 4U), 4U);
+		}
+		Engine.Done = 1U;
+	}
+}
+
+/* Completes the active command of a channel */
+static void SimRetire(SimChannel *Ch)
+{
+	if (Ch->DoneCnt < 7U) {
+		Ch->DoneCnt++;
+	}
+	Ch->Reg[XCSUDMA_I_STS_OFFSET / 4U] |= XCSUDMA_IXR_DONE_MASK;
+	Ch->Queue[0] = Ch->Queue[1];
+	Ch->Count--;
+	Ch->StartAt = SimNow + SimCmdNs;
+}
+
+/* Runs the source channel up to time End */
+static void SimAdvance(double End)
+{
+	SimChannel *Src = &Sim[XCSUDMA_SRC_CHANNEL];
+	SimCmd *Cmd;
+
+	while ((SimNow + SimTickNs) <= End) {
+		if (Src->Count == 0U) {
+			/* Nothing in flight, skip ahead */
+			SimNow = End;
+			break;
+		}
+		SimNow += SimTickNs;
+
+		Cmd = &Src->Queue[0];
+		if (SimNow >= Src->StartAt) {
+			Cmd->Moved += 4U;
+			SimShaFeed(Cmd->Ptr + Cmd->Moved - 4U,
+				((Cmd->Moved == Cmd->Bytes) &&
+				(Cmd->Last != 0U)) ? 1U : 0U);
+			if (Cmd->Moved == Cmd->Bytes) {
+				SimRetire(Src);
+			}
+		}
+	}
+}
+
+static u32 *SimDecode(UINTPTR Addr, SimChannel **ChPtr, u32 *Offset)
+{
+	u32 Rel = (u32)(Addr - SIM_DMA_BASE);
+
+	*ChPtr = NULL;
+	if (Addr == XSECURE_CSU_SSS_BASE) {
+		return &SimSss;
+	}
+	if ((Addr >= SIM_DMA_BASE) && (Rel < (2U * XCSUDMA_OFFSET_DIFF)) &&
+			((Rel % XCSUDMA_OFFSET_DIFF) < 0x30U)) {
+		*Offset = Rel % XCSUDMA_OFFSET_DIFF;
+		*ChPtr = &Sim[Rel / XCSUDMA_OFFSET_DIFF];
+		return &(*ChPtr)->Reg[*Offset / 4U];
+	}
+	if ((Addr >= (XSECURE_CSU_SHA3_BASE +
+			XSECURE_CSU_SHA3_DIGEST_0_OFFSET)) &&
+			(Addr < (XSECURE_CSU_SHA3_BASE +
+			XSECURE_CSU_SHA3_DIGEST_0_OFFSET + SIM_SHA_DIGEST))) {
+		return &Engine.Digest[(Addr - XSECURE_CSU_SHA3_BASE -
+				XSECURE_CSU_SHA3_DIGEST_0_OFFSET) / 4U];
+	}
+	if (Addr == (XSECURE_CSU_SHA3_BASE + XSECURE_CSU_SHA3_DONE_OFFSET)) {
+		return &Engine.Done;
+	}
+	return NULL;
+}
+
+u32 Xil_In32(UINTPTR Addr)
+{
+	SimChannel *Ch;
+	u32 Offset;
+	u32 *Reg;
+
+	SimAdvance(SimNow + SimApbNs);
+	Reg = SimDecode(Addr, &Ch, &Offset);
+	if (Reg == NULL) {
+		fprintf(stderr, "read outside the model: 0x%lx\n",
+				(unsigned long)Addr);
+		exit(1);
+	}
+	if ((Ch != NULL) && (Offset == XCSUDMA_STS_OFFSET)) {
+		return (Ch->DoneCnt << XCSUDMA_STS_DONE_CNT_SHIFT) |
+			((Ch->Count != 0U) ? XCSUDMA_STS_BUSY_MASK : 0U);
+	}
+	return *Reg;
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+	SimChannel *Ch;
+	SimCmd *Cmd;
+	u32 Offset;
+	u32 *Reg;
+
+	SimAdvance(SimNow + SimApbNs);
+	if (Addr == (XCSU_BASEADDRESS + XCSU_DMA_RESET_OFFSET)) {
+		return;
+	}
+	if (Addr == (XSECURE_CSU_SHA3_BASE + XSECURE_CSU_SHA3_RESET_OFFSET)) {
+		return;
+	}
+	if (Addr == (XSECURE_CSU_SHA3_BASE + XSECURE_CSU_SHA3_START_OFFSET)) {
+		if ((Value & XSECURE_CSU_SHA3_START_START) != 0U) {
+			memset(Engine.State, 0, sizeof(Engine.State));
+			Engine.Fill = 0U;
+			Engine.Done = 0U;
+			Engine.Fed = 0U;
+		}
+		return;
+	}
+	Reg = SimDecode(Addr, &Ch, &Offset);
+	if ((Reg == NULL) || ((Ch == NULL) && (Reg != &SimSss))) {
+		fprintf(stderr, "write outside the model: 0x%lx\n",
+				(unsigned long)Addr);
+		exit(1);
+	}
+	if (Ch == NULL) {
+		*Reg = Value;
+		return;
+	}
+
+	switch (Offset) {
+	case XCSUDMA_SIZE_OFFSET:
+		if (Ch->Count == SIM_QUEUE) {
+			Ch->Drops++;
+			Ch->Reg[XCSUDMA_I_STS_OFFSET / 4U] |=
+					XCSUDMA_IXR_INVALID_APB_MASK;
+			break;
+		}
+		Cmd = &Ch->Queue[Ch->Count];
+		Cmd->Ptr = (u8 *)(UINTPTR)
+			(((u64)Ch->Reg[XCSUDMA_ADDR_MSB_OFFSET / 4U] << 32) |
+			Ch->Reg[XCSUDMA_ADDR_OFFSET / 4U]);
+		Cmd->Bytes = Value & ~XCSUDMA_LAST_WORD_MASK;
+		Cmd->Moved = 0U;
+		Cmd->Last = Value & XCSUDMA_LAST_WORD_MASK;
+		if (Ch->Count == 0U) {
+			Ch->StartAt = SimNow;
+		}
+		Ch->Count++;
+		if (Cmd->Bytes == 0U) {
+			SimRetire(Ch);
+		}
+		break;
+	case XCSUDMA_STS_OFFSET:
+		if ((Value & XCSUDMA_STS_DONE_CNT_MASK) != 0U) {
+			Ch->DoneCnt = 0U;
+		}
+		break;
+	case XCSUDMA_I_STS_OFFSET:
+		*Reg &= ~Value;
+		break;
+	default:
+		*Reg = Value;
+		break;
+	}
+}
+
+void SimCacheRange(INTPTR Addr, u32 Len)
+{
+	u32 Lines = (u32)(((Addr + Len + SIM_LINE - 1U) / SIM_LINE) -
+				(Addr / SIM_LINE));
+
+	SimAdvance(SimNow + (Lines * SimLineNs));
+}
+
+static void SimReset(void)
+{
+	XCsuDma_Config Config = { 0U, SIM_DMA_BASE };
+
+	memset(Sim, 0, sizeof(Sim));
+	memset(&Engine, 0, sizeof(Engine));
+	SimSss = 0U;
+	SimNow = 0.0;
+	XCsuDma_CfgInitialize(&CsuDma, &Config, SIM_DMA_BASE);
+	(void)XSecure_Sha3Initialize(&Sha, &CsuDma);
+}
+
+/* Checks the model state after a hash */
+static void CheckClean(const char *Name)
+{
+	char What[96];
+
+	snprintf(What, sizeof(What), "%s: no command dropped", Name);
+	Check(Sim[XCSUDMA_SRC_CHANNEL].Drops == 0U, What);
+	snprintf(What, sizeof(What), "%s: engine fed from the DMA only",
+			Name);
+	Check(Engine.Errors == 0U, What);
+	snprintf(What, sizeof(What), "%s: DONE status clear", Name);
+	Check((Sim[XCSUDMA_SRC_CHANNEL].Reg[XCSUDMA_I_STS_OFFSET / 4U] &
+		XCSUDMA_IXR_DONE_MASK) == 0U, What);
+}
+
+/* Hashes Bytes of Msg with a XSecure_Sha3Update per Block bytes */
+static void HashBlocking(const u8 *Msg, u32 Bytes, u32 Block, u8 *Hash)
+{
+	u32 Offset;
+	u32 Size;
+
+	XSecure_Sha3Start(&Sha);
+	for (Offset = 0U; Offset < Bytes; Offset += Size) {
+		Size = ((Bytes - Offset) > Block) ? Block : (Bytes - Offset);
+		XSecure_Sha3Update(&Sha, Msg + Offset, Size);
+	}
+	XSecure_Sha3Finish(&Sha, Hash);
+}
+
+/*
+ * Hashes Bytes of Msg in blocks of Block bytes, with at most Depth of them
+ * queued, doing WorkNs of other work whenever the queue is full.
+ */
+static void HashQueued(const u8 *Msg, u32 Bytes, u32 Block, u32 Depth,
+			double WorkNs, u8 *Hash)
+{
+	u32 Offset = 0U;
+	u32 Size;
+	u32 Base = XSecure_Sha3GetCompleted(&Sha);
+	u32 Queued = 0U;
+	u32 Done;
+	u32 Late = 0U;
+
+	XSecure_Sha3Start(&Sha);
+	while (Offset < Bytes) {
+		Size = ((Bytes - Offset) > Block) ? Block : (Bytes - Offset);
+		Done = XSecure_Sha3GetCompleted(&Sha) - Base;
+		/* Completed blocks must have reached the engine */
+		if ((u64)Done * Block > Engine.Fed) {
+			Late++;
+		}
+		if (((Queued - Done) < Depth) &&
+				(XSecure_Sha3UpdateAsync(&Sha, Msg + Offset,
+				Size) == XST_SUCCESS)) {
+			Offset += Size;
+			Queued++;
+		}
+		else {
+			SimAdvance(SimNow + WorkNs);
+		}
+	}
+	XSecure_Sha3Finish(&Sha, Hash);
+	Check(Late == 0U, "queued: no block completes before it is hashed");
+	Check((XSecure_Sha3GetCompleted(&Sha) - Base) == Queued,
+		"queued: every block completed");
+}
+
+static void TestDigests(const u8 *Msg)
+{
+	static const u8 Abc[48] = {
+		0xecU, 0x01U, 0x49U, 0x82U, 0x88U, 0x51U, 0x6fU, 0xc9U,
+		0x26U, 0x45U, 0x9fU, 0x58U, 0xe2U, 0xc6U, 0xadU, 0x8dU,
+		0xf9U, 0xb4U, 0x73U, 0xcbU, 0x0fU, 0xc0U, 0x8cU, 0x25U,
+		0x96U, 0xdaU, 0x7cU, 0xf0U, 0xe4U, 0x9bU, 0xe4U, 0xb2U,
+		0x98U, 0xd8U, 0x8cU, 0xeaU, 0x92U, 0x7aU, 0xc7U, 0xf5U,
+		0x39U, 0xf1U, 0xedU, 0xf2U, 0x28U, 0x37U, 0x6dU, 0x25U
+	};
+	XSecure_Sha3Sg List[XSECURE_SHA3_QUEUE_DEPTH];
+	u32 Size[CHECK_BLOCKS];
+	u32 Hash[SIM_SHA_DIGEST / 4U];
+	u8 Ref[SIM_SHA_DIGEST];
+	u32 Total = 0U;
+	u32 Offset;
+	u32 Index;
+	u32 Count;
+	u32 Base;
+
+	SimKeccak384((const u8 *)"abc", 3U, 0x06U, Ref);
+	Check(memcmp(Ref, Abc, sizeof(Abc)) == 0,
+		"model: SHA3-384(\"abc\")");
+
+	/* Uneven block sizes, the total not a multiple of the block length */
+	for (Index = 0U; Index < CHECK_BLOCKS; Index++) {
+		Size[Index] = 4U * (1U + ((Index * 2654435761U) % 3001U));
+		Total += Size[Index];
+	}
+	SimKeccak384(Msg, Total, 0x01U, Ref);
+
+	SimReset();
+	XSecure_Sha3Start(&Sha);
+	for (Index = 0U, Offset = 0U; Index < CHECK_BLOCKS; Index++) {
+		XSecure_Sha3Update(&Sha, Msg + Offset, Size[Index]);
+		Offset += Size[Index];
+	}
+	XSecure_Sha3Finish(&Sha, (u8 *)Hash);
+	Check(memcmp(Hash, Ref, sizeof(Ref)) == 0, "update: digest");
+	CheckClean("update");
+
+	SimReset();
+	XSecure_Sha3Start(&Sha);
+	Base = XSecure_Sha3GetCompleted(&Sha);
+	for (Index = 0U, Offset = 0U; Index < CHECK_BLOCKS; Index += Count) {
+		for (Count = 0U; (Count < 3U) &&
+				((Index + Count) < CHECK_BLOCKS); Count++) {
+			List[Count].Data = Msg + Offset;
+			List[Count].Size = Size[Index + Count];
+			Offset += Size[Index + Count];
+		}
+		while (XSecure_Sha3UpdateSg(&Sha, List, Count) ==
+				XST_DEVICE_BUSY) {
+			SimAdvance(SimNow + 1000.0);
+		}
+	}
+	XSecure_Sha3Finish(&Sha, (u8 *)Hash);
+	Check(memcmp(Hash, Ref, sizeof(Ref)) == 0, "scatter list: digest");
+	Check((XSecure_Sha3GetCompleted(&Sha) - Base) == CHECK_BLOCKS,
+		"scatter list: every block completed");
+	CheckClean("scatter list");
+
+	/* A transfer that cannot be started must not leave Drain spinning */
+	SimReset();
+	XSecure_Sha3Start(&Sha);
+	Sha.Chain.Channels = (u8)(1U << (u32)XCSUDMA_SRC_CHANNEL);
+	Check(XSecure_Sha3UpdateAsync(&Sha, Msg, Size[0]) == XST_FAILURE,
+		"failed start: reported by UpdateAsync");
+	Check(Sha.Active == 0U, "failed start: queue left idle");
+	Check(XSecure_Sha3Poll(&Sha) == XST_FAILURE,
+		"failed start: reported by Poll");
+	Sha.Chain.Channels = 0U;
+	for (Index = 1U, Offset = Size[0]; Index < CHECK_BLOCKS; Index++) {
+		XSecure_Sha3Update(&Sha, Msg + Offset, Size[Index]);
+		Offset += Size[Index];
+	}
+	XSecure_Sha3Finish(&Sha, (u8 *)Hash);
+	Check(memcmp(Hash, Ref, sizeof(Ref)) == 0,
+		"failed start: block retried in order");
+	CheckClean("failed start");
+}
+
+int main(int argc, char *argv[])
+{
+	static const u32 Blocks[] = { 4096U, 16384U, 65536U };
+	static const double Work[] = { 1000.0, 50000.0, 200000.0 };
+	u32 Hash[SIM_SHA_DIGEST / 4U];
+	u8 Ref[SIM_SHA_DIGEST];
+	u8 *Msg;
+	u32 Index;
+	u32 Step;
+	double Rate[1U + (2U * (sizeof(Work) / sizeof(Work[0])))];
+
+	if (argc > 1) {
+		SimMBps = atof(argv[1]);
+	}
+	if (argc > 2) {
+		SimApbNs = atof(argv[2]);
+	}
+	if (argc > 3) {
+		SimLineNs = atof(argv[3]);
+	}
+	if (argc > 4) {
+		SimCmdNs = atof(argv[4]);
+	}
+	SimTickNs = 4000.0 / SimMBps;
+
+	Msg = aligned_alloc(64, BENCH_BYTES);
+	if (Msg == NULL) {
+		return 1;
+	}
+	for (Index = 0U; Index < BENCH_BYTES; Index++) {
+		Msg[Index] = (u8)((Index * 7U) + (Index >> 9));
+	}
+
+	TestDigests(Msg);
+
+	printf("XSECURE_SHA3_QUEUE_DEPTH %u, model: %.0f MB/s, %.0f ns per "
+		"access, %.0f ns per cache line, %.0f ns per command\n\n",
+		(u32)XSECURE_SHA3_QUEUE_DEPTH, SimMBps, SimApbNs, SimLineNs,
+		SimCmdNs);
+	printf("MB/s hashing %u KB; one queued / queue full, with the given "
+		"work between polls\n", BENCH_BYTES / 1024U);
+	printf("%6s %8s", "block", "update");
+	for (Step = 0U; Step < sizeof(Work) / sizeof(Work[0]); Step++) {
+		printf("   %5.0fus 1/full", Work[Step] / 1000.0);
+	}
+	printf("\n");
+
+	SimKeccak384(Msg, BENCH_BYTES, 0x01U, Ref);
+	for (Index = 0U; Index < sizeof(Blocks) / sizeof(Blocks[0]); Index++) {
+		SimReset();
+		HashBlocking(Msg, BENCH_BYTES, Blocks[Index], (u8 *)Hash);
+		Check(memcmp(Hash, Ref, sizeof(Ref)) == 0, "bench: digest");
+		CheckClean("bench update");
+		Rate[0] = BENCH_BYTES * 1000.0 / SimNow;
+
+		for (Step = 0U; Step < (2U * (sizeof(Work) / sizeof(Work[0])));
+				Step++) {
+			SimReset();
+			HashQueued(Msg, BENCH_BYTES, Blocks[Index],
+				((Step & 1U) == 0U) ? 1U :
+				XSECURE_SHA3_QUEUE_DEPTH, Work[Step / 2U],
+				(u8 *)Hash);
+			Check(memcmp(Hash, Ref, sizeof(Ref)) == 0,
+				"bench: digest");
+			CheckClean("bench queued");
+			Rate[1U + Step] = BENCH_BYTES * 1000.0 / SimNow;
+		}
+
+		printf("%6u %8.1f", Blocks[Index], Rate[0]);
+		for (Step = 0U; Step < sizeof(Work) / sizeof(Work[0]); Step++) {
+			printf("   %6.1f/%6.1f", Rate[1U + (2U * Step)],
+				Rate[2U + (2U * Step)]);
+		}
+		printf("\n");
+	}
+
+	free(Msg);
+
+	printf("\n%s\n", (Failed == 0U) ? "all checks passed" :
+						"CHECKS FAILED");
+	return (Failed == 0U) ? 0 : 1;
+}